@@ -149,6 +149,12 @@ public:
 	virtual void			ListModels( void ) = 0;
 	// Writes a collision model file for the given map entity.
 	virtual bool			WriteCollisionModelForMapEntity( const idMapEntity *mapEnt, const char *filename, const bool testTraceModel = true ) = 0;
+
+	// Compares traces run in parallel jobs against the same traces run on the calling thread.
+	static void				TestThreads_f( const class idCmdArgs &args );
+	// Prints how many random traces per second the calling thread runs against the world model and how many
+	// polygons and edges they test, optionally loads a map first and writes or checks golden trace results.
+	static void				BenchTraces_f( const class idCmdArgs &args );
 };
 
 extern idCollisionModelManager *		collisionModelManager;
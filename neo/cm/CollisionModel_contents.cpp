@@ -58,19 +58,8 @@ bool idCollisionModelManagerLocal::TestTrmVertsInBrush( cm_traceWork_t *tw, cm_b
 	float d, bestd;
 	idVec3 *p;
 
-	if ( b->checkcount == idCollisionModelManagerLocal::checkCount ) {
-		return false;
-	}
-	b->checkcount = idCollisionModelManagerLocal::checkCount;
-
-	if ( !(b->contents & tw->contents) ) {
-		return false;
-	}
-
-	// if the brush bounds don't intersect the trace bounds
-	if ( !b->bounds.IntersectsBounds( tw->bounds ) ) {
-		return false;
-	}
+	// CM_TestFlatRef already skipped brushes that were checked before, don't have the
+	// right contents or don't intersect the trace bounds
 
 	if ( tw->pointTrace ) {
 		numVerts = 1;
@@ -130,10 +119,10 @@ CM_SetTrmEdgeSidedness
 CM_SetTrmPolygonSidedness
 ================
 */
-#define CM_SetTrmPolygonSidedness( v, plane, bitNum ) {								\
+#define CM_SetTrmPolygonSidedness( v, p, plane, bitNum ) {							\
 	if ( !((v)->sideSet & (1<<bitNum)) ) {											\
 		float fl;																	\
-		fl = plane.Distance( (v)->p );												\
+		fl = plane.Distance( p );													\
 		/* cannot use float sign bit because it is undetermined when fl == 0.0f */	\
 		if ( fl < 0.0f ) {															\
 			(v)->side |= (1 << bitNum);												\
@@ -158,23 +147,11 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 	float d, bestd;
 	cm_trmEdge_t *trmEdge;
 	cm_edge_t *edge;
-	cm_vertex_t *v, *v1, *v2;
+	cm_vertex_t *v;
+	cm_featureCheck_t *ec, *vc, *v1, *v2;
 
-	// if already checked this polygon
-	if ( p->checkcount == idCollisionModelManagerLocal::checkCount ) {
-		return false;
-	}
-	p->checkcount = idCollisionModelManagerLocal::checkCount;
-
-	// if this polygon does not have the right contents behind it
-	if ( !(p->contents & tw->contents) ) {
-		return false;
-	}
-
-	// if the polygon bounds don't intersect the trace bounds
-	if ( !p->bounds.IntersectsBounds( tw->bounds ) ) {
-		return false;
-	}
+	// CM_TestFlatRef already skipped polygons that were checked before, don't have the
+	// right contents or don't intersect the trace bounds
 
 	// bounds should cross polygon plane
 	switch( tw->bounds.PlaneSide( p->plane ) ) {
@@ -196,14 +173,14 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 			edgeNum = p->edges[i];
 			edge = tw->model->edges + abs(edgeNum);
 			// if this edge is already tested
-			if ( edge->checkcount == idCollisionModelManagerLocal::checkCount ) {
+			if ( tw->edgeChecks[abs(edgeNum)].checkcount == tw->checkCount ) {
 				continue;
 			}
 
 			for ( j = 0; j < 2; j++ ) {
 				v = &tw->model->vertices[edge->vertexNum[j]];
 				// if this vertex is already tested
-				if ( v->checkcount == idCollisionModelManagerLocal::checkCount ) {
+				if ( tw->vertexChecks[edge->vertexNum[j]].checkcount == tw->checkCount ) {
 					continue;
 				}
 
@@ -238,19 +215,20 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 	for ( i = 0; i < p->numEdges; i++ ) {
 		edgeNum = p->edges[i];
 		edge = tw->model->edges + abs(edgeNum);
+		ec = tw->edgeChecks + abs(edgeNum);
 		// reset sidedness cache if this is the first time we encounter this edge
-		if ( edge->checkcount != idCollisionModelManagerLocal::checkCount ) {
-			edge->sideSet = 0;
+		if ( ec->checkcount != tw->checkCount ) {
+			ec->sideSet = 0;
 		}
 		// pluecker coordinate for edge
 		tw->polygonEdgePlueckerCache[i].FromLine( tw->model->vertices[edge->vertexNum[0]].p,
 													tw->model->vertices[edge->vertexNum[1]].p );
-		v = &tw->model->vertices[edge->vertexNum[INTSIGNBITSET(edgeNum)]];
+		vc = &tw->vertexChecks[edge->vertexNum[INTSIGNBITSET(edgeNum)]];
 		// reset sidedness cache if this is the first time we encounter this vertex
-		if ( v->checkcount != idCollisionModelManagerLocal::checkCount ) {
-			v->sideSet = 0;
+		if ( vc->checkcount != tw->checkCount ) {
+			vc->sideSet = 0;
 		}
-		v->checkcount = idCollisionModelManagerLocal::checkCount;
+		vc->checkcount = tw->checkCount;
 	}
 
 	// get side of polygon for each trm vertex
@@ -270,10 +248,10 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 		// test if trm edge goes through the polygon between the polygon edges
 		for ( j = 0; j < p->numEdges; j++ ) {
 			edgeNum = p->edges[j];
-			edge = tw->model->edges + abs(edgeNum);
+			ec = tw->edgeChecks + abs(edgeNum);
 #if 1
-			CM_SetTrmEdgeSidedness( edge, tw->edges[i].pl, tw->polygonEdgePlueckerCache[j], i );
-			if ( INTSIGNBITSET(edgeNum) ^ ((edge->side >> i) & 1) ^ flip ) {
+			CM_SetTrmEdgeSidedness( ec, tw->edges[i].pl, tw->polygonEdgePlueckerCache[j], i );
+			if ( INTSIGNBITSET(edgeNum) ^ ((ec->side >> i) & 1) ^ flip ) {
 				break;
 			}
 #else
@@ -311,17 +289,18 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 	for ( i = 0; i < p->numEdges; i++ ) {
 		edgeNum = p->edges[i];
 		edge = tw->model->edges + abs(edgeNum);
-		if ( edge->checkcount == idCollisionModelManagerLocal::checkCount ) {
+		ec = tw->edgeChecks + abs(edgeNum);
+		if ( ec->checkcount == tw->checkCount ) {
 			continue;
 		}
-		edge->checkcount = idCollisionModelManagerLocal::checkCount;
+		ec->checkcount = tw->checkCount;
 
 		for ( j = 0; j < tw->numPolys; j++ ) {
 #if 1
-			v1 = tw->model->vertices + edge->vertexNum[0];
-			CM_SetTrmPolygonSidedness( v1, tw->polys[j].plane, j );
-			v2 = tw->model->vertices + edge->vertexNum[1];
-			CM_SetTrmPolygonSidedness( v2, tw->polys[j].plane, j );
+			v1 = tw->vertexChecks + edge->vertexNum[0];
+			CM_SetTrmPolygonSidedness( v1, tw->model->vertices[edge->vertexNum[0]].p, tw->polys[j].plane, j );
+			v2 = tw->vertexChecks + edge->vertexNum[1];
+			CM_SetTrmPolygonSidedness( v2, tw->model->vertices[edge->vertexNum[1]].p, tw->polys[j].plane, j );
 			// if the polygon edge does not cross the trm polygon plane
 			if ( !(((v1->side ^ v2->side) >> j) & 1) ) {
 				continue;
@@ -330,10 +309,8 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 #else
 			float d1, d2;
 
-			v1 = tw->model->vertices + edge->vertexNum[0];
-			d1 = tw->polys[j].plane.Distance( v1->p );
-			v2 = tw->model->vertices + edge->vertexNum[1];
-			d2 = tw->polys[j].plane.Distance( v2->p );
+			d1 = tw->polys[j].plane.Distance( tw->model->vertices[edge->vertexNum[0]].p );
+			d2 = tw->polys[j].plane.Distance( tw->model->vertices[edge->vertexNum[1]].p );
 			// if the polygon edge does not cross the trm polygon plane
 			if ( (d1 >= 0.0f && d2 >= 0.0f) || (d1 <= 0.0f && d2 <= 0.0f) ) {
 				continue;
@@ -349,8 +326,8 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 				trmEdge = tw->edges + abs(trmEdgeNum);
 #if 1
 				bitNum = abs(trmEdgeNum);
-				CM_SetTrmEdgeSidedness( edge, trmEdge->pl, tw->polygonEdgePlueckerCache[i], bitNum );
-				if ( INTSIGNBITSET(trmEdgeNum) ^ ((edge->side >> bitNum) & 1) ^ flip ) {
+				CM_SetTrmEdgeSidedness( ec, trmEdge->pl, tw->polygonEdgePlueckerCache[i], bitNum );
+				if ( INTSIGNBITSET(trmEdgeNum) ^ ((ec->side >> bitNum) & 1) ^ flip ) {
 					break;
 				}
 #else
@@ -392,19 +369,19 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 idCollisionModelManagerLocal::PointNode
 ================
 */
-cm_node_t *idCollisionModelManagerLocal::PointNode( const idVec3 &p, cm_model_t *model ) {
-	cm_node_t *node;
+const cm_flatNode_t *idCollisionModelManagerLocal::PointNode( const idVec3 &p, cm_model_t *model ) {
+	const cm_flatNode_t *node;
 
-	node = model->node;
+	node = model->flatNodes;
 	while ( node->planeType != -1 ) {
 		if (p[node->planeType] > node->planeDist) {
-			node = node->children[0];
+			assert( node->children[0] != -1 );
+			node = model->flatNodes + node->children[0];
 		}
 		else {
-			node = node->children[1];
+			assert( node->children[1] != -1 );
+			node = model->flatNodes + node->children[1];
 		}
-
-		assert( node != NULL );
 	}
 	return node;
 }
@@ -414,29 +391,30 @@ cm_node_t *idCollisionModelManagerLocal::PointNode( const idVec3 &p, cm_model_t
 idCollisionModelManagerLocal::PointContents
 ================
 */
-int idCollisionModelManagerLocal::PointContents( const idVec3 p, cmHandle_t model ) {
-	int i;
+int idCollisionModelManagerLocal::PointContents( const idVec3 p, cm_model_t *model ) {
+	int i, j;
 	float d;
-	cm_node_t *node;
-	cm_brushRef_t *bref;
+	const cm_flatNode_t *node;
+	const cm_flatBrush_t *fb;
 	cm_brush_t *b;
 	idPlane *plane;
 
-	node = idCollisionModelManagerLocal::PointNode( p, idCollisionModelManagerLocal::models[model] );
-	for ( bref = node->brushes; bref; bref = bref->next ) {
-		b = bref->b;
+	node = idCollisionModelManagerLocal::PointNode( p, model );
+	for ( j = 0; j < node->numBrushes; j++ ) {
+		fb = model->flatBrushes + node->firstBrush + j;
 		// test if the point is within the brush bounds
 		for ( i = 0; i < 3; i++ ) {
-			if ( p[i] < b->bounds[0][i] ) {
+			if ( p[i] < fb->bounds[0][i] ) {
 				break;
 			}
-			if ( p[i] > b->bounds[1][i] ) {
+			if ( p[i] > fb->bounds[1][i] ) {
 				break;
 			}
 		}
 		if ( i < 3 ) {
 			continue;
 		}
+		b = fb->b;
 		// test if the point is inside the brush
 		plane = b->planes;
 		for ( i = 0; i < b->numPlanes; i++, plane++ ) {
@@ -457,7 +435,7 @@ int idCollisionModelManagerLocal::PointContents( const idVec3 p, cmHandle_t mode
 idCollisionModelManagerLocal::TransformedPointContents
 ==================
 */
-int	idCollisionModelManagerLocal::TransformedPointContents( const idVec3 &p, cmHandle_t model, const idVec3 &origin, const idMat3 &modelAxis ) {
+int	idCollisionModelManagerLocal::TransformedPointContents( const idVec3 &p, cm_model_t *model, const idVec3 &origin, const idMat3 &modelAxis ) {
 	idVec3 p_l;
 
 	// subtract origin offset
@@ -474,21 +452,20 @@ int	idCollisionModelManagerLocal::TransformedPointContents( const idVec3 &p, cmH
 idCollisionModelManagerLocal::ContentsTrm
 ==================
 */
-int idCollisionModelManagerLocal::ContentsTrm( trace_t *results, const idVec3 &start,
+int idCollisionModelManagerLocal::ContentsTrm( cm_traceContext_t *ctx, trace_t *results, const idVec3 &start,
 									const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
 									cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis ) {
 	int i;
 	bool model_rotated, trm_rotated;
 	idMat3 invModelAxis, tmpAxis;
 	idVec3 dir;
-	ALIGN16( cm_traceWork_t tw );
 
 	// fast point case
 	if ( !trm || ( trm->bounds[1][0] - trm->bounds[0][0] <= 0.0f &&
 					trm->bounds[1][1] - trm->bounds[0][1] <= 0.0f &&
 					trm->bounds[1][2] - trm->bounds[0][2] <= 0.0f ) ) {
 
-		results->c.contents = idCollisionModelManagerLocal::TransformedPointContents( start, model, modelOrigin, modelAxis );
+		results->c.contents = idCollisionModelManagerLocal::TransformedPointContents( start, ModelForHandle( ctx, model ), modelOrigin, modelAxis );
 		results->fraction = ( results->c.contents == 0 );
 		results->endpos = start;
 		results->endAxis = trmAxis;
@@ -496,7 +473,8 @@ int idCollisionModelManagerLocal::ContentsTrm( trace_t *results, const idVec3 &s
 		return results->c.contents;
 	}
 
-	idCollisionModelManagerLocal::checkCount++;
+	cm_traceWork_t &tw = ctx->tw;
+	SetupTraceWork( ctx, &tw, model );
 
 	tw.trace.fraction = 1.0f;
 	tw.trace.c.contents = 0;
@@ -508,7 +486,6 @@ int idCollisionModelManagerLocal::ContentsTrm( trace_t *results, const idVec3 &s
 	tw.pointTrace = false;
 	tw.quickExit = false;
 	tw.numContacts = 0;
-	tw.model = idCollisionModelManagerLocal::models[model];
 	tw.start = start - modelOrigin;
 	tw.end = tw.start;
 
@@ -626,15 +603,17 @@ int idCollisionModelManagerLocal::Contents( const idVec3 &start,
 									const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
 									cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis ) {
 	trace_t results;
+	cm_traceContext_t *ctx;
 
 	if ( model < 0 || model > idCollisionModelManagerLocal::maxModels || model > MAX_SUBMODELS ) {
 		common->Printf("idCollisionModelManagerLocal::Contents: invalid model handle\n");
 		return 0;
 	}
-	if ( !idCollisionModelManagerLocal::models || !idCollisionModelManagerLocal::models[model] ) {
+	ctx = GetTraceContext();
+	if ( !ModelForHandle( ctx, model ) ) {
 		common->Printf("idCollisionModelManagerLocal::Contents: invalid model\n");
 		return 0;
 	}
 
-	return ContentsTrm( &results, start, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
+	return ContentsTrm( ctx, &results, start, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
 }
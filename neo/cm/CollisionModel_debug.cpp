@@ -37,6 +37,8 @@ If you have questions concerning this license or the applicable additional terms
 #include "sys/platform.h"
 #include "idlib/Timer.h"
 #include "framework/Common.h"
+#include "framework/CmdSystem.h"
+#include "framework/FileSystem.h"
 #include "framework/Session.h"
 #include "renderer/Material.h"
 #include "renderer/RenderWorld.h"
@@ -327,7 +329,11 @@ void idCollisionModelManagerLocal::DrawModel( cmHandle_t handle, const idVec3 &m
 		cm_drawColor.ClearModified();
 	}
 
-	model = models[ handle ];
+	// trace model handles are only valid on the thread that set them up
+	model = ModelForHandle( GetTraceContext(), handle );
+	if ( !model ) {
+		return;
+	}
 	viewPos = (viewOrigin - modelOrigin) * modelAxis.Transpose();
 	checkCount++;
 	DrawNodePolygons( model, model->node, modelOrigin, modelAxis, viewPos, radius );
@@ -489,3 +495,525 @@ void idCollisionModelManagerLocal::DebugOutput( const idVec3 &origin ) {
 	Mem_Free( testend );
 	testend = NULL;
 }
+
+/*
+===============================================================================
+
+Thread stress test
+
+===============================================================================
+*/
+
+#define CM_TEST_QUERIES			4096
+#define CM_TEST_JOBS			16
+#define CM_TEST_PASSES			4
+#define CM_TEST_CONTENTS_MASK	-1		// all contents
+#define CM_TEST_TRACEMODELS		4
+
+enum {
+	CM_TEST_TRANSLATION,
+	CM_TEST_ROTATION,
+	CM_TEST_CONTENTS,
+	CM_TEST_TRM_TRANSLATION,	// translation against a trace model set up on the tracing thread
+	CM_TEST_POINT				// translation of a point
+};
+
+typedef struct cm_testQuery_s {
+	int						type;
+	const idTraceModel *	trm;
+	const idTraceModel *	otherTrm;
+	idVec3					start;
+	idVec3					end;
+	idRotation				rotation;
+	idMat3					trmAxis;
+	idVec3					modelOrigin;
+	trace_t					result;
+} cm_testQuery_t;
+
+typedef struct cm_testJob_s {
+	cm_testQuery_t *		queries;
+	int						numQueries;
+} cm_testJob_t;
+
+/*
+================
+CM_RunTestQueries
+================
+*/
+static void CM_RunTestQueries( cm_testJob_t *job ) {
+	int i;
+	cmHandle_t handle;
+
+	for ( i = 0; i < job->numQueries; i++ ) {
+		cm_testQuery_t &q = job->queries[i];
+
+		memset( &q.result, 0, sizeof( q.result ) );
+		switch( q.type ) {
+			case CM_TEST_POINT:
+			case CM_TEST_TRANSLATION:
+				collisionModelManager->Translation( &q.result, q.start, q.end, q.trm, q.trmAxis, CM_TEST_CONTENTS_MASK, 0, vec3_origin, mat3_identity );
+				break;
+			case CM_TEST_ROTATION:
+				collisionModelManager->Rotation( &q.result, q.start, q.rotation, q.trm, q.trmAxis, CM_TEST_CONTENTS_MASK, 0, vec3_origin, mat3_identity );
+				break;
+			case CM_TEST_CONTENTS:
+				q.result.c.contents = collisionModelManager->Contents( q.start, q.trm, q.trmAxis, CM_TEST_CONTENTS_MASK, 0, vec3_origin, mat3_identity );
+				break;
+			case CM_TEST_TRM_TRANSLATION:
+				handle = collisionModelManager->SetupTrmModel( *q.otherTrm, NULL );
+				collisionModelManager->Translation( &q.result, q.start, q.end, q.trm, q.trmAxis, CM_TEST_CONTENTS_MASK, handle, q.modelOrigin, mat3_identity );
+				break;
+		}
+	}
+}
+
+/*
+================
+CM_CompareTestResults
+================
+*/
+static bool CM_CompareTestResults( const cm_testQuery_t &q, const trace_t &a, const trace_t &b ) {
+	if ( a.fraction != b.fraction || a.c.contents != b.c.contents ) {
+		return false;
+	}
+	if ( q.type == CM_TEST_CONTENTS ) {
+		return true;
+	}
+	if ( !a.endpos.Compare( b.endpos ) || !a.endAxis.Compare( b.endAxis ) ) {
+		return false;
+	}
+	if ( a.c.type != b.c.type || !a.c.point.Compare( b.c.point ) || !a.c.normal.Compare( b.c.normal ) || a.c.dist != b.c.dist || a.c.trmFeature != b.c.trmFeature ) {
+		return false;
+	}
+	// features of trace models are per thread memory
+	if ( q.type != CM_TEST_TRM_TRANSLATION && a.c.modelFeature != b.c.modelFeature ) {
+		return false;
+	}
+	return true;
+}
+
+/*
+================
+CM_SetupTestTraceModels
+================
+*/
+static void CM_SetupTestTraceModels( idTraceModel trms[CM_TEST_TRACEMODELS] ) {
+	trms[0].SetupBox( 16.0f );
+	trms[1].SetupBox( idBounds( idVec3( -16, -16, 0 ), idVec3( 16, 16, 64 ) ) );
+	trms[2].SetupCylinder( idBounds( idVec3( -12, -12, 0 ), idVec3( 12, 12, 48 ) ), 8 );
+	trms[3].SetupDodecahedron( 24.0f );
+}
+
+/*
+================
+CM_CreateTestQueries
+
+  creates random queries inside the bounds, of the given type or of random types if type is -1
+  mixed queries use a point instead of a trace model one in five times
+================
+*/
+static void CM_CreateTestQueries( cm_testQuery_t *queries, int numQueries, int type, const idBounds &bounds, const idTraceModel trms[CM_TEST_TRACEMODELS], idRandom &random ) {
+	int i, j;
+	idVec3 size, dir;
+
+	size = bounds[1] - bounds[0];
+	for ( i = 0; i < numQueries; i++ ) {
+		cm_testQuery_t &q = queries[i];
+
+		q.type = ( type == -1 ) ? random.RandomInt( 4 ) : type;
+		j = random.RandomInt( CM_TEST_TRACEMODELS + 1 );
+		if ( type != -1 ) {
+			j = ( type == CM_TEST_POINT ) ? CM_TEST_TRACEMODELS : j % CM_TEST_TRACEMODELS;
+		}
+		q.trm = ( j < CM_TEST_TRACEMODELS ) ? &trms[j] : NULL;
+		q.otherTrm = &trms[random.RandomInt( CM_TEST_TRACEMODELS )];
+		for ( j = 0; j < 3; j++ ) {
+			q.start[j] = bounds[0][j] + random.RandomFloat() * size[j];
+			dir[j] = random.CRandomFloat();
+		}
+		dir.Normalize();
+		q.end = q.start + dir * ( 16.0f + random.RandomFloat() * 512.0f );
+		q.trmAxis = ( random.RandomInt( 2 ) ) ? idAngles( 0.0f, random.RandomFloat() * 360.0f, 0.0f ).ToMat3() : mat3_identity;
+		q.rotation = idRotation( q.start + idVec3( random.CRandomFloat(), random.CRandomFloat(), random.CRandomFloat() ) * 32.0f, dir, random.CRandomFloat() * 90.0f );
+		q.modelOrigin = q.start + ( q.end - q.start ) * random.RandomFloat();
+		if ( q.type == CM_TEST_TRM_TRANSLATION && !q.trm ) {
+			q.trm = &trms[0];
+		}
+	}
+}
+
+/*
+================
+idCollisionModelManager::TestThreads_f
+
+  runs the same random queries on the calling thread and in parallel jobs and compares the results
+================
+*/
+void idCollisionModelManager::TestThreads_f( const idCmdArgs &args ) {
+	int i, pass, numMismatches, queriesPerJob;
+	idBounds worldBounds;
+	idRandom random;
+	cm_testQuery_t *queries;
+	trace_t *reference;
+	cm_testJob_t jobs[CM_TEST_JOBS];
+	idParallelJobList *jobList;
+
+	if ( !collisionModelManager->GetModelBounds( 0, worldBounds ) ) {
+		common->Printf( "no map loaded\n" );
+		return;
+	}
+
+	random.SetSeed( args.Argc() > 1 ? atoi( args.Argv( 1 ) ) : 0 );
+
+	idTraceModel trms[CM_TEST_TRACEMODELS];
+	CM_SetupTestTraceModels( trms );
+
+	queries = new cm_testQuery_t[CM_TEST_QUERIES];
+	reference = new trace_t[CM_TEST_QUERIES];
+
+	CM_CreateTestQueries( queries, CM_TEST_QUERIES, -1, worldBounds, trms, random );
+
+	// reference results on the calling thread
+	jobs[0].queries = queries;
+	jobs[0].numQueries = CM_TEST_QUERIES;
+	CM_RunTestQueries( &jobs[0] );
+	for ( i = 0; i < CM_TEST_QUERIES; i++ ) {
+		reference[i] = queries[i].result;
+	}
+
+	queriesPerJob = CM_TEST_QUERIES / CM_TEST_JOBS;
+	for ( i = 0; i < CM_TEST_JOBS; i++ ) {
+		jobs[i].queries = queries + i * queriesPerJob;
+		jobs[i].numQueries = queriesPerJob;
+	}
+
+	jobList = parallelJobManager->AllocJobList( "CM_RunTestQueries" );
+
+	numMismatches = 0;
+	for ( pass = 0; pass < CM_TEST_PASSES; pass++ ) {
+		for ( i = 0; i < CM_TEST_JOBS; i++ ) {
+			jobList->AddJob( (jobRun_t)CM_RunTestQueries, &jobs[i] );
+		}
+		jobList->Submit();
+		jobList->Wait();
+		jobList->Clear();
+
+		for ( i = 0; i < CM_TEST_QUERIES; i++ ) {
+			if ( !CM_CompareTestResults( queries[i], queries[i].result, reference[i] ) ) {
+				if ( numMismatches < 8 ) {
+					common->Printf( "pass %d query %d (type %d) differs: fraction %f != %f\n", pass, i, queries[i].type, queries[i].result.fraction, reference[i].fraction );
+				}
+				numMismatches++;
+			}
+		}
+	}
+
+	parallelJobManager->FreeJobList( jobList );
+
+	delete[] queries;
+	delete[] reference;
+
+	common->Printf( "%d queries x %d passes on %d worker threads: %d mismatches\n", CM_TEST_QUERIES, CM_TEST_PASSES, parallelJobManager->GetNumWorkerThreads(), numMismatches );
+}
+
+/*
+===============================================================================
+
+Trace benchmark
+
+===============================================================================
+*/
+
+#define CM_GOLDEN_ID			"CMGT"
+#define CM_GOLDEN_VERSION		1
+#define CM_GOLDEN_EXT			"cmgolden"
+
+static const int cm_benchTypes[] = { CM_TEST_POINT, CM_TEST_TRANSLATION, CM_TEST_ROTATION, CM_TEST_CONTENTS, CM_TEST_TRM_TRANSLATION };
+static const char *cm_testTypeNames[] = { "translation", "rotation", "contents", "trm translation", "point" };	// indexed by type
+
+/*
+================
+CM_CompareInts
+================
+*/
+static int CM_CompareInts( const void *a, const void *b ) {
+	return *(const int *)a - *(const int *)b;
+}
+
+/*
+================
+CM_PrintDistribution
+
+  sorts the values
+================
+*/
+static void CM_PrintDistribution( const char *name, int *values, int numValues ) {
+	int i;
+	double total;
+
+	qsort( values, numValues, sizeof( values[0] ), CM_CompareInts );
+	total = 0.0;
+	for ( i = 0; i < numValues; i++ ) {
+		total += values[i];
+	}
+	common->Printf( "%18s: min %5d, avg %8.1f, median %5d, 90%% %5d, 99%% %5d, max %5d\n", name, values[0], total / numValues,
+					values[numValues / 2], values[numValues * 9 / 10], values[numValues * 99 / 100], values[numValues - 1] );
+}
+
+/*
+================
+CM_WriteGoldenTrace
+================
+*/
+static void CM_WriteGoldenTrace( idFile *f, const trace_t &trace ) {
+	f->WriteFloat( trace.fraction );
+	f->WriteVec3( trace.endpos );
+	f->WriteMat3( trace.endAxis );
+	f->WriteInt( trace.c.type );
+	f->WriteVec3( trace.c.point );
+	f->WriteVec3( trace.c.normal );
+	f->WriteFloat( trace.c.dist );
+	f->WriteInt( trace.c.contents );
+	f->WriteInt( trace.c.modelFeature );
+	f->WriteInt( trace.c.trmFeature );
+}
+
+/*
+================
+CM_ReadGoldenTrace
+================
+*/
+static void CM_ReadGoldenTrace( idFile *f, trace_t &trace ) {
+	int type;
+
+	memset( &trace, 0, sizeof( trace ) );
+	f->ReadFloat( trace.fraction );
+	f->ReadVec3( trace.endpos );
+	f->ReadMat3( trace.endAxis );
+	f->ReadInt( type );
+	trace.c.type = (contactType_t) type;
+	f->ReadVec3( trace.c.point );
+	f->ReadVec3( trace.c.normal );
+	f->ReadFloat( trace.c.dist );
+	f->ReadInt( trace.c.contents );
+	f->ReadInt( trace.c.modelFeature );
+	f->ReadInt( trace.c.trmFeature );
+}
+
+/*
+================
+CM_GoldenHeader
+
+  writes the golden file header or checks whether the golden file was written for the same queries
+================
+*/
+static bool CM_GoldenHeader( idFile *golden, bool writeGolden, int numQueries, int seed ) {
+	char id[4];
+	int version, goldenQueries, goldenSeed;
+	idStr goldenMap;
+	const char *mapName = collisionModelManager->GetModelName( 0 );
+
+	if ( writeGolden ) {
+		golden->Write( CM_GOLDEN_ID, 4 );
+		golden->WriteInt( CM_GOLDEN_VERSION );
+		golden->WriteString( mapName );
+		golden->WriteInt( numQueries );
+		golden->WriteInt( seed );
+		return true;
+	}
+
+	golden->Read( id, 4 );
+	golden->ReadInt( version );
+	if ( memcmp( id, CM_GOLDEN_ID, 4 ) != 0 || version != CM_GOLDEN_VERSION ) {
+		common->Printf( "%s is not a version %d collision golden file\n", golden->GetName(), CM_GOLDEN_VERSION );
+		return false;
+	}
+	golden->ReadString( goldenMap );
+	golden->ReadInt( goldenQueries );
+	golden->ReadInt( goldenSeed );
+	if ( goldenMap.Icmp( mapName ) != 0 || goldenQueries != numQueries || goldenSeed != seed ) {
+		common->Printf( "%s was written for %s with %d queries and seed %d\n", golden->GetName(), goldenMap.c_str(), goldenQueries, goldenSeed );
+		return false;
+	}
+	return true;
+}
+
+/*
+================
+CM_BenchTraces
+================
+*/
+static void CM_BenchTraces( int numQueries, int seed, idFile *golden, bool writeGolden ) {
+	int i, j, type, run, numMismatches, totalMismatches;
+	double startMsec, msec, bestMsec;
+	idBounds worldBounds;
+	idRandom random;
+	cm_testQuery_t *queries;
+	cm_testJob_t job;
+	cm_traceStats_t before, after;
+	int *numPolygons, *numEdges;
+	trace_t goldenTrace;
+
+	if ( !collisionModelManager->GetModelBounds( 0, worldBounds ) ) {
+		common->Printf( "no map loaded\n" );
+		return;
+	}
+
+	if ( golden && !CM_GoldenHeader( golden, writeGolden, numQueries, seed ) ) {
+		return;
+	}
+
+	idTraceModel trms[CM_TEST_TRACEMODELS];
+	CM_SetupTestTraceModels( trms );
+
+	queries = new cm_testQuery_t[numQueries];
+	numPolygons = new int[numQueries];
+	numEdges = new int[numQueries];
+
+	common->Printf( "%d queries per type against %s, seed %d\n", numQueries, collisionModelManager->GetModelName( 0 ), seed );
+
+	totalMismatches = 0;
+	for ( i = 0; i < (int)( sizeof( cm_benchTypes ) / sizeof( cm_benchTypes[0] ) ); i++ ) {
+		type = cm_benchTypes[i];
+
+		// the same queries every time so runs can be compared
+		random.SetSeed( seed + type );
+		CM_CreateTestQueries( queries, numQueries, type, worldBounds, trms, random );
+		job.queries = queries;
+		job.numQueries = numQueries;
+
+		// best of a few runs, the first one also warms up the caches
+		bestMsec = idMath::INFINITY;
+		for ( run = 0; run < 3; run++ ) {
+			startMsec = Sys_MillisecondsPrecise();
+			CM_RunTestQueries( &job );
+			msec = Sys_MillisecondsPrecise() - startMsec;
+			if ( msec < bestMsec ) {
+				bestMsec = msec;
+			}
+		}
+		common->Printf( "%16s: %d queries in %6.2f msec, %8.0f queries/sec\n", cm_testTypeNames[type], numQueries, bestMsec, bestMsec > 0.0 ? numQueries * 1000.0 / bestMsec : 0.0 );
+
+		// features tested by each query, not timed
+		job.numQueries = 1;
+		for ( j = 0; j < numQueries; j++ ) {
+			collisionModelManagerLocal.GetTraceStats( before );
+			job.queries = &queries[j];
+			CM_RunTestQueries( &job );
+			collisionModelManagerLocal.GetTraceStats( after );
+			numPolygons[j] = after.numPolygons - before.numPolygons;
+			numEdges[j] = after.numEdges - before.numEdges;
+		}
+		CM_PrintDistribution( "polygons tested", numPolygons, numQueries );
+		CM_PrintDistribution( "edges tested", numEdges, numQueries );
+
+		if ( !golden ) {
+			continue;
+		}
+		if ( writeGolden ) {
+			for ( j = 0; j < numQueries; j++ ) {
+				CM_WriteGoldenTrace( golden, queries[j].result );
+			}
+			continue;
+		}
+		numMismatches = 0;
+		for ( j = 0; j < numQueries; j++ ) {
+			CM_ReadGoldenTrace( golden, goldenTrace );
+			if ( !CM_CompareTestResults( queries[j], queries[j].result, goldenTrace ) ) {
+				if ( numMismatches < 8 ) {
+					common->Printf( "%s query %d differs from the golden result: fraction %f != %f\n", cm_testTypeNames[type], j, queries[j].result.fraction, goldenTrace.fraction );
+				}
+				numMismatches++;
+			}
+		}
+		totalMismatches += numMismatches;
+	}
+
+	if ( golden ) {
+		if ( writeGolden ) {
+			common->Printf( "wrote golden results to %s\n", golden->GetName() );
+		} else {
+			common->Printf( "%d mismatches against the golden results in %s\n", totalMismatches, golden->GetName() );
+		}
+	}
+
+	delete[] queries;
+	delete[] numPolygons;
+	delete[] numEdges;
+}
+
+/*
+================
+idCollisionModelManager::BenchTraces_f
+
+  measures how many random queries of each type are run per second on the calling thread and how many
+  polygons and edges they test, the map is loaded without a game or renderer when given, the results
+  can be written to a golden file and compared against it after changing the collision detection
+================
+*/
+void idCollisionModelManager::BenchTraces_f( const idCmdArgs &args ) {
+	int i, numQueries, seed;
+	bool writeGolden;
+	idStr arg, mapName, goldenName;
+	idMapFile *mapFile;
+	idFile *golden;
+
+	numQueries = CM_TEST_QUERIES;
+	seed = 0;
+	writeGolden = false;
+	for ( i = 1; i < args.Argc(); i++ ) {
+		arg = args.Argv( i );
+		if ( arg.Icmp( "map" ) == 0 && i + 1 < args.Argc() ) {
+			mapName = args.Argv( ++i );
+		} else if ( arg.Icmp( "seed" ) == 0 && i + 1 < args.Argc() ) {
+			seed = atoi( args.Argv( ++i ) );
+		} else if ( ( arg.Icmp( "writeGolden" ) == 0 || arg.Icmp( "checkGolden" ) == 0 ) && i + 1 < args.Argc() ) {
+			writeGolden = ( arg.Icmp( "writeGolden" ) == 0 );
+			goldenName = args.Argv( ++i );
+		} else if ( arg.IsNumeric() && atoi( arg ) > 0 ) {
+			numQueries = atoi( arg );
+		} else {
+			common->Printf( "usage: benchCollision [numQueries] [map <mapName>] [seed <seed>] [writeGolden|checkGolden <file>]\n" );
+			return;
+		}
+	}
+
+	golden = NULL;
+	if ( goldenName.Length() ) {
+		goldenName.DefaultFileExtension( "." CM_GOLDEN_EXT );
+		golden = writeGolden ? fileSystem->OpenFileWrite( goldenName ) : fileSystem->OpenFileRead( goldenName );
+		if ( !golden ) {
+			common->Printf( "couldn't open %s\n", goldenName.c_str() );
+			return;
+		}
+	}
+
+	mapFile = NULL;
+	if ( mapName.Length() ) {
+		if ( mapName.Icmpn( "maps/", 5 ) != 0 ) {
+			mapName = "maps/" + mapName;
+		}
+		mapFile = new idMapFile;
+		if ( !mapFile->Parse( mapName ) ) {
+			common->Printf( "couldn't load %s\n", mapName.c_str() );
+			delete mapFile;
+			if ( golden ) {
+				fileSystem->CloseFile( golden );
+			}
+			return;
+		}
+		// make sure the collision model manager is not used by the game
+		cmdSystem->BufferCommandText( CMD_EXEC_NOW, "disconnect" );
+		collisionModelManager->LoadMap( mapFile );
+	}
+
+	CM_BenchTraces( numQueries, seed, golden, writeGolden );
+
+	if ( mapFile ) {
+		collisionModelManager->FreeMap();
+		delete mapFile;
+	}
+	if ( golden ) {
+		fileSystem->CloseFile( golden );
+	}
+}
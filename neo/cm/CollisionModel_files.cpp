@@ -45,6 +45,94 @@ If you have questions concerning this license or the applicable additional terms
 #define CM_FILEID			"CM"
 #define CM_FILEVERSION		"1.00"
 
+#define CMB_FILE_EXT		"cmb"
+#define CMB_FILEID			( ( 'B' << 24 ) | ( 'M' << 16 ) | ( 'C' << 8 ) | 'I' )	// little endian "ICMB"
+#define CMB_FILEVERSION		1
+
+idCVar cm_binaryCache( "cm_binaryCache", "1", CVAR_SYSTEM | CVAR_BOOL, "load collision models from binary .cmb files and write those when loading or building .cm files" );
+
+/*
+===============================================================================
+
+	Binary collision model file
+
+	A cached copy of a .cm file that can be loaded without any parsing. All data
+	is stored in flat arrays referencing each other by index. The models follow
+	the header, all offsets in a model are relative to the start of that model.
+	Everything is little endian.
+
+===============================================================================
+*/
+
+typedef struct cmbHeader_s {
+	int					ident;
+	int					version;
+	unsigned int		mapFileCRC;
+	int					numModels;
+} cmbHeader_t;
+
+#define CMB_MODEL_CONVEX	1
+
+typedef struct cmbModel_s {
+	int					flags;
+	int					numVertices;
+	int					ofsVertices;
+	int					numEdges;
+	int					ofsEdges;
+	int					numNodes;
+	int					ofsNodes;
+	int					numPolygons;
+	int					ofsPolygons;
+	int					numBrushes;
+	int					ofsBrushes;
+	int					numPolygonRefs;
+	int					ofsPolygonRefs;		// polygon numbers
+	int					numBrushRefs;
+	int					ofsBrushRefs;		// brush numbers
+	int					numStrings;
+	int					ofsStrings;			// model name followed by the material names
+	int					ofsEnd;				// start of the next model
+} cmbModel_t;
+
+typedef struct cmbVertex_s {
+	float				p[3];
+} cmbVertex_t;
+
+typedef struct cmbEdge_s {
+	int					vertexNum[2];
+	unsigned short		internal;
+	unsigned short		numUsers;
+} cmbEdge_t;
+
+typedef struct cmbNode_s {
+	int					planeType;
+	float				planeDist;
+	int					children[2];		// node numbers, children are stored after their parent
+	int					firstPolygonRef;
+	int					numPolygonRefs;
+	int					firstBrushRef;
+	int					numBrushRefs;
+} cmbNode_t;
+
+typedef struct cmbPolygon_s {
+	int					numEdges;
+	int					material;			// index into the material names
+	float				plane[4];
+	float				bounds[2][3];
+	int					edges[1];			// variable sized
+} cmbPolygon_t;
+
+typedef struct cmbBrush_s {
+	int					numPlanes;
+	int					material;			// index into the material names, -1 if none
+	int					contents;
+	float				bounds[2][3];
+	float				planes[1][4];		// variable sized
+} cmbBrush_t;
+
+#define CMB_POLYGON_SIZE( numEdges )	( (int) sizeof( cmbPolygon_t ) + ( (numEdges) - 1 ) * (int) sizeof( int ) )
+#define CMB_BRUSH_SIZE( numPlanes )		( (int) sizeof( cmbBrush_t ) + ( (numPlanes) - 1 ) * (int) sizeof( float[4] ) )
+
 /*
 ===============================================================================
 
@@ -306,6 +394,241 @@ bool idCollisionModelManagerLocal::WriteCollisionModelForMapEntity( const idMapE
 	return true;
 }
 
+/*
+===============================================================================
+
+Writing of binary collision model file
+
+===============================================================================
+*/
+
+/*
+================
+CM_GetBinaryNodes_r
+
+  collects the nodes depth first so children always follow their parent
+================
+*/
+static void CM_GetBinaryNodes_r( cm_node_t *node, idList<cm_node_t *> &nodes, idList<int> &secondChild ) {
+	int index;
+
+	index = nodes.Append( node );
+	secondChild.Append( -1 );
+	if ( node->planeType != -1 ) {
+		CM_GetBinaryNodes_r( node->children[0], nodes, secondChild );
+		secondChild[index] = nodes.Num();
+		CM_GetBinaryNodes_r( node->children[1], nodes, secondChild );
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::WriteBinaryCollisionModel
+================
+*/
+void idCollisionModelManagerLocal::WriteBinaryCollisionModel( idFile *fp, cm_model_t *model ) {
+	int i, j, numRefs, firstPolygonRef, firstBrushRef, stringSize;
+	cmbModel_t header;
+	cm_node_t *node;
+	cm_polygonRef_t *pref;
+	cm_brushRef_t *bref;
+	cm_polygon_t *p;
+	cm_brush_t *b;
+	idList<cm_node_t *> nodes;
+	idList<cm_polygon_t *> polygons;
+	idList<cm_brush_t *> brushes;
+	idList<int> secondChild, polygonNums, brushNums;
+	idList<int> polygonRefs, brushRefs;
+	idList<const idMaterial *> materials;
+
+	nodes.SetGranularity( 1024 );
+	secondChild.SetGranularity( 1024 );
+	polygons.SetGranularity( 1024 );
+	brushes.SetGranularity( 1024 );
+	polygonRefs.SetGranularity( 1024 );
+	brushRefs.SetGranularity( 1024 );
+
+	CM_GetBinaryNodes_r( model->node, nodes, secondChild );
+
+	// number the polygons and brushes in the order they are first referenced
+	polygonNums.SetNum( model->maxPolygons );
+	memset( polygonNums.Ptr(), -1, model->maxPolygons * sizeof( int ) );
+	brushNums.SetNum( model->maxBrushes );
+	memset( brushNums.Ptr(), -1, model->maxBrushes * sizeof( int ) );
+
+	for ( i = 0; i < nodes.Num(); i++ ) {
+		for ( pref = nodes[i]->polygons; pref; pref = pref->next ) {
+			p = pref->p;
+			if ( !p ) {
+				continue;
+			}
+			if ( polygonNums[p->checkNum] == -1 ) {
+				polygonNums[p->checkNum] = polygons.Append( p );
+				materials.AddUnique( p->material );
+			}
+			polygonRefs.Append( polygonNums[p->checkNum] );
+		}
+		for ( bref = nodes[i]->brushes; bref; bref = bref->next ) {
+			b = bref->b;
+			if ( !b ) {
+				continue;
+			}
+			if ( brushNums[b->checkNum] == -1 ) {
+				brushNums[b->checkNum] = brushes.Append( b );
+				if ( b->material ) {
+					materials.AddUnique( b->material );
+				}
+			}
+			brushRefs.Append( brushNums[b->checkNum] );
+		}
+	}
+
+	// layout of the model
+	header.flags = model->isConvex ? CMB_MODEL_CONVEX : 0;
+	header.numVertices = model->numVertices;
+	header.ofsVertices = sizeof( cmbModel_t );
+	header.numEdges = model->numEdges;
+	header.ofsEdges = header.ofsVertices + header.numVertices * sizeof( cmbVertex_t );
+	header.numNodes = nodes.Num();
+	header.ofsNodes = header.ofsEdges + header.numEdges * sizeof( cmbEdge_t );
+	header.numPolygons = polygons.Num();
+	header.ofsPolygons = header.ofsNodes + header.numNodes * sizeof( cmbNode_t );
+	header.numBrushes = brushes.Num();
+	header.ofsBrushes = header.ofsPolygons;
+	for ( i = 0; i < polygons.Num(); i++ ) {
+		header.ofsBrushes += CMB_POLYGON_SIZE( polygons[i]->numEdges );
+	}
+	header.numPolygonRefs = polygonRefs.Num();
+	header.ofsPolygonRefs = header.ofsBrushes;
+	for ( i = 0; i < brushes.Num(); i++ ) {
+		header.ofsPolygonRefs += CMB_BRUSH_SIZE( brushes[i]->numPlanes );
+	}
+	header.numBrushRefs = brushRefs.Num();
+	header.ofsBrushRefs = header.ofsPolygonRefs + header.numPolygonRefs * sizeof( int );
+	header.numStrings = 1 + materials.Num();
+	header.ofsStrings = header.ofsBrushRefs + header.numBrushRefs * sizeof( int );
+	stringSize = model->name.Length() + 1;
+	for ( i = 0; i < materials.Num(); i++ ) {
+		stringSize += idStr::Length( materials[i]->GetName() ) + 1;
+	}
+	header.ofsEnd = header.ofsStrings + ( ( stringSize + 3 ) & ~3 );
+
+	for ( i = 0; i < (int)( sizeof( header ) / sizeof( int ) ); i++ ) {
+		fp->WriteInt( ( (int *) &header )[i] );
+	}
+
+	// vertices
+	for ( i = 0; i < model->numVertices; i++ ) {
+		fp->WriteFloat( model->vertices[i].p[0] );
+		fp->WriteFloat( model->vertices[i].p[1] );
+		fp->WriteFloat( model->vertices[i].p[2] );
+	}
+	// edges
+	for ( i = 0; i < model->numEdges; i++ ) {
+		fp->WriteInt( model->edges[i].vertexNum[0] );
+		fp->WriteInt( model->edges[i].vertexNum[1] );
+		fp->WriteUnsignedShort( model->edges[i].internal );
+		fp->WriteUnsignedShort( model->edges[i].numUsers );
+	}
+	// nodes, the references are stored in the same order as the node lists
+	firstPolygonRef = firstBrushRef = 0;
+	for ( i = 0; i < nodes.Num(); i++ ) {
+		node = nodes[i];
+		fp->WriteInt( node->planeType );
+		fp->WriteFloat( node->planeDist );
+		if ( node->planeType != -1 ) {
+			// the first child directly follows the parent
+			fp->WriteInt( i + 1 );
+			fp->WriteInt( secondChild[i] );
+		} else {
+			fp->WriteInt( -1 );
+			fp->WriteInt( -1 );
+		}
+		for ( numRefs = 0, pref = node->polygons; pref; pref = pref->next ) {
+			numRefs += ( pref->p != NULL );
+		}
+		fp->WriteInt( firstPolygonRef );
+		fp->WriteInt( numRefs );
+		firstPolygonRef += numRefs;
+		for ( numRefs = 0, bref = node->brushes; bref; bref = bref->next ) {
+			numRefs += ( bref->b != NULL );
+		}
+		fp->WriteInt( firstBrushRef );
+		fp->WriteInt( numRefs );
+		firstBrushRef += numRefs;
+	}
+	// polygons
+	for ( i = 0; i < polygons.Num(); i++ ) {
+		p = polygons[i];
+		fp->WriteInt( p->numEdges );
+		fp->WriteInt( materials.FindIndex( p->material ) );
+		fp->WriteVec4( p->plane.ToVec4() );
+		fp->WriteVec3( p->bounds[0] );
+		fp->WriteVec3( p->bounds[1] );
+		for ( j = 0; j < p->numEdges; j++ ) {
+			fp->WriteInt( p->edges[j] );
+		}
+	}
+	// brushes
+	for ( i = 0; i < brushes.Num(); i++ ) {
+		b = brushes[i];
+		fp->WriteInt( b->numPlanes );
+		fp->WriteInt( b->material ? materials.FindIndex( b->material ) : -1 );
+		fp->WriteInt( b->contents );
+		fp->WriteVec3( b->bounds[0] );
+		fp->WriteVec3( b->bounds[1] );
+		for ( j = 0; j < b->numPlanes; j++ ) {
+			fp->WriteVec4( b->planes[j].ToVec4() );
+		}
+	}
+	// references
+	for ( i = 0; i < polygonRefs.Num(); i++ ) {
+		fp->WriteInt( polygonRefs[i] );
+	}
+	for ( i = 0; i < brushRefs.Num(); i++ ) {
+		fp->WriteInt( brushRefs[i] );
+	}
+	// strings
+	fp->Write( model->name.c_str(), model->name.Length() + 1 );
+	for ( i = 0; i < materials.Num(); i++ ) {
+		fp->Write( materials[i]->GetName(), idStr::Length( materials[i]->GetName() ) + 1 );
+	}
+	for ( ; stringSize & 3; stringSize++ ) {
+		fp->WriteChar( 0 );
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::WriteBinaryCollisionModelsToFile
+================
+*/
+void idCollisionModelManagerLocal::WriteBinaryCollisionModelsToFile( const char *filename, int firstModel, int lastModel, unsigned int mapFileCRC ) {
+	int i;
+	idFile *fp;
+	idStr name;
+
+	name = filename;
+	name.SetFileExtension( CMB_FILE_EXT );
+
+	fp = fileSystem->OpenFileWrite( name, "fs_devpath" );
+	if ( !fp ) {
+		common->DPrintf( "idCollisionModelManagerLocal::WriteBinaryCollisionModelsToFile: Error opening file %s\n", name.c_str() );
+		return;
+	}
+
+	fp->WriteInt( CMB_FILEID );
+	fp->WriteInt( CMB_FILEVERSION );
+	fp->WriteUnsignedInt( mapFileCRC );
+	fp->WriteInt( lastModel - firstModel );
+
+	for ( i = firstModel; i < lastModel; i++ ) {
+		WriteBinaryCollisionModel( fp, models[ i ] );
+	}
+
+	fileSystem->CloseFile( fp );
+}
+
 
 /*
 ===============================================================================
@@ -329,8 +652,6 @@ void idCollisionModelManagerLocal::ParseVertices( idLexer *src, cm_model_t *mode
 	model->vertices = (cm_vertex_t *) Mem_Alloc( model->maxVertices * sizeof( cm_vertex_t ) );
 	for ( i = 0; i < model->numVertices; i++ ) {
 		src->Parse1DMatrix( 3, model->vertices[i].p.ToFloatPtr() );
-		model->vertices[i].side = 0;
-		model->vertices[i].sideSet = 0;
 		model->vertices[i].checkcount = 0;
 	}
 	src->ExpectTokenString( "}" );
@@ -353,8 +674,6 @@ void idCollisionModelManagerLocal::ParseEdges( idLexer *src, cm_model_t *model )
 		model->edges[i].vertexNum[0] = src->ParseInt();
 		model->edges[i].vertexNum[1] = src->ParseInt();
 		src->ExpectTokenString( ")" );
-		model->edges[i].side = 0;
-		model->edges[i].sideSet = 0;
 		model->edges[i].internal = src->ParseInt();
 		model->edges[i].numUsers = src->ParseInt();
 		model->edges[i].normal = vec3_origin;
@@ -544,6 +863,8 @@ bool idCollisionModelManagerLocal::ParseCollisionModel( idLexer *src ) {
 						model->numNodes * sizeof(cm_node_t) +
 						model->numPolygonRefs * sizeof(cm_polygonRef_t) +
 						model->numBrushRefs * sizeof(cm_brushRef_t);
+	// create the flat tree used for collision detection
+	BuildFlatTree( model );
 
 	return true;
 }
@@ -558,6 +879,12 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char *name, uns
 	idToken token;
 	idLexer *src;
 	unsigned int crc;
+	int firstModel;
+
+	// try the binary file first
+	if ( cm_binaryCache.GetBool() && LoadBinaryCollisionModelFile( name, mapFileCRC ) ) {
+		return true;
+	}
 
 	// load it
 	fileName = name;
@@ -595,6 +922,7 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char *name, uns
 	}
 
 	// parse the file
+	firstModel = numModels;
 	while ( 1 ) {
 		if ( !src->ReadToken( &token ) ) {
 			break;
@@ -613,5 +941,436 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char *name, uns
 
 	delete src;
 
+	// write the binary file so the models load faster next time
+	if ( cm_binaryCache.GetBool() ) {
+		WriteBinaryCollisionModelsToFile( name, firstModel, numModels, crc );
+	}
+
+	return true;
+}
+
+/*
+===============================================================================
+
+Loading of binary collision model file
+
+===============================================================================
+*/
+
+/*
+================
+CM_CheckBinaryLump
+================
+*/
+static bool CM_CheckBinaryLump( int ofs, int num, int elementSize, int end ) {
+	if ( num < 0 || ofs < (int) sizeof( cmbModel_t ) || ofs > end || ( ofs & 3 ) ) {
+		return false;
+	}
+	return ( num <= ( end - ofs ) / elementSize );
+}
+
+/*
+================
+CM_CheckBinaryRefs
+================
+*/
+static bool CM_CheckBinaryRefs( int first, int num, int numRefs ) {
+	return ( first >= 0 && num >= 0 && first <= numRefs - num );
+}
+
+/*
+================
+idCollisionModelManagerLocal::ParseBinaryCollisionModel
+
+  validates the whole model before anything is allocated, so a corrupt file never leaves a partial model behind
+================
+*/
+bool idCollisionModelManagerLocal::ParseBinaryCollisionModel( const byte *buffer, int size, int &offset ) {
+	int i, j, ofs, end, num, polygonMemory, brushMemory;
+	const byte *base;
+	const char *str;
+	const cmbVertex_t *inVertex;
+	const cmbEdge_t *inEdge;
+	const cmbNode_t *inNode;
+	const cmbPolygon_t *inPolygon;
+	const cmbBrush_t *inBrush;
+	const int *inPolygonRefs, *inBrushRefs;
+	cmbModel_t header;
+	cm_model_t *model;
+	cm_node_t *node;
+	cm_polygon_t *p;
+	cm_brush_t *b;
+	cm_polygonRef_t *pref, **lastPref;
+	cm_brushRef_t *bref, **lastBref;
+	idList<const char *> strings;
+	idList<const idMaterial *> materials;
+	idList<cm_node_t *> nodes;
+	idList<cm_polygon_t *> polygons;
+	idList<cm_brush_t *> brushes;
+	idList<bool> isChild;
+
+	if ( numModels >= MAX_SUBMODELS ) {
+		common->Error( "LoadModel: no free slots" );
+		return false;
+	}
+
+	if ( offset < 0 || offset > size - (int) sizeof( cmbModel_t ) ) {
+		return false;
+	}
+	base = buffer + offset;
+	for ( i = 0; i < (int)( sizeof( header ) / sizeof( int ) ); i++ ) {
+		( (int *) &header )[i] = LittleInt( ( (const int *) base )[i] );
+	}
+	end = header.ofsEnd;
+	if ( end < (int) sizeof( cmbModel_t ) || end > size - offset || ( end & 3 ) ) {
+		return false;
+	}
+
+	if ( !CM_CheckBinaryLump( header.ofsVertices, header.numVertices, sizeof( cmbVertex_t ), end ) ||
+			!CM_CheckBinaryLump( header.ofsEdges, header.numEdges, sizeof( cmbEdge_t ), end ) ||
+				!CM_CheckBinaryLump( header.ofsNodes, header.numNodes, sizeof( cmbNode_t ), end ) ||
+					!CM_CheckBinaryLump( header.ofsPolygons, header.numPolygons, CMB_POLYGON_SIZE( 1 ), end ) ||
+						!CM_CheckBinaryLump( header.ofsBrushes, header.numBrushes, CMB_BRUSH_SIZE( 1 ), end ) ||
+							!CM_CheckBinaryLump( header.ofsPolygonRefs, header.numPolygonRefs, sizeof( int ), end ) ||
+								!CM_CheckBinaryLump( header.ofsBrushRefs, header.numBrushRefs, sizeof( int ), end ) ||
+									!CM_CheckBinaryLump( header.ofsStrings, header.numStrings, 1, end ) ) {
+		return false;
+	}
+	if ( header.numNodes < 1 || header.numStrings < 1 ) {
+		return false;
+	}
+
+	inVertex = (const cmbVertex_t *) ( base + header.ofsVertices );
+	inEdge = (const cmbEdge_t *) ( base + header.ofsEdges );
+	inNode = (const cmbNode_t *) ( base + header.ofsNodes );
+	inPolygonRefs = (const int *) ( base + header.ofsPolygonRefs );
+	inBrushRefs = (const int *) ( base + header.ofsBrushRefs );
+
+	// strings
+	strings.SetNum( header.numStrings );
+	ofs = header.ofsStrings;
+	for ( i = 0; i < header.numStrings; i++ ) {
+		str = (const char *) base + ofs;
+		if ( ofs >= end || !memchr( str, 0, end - ofs ) ) {
+			return false;
+		}
+		strings[i] = str;
+		ofs += strlen( str ) + 1;
+	}
+
+	// edges
+	for ( i = 0; i < header.numEdges; i++ ) {
+		for ( j = 0; j < 2; j++ ) {
+			num = LittleInt( inEdge[i].vertexNum[j] );
+			if ( num < 0 || num >= header.numVertices ) {
+				return false;
+			}
+		}
+	}
+
+	// polygons
+	polygonMemory = 0;
+	ofs = header.ofsPolygons;
+	for ( i = 0; i < header.numPolygons; i++ ) {
+		if ( ofs > end - CMB_POLYGON_SIZE( 1 ) ) {
+			return false;
+		}
+		inPolygon = (const cmbPolygon_t *) ( base + ofs );
+		num = LittleInt( inPolygon->numEdges );
+		if ( num < 1 || num > ( end - ofs - CMB_POLYGON_SIZE( 1 ) ) / (int) sizeof( int ) + 1 ) {
+			return false;
+		}
+		j = LittleInt( inPolygon->material );
+		if ( j < 0 || j >= header.numStrings - 1 ) {
+			return false;
+		}
+		for ( j = 0; j < num; j++ ) {
+			if ( abs( LittleInt( inPolygon->edges[j] ) ) >= header.numEdges ) {
+				return false;
+			}
+		}
+		polygonMemory += sizeof( cm_polygon_t ) + ( num - 1 ) * sizeof( p->edges[0] );
+		ofs += CMB_POLYGON_SIZE( num );
+	}
+
+	// brushes
+	brushMemory = 0;
+	ofs = header.ofsBrushes;
+	for ( i = 0; i < header.numBrushes; i++ ) {
+		if ( ofs > end - CMB_BRUSH_SIZE( 1 ) ) {
+			return false;
+		}
+		inBrush = (const cmbBrush_t *) ( base + ofs );
+		num = LittleInt( inBrush->numPlanes );
+		if ( num < 1 || num > ( end - ofs - CMB_BRUSH_SIZE( 1 ) ) / (int) sizeof( float[4] ) + 1 ) {
+			return false;
+		}
+		j = LittleInt( inBrush->material );
+		if ( j < -1 || j >= header.numStrings - 1 ) {
+			return false;
+		}
+		brushMemory += sizeof( cm_brush_t ) + ( num - 1 ) * sizeof( b->planes[0] );
+		ofs += CMB_BRUSH_SIZE( num );
+	}
+
+	// references
+	for ( i = 0; i < header.numPolygonRefs; i++ ) {
+		num = LittleInt( inPolygonRefs[i] );
+		if ( num < 0 || num >= header.numPolygons ) {
+			return false;
+		}
+	}
+	for ( i = 0; i < header.numBrushRefs; i++ ) {
+		num = LittleInt( inBrushRefs[i] );
+		if ( num < 0 || num >= header.numBrushes ) {
+			return false;
+		}
+	}
+
+	// nodes have to form a tree with every child stored after its parent
+	isChild.SetNum( header.numNodes );
+	memset( isChild.Ptr(), 0, header.numNodes * sizeof( bool ) );
+	for ( i = 0; i < header.numNodes; i++ ) {
+		num = LittleInt( inNode[i].planeType );
+		if ( num < -1 || num > 2 ) {
+			return false;
+		}
+		if ( num != -1 ) {
+			for ( j = 0; j < 2; j++ ) {
+				num = LittleInt( inNode[i].children[j] );
+				if ( num <= i || num >= header.numNodes || isChild[num] ) {
+					return false;
+				}
+				isChild[num] = true;
+			}
+		}
+		if ( !CM_CheckBinaryRefs( LittleInt( inNode[i].firstPolygonRef ), LittleInt( inNode[i].numPolygonRefs ), header.numPolygonRefs ) ||
+				!CM_CheckBinaryRefs( LittleInt( inNode[i].firstBrushRef ), LittleInt( inNode[i].numBrushRefs ), header.numBrushRefs ) ) {
+			return false;
+		}
+	}
+
+	// everything checks out, create the model
+	model = AllocModel();
+	model->name = strings[0];
+	model->isConvex = ( header.flags & CMB_MODEL_CONVEX ) != 0;
+
+	materials.SetNum( header.numStrings - 1 );
+	for ( i = 0; i < materials.Num(); i++ ) {
+		materials[i] = declManager->FindMaterial( strings[i + 1] );
+	}
+
+	// vertices
+	model->numVertices = model->maxVertices = header.numVertices;
+	model->vertices = (cm_vertex_t *) Mem_Alloc( model->maxVertices * sizeof( cm_vertex_t ) );
+	for ( i = 0; i < model->numVertices; i++ ) {
+		model->vertices[i].p[0] = LittleFloat( inVertex[i].p[0] );
+		model->vertices[i].p[1] = LittleFloat( inVertex[i].p[1] );
+		model->vertices[i].p[2] = LittleFloat( inVertex[i].p[2] );
+		model->vertices[i].checkcount = 0;
+	}
+
+	// edges
+	model->numEdges = model->maxEdges = header.numEdges;
+	model->edges = (cm_edge_t *) Mem_Alloc( model->maxEdges * sizeof( cm_edge_t ) );
+	for ( i = 0; i < model->numEdges; i++ ) {
+		model->edges[i].vertexNum[0] = LittleInt( inEdge[i].vertexNum[0] );
+		model->edges[i].vertexNum[1] = LittleInt( inEdge[i].vertexNum[1] );
+		model->edges[i].internal = LittleShort( inEdge[i].internal );
+		model->edges[i].numUsers = LittleShort( inEdge[i].numUsers );
+		model->edges[i].normal = vec3_origin;
+		model->edges[i].checkcount = 0;
+		model->numInternalEdges += model->edges[i].internal;
+	}
+
+	// all polygons are allocated from a single block
+	if ( polygonMemory ) {
+		model->polygonBlock = (cm_polygonBlock_t *) Mem_Alloc( sizeof( cm_polygonBlock_t ) + polygonMemory );
+		model->polygonBlock->bytesRemaining = polygonMemory;
+		model->polygonBlock->next = ( (byte *) model->polygonBlock ) + sizeof( cm_polygonBlock_t );
+	}
+	polygons.SetNum( header.numPolygons );
+	ofs = header.ofsPolygons;
+	for ( i = 0; i < header.numPolygons; i++ ) {
+		inPolygon = (const cmbPolygon_t *) ( base + ofs );
+		num = LittleInt( inPolygon->numEdges );
+		p = AllocPolygon( model, num );
+		p->numEdges = num;
+		for ( j = 0; j < num; j++ ) {
+			p->edges[j] = LittleInt( inPolygon->edges[j] );
+		}
+		p->plane = idPlane( LittleFloat( inPolygon->plane[0] ), LittleFloat( inPolygon->plane[1] ), LittleFloat( inPolygon->plane[2] ), LittleFloat( inPolygon->plane[3] ) );
+		for ( j = 0; j < 3; j++ ) {
+			p->bounds[0][j] = LittleFloat( inPolygon->bounds[0][j] );
+			p->bounds[1][j] = LittleFloat( inPolygon->bounds[1][j] );
+		}
+		p->material = materials[LittleInt( inPolygon->material )];
+		p->contents = p->material->GetContentFlags();
+		p->checkcount = 0;
+		polygons[i] = p;
+		ofs += CMB_POLYGON_SIZE( num );
+	}
+
+	// all brushes are allocated from a single block
+	if ( brushMemory ) {
+		model->brushBlock = (cm_brushBlock_t *) Mem_Alloc( sizeof( cm_brushBlock_t ) + brushMemory );
+		model->brushBlock->bytesRemaining = brushMemory;
+		model->brushBlock->next = ( (byte *) model->brushBlock ) + sizeof( cm_brushBlock_t );
+	}
+	brushes.SetNum( header.numBrushes );
+	ofs = header.ofsBrushes;
+	for ( i = 0; i < header.numBrushes; i++ ) {
+		inBrush = (const cmbBrush_t *) ( base + ofs );
+		num = LittleInt( inBrush->numPlanes );
+		b = AllocBrush( model, num );
+		b->numPlanes = num;
+		for ( j = 0; j < num; j++ ) {
+			b->planes[j] = idPlane( LittleFloat( inBrush->planes[j][0] ), LittleFloat( inBrush->planes[j][1] ), LittleFloat( inBrush->planes[j][2] ), LittleFloat( inBrush->planes[j][3] ) );
+		}
+		for ( j = 0; j < 3; j++ ) {
+			b->bounds[0][j] = LittleFloat( inBrush->bounds[0][j] );
+			b->bounds[1][j] = LittleFloat( inBrush->bounds[1][j] );
+		}
+		j = LittleInt( inBrush->material );
+		b->material = ( j >= 0 ) ? materials[j] : NULL;
+		b->contents = LittleInt( inBrush->contents );
+		b->checkcount = 0;
+		b->primitiveNum = 0;
+		brushes[i] = b;
+		ofs += CMB_BRUSH_SIZE( num );
+	}
+
+	// all nodes and references are allocated from a single block each
+	nodes.SetNum( header.numNodes );
+	for ( i = 0; i < header.numNodes; i++ ) {
+		nodes[i] = AllocNode( model, header.numNodes );
+	}
+	for ( i = 0; i < header.numNodes; i++ ) {
+		node = nodes[i];
+		node->planeType = LittleInt( inNode[i].planeType );
+		node->planeDist = LittleFloat( inNode[i].planeDist );
+		if ( node->planeType != -1 ) {
+			for ( j = 0; j < 2; j++ ) {
+				node->children[j] = nodes[LittleInt( inNode[i].children[j] )];
+				node->children[j]->parent = node;
+			}
+		}
+		// keep the reference lists in the order they were written
+		lastPref = &node->polygons;
+		num = LittleInt( inNode[i].firstPolygonRef );
+		for ( j = 0; j < LittleInt( inNode[i].numPolygonRefs ); j++ ) {
+			pref = AllocPolygonReference( model, header.numPolygonRefs );
+			pref->p = polygons[LittleInt( inPolygonRefs[num + j] )];
+			*lastPref = pref;
+			lastPref = &pref->next;
+		}
+		*lastPref = NULL;
+		lastBref = &node->brushes;
+		num = LittleInt( inNode[i].firstBrushRef );
+		for ( j = 0; j < LittleInt( inNode[i].numBrushRefs ); j++ ) {
+			bref = AllocBrushReference( model, header.numBrushRefs );
+			bref->b = brushes[LittleInt( inBrushRefs[num + j] )];
+			*lastBref = bref;
+			lastBref = &bref->next;
+		}
+		*lastBref = NULL;
+	}
+	model->node = nodes[0];
+	model->numNodes = header.numNodes;
+	model->numPolygonRefs = header.numPolygonRefs;
+	model->numBrushRefs = header.numBrushRefs;
+
+	// calculate edge normals
+	checkCount++;
+	CalculateEdgeNormals( model, model->node );
+	// get model bounds from brush and polygon bounds
+	CM_GetNodeBounds( &model->bounds, model->node );
+	// get model contents
+	model->contents = CM_GetNodeContents( model->node );
+	// total memory used by this model
+	model->usedMemory = model->numVertices * sizeof(cm_vertex_t) +
+						model->numEdges * sizeof(cm_edge_t) +
+						model->polygonMemory +
+						model->brushMemory +
+						model->numNodes * sizeof(cm_node_t) +
+						model->numPolygonRefs * sizeof(cm_polygonRef_t) +
+						model->numBrushRefs * sizeof(cm_brushRef_t);
+	// create the flat tree used for collision detection
+	BuildFlatTree( model );
+
+	models[numModels] = model;
+	numModels++;
+
+	offset += end;
+
+	return true;
+}
+
+/*
+================
+idCollisionModelManagerLocal::LoadBinaryCollisionModelFile
+================
+*/
+bool idCollisionModelManagerLocal::LoadBinaryCollisionModelFile( const char *name, unsigned int mapFileCRC ) {
+	int i, size, offset, firstModel;
+	idStr fileName, textFileName;
+	byte *buffer;
+	const cmbHeader_t *header;
+	ID_TIME_T binaryTime, textTime;
+
+	fileName = name;
+	fileName.SetFileExtension( CMB_FILE_EXT );
+	size = fileSystem->ReadFile( fileName, (void **) &buffer, &binaryTime );
+	if ( !buffer ) {
+		return false;
+	}
+
+	// the binary file is out of date if the .cm file was changed after it was written
+	textFileName = name;
+	textFileName.SetFileExtension( CM_FILE_EXT );
+	fileSystem->ReadFile( textFileName, NULL, &textTime );
+	if ( textTime != FILE_NOT_FOUND_TIMESTAMP && textTime > binaryTime ) {
+		common->Printf( "%s is older than %s\n", fileName.c_str(), textFileName.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	header = (const cmbHeader_t *) buffer;
+	if ( size < (int) sizeof( cmbHeader_t ) || LittleInt( header->ident ) != CMB_FILEID ) {
+		common->Warning( "%s is not a CMB file.", fileName.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	if ( LittleInt( header->version ) != CMB_FILEVERSION ) {
+		common->Warning( "%s has version %d instead of %d", fileName.c_str(), LittleInt( header->version ), CMB_FILEVERSION );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	if ( mapFileCRC && (unsigned int) LittleInt( header->mapFileCRC ) != mapFileCRC ) {
+		common->Printf( "%s is out of date\n", fileName.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	firstModel = numModels;
+	offset = sizeof( cmbHeader_t );
+	for ( i = 0; i < LittleInt( header->numModels ); i++ ) {
+		if ( !ParseBinaryCollisionModel( buffer, size, offset ) ) {
+			common->Warning( "%s is corrupt", fileName.c_str() );
+			// free the models of this file that were already loaded
+			while ( numModels > firstModel ) {
+				numModels--;
+				FreeModel( models[numModels] );
+				models[numModels] = NULL;
+			}
+			fileSystem->FreeFile( buffer );
+			return false;
+		}
+	}
+
+	fileSystem->FreeFile( buffer );
+
 	return true;
 }
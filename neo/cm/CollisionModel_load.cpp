@@ -185,15 +185,9 @@ void idCollisionModelManagerLocal::Clear( void ) {
 	maxModels = 0;
 	numModels = 0;
 	models = NULL;
-	memset( trmPolygons, 0, sizeof( trmPolygons ) );
-	trmBrushes[0] = NULL;
 	trmMaterial = NULL;
 	numProcNodes = 0;
 	procNodes = NULL;
-	getContacts = false;
-	contacts = NULL;
-	maxContacts = 0;
-	numContacts = 0;
 }
 
 /*
@@ -393,6 +387,10 @@ void idCollisionModelManagerLocal::FreeModel( cm_model_t *model ) {
 	Mem_Free( model->polygonBlock );
 	// free block allocated brushes
 	Mem_Free( model->brushBlock );
+	// free the flat tree
+	Mem_Free( model->flatNodes );
+	Mem_Free( model->flatPolygons );
+	Mem_Free( model->flatBrushes );
 	// free edges
 	Mem_Free( model->edges );
 	// free vertices
@@ -410,6 +408,7 @@ void idCollisionModelManagerLocal::FreeMap( void ) {
 	int i;
 
 	if ( !loaded ) {
+		FreeTraceContexts();
 		Clear();
 		return;
 	}
@@ -421,7 +420,7 @@ void idCollisionModelManagerLocal::FreeMap( void ) {
 		FreeModel( models[i] );
 	}
 
-	FreeTrmModelStructure();
+	FreeTraceContexts();
 
 	Mem_Free( models );
 
@@ -435,22 +434,22 @@ void idCollisionModelManagerLocal::FreeMap( void ) {
 idCollisionModelManagerLocal::FreeTrmModelStructure
 ================
 */
-void idCollisionModelManagerLocal::FreeTrmModelStructure( void ) {
+void idCollisionModelManagerLocal::FreeTrmModelStructure( cm_traceContext_t *ctx ) {
 	int i;
 
-	assert( models );
-	if ( !models[MAX_SUBMODELS] ) {
+	if ( !ctx->trmModel ) {
 		return;
 	}
 
 	for ( i = 0; i < MAX_TRACEMODEL_POLYS; i++ ) {
-		FreePolygon( models[MAX_SUBMODELS], trmPolygons[i]->p );
+		FreePolygon( ctx->trmModel, ctx->trmPolygons[i]->p );
 	}
-	FreeBrush( models[MAX_SUBMODELS], trmBrushes[0]->b );
+	FreeBrush( ctx->trmModel, ctx->trmBrushes[0]->b );
 
-	models[MAX_SUBMODELS]->node->polygons = NULL;
-	models[MAX_SUBMODELS]->node->brushes = NULL;
-	FreeModel( models[MAX_SUBMODELS] );
+	ctx->trmModel->node->polygons = NULL;
+	ctx->trmModel->node->brushes = NULL;
+	FreeModel( ctx->trmModel );
+	ctx->trmModel = NULL;
 }
 
 
@@ -549,12 +548,20 @@ cm_model_t *idCollisionModelManagerLocal::AllocModel( void ) {
 	model->maxEdges = 0;
 	model->numEdges = 0;
 	model->edges= NULL;
+	model->maxPolygons = 0;
+	model->maxBrushes = 0;
 	model->node = NULL;
 	model->nodeBlocks = NULL;
 	model->polygonRefBlocks = NULL;
 	model->brushRefBlocks = NULL;
 	model->polygonBlock = NULL;
 	model->brushBlock = NULL;
+	model->numFlatNodes = 0;
+	model->flatNodes = NULL;
+	model->numFlatPolygons = 0;
+	model->flatPolygons = NULL;
+	model->numFlatBrushes = 0;
+	model->flatBrushes = NULL;
 	model->numPolygons = model->polygonMemory =
 	model->numBrushes = model->brushMemory =
 	model->numNodes = model->numBrushRefs =
@@ -672,6 +679,7 @@ cm_polygon_t *idCollisionModelManagerLocal::AllocPolygon( cm_model_t *model, int
 	} else {
 		poly = (cm_polygon_t *) Mem_Alloc( size );
 	}
+	poly->checkNum = model->maxPolygons++;
 	return poly;
 }
 
@@ -694,6 +702,7 @@ cm_brush_t *idCollisionModelManagerLocal::AllocBrush( cm_model_t *model, int num
 	} else {
 		brush = (cm_brush_t *) Mem_Alloc( size );
 	}
+	brush->checkNum = model->maxBrushes++;
 	return brush;
 }
 
@@ -732,7 +741,7 @@ void idCollisionModelManagerLocal::AddBrushToNode( cm_model_t *model, cm_node_t
 idCollisionModelManagerLocal::SetupTrmModelStructure
 ================
 */
-void idCollisionModelManagerLocal::SetupTrmModelStructure( void ) {
+void idCollisionModelManagerLocal::SetupTrmModelStructure( cm_traceContext_t *ctx ) {
 	int i;
 	cm_node_t *node;
 	cm_model_t *model;
@@ -740,8 +749,7 @@ void idCollisionModelManagerLocal::SetupTrmModelStructure( void ) {
 	// setup model
 	model = AllocModel();
 
-	assert( models );
-	models[MAX_SUBMODELS] = model;
+	ctx->trmModel = model;
 	// create node to hold the collision data
 	node = (cm_node_t *) AllocNode( model, 1 );
 	node->planeType = -1;
@@ -753,39 +761,39 @@ void idCollisionModelManagerLocal::SetupTrmModelStructure( void ) {
 	model->numEdges = 0;
 	model->maxEdges = MAX_TRACEMODEL_EDGES+1;
 	model->edges = (cm_edge_t *) Mem_ClearedAlloc( model->maxEdges * sizeof(cm_edge_t) );
-	// create a material for the trace model polygons
-	trmMaterial = declManager->FindMaterial( "_tracemodel", false );
-	if ( !trmMaterial ) {
-		common->FatalError( "_tracemodel material not found" );
-	}
 
 	// allocate polygons
 	for ( i = 0; i < MAX_TRACEMODEL_POLYS; i++ ) {
-		trmPolygons[i] = AllocPolygonReference( model, MAX_TRACEMODEL_POLYS );
-		trmPolygons[i]->p = AllocPolygon( model, MAX_TRACEMODEL_POLYEDGES );
-		trmPolygons[i]->p->bounds.Clear();
-		trmPolygons[i]->p->plane.Zero();
-		trmPolygons[i]->p->checkcount = 0;
-		trmPolygons[i]->p->contents = -1;		// all contents
-		trmPolygons[i]->p->material = trmMaterial;
-		trmPolygons[i]->p->numEdges = 0;
+		ctx->trmPolygons[i] = AllocPolygonReference( model, MAX_TRACEMODEL_POLYS );
+		ctx->trmPolygons[i]->p = AllocPolygon( model, MAX_TRACEMODEL_POLYEDGES );
+		ctx->trmPolygons[i]->p->bounds.Clear();
+		ctx->trmPolygons[i]->p->plane.Zero();
+		ctx->trmPolygons[i]->p->checkcount = 0;
+		ctx->trmPolygons[i]->p->contents = -1;		// all contents
+		ctx->trmPolygons[i]->p->material = trmMaterial;
+		ctx->trmPolygons[i]->p->numEdges = 0;
 	}
 	// allocate brush for position test
-	trmBrushes[0] = AllocBrushReference( model, 1 );
-	trmBrushes[0]->b = AllocBrush( model, MAX_TRACEMODEL_POLYS );
-	trmBrushes[0]->b->primitiveNum = 0;
-	trmBrushes[0]->b->bounds.Clear();
-	trmBrushes[0]->b->checkcount = 0;
-	trmBrushes[0]->b->contents = -1;		// all contents
-	trmBrushes[0]->b->numPlanes = 0;
+	ctx->trmBrushes[0] = AllocBrushReference( model, 1 );
+	ctx->trmBrushes[0]->b = AllocBrush( model, MAX_TRACEMODEL_POLYS );
+	ctx->trmBrushes[0]->b->primitiveNum = 0;
+	ctx->trmBrushes[0]->b->bounds.Clear();
+	ctx->trmBrushes[0]->b->checkcount = 0;
+	ctx->trmBrushes[0]->b->contents = -1;		// all contents
+	ctx->trmBrushes[0]->b->numPlanes = 0;
+	// the flat tree is refilled for every trace model
+	model->flatNodes = (cm_flatNode_t *) Mem_Alloc( sizeof( cm_flatNode_t ) );
+	model->flatPolygons = (cm_flatPolygon_t *) Mem_Alloc( MAX_TRACEMODEL_POLYS * sizeof( cm_flatPolygon_t ) );
+	model->flatBrushes = (cm_flatBrush_t *) Mem_Alloc( sizeof( cm_flatBrush_t ) );
+	FillFlatTree( model );
 }
 
 /*
 ================
 idCollisionModelManagerLocal::SetupTrmModel
 
-Trace models (item boxes, etc) are converted to collision models on the fly, using the last model slot
-as a reusable temporary buffer
+Trace models (item boxes, etc) are converted to collision models on the fly, using the trace model
+of the trace context as a reusable temporary buffer. So the handle is only valid on the calling thread.
 ================
 */
 cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm, const idMaterial *material ) {
@@ -794,6 +802,7 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 	cm_edge_t *edge;
 	cm_polygon_t *poly;
 	cm_model_t *model;
+	cm_traceContext_t *ctx;
 	const traceModelVert_t *trmVert;
 	const traceModelEdge_t *trmEdge;
 	const traceModelPoly_t *trmPoly;
@@ -804,11 +813,17 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 		material = trmMaterial;
 	}
 
-	model = models[MAX_SUBMODELS];
+	ctx = GetTraceContext();
+	if ( !ctx->trmModel ) {
+		SetupTrmModelStructure( ctx );
+	}
+
+	model = ctx->trmModel;
 	model->node->brushes = NULL;
 	model->node->polygons = NULL;
 	// if not a valid trace model
 	if ( trm.type == TRM_INVALID || !trm.numPolys ) {
+		FillFlatTree( model );
 		return TRACE_MODEL_HANDLE;
 	}
 	// vertices
@@ -817,7 +832,6 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 	trmVert = trm.verts;
 	for ( i = 0; i < trm.numVerts; i++, vertex++, trmVert++ ) {
 		vertex->p = *trmVert;
-		vertex->sideSet = 0;
 	}
 	// edges
 	model->numEdges = trm.numEdges;
@@ -828,13 +842,12 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 		edge->vertexNum[1] = trmEdge->v[1];
 		edge->normal = trmEdge->normal;
 		edge->internal = false;
-		edge->sideSet = 0;
 	}
 	// polygons
 	model->numPolygons = trm.numPolys;
 	trmPoly = trm.polys;
 	for ( i = 0; i < trm.numPolys; i++, trmPoly++ ) {
-		poly = trmPolygons[i]->p;
+		poly = ctx->trmPolygons[i]->p;
 		poly->numEdges = trmPoly->numEdges;
 		for ( j = 0; j < trmPoly->numEdges; j++ ) {
 			poly->edges[j] = trmPoly->edges[j];
@@ -844,26 +857,28 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 		poly->bounds = trmPoly->bounds;
 		poly->material = material;
 		// link polygon at node
-		trmPolygons[i]->next = model->node->polygons;
-		model->node->polygons = trmPolygons[i];
+		ctx->trmPolygons[i]->next = model->node->polygons;
+		model->node->polygons = ctx->trmPolygons[i];
 	}
 	// if the trace model is convex
 	if ( trm.isConvex ) {
 		// setup brush for position test
-		trmBrushes[0]->b->numPlanes = trm.numPolys;
+		ctx->trmBrushes[0]->b->numPlanes = trm.numPolys;
 		for ( i = 0; i < trm.numPolys; i++ ) {
-			trmBrushes[0]->b->planes[i] = trmPolygons[i]->p->plane;
+			ctx->trmBrushes[0]->b->planes[i] = ctx->trmPolygons[i]->p->plane;
 		}
-		trmBrushes[0]->b->bounds = trm.bounds;
+		ctx->trmBrushes[0]->b->bounds = trm.bounds;
 		// link brush at node
-		trmBrushes[0]->next = model->node->brushes;
-		model->node->brushes = trmBrushes[0];
+		ctx->trmBrushes[0]->next = model->node->brushes;
+		model->node->brushes = ctx->trmBrushes[0];
 	}
 	// model bounds
 	model->bounds = trm.bounds;
 	// convex
 	model->isConvex = trm.isConvex;
 
+	FillFlatTree( model );
+
 	return TRACE_MODEL_HANDLE;
 }
 
@@ -1301,7 +1316,7 @@ cm_polygon_t *idCollisionModelManagerLocal::TryMergePolygons( cm_model_t *model,
 	int i, j, nexti, prevj;
 	int p1BeforeShare, p1AfterShare, p2BeforeShare, p2AfterShare;
 	int newEdges[CM_MAX_POLYGON_EDGES], newNumEdges;
-	int edgeNum, edgeNum1, edgeNum2, newEdgeNum1, newEdgeNum2;
+	int edgeNum, edgeNum1, edgeNum2, newEdgeNum1, newEdgeNum2, checkNum;
 	cm_edge_t *edge;
 	cm_polygon_t *newp;
 	idVec3 delta, normal;
@@ -1452,10 +1467,12 @@ cm_polygon_t *idCollisionModelManagerLocal::TryMergePolygons( cm_model_t *model,
 	}
 
 	newp = AllocPolygon( model, newNumEdges );
+	checkNum = newp->checkNum;
 	memcpy( newp, p1, sizeof(cm_polygon_t) );
 	memcpy( newp->edges, newEdges, newNumEdges * sizeof(int) );
 	newp->numEdges = newNumEdges;
 	newp->checkcount = 0;
+	newp->checkNum = checkNum;
 	// increase usage count for the edges of this polygon
 	for ( i = 0; i < newp->numEdges; i++ ) {
 		if ( !keep1 && newp->edges[i] == newEdgeNum1 ) {
@@ -2959,6 +2976,193 @@ void idCollisionModelManagerLocal::FinishModel( cm_model_t *model ) {
 						model->numNodes * sizeof(cm_node_t) +
 						model->numPolygonRefs * sizeof(cm_polygonRef_t) +
 						model->numBrushRefs * sizeof(cm_brushRef_t);
+	// create the flat tree used for collision detection
+	BuildFlatTree( model );
+}
+
+/*
+================
+CM_CountFlatTree_r
+================
+*/
+static void CM_CountFlatTree_r( const cm_node_t *node, int &numNodes, int &numPolygons, int &numBrushes ) {
+	cm_polygonRef_t *pref;
+	cm_brushRef_t *bref;
+
+	numNodes++;
+	for ( pref = node->polygons; pref; pref = pref->next ) {
+		numPolygons += ( pref->p != NULL );
+	}
+	for ( bref = node->brushes; bref; bref = bref->next ) {
+		numBrushes += ( bref->b != NULL );
+	}
+	if ( node->planeType != -1 ) {
+		if ( node->children[0] ) {
+			CM_CountFlatTree_r( node->children[0], numNodes, numPolygons, numBrushes );
+		}
+		if ( node->children[1] ) {
+			CM_CountFlatTree_r( node->children[1], numNodes, numPolygons, numBrushes );
+		}
+	}
+}
+
+/*
+================
+CM_NumberChecks_r
+
+  numbers the polygons and brushes referenced by the tree in the order they are first referenced,
+  with clear set all numbers are reset to -1 instead
+================
+*/
+static void CM_NumberChecks_r( const cm_node_t *node, int &numPolygons, int &numBrushes, bool clear ) {
+	cm_polygonRef_t *pref;
+	cm_brushRef_t *bref;
+
+	for ( pref = node->polygons; pref; pref = pref->next ) {
+		if ( !pref->p ) {
+			continue;
+		}
+		if ( clear ) {
+			pref->p->checkNum = -1;
+		} else if ( pref->p->checkNum == -1 ) {
+			pref->p->checkNum = numPolygons++;
+		}
+	}
+	for ( bref = node->brushes; bref; bref = bref->next ) {
+		if ( !bref->b ) {
+			continue;
+		}
+		if ( clear ) {
+			bref->b->checkNum = -1;
+		} else if ( bref->b->checkNum == -1 ) {
+			bref->b->checkNum = numBrushes++;
+		}
+	}
+	if ( node->planeType != -1 ) {
+		if ( node->children[0] ) {
+			CM_NumberChecks_r( node->children[0], numPolygons, numBrushes, clear );
+		}
+		if ( node->children[1] ) {
+			CM_NumberChecks_r( node->children[1], numPolygons, numBrushes, clear );
+		}
+	}
+}
+
+/*
+================
+CM_FillFlatTree_r
+================
+*/
+static int CM_FillFlatTree_r( cm_model_t *model, const cm_node_t *node ) {
+	int i, nodeNum;
+	cm_flatNode_t *flatNode;
+	cm_flatPolygon_t *flatPolygon;
+	cm_flatBrush_t *flatBrush;
+	cm_polygonRef_t *pref;
+	cm_brushRef_t *bref;
+
+	nodeNum = model->numFlatNodes++;
+	flatNode = &model->flatNodes[nodeNum];
+	flatNode->planeType = node->planeType;
+	flatNode->planeDist = node->planeDist;
+
+	// the spans keep the order of the reference lists
+	flatNode->firstPolygon = model->numFlatPolygons;
+	for ( pref = node->polygons; pref; pref = pref->next ) {
+		if ( !pref->p ) {
+			continue;
+		}
+		flatPolygon = &model->flatPolygons[model->numFlatPolygons++];
+		flatPolygon->bounds = pref->p->bounds;
+		flatPolygon->contents = pref->p->contents;
+		flatPolygon->checkNum = pref->p->checkNum;
+		flatPolygon->p = pref->p;
+	}
+	flatNode->numPolygons = model->numFlatPolygons - flatNode->firstPolygon;
+
+	flatNode->firstBrush = model->numFlatBrushes;
+	for ( bref = node->brushes; bref; bref = bref->next ) {
+		if ( !bref->b ) {
+			continue;
+		}
+		flatBrush = &model->flatBrushes[model->numFlatBrushes++];
+		flatBrush->bounds = bref->b->bounds;
+		flatBrush->contents = bref->b->contents;
+		flatBrush->checkNum = bref->b->checkNum;
+		flatBrush->b = bref->b;
+	}
+	flatNode->numBrushes = model->numFlatBrushes - flatNode->firstBrush;
+
+	flatNode->children[0] = flatNode->children[1] = -1;
+	if ( node->planeType != -1 ) {
+		for ( i = 0; i < 2; i++ ) {
+			if ( node->children[i] ) {
+				flatNode->children[i] = CM_FillFlatTree_r( model, node->children[i] );
+			}
+		}
+	}
+	return nodeNum;
+}
+
+/*
+================
+idCollisionModelManagerLocal::FillFlatTree
+
+  the flat tree arrays have to be large enough to hold the whole tree
+================
+*/
+void idCollisionModelManagerLocal::FillFlatTree( cm_model_t *model ) {
+	model->numFlatNodes = 0;
+	model->numFlatPolygons = 0;
+	model->numFlatBrushes = 0;
+	if ( !model->node ) {
+		// a single empty leaf
+		memset( model->flatNodes, 0, sizeof( cm_flatNode_t ) );
+		model->flatNodes[0].planeType = -1;
+		model->flatNodes[0].children[0] = model->flatNodes[0].children[1] = -1;
+		model->numFlatNodes = 1;
+		return;
+	}
+	CM_FillFlatTree_r( model, model->node );
+}
+
+/*
+================
+idCollisionModelManagerLocal::BuildFlatTree
+
+  must be called whenever the tree of a model is complete, collision detection only uses the flat tree
+================
+*/
+void idCollisionModelManagerLocal::BuildFlatTree( cm_model_t *model ) {
+	int numNodes, numPolygons, numBrushes;
+
+	numNodes = numPolygons = numBrushes = 0;
+	if ( model->node ) {
+		CM_CountFlatTree_r( model->node, numNodes, numPolygons, numBrushes );
+	} else {
+		numNodes = 1;
+	}
+
+	// polygons and brushes freed while the model was built, like the ones merged by MergeTreePolygons,
+	// leave gaps in the check numbers, renumber them so the check arrays of the traces stay small
+	model->maxPolygons = model->maxBrushes = 0;
+	if ( model->node ) {
+		CM_NumberChecks_r( model->node, model->maxPolygons, model->maxBrushes, true );
+		CM_NumberChecks_r( model->node, model->maxPolygons, model->maxBrushes, false );
+	}
+
+	Mem_Free( model->flatNodes );
+	Mem_Free( model->flatPolygons );
+	Mem_Free( model->flatBrushes );
+	model->flatNodes = (cm_flatNode_t *) Mem_Alloc( numNodes * sizeof( cm_flatNode_t ) );
+	model->flatPolygons = (cm_flatPolygon_t *) Mem_Alloc( numPolygons * sizeof( cm_flatPolygon_t ) );
+	model->flatBrushes = (cm_flatBrush_t *) Mem_Alloc( numBrushes * sizeof( cm_flatBrush_t ) );
+
+	FillFlatTree( model );
+
+	model->usedMemory += numNodes * sizeof( cm_flatNode_t ) +
+						numPolygons * sizeof( cm_flatPolygon_t ) +
+						numBrushes * sizeof( cm_flatBrush_t );
 }
 
 /*
@@ -3321,6 +3525,9 @@ void idCollisionModelManagerLocal::BuildModels( const idMapFile *mapFile ) {
 
 		// write the collision models to a file
 		WriteCollisionModelsToFile( mapFile->GetName(), 0, numModels, mapFile->GetGeometryCRC() );
+		if ( cm_binaryCache.GetBool() ) {
+			WriteBinaryCollisionModelsToFile( mapFile->GetName(), 0, numModels, mapFile->GetGeometryCRC() );
+		}
 	}
 
 	timer.Stop();
@@ -3369,8 +3576,11 @@ void idCollisionModelManagerLocal::LoadMap( const idMapFile *mapFile ) {
 	// setup hash to speed up finding shared vertices and edges
 	SetupHash();
 
-	// setup trace model structure
-	SetupTrmModelStructure();
+	// create a material for the trace model polygons
+	trmMaterial = declManager->FindMaterial( "_tracemodel", false );
+	if ( !trmMaterial ) {
+		common->FatalError( "_tracemodel material not found" );
+	}
 
 	// build collision models
 	BuildModels( mapFile );
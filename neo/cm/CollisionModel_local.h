@@ -35,6 +35,7 @@ If you have questions concerning this license or the applicable additional terms
 */
 
 #include "idlib/math/Pluecker.h"
+#include "sys/sys_jobs.h"
 #include "cm/CollisionModel.h"
 
 #define MIN_NODE_SIZE						64.0f
@@ -81,17 +82,13 @@ Collision model
 
 typedef struct cm_vertex_s {
 	idVec3					p;					// vertex point
-	int						checkcount;			// for multi-check avoidance
-	unsigned int			side;				// each bit tells at which side this vertex passes one of the trace model edges
-	unsigned int			sideSet;			// each bit tells if sidedness for the trace model edge has been calculated yet
+	int						checkcount;			// for multi-check avoidance while building, writing and drawing
 } cm_vertex_t;
 
 typedef struct cm_edge_s {
-	int						checkcount;			// for multi-check avoidance
+	int						checkcount;			// for multi-check avoidance while building, writing and drawing
 	unsigned short			internal;			// a trace model can never collide with internal edges
 	unsigned short			numUsers;			// number of polygons using this edge
-	unsigned int			side;				// each bit tells at which side of this edge one of the trace model vertices passes
-	unsigned int			sideSet;			// each bit tells if sidedness for the trace model vertex has been calculated yet
 	int						vertexNum[2];		// start and end point of edge
 	idVec3					normal;				// edge normal
 } cm_edge_t;
@@ -103,7 +100,8 @@ typedef struct cm_polygonBlock_s {
 
 typedef struct cm_polygon_s {
 	idBounds				bounds;				// polygon bounds
-	int						checkcount;			// for multi-check avoidance
+	int						checkcount;			// for multi-check avoidance while building, writing and drawing
+	int						checkNum;			// index into cm_modelChecks_t::polygons
 	int						contents;			// contents behind polygon
 	const idMaterial *		material;			// material
 	idPlane					plane;				// polygon plane
@@ -127,7 +125,8 @@ typedef struct cm_brushBlock_s {
 } cm_brushBlock_t;
 
 typedef struct cm_brush_s {
-	int						checkcount;			// for multi-check avoidance
+	int						checkcount;			// for multi-check avoidance while building and writing
+	int						checkNum;			// index into cm_modelChecks_t::brushes
 	idBounds				bounds;				// brush bounds
 	int						contents;			// contents of brush
 	const idMaterial *		material;			// material
@@ -160,6 +159,36 @@ typedef struct cm_nodeBlock_s {
 	struct cm_nodeBlock_s *next;				// next block with nodes
 } cm_nodeBlock_t;
 
+/*
+	After a model is complete its tree is also stored depth first in a single node array,
+	with the polygons and brushes of every node in a contiguous span. The spans hold copies
+	of the data needed to reject a polygon or brush, so most of them are never touched.
+*/
+
+typedef struct cm_flatNode_s {
+	int						planeType;			// node axial plane type, -1 for leaf nodes
+	float					planeDist;			// node plane distance
+	int						children[2];		// indexes into cm_model_t::flatNodes, -1 if none
+	int						firstPolygon;		// first polygon in cm_model_t::flatPolygons
+	int						numPolygons;		// number of polygons in node
+	int						firstBrush;			// first brush in cm_model_t::flatBrushes
+	int						numBrushes;			// number of brushes in node
+} cm_flatNode_t;
+
+typedef struct cm_flatPolygon_s {
+	idBounds				bounds;				// polygon bounds
+	int						contents;			// contents behind polygon
+	int						checkNum;			// index into cm_modelChecks_t::polygons
+	cm_polygon_t *			p;					// pointer to polygon
+} cm_flatPolygon_t;
+
+typedef struct cm_flatBrush_s {
+	idBounds				bounds;				// brush bounds
+	int						contents;			// contents of brush
+	int						checkNum;			// index into cm_modelChecks_t::brushes
+	cm_brush_t *			b;					// pointer to brush
+} cm_flatBrush_t;
+
 typedef struct cm_model_s {
 	idStr					name;				// model name
 	idBounds				bounds;				// model bounds
@@ -172,6 +201,8 @@ typedef struct cm_model_s {
 	int						maxEdges;			// size of edge array
 	int						numEdges;			// number of edges
 	cm_edge_t *				edges;				// array with all edges used by the model
+	int						maxPolygons;		// number of polygon checkNums handed out
+	int						maxBrushes;			// number of brush checkNums handed out
 	cm_node_t *				node;				// first node of spatial subdivision
 	// blocks with allocated memory
 	cm_nodeBlock_t *		nodeBlocks;			// list with blocks of nodes
@@ -179,6 +210,13 @@ typedef struct cm_model_s {
 	cm_brushRefBlock_t *	brushRefBlocks;		// list with blocks of brush references
 	cm_polygonBlock_t *		polygonBlock;		// memory block with all polygons
 	cm_brushBlock_t *		brushBlock;			// memory block with all brushes
+	// flat copy of the tree used for collision detection
+	int						numFlatNodes;
+	cm_flatNode_t *			flatNodes;			// depth first, the first node is the root
+	int						numFlatPolygons;
+	cm_flatPolygon_t *		flatPolygons;
+	int						numFlatBrushes;
+	cm_flatBrush_t *		flatBrushes;
 	// statistics
 	int						numPolygons;
 	int						polygonMemory;
@@ -232,6 +270,18 @@ typedef struct cm_trmPolygon_s {
 	idBounds rotationBounds;						// rotation bounds for this polygon
 } cm_trmPolygon_t;
 
+typedef struct cm_featureCheck_s {
+	int checkcount;									// for multi-check avoidance
+	unsigned int side;								// each bit tells at which side of one of the trace model edges/vertices this model vertex/edge passes
+	unsigned int sideSet;							// each bit tells if sidedness for the trace model edge/vertex has been calculated yet
+} cm_featureCheck_t;
+
+typedef struct cm_traceStats_s {
+	int numPolygons;								// polygons that passed the bounds test
+	int numEdges;									// edges of those polygons
+	int numBrushes;									// brushes that passed the bounds test
+} cm_traceStats_t;
+
 typedef struct cm_traceWork_s {
 	int numVerts;
 	cm_trmVertex_t vertices[MAX_TRACEMODEL_VERTS];	// trm vertices
@@ -240,6 +290,11 @@ typedef struct cm_traceWork_s {
 	int numPolys;
 	cm_trmPolygon_t polys[MAX_TRACEMODEL_POLYS];	// trm polygons
 	cm_model_t *model;								// model colliding with
+	int checkCount;									// for multi-check avoidance
+	cm_featureCheck_t *vertexChecks;				// per thread check data of the model features, see cm_modelChecks_t
+	cm_featureCheck_t *edgeChecks;
+	int *polygonChecks;
+	int *brushChecks;
 	idVec3 start;									// start of trace
 	idVec3 end;										// end of trace
 	idVec3 dir;										// trace direction
@@ -276,11 +331,53 @@ typedef struct cm_traceWork_s {
 	idPluecker polygonEdgePlueckerCache[CM_MAX_POLYGON_EDGES];
 	idPluecker polygonVertexPlueckerCache[CM_MAX_POLYGON_EDGES];
 	idVec3 polygonRotationOriginCache[CM_MAX_POLYGON_EDGES];
+
+	cm_traceStats_t *stats;							// statistics of the tracing thread
 } cm_traceWork_t;
 
 /*
 ===============================================================================
 
+Trace contexts
+
+Every thread tracing gets its own trace work, check counts and trace model,
+so collision detection can run on several threads at once. The collision
+models themselves are only read while tracing.
+
+===============================================================================
+*/
+
+typedef struct cm_modelChecks_s {
+	int						maxVertices;
+	int						maxEdges;
+	int						maxPolygons;
+	int						maxBrushes;
+	cm_featureCheck_t *		vertices;			// indexed like cm_model_t::vertices
+	cm_featureCheck_t *		edges;				// indexed like cm_model_t::edges
+	int *					polygons;			// check counts indexed by cm_polygon_t::checkNum
+	int *					brushes;			// check counts indexed by cm_brush_t::checkNum
+} cm_modelChecks_t;
+
+typedef struct cm_traceContext_s {
+	ALIGN16( cm_traceWork_t tw );				// for translations, rotations and contents tests, too large for the stack
+	int						checkCount;			// for multi-check avoidance
+	cm_modelChecks_t		checks[MAX_SUBMODELS+1];
+							// trace model set up by SetupTrmModel, TRACE_MODEL_HANDLE refers to it
+	cm_model_t *			trmModel;
+	cm_polygonRef_t *		trmPolygons[MAX_TRACEMODEL_POLYS];
+	cm_brushRef_t *			trmBrushes[1];
+							// for retrieving contact points
+	bool					getContacts;
+	contactInfo_t *			contacts;
+	int						maxContacts;
+	int						numContacts;
+							// features tested, only ever increased
+	cm_traceStats_t			stats;
+} cm_traceContext_t;
+
+/*
+===============================================================================
+
 Collision Map
 
 ===============================================================================
@@ -345,6 +442,8 @@ public:
 	void			ListModels( void );
 	// write a collision model file for the map entity
 	bool			WriteCollisionModelForMapEntity( const idMapEntity *mapEnt, const char *filename, const bool testTraceModel = true );
+	// get the features tested so far by traces on the calling thread
+	void			GetTraceStats( cm_traceStats_t &stats );
 
 private:			// CollisionMap_translate.cpp
 	int				TranslateEdgeThroughEdge( idVec3 &cross, idPluecker &l1, idPluecker &l2, float *fraction );
@@ -387,22 +486,27 @@ private:			// CollisionMap_rotate.cpp
 private:			// CollisionMap_contents.cpp
 	bool			TestTrmVertsInBrush( cm_traceWork_t *tw, cm_brush_t *b );
 	bool			TestTrmInPolygon( cm_traceWork_t *tw, cm_polygon_t *p );
-	cm_node_t *		PointNode( const idVec3 &p, cm_model_t *model );
-	int				PointContents( const idVec3 p, cmHandle_t model );
-	int				TransformedPointContents( const idVec3 &p, cmHandle_t model, const idVec3 &origin, const idMat3 &modelAxis );
-	int				ContentsTrm( trace_t *results, const idVec3 &start,
+	const cm_flatNode_t *PointNode( const idVec3 &p, cm_model_t *model );
+	int				PointContents( const idVec3 p, cm_model_t *model );
+	int				TransformedPointContents( const idVec3 &p, cm_model_t *model, const idVec3 &origin, const idMat3 &modelAxis );
+	int				ContentsTrm( cm_traceContext_t *ctx, trace_t *results, const idVec3 &start,
 									const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
 									cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis );
 
 private:			// CollisionMap_trace.cpp
-	void			TraceTrmThroughNode( cm_traceWork_t *tw, cm_node_t *node );
-	void			TraceThroughAxialBSPTree_r( cm_traceWork_t *tw, cm_node_t *node, float p1f, float p2f, idVec3 &p1, idVec3 &p2);
+	void			TraceTrmThroughNode( cm_traceWork_t *tw, const cm_flatNode_t *node );
+	void			TraceThroughAxialBSPTree_r( cm_traceWork_t *tw, int nodeNum, float p1f, float p2f, idVec3 &p1, idVec3 &p2);
 	void			TraceThroughModel( cm_traceWork_t *tw );
 	void			RecurseProcBSP_r( trace_t *results, int parentNodeNum, int nodeNum, float p1f, float p2f, const idVec3 &p1, const idVec3 &p2 );
+					// per thread trace contexts
+	cm_traceContext_t *GetTraceContext( void );
+	void			FreeTraceContexts( void );
+	cm_model_t *	ModelForHandle( cm_traceContext_t *ctx, cmHandle_t model );
+	void			SetupTraceWork( cm_traceContext_t *ctx, cm_traceWork_t *tw, cmHandle_t model );
 
 private:			// CollisionMap_load.cpp
 	void			Clear( void );
-	void			FreeTrmModelStructure( void );
+	void			FreeTrmModelStructure( cm_traceContext_t *ctx );
 					// model deallocation
 	void			RemovePolygonReferences_r( cm_node_t *node, cm_polygon_t *p );
 	void			RemoveBrushReferences_r( cm_node_t *node, cm_brush_t *b );
@@ -442,7 +546,7 @@ private:			// CollisionMap_load.cpp
 	cm_brush_t *	AllocBrush( cm_model_t *model, int numPlanes );
 	void			AddPolygonToNode( cm_model_t *model, cm_node_t *node, cm_polygon_t *p );
 	void			AddBrushToNode( cm_model_t *model, cm_node_t *node, cm_brush_t *b );
-	void			SetupTrmModelStructure( void );
+	void			SetupTrmModelStructure( cm_traceContext_t *ctx );
 	void			R_FilterPolygonIntoTree( cm_model_t *model, cm_node_t *node, cm_polygonRef_t *pref, cm_polygon_t *p );
 	void			R_FilterBrushIntoTree( cm_model_t *model, cm_node_t *node, cm_brushRef_t *pref, cm_brush_t *b );
 	cm_node_t *		R_CreateAxialBSPTree( cm_model_t *model, cm_node_t *node, const idBounds &bounds );
@@ -466,6 +570,8 @@ private:			// CollisionMap_load.cpp
 	void			RemapEdges( cm_node_t *node, int *edgeRemap );
 	void			OptimizeArrays( cm_model_t *model );
 	void			FinishModel( cm_model_t *model );
+	void			FillFlatTree( cm_model_t *model );
+	void			BuildFlatTree( cm_model_t *model );
 	void			BuildModels( const idMapFile *mapFile );
 	cmHandle_t		FindModel( const char *name );
 	cm_model_t *	CollisionModelForMapEntity( const idMapEntity *mapEnt );	// brush/patch model from .map
@@ -482,6 +588,8 @@ private:			// CollisionMap_files.cpp
 	void			WriteBrushes( idFile *fp, cm_node_t *node );
 	void			WriteCollisionModel( idFile *fp, cm_model_t *model );
 	void			WriteCollisionModelsToFile( const char *filename, int firstModel, int lastModel, unsigned int mapFileCRC );
+	void			WriteBinaryCollisionModel( idFile *fp, cm_model_t *model );
+	void			WriteBinaryCollisionModelsToFile( const char *filename, int firstModel, int lastModel, unsigned int mapFileCRC );
 					// loading
 	cm_node_t *		ParseNodes( idLexer *src, cm_model_t *model, cm_node_t *parent );
 	void			ParseVertices( idLexer *src, cm_model_t *model );
@@ -489,6 +597,8 @@ private:			// CollisionMap_files.cpp
 	void			ParsePolygons( idLexer *src, cm_model_t *model );
 	void			ParseBrushes( idLexer *src, cm_model_t *model );
 	bool			ParseCollisionModel( idLexer *src );
+	bool			ParseBinaryCollisionModel( const byte *buffer, int size, int &offset );
+	bool			LoadBinaryCollisionModelFile( const char *name, unsigned int mapFileCRC );
 	bool			LoadCollisionModelFile( const char *name, unsigned int mapFileCRC );
 
 private:			// CollisionMap_debug
@@ -504,25 +614,24 @@ private:			// collision map data
 	idStr			mapName;
 	ID_TIME_T			mapFileTime;
 	int				loaded;
-					// for multi-check avoidance
+					// for multi-check avoidance while building, writing and drawing
 	int				checkCount;
 					// models
 	int				maxModels;
 	int				numModels;
 	cm_model_t **	models;
-					// polygons and brush for trm model
-	cm_polygonRef_t*trmPolygons[MAX_TRACEMODEL_POLYS];
-	cm_brushRef_t *	trmBrushes[1];
+					// material of trace model polygons
 	const idMaterial *trmMaterial;
 					// for data pruning
 	int				numProcNodes;
 	cm_procNode_t *	procNodes;
-					// for retrieving contact points
-	bool			getContacts;
-	contactInfo_t *	contacts;
-	int				maxContacts;
-	int				numContacts;
+					// indexed by parallelJobManager->GetThreadIndex(), allocated on first use
+	cm_traceContext_t *traceContexts[MAX_JOB_THREADS];
 };
 
+extern idCollisionModelManagerLocal	collisionModelManagerLocal;
+
+extern idCVar cm_binaryCache;
+
 // for debugging
 extern idCVar cm_debugCollision;
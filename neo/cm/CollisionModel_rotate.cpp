@@ -507,7 +507,7 @@ void idCollisionModelManagerLocal::RotateTrmEdgeThroughPolygon( cm_traceWork_t *
 		edge = tw->model->edges + abs(edgeNum);
 
 		// if this edge is already checked
-		if ( edge->checkcount == idCollisionModelManagerLocal::checkCount ) {
+		if ( tw->edgeChecks[abs(edgeNum)].checkcount == tw->checkCount ) {
 			continue;
 		}
 
@@ -1060,21 +1060,8 @@ bool idCollisionModelManagerLocal::RotateTrmThroughPolygon( cm_traceWork_t *tw,
 	cm_edge_t *e;
 	idVec3 *rotationOrigin;
 
-	// if already checked this polygon
-	if ( p->checkcount == idCollisionModelManagerLocal::checkCount ) {
-		return false;
-	}
-	p->checkcount = idCollisionModelManagerLocal::checkCount;
-
-	// if this polygon does not have the right contents behind it
-	if ( !(p->contents & tw->contents) ) {
-		return false;
-	}
-
-	// if the the trace bounds do not intersect the polygon bounds
-	if ( !tw->bounds.IntersectsBounds( p->bounds ) ) {
-		return false;
-	}
+	// CM_TestFlatRef already skipped polygons that were checked before, don't have the
+	// right contents or don't intersect the trace bounds
 
 	// back face culling
 	if ( tw->isConvex ) {
@@ -1160,11 +1147,11 @@ bool idCollisionModelManagerLocal::RotateTrmThroughPolygon( cm_traceWork_t *tw,
 			edgeNum = p->edges[i];
 			e = tw->model->edges + abs(edgeNum);
 
-			if ( e->checkcount == idCollisionModelManagerLocal::checkCount ) {
+			if ( tw->edgeChecks[abs(edgeNum)].checkcount == tw->checkCount ) {
 				continue;
 			}
 			// set edge check count
-			e->checkcount = idCollisionModelManagerLocal::checkCount;
+			tw->edgeChecks[abs(edgeNum)].checkcount = tw->checkCount;
 			// can never collide with internal edges
 			if ( e->internal ) {
 				continue;
@@ -1175,11 +1162,11 @@ bool idCollisionModelManagerLocal::RotateTrmThroughPolygon( cm_traceWork_t *tw,
 				v = tw->model->vertices + e->vertexNum[k ^ INTSIGNBITSET(edgeNum)];
 
 				// if this vertex is already checked
-				if ( v->checkcount == idCollisionModelManagerLocal::checkCount ) {
+				if ( tw->vertexChecks[e->vertexNum[k ^ INTSIGNBITSET(edgeNum)]].checkcount == tw->checkCount ) {
 					continue;
 				}
 				// set vertex check count
-				v->checkcount = idCollisionModelManagerLocal::checkCount;
+				tw->vertexChecks[e->vertexNum[k ^ INTSIGNBITSET(edgeNum)]].checkcount = tw->checkCount;
 
 				// if the vertex is outside the trm rotation bounds
 				if ( !tw->bounds.ContainsPoint( v->p ) ) {
@@ -1262,18 +1249,20 @@ void idCollisionModelManagerLocal::Rotation180( trace_t *results, const idVec3 &
 	cm_trmPolygon_t *poly;
 	cm_trmEdge_t *edge;
 	cm_trmVertex_t *vert;
-	ALIGN16( static cm_traceWork_t tw );
+	cm_traceContext_t *ctx;
 
 	if ( model < 0 || model > MAX_SUBMODELS || model > idCollisionModelManagerLocal::maxModels ) {
 		common->Printf("idCollisionModelManagerLocal::Rotation180: invalid model handle\n");
 		return;
 	}
-	if ( !idCollisionModelManagerLocal::models[model] ) {
+	ctx = GetTraceContext();
+	if ( !ModelForHandle( ctx, model ) ) {
 		common->Printf("idCollisionModelManagerLocal::Rotation180: invalid model\n");
 		return;
 	}
 
-	idCollisionModelManagerLocal::checkCount++;
+	cm_traceWork_t &tw = ctx->tw;
+	SetupTraceWork( ctx, &tw, model );
 
 	tw.trace.fraction = 1.0f;
 	tw.trace.c.contents = 0;
@@ -1288,7 +1277,6 @@ void idCollisionModelManagerLocal::Rotation180( trace_t *results, const idVec3 &
 	assert( tw.angle > -180.0f && tw.angle < 180.0f );
 	tw.angle = idMath::ClampFloat(-180.0f, 180.0f, tw.angle); // DG: enforce it for the rare cases the assert would trigger
 	tw.maxTan = initialTan = idMath::Fabs( tan( ( idMath::PI / 360.0f ) * tw.angle ) );
-	tw.model = idCollisionModelManagerLocal::models[model];
 	tw.start = start - modelOrigin;
 	// rotation axis, axis is assumed to be normalized
 	tw.axis = axis;
@@ -1623,7 +1611,7 @@ void idCollisionModelManagerLocal::Rotation( trace_t *results, const idVec3 &sta
 
 	// if special position test
 	if ( rotation.GetAngle() == 0.0f ) {
-		idCollisionModelManagerLocal::ContentsTrm( results, start, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
+		idCollisionModelManagerLocal::ContentsTrm( GetTraceContext(), results, start, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
 		return;
 	}
 
@@ -46,14 +46,54 @@ Trace through the spatial subdivision
 ===============================================================================
 */
 
+/*
+================
+CM_TestFlatRef
+
+  returns true if the polygon or brush has to be tested, the polygon or brush itself is not touched
+================
+*/
+template< class type >
+static ID_INLINE bool CM_TestFlatRef( const cm_traceWork_t *tw, int *checks, const type *ref ) {
+	// if already checked this polygon or brush
+	if ( checks[ref->checkNum] == tw->checkCount ) {
+		return false;
+	}
+	checks[ref->checkNum] = tw->checkCount;
+
+	// if this polygon or brush does not have the right contents
+	if ( !(ref->contents & tw->contents) ) {
+		return false;
+	}
+
+	// if the bounds don't intersect the trace bounds
+	if ( !ref->bounds.IntersectsBounds( tw->bounds ) ) {
+		return false;
+	}
+	return true;
+}
+
+/*
+================
+CM_CountPolygon
+================
+*/
+static ID_INLINE void CM_CountPolygon( const cm_traceWork_t *tw, const cm_polygon_t *p ) {
+	tw->stats->numPolygons++;
+	tw->stats->numEdges += p->numEdges;
+}
+
 /*
 ================
 idCollisionModelManagerLocal::TraceTrmThroughNode
 ================
 */
-void idCollisionModelManagerLocal::TraceTrmThroughNode( cm_traceWork_t *tw, cm_node_t *node ) {
-	cm_polygonRef_t *pref;
-	cm_brushRef_t *bref;
+void idCollisionModelManagerLocal::TraceTrmThroughNode( cm_traceWork_t *tw, const cm_flatNode_t *node ) {
+	const cm_flatPolygon_t *fp, *fpEnd;
+	const cm_flatBrush_t *fb, *fbEnd;
+
+	fp = tw->model->flatPolygons + node->firstPolygon;
+	fpEnd = fp + node->numPolygons;
 
 	// position test
 	if ( tw->positionTest ) {
@@ -62,9 +102,14 @@ void idCollisionModelManagerLocal::TraceTrmThroughNode( cm_traceWork_t *tw, cm_n
 			return;
 		}
 		// test if any of the trm vertices is inside a brush
-		for ( bref = node->brushes; bref; bref = bref->next ) {
-			if ( idCollisionModelManagerLocal::TestTrmVertsInBrush( tw, bref->b ) ) {
-				return;
+		fb = tw->model->flatBrushes + node->firstBrush;
+		fbEnd = fb + node->numBrushes;
+		for ( ; fb < fbEnd; fb++ ) {
+			if ( CM_TestFlatRef( tw, tw->brushChecks, fb ) ) {
+				tw->stats->numBrushes++;
+				if ( idCollisionModelManagerLocal::TestTrmVertsInBrush( tw, fb->b ) ) {
+					return;
+				}
 			}
 		}
 		// if just testing a point we're done
@@ -72,25 +117,34 @@ void idCollisionModelManagerLocal::TraceTrmThroughNode( cm_traceWork_t *tw, cm_n
 			return;
 		}
 		// test if the trm is stuck in any polygons
-		for ( pref = node->polygons; pref; pref = pref->next ) {
-			if ( idCollisionModelManagerLocal::TestTrmInPolygon( tw, pref->p ) ) {
-				return;
+		for ( ; fp < fpEnd; fp++ ) {
+			if ( CM_TestFlatRef( tw, tw->polygonChecks, fp ) ) {
+				CM_CountPolygon( tw, fp->p );
+				if ( idCollisionModelManagerLocal::TestTrmInPolygon( tw, fp->p ) ) {
+					return;
+				}
 			}
 		}
 	}
 	else if ( tw->rotation ) {
 		// rotate through all polygons in this leaf
-		for ( pref = node->polygons; pref; pref = pref->next ) {
-			if ( idCollisionModelManagerLocal::RotateTrmThroughPolygon( tw, pref->p ) ) {
-				return;
+		for ( ; fp < fpEnd; fp++ ) {
+			if ( CM_TestFlatRef( tw, tw->polygonChecks, fp ) ) {
+				CM_CountPolygon( tw, fp->p );
+				if ( idCollisionModelManagerLocal::RotateTrmThroughPolygon( tw, fp->p ) ) {
+					return;
+				}
 			}
 		}
 	}
 	else {
 		// trace through all polygons in this leaf
-		for ( pref = node->polygons; pref; pref = pref->next ) {
-			if ( idCollisionModelManagerLocal::TranslateTrmThroughPolygon( tw, pref->p ) ) {
-				return;
+		for ( ; fp < fpEnd; fp++ ) {
+			if ( CM_TestFlatRef( tw, tw->polygonChecks, fp ) ) {
+				CM_CountPolygon( tw, fp->p );
+				if ( idCollisionModelManagerLocal::TranslateTrmThroughPolygon( tw, fp->p ) ) {
+					return;
+				}
 			}
 		}
 	}
@@ -103,17 +157,19 @@ idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r
 */
 //#define NO_SPATIAL_SUBDIVISION
 
-void idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r( cm_traceWork_t *tw, cm_node_t *node, float p1f, float p2f, idVec3 &p1, idVec3 &p2) {
+void idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r( cm_traceWork_t *tw, int nodeNum, float p1f, float p2f, idVec3 &p1, idVec3 &p2) {
 	float		t1, t2, offset;
 	float		frac, frac2;
 	float		idist;
 	idVec3		mid;
 	int			side;
 	float		midf;
+	const cm_flatNode_t *node;
 
-	if ( !node ) {
+	if ( nodeNum < 0 ) {
 		return;
 	}
+	node = tw->model->flatNodes + nodeNum;
 
 	if ( tw->quickExit ) {
 		return;		// stop immediately
@@ -124,7 +180,7 @@ void idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r( cm_traceWork_t *t
 	}
 
 	// if we need to test this node for collisions
-	if ( node->polygons || (tw->positionTest && node->brushes) ) {
+	if ( node->numPolygons || (tw->positionTest && node->numBrushes) ) {
 		// trace through node with collision data
 		idCollisionModelManagerLocal::TraceTrmThroughNode( tw, node );
 	}
@@ -220,7 +276,7 @@ void idCollisionModelManagerLocal::TraceThroughModel( cm_traceWork_t *tw ) {
 
 	if ( !tw->rotation ) {
 		// trace through spatial subdivision and then through leafs
-		idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r( tw, tw->model->node, 0, 1, tw->start, tw->end );
+		idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r( tw, 0, 0, 1, tw->start, tw->end );
 	}
 	else {
 		// approximate the rotation with a series of straight line movements
@@ -238,7 +294,7 @@ void idCollisionModelManagerLocal::TraceThroughModel( cm_traceWork_t *tw ) {
 				rot.Set( tw->origin, tw->axis, tw->angle * ((float) (i+1) / numSteps) );
 				end = start * rot;
 				// trace through spatial subdivision and then through leafs
-				idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r( tw, tw->model->node, 0, 1, start, end );
+				idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r( tw, 0, 0, 1, start, end );
 				// no need to continue if something was hit already
 				if ( tw->trace.fraction < 1.0f ) {
 					return;
@@ -250,6 +306,128 @@ void idCollisionModelManagerLocal::TraceThroughModel( cm_traceWork_t *tw ) {
 			start = tw->start;
 		}
 		// last step of the approximation
-		idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r( tw, tw->model->node, 0, 1, start, tw->end );
+		idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r( tw, 0, 0, 1, start, tw->end );
+	}
+}
+
+/*
+===============================================================================
+
+Per thread trace contexts
+
+===============================================================================
+*/
+
+/*
+================
+idCollisionModelManagerLocal::GetTraceContext
+
+  returns the trace context of the calling thread
+================
+*/
+cm_traceContext_t *idCollisionModelManagerLocal::GetTraceContext( void ) {
+	int thread = parallelJobManager->GetThreadIndex();
+
+	// a job worker is the only thread using its slot, but slot 0 is shared by all threads
+	// that aren't workers, so outside of jobs only the main thread may trace
+	if ( traceContexts[thread] == NULL ) {
+		cm_traceContext_t *ctx = (cm_traceContext_t *) Mem_Alloc16( sizeof( cm_traceContext_t ) );
+		memset( ctx, 0, sizeof( cm_traceContext_t ) );
+		traceContexts[thread] = ctx;
+	}
+	return traceContexts[thread];
+}
+
+/*
+================
+idCollisionModelManagerLocal::FreeTraceContexts
+
+  no traces may be running
+================
+*/
+void idCollisionModelManagerLocal::FreeTraceContexts( void ) {
+	int i, j;
+
+	for ( i = 0; i < MAX_JOB_THREADS; i++ ) {
+		cm_traceContext_t *ctx = traceContexts[i];
+		if ( ctx == NULL ) {
+			continue;
+		}
+		FreeTrmModelStructure( ctx );
+		for ( j = 0; j <= MAX_SUBMODELS; j++ ) {
+			Mem_Free( ctx->checks[j].vertices );
+			Mem_Free( ctx->checks[j].edges );
+			Mem_Free( ctx->checks[j].polygons );
+			Mem_Free( ctx->checks[j].brushes );
+		}
+		Mem_Free16( ctx );
+		traceContexts[i] = NULL;
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::ModelForHandle
+
+  the trace model handle refers to the trace model of the calling thread
+================
+*/
+cm_model_t *idCollisionModelManagerLocal::ModelForHandle( cm_traceContext_t *ctx, cmHandle_t model ) {
+	if ( !models ) {
+		return NULL;
+	}
+	if ( model == TRACE_MODEL_HANDLE ) {
+		return ctx->trmModel;
 	}
+	return models[model];
+}
+
+/*
+================
+CM_GrowChecks
+================
+*/
+template< class type >
+static ID_INLINE void CM_GrowChecks( type *&checks, int &maxChecks, const int num ) {
+	if ( num > maxChecks ) {
+		Mem_Free( checks );
+		checks = (type *) Mem_ClearedAlloc( num * sizeof( type ) );
+		maxChecks = num;
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::SetupTraceWork
+
+  points the trace work to the check data of the model and starts a new check count
+================
+*/
+void idCollisionModelManagerLocal::SetupTraceWork( cm_traceContext_t *ctx, cm_traceWork_t *tw, cmHandle_t model ) {
+	cm_modelChecks_t *checks = &ctx->checks[model];
+
+	tw->model = ModelForHandle( ctx, model );
+
+	// models may be loaded after the checks were allocated, the new checks are cleared
+	// which is fine because the check count is increased before any of them is set
+	CM_GrowChecks( checks->vertices, checks->maxVertices, tw->model->maxVertices );
+	CM_GrowChecks( checks->edges, checks->maxEdges, tw->model->maxEdges );
+	CM_GrowChecks( checks->polygons, checks->maxPolygons, tw->model->maxPolygons );
+	CM_GrowChecks( checks->brushes, checks->maxBrushes, tw->model->maxBrushes );
+
+	tw->checkCount = ++ctx->checkCount;
+	tw->vertexChecks = checks->vertices;
+	tw->edgeChecks = checks->edges;
+	tw->polygonChecks = checks->polygons;
+	tw->brushChecks = checks->brushes;
+	tw->stats = &ctx->stats;
+}
+
+/*
+================
+idCollisionModelManagerLocal::GetTraceStats
+================
+*/
+void idCollisionModelManagerLocal::GetTraceStats( cm_traceStats_t &stats ) {
+	stats = GetTraceContext()->stats;
 }
@@ -1483,6 +1483,7 @@ Present is called to allow entities to generate refEntities, lights, etc for the
 ================
 */
 void idEntity::Present( void ) {
+	idThinkStatsScope thinkStatsScope( this, THINKSTAT_PRESENT );
 
 	if ( !gameLocal.isNewFrame ) {
 		return;
@@ -2632,6 +2633,8 @@ bool idEntity::RunPhysics( void ) {
 	idEntity *	part, *blockedPart, *blockingEntity;
 	bool		moved;
 
+	idThinkStatsScope thinkStatsScope( this, THINKSTAT_PHYSICS );
+
 	// don't run physics if not enabled
 	if ( !( thinkFlags & TH_PHYSICS ) ) {
 		// however do update any animation controllers
@@ -31,6 +31,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "sys/platform.h"
 #include "idlib/LangDict.h"
 #include "idlib/Timer.h"
+#include "sys/sys_jobs.h"
 #include "framework/async/NetworkSystem.h"
 #include "framework/BuildVersion.h"
 #include "framework/DeclEntityDef.h"
@@ -75,6 +76,7 @@ idUserInterfaceManager *	uiManager = NULL;
 idDeclManager *				declManager = NULL;
 idAASFileManager *			AASFileManager = NULL;
 idCollisionModelManager *	collisionModelManager = NULL;
+idParallelJobManager *		parallelJobManager = NULL;
 idCVar *					idCVar::staticVars = NULL;
 
 idCVar com_forceGenericSIMD( "com_forceGenericSIMD", "0", CVAR_BOOL|CVAR_SYSTEM, "force generic platform independent SIMD" );
@@ -156,6 +158,9 @@ extern "C" ID_GAME_API gameExport_t *GetGameAPI( gameImport_t *import ) {
 		declManager					= import->declManager;
 		AASFileManager				= import->AASFileManager;
 		collisionModelManager		= import->collisionModelManager;
+		parallelJobManager			= import->parallelJobManager;
+
+		idLib::profiler				= import->profiler;
 	}
 
 	// set interface pointers used by idLib
@@ -194,6 +199,7 @@ void TestGameAPI( void ) {
 	testImport.declManager				= ::declManager;
 	testImport.AASFileManager			= ::AASFileManager;
 	testImport.collisionModelManager	= ::collisionModelManager;
+	testImport.parallelJobManager		= ::parallelJobManager;
 
 	testExport = *GetGameAPI( &testImport );
 }
@@ -204,6 +210,7 @@ idGameLocal::idGameLocal
 ============
 */
 idGameLocal::idGameLocal() {
+	animFrameJobList = NULL;
 	Clear();
 }
 
@@ -421,6 +428,8 @@ void idGameLocal::Init( void ) {
 
 	Printf( "...%d aas types\n", aasList.Num() );
 
+	animFrameJobList = parallelJobManager->AllocJobList( "idAnimator::CreateFrame" );
+
 	//debugger support
 	common->GetAdditionalFunction( idCommon::FT_UpdateDebugger,( idCommon::FunctionPointer * ) &updateDebuggerFnPtr,NULL);
 
@@ -448,6 +457,11 @@ void idGameLocal::Shutdown( void ) {
 	aasList.DeleteContents( true );
 	aasNames.Clear();
 
+	parallelJobManager->FreeJobList( animFrameJobList );
+	animFrameJobList = NULL;
+	animFrames.Clear();
+	animFrameJobs.Clear();
+
 	idAI::FreeObstacleAvoidanceNodes();
 
 	// shutdown the model exporter
@@ -1703,6 +1717,10 @@ void idGameLocal::MapShutdown( void ) {
 		inCinematic = false;
 	}
 
+	// write the think stats and script profile of the map before they are cleared
+	thinkStats.MapShutdown();
+	scriptProfiler.MapShutdown();
+
 	MapClear( true );
 
 	// reset the script to the state it was before the map was started
@@ -1717,6 +1735,9 @@ void idGameLocal::MapShutdown( void ) {
 	clip.Shutdown();
 	idClipModel::ClearTraceModelCache();
 
+	// the obstacle grid references entities of this map
+	idAI::FreeObstacleAvoidanceNodes();
+
 	ShutdownAsyncNetwork();
 
 	mapFileName.Clear();
@@ -2437,7 +2458,7 @@ void idGameLocal::RunTimeGroup2() {
 			continue;
 		}
 
-		ent->Think();
+		RunEntityThink( ent );
 		num++;
 	}
 
@@ -2445,6 +2466,96 @@ void idGameLocal::RunTimeGroup2() {
 }
 #endif
 
+/*
+================
+idGameLocal::RunEntityThink
+================
+*/
+void idGameLocal::RunEntityThink( idEntity *ent ) {
+	PROFILE_ZONE( ent->GetClassname() );
+	idThinkStatsScope thinkStatsScope( ent, THINKSTAT_THINK );
+
+	ent->Think();
+}
+
+/*
+================
+CreateAnimationFramesJob
+================
+*/
+static void CreateAnimationFramesJob( void *data ) {
+	animFrameJob_t *job = ( animFrameJob_t * )data;
+
+	for ( int i = 0; i < job->numFrames; i++ ) {
+		job->frames[i].animator->CreateParallelFrame( job->frames[i].time );
+	}
+}
+
+/*
+================
+idGameLocal::CreateAnimationFrames
+
+With g_parallelThink the animation frames of the entities in the player PVS
+are blended in jobs once all entities have thought and all events ran.
+The think order itself stays serial, so team masters still run before their
+slaves and everything that depends on it behaves as before.
+
+Nothing may change an animator between this and the render callback that
+picks the frame up in idAnimator::CreateFrame; anything that does invalidates
+the frame and it is built serially again.
+================
+*/
+void idGameLocal::CreateAnimationFrames( void ) {
+	const int	framesPerJob = 16;
+	idEntity *	ent;
+	idAnimator *animator;
+	int			i;
+
+	if ( !g_parallelThink.GetBool() || animFrameJobList == NULL ) {
+		return;
+	}
+
+	if ( inCinematic && skipCinematic ) {
+		return;
+	}
+
+	PROFILE_ZONE( "idGameLocal::CreateAnimationFrames" );
+
+	animFrames.SetNum( 0, false );
+	for ( ent = activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() ) {
+		if ( ent->IsHidden() || ent->GetModelDefHandle() == -1 || !InPlayerPVS( ent ) ) {
+			continue;
+		}
+		animator = ent->GetAnimator();
+		if ( animator == NULL ) {
+			continue;
+		}
+
+		SetTimeState ts( ent->timeGroup );
+		if ( !animator->PrepareParallelFrame( time ) ) {
+			continue;
+		}
+		animFrame_t &frame = animFrames.Alloc();
+		frame.animator = animator;
+		frame.time = time;
+	}
+
+	if ( !animFrames.Num() ) {
+		return;
+	}
+
+	animFrameJobs.SetNum( ( animFrames.Num() + framesPerJob - 1 ) / framesPerJob, false );
+	for ( i = 0; i < animFrameJobs.Num(); i++ ) {
+		animFrameJobs[i].frames = &animFrames[i * framesPerJob];
+		animFrameJobs[i].numFrames = Min( framesPerJob, animFrames.Num() - i * framesPerJob );
+		animFrameJobList->AddJob( CreateAnimationFramesJob, &animFrameJobs[i] );
+	}
+
+	animFrameJobList->Submit();
+	animFrameJobList->Wait();
+	animFrameJobList->Clear();
+}
+
 /*
 ================
 idGameLocal::RunFrame
@@ -2459,6 +2570,8 @@ gameReturn_t idGameLocal::RunFrame(const usercmd_t* clientCmds) {
 	idPlayer* player;
 	const renderView_t* view;
 
+	PROFILE_ZONE( "idGameLocal::RunFrame" );
+
 #ifdef _DEBUG
 	if ( isMultiplayer ) {
 		assert( !isClient );
@@ -2485,6 +2598,9 @@ gameReturn_t idGameLocal::RunFrame(const usercmd_t* clientCmds) {
 			player->Think();
 		}
 	} else do {
+		thinkStats.BeginFrame();
+		scriptProfiler.BeginFrame();
+
 		// update the game time
 		framenum++;
 		previousTime = time;
@@ -2541,6 +2657,11 @@ gameReturn_t idGameLocal::RunFrame(const usercmd_t* clientCmds) {
 		timer_think.Clear();
 		timer_think.Start();
 
+		// route the monsters chasing the same enemy all at once
+		if ( ai_batchRouting.GetBool() ) {
+			idAI::RouteToEnemies();
+		}
+
 		// let entities think
 		if ( g_timeentities.GetFloat() ) {
 			num = 0;
@@ -2551,7 +2672,7 @@ gameReturn_t idGameLocal::RunFrame(const usercmd_t* clientCmds) {
 				}
 				timer_singlethink.Clear();
 				timer_singlethink.Start();
-				ent->Think();
+				RunEntityThink( ent );
 				timer_singlethink.Stop();
 				ms = timer_singlethink.Milliseconds();
 				if ( ms >= g_timeentities.GetFloat() ) {
@@ -2567,7 +2688,7 @@ gameReturn_t idGameLocal::RunFrame(const usercmd_t* clientCmds) {
 						ent->GetPhysics()->UpdateTime( time );
 						continue;
 					}
-					ent->Think();
+					RunEntityThink( ent );
 					num++;
 				}
 			} else {
@@ -2578,7 +2699,7 @@ gameReturn_t idGameLocal::RunFrame(const usercmd_t* clientCmds) {
 						continue;
 					}
 #endif
-					ent->Think();
+					RunEntityThink( ent );
 					num++;
 				}
 			}
@@ -2619,6 +2740,9 @@ gameReturn_t idGameLocal::RunFrame(const usercmd_t* clientCmds) {
 
 		timer_events.Stop();
 
+		// build the animation frames the renderer is going to ask for
+		CreateAnimationFrames();
+
 		// free the player pvs
 		FreePlayerPVS();
 
@@ -2627,6 +2751,8 @@ gameReturn_t idGameLocal::RunFrame(const usercmd_t* clientCmds) {
 			mpGame.Run();
 		}
 
+		thinkStats.EndFrame( msec );
+
 		// display how long it took to calculate the current game frame
 		if ( g_frametime.GetBool() ) {
 			Printf( "game %d: all:%u th:%u ev:%u %d ents \n",
@@ -2634,6 +2760,9 @@ gameReturn_t idGameLocal::RunFrame(const usercmd_t* clientCmds) {
 				timer_think.Milliseconds(), timer_events.Milliseconds(), num );
 		}
 
+		// display the routing queries of the current game frame
+		RunRoutingStats();
+
 		// build the return value
 		ret.consistencyHash = 0;
 		ret.sessionCommand[0] = 0;
@@ -2964,6 +3093,31 @@ void idGameLocal::ShowTargets( void ) {
 	}
 }
 
+/*
+================
+idGameLocal::RunRoutingStats
+
+  the routing stats of each aas are reset every frame
+================
+*/
+void idGameLocal::RunRoutingStats( void ) {
+	int i, areaCacheQueries, portalCacheQueries;
+	aasRoutingStats_t stats;
+
+	for ( i = 0; i < aasList.Num(); i++ ) {
+		aasList[ i ]->GetRoutingStats( stats, true );
+		if ( !aas_showRoutingStats.GetBool() || !aasList[ i ]->GetSettings() ) {
+			continue;
+		}
+		areaCacheQueries = stats.areaCacheHits + stats.areaCacheMisses;
+		portalCacheQueries = stats.portalCacheHits + stats.portalCacheMisses;
+		Printf( "game %d %s: %d routes, %d batches with %d routes, %d paths, area cache %d%% of %d, portal cache %d%% of %d\n",
+			time, aasNames[ i ].c_str(), stats.numRoutes, stats.numBatches, stats.numBatchedRoutes, stats.numPaths,
+			areaCacheQueries ? stats.areaCacheHits * 100 / areaCacheQueries : 100, areaCacheQueries,
+			portalCacheQueries ? stats.portalCacheHits * 100 / portalCacheQueries : 100, portalCacheQueries );
+	}
+}
+
 /*
 ================
 idGameLocal::RunDebugInfo
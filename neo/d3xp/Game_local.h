@@ -34,12 +34,15 @@ If you have questions concerning this license or the applicable additional terms
 #include "idlib/containers/StrList.h"
 #include "idlib/containers/LinkList.h"
 #include "idlib/BitMsg.h"
+#include "idlib/Profiler.h"
 #include "framework/Game.h"
 
 #include "gamesys/SaveGame.h"
+#include "gamesys/ThinkStats.h"
 #include "physics/Clip.h"
 #include "physics/Push.h"
 #include "script/Script_Program.h"
+#include "script/Script_Profiler.h"
 #include "ai/AAS.h"
 #include "anim/Anim.h"
 #include "Pvs.h"
@@ -62,6 +65,7 @@ class idDeclEntityDef;
 class idRenderWorld;
 class idSoundWorld;
 class idUserInterface;
+class idParallelJobList;
 
 extern idRenderWorld *				gameRenderWorld;
 extern idSoundWorld *				gameSoundWorld;
@@ -166,6 +170,17 @@ typedef struct {
 #endif
 } spawnSpot_t;
 
+// an animator whose frame is built ahead of time by idGameLocal::CreateAnimationFrames
+typedef struct {
+	idAnimator	*animator;
+	int			time;
+} animFrame_t;
+
+typedef struct {
+	animFrame_t	*frames;
+	int			numFrames;
+} animFrameJob_t;
+
 //============================================================================
 
 class idEventQueue {
@@ -287,6 +302,8 @@ public:
 
 	idSmokeParticles *		smokeParticles;			// global smoke trails
 	idEditEntities *		editEntities;			// in game editing
+	idThinkStats			thinkStats;				// time spent by thinking entities
+	idScriptProfiler		scriptProfiler;			// instructions and time spent in scripts
 
 	int						cinematicSkipTime;		// don't allow skipping cinemetics until this time has passed so player doesn't skip out accidently from a firefight
 	int						cinematicStopTime;		// cinematics have several camera changes, so keep track of when we stop them so that we don't reset cinematicSkipTime unnecessarily
@@ -529,6 +546,10 @@ private:
 	idList<idAAS *>			aasList;				// area system
 	idStrList				aasNames;
 
+	idParallelJobList *		animFrameJobList;		// builds the animation frames of visible entities, see CreateAnimationFrames
+	idList<animFrame_t>		animFrames;
+	idList<animFrameJob_t>	animFrameJobs;
+
 	idEntityPtr<idActor>	lastAIAlertEntity;
 	int						lastAIAlertTime;
 
@@ -583,8 +604,11 @@ private:
 	void					FreePlayerPVS( void );
 	void					UpdateGravity( void );
 	void					SortActiveEntityList( void );
+	void					RunEntityThink( idEntity *ent );
+	void					CreateAnimationFrames( void );
 	void					ShowTargets( void );
 	void					RunDebugInfo( void );
+	void					RunRoutingStats( void );
 
 	void					InitScriptForMap( void );
 
@@ -1788,6 +1788,8 @@ void idMultiplayerGame::Run() {
 	idPlayer *player;
 	int gameReviewPause;
 
+	PROFILE_ZONE( "idMultiplayerGame::Run" );
+
 	assert( gameLocal.isMultiplayer );
 	assert( !gameLocal.isClient );
 
@@ -3390,18 +3390,29 @@ void idWeapon::Event_LaunchProjectiles( int num_projectiles, float spread, float
 
 	if ( gameLocal.isClient ) {
 
-		// predict instant hit projectiles
-		if ( projectileDict.GetBool( "net_instanthit" ) ) {
+		// predict instant hit projectiles, the traces of all projectiles are done at once
+		if ( projectileDict.GetBool( "net_instanthit" ) && num_projectiles > 0 ) {
 			float spreadRad = DEG2RAD( spread );
+			clipTraceQuery_t *queries = (clipTraceQuery_t *)_alloca16( num_projectiles * sizeof( queries[0] ) );
+			trace_t *results = (trace_t *)_alloca16( num_projectiles * sizeof( results[0] ) );
 			muzzle_pos = muzzleOrigin + playerViewAxis[ 0 ] * 2.0f;
 			for( i = 0; i < num_projectiles; i++ ) {
 				ang = idMath::Sin( spreadRad * gameLocal.random.RandomFloat() );
 				spin = (float)DEG2RAD( 360.0f ) * gameLocal.random.RandomFloat();
 				dir = playerViewAxis[ 0 ] + playerViewAxis[ 2 ] * ( ang * idMath::Sin( spin ) ) - playerViewAxis[ 1 ] * ( ang * idMath::Cos( spin ) );
 				dir.Normalize();
-				gameLocal.clip.Translation( tr, muzzle_pos, muzzle_pos + dir * 4096.0f, NULL, mat3_identity, MASK_SHOT_RENDERMODEL, owner );
-				if ( tr.fraction < 1.0f ) {
-					idProjectile::ClientPredictionCollide( this, projectileDict, tr, vec3_origin, true );
+				queries[i].start = muzzle_pos;
+				queries[i].end = muzzle_pos + dir * 4096.0f;
+				queries[i].mdl = NULL;
+				queries[i].trmAxis = mat3_identity;
+				queries[i].contentMask = MASK_SHOT_RENDERMODEL;
+				queries[i].passEntity = owner;
+			}
+			if ( gameLocal.clip.TranslationBatch( results, queries, num_projectiles ) ) {
+				for( i = 0; i < num_projectiles; i++ ) {
+					if ( results[i].fraction < 1.0f ) {
+						idProjectile::ClientPredictionCollide( this, projectileDict, results[i], vec3_origin, true );
+					}
 				}
 			}
 		}
@@ -56,6 +56,9 @@ idAASLocal::idAASLocal
 */
 idAASLocal::idAASLocal( void ) {
 	file = NULL;
+	precacheJobList = NULL;
+	memset( &routingStats, 0, sizeof( routingStats ) );
+	routingRevision = 0;
 }
 
 /*
@@ -118,6 +121,18 @@ void idAASLocal::Stats( void ) const {
 	RoutingStats();
 }
 
+/*
+============
+idAASLocal::GetRoutingStats
+============
+*/
+void idAASLocal::GetRoutingStats( aasRoutingStats_t &stats, bool reset ) {
+	stats = routingStats;
+	if ( reset ) {
+		memset( &routingStats, 0, sizeof( routingStats ) );
+	}
+}
+
 /*
 ============
 idAASLocal::GetSettings
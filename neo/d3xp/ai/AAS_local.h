@@ -29,9 +29,12 @@ If you have questions concerning this license or the applicable additional terms
 #ifndef __AAS_LOCAL_H__
 #define __AAS_LOCAL_H__
 
+#include "sys/sys_jobs.h"
 #include "ai/AAS.h"
 #include "Pvs.h"
 
+class idAASLocal;
+
 class idRoutingCache {
 	friend class idAASLocal;
 
@@ -52,6 +55,7 @@ private:
 	idRoutingCache *			time_next;				// next in time based list
 	idRoutingCache *			time_prev;				// previous in time based list
 	unsigned short				startTravelTime;		// travel time to start with
+	bool						precached;				// calculated after loading the map, never in the time based list
 	unsigned char *				reachabilities;			// reachabilities used for routing
 	unsigned short *			travelTimes;			// travel time for every area
 };
@@ -82,6 +86,17 @@ private:
 };
 
 
+class idRoutingPrecache {
+	friend class idAASLocal;
+
+private:
+	const idAASLocal *			aas;
+	int							cluster;				// cluster of the portal areas
+	int							travelFlags;			// travel flags of the cache
+	idList<idRoutingCache *>	caches;					// area cache of the portal areas, calculated in a job
+};
+
+
 class idAASLocal : public idAAS {
 public:
 								idAASLocal( void );
@@ -89,6 +104,7 @@ public:
 	virtual bool				Init( const idStr &mapName, unsigned int mapFileCRC );
 	virtual void				Shutdown( void );
 	virtual void				Stats( void ) const;
+	virtual void				GetRoutingStats( aasRoutingStats_t &stats, bool reset );
 	virtual void				Test( const idVec3 &origin );
 	virtual const idAASSettings *GetSettings( void ) const;
 	virtual int					PointAreaNum( const idVec3 &origin ) const;
@@ -110,6 +126,8 @@ public:
 	virtual void				RemoveAllObstacles( void );
 	virtual int					TravelTimeToGoalArea( int areaNum, const idVec3 &origin, int goalAreaNum, int travelFlags ) const;
 	virtual bool				RouteToGoalArea( int areaNum, const idVec3 origin, int goalAreaNum, int travelFlags, int &travelTime, idReachability **reach ) const;
+	virtual int					RoutesToGoalArea( aasRoute_t *routes, int numRoutes, int goalAreaNum, int travelFlags ) const;
+	virtual int					GetRoutingRevision( void ) const;
 	virtual bool				WalkPathToGoal( aasPath_t &path, int areaNum, const idVec3 &origin, int goalAreaNum, const idVec3 &goalOrigin, int travelFlags ) const;
 	virtual bool				WalkPathValid( int areaNum, const idVec3 &origin, int goalAreaNum, const idVec3 &goalOrigin, int travelFlags, idVec3 &endPos, int &endAreaNum ) const;
 	virtual bool				FlyPathToGoal( aasPath_t &path, int areaNum, const idVec3 &origin, int goalAreaNum, const idVec3 &goalOrigin, int travelFlags ) const;
@@ -135,7 +153,12 @@ private:	// routing data
 	mutable idRoutingCache *	cacheListStart;			// start of list with cache sorted from oldest to newest
 	mutable idRoutingCache *	cacheListEnd;			// end of list with cache sorted from oldest to newest
 	mutable int					totalCacheMemory;		// total cache memory used
+	mutable int					precacheMemory;			// memory used by precached cache, not part of the total
+	mutable idParallelJobList *	precacheJobList;		// calculates the area cache of the cluster portals
+	mutable idList<idRoutingPrecache *> precacheJobs;	// one job for each cluster
 	idList<idRoutingObstacle *>	obstacleList;			// list with obstacles
+	mutable aasRoutingStats_t	routingStats;			// reset every game frame
+	int							routingRevision;		// changed whenever the routing cache of areas is removed
 
 private:	// routing
 	bool						SetupRouting( void );
@@ -150,13 +173,25 @@ private:	// routing
 	void						RoutingStats( void ) const;
 	void						LinkCache( idRoutingCache *cache ) const;
 	void						UnlinkCache( idRoutingCache *cache ) const;
+	void						DeleteCache( idRoutingCache *cache ) const;
 	void						DeleteOldestCache( void ) const;
 	idReachability *			GetAreaReachability( int areaNum, int reachabilityNum ) const;
 	int							ClusterAreaNum( int clusterNum, int areaNum ) const;
-	void						UpdateAreaRoutingCache( idRoutingCache *areaCache ) const;
+	void						UpdateAreaRoutingCache( idRoutingCache *areaCache, idRoutingUpdate *updates ) const;
 	idRoutingCache *			GetAreaRoutingCache( int clusterNum, int areaNum, int travelFlags ) const;
 	void						UpdatePortalRoutingCache( idRoutingCache *portalCache ) const;
 	idRoutingCache *			GetPortalRoutingCache( int clusterNum, int areaNum, int travelFlags ) const;
+	idRoutingCache *			GetGoalPortalRoutingCache( int goalAreaNum, int travelFlags ) const;
+	void						GetClusterPortalCaches( int clusterNum, const idRoutingCache *portalCache, int travelFlags, idRoutingCache **caches ) const;
+	bool						RouteFromArea( int areaNum, const idVec3 &origin, int goalAreaNum, int travelFlags, idRoutingCache *portalCache,
+											idRoutingCache **portalAreaCaches, int &travelTime, idReachability **reach ) const;
+	static void					RoutingPrecacheJob( idRoutingPrecache *precache );
+	void						PrecacheClusterRouting( idRoutingPrecache *precache ) const;
+	void						StartRoutingPrecache( void );
+	void						FinishRoutingPrecache( bool wait ) const;
+	bool						AreaCacheReachedArea( const idRoutingCache *cache, int areaNum ) const;
+	bool						AreaCacheUsesArea( const idRoutingCache *cache, int areaNum ) const;
+	bool						PortalCacheUsesCluster( const idRoutingCache *cache, int clusterNum ) const;
 	void						RemoveRoutingCacheUsingArea( int areaNum );
 	void						DisableArea( int areaNum );
 	void						EnableArea( int areaNum );
@@ -291,6 +291,7 @@ idAI::idAI
 idAI::idAI() {
 	aas					= NULL;
 	travelFlags			= TFL_WALK|TFL_AIR;
+	enemyRoute.frame	= -1;
 
 	kickForce			= 2048.0f;
 	ignore_obstacles	= false;
@@ -1505,6 +1506,25 @@ bool idAI::PathToGoal( aasPath_t &path, int areaNum, const idVec3 &origin, int g
 	}
 }
 
+/*
+=====================
+idAI::EnemyReachable
+
+  returns true if there is a path towards the enemy, uses the route found by RouteToEnemies
+  this frame as long as the areas and the routing didn't change since
+=====================
+*/
+bool idAI::EnemyReachable( int areaNum, const idVec3 &origin, int enemyAreaNum, const idVec3 &enemyPos ) const {
+	aasPath_t path;
+
+	if ( aas && enemyRoute.frame == gameLocal.framenum && enemyRoute.areaNum == areaNum && enemyRoute.enemyAreaNum == enemyAreaNum &&
+			enemyRoute.travelFlags == travelFlags && enemyRoute.revision == aas->GetRoutingRevision() ) {
+		return enemyRoute.found;
+	}
+
+	return PathToGoal( path, areaNum, origin, enemyAreaNum, enemyPos );
+}
+
 /*
 =====================
 idAI::TravelDistance
@@ -3870,7 +3890,6 @@ void idAI::UpdateEnemyPosition( void ) {
 	idActor *enemyEnt = enemy.GetEntity();
 	int				enemyAreaNum;
 	int				areaNum;
-	aasPath_t		path;
 	idVec3			enemyPos;
 	bool			onGround;
 
@@ -3900,7 +3919,7 @@ void idAI::UpdateEnemyPosition( void ) {
 			enemyAreaNum = PointReachableAreaNum( enemyPos, 1.0f );
 			if ( enemyAreaNum ) {
 				areaNum = PointReachableAreaNum( org );
-				if ( PathToGoal( path, areaNum, org, enemyAreaNum, enemyPos ) ) {
+				if ( EnemyReachable( areaNum, org, enemyAreaNum, enemyPos ) ) {
 					lastReachableEnemyPos = enemyPos;
 				}
 			}
@@ -3933,6 +3952,151 @@ void idAI::UpdateEnemyPosition( void ) {
 	}
 }
 
+typedef struct enemyRouteQuery_s {
+	idAI *				ai;
+	const idAAS *		aas;
+	int					enemyAreaNum;
+	int					travelFlags;
+} enemyRouteQuery_t;
+
+typedef struct enemyFloorPos_s {
+	idActor *			enemy;
+	bool				onGround;
+	idVec3				pos;
+} enemyFloorPos_t;
+
+/*
+=====================
+CompareEnemyRouteQueries
+
+  sorts the queries of the monsters chasing the same enemy area through the same AAS next to each other
+=====================
+*/
+static int CompareEnemyRouteQueries( const enemyRouteQuery_t *a, const enemyRouteQuery_t *b ) {
+	if ( a->aas != b->aas ) {
+		return ( a->aas < b->aas ) ? -1 : 1;
+	}
+	if ( a->enemyAreaNum != b->enemyAreaNum ) {
+		return a->enemyAreaNum - b->enemyAreaNum;
+	}
+	return a->travelFlags - b->travelFlags;
+}
+
+/*
+=====================
+idAI::RouteToEnemies
+
+  Called before the entities think. The monsters that will update their enemy position this frame
+  and chase the same enemy area are routed with one RoutesToGoalArea query, which floods the
+  routing cache of the enemy area once for all of them. A single monster is left to route itself.
+=====================
+*/
+void idAI::RouteToEnemies( void ) {
+	int							i, j, k, areaNum, enemyAreaNum;
+	idEntity *					ent;
+	idAI *						ai;
+	idActor *					enemyEnt;
+	idVec3						enemyPos;
+	bool						onGround;
+	idList<enemyRouteQuery_t>	queries;
+	idList<enemyFloorPos_t>		floorPositions;
+	idList<aasRoute_t>			routes;
+
+	for( ent = gameLocal.activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() ) {
+		if ( !ent->IsType( idAI::Type ) ) {
+			continue;
+		}
+		ai = static_cast<idAI *>( ent );
+
+		// only the monsters which call UpdateEnemyPosition from Think
+		enemyEnt = ai->enemy.GetEntity();
+		if ( !ai->aas || !enemyEnt || enemyEnt->health <= 0 ) {
+			continue;
+		}
+		if ( !( ai->thinkFlags & TH_THINK ) || ai->fl.isDormant || ai->num_cinematics || ai->move.moveType == MOVETYPE_DEAD ) {
+			continue;
+		}
+		if ( ai->IsHidden() && !ai->allowHiddenMovement ) {
+			continue;
+		}
+		if ( g_cinematic.GetBool() && gameLocal.inCinematic && !ai->cinematic ) {
+			continue;
+		}
+
+		// get the enemy position the way UpdateEnemyPosition does, once per enemy
+		if ( ai->move.moveType == MOVETYPE_FLY ) {
+			enemyPos = enemyEnt->GetPhysics()->GetOrigin();
+		} else {
+			for ( j = 0; j < floorPositions.Num(); j++ ) {
+				if ( floorPositions[j].enemy == enemyEnt ) {
+					break;
+				}
+			}
+			if ( j >= floorPositions.Num() ) {
+				enemyFloorPos_t &floorPos = floorPositions.Alloc();
+				floorPos.enemy = enemyEnt;
+				floorPos.onGround = enemyEnt->GetFloorPos( 64.0f, floorPos.pos ) && !enemyEnt->OnLadder();
+			}
+			onGround = floorPositions[j].onGround;
+			enemyPos = floorPositions[j].pos;
+			if ( !onGround ) {
+				continue;
+			}
+		}
+
+		enemyAreaNum = ai->PointReachableAreaNum( enemyPos, 1.0f );
+		if ( !enemyAreaNum ) {
+			continue;
+		}
+		areaNum = ai->PointReachableAreaNum( ai->physicsObj.GetOrigin() );
+		if ( !areaNum ) {
+			continue;
+		}
+
+		ai->enemyRoute.frame = -1;
+		ai->enemyRoute.areaNum = areaNum;
+
+		enemyRouteQuery_t &query = queries.Alloc();
+		query.ai = ai;
+		query.aas = ai->aas;
+		query.enemyAreaNum = enemyAreaNum;
+		query.travelFlags = ai->travelFlags;
+	}
+
+	queries.Sort( CompareEnemyRouteQueries );
+
+	routes.SetNum( queries.Num() );
+	for ( i = 0; i < queries.Num(); i++ ) {
+		ai = queries[i].ai;
+		routes[i].areaNum = ai->enemyRoute.areaNum;
+		routes[i].origin = ai->physicsObj.GetOrigin();
+		ai->aas->PushPointIntoAreaNum( routes[i].areaNum, routes[i].origin );
+	}
+
+	for ( i = 0; i < queries.Num(); i = j ) {
+		for ( j = i + 1; j < queries.Num(); j++ ) {
+			if ( CompareEnemyRouteQueries( &queries[i], &queries[j] ) != 0 ) {
+				break;
+			}
+		}
+		if ( j - i < 2 ) {
+			continue;
+		}
+
+		queries[i].aas->RoutesToGoalArea( routes.Ptr() + i, j - i, queries[i].enemyAreaNum, queries[i].travelFlags );
+
+		for ( k = i; k < j; k++ ) {
+			enemyRoute_t &enemyRoute = queries[k].ai->enemyRoute;
+			enemyRoute.frame = gameLocal.framenum;
+			enemyRoute.enemyAreaNum = queries[k].enemyAreaNum;
+			enemyRoute.travelFlags = queries[k].travelFlags;
+			enemyRoute.revision = queries[k].aas->GetRoutingRevision();
+			// same as the path the monster would find itself
+			enemyRoute.found = routes[k].found && ( routes[k].reach != NULL || routes[k].areaNum == enemyRoute.enemyAreaNum );
+		}
+	}
+}
+
 /*
 =====================
 idAI::SetEnemy
@@ -188,6 +188,15 @@ typedef struct funcEmitter_s {
 } funcEmitter_t;
 #endif
 
+typedef struct enemyRoute_s {
+	int					frame;			// game frame the route was found in
+	int					areaNum;		// area of the monster
+	int					enemyAreaNum;	// area of the enemy
+	int					travelFlags;
+	int					revision;		// AAS routing revision the route was found with
+	bool				found;			// true if the enemy can be reached
+} enemyRoute_t;
+
 class idMoveState {
 public:
 							idMoveState();
@@ -292,6 +301,8 @@ public:
 	static bool				TestTrajectory( const idVec3 &start, const idVec3 &end, float zVel, float gravity, float time, float max_height, const idClipModel *clip, int clipmask, const idEntity *ignore, const idEntity *targetEntity, int drawtime );
 							// Finds the best collision free trajectory for a clip model.
 	static bool				PredictTrajectory( const idVec3 &firePos, const idVec3 &target, float projectileSpeed, const idVec3 &projGravity, const idClipModel *clip, int clipmask, float max_height, const idEntity *ignore, const idEntity *targetEntity, int drawtime, idVec3 &aimDir );
+							// Finds the routes of all thinking monsters towards their enemy, one AAS query for all monsters chasing the same enemy.
+	static void				RouteToEnemies( void );
 
 #ifdef _D3XP
 	virtual void			Gib( const idVec3 &dir, const char *damageDefName );
@@ -301,6 +312,7 @@ protected:
 	// navigation
 	idAAS *					aas;
 	int						travelFlags;
+	enemyRoute_t			enemyRoute;
 
 	idMoveState				move;
 	idMoveState				savedMove;
@@ -494,6 +506,7 @@ protected:
 	float					TravelDistance( const idVec3 &start, const idVec3 &end ) const;
 	int						PointReachableAreaNum( const idVec3 &pos, const float boundsScale = 2.0f ) const;
 	bool					PathToGoal( aasPath_t &path, int areaNum, const idVec3 &origin, int goalAreaNum, const idVec3 &goalOrigin ) const;
+	bool					EnemyReachable( int areaNum, const idVec3 &origin, int enemyAreaNum, const idVec3 &enemyPos ) const;
 	void					DrawRoute( void ) const;
 	bool					GetMovePos( idVec3 &seekPos );
 	bool					MoveDone( void ) const;
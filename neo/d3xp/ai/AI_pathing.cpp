@@ -92,7 +92,279 @@ void pathNode_s::Init() {
 	parent = children[0] = children[1] = next = NULL;
 }
 
-idBlockAlloc<pathNode_t, 128>	pathNodeAllocator;
+/*
+===============================================================================
+
+	Path node pool
+
+	All nodes of a path tree are taken from a fixed size pool which is reset
+	for every search. This also puts a hard cap on the size of the path tree.
+
+===============================================================================
+*/
+
+const int	MAX_PATH_NODE_ALLOCS		= MAX_PATH_NODES + 2;	// a single expansion can add two nodes past the limit
+
+class idPathNodePool {
+public:
+						idPathNodePool( void ) { numNodes = 0; }
+
+	void				Reset( void ) { numNodes = 0; }
+	pathNode_t *		Alloc( void );
+	int					GetAllocCount( void ) const { return numNodes; }
+
+private:
+	pathNode_t			nodes[MAX_PATH_NODE_ALLOCS];
+	int					numNodes;
+};
+
+pathNode_t *idPathNodePool::Alloc( void ) {
+	assert( numNodes < MAX_PATH_NODE_ALLOCS );
+	pathNode_t *node = &nodes[numNodes++];
+	node->Init();
+	return node;
+}
+
+static idPathNodePool	pathNodePool;
+
+
+/*
+===============================================================================
+
+	Obstacle grid
+
+	Only actors and moveables are considered dynamic obstacles. Instead of
+	walking the clip sector tree for every AI, the clip models of these
+	entities are binned into a coarse 2D grid once per frame. The grid is
+	shared by all obstacle queries during that frame.
+
+===============================================================================
+*/
+
+const float OBSTACLE_GRID_CELL_SIZE		= 128.0f;
+const float OBSTACLE_GRID_MOVE_EPSILON	= 32.0f;	// allows for movement after the grid has been built
+const int	OBSTACLE_GRID_MAX_CELLS		= 64;		// models touching more cells are tested for every query
+
+typedef struct obstacleGridModel_s {
+	idEntityPtr<idEntity>	entity;
+	int						clipModelNum;
+	int						checkCount;
+} obstacleGridModel_t;
+
+typedef struct obstacleGridLink_s {
+	int						x;
+	int						y;
+	int						model;
+} obstacleGridLink_t;
+
+class idObstacleGrid {
+public:
+							idObstacleGrid( void );
+
+	void					Clear( void );
+	int						ClipModelsTouchingBounds( const idBounds &bounds, int contentMask, idClipModel **clipModelList, int maxCount );
+
+private:
+	int						frameNum;
+	int						checkCount;
+	idList<obstacleGridModel_t>	models;
+	idList<obstacleGridLink_t>	links;
+	idList<int>				largeModels;
+	idHashIndex				cellHash;
+
+	void					Build( void );
+	void					AddClipModel( idEntity *ent, int clipModelNum, const idClipModel *clipModel );
+	idClipModel *			GetTouchingClipModel( int modelNum, const idBounds &bounds, int contentMask );
+	static int				CellKey( int x, int y ) { return x * 1031 + y; }
+	static int				CellNum( float f ) { return idMath::FtoiFast( idMath::Floor( f * ( 1.0f / OBSTACLE_GRID_CELL_SIZE ) ) ); }
+};
+
+static idObstacleGrid	obstacleGrid;
+
+/*
+============
+idObstacleGrid::idObstacleGrid
+============
+*/
+idObstacleGrid::idObstacleGrid( void ) {
+	frameNum = -1;
+	checkCount = 0;
+}
+
+/*
+============
+idObstacleGrid::Clear
+============
+*/
+void idObstacleGrid::Clear( void ) {
+	frameNum = -1;
+	models.Clear();
+	links.Clear();
+	largeModels.Clear();
+	cellHash.Free();
+}
+
+/*
+============
+idObstacleGrid::AddClipModel
+============
+*/
+void idObstacleGrid::AddClipModel( idEntity *ent, int clipModelNum, const idClipModel *clipModel ) {
+	int x, y, x0, y0, x1, y1, modelNum;
+
+	modelNum = models.Num();
+	obstacleGridModel_t &model = models.Alloc();
+	model.entity = ent;
+	model.clipModelNum = clipModelNum;
+	model.checkCount = checkCount;
+
+	const idBounds &absBounds = clipModel->GetAbsBounds();
+	x0 = CellNum( absBounds[0].x - OBSTACLE_GRID_MOVE_EPSILON );
+	y0 = CellNum( absBounds[0].y - OBSTACLE_GRID_MOVE_EPSILON );
+	x1 = CellNum( absBounds[1].x + OBSTACLE_GRID_MOVE_EPSILON );
+	y1 = CellNum( absBounds[1].y + OBSTACLE_GRID_MOVE_EPSILON );
+
+	if ( ( x1 - x0 + 1 ) * ( y1 - y0 + 1 ) > OBSTACLE_GRID_MAX_CELLS ) {
+		largeModels.Append( modelNum );
+		return;
+	}
+
+	for ( x = x0; x <= x1; x++ ) {
+		for ( y = y0; y <= y1; y++ ) {
+			obstacleGridLink_t &link = links.Alloc();
+			link.x = x;
+			link.y = y;
+			link.model = modelNum;
+			cellHash.Add( CellKey( x, y ), links.Num() - 1 );
+		}
+	}
+}
+
+/*
+============
+idObstacleGrid::Build
+============
+*/
+void idObstacleGrid::Build( void ) {
+	int i;
+	idEntity *ent;
+	idPhysics *phys;
+	idClipModel *clipModel;
+
+	frameNum = gameLocal.framenum;
+	models.SetNum( 0, false );
+	links.SetNum( 0, false );
+	largeModels.SetNum( 0, false );
+	cellHash.Clear();
+
+	for ( ent = gameLocal.spawnedEntities.Next(); ent != NULL; ent = ent->spawnNode.Next() ) {
+		if ( !ent->IsType( idActor::Type ) && !ent->IsType( idMoveable::Type ) ) {
+			continue;
+		}
+		phys = ent->GetPhysics();
+		for ( i = 0; i < phys->GetNumClipModels(); i++ ) {
+			clipModel = phys->GetClipModel( i );
+			if ( !clipModel || !clipModel->IsLinked() || !clipModel->IsTraceModel() ) {
+				continue;
+			}
+			AddClipModel( ent, i, clipModel );
+		}
+	}
+}
+
+/*
+============
+idObstacleGrid::GetTouchingClipModel
+============
+*/
+idClipModel *idObstacleGrid::GetTouchingClipModel( int modelNum, const idBounds &bounds, int contentMask ) {
+	obstacleGridModel_t &model = models[modelNum];
+
+	// avoid duplicates in the list
+	if ( model.checkCount == checkCount ) {
+		return NULL;
+	}
+	model.checkCount = checkCount;
+
+	// the entity may have been removed after the grid was built
+	idEntity *ent = model.entity.GetEntity();
+	if ( !ent ) {
+		return NULL;
+	}
+	idPhysics *phys = ent->GetPhysics();
+	if ( model.clipModelNum >= phys->GetNumClipModels() ) {
+		return NULL;
+	}
+	idClipModel *clipModel = phys->GetClipModel( model.clipModelNum );
+	if ( !clipModel || !clipModel->IsLinked() || !clipModel->IsEnabled() ) {
+		return NULL;
+	}
+	if ( !( clipModel->GetContents() & contentMask ) ) {
+		return NULL;
+	}
+	if ( !clipModel->GetAbsBounds().IntersectsBounds( bounds ) ) {
+		return NULL;
+	}
+	return clipModel;
+}
+
+/*
+============
+idObstacleGrid::ClipModelsTouchingBounds
+
+  Lists the actor and moveable clip models touching the bounds.
+  The grid is rebuilt on the first query of every frame.
+============
+*/
+int idObstacleGrid::ClipModelsTouchingBounds( const idBounds &bounds, int contentMask, idClipModel **clipModelList, int maxCount ) {
+	int i, x, y, x0, y0, x1, y1, count;
+	idClipModel *clipModel;
+
+	if ( frameNum != gameLocal.framenum ) {
+		Build();
+	}
+
+	checkCount++;
+	count = 0;
+
+	x0 = CellNum( bounds[0].x );
+	y0 = CellNum( bounds[0].y );
+	x1 = CellNum( bounds[1].x );
+	y1 = CellNum( bounds[1].y );
+
+	for ( x = x0; x <= x1; x++ ) {
+		for ( y = y0; y <= y1; y++ ) {
+			for ( i = cellHash.First( CellKey( x, y ) ); i != -1; i = cellHash.Next( i ) ) {
+				if ( links[i].x != x || links[i].y != y ) {
+					continue;
+				}
+				clipModel = GetTouchingClipModel( links[i].model, bounds, contentMask );
+				if ( !clipModel ) {
+					continue;
+				}
+				if ( count >= maxCount ) {
+					gameLocal.Warning( "idObstacleGrid::ClipModelsTouchingBounds: max count" );
+					return count;
+				}
+				clipModelList[count++] = clipModel;
+			}
+		}
+	}
+
+	for ( i = 0; i < largeModels.Num(); i++ ) {
+		clipModel = GetTouchingClipModel( largeModels[i], bounds, contentMask );
+		if ( !clipModel ) {
+			continue;
+		}
+		if ( count >= maxCount ) {
+			gameLocal.Warning( "idObstacleGrid::ClipModelsTouchingBounds: max count" );
+			return count;
+		}
+		clipModelList[count++] = clipModel;
+	}
+
+	return count;
+}
 
 
 /*
@@ -343,7 +615,11 @@ int GetObstacles( const idPhysics *physics, const idAAS *aas, const idEntity *ig
 	clipMask = physics->GetClipMask();
 
 	// find all obstacles touching the clip bounds
-	numListedClipModels = gameLocal.clip.ClipModelsTouchingBounds( clipBounds, clipMask, clipModelList, MAX_GENTITIES );
+	if ( ai_obstacleGrid.GetBool() ) {
+		numListedClipModels = obstacleGrid.ClipModelsTouchingBounds( clipBounds, clipMask, clipModelList, MAX_GENTITIES );
+	} else {
+		numListedClipModels = gameLocal.clip.ClipModelsTouchingBounds( clipBounds, clipMask, clipModelList, MAX_GENTITIES );
+	}
 
 	for ( i = 0; i < numListedClipModels && numObstacles < MAX_OBSTACLES; i++ ) {
 		clipModel = clipModelList[i];
@@ -490,21 +766,6 @@ int GetObstacles( const idPhysics *physics, const idAAS *aas, const idEntity *ig
 	return numObstacles;
 }
 
-/*
-============
-FreePathTree_r
-============
-*/
-void FreePathTree_r( pathNode_t *node ) {
-	if ( node->children[0] ) {
-		FreePathTree_r( node->children[0] );
-	}
-	if ( node->children[1] ) {
-		FreePathTree_r( node->children[1] );
-	}
-	pathNodeAllocator.Free( node );
-}
-
 /*
 ============
 DrawPathTree
@@ -605,15 +866,16 @@ pathNode_t *BuildPathTree( const obstacle_t *obstacles, int numObstacles, const
 	// gcc 4.0
 	idQueueTemplate<pathNode_t, offsetof( pathNode_t, next ) > pathNodeQueue, treeQueue;
 
-	root = pathNodeAllocator.Alloc();
-	root->Init();
+	pathNodePool.Reset();
+
+	root = pathNodePool.Alloc();
 	root->pos = startPos;
 
 	root->delta = seekPos - root->pos;
 	root->numNodes = 0;
 	pathNodeQueue.Add( root );
 
-	for ( node = pathNodeQueue.Get(); node && pathNodeAllocator.GetAllocCount() < MAX_PATH_NODES; node = pathNodeQueue.Get() ) {
+	for ( node = pathNodeQueue.Get(); node && pathNodePool.GetAllocCount() < MAX_PATH_NODES; node = pathNodeQueue.Get() ) {
 
 		treeQueue.Add( node );
 
@@ -639,10 +901,8 @@ pathNode_t *BuildPathTree( const obstacle_t *obstacles, int numObstacles, const
 			node->delta *= blockingScale;
 
 			if ( node->edgeNum == -1 ) {
-				node->children[0] = pathNodeAllocator.Alloc();
-				node->children[0]->Init();
-				node->children[1] = pathNodeAllocator.Alloc();
-				node->children[1]->Init();
+				node->children[0] = pathNodePool.Alloc();
+				node->children[1] = pathNodePool.Alloc();
 				node->children[0]->dir = 0;
 				node->children[1]->dir = 1;
 				node->children[0]->parent = node->children[1]->parent = node;
@@ -657,8 +917,7 @@ pathNode_t *BuildPathTree( const obstacle_t *obstacles, int numObstacles, const
 					pathNodeQueue.Add( node->children[1] );
 				}
 			} else {
-				node->children[node->dir] = child = pathNodeAllocator.Alloc();
-				child->Init();
+				node->children[node->dir] = child = pathNodePool.Alloc();
 				child->dir = node->dir;
 				child->parent = node;
 				child->pos = node->pos + node->delta;
@@ -670,8 +929,7 @@ pathNode_t *BuildPathTree( const obstacle_t *obstacles, int numObstacles, const
 				}
 			}
 		} else {
-			node->children[node->dir] = child = pathNodeAllocator.Alloc();
-			child->Init();
+			node->children[node->dir] = child = pathNodePool.Alloc();
 			child->dir = node->dir;
 			child->parent = node;
 			child->pos = node->pos + node->delta;
@@ -704,7 +962,6 @@ PrunePathTree
 ============
 */
 void PrunePathTree( pathNode_t *root, const idVec2 &seekPos ) {
-	int i;
 	float bestDist;
 	pathNode_t *node, *lastNode, *n, *bestNode;
 
@@ -732,13 +989,8 @@ void PrunePathTree( pathNode_t *root, const idVec2 &seekPos ) {
 				}
 			}
 
-			// free tree down from the best node
-			for ( i = 0; i < 2; i++ ) {
-				if ( bestNode->children[i] ) {
-					FreePathTree_r( bestNode->children[i] );
-					bestNode->children[i] = NULL;
-				}
-			}
+			// cut the tree down from the best node, the nodes go back to the pool with the next search
+			bestNode->children[0] = bestNode->children[1] = NULL;
 
 			for ( lastNode = bestNode, node = bestNode->parent; node; lastNode = node, node = node->parent ) {
 				if ( node->children[1] && ( node->children[1] != lastNode ) ) {
@@ -994,9 +1246,6 @@ bool idAI::FindPathAroundObstacles( const idPhysics *physics, const idAAS *aas,
 	// find the optimal path
 	pathToGoalExists = FindOptimalPath( root, obstacles, numObstacles, physics->GetOrigin().z, physics->GetLinearVelocity(), path.seekPos );
 
-	// free the tree
-	FreePathTree_r( root );
-
 	return pathToGoalExists;
 }
 
@@ -1006,7 +1255,8 @@ idAI::FreeObstacleAvoidanceNodes
 ============
 */
 void idAI::FreeObstacleAvoidanceNodes( void ) {
-	pathNodeAllocator.Shutdown();
+	pathNodePool.Reset();
+	obstacleGrid.Clear();
 }
 
 
@@ -500,6 +500,8 @@ void idEvent::ServiceEvents( void ) {
 	byte		*data;
 	const char  *materialName;
 
+	PROFILE_ZONE( "idEvent::ServiceEvents" );
+
 	num = 0;
 	while( !EventQueue.IsListEmpty() ) {
 		event = EventQueue.Next();
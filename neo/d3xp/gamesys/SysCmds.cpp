@@ -216,6 +216,113 @@ void Cmd_Script_f( const idCmdArgs &args ) {
 	}
 }
 
+/*
+===================
+ScriptBenchmarkRuns
+
+Returns the milliseconds spent executing func runs times, instructions is set to the statements executed
+===================
+*/
+static double ScriptBenchmarkRuns( const function_t *func, int runs, bool fastDispatch, double &instructions ) {
+	idThread	*thread;
+	double		start, msec;
+	int			i;
+
+	g_scriptFastDispatch.SetBool( fastDispatch );
+
+	msec = 0.0;
+	instructions = 0;
+	for( i = 0; i < runs; i++ ) {
+		thread = new idThread( func );
+		thread->ManualDelete();
+		thread->ManualControl();
+
+		start = sys->GetMillisecondsPrecise();
+		thread->Execute();
+		msec += sys->GetMillisecondsPrecise() - start;
+
+		instructions += thread->GetInstructionsExecuted();
+		delete thread;
+	}
+
+	return msec;
+}
+
+/*
+===================
+Cmd_ScriptBenchmark_f
+
+Runs a script function through the statement switch and through the lowered
+instructions and compares the statements per second
+===================
+*/
+static const char *scriptBenchmarkText =
+	"void scriptBenchmark() {\n"
+	"	float i;\n"
+	"	float j;\n"
+	"	float sum;\n"
+	"	vector v;\n"
+	"	sum = 0;\n"
+	"	for( i = 0; i < 1000; i++ ) {\n"
+	"		v = '1 2 3' * i;\n"
+	"		if ( ( i % 3 ) == 0 ) {\n"
+	"			sum += v * '0 0 1';\n"
+	"		} else if ( ( i > 500 ) && ( sum >= 0 ) ) {\n"
+	"			sum = sum - v_x;\n"
+	"		}\n"
+	"		for( j = 0; j < 10; j++ ) {\n"
+	"			sum = sum + j * 0.5;\n"
+	"		}\n"
+	"	}\n"
+	"}\n";
+
+void Cmd_ScriptBenchmark_f( const idCmdArgs &args ) {
+	const function_t	*func;
+	const char			*funcName;
+	int					runs;
+	double				switchInstructions, loweredInstructions;	// may exceed an int with many runs
+	double				switchMsec, loweredMsec;
+	bool				fastDispatch;
+
+	if ( !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	funcName = ( args.Argc() > 1 ) ? args.Argv( 1 ) : "scriptBenchmark";
+	runs = ( args.Argc() > 2 ) ? Max( atoi( args.Argv( 2 ) ), 1 ) : 100;
+
+	func = gameLocal.program.FindFunction( funcName );
+	if ( !func && args.Argc() <= 1 ) {
+		if ( gameLocal.program.CompileText( "scriptBenchmark", scriptBenchmarkText, true ) ) {
+			func = gameLocal.program.FindFunction( funcName );
+		}
+	}
+	if ( !func ) {
+		gameLocal.Printf( "Unknown function '%s'\n", funcName );
+		return;
+	}
+	if ( func->parmTotal || func->eventdef ) {
+		gameLocal.Printf( "'%s' has to be a script function without parameters\n", funcName );
+		return;
+	}
+
+	fastDispatch = g_scriptFastDispatch.GetBool();
+
+	// warm up the caches, then time both
+	ScriptBenchmarkRuns( func, 1, true, loweredInstructions );
+	switchMsec = ScriptBenchmarkRuns( func, runs, false, switchInstructions );
+	loweredMsec = ScriptBenchmarkRuns( func, runs, true, loweredInstructions );
+
+	g_scriptFastDispatch.SetBool( fastDispatch );
+
+	gameLocal.Printf( "%d runs of %s, %.0f statements per run\n", runs, funcName, switchInstructions / runs );
+	gameLocal.Printf( "switch:  %8.2f msec, %7.2f million statements per second\n", switchMsec, switchInstructions / Max( switchMsec, 0.001 ) * 0.001 );
+	gameLocal.Printf( "lowered: %8.2f msec, %7.2f million statements per second, %.2fx\n", loweredMsec, loweredInstructions / Max( loweredMsec, 0.001 ) * 0.001, switchMsec / Max( loweredMsec, 0.001 ) );
+	if ( switchInstructions != loweredInstructions ) {
+		gameLocal.Warning( "the switch executed %.0f statements and the lowered instructions %.0f", switchInstructions, loweredInstructions );
+	}
+}
+
 /*
 ==================
 KillEntities
@@ -1366,6 +1473,105 @@ void D_DrawDebugLines( void ) {
 	}
 }
 
+/*
+==================
+Cmd_TestClipBatch_f
+
+Traces random point and player box translations from the player with
+idClip::TranslationBatch() and tests the contents at their end points with
+idClip::ContentsBatch(), once on the main thread and once in jobs.
+The results are compared with single Translation() and Contents() calls.
+==================
+*/
+static void Cmd_TestClipBatch_f( const idCmdArgs &args ) {
+	idPlayer	*player;
+	idRandom	random;
+	trace_t		tr;
+	int			i, pass, numQueries, numErrors, contents;
+	double		start, singleMsec, batchMsec[2];
+	bool		parallelTraces;
+
+	player = gameLocal.GetLocalPlayer();
+	if ( !player || !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	numQueries = ( args.Argc() > 1 ) ? idMath::ClampInt( 1, 65536, atoi( args.Argv( 1 ) ) ) : 1024;
+
+	idList<clipTraceQuery_t> queries;
+	idList<trace_t> results;
+	idList<int> batchContents;
+	queries.SetNum( numQueries );
+	results.SetNum( numQueries );
+	batchContents.SetNum( numQueries );
+
+	// every other query is a trace of the player bounds
+	const idClipModel *clipModel = player->GetPhysics()->GetClipModel();
+	for ( i = 0; i < numQueries; i++ ) {
+		clipTraceQuery_t &q = queries[i];
+		idVec3 dir( random.CRandomFloat(), random.CRandomFloat(), random.CRandomFloat() );
+		dir.Normalize();
+		if ( i & 1 ) {
+			q.start = player->GetPhysics()->GetOrigin();
+			q.mdl = clipModel;
+			q.trmAxis = clipModel->GetAxis();
+			q.contentMask = MASK_PLAYERSOLID;
+		} else {
+			q.start = player->GetEyePosition();
+			q.mdl = NULL;
+			q.trmAxis = mat3_identity;
+			q.contentMask = MASK_SHOT_RENDERMODEL;
+		}
+		q.end = q.start + dir * 1024.0f;
+		q.passEntity = player;
+	}
+
+	parallelTraces = g_parallelTraces.GetBool();
+
+	numErrors = 0;
+	singleMsec = 0.0;
+	for ( pass = 0; pass < 2; pass++ ) {
+		g_parallelTraces.SetBool( pass != 0 );
+
+		start = sys->GetMillisecondsPrecise();
+		gameLocal.clip.TranslationBatch( results.Ptr(), queries.Ptr(), numQueries );
+		batchMsec[pass] = sys->GetMillisecondsPrecise() - start;
+
+		for ( i = 0; i < numQueries; i++ ) {
+			const clipTraceQuery_t &q = queries[i];
+			start = sys->GetMillisecondsPrecise();
+			gameLocal.clip.Translation( tr, q.start, q.end, q.mdl, q.trmAxis, q.contentMask, q.passEntity );
+			singleMsec += sys->GetMillisecondsPrecise() - start;
+			if ( tr.fraction != results[i].fraction || tr.endpos != results[i].endpos || tr.c.entityNum != results[i].c.entityNum ) {
+				numErrors++;
+			}
+		}
+	}
+
+	// test the contents where the traces would have ended
+	for ( i = 0; i < numQueries; i++ ) {
+		queries[i].start = queries[i].end;
+	}
+	for ( pass = 0; pass < 2; pass++ ) {
+		g_parallelTraces.SetBool( pass != 0 );
+
+		gameLocal.clip.ContentsBatch( batchContents.Ptr(), queries.Ptr(), numQueries );
+
+		for ( i = 0; i < numQueries; i++ ) {
+			const clipTraceQuery_t &q = queries[i];
+			contents = gameLocal.clip.Contents( q.start, q.mdl, q.trmAxis, q.contentMask, q.passEntity );
+			if ( contents != batchContents[i] ) {
+				numErrors++;
+			}
+		}
+	}
+
+	g_parallelTraces.SetBool( parallelTraces );
+
+	gameLocal.Printf( "%d translations: single %.2f msec, batch %.2f msec, batch in jobs %.2f msec\n", numQueries, singleMsec * 0.5, batchMsec[0], batchMsec[1] );
+	gameLocal.Printf( "%d results differ from the single traces\n", numErrors );
+}
+
 /*
 ==================
 Cmd_ListCollisionModels_f
@@ -2413,6 +2619,10 @@ void idGameLocal::InitConsoleCommands( void ) {
 	cmdSystem->AddCommand( "listThreads",			idThread::ListThreads_f,	CMD_FL_GAME|CMD_FL_CHEAT,	"lists script threads" );
 	cmdSystem->AddCommand( "listEntities",			Cmd_EntityList_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"lists game entities" );
 	cmdSystem->AddCommand( "listActiveEntities",	Cmd_ActiveEntityList_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"lists active game entities" );
+	cmdSystem->AddCommand( "listThinkStats",		idThinkStats::ListThinkStats_f,	CMD_FL_GAME,			"lists the entities and classes that take the most time to think, usage: listThinkStats [count] [think|physics|present|script]" );
+	cmdSystem->AddCommand( "writeThinkStats",		idThinkStats::WriteThinkStats_f,	CMD_FL_GAME,			"writes the think stats of all entities and classes to a CSV file" );
+	cmdSystem->AddCommand( "listScriptProfile",		idScriptProfiler::ListScriptProfile_f,	CMD_FL_GAME,		"lists the script functions, threads and events that take the most time, usage: listScriptProfile [count] [time|instructions|calls]" );
+	cmdSystem->AddCommand( "writeScriptProfile",	idScriptProfiler::WriteScriptProfile_f,	CMD_FL_GAME,		"writes the script profile of all functions, threads and events to a CSV file" );
 	cmdSystem->AddCommand( "listMonsters",			idAI::List_f,				CMD_FL_GAME|CMD_FL_CHEAT,	"lists monsters" );
 	cmdSystem->AddCommand( "listSpawnArgs",			Cmd_ListSpawnArgs_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"list the spawn args of an entity", idGameLocal::ArgCompletion_EntityName );
 	cmdSystem->AddCommand( "say",					Cmd_Say_f,					CMD_FL_GAME,				"text chat" );
@@ -2462,8 +2672,10 @@ void idGameLocal::InitConsoleCommands( void ) {
 	cmdSystem->AddCommand( "testBlend",				idTestModel::TestBlend_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"tests animation blending" );
 	cmdSystem->AddCommand( "reloadScript",			Cmd_ReloadScript_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"reloads scripts" );
 	cmdSystem->AddCommand( "script",				Cmd_Script_f,				CMD_FL_GAME|CMD_FL_CHEAT,	"executes a line of script" );
+	cmdSystem->AddCommand( "scriptBenchmark",		Cmd_ScriptBenchmark_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"compares the statements per second of the script interpreter switch and the lowered instructions, usage: scriptBenchmark [function] [runs]" );
 	cmdSystem->AddCommand( "listCollisionModels",	Cmd_ListCollisionModels_f,	CMD_FL_GAME,				"lists collision models" );
 	cmdSystem->AddCommand( "collisionModelInfo",	Cmd_CollisionModelInfo_f,	CMD_FL_GAME,				"shows collision model info" );
+	cmdSystem->AddCommand( "testClipBatch",			Cmd_TestClipBatch_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"compares batched clip traces with single traces, usage: testClipBatch [numTraces]" );
 	cmdSystem->AddCommand( "reexportmodels",		Cmd_ReexportModels_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"reexports models", ArgCompletion_DefFile );
 	cmdSystem->AddCommand( "reloadanims",			Cmd_ReloadAnims_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"reloads animations" );
 	cmdSystem->AddCommand( "listAnims",				Cmd_ListAnims_f,			CMD_FL_GAME,				"lists all animations" );
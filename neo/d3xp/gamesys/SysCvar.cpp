@@ -142,6 +142,9 @@ idCVar g_debugMove(					"g_debugMove",				"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_debugDamage(				"g_debugDamage",			"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_debugWeapon(				"g_debugWeapon",			"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_debugScript(				"g_debugScript",			"0",			CVAR_GAME | CVAR_BOOL, "" );
+idCVar g_scriptFastDispatch(		"g_scriptFastDispatch",		"1",			CVAR_GAME | CVAR_BOOL, "execute the lowered script instructions with the fast dispatch loop, 0 executes every statement through the interpreter switch" );
+idCVar g_scriptProfile(				"g_scriptProfile",			"0",			CVAR_GAME | CVAR_INTEGER, "count the instructions and time spent in script functions, threads and events, see listScriptProfile. 1 = measure, 2 = also write scriptprofile/<map>.csv when the map ends", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
+idCVar g_scriptImageCache(			"g_scriptImageCache",		"1",			CVAR_GAME | CVAR_BOOL, "load compiled scripts from .scriptb program images when their files didn't change and write those after compiling" );
 idCVar g_debugMover(				"g_debugMover",				"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_debugTriggers(				"g_debugTriggers",			"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_debugCinematic(			"g_debugCinematic",			"0",			CVAR_GAME | CVAR_BOOL, "" );
@@ -172,6 +175,10 @@ idCVar g_showEnemies(				"g_showEnemies",			"0",			CVAR_GAME | CVAR_BOOL, "draws
 
 idCVar g_frametime(					"g_frametime",				"0",			CVAR_GAME | CVAR_BOOL, "displays timing information for each game frame" );
 idCVar g_timeentities(				"g_timeEntities",			"0",			CVAR_GAME | CVAR_FLOAT, "when non-zero, shows entities whose think functions exceeded the # of milliseconds specified" );
+idCVar g_thinkStats(				"g_thinkStats",				"0",			CVAR_GAME | CVAR_INTEGER, "measure how long entities and classes take to think, see listThinkStats. 1 = measure, 2 = also write thinkstats/<map>.csv when the map ends", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
+idCVar g_parallelThink(				"g_parallelThink",			"0",			CVAR_GAME | CVAR_BOOL, "build the animation frames of visible entities in parallel jobs at the end of each game frame" );
+idCVar g_checkParallelThink(		"g_checkParallelThink",		"0",			CVAR_GAME | CVAR_INTEGER, "compare the animation frames built by g_parallelThink with serially built ones. 1 = warn, 2 = error on mismatch", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
+idCVar g_parallelTraces(			"g_parallelTraces",			"1",			CVAR_GAME | CVAR_BOOL, "trace large idClip::TranslationBatch() and ContentsBatch() calls in parallel jobs" );
 
 #ifdef _D3XP
 idCVar g_testPistolFlashlight(		"g_testPistolFlashlight",	"1",			CVAR_GAME | CVAR_BOOL, "Test out having a flashlight out with the pistol" );
@@ -200,6 +207,8 @@ idCVar ai_testPredictPath(			"ai_testPredictPath",		"0",			CVAR_GAME | CVAR_BOOL
 idCVar ai_showCombatNodes(			"ai_showCombatNodes",		"0",			CVAR_GAME | CVAR_BOOL, "draws attack cones for monsters" );
 idCVar ai_showPaths(				"ai_showPaths",				"0",			CVAR_GAME | CVAR_BOOL, "draws path_* entities" );
 idCVar ai_showObstacleAvoidance(	"ai_showObstacleAvoidance",	"0",			CVAR_GAME | CVAR_INTEGER, "draws obstacle avoidance information for monsters.  if 2, draws obstacles for player, as well", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
+idCVar ai_obstacleGrid(				"ai_obstacleGrid",			"1",			CVAR_GAME | CVAR_BOOL, "gather obstacles for obstacle avoidance from a grid of actors and moveables that is built once per frame" );
+idCVar ai_batchRouting(				"ai_batchRouting",			"1",			CVAR_GAME | CVAR_BOOL, "route the monsters chasing the same enemy with one batched AAS query at the start of each game frame" );
 idCVar ai_blockedFailSafe(			"ai_blockedFailSafe",		"1",			CVAR_GAME | CVAR_BOOL, "enable blocked fail safe handling" );
 
 #ifdef _D3XP
@@ -371,6 +380,8 @@ idCVar aas_pullPlayer(				"aas_pullPlayer",			"0",			CVAR_GAME | CVAR_INTEGER, "
 idCVar aas_randomPullPlayer(		"aas_randomPullPlayer",		"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar aas_goalArea(				"aas_goalArea",				"0",			CVAR_GAME | CVAR_INTEGER, "" );
 idCVar aas_showPushIntoArea(		"aas_showPushIntoArea",		"0",			CVAR_GAME | CVAR_BOOL, "" );
+idCVar aas_precacheRouting(			"aas_precacheRouting",		"1",			CVAR_GAME | CVAR_BOOL, "calculate the routing cache of all cluster portals on the worker threads after loading the map" );
+idCVar aas_showRoutingStats(		"aas_showRoutingStats",		"0",			CVAR_GAME | CVAR_BOOL, "print the routing queries and routing cache hits of every game frame" );
 
 idCVar g_password(					"g_password",				"",				CVAR_GAME | CVAR_ARCHIVE, "game password" );
 idCVar password(					"password",					"",				CVAR_GAME | CVAR_NOCHEAT, "client password used when connecting" );
@@ -58,6 +58,9 @@ extern idCVar	g_debugMove;
 extern idCVar	g_debugDamage;
 extern idCVar	g_debugWeapon;
 extern idCVar	g_debugScript;
+extern idCVar	g_scriptFastDispatch;
+extern idCVar	g_scriptProfile;
+extern idCVar	g_scriptImageCache;
 extern idCVar	g_debugMover;
 extern idCVar	g_debugTriggers;
 extern idCVar	g_debugCinematic;
@@ -86,6 +89,10 @@ extern idCVar	g_showEnemies;
 
 extern idCVar	g_frametime;
 extern idCVar	g_timeentities;
+extern idCVar	g_thinkStats;
+extern idCVar	g_parallelThink;
+extern idCVar	g_checkParallelThink;
+extern idCVar	g_parallelTraces;
 
 extern idCVar	ai_debugScript;
 extern idCVar	ai_debugMove;
@@ -94,6 +101,8 @@ extern idCVar	ai_testPredictPath;
 extern idCVar	ai_showCombatNodes;
 extern idCVar	ai_showPaths;
 extern idCVar	ai_showObstacleAvoidance;
+extern idCVar	ai_obstacleGrid;
+extern idCVar	ai_batchRouting;
 extern idCVar	ai_blockedFailSafe;
 #ifdef _D3XP
 extern idCVar	ai_showHealth;
@@ -268,6 +277,8 @@ extern idCVar	aas_pullPlayer;
 extern idCVar	aas_randomPullPlayer;
 extern idCVar	aas_goalArea;
 extern idCVar	aas_showPushIntoArea;
+extern idCVar	aas_precacheRouting;
+extern idCVar	aas_showRoutingStats;
 
 extern idCVar	net_clientPredictGUI;
 
@@ -28,6 +28,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "sys/platform.h"
 #include "gamesys/SaveGame.h"
+#include "gamesys/SysCvar.h"
 #include "Entity.h"
 #include "Game_local.h"
 
@@ -35,6 +36,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #define	MAX_SECTOR_DEPTH				12
 #define MAX_SECTORS						((1<<(MAX_SECTOR_DEPTH+1))-1)
+#define CLIP_BATCH_QUERIES_PER_JOB		16
 
 typedef struct clipSector_s {
 	int						axis;		// -1 = leaf node
@@ -626,6 +628,14 @@ idClip::idClip( void ) {
 	clipSectors = NULL;
 	worldBounds.Zero();
 	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
+	numBatchQueries = 0;
+	batchQueries = NULL;
+	batchResults = NULL;
+	batchContents = NULL;
+	batchJobList = NULL;
+	batchQueryStack.SetGranularity( 1024 );
+	batchTouches.SetGranularity( 1024 );
+	batchSortedTouches.SetGranularity( 1024 );
 }
 
 /*
@@ -707,6 +717,10 @@ void idClip::Init( void ) {
 
 	// set counters to zero
 	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
+
+	if ( !batchJobList ) {
+		batchJobList = parallelJobManager->AllocJobList( "idClip::TranslationBatch" );
+	}
 }
 
 /*
@@ -731,6 +745,21 @@ void idClip::Shutdown( void ) {
 	}
 
 	clipLinkAllocator.Shutdown();
+
+	batchBounds.Clear();
+	batchMasks.Clear();
+	batchQueryStack.Clear();
+	batchTouches.Clear();
+	batchSortedTouches.Clear();
+	batchFirstTouch.Clear();
+	batchTrms.Clear();
+	batchDone.Clear();
+	batchJobs.Clear();
+
+	if ( batchJobList ) {
+		parallelJobManager->FreeJobList( batchJobList );
+		batchJobList = NULL;
+	}
 }
 
 /*
@@ -858,6 +887,40 @@ int idClip::EntitiesTouchingBounds( const idBounds &bounds, int contentMask, idE
 	return entCount;
 }
 
+/*
+====================
+GetPassOwner
+
+  returns the owner of the pass entity, traces don't clip against it either
+====================
+*/
+static idEntity *GetPassOwner( const idEntity *passEntity ) {
+	if ( passEntity && passEntity->GetPhysics()->GetNumClipModels() > 0 ) {
+		return passEntity->GetPhysics()->GetClipModel()->GetOwner();
+	}
+	return NULL;
+}
+
+/*
+====================
+IgnoreTraceClipModel
+====================
+*/
+static ID_INLINE bool IgnoreTraceClipModel( const idClipModel *cm, const idEntity *passEntity, const idEntity *passOwner ) {
+	if ( cm->GetEntity() == passEntity ) {
+		return true;			// don't clip against the pass entity
+	} else if ( cm->GetEntity() == passOwner ) {
+		return true;			// missiles don't clip with their owner
+	} else if ( cm->GetOwner() ) {
+		if ( cm->GetOwner() == passEntity ) {
+			return true;		// don't clip against own missiles
+		} else if ( cm->GetOwner() == passOwner ) {
+			return true;		// don't clip against other missiles from same owner
+		}
+	}
+	return false;
+}
+
 /*
 ====================
 idClip::GetTraceClipModels
@@ -871,7 +934,6 @@ idClip::GetTraceClipModels
 */
 int idClip::GetTraceClipModels( const idBounds &bounds, int contentMask, const idEntity *passEntity, idClipModel **clipModelList ) const {
 	int i, num;
-	idClipModel	*cm;
 	idEntity *passOwner;
 
 	num = ClipModelsTouchingBounds( bounds, contentMask, clipModelList, MAX_GENTITIES );
@@ -880,27 +942,12 @@ int idClip::GetTraceClipModels( const idBounds &bounds, int contentMask, const i
 		return num;
 	}
 
-	if ( passEntity->GetPhysics()->GetNumClipModels() > 0 ) {
-		passOwner = passEntity->GetPhysics()->GetClipModel()->GetOwner();
-	} else {
-		passOwner = NULL;
-	}
+	passOwner = GetPassOwner( passEntity );
 
 	for ( i = 0; i < num; i++ ) {
-
-		cm = clipModelList[i];
-
 		// check if we should ignore this entity
-		if ( cm->entity == passEntity ) {
-			clipModelList[i] = NULL;			// don't clip against the pass entity
-		} else if ( cm->entity == passOwner ) {
-			clipModelList[i] = NULL;			// missiles don't clip with their owner
-		} else if ( cm->owner ) {
-			if ( cm->owner == passEntity ) {
-				clipModelList[i] = NULL;		// don't clip against own missiles
-			} else if ( cm->owner == passOwner ) {
-				clipModelList[i] = NULL;		// don't clip against other missiles from same owner
-			}
+		if ( IgnoreTraceClipModel( clipModelList[i], passEntity, passOwner ) ) {
+			clipModelList[i] = NULL;
 		}
 	}
 
@@ -1058,11 +1105,9 @@ idClip::Translation
 */
 bool idClip::Translation( trace_t &results, const idVec3 &start, const idVec3 &end,
 						const idClipModel *mdl, const idMat3 &trmAxis, int contentMask, const idEntity *passEntity ) {
-	int i, num;
-	idClipModel *touch, *clipModelList[MAX_GENTITIES];
+	int num;
+	idClipModel *clipModelList[MAX_GENTITIES];
 	idBounds traceBounds;
-	float radius;
-	trace_t trace;
 	const idTraceModel *trm;
 
 	if ( TestHugeTranslation( results, mdl, start, end, trmAxis ) ) {
@@ -1088,14 +1133,34 @@ bool idClip::Translation( trace_t &results, const idVec3 &start, const idVec3 &e
 
 	if ( !trm ) {
 		traceBounds.FromPointTranslation( start, results.endpos - start );
-		radius = 0.0f;
 	} else {
 		traceBounds.FromBoundsTranslation( trm->bounds, start, trmAxis, results.endpos - start );
-		radius = trm->bounds.GetRadius();
 	}
 
 	num = GetTraceClipModels( traceBounds, contentMask, passEntity, clipModelList );
 
+	TranslationClipModels( results, start, end, trm, trmAxis, contentMask, clipModelList, num, idClip::numTranslations );
+
+	return ( results.fraction < 1.0f );
+}
+
+/*
+============
+idClip::TranslationClipModels
+
+  clips the translation against the clip models, results is only replaced by closer hits.
+  numTraces counts the collision model traces, the render model traces are counted here
+============
+*/
+void idClip::TranslationClipModels( trace_t &results, const idVec3 &start, const idVec3 &end, const idTraceModel *trm, const idMat3 &trmAxis,
+									int contentMask, idClipModel **clipModelList, const int num, int &numTraces ) {
+	int i;
+	idClipModel *touch;
+	float radius;
+	trace_t trace;
+
+	radius = trm ? trm->bounds.GetRadius() : 0.0f;
+
 	for ( i = 0; i < num; i++ ) {
 		touch = clipModelList[i];
 
@@ -1107,7 +1172,7 @@ bool idClip::Translation( trace_t &results, const idVec3 &start, const idVec3 &e
 			idClip::numRenderModelTraces++;
 			TraceRenderModel( trace, start, end, radius, trmAxis, touch );
 		} else {
-			idClip::numTranslations++;
+			numTraces++;
 			collisionModelManager->Translation( &trace, start, end, trm, trmAxis, contentMask,
 									touch->Handle(), touch->origin, touch->axis );
 		}
@@ -1121,8 +1186,6 @@ bool idClip::Translation( trace_t &results, const idVec3 &start, const idVec3 &e
 			}
 		}
 	}
-
-	return ( results.fraction < 1.0f );
 }
 
 /*
@@ -1424,14 +1487,31 @@ int idClip::Contacts( contactInfo_t *contacts, const int maxContacts, const idVe
 	return numContacts;
 }
 
+/*
+============
+ContentsBounds
+============
+*/
+static ID_INLINE void ContentsBounds( idBounds &bounds, const idVec3 &start, const idTraceModel *trm, const idMat3 &trmAxis ) {
+	if ( !trm ) {
+		bounds[0] = start;
+		bounds[1] = start;
+	} else if ( trmAxis.IsRotated() ) {
+		bounds.FromTransformedBounds( trm->bounds, start, trmAxis );
+	} else {
+		bounds[0] = trm->bounds[0] + start;
+		bounds[1] = trm->bounds[1] + start;
+	}
+}
+
 /*
 ============
 idClip::Contents
 ============
 */
 int idClip::Contents( const idVec3 &start, const idClipModel *mdl, const idMat3 &trmAxis, int contentMask, const idEntity *passEntity ) {
-	int i, num, contents;
-	idClipModel *touch, *clipModelList[MAX_GENTITIES];
+	int num, contents;
+	idClipModel *clipModelList[MAX_GENTITIES];
 	idBounds traceBounds;
 	const idTraceModel *trm;
 
@@ -1445,18 +1525,25 @@ int idClip::Contents( const idVec3 &start, const idClipModel *mdl, const idMat3
 		contents = 0;
 	}
 
-	if ( !trm ) {
-		traceBounds[0] = start;
-		traceBounds[1] = start;
-	} else if ( trmAxis.IsRotated() ) {
-		traceBounds.FromTransformedBounds( trm->bounds, start, trmAxis );
-	} else {
-		traceBounds[0] = trm->bounds[0] + start;
-		traceBounds[1] = trm->bounds[1] + start;
-	}
+	ContentsBounds( traceBounds, start, trm, trmAxis );
 
 	num = GetTraceClipModels( traceBounds, -1, passEntity, clipModelList );
 
+	return ContentsClipModels( contents, start, trm, trmAxis, contentMask, clipModelList, num, idClip::numContents );
+}
+
+/*
+============
+idClip::ContentsClipModels
+
+  returns contents with the contents of the clip models added, numTraces counts the collision model tests
+============
+*/
+int idClip::ContentsClipModels( int contents, const idVec3 &start, const idTraceModel *trm, const idMat3 &trmAxis,
+								int contentMask, idClipModel **clipModelList, const int num, int &numTraces ) {
+	int i;
+	idClipModel *touch;
+
 	for ( i = 0; i < num; i++ ) {
 		touch = clipModelList[i];
 
@@ -1479,7 +1566,7 @@ int idClip::Contents( const idVec3 &start, const idClipModel *mdl, const idMat3
 			continue;
 		}
 
-		idClip::numContents++;
+		numTraces++;
 		if ( collisionModelManager->Contents( start, trm, trmAxis, contentMask, touch->Handle(), touch->origin, touch->axis ) ) {
 			contents |= ( touch->contents & contentMask );
 		}
@@ -1488,6 +1575,456 @@ int idClip::Contents( const idVec3 &start, const idClipModel *mdl, const idMat3
 	return contents;
 }
 
+/*
+============
+idClip::GetBatchClipModels_r
+
+  batchQueryStack[first] to batchQueryStack[first+num-1] are the queries touching the node.
+  every query visits the sectors in the same order as ClipModelsTouchingBounds_r
+  and the clip models of a sector are stored in order, so the clip models per
+  query end up in the same order as for a single query
+============
+*/
+void idClip::GetBatchClipModels_r( const struct clipSector_s *node, const int first, const int num ) {
+	int i;
+
+	if ( node->axis != -1 ) {
+		const int axis = node->axis;
+		const int start = batchQueryStack.Num();
+
+		for ( i = 0; i < num; i++ ) {
+			const int q = batchQueryStack[first + i];
+			if ( batchBounds[q][0][axis] > node->dist || !( batchBounds[q][1][axis] < node->dist ) ) {
+				batchQueryStack.Append( q );
+			}
+		}
+		const int numFront = batchQueryStack.Num() - start;
+
+		for ( i = 0; i < num; i++ ) {
+			const int q = batchQueryStack[first + i];
+			if ( !( batchBounds[q][0][axis] > node->dist ) ) {
+				batchQueryStack.Append( q );
+			}
+		}
+		const int numBack = batchQueryStack.Num() - start - numFront;
+
+		if ( numFront ) {
+			GetBatchClipModels_r( node->children[0], start, numFront );
+		}
+		if ( numBack ) {
+			GetBatchClipModels_r( node->children[1], start + numFront, numBack );
+		}
+		batchQueryStack.SetNum( start, false );
+		return;
+	}
+
+	for ( clipLink_t *link = node->clipLinks; link; link = link->nextInSector ) {
+		idClipModel	*check = link->clipModel;
+
+		// if the clip model is enabled
+		if ( !check->enabled ) {
+			continue;
+		}
+
+		for ( i = 0; i < num; i++ ) {
+			const int q = batchQueryStack[first + i];
+			const idBounds &bounds = batchBounds[q];
+
+			// if the clip model does not have any contents we are looking for
+			if ( !( check->contents & batchMasks[q] ) ) {
+				continue;
+			}
+
+			// if the bounds really do overlap
+			if (	check->absBounds[0][0] > bounds[1][0] ||
+					check->absBounds[1][0] < bounds[0][0] ||
+					check->absBounds[0][1] > bounds[1][1] ||
+					check->absBounds[1][1] < bounds[0][1] ||
+					check->absBounds[0][2] > bounds[1][2] ||
+					check->absBounds[1][2] < bounds[0][2] ) {
+				continue;
+			}
+
+			clipBatchTouch_t &touch = batchTouches.Alloc();
+			touch.query = q;
+			touch.clipModel = check;
+		}
+	}
+}
+
+/*
+============
+idClip::GetBatchClipModels
+
+  walks the sectors once with all queries for which batchBounds and batchMasks are set up
+  and sorts the touched clip models by query
+============
+*/
+void idClip::GetBatchClipModels( const int numQueries ) {
+	int i, j, numTouches;
+
+	batchTouches.SetNum( 0, false );
+	batchQueryStack.SetNum( 0, false );
+	for ( i = 0; i < numQueries; i++ ) {
+		// skip queries that are not set up, like huge translations
+		if ( batchBounds[i][0][0] <= batchBounds[i][1][0] ) {
+			batchQueryStack.Append( i );
+		}
+	}
+	if ( batchQueryStack.Num() ) {
+		GetBatchClipModels_r( clipSectors, 0, batchQueryStack.Num() );
+	}
+
+	// stable counting sort by query
+	batchFirstTouch.AssureSize( numQueries + 1 );
+	memset( batchFirstTouch.Ptr(), 0, ( numQueries + 1 ) * sizeof( int ) );
+	for ( i = 0; i < batchTouches.Num(); i++ ) {
+		batchFirstTouch[batchTouches[i].query + 1]++;
+	}
+	for ( i = 0; i < numQueries; i++ ) {
+		batchFirstTouch[i + 1] += batchFirstTouch[i];
+	}
+
+	idList<int> &next = batchQueryStack;
+	next.SetNum( numQueries, false );
+	memcpy( next.Ptr(), batchFirstTouch.Ptr(), numQueries * sizeof( int ) );
+
+	batchSortedTouches.SetNum( batchTouches.Num(), false );
+	for ( i = 0; i < batchTouches.Num(); i++ ) {
+		batchSortedTouches[next[batchTouches[i].query]++] = batchTouches[i];
+	}
+	batchTouches.Swap( batchSortedTouches );
+	batchQueryStack.SetNum( 0, false );
+
+	// remove the duplicates of clip models linked into several sectors here,
+	// the queries may be traced in jobs which can't use the touch count
+	numTouches = 0;
+	for ( i = 0; i < numQueries; i++ ) {
+		const int first = numTouches;
+
+		touchCount++;
+		for ( j = batchFirstTouch[i]; j < batchFirstTouch[i + 1]; j++ ) {
+			idClipModel *check = batchTouches[j].clipModel;
+
+			if ( check->touchCount == touchCount ) {
+				continue;
+			}
+
+			if ( numTouches - first >= MAX_GENTITIES ) {
+				gameLocal.Warning( "idClip::GetBatchClipModels: max count" );
+				break;
+			}
+
+			check->touchCount = touchCount;
+			batchTouches[numTouches++] = batchTouches[j];
+		}
+		batchFirstTouch[i] = first;
+	}
+	batchFirstTouch[numQueries] = numTouches;
+	batchTouches.SetNum( numTouches, false );
+}
+
+/*
+============
+idClip::GetBatchTraceClipModels
+
+  the batch version of GetTraceClipModels, bounds may be smaller than the bounds the query was gathered with.
+  only reads the clip models so it can run in jobs
+============
+*/
+int idClip::GetBatchTraceClipModels( const int query, const idBounds &bounds, const idEntity *passEntity, idClipModel **clipModelList ) const {
+	int i, num;
+	idBounds expanded;
+	idEntity *passOwner;
+
+	expanded[0] = bounds[0] - vec3_boxEpsilon;
+	expanded[1] = bounds[1] + vec3_boxEpsilon;
+	passOwner = GetPassOwner( passEntity );
+
+	num = 0;
+	for ( i = batchFirstTouch[query]; i < batchFirstTouch[query + 1]; i++ ) {
+		idClipModel *check = batchTouches[i].clipModel;
+
+		if (	check->absBounds[0][0] > expanded[1][0] ||
+				check->absBounds[1][0] < expanded[0][0] ||
+				check->absBounds[0][1] > expanded[1][1] ||
+				check->absBounds[1][1] < expanded[0][1] ||
+				check->absBounds[0][2] > expanded[1][2] ||
+				check->absBounds[1][2] < expanded[0][2] ) {
+			continue;
+		}
+
+		if ( passEntity && IgnoreTraceClipModel( check, passEntity, passOwner ) ) {
+			continue;
+		}
+
+		clipModelList[num++] = check;
+	}
+
+	return num;
+}
+
+/*
+============
+idClip::BatchTouchesRenderModel
+
+  render model traces aren't thread safe, queries touching a render model are traced on the main thread
+============
+*/
+bool idClip::BatchTouchesRenderModel( const int query ) const {
+	int i;
+
+	for ( i = batchFirstTouch[query]; i < batchFirstTouch[query + 1]; i++ ) {
+		if ( batchTouches[i].clipModel->renderModelHandle != -1 ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+============
+idClip::RunBatchJobs
+
+  traces the queries of the batch in jobs and returns the number of collision model traces once all are done
+============
+*/
+int idClip::RunBatchJobs( jobRun_t function, const int numQueries ) {
+	int i, numTraces;
+
+	batchJobs.SetNum( ( numQueries + CLIP_BATCH_QUERIES_PER_JOB - 1 ) / CLIP_BATCH_QUERIES_PER_JOB, false );
+	for ( i = 0; i < batchJobs.Num(); i++ ) {
+		clipBatchJob_t &job = batchJobs[i];
+		job.clip = this;
+		job.firstQuery = i * CLIP_BATCH_QUERIES_PER_JOB;
+		job.numQueries = Min( CLIP_BATCH_QUERIES_PER_JOB, numQueries - job.firstQuery );
+		job.numTraces = 0;
+		batchJobList->AddJob( function, &job );
+	}
+
+	batchJobList->Submit();
+	batchJobList->Wait();
+	batchJobList->Clear();
+
+	numTraces = 0;
+	for ( i = 0; i < batchJobs.Num(); i++ ) {
+		numTraces += batchJobs[i].numTraces;
+	}
+	return numTraces;
+}
+
+/*
+============
+idClip::TranslationBatchQuery
+
+  in a job the queries touching a render model are skipped and left for the main thread
+============
+*/
+void idClip::TranslationBatchQuery( const int query, const bool inJob, int &numTraces ) {
+	int num;
+	idClipModel *clipModelList[MAX_GENTITIES];
+	idBounds traceBounds;
+
+	if ( batchDone[query] ) {
+		return;
+	}
+	if ( inJob && BatchTouchesRenderModel( query ) ) {
+		return;
+	}
+
+	const clipTraceQuery_t &q = batchQueries[query];
+	const idTraceModel *trm = batchTrms[query];
+	trace_t &tr = batchResults[query];
+
+	batchDone[query] = true;
+
+	if ( !q.passEntity || q.passEntity->entityNumber != ENTITYNUM_WORLD ) {
+		// test world
+		numTraces++;
+		collisionModelManager->Translation( &tr, q.start, q.end, trm, q.trmAxis, q.contentMask, 0, vec3_origin, mat3_default );
+		tr.c.entityNum = tr.fraction != 1.0f ? ENTITYNUM_WORLD : ENTITYNUM_NONE;
+		if ( tr.fraction == 0.0f ) {
+			return;		// blocked immediately by the world
+		}
+	} else {
+		memset( &tr, 0, sizeof( tr ) );
+		tr.fraction = 1.0f;
+		tr.endpos = q.end;
+		tr.endAxis = q.trmAxis;
+	}
+
+	if ( !trm ) {
+		traceBounds.FromPointTranslation( q.start, tr.endpos - q.start );
+	} else {
+		traceBounds.FromBoundsTranslation( trm->bounds, q.start, q.trmAxis, tr.endpos - q.start );
+	}
+
+	num = GetBatchTraceClipModels( query, traceBounds, q.passEntity, clipModelList );
+
+	TranslationClipModels( tr, q.start, q.end, trm, q.trmAxis, q.contentMask, clipModelList, num, numTraces );
+}
+
+/*
+============
+idClip::TranslationBatchJob
+============
+*/
+void idClip::TranslationBatchJob( clipBatchJob_t *job ) {
+	for ( int i = 0; i < job->numQueries; i++ ) {
+		job->clip->TranslationBatchQuery( job->firstQuery + i, true, job->numTraces );
+	}
+}
+
+/*
+============
+idClip::TranslationBatch
+============
+*/
+int idClip::TranslationBatch( trace_t *results, const clipTraceQuery_t *queries, const int numQueries ) {
+	int i, numHits;
+	const idTraceModel *trm;
+
+	if ( numQueries <= 0 ) {
+		return 0;
+	}
+
+	idClip::numBatchQueries += numQueries;
+
+	batchBounds.AssureSize( numQueries );
+	batchMasks.AssureSize( numQueries );
+	batchTrms.AssureSize( numQueries );
+	batchDone.AssureSize( numQueries );
+	for ( i = 0; i < numQueries; i++ ) {
+		const clipTraceQuery_t &q = queries[i];
+
+		if ( TestHugeTranslation( results[i], q.mdl, q.start, q.end, q.trmAxis ) ) {
+			batchBounds[i].Clear();
+			batchDone[i] = true;
+			continue;
+		}
+
+		trm = TraceModelForClipModel( q.mdl );
+		if ( !trm ) {
+			batchBounds[i].FromPointTranslation( q.start, q.end - q.start );
+		} else {
+			batchBounds[i].FromBoundsTranslation( trm->bounds, q.start, q.trmAxis, q.end - q.start );
+		}
+		batchBounds[i][0] -= vec3_boxEpsilon;
+		batchBounds[i][1] += vec3_boxEpsilon;
+		batchMasks[i] = q.contentMask;
+		batchTrms[i] = trm;
+		batchDone[i] = false;
+	}
+
+	GetBatchClipModels( numQueries );
+
+	batchQueries = queries;
+	batchResults = results;
+
+	if ( g_parallelTraces.GetBool() && batchJobList != NULL && numQueries > CLIP_BATCH_QUERIES_PER_JOB ) {
+		idClip::numTranslations += RunBatchJobs( (jobRun_t)TranslationBatchJob, numQueries );
+	}
+
+	// everything the jobs left
+	for ( i = 0; i < numQueries; i++ ) {
+		TranslationBatchQuery( i, false, idClip::numTranslations );
+	}
+
+	batchQueries = NULL;
+	batchResults = NULL;
+
+	numHits = 0;
+	for ( i = 0; i < numQueries; i++ ) {
+		if ( results[i].fraction < 1.0f ) {
+			numHits++;
+		}
+	}
+
+	return numHits;
+}
+
+/*
+============
+idClip::ContentsBatchQuery
+============
+*/
+void idClip::ContentsBatchQuery( const int query, int &numTraces ) {
+	int num, contents;
+	idClipModel *clipModelList[MAX_GENTITIES];
+	idBounds bounds;
+	const clipTraceQuery_t &q = batchQueries[query];
+	const idTraceModel *trm = batchTrms[query];
+
+	if ( !q.passEntity || q.passEntity->entityNumber != ENTITYNUM_WORLD ) {
+		// test world
+		numTraces++;
+		contents = collisionModelManager->Contents( q.start, trm, q.trmAxis, q.contentMask, 0, vec3_origin, mat3_default );
+	} else {
+		contents = 0;
+	}
+
+	ContentsBounds( bounds, q.start, trm, q.trmAxis );
+	num = GetBatchTraceClipModels( query, bounds, q.passEntity, clipModelList );
+
+	batchContents[query] = ContentsClipModels( contents, q.start, trm, q.trmAxis, q.contentMask, clipModelList, num, numTraces );
+}
+
+/*
+============
+idClip::ContentsBatchJob
+============
+*/
+void idClip::ContentsBatchJob( clipBatchJob_t *job ) {
+	for ( int i = 0; i < job->numQueries; i++ ) {
+		job->clip->ContentsBatchQuery( job->firstQuery + i, job->numTraces );
+	}
+}
+
+/*
+============
+idClip::ContentsBatch
+============
+*/
+void idClip::ContentsBatch( int *contents, const clipTraceQuery_t *queries, const int numQueries ) {
+	int i;
+
+	if ( numQueries <= 0 ) {
+		return;
+	}
+
+	idClip::numBatchQueries += numQueries;
+
+	batchBounds.AssureSize( numQueries );
+	batchMasks.AssureSize( numQueries );
+	batchTrms.AssureSize( numQueries );
+	for ( i = 0; i < numQueries; i++ ) {
+		const clipTraceQuery_t &q = queries[i];
+		idBounds &bounds = batchBounds[i];
+
+		batchTrms[i] = TraceModelForClipModel( q.mdl );
+		ContentsBounds( bounds, q.start, batchTrms[i], q.trmAxis );
+		bounds[0] -= vec3_boxEpsilon;
+		bounds[1] += vec3_boxEpsilon;
+		batchMasks[i] = -1;
+	}
+
+	GetBatchClipModels( numQueries );
+
+	batchQueries = queries;
+	batchContents = contents;
+
+	if ( g_parallelTraces.GetBool() && batchJobList != NULL && numQueries > CLIP_BATCH_QUERIES_PER_JOB ) {
+		idClip::numContents += RunBatchJobs( (jobRun_t)ContentsBatchJob, numQueries );
+	} else {
+		for ( i = 0; i < numQueries; i++ ) {
+			ContentsBatchQuery( i, idClip::numContents );
+		}
+	}
+
+	batchQueries = NULL;
+	batchContents = NULL;
+}
+
 /*
 ============
 idClip::TranslationModel
@@ -1607,9 +2144,10 @@ idClip::PrintStatistics
 ============
 */
 void idClip::PrintStatistics( void ) {
-	gameLocal.Printf( "t = %-3d, r = %-3d, m = %-3d, render = %-3d, contents = %-3d, contacts = %-3d\n",
-					numTranslations, numRotations, numMotions, numRenderModelTraces, numContents, numContacts );
+	gameLocal.Printf( "t = %-3d, r = %-3d, m = %-3d, render = %-3d, contents = %-3d, contacts = %-3d, batched = %-3d\n",
+					numTranslations, numRotations, numMotions, numRenderModelTraces, numContents, numContacts, numBatchQueries );
 	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
+	numBatchQueries = 0;
 }
 
 /*
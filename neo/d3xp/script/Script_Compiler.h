@@ -277,6 +277,8 @@ public :
 
 					idCompiler();
 	void			CompileFile( const char *text, const char *filename, bool console );
+					// files included by the last CompileFile
+	const idStrList &GetIncludedFiles( void ) const { return parser.GetIncludedFiles(); }
 };
 
 #endif /* !__SCRIPT_COMPILER_H__ */
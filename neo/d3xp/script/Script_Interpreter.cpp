@@ -179,6 +179,8 @@ void idInterpreter::Reset( void ) {
 
 	threadDying		= false;
 	doneProcessing	= true;
+
+	instructionsExecuted = 0;
 }
 
 /*
@@ -607,6 +609,10 @@ void idInterpreter::EnterFunction( const function_t *func, bool clearStack ) {
 		Error( "call stack overflow" );
 	}
 
+	if ( gameLocal.scriptProfiler.IsActive() ) {
+		gameLocal.scriptProfiler.AddFunctionCall( func );
+	}
+
 	stack = &callStack[ callStackDepth ];
 
 	stack->s			= instructionPointer + 1;	// point to the next instruction to execute
@@ -831,7 +837,13 @@ void idInterpreter::CallEvent( const function_t *func, int argsize ) {
 	}
 
 	popParms = argsize;
-	eventEntity->ProcessEventArgPtr( evdef, data );
+	if ( gameLocal.scriptProfiler.IsActive() ) {
+		double start = sys->GetMillisecondsPrecise();
+		eventEntity->ProcessEventArgPtr( evdef, data );
+		gameLocal.scriptProfiler.AddEvent( evdef, false, sys->GetMillisecondsPrecise() - start );
+	} else {
+		eventEntity->ProcessEventArgPtr( evdef, data );
+	}
 
 	if ( !multiFrameEvent ) {
 		if ( popParms ) {
@@ -961,13 +973,535 @@ void idInterpreter::CallSysEvent( const function_t *func, int argsize ) {
 	}
 
 	popParms = argsize;
-	thread->ProcessEventArgPtr( evdef, data );
+	if ( gameLocal.scriptProfiler.IsActive() ) {
+		double start = sys->GetMillisecondsPrecise();
+		thread->ProcessEventArgPtr( evdef, data );
+		gameLocal.scriptProfiler.AddEvent( evdef, true, sys->GetMillisecondsPrecise() - start );
+	} else {
+		thread->ProcessEventArgPtr( evdef, data );
+	}
 	if ( popParms ) {
 		PopParms( popParms );
 	}
 	popParms = 0;
 }
 
+/*
+====================
+idInterpreter::ExecuteLowered
+
+Executes the lowered instructions after the current statement until one has
+to be executed from its statement by Execute.  Returns the remaining runaway count.
+====================
+*/
+
+// operands of the current instruction
+#define LOWERED_ADDRESS( x )	( bases[ ( x ) & SCRIPT_OPERAND_LOCAL ] + ( ( x ) >> 1 ) )
+#define LOWERED_FLOAT( x )		( *( float * )LOWERED_ADDRESS( in->x ) )
+#define LOWERED_INT( x )		( *( int * )LOWERED_ADDRESS( in->x ) )
+#define LOWERED_VECTOR( x )		( *( idVec3 * )LOWERED_ADDRESS( in->x ) )
+#define LOWERED_POINTER( x )	( ( varEval_t * )LOWERED_ADDRESS( in->x ) )
+#define LOWERED_FIELD( type )	( *( type * )&obj->data[ in->b ] )
+
+#if defined( __GNUC__ )
+// threaded dispatch, every instruction jumps straight to the code of the next one
+#define LOWERED_CASE( x )		op_##x:
+#define LOWERED_LABEL( x )		dispatch[ x ] = &&op_##x
+#define LOWERED_DISPATCH()		goto *dispatch[ in->op ]
+#define LOWERED_BEGIN
+#define LOWERED_END
+#else
+#define LOWERED_CASE( x )		case x:
+#define LOWERED_DISPATCH()		goto dispatch
+#define LOWERED_BEGIN			dispatch: switch( in->op ) {
+#define LOWERED_END				default: Error( "Bad lowered opcode %i", in->op ); return runaway; }
+#endif
+
+#define LOWERED_JUMP( target )	{ instructionPointer = ( target ); if ( --runaway <= 0 ) { Error( "runaway loop error" ); } in = &code[ instructionPointer ]; LOWERED_DISPATCH(); }
+#define LOWERED_NEXT()			LOWERED_JUMP( instructionPointer + 1 )
+
+// a compare and the if or ifnot on its result, counts as two statements
+#define LOWERED_COMPARE_BRANCH( x, compare, branchIf ) \
+	LOWERED_CASE( x ) { \
+		bool result = ( compare ); \
+		LOWERED_FLOAT( c ) = result; \
+		runaway--; \
+		if ( result == branchIf ) { \
+			LOWERED_JUMP( in->jump ); \
+		} \
+		instructionPointer++; \
+		LOWERED_NEXT(); \
+	}
+
+int idInterpreter::ExecuteLowered( int runaway ) {
+	const scriptInstruction_t	*code;
+	const scriptInstruction_t	*in;
+	byte						*bases[ 2 ];
+	varEval_t					*ptr;
+	idScriptObject				*obj;
+	float						floatVal;
+
+	assert( gameLocal.program.NumStatements() > instructionPointer );
+
+	code = gameLocal.program.GetInstructions();
+	bases[ 0 ] = gameLocal.program.GetVariables();
+	bases[ 1 ] = &localstack[ localstackBase ];
+
+#if defined( __GNUC__ )
+	static const void *dispatch[ NUM_SCRIPT_OPS ];
+
+	if ( !dispatch[ SOP_STATEMENT ] ) {
+		LOWERED_LABEL( SOP_GOTO );
+		LOWERED_LABEL( SOP_IF );
+		LOWERED_LABEL( SOP_IFNOT );
+		LOWERED_LABEL( SOP_ADD_F );
+		LOWERED_LABEL( SOP_ADD_V );
+		LOWERED_LABEL( SOP_SUB_F );
+		LOWERED_LABEL( SOP_SUB_V );
+		LOWERED_LABEL( SOP_MUL_F );
+		LOWERED_LABEL( SOP_MUL_V );
+		LOWERED_LABEL( SOP_MUL_FV );
+		LOWERED_LABEL( SOP_MUL_VF );
+		LOWERED_LABEL( SOP_DIV_F );
+		LOWERED_LABEL( SOP_MOD_F );
+		LOWERED_LABEL( SOP_BITAND );
+		LOWERED_LABEL( SOP_BITOR );
+		LOWERED_LABEL( SOP_GE );
+		LOWERED_LABEL( SOP_LE );
+		LOWERED_LABEL( SOP_GT );
+		LOWERED_LABEL( SOP_LT );
+		LOWERED_LABEL( SOP_EQ_F );
+		LOWERED_LABEL( SOP_NE_F );
+		LOWERED_LABEL( SOP_EQ_E );
+		LOWERED_LABEL( SOP_NE_E );
+		LOWERED_LABEL( SOP_EQ_V );
+		LOWERED_LABEL( SOP_NE_V );
+		LOWERED_LABEL( SOP_AND );
+		LOWERED_LABEL( SOP_AND_BOOLF );
+		LOWERED_LABEL( SOP_AND_FBOOL );
+		LOWERED_LABEL( SOP_AND_BOOLBOOL );
+		LOWERED_LABEL( SOP_OR );
+		LOWERED_LABEL( SOP_OR_BOOLF );
+		LOWERED_LABEL( SOP_OR_FBOOL );
+		LOWERED_LABEL( SOP_OR_BOOLBOOL );
+		LOWERED_LABEL( SOP_NOT_BOOL );
+		LOWERED_LABEL( SOP_NOT_F );
+		LOWERED_LABEL( SOP_NOT_V );
+		LOWERED_LABEL( SOP_NOT_ENT );
+		LOWERED_LABEL( SOP_NEG_F );
+		LOWERED_LABEL( SOP_NEG_V );
+		LOWERED_LABEL( SOP_INT_F );
+		LOWERED_LABEL( SOP_COMP_F );
+		LOWERED_LABEL( SOP_UADD_F );
+		LOWERED_LABEL( SOP_UADD_V );
+		LOWERED_LABEL( SOP_USUB_F );
+		LOWERED_LABEL( SOP_USUB_V );
+		LOWERED_LABEL( SOP_UMUL_F );
+		LOWERED_LABEL( SOP_UMUL_V );
+		LOWERED_LABEL( SOP_UOR_F );
+		LOWERED_LABEL( SOP_UAND_F );
+		LOWERED_LABEL( SOP_UINC_F );
+		LOWERED_LABEL( SOP_UDEC_F );
+		LOWERED_LABEL( SOP_UINCP_F );
+		LOWERED_LABEL( SOP_UDECP_F );
+		LOWERED_LABEL( SOP_STORE_INT );
+		LOWERED_LABEL( SOP_STORE_V );
+		LOWERED_LABEL( SOP_STORE_FTOBOOL );
+		LOWERED_LABEL( SOP_STORE_BOOLTOF );
+		LOWERED_LABEL( SOP_STOREP_INT );
+		LOWERED_LABEL( SOP_STOREP_V );
+		LOWERED_LABEL( SOP_STOREP_FTOBOOL );
+		LOWERED_LABEL( SOP_STOREP_BOOLTOF );
+		LOWERED_LABEL( SOP_ADDRESS );
+		LOWERED_LABEL( SOP_INDIRECT_INT );
+		LOWERED_LABEL( SOP_INDIRECT_V );
+		LOWERED_LABEL( SOP_PUSH_INT );
+		LOWERED_LABEL( SOP_PUSH_V );
+		LOWERED_LABEL( SOP_PUSH_BTOF );
+		LOWERED_LABEL( SOP_PUSH_FTOB );
+		LOWERED_LABEL( SOP_GE_IF );
+		LOWERED_LABEL( SOP_LE_IF );
+		LOWERED_LABEL( SOP_GT_IF );
+		LOWERED_LABEL( SOP_LT_IF );
+		LOWERED_LABEL( SOP_EQ_F_IF );
+		LOWERED_LABEL( SOP_NE_F_IF );
+		LOWERED_LABEL( SOP_EQ_E_IF );
+		LOWERED_LABEL( SOP_NE_E_IF );
+		LOWERED_LABEL( SOP_GE_IFNOT );
+		LOWERED_LABEL( SOP_LE_IFNOT );
+		LOWERED_LABEL( SOP_GT_IFNOT );
+		LOWERED_LABEL( SOP_LT_IFNOT );
+		LOWERED_LABEL( SOP_EQ_F_IFNOT );
+		LOWERED_LABEL( SOP_NE_F_IFNOT );
+		LOWERED_LABEL( SOP_EQ_E_IFNOT );
+		LOWERED_LABEL( SOP_NE_E_IFNOT );
+		for( int i = 1; i < NUM_SCRIPT_OPS; i++ ) {
+			if ( !dispatch[ i ] ) {
+				gameLocal.Error( "idInterpreter::ExecuteLowered: no code for lowered opcode %i", i );
+			}
+		}
+		// set last, it marks the table as complete
+		LOWERED_LABEL( SOP_STATEMENT );
+	}
+#endif
+
+	LOWERED_NEXT();
+
+	LOWERED_BEGIN
+
+	LOWERED_CASE( SOP_STATEMENT )
+		// Execute runs it from the statement and counts it again
+		instructionPointer--;
+		return runaway + 1;
+
+	LOWERED_CASE( SOP_GOTO )
+		LOWERED_JUMP( in->jump );
+
+	LOWERED_CASE( SOP_IF )
+		if ( LOWERED_INT( a ) != 0 ) {
+			LOWERED_JUMP( in->jump );
+		}
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_IFNOT )
+		if ( LOWERED_INT( a ) == 0 ) {
+			LOWERED_JUMP( in->jump );
+		}
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_ADD_F )
+		LOWERED_FLOAT( c ) = LOWERED_FLOAT( a ) + LOWERED_FLOAT( b );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_ADD_V )
+		LOWERED_VECTOR( c ) = LOWERED_VECTOR( a ) + LOWERED_VECTOR( b );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_SUB_F )
+		LOWERED_FLOAT( c ) = LOWERED_FLOAT( a ) - LOWERED_FLOAT( b );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_SUB_V )
+		LOWERED_VECTOR( c ) = LOWERED_VECTOR( a ) - LOWERED_VECTOR( b );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_MUL_F )
+		LOWERED_FLOAT( c ) = LOWERED_FLOAT( a ) * LOWERED_FLOAT( b );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_MUL_V )
+		LOWERED_FLOAT( c ) = LOWERED_VECTOR( a ) * LOWERED_VECTOR( b );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_MUL_FV )
+		LOWERED_VECTOR( c ) = LOWERED_FLOAT( a ) * LOWERED_VECTOR( b );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_MUL_VF )
+		LOWERED_VECTOR( c ) = LOWERED_VECTOR( a ) * LOWERED_FLOAT( b );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_DIV_F )
+		if ( LOWERED_FLOAT( b ) == 0.0f ) {
+			Warning( "Divide by zero" );
+			LOWERED_FLOAT( c ) = idMath::INFINITY;
+		} else {
+			LOWERED_FLOAT( c ) = LOWERED_FLOAT( a ) / LOWERED_FLOAT( b );
+		}
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_MOD_F )
+		if ( LOWERED_FLOAT( b ) == 0.0f ) {
+			Warning( "Divide by zero" );
+			LOWERED_FLOAT( c ) = LOWERED_FLOAT( a );
+		} else {
+			LOWERED_FLOAT( c ) = static_cast<int>( LOWERED_FLOAT( a ) ) % static_cast<int>( LOWERED_FLOAT( b ) );
+		}
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_BITAND )
+		LOWERED_FLOAT( c ) = static_cast<int>( LOWERED_FLOAT( a ) ) & static_cast<int>( LOWERED_FLOAT( b ) );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_BITOR )
+		LOWERED_FLOAT( c ) = static_cast<int>( LOWERED_FLOAT( a ) ) | static_cast<int>( LOWERED_FLOAT( b ) );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_GE )
+		LOWERED_FLOAT( c ) = ( LOWERED_FLOAT( a ) >= LOWERED_FLOAT( b ) );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_LE )
+		LOWERED_FLOAT( c ) = ( LOWERED_FLOAT( a ) <= LOWERED_FLOAT( b ) );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_GT )
+		LOWERED_FLOAT( c ) = ( LOWERED_FLOAT( a ) > LOWERED_FLOAT( b ) );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_LT )
+		LOWERED_FLOAT( c ) = ( LOWERED_FLOAT( a ) < LOWERED_FLOAT( b ) );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_EQ_F )
+		LOWERED_FLOAT( c ) = ( LOWERED_FLOAT( a ) == LOWERED_FLOAT( b ) );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_NE_F )
+		LOWERED_FLOAT( c ) = ( LOWERED_FLOAT( a ) != LOWERED_FLOAT( b ) );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_EQ_E )
+		LOWERED_FLOAT( c ) = ( LOWERED_INT( a ) == LOWERED_INT( b ) );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_NE_E )
+		LOWERED_FLOAT( c ) = ( LOWERED_INT( a ) != LOWERED_INT( b ) );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_EQ_V )
+		LOWERED_FLOAT( c ) = ( LOWERED_VECTOR( a ) == LOWERED_VECTOR( b ) );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_NE_V )
+		LOWERED_FLOAT( c ) = ( LOWERED_VECTOR( a ) != LOWERED_VECTOR( b ) );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_AND )
+		LOWERED_FLOAT( c ) = ( LOWERED_FLOAT( a ) != 0.0f ) && ( LOWERED_FLOAT( b ) != 0.0f );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_AND_BOOLF )
+		LOWERED_FLOAT( c ) = ( LOWERED_INT( a ) != 0 ) && ( LOWERED_FLOAT( b ) != 0.0f );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_AND_FBOOL )
+		LOWERED_FLOAT( c ) = ( LOWERED_FLOAT( a ) != 0.0f ) && ( LOWERED_INT( b ) != 0 );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_AND_BOOLBOOL )
+		LOWERED_FLOAT( c ) = ( LOWERED_INT( a ) != 0 ) && ( LOWERED_INT( b ) != 0 );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_OR )
+		LOWERED_FLOAT( c ) = ( LOWERED_FLOAT( a ) != 0.0f ) || ( LOWERED_FLOAT( b ) != 0.0f );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_OR_BOOLF )
+		LOWERED_FLOAT( c ) = ( LOWERED_INT( a ) != 0 ) || ( LOWERED_FLOAT( b ) != 0.0f );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_OR_FBOOL )
+		LOWERED_FLOAT( c ) = ( LOWERED_FLOAT( a ) != 0.0f ) || ( LOWERED_INT( b ) != 0 );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_OR_BOOLBOOL )
+		LOWERED_FLOAT( c ) = ( LOWERED_INT( a ) != 0 ) || ( LOWERED_INT( b ) != 0 );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_NOT_BOOL )
+		LOWERED_FLOAT( c ) = ( LOWERED_INT( a ) == 0 );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_NOT_F )
+		LOWERED_FLOAT( c ) = ( LOWERED_FLOAT( a ) == 0.0f );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_NOT_V )
+		LOWERED_FLOAT( c ) = ( LOWERED_VECTOR( a ) == vec3_zero );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_NOT_ENT )
+		LOWERED_FLOAT( c ) = ( GetEntity( LOWERED_INT( a ) ) == NULL );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_NEG_F )
+		LOWERED_FLOAT( c ) = -LOWERED_FLOAT( a );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_NEG_V )
+		LOWERED_VECTOR( c ) = -LOWERED_VECTOR( a );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_INT_F )
+		LOWERED_FLOAT( c ) = static_cast<int>( LOWERED_FLOAT( a ) );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_COMP_F )
+		LOWERED_FLOAT( c ) = ~static_cast<int>( LOWERED_FLOAT( a ) );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_UADD_F )
+		LOWERED_FLOAT( b ) += LOWERED_FLOAT( a );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_UADD_V )
+		LOWERED_VECTOR( b ) += LOWERED_VECTOR( a );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_USUB_F )
+		LOWERED_FLOAT( b ) -= LOWERED_FLOAT( a );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_USUB_V )
+		LOWERED_VECTOR( b ) -= LOWERED_VECTOR( a );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_UMUL_F )
+		LOWERED_FLOAT( b ) *= LOWERED_FLOAT( a );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_UMUL_V )
+		LOWERED_VECTOR( b ) *= LOWERED_FLOAT( a );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_UOR_F )
+		LOWERED_FLOAT( b ) = static_cast<int>( LOWERED_FLOAT( b ) ) | static_cast<int>( LOWERED_FLOAT( a ) );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_UAND_F )
+		LOWERED_FLOAT( b ) = static_cast<int>( LOWERED_FLOAT( b ) ) & static_cast<int>( LOWERED_FLOAT( a ) );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_UINC_F )
+		LOWERED_FLOAT( a )++;
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_UDEC_F )
+		LOWERED_FLOAT( a )--;
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_UINCP_F )
+		obj = GetScriptObject( LOWERED_INT( a ) );
+		if ( obj ) {
+			LOWERED_FIELD( float )++;
+		}
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_UDECP_F )
+		obj = GetScriptObject( LOWERED_INT( a ) );
+		if ( obj ) {
+			LOWERED_FIELD( float )--;
+		}
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_STORE_INT )
+		LOWERED_INT( b ) = LOWERED_INT( a );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_STORE_V )
+		LOWERED_VECTOR( b ) = LOWERED_VECTOR( a );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_STORE_FTOBOOL )
+		LOWERED_INT( b ) = ( LOWERED_FLOAT( a ) != 0.0f ) ? 1 : 0;
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_STORE_BOOLTOF )
+		LOWERED_FLOAT( b ) = static_cast<float>( LOWERED_INT( a ) );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_STOREP_INT )
+		ptr = LOWERED_POINTER( b );
+		if ( ptr->intPtr ) {
+			*ptr->intPtr = LOWERED_INT( a );
+		}
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_STOREP_V )
+		ptr = LOWERED_POINTER( b );
+		if ( ptr->vectorPtr ) {
+			*ptr->vectorPtr = LOWERED_VECTOR( a );
+		}
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_STOREP_FTOBOOL )
+		ptr = LOWERED_POINTER( b );
+		if ( ptr->intPtr ) {
+			*ptr->intPtr = ( LOWERED_FLOAT( a ) != 0.0f ) ? 1 : 0;
+		}
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_STOREP_BOOLTOF )
+		ptr = LOWERED_POINTER( b );
+		if ( ptr->floatPtr ) {
+			*ptr->floatPtr = static_cast<float>( LOWERED_INT( a ) );
+		}
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_ADDRESS )
+		obj = GetScriptObject( LOWERED_INT( a ) );
+		LOWERED_POINTER( c )->bytePtr = obj ? &obj->data[ in->b ] : NULL;
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_INDIRECT_INT )
+		obj = GetScriptObject( LOWERED_INT( a ) );
+		LOWERED_INT( c ) = obj ? LOWERED_FIELD( int ) : 0;
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_INDIRECT_V )
+		obj = GetScriptObject( LOWERED_INT( a ) );
+		if ( obj ) {
+			LOWERED_VECTOR( c ) = LOWERED_FIELD( idVec3 );
+		} else {
+			LOWERED_VECTOR( c ).Zero();
+		}
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_PUSH_INT )
+		Push( LOWERED_INT( a ) );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_PUSH_V )
+		PushVector( LOWERED_VECTOR( a ) );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_PUSH_BTOF )
+		floatVal = LOWERED_INT( a );
+		Push( *reinterpret_cast<int *>( &floatVal ) );
+		LOWERED_NEXT();
+
+	LOWERED_CASE( SOP_PUSH_FTOB )
+		Push( ( LOWERED_FLOAT( a ) != 0.0f ) ? 1 : 0 );
+		LOWERED_NEXT();
+
+	LOWERED_COMPARE_BRANCH( SOP_GE_IF,		LOWERED_FLOAT( a ) >= LOWERED_FLOAT( b ),	true )
+	LOWERED_COMPARE_BRANCH( SOP_LE_IF,		LOWERED_FLOAT( a ) <= LOWERED_FLOAT( b ),	true )
+	LOWERED_COMPARE_BRANCH( SOP_GT_IF,		LOWERED_FLOAT( a ) > LOWERED_FLOAT( b ),	true )
+	LOWERED_COMPARE_BRANCH( SOP_LT_IF,		LOWERED_FLOAT( a ) < LOWERED_FLOAT( b ),	true )
+	LOWERED_COMPARE_BRANCH( SOP_EQ_F_IF,	LOWERED_FLOAT( a ) == LOWERED_FLOAT( b ),	true )
+	LOWERED_COMPARE_BRANCH( SOP_NE_F_IF,	LOWERED_FLOAT( a ) != LOWERED_FLOAT( b ),	true )
+	LOWERED_COMPARE_BRANCH( SOP_EQ_E_IF,	LOWERED_INT( a ) == LOWERED_INT( b ),		true )
+	LOWERED_COMPARE_BRANCH( SOP_NE_E_IF,	LOWERED_INT( a ) != LOWERED_INT( b ),		true )
+	LOWERED_COMPARE_BRANCH( SOP_GE_IFNOT,	LOWERED_FLOAT( a ) >= LOWERED_FLOAT( b ),	false )
+	LOWERED_COMPARE_BRANCH( SOP_LE_IFNOT,	LOWERED_FLOAT( a ) <= LOWERED_FLOAT( b ),	false )
+	LOWERED_COMPARE_BRANCH( SOP_GT_IFNOT,	LOWERED_FLOAT( a ) > LOWERED_FLOAT( b ),	false )
+	LOWERED_COMPARE_BRANCH( SOP_LT_IFNOT,	LOWERED_FLOAT( a ) < LOWERED_FLOAT( b ),	false )
+	LOWERED_COMPARE_BRANCH( SOP_EQ_F_IFNOT,	LOWERED_FLOAT( a ) == LOWERED_FLOAT( b ),	false )
+	LOWERED_COMPARE_BRANCH( SOP_NE_F_IFNOT,	LOWERED_FLOAT( a ) != LOWERED_FLOAT( b ),	false )
+	LOWERED_COMPARE_BRANCH( SOP_EQ_E_IFNOT,	LOWERED_INT( a ) == LOWERED_INT( b ),		false )
+	LOWERED_COMPARE_BRANCH( SOP_NE_E_IFNOT,	LOWERED_INT( a ) != LOWERED_INT( b ),		false )
+
+	LOWERED_END
+
+	return runaway;
+}
+
+#undef LOWERED_ADDRESS
+#undef LOWERED_FLOAT
+#undef LOWERED_INT
+#undef LOWERED_VECTOR
+#undef LOWERED_POINTER
+#undef LOWERED_FIELD
+#undef LOWERED_CASE
+#undef LOWERED_LABEL
+#undef LOWERED_DISPATCH
+#undef LOWERED_BEGIN
+#undef LOWERED_END
+#undef LOWERED_JUMP
+#undef LOWERED_NEXT
+#undef LOWERED_COMPARE_BRANCH
+
 /*
 ====================
 idInterpreter::Execute
@@ -984,6 +1518,12 @@ bool idInterpreter::Execute( void ) {
 	float		floatVal;
 	idScriptObject *obj;
 	const function_t *func;
+	bool		lowered;
+	bool		debugging;
+	bool		profiling;
+	const function_t *profiledFunction;
+	const function_t *outerFunction;
+	int			profiledRunaway;
 
 	if ( threadDying || !currentFunction ) {
 		return true;
@@ -995,20 +1535,27 @@ bool idInterpreter::Execute( void ) {
 	}
 
 	runaway = 5000000;
+	lowered = g_scriptFastDispatch.GetBool() && !g_debugScript.GetBool();
+
+	// the profiled function only changes in the switch, the lowered instructions never call
+	profiling = gameLocal.scriptProfiler.IsActive();
+	profiledFunction = currentFunction;
+	profiledRunaway = runaway;
+	outerFunction = profiling ? gameLocal.scriptProfiler.SwitchFunction( currentFunction ) : NULL;
 
 	doneProcessing = false;
 	while( !doneProcessing && !threadDying ) {
 		instructionPointer++;
 
-		if ( !--runaway ) {
+		if ( --runaway <= 0 ) {
 			Error( "runaway loop error" );
 		}
 
 		// next statement
 		st = &gameLocal.program.GetStatement( instructionPointer );
 
-		if ( !updateGameDebugger( this, &gameLocal.program, instructionPointer )
-			&& g_debugScript.GetBool( ) ) 
+		debugging = updateGameDebugger( this, &gameLocal.program, instructionPointer );
+		if ( !debugging && g_debugScript.GetBool( ) ) 
 		{
 			static int lastLineNumber = -1;
 			if (lastLineNumber != gameLocal.program.GetStatement(instructionPointer).linenumber) {
@@ -1880,8 +2427,28 @@ bool idInterpreter::Execute( void ) {
 			Error( "Bad opcode %i", st->op );
 			break;
 		}
+
+		if ( profiling && currentFunction != profiledFunction ) {
+			gameLocal.scriptProfiler.AddInstructions( profiledFunction, profiledRunaway - runaway );
+			gameLocal.scriptProfiler.SwitchFunction( currentFunction );
+			profiledFunction = currentFunction;
+			profiledRunaway = runaway;
+		}
+
+		// run the lowered instructions up to the next one that needs the switch,
+		// the debugger has to see every statement so it always uses the switch
+		if ( lowered && !debugging && !doneProcessing && !threadDying ) {
+			runaway = ExecuteLowered( runaway );
+		}
 	}
 
+	if ( profiling ) {
+		gameLocal.scriptProfiler.AddInstructions( profiledFunction, profiledRunaway - runaway );
+		gameLocal.scriptProfiler.SwitchFunction( outerFunction );
+	}
+
+	instructionsExecuted = 5000000 - runaway;
+
 	return threadDying;
 }
 
@@ -108,6 +108,8 @@ Contains type information for variables and functions.
 ***********************************************************************/
 
 class idTypeDef {
+	friend class idProgram;		// fills in the types of program images
+
 private:
 	etype_t						type;
 	idStr						name;
@@ -449,6 +451,166 @@ typedef struct statement_s {
 
 /***********************************************************************
 
+Lowered statements
+
+After compiling, idProgram::LowerStatements turns every statement into a
+scriptInstruction_t with the operand addresses resolved, so the dispatch
+loop of idInterpreter doesn't have to go through the idVarDefs.  There is
+one instruction for every statement, so jumps, the call stack and the
+debugger keep using statement numbers.  Statements that call functions or
+events, use strings or need the type info are left as SOP_STATEMENT and
+are executed from the statement.
+
+***********************************************************************/
+
+typedef enum {
+	SOP_STATEMENT,
+
+	SOP_GOTO,
+	SOP_IF,
+	SOP_IFNOT,
+
+	SOP_ADD_F,
+	SOP_ADD_V,
+	SOP_SUB_F,
+	SOP_SUB_V,
+	SOP_MUL_F,
+	SOP_MUL_V,
+	SOP_MUL_FV,
+	SOP_MUL_VF,
+	SOP_DIV_F,
+	SOP_MOD_F,
+	SOP_BITAND,
+	SOP_BITOR,
+
+	SOP_GE,
+	SOP_LE,
+	SOP_GT,
+	SOP_LT,
+	SOP_EQ_F,
+	SOP_NE_F,
+	SOP_EQ_E,
+	SOP_NE_E,
+	SOP_EQ_V,
+	SOP_NE_V,
+
+	SOP_AND,
+	SOP_AND_BOOLF,
+	SOP_AND_FBOOL,
+	SOP_AND_BOOLBOOL,
+	SOP_OR,
+	SOP_OR_BOOLF,
+	SOP_OR_FBOOL,
+	SOP_OR_BOOLBOOL,
+
+	SOP_NOT_BOOL,
+	SOP_NOT_F,
+	SOP_NOT_V,
+	SOP_NOT_ENT,
+	SOP_NEG_F,
+	SOP_NEG_V,
+	SOP_INT_F,
+	SOP_COMP_F,
+
+	SOP_UADD_F,
+	SOP_UADD_V,
+	SOP_USUB_F,
+	SOP_USUB_V,
+	SOP_UMUL_F,
+	SOP_UMUL_V,
+	SOP_UOR_F,
+	SOP_UAND_F,
+	SOP_UINC_F,
+	SOP_UDEC_F,
+	SOP_UINCP_F,
+	SOP_UDECP_F,
+
+	SOP_STORE_INT,			// floats, booleans, entities and objects
+	SOP_STORE_V,
+	SOP_STORE_FTOBOOL,
+	SOP_STORE_BOOLTOF,
+	SOP_STOREP_INT,
+	SOP_STOREP_V,
+	SOP_STOREP_FTOBOOL,
+	SOP_STOREP_BOOLTOF,
+
+	SOP_ADDRESS,
+	SOP_INDIRECT_INT,
+	SOP_INDIRECT_V,
+
+	SOP_PUSH_INT,
+	SOP_PUSH_V,
+	SOP_PUSH_BTOF,
+	SOP_PUSH_FTOB,
+
+	// a compare followed by an if or ifnot of its result, in the order of SOP_GE to SOP_NE_E
+	SOP_GE_IF,
+	SOP_LE_IF,
+	SOP_GT_IF,
+	SOP_LT_IF,
+	SOP_EQ_F_IF,
+	SOP_NE_F_IF,
+	SOP_EQ_E_IF,
+	SOP_NE_E_IF,
+	SOP_GE_IFNOT,
+	SOP_LE_IFNOT,
+	SOP_GT_IFNOT,
+	SOP_LT_IFNOT,
+	SOP_EQ_F_IFNOT,
+	SOP_NE_F_IFNOT,
+	SOP_EQ_E_IFNOT,
+	SOP_NE_E_IFNOT,
+
+	NUM_SCRIPT_OPS
+} scriptOp_t;
+
+// operands are ( offset << 1 ) into the globals, or ( offset << 1 ) | SCRIPT_OPERAND_LOCAL into the locals of the function
+#define SCRIPT_OPERAND_LOCAL	1
+
+typedef struct scriptInstruction_s {
+	int				op;				// scriptOp_t
+	int				a;
+	int				b;				// object field offset for field operations
+	int				c;
+	int				jump;			// statement number of a branch
+} scriptInstruction_t;
+
+/***********************************************************************
+
+Program images
+
+idProgram::CompileFile writes what the compile of a script file added to
+the program to a binary program image next to the script, so the next
+compile of the same file on top of the same program can load it instead
+(script/doom_main.script -> script/doom_main.scriptb).  The image is keyed
+by the content hashes of the script and every file it includes, and by a
+key of the program it was compiled on top of.  Everything refers to
+everything else by index.
+
+***********************************************************************/
+
+// the state of the program before a file is compiled
+typedef struct scriptImageBase_s {
+	unsigned int	programKey;
+	int				numFiles;
+	int				numTypes;
+	int				numDefs;
+	int				numFunctions;
+	int				numStatements;
+	int				numVariables;
+	const idVarDef	*lastDef;		// to notice base defs being freed
+} scriptImageBase_t;
+
+// a file read by the compile of a program image
+typedef struct scriptImageFile_s {
+	idStr			name;
+	int				length;
+	unsigned int	crc;
+	unsigned int	md5;
+} scriptImageFile_t;
+
+/***********************************************************************
+
 idProgram
 
 Handles compiling and storage of script data.  Multiple idProgram objects
@@ -469,6 +631,7 @@ private:
 	idStaticList<byte,MAX_GLOBALS>				variableDefaults;
 	idStaticList<function_t,MAX_FUNCS>			functions;
 	idStaticList<statement_t,MAX_STATEMENTS>	statements;
+	idList<scriptInstruction_t>					instructions;		// lowered statements
 	idList<idTypeDef *>							types;
 	idList<idVarDefName *>						varDefNames;
 	idHashIndex									varDefNameHash;
@@ -482,7 +645,20 @@ private:
 	int											top_defs;
 	int											top_files;
 
+	unsigned int								programKey;			// identifies the compiled files and their order, 0 if the program can't be cached
+	unsigned int								top_programKey;
+	idStrList									includedFiles;		// files included by the last CompileText
+
 	void										CompileStats( void );
+	bool										LowerOperand( const idVarDef *def, int &operand ) const;
+	void										LowerStatement( int index, scriptInstruction_t &in ) const;
+	void										LowerStatements( bool lower );
+	static unsigned int							StartProgramKey( void );
+	void										GetImageBase( scriptImageBase_t &base ) const;
+	void										FreeImageData( const scriptImageBase_t &base );
+	bool										LoadImage( const char *filename, const char *text, int length );
+	bool										ReadImage( idFile *f, const char *filename, const char *text, int length, const scriptImageBase_t &base, idList<scriptImageFile_t> &files );
+	void										WriteImage( const char *filename, const char *text, int length, const scriptImageBase_t &base );
 	byte										*ReserveMem(int size);
 	idVarDef									*AllocVarDef(idTypeDef *type, const char *name, idVarDef *scope);
 
@@ -538,6 +714,8 @@ public:
 	statement_t									*AllocStatement( void );
 	statement_t									&GetStatement( int index );
 	int											NumStatements( void ) { return statements.Num(); }
+	const scriptInstruction_t					*GetInstructions( void ) const { return instructions.Ptr(); }
+	byte										*GetVariables( void ) { return variables; }
 
 	int											GetReturnedInteger( void );
 
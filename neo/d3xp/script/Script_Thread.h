@@ -219,6 +219,7 @@ public:
 
 	void						EnableDebugInfo( void ) { interpreter.debug = true; };
 	void						DisableDebugInfo( void ) { interpreter.debug = false; };
+	int							GetInstructionsExecuted( void ) const { return interpreter.instructionsExecuted; };
 
 	void						WaitMS( int time );
 	void						WaitSec( float time );
@@ -129,4 +129,4 @@ dhewm WIP		42
 
 // threads
 
-#define MAX_THREADS				(10)
+#define MAX_THREADS				(10 + 32)	// + MAX_JOB_THREADS from sys/sys_jobs.h
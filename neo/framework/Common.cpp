@@ -32,6 +32,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "idlib/containers/HashTable.h"
 #include "idlib/LangDict.h"
 #include "idlib/MapFile.h"
+#include "idlib/Profiler.h"
 #include "cm/CollisionModel.h"
 #include "framework/async/AsyncNetwork.h"
 #include "framework/async/NetworkSystem.h"
@@ -51,6 +52,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "tools/edit_public.h"
 
 #include "sys/sys_imgui.h"
+#include "sys/sys_jobs.h"
 
 #include "framework/Common.h"
 
@@ -60,6 +62,9 @@ If you have questions concerning this license or the applicable additional terms
 #define	MAX_PRINT_MSG_SIZE	4096
 #define MAX_WARNING_LIST	256
 
+// guards the prints and warnings of job threads
+const int CRITICAL_SECTION_PRINT = CRITICAL_SECTION_THREE;
+
 // DG: implemented in Dhewm3SettingsMenu.cpp (the only Com_*_f() function not implemented in this file)
 extern void Com_Dhewm3Settings_f( const idCmdArgs &args );
 
@@ -203,6 +208,7 @@ public:
 
 private:
 	void						InitCommands( void );
+	void						FlushThreadPrints( void );
 	void						InitRenderSystem( void );
 	void						InitSIMD( void );
 	bool						AddStartupCommands( void );
@@ -232,6 +238,7 @@ private:
 	idStr						warningCaption;
 	idStrList					warningList;
 	idStrList					errorList;
+	idStrList					threadPrints;		// prints of job threads that still have to go to the console
 
 	uintptr_t					gameDLL;
 
@@ -360,6 +367,19 @@ void idCommonLocal::VPrintf( const char *fmt, va_list args ) {
 		return;
 	}
 
+	// the console, the log and the redirect buffer are only touched by the main thread,
+	// prints of job threads are queued and printed with the next print of the main thread
+	if ( !Sys_IsMainThread() ) {
+		idStr::vsnPrintf( msg, sizeof( msg ), fmt, args );
+		msg[sizeof(msg)-1] = '\0';
+		Sys_EnterCriticalSection( CRITICAL_SECTION_PRINT );
+		threadPrints.Append( msg );
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_PRINT );
+		return;
+	}
+
+	FlushThreadPrints();
+
 	// optionally put a timestamp at the beginning of each print,
 	// so we can see how long different init sections are taking
 	if ( com_timestampPrints.GetInteger() ) {
@@ -444,6 +464,25 @@ void idCommonLocal::VPrintf( const char *fmt, va_list args ) {
 #endif
 }
 
+/*
+==================
+idCommonLocal::FlushThreadPrints
+
+prints the messages queued by job threads
+==================
+*/
+void idCommonLocal::FlushThreadPrints( void ) {
+	idStrList prints;
+
+	Sys_EnterCriticalSection( CRITICAL_SECTION_PRINT );
+	prints.Swap( threadPrints );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_PRINT );
+
+	for ( int i = 0; i < prints.Num(); i++ ) {
+		Printf( "%s", prints[i].c_str() );
+	}
+}
+
 /*
 ==================
 idCommonLocal::Printf
@@ -530,9 +569,11 @@ void idCommonLocal::Warning( const char *fmt, ... ) {
 
 	Printf( S_COLOR_YELLOW "WARNING: " S_COLOR_RED "%s\n", msg );
 
+	Sys_EnterCriticalSection( CRITICAL_SECTION_PRINT );
 	if ( warningList.Num() < MAX_WARNING_LIST ) {
 		warningList.AddUnique( msg );
 	}
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_PRINT );
 }
 
 /*
@@ -2351,6 +2392,8 @@ void idCommonLocal::InitCommands( void ) {
 	cmdSystem->AddCommand( "listDictKeys", idDict::ListKeys_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "lists all keys used by dictionaries" );
 	cmdSystem->AddCommand( "listDictValues", idDict::ListValues_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "lists all values used by dictionaries" );
 	cmdSystem->AddCommand( "testSIMD", idSIMD::Test_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "test SIMD code" );
+	cmdSystem->AddCommand( "testCollisionThreads", idCollisionModelManager::TestThreads_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "compare collision traces run in parallel jobs against single threaded results" );
+	cmdSystem->AddCommand( "benchCollision", idCollisionModelManager::BenchTraces_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "measure collision trace throughput and check traces against golden results" );
 
 	// localization
 	cmdSystem->AddCommand( "localizeGuis", Com_LocalizeGuis_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "localize guis" );
@@ -2417,6 +2460,11 @@ idCommonLocal::Frame
 */
 void idCommonLocal::Frame( void ) {
 	try {
+		profiler->BeginFrame();
+		PROFILE_ZONE( "idCommon::Frame" );
+
+		// print what the job threads printed since the last frame
+		FlushThreadPrints();
 
 		// pump all the events
 		Sys_GenerateEvents();
@@ -2424,6 +2472,9 @@ void idCommonLocal::Frame( void ) {
 		// write config file if anything changed
 		WriteConfiguration();
 
+		// restart the job workers if sys_jobThreads changed
+		parallelJobManager->UpdateWorkerThreads();
+
 		// change SIMD implementation if required
 		if ( com_forceGenericSIMD.IsModified() ) {
 			InitSIMD();
@@ -2529,6 +2580,8 @@ int prevAsyncMsec;
 int	lastTicMsec;
 
 void idCommonLocal::SingleAsyncTic( void ) {
+	PROFILE_ZONE( "idCommon::SingleAsyncTic" );
+
 	// main thread code can prevent this from happening while modifying
 	// critical data structures
 	Sys_EnterCriticalSection();
@@ -2708,6 +2761,8 @@ void idCommonLocal::LoadGameDLL( void ) {
 	gameImport.declManager				= ::declManager;
 	gameImport.AASFileManager			= ::AASFileManager;
 	gameImport.collisionModelManager	= ::collisionModelManager;
+	gameImport.parallelJobManager		= ::parallelJobManager;
+	gameImport.profiler					= ::profiler;
 
 	gameExport							= *GetGameAPI( &gameImport);
 
@@ -2752,6 +2807,9 @@ void idCommonLocal::UnloadGameDLL( void ) {
 
 #endif
 
+	// the recorded zone names may point into the unloaded library
+	profiler->Clear();
+
 	com_debuggerSupported = false; // HvG: Reset debugger availability.
 	gameCallbacks.Reset(); // DG: these callbacks are invalid now because DLL has been unloaded
 }
@@ -2923,7 +2981,7 @@ void idCommonLocal::Init( int argc, char **argv ) {
 		exit(1);
 	}
 
-#ifdef ID_DEDICATED
+#if defined(ID_DEDICATED) || defined(ID_HEADLESS)
 	// we want to use the SDL event queue for dedicated servers. That
 	// requires video to be initialized, so we just use the dummy
 	// driver for headless boxen
@@ -2970,6 +3028,7 @@ void idCommonLocal::Init( int argc, char **argv ) {
 		idLib::common		= common;
 		idLib::cvarSystem	= cvarSystem;
 		idLib::fileSystem	= fileSystem;
+		idLib::profiler		= profiler;
 
 		// initialize idLib
 		idLib::Init();
@@ -3027,6 +3086,12 @@ void idCommonLocal::Init( int argc, char **argv ) {
 		// initialize processor specific SIMD implementation
 		InitSIMD();
 
+		// start the job worker threads
+		parallelJobManager->Init();
+
+		// the profiler records zones of all threads from now on
+		profiler->Init();
+
 		// init commands
 		InitCommands();
 
@@ -3096,6 +3161,11 @@ void idCommonLocal::Shutdown( void ) {
 	// game specific shut down
 	ShutdownGame( false );
 
+	// stop the job worker threads
+	parallelJobManager->Shutdown();
+
+	profiler->Shutdown();
+
 	// shut down non-portable system services
 	Sys_Shutdown();
 
@@ -3200,6 +3270,9 @@ void idCommonLocal::InitGame( void ) {
 	// re-override anything from the config files with command line args
 	StartupVariable( NULL, false );
 
+	// the job workers were started before sys_jobThreads was read from the configs
+	parallelJobManager->UpdateWorkerThreads();
+
 	// if any archived cvars are modified after this, we will trigger a writing of the config file
 	cvarSystem->ClearModifiedFlags( CVAR_ARCHIVE );
 
@@ -0,0 +1,462 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include <SDL_mutex.h>
+#include <SDL_atomic.h>
+#include <SDL_version.h>
+
+#include "sys/platform.h"
+#include "idlib/Str.h"
+#include "idlib/Profiler.h"
+#include "framework/Licensee.h"
+#include "framework/Common.h"
+#include "framework/CmdSystem.h"
+#include "framework/CVarSystem.h"
+#include "framework/FileSystem.h"
+
+#include "sys/sys_public.h"
+
+idCVar com_profile( "com_profile", "0", CVAR_SYSTEM | CVAR_BOOL | CVAR_NOCHEAT, "record the profile zones of all threads, see profileDump" );
+idCVar com_profileSpikeMsec( "com_profileSpikeMsec", "0", CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "while recording, write the slow frame and the one before it to profiles/spike_<frame>.json when a frame takes longer than this, 0 = off", 0, 10000 );
+
+#ifdef _MSC_VER
+#define PROFILE_THREAD_LOCAL	__declspec( thread )
+#else
+#define PROFILE_THREAD_LOCAL	__thread
+#endif
+
+const int PROFILE_MAX_THREADS		= 64;
+const int PROFILE_MAX_DEPTH			= 64;
+const int PROFILE_MAX_ZONES			= 1 << 15;		// per thread, power of two
+const int PROFILE_MAX_FRAMES		= 256;			// power of two
+const int PROFILE_SPIKE_FRAMES		= 2;
+const int PROFILE_DRAIN_MSEC		= 100;			// how long WriteTrace waits for the other threads to leave their zones
+
+// the zone must be in the buffer before the thread counts it as written or left
+#if SDL_VERSION_ATLEAST(2, 0, 6)
+#define PROFILE_WRITE_BARRIER()		SDL_MemoryBarrierRelease()
+#define PROFILE_READ_BARRIER()		SDL_MemoryBarrierAcquire()
+#else
+#define PROFILE_WRITE_BARRIER()
+#define PROFILE_READ_BARRIER()
+#endif
+
+typedef struct {
+	const char *		name;
+	double				start;
+	double				end;
+} profileZone_t;
+
+typedef struct {
+	idStr				name;
+	profileZone_t *		zones;						// ring buffer of the zones that were left
+	volatile int		numZones;					// zones written since the last Clear()
+	const char *		stackNames[PROFILE_MAX_DEPTH];
+	double				stackStarts[PROFILE_MAX_DEPTH];
+	volatile int		depth;						// zones entered and not left yet
+} profileThread_t;
+
+/*
+===============================================================================
+
+	idProfilerLocal
+
+===============================================================================
+*/
+
+class idProfilerLocal : public idProfiler {
+public:
+							idProfilerLocal( void );
+
+	virtual void			Init( void );
+	virtual void			Shutdown( void );
+
+	virtual void			BeginFrame( void );
+	virtual void			Clear( void );
+
+	virtual void			BeginZone( const char *name );
+	virtual void			EndZone( void );
+
+private:
+	SDL_mutex *				mutex;
+	profileThread_t *		threads[PROFILE_MAX_THREADS];
+	int						numThreads;
+
+	double					frameStarts[PROFILE_MAX_FRAMES];
+	int						numFrames;
+
+	profileThread_t *		GetThread( void );
+	void					StopRecording( void );
+	bool					WriteTrace( const char *fileName, int traceFrames );
+
+	static void				ProfileDump_f( const idCmdArgs &args );
+};
+
+static PROFILE_THREAD_LOCAL profileThread_t *	currentThread = NULL;
+static PROFILE_THREAD_LOCAL bool				currentThreadFailed = false;
+
+idProfilerLocal				profilerLocal;
+idProfiler *				profiler = &profilerLocal;
+
+/*
+================
+idProfilerLocal::idProfilerLocal
+================
+*/
+idProfilerLocal::idProfilerLocal( void ) {
+	recording = false;
+	mutex = NULL;
+	memset( threads, 0, sizeof( threads ) );
+	numThreads = 0;
+	numFrames = 0;
+}
+
+/*
+================
+idProfilerLocal::Init
+================
+*/
+void idProfilerLocal::Init( void ) {
+	mutex = SDL_CreateMutex();
+
+	cmdSystem->AddCommand( "profileDump", ProfileDump_f, CMD_FL_SYSTEM, "writes the last recorded frames as Chrome trace JSON, usage: profileDump [numFrames] [fileName]" );
+}
+
+/*
+================
+idProfilerLocal::Shutdown
+================
+*/
+void idProfilerLocal::Shutdown( void ) {
+	recording = false;
+
+	for ( int i = 0; i < numThreads; i++ ) {
+		delete[] threads[i]->zones;
+		delete threads[i];
+		threads[i] = NULL;
+	}
+	numThreads = 0;
+	numFrames = 0;
+
+	if ( mutex ) {
+		SDL_DestroyMutex( mutex );
+		mutex = NULL;
+	}
+}
+
+/*
+================
+idProfilerLocal::BeginFrame
+================
+*/
+void idProfilerLocal::BeginFrame( void ) {
+	if ( com_profile.GetBool() != recording ) {
+		if ( !recording ) {
+			Clear();
+		}
+		recording = com_profile.GetBool();
+	}
+
+	if ( !recording ) {
+		return;
+	}
+
+	double now = Sys_MillisecondsPrecise();
+	frameStarts[numFrames & ( PROFILE_MAX_FRAMES - 1 )] = now;
+	numFrames++;
+
+	if ( com_profileSpikeMsec.GetInteger() > 0 && numFrames > PROFILE_SPIKE_FRAMES ) {
+		double frameMsec = now - frameStarts[( numFrames - 2 ) & ( PROFILE_MAX_FRAMES - 1 )];
+		if ( frameMsec > com_profileSpikeMsec.GetInteger() ) {
+			common->Printf( "frame %d took %1.1f msec\n", idLib::frameNumber - 1, frameMsec );
+			WriteTrace( va( "profiles/spike_%05d.json", idLib::frameNumber - 1 ), PROFILE_SPIKE_FRAMES );
+			// don't count writing the file against this frame, that would make it a spike, too
+			frameStarts[( numFrames - 1 ) & ( PROFILE_MAX_FRAMES - 1 )] = Sys_MillisecondsPrecise();
+		}
+	}
+}
+
+/*
+================
+idProfilerLocal::Clear
+================
+*/
+void idProfilerLocal::Clear( void ) {
+	for ( int i = 0; i < numThreads; i++ ) {
+		threads[i]->numZones = 0;
+	}
+	numFrames = 0;
+}
+
+/*
+================
+idProfilerLocal::GetThread
+
+the buffers of a thread are allocated when it enters its first zone
+================
+*/
+profileThread_t *idProfilerLocal::GetThread( void ) {
+	if ( currentThread != NULL || currentThreadFailed ) {
+		return currentThread;
+	}
+
+	SDL_LockMutex( mutex );
+
+	if ( numThreads < PROFILE_MAX_THREADS ) {
+		profileThread_t *thread = new profileThread_t;
+		thread->zones = new profileZone_t[PROFILE_MAX_ZONES];
+		thread->numZones = 0;
+		thread->depth = 0;
+		if ( Sys_IsMainThread() ) {
+			thread->name = "main";
+		} else {
+			int index;
+			thread->name = Sys_GetThreadName( &index );
+			if ( index < 0 ) {
+				// not started with Sys_CreateThread()
+				sprintf( thread->name, "thread %d", numThreads );
+			}
+		}
+		threads[numThreads++] = thread;
+		currentThread = thread;
+	} else {
+		currentThreadFailed = true;
+	}
+
+	SDL_UnlockMutex( mutex );
+
+	return currentThread;
+}
+
+/*
+================
+idProfilerLocal::BeginZone
+================
+*/
+void idProfilerLocal::BeginZone( const char *name ) {
+	profileThread_t *thread = GetThread();
+	if ( thread == NULL ) {
+		return;
+	}
+
+	// zones nested too deep are left out, but still counted so EndZone() stays balanced
+	if ( thread->depth < PROFILE_MAX_DEPTH ) {
+		thread->stackNames[thread->depth] = name;
+		thread->stackStarts[thread->depth] = Sys_MillisecondsPrecise();
+	}
+	thread->depth++;
+}
+
+/*
+================
+idProfilerLocal::EndZone
+================
+*/
+void idProfilerLocal::EndZone( void ) {
+	profileThread_t *thread = currentThread;
+	if ( thread == NULL || thread->depth <= 0 ) {
+		return;
+	}
+
+	int depth = thread->depth - 1;
+	if ( depth < PROFILE_MAX_DEPTH ) {
+		profileZone_t &zone = thread->zones[thread->numZones & ( PROFILE_MAX_ZONES - 1 )];
+		zone.name = thread->stackNames[depth];
+		zone.start = thread->stackStarts[depth];
+		zone.end = Sys_MillisecondsPrecise();
+		PROFILE_WRITE_BARRIER();
+		thread->numZones++;
+	}
+
+	// only leave the zone once it's written, so StopRecording knows when the thread is done
+	PROFILE_WRITE_BARRIER();
+	thread->depth = depth;
+}
+
+/*
+================
+idProfilerLocal::StopRecording
+
+Stops recording and waits a bit for the other threads to leave the zones
+they entered while recording, which still write to their buffers.
+================
+*/
+void idProfilerLocal::StopRecording( void ) {
+	// no thread enters another zone once it sees this
+	SDL_LockMutex( mutex );
+	recording = false;
+	SDL_UnlockMutex( mutex );
+
+	int waitStart = Sys_Milliseconds();
+
+	for ( int i = 0; i < numThreads; i++ ) {
+		// the zones of the calling thread are left after the trace is written
+		if ( threads[i] == currentThread ) {
+			continue;
+		}
+		while ( threads[i]->depth > 0 && Sys_Milliseconds() - waitStart < PROFILE_DRAIN_MSEC ) {
+			Sys_Sleep( 1 );
+		}
+	}
+
+	PROFILE_READ_BARRIER();
+}
+
+/*
+================
+WriteTraceString
+================
+*/
+static void WriteTraceString( idFile *f, const char *s ) {
+	idStr escaped;
+
+	for ( ; *s; s++ ) {
+		if ( *s == '"' || *s == '\\' ) {
+			escaped += '\\';
+		}
+		escaped += *s;
+	}
+	f->Printf( "\"%s\"", escaped.c_str() );
+}
+
+/*
+================
+idProfilerLocal::WriteTrace
+
+writes the zones of the last traceFrames frames in the Chrome trace event format,
+which can be viewed with chrome://tracing or ui.perfetto.dev
+================
+*/
+bool idProfilerLocal::WriteTrace( const char *fileName, int traceFrames ) {
+	// the frame that is running now isn't complete
+	int completeFrames = numFrames - 1;
+	if ( completeFrames > PROFILE_MAX_FRAMES - 1 ) {
+		completeFrames = PROFILE_MAX_FRAMES - 1;
+	}
+	if ( completeFrames < 1 ) {
+		common->Printf( "no frames recorded, set com_profile 1 first\n" );
+		return false;
+	}
+	if ( traceFrames > completeFrames ) {
+		traceFrames = completeFrames;
+	}
+
+	idFile *f = fileSystem->OpenFileWrite( fileName );
+	if ( !f ) {
+		common->Warning( "couldn't open %s", fileName );
+		return false;
+	}
+
+	// keep the buffers from wrapping around while they are read
+	bool wasRecording = recording;
+	StopRecording();
+
+	int lastFrame = numFrames - 1;
+	int firstFrame = lastFrame - traceFrames;
+	double traceStart = frameStarts[firstFrame & ( PROFILE_MAX_FRAMES - 1 )];
+	double traceEnd = frameStarts[lastFrame & ( PROFILE_MAX_FRAMES - 1 )];
+	int numWritten = 0;
+
+	f->Printf( "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" );
+
+	for ( int i = 0; i < numThreads; i++ ) {
+		f->Printf( "{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":", i );
+		WriteTraceString( f, threads[i]->name );
+		f->Printf( "}},\n" );
+		f->Printf( "{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_sort_index\",\"args\":{\"sort_index\":%d}},\n", i, i );
+	}
+
+	for ( int i = firstFrame; i < lastFrame; i++ ) {
+		double start = frameStarts[i & ( PROFILE_MAX_FRAMES - 1 )];
+		double end = frameStarts[( i + 1 ) & ( PROFILE_MAX_FRAMES - 1 )];
+		f->Printf( "{\"ph\":\"X\",\"pid\":1,\"tid\":0,\"name\":\"frame %d\",\"ts\":%.3f,\"dur\":%.3f},\n",
+					idLib::frameNumber - ( lastFrame - i ), ( start - traceStart ) * 1000.0, ( end - start ) * 1000.0 );
+	}
+
+	for ( int i = 0; i < numThreads; i++ ) {
+		profileThread_t *thread = threads[i];
+		int end = thread->numZones;
+		// a thread that didn't leave its zones in time, or entered one just as recording
+		// stopped, still writes a zone for each of them over the oldest ones of the buffer
+		int start = Max( end - PROFILE_MAX_ZONES + PROFILE_MAX_DEPTH, 0 );
+
+		for ( int j = start; j < end; j++ ) {
+			const profileZone_t &zone = thread->zones[j & ( PROFILE_MAX_ZONES - 1 )];
+			if ( zone.end < traceStart || zone.start > traceEnd ) {
+				continue;
+			}
+			f->Printf( "{\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"name\":", i );
+			WriteTraceString( f, zone.name );
+			f->Printf( ",\"ts\":%.3f,\"dur\":%.3f},\n", ( zone.start - traceStart ) * 1000.0, ( zone.end - zone.start ) * 1000.0 );
+			numWritten++;
+		}
+	}
+
+	// closing metadata event, so every event before can end with a comma
+	f->Printf( "{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\",\"args\":{\"name\":\"" GAME_NAME "\"}}\n]}\n" );
+
+	common->Printf( "wrote %d zones of %d frames to %s\n", numWritten, traceFrames, f->GetFullPath() );
+
+	fileSystem->CloseFile( f );
+
+	recording = wasRecording;
+
+	return true;
+}
+
+/*
+================
+idProfilerLocal::ProfileDump_f
+================
+*/
+void idProfilerLocal::ProfileDump_f( const idCmdArgs &args ) {
+	int traceFrames = 10;
+	idStr fileName;
+
+	if ( args.Argc() > 3 ) {
+		common->Printf( "usage: profileDump [numFrames] [fileName]\n" );
+		return;
+	}
+
+	if ( args.Argc() > 1 ) {
+		traceFrames = atoi( args.Argv( 1 ) );
+		if ( traceFrames < 1 ) {
+			common->Printf( "usage: profileDump [numFrames] [fileName]\n" );
+			return;
+		}
+	}
+
+	if ( args.Argc() > 2 ) {
+		fileName = args.Argv( 2 );
+		fileName.DefaultFileExtension( ".json" );
+	} else {
+		sprintf( fileName, "profiles/profile_%05d.json", idLib::frameNumber );
+	}
+
+	profilerLocal.WriteTrace( fileName, traceFrames );
+}
@@ -29,6 +29,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "sys/platform.h"
 #include "idlib/hashing/CRC32.h"
 #include "idlib/LangDict.h"
+#include "idlib/Profiler.h"
 #include "framework/async/AsyncNetwork.h"
 #include "framework/Console.h"
 #include "framework/Game.h"
@@ -2588,6 +2589,7 @@ idSessionLocal::UpdateScreen
 ===============
 */
 void idSessionLocal::UpdateScreen( bool outOfSequence ) {
+	PROFILE_ZONE( "idSession::UpdateScreen" );
 
 #ifdef _WIN32
 
@@ -2633,6 +2635,7 @@ idSessionLocal::Frame
 extern bool CheckOpenALDeviceAndRecoverIfNeeded();
 extern int g_screenshotFormat;
 void idSessionLocal::Frame() {
+	PROFILE_ZONE( "idSession::Frame" );
 
 	if ( com_asyncSound.GetInteger() == 0 ) {
 		soundSystem->AsyncUpdateWrite( Sys_Milliseconds() );
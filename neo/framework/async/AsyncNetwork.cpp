@@ -28,6 +28,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "sys/platform.h"
 #include "idlib/LangDict.h"
+#include "idlib/Profiler.h"
 #include "framework/Console.h"
 #include "framework/Game.h"
 #include "renderer/RenderSystem.h"
@@ -171,6 +172,8 @@ idAsyncNetwork::RunFrame
 ==================
 */
 void idAsyncNetwork::RunFrame( void ) {
+	PROFILE_ZONE( "idAsyncNetwork::RunFrame" );
+
 	if ( console->Active() ) {
 		usercmdGen->InhibitUsercmd( INHIBIT_ASYNC, true );
 	} else {
@@ -1395,6 +1395,7 @@ Present is called to allow entities to generate refEntities, lights, etc for the
 ================
 */
 void idEntity::Present( void ) {
+	idThinkStatsScope thinkStatsScope( this, THINKSTAT_PRESENT );
 
 	if ( !gameLocal.isNewFrame ) {
 		return;
@@ -2540,6 +2541,8 @@ bool idEntity::RunPhysics( void ) {
 	idEntity *	part, *blockedPart, *blockingEntity;
 	bool		moved;
 
+	idThinkStatsScope thinkStatsScope( this, THINKSTAT_PHYSICS );
+
 	// don't run physics if not enabled
 	if ( !( thinkFlags & TH_PHYSICS ) ) {
 		// however do update any animation controllers
@@ -66,6 +66,27 @@ typedef struct aasObstacle_s {
 	idBounds					expAbsBounds;	// expanded absolute bounds of obstacle
 } aasObstacle_t;
 
+
+typedef struct aasRoute_s {
+	int							areaNum;		// start area
+	idVec3						origin;			// start position in the area
+	bool						found;			// true if there is a route to the goal area
+	int							travelTime;		// travel time towards the goal area
+	idReachability *			reach;			// first reachability towards the goal area
+} aasRoute_t;
+
+
+typedef struct aasRoutingStats_s {
+	int							numRoutes;			// single routing queries
+	int							numBatches;			// batched routing queries
+	int							numBatchedRoutes;	// routes of all batched queries
+	int							numPaths;			// walk and fly path queries
+	int							areaCacheHits;		// area routing cache found
+	int							areaCacheMisses;	// area routing cache calculated
+	int							portalCacheHits;	// portal routing cache found
+	int							portalCacheMisses;	// portal routing cache calculated
+} aasRoutingStats_t;
+
 class idAASCallback {
 public:
 	virtual						~idAASCallback() {};
@@ -82,6 +103,8 @@ public:
 	virtual bool				Init( const idStr &mapName, unsigned int mapFileCRC ) = 0;
 								// Print AAS stats.
 	virtual void				Stats( void ) const = 0;
+								// Get the routing statistics gathered since the last reset.
+	virtual void				GetRoutingStats( aasRoutingStats_t &stats, bool reset ) = 0;
 								// Test from the given origin.
 	virtual void				Test( const idVec3 &origin ) = 0;
 								// Get the AAS settings.
@@ -124,6 +147,10 @@ public:
 	virtual int					TravelTimeToGoalArea( int areaNum, const idVec3 &origin, int goalAreaNum, int travelFlags ) const = 0;
 								// Get the travel time and first reachability to be used towards the goal, returns true if there is a path.
 	virtual bool				RouteToGoalArea( int areaNum, const idVec3 origin, int goalAreaNum, int travelFlags, int &travelTime, idReachability **reach ) const = 0;
+								// Same as RouteToGoalArea for many start areas towards the same goal, returns the number of routes found.
+	virtual int					RoutesToGoalArea( aasRoute_t *routes, int numRoutes, int goalAreaNum, int travelFlags ) const = 0;
+								// Changes whenever areas or reachabilities are enabled or disabled, routes found before may be invalid then.
+	virtual int					GetRoutingRevision( void ) const = 0;
 								// Creates a walk path towards the goal.
 	virtual bool				WalkPathToGoal( aasPath_t &path, int areaNum, const idVec3 &origin, int goalAreaNum, const idVec3 &goalOrigin, int travelFlags ) const = 0;
 								// Returns true if one can walk along a straight line from the origin to the goal origin.
@@ -288,6 +288,8 @@ bool idAASLocal::WalkPathToGoal( aasPath_t &path, int areaNum, const idVec3 &ori
 	path.secondaryGoal = origin;
 	path.reachability = NULL;
 
+	routingStats.numPaths++;
+
 	if ( file == NULL || areaNum == goalAreaNum ) {
 		path.moveGoal = goalOrigin;
 		return true;
@@ -464,6 +466,8 @@ bool idAASLocal::FlyPathToGoal( aasPath_t &path, int areaNum, const idVec3 &orig
 	path.secondaryGoal = origin;
 	path.reachability = NULL;
 
+	routingStats.numPaths++;
+
 	if ( file == NULL || areaNum == goalAreaNum ) {
 		path.moveGoal = goalOrigin;
 		return true;
@@ -27,6 +27,7 @@ If you have questions concerning this license or the applicable additional terms
 */
 
 #include "sys/platform.h"
+#include "gamesys/SysCvar.h"
 #include "Game_local.h"
 
 #include "ai/AAS_local.h"
@@ -38,6 +39,9 @@ If you have questions concerning this license or the applicable additional terms
 
 #define LEDGE_TRAVELTIME_PANALTY	250
 
+// the travel flags of all monsters, see idAI::travelFlags
+#define PRECACHE_TRAVELFLAGS		(TFL_WALK|TFL_AIR)
+
 /*
 ============
 idRoutingCache::idRoutingCache
@@ -51,6 +55,7 @@ idRoutingCache::idRoutingCache( int size ) {
 	travelFlags = 0;
 	startTravelTime = 0;
 	type = 0;
+	precached = false;
 	this->size = size;
 	reachabilities = new byte[size];
 	memset( reachabilities, 0, size * sizeof( reachabilities[0] ) );
@@ -211,6 +216,7 @@ void idAASLocal::SetupRoutingCache( void ) {
 
 	cacheListStart = cacheListEnd = NULL;
 	totalCacheMemory = 0;
+	precacheMemory = 0;
 }
 
 /*
@@ -220,13 +226,10 @@ idAASLocal::DeleteClusterCache
 */
 void idAASLocal::DeleteClusterCache( int clusterNum ) {
 	int i;
-	idRoutingCache *cache;
 
 	for ( i = 0; i < file->GetCluster( clusterNum ).numReachableAreas; i++ ) {
-		for ( cache = areaCacheIndex[clusterNum][i]; cache; cache = areaCacheIndex[clusterNum][i] ) {
-			areaCacheIndex[clusterNum][i] = cache->next;
-			UnlinkCache( cache );
-			delete cache;
+		while( areaCacheIndex[clusterNum][i] ) {
+			DeleteCache( areaCacheIndex[clusterNum][i] );
 		}
 	}
 }
@@ -238,13 +241,10 @@ idAASLocal::DeletePortalCache
 */
 void idAASLocal::DeletePortalCache( void ) {
 	int i;
-	idRoutingCache *cache;
 
 	for ( i = 0; i < file->GetNumAreas(); i++ ) {
-		for ( cache = portalCacheIndex[i]; cache; cache = portalCacheIndex[i] ) {
-			portalCacheIndex[i] = cache->next;
-			UnlinkCache( cache );
-			delete cache;
+		while( portalCacheIndex[i] ) {
+			DeleteCache( portalCacheIndex[i] );
 		}
 	}
 }
@@ -278,6 +278,130 @@ void idAASLocal::ShutdownRoutingCache( void ) {
 
 	cacheListStart = cacheListEnd = NULL;
 	totalCacheMemory = 0;
+	precacheMemory = 0;
+}
+
+/*
+============
+idAASLocal::RoutingPrecacheJob
+============
+*/
+void idAASLocal::RoutingPrecacheJob( idRoutingPrecache *precache ) {
+	precache->aas->PrecacheClusterRouting( precache );
+}
+
+/*
+============
+idAASLocal::PrecacheClusterRouting
+
+  calculates the area cache of all portal areas of a cluster, runs in a job so it only reads
+  the AAS file and writes to the precache, the cache is added to the cache index afterwards
+============
+*/
+void idAASLocal::PrecacheClusterRouting( idRoutingPrecache *precache ) const {
+	int i;
+	const aasCluster_t *cluster;
+	idRoutingUpdate *updates;
+	idRoutingCache *cache;
+
+	cluster = &file->GetCluster( precache->cluster );
+	if ( !cluster->numPortals || !cluster->numReachableAreas ) {
+		return;
+	}
+
+	// own update memory, areaUpdate is used by the routing on the main thread
+	updates = (idRoutingUpdate *) Mem_ClearedAlloc( cluster->numReachableAreas * sizeof( idRoutingUpdate ) );
+
+	for ( i = 0; i < cluster->numPortals; i++ ) {
+		cache = new idRoutingCache( cluster->numReachableAreas );
+		cache->type = CACHETYPE_AREA;
+		cache->cluster = precache->cluster;
+		cache->areaNum = file->GetPortal( file->GetPortalIndex( cluster->firstPortal + i ) ).areaNum;
+		cache->startTravelTime = 1;
+		cache->travelFlags = precache->travelFlags;
+		cache->precached = true;
+		UpdateAreaRoutingCache( cache, updates );
+		precache->caches.Append( cache );
+	}
+
+	Mem_Free( updates );
+}
+
+/*
+============
+idAASLocal::StartRoutingPrecache
+
+  every route leaving a cluster needs the area cache of the cluster portals,
+  calculate them on the worker threads instead of during the first fights
+============
+*/
+void idAASLocal::StartRoutingPrecache( void ) {
+	int i;
+	idRoutingPrecache *precache;
+
+	if ( !aas_precacheRouting.GetBool() ) {
+		return;
+	}
+
+	precacheJobList = parallelJobManager->AllocJobList( "idAASLocal::PrecacheClusterRouting" );
+	for ( i = 0; i < file->GetNumClusters(); i++ ) {
+		precache = new idRoutingPrecache;
+		precache->aas = this;
+		precache->cluster = i;
+		precache->travelFlags = PRECACHE_TRAVELFLAGS;
+		precacheJobs.Append( precache );
+		precacheJobList->AddJob( (jobRun_t)RoutingPrecacheJob, precache );
+	}
+	precacheJobList->Submit();
+}
+
+/*
+============
+idAASLocal::FinishRoutingPrecache
+
+  adds the precached area cache to the cache index once the jobs are done,
+  waits for the jobs if requested, which is required before changing any area or reachability
+============
+*/
+void idAASLocal::FinishRoutingPrecache( bool wait ) const {
+	int i, j, clusterAreaNum;
+	idRoutingCache *cache, *old, **clusterCache;
+
+	if ( !precacheJobList ) {
+		return;
+	}
+	if ( !wait && !precacheJobList->IsDone() ) {
+		return;
+	}
+
+	precacheJobList->Wait();
+	parallelJobManager->FreeJobList( precacheJobList );
+	precacheJobList = NULL;
+
+	for ( i = 0; i < precacheJobs.Num(); i++ ) {
+		for ( j = 0; j < precacheJobs[i]->caches.Num(); j++ ) {
+			cache = precacheJobs[i]->caches[j];
+			clusterAreaNum = ClusterAreaNum( cache->cluster, cache->areaNum );
+			clusterCache = &areaCacheIndex[cache->cluster][clusterAreaNum];
+
+			// replace the cache calculated by routing in the meantime
+			for ( old = *clusterCache; old; old = old->next ) {
+				if ( old->travelFlags == cache->travelFlags ) {
+					DeleteCache( old );
+					break;
+				}
+			}
+
+			cache->prev = NULL;
+			cache->next = *clusterCache;
+			if ( *clusterCache ) {
+				(*clusterCache)->prev = cache;
+			}
+			*clusterCache = cache;
+			precacheMemory += cache->Size();
+		}
+	}
+	precacheJobs.DeleteContents( true );
 }
 
 /*
@@ -286,8 +410,10 @@ idAASLocal::SetupRouting
 ============
 */
 bool idAASLocal::SetupRouting( void ) {
+	routingRevision++;
 	CalculateAreaTravelTimes();
 	SetupRoutingCache();
+	StartRoutingPrecache();
 	return true;
 }
 
@@ -297,6 +423,7 @@ idAASLocal::ShutdownRouting
 ============
 */
 void idAASLocal::ShutdownRouting( void ) {
+	FinishRoutingPrecache( true );
 	DeleteAreaTravelTimes();
 	ShutdownRoutingCache();
 }
@@ -308,9 +435,20 @@ idAASLocal::RoutingStats
 */
 void idAASLocal::RoutingStats( void ) const {
 	idRoutingCache *cache;
-	int numAreaCache, numPortalCache;
+	int i, j, numAreaCache, numPortalCache, numPrecache;
 	int totalAreaCacheMemory, totalPortalCacheMemory;
 
+	numPrecache = 0;
+	for ( i = 0; i < file->GetNumClusters(); i++ ) {
+		for ( j = 0; j < file->GetCluster( i ).numReachableAreas; j++ ) {
+			for ( cache = areaCacheIndex[i][j]; cache; cache = cache->next ) {
+				if ( cache->precached ) {
+					numPrecache++;
+				}
+			}
+		}
+	}
+
 	numAreaCache = numPortalCache = 0;
 	totalAreaCacheMemory = totalPortalCacheMemory = 0;
 	for ( cache = cacheListStart; cache; cache = cache->time_next ) {
@@ -326,30 +464,144 @@ void idAASLocal::RoutingStats( void ) const {
 	gameLocal.Printf( "%6d area cache (%d KB)\n", numAreaCache, totalAreaCacheMemory >> 10 );
 	gameLocal.Printf( "%6d portal cache (%d KB)\n", numPortalCache, totalPortalCacheMemory >> 10 );
 	gameLocal.Printf( "%6d total cache (%d KB)\n", numAreaCache + numPortalCache, totalCacheMemory >> 10 );
+	gameLocal.Printf( "%6d precached area cache (%d KB)%s\n", numPrecache, precacheMemory >> 10, precacheJobList ? ", still calculating" : "" );
 	gameLocal.Printf( "%6d area travel times (%zu KB)\n", numAreaTravelTimes, ( numAreaTravelTimes * sizeof( unsigned short ) ) >> 10 );
 	gameLocal.Printf( "%6d area cache entries (%zu KB)\n", areaCacheIndexSize, ( areaCacheIndexSize * sizeof( idRoutingCache * ) ) >> 10 );
 	gameLocal.Printf( "%6d portal cache entries (%zu KB)\n", portalCacheIndexSize, ( portalCacheIndexSize * sizeof( idRoutingCache * ) ) >> 10 );
 }
 
+/*
+============
+idAASLocal::AreaCacheReachedArea
+
+  returns true if the area got a travel time when the area cache was calculated
+============
+*/
+bool idAASLocal::AreaCacheReachedArea( const idRoutingCache *cache, int areaNum ) const {
+	int areaCluster, clusterAreaNum;
+	const aasPortal_t *portal;
+
+	areaCluster = file->GetArea( areaNum ).cluster;
+	if ( areaCluster < 0 ) {
+		portal = &file->GetPortal( -areaCluster );
+		if ( portal->clusters[0] != cache->cluster && portal->clusters[1] != cache->cluster ) {
+			return false;
+		}
+	}
+	else if ( areaCluster != cache->cluster ) {
+		return false;
+	}
+	clusterAreaNum = ClusterAreaNum( cache->cluster, areaNum );
+	return ( clusterAreaNum < cache->size && cache->travelTimes[clusterAreaNum] != 0 );
+}
+
+/*
+============
+idAASLocal::AreaCacheUsesArea
+
+  returns true if the area cache may change when the area is enabled or disabled or the reachabilities into
+  the area change. The cache is flooded backwards from its area so it can only change if the flood reached
+  the area or, when the area is enabled, any of the areas the area leads to.
+============
+*/
+bool idAASLocal::AreaCacheUsesArea( const idRoutingCache *cache, int areaNum ) const {
+	const idReachability *reach;
+
+	if ( AreaCacheReachedArea( cache, areaNum ) ) {
+		return true;
+	}
+	for ( reach = file->GetArea( areaNum ).reach; reach; reach = reach->next ) {
+		if ( AreaCacheReachedArea( cache, reach->toAreaNum ) ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+============
+idAASLocal::PortalCacheUsesCluster
+
+  returns true if the area cache of the cluster was used to calculate the portal cache,
+  which is the case for the cluster of the goal area and every cluster with a reached portal
+============
+*/
+bool idAASLocal::PortalCacheUsesCluster( const idRoutingCache *cache, int clusterNum ) const {
+	int i;
+	const aasCluster_t *cluster;
+
+	if ( cache->cluster == clusterNum ) {
+		return true;
+	}
+	cluster = &file->GetCluster( clusterNum );
+	for ( i = 0; i < cluster->numPortals; i++ ) {
+		if ( cache->travelTimes[file->GetPortalIndex( cluster->firstPortal + i )] ) {
+			return true;
+		}
+	}
+	return false;
+}
+
 /*
 ============
 idAASLocal::RemoveRoutingCacheUsingArea
+
+  removes the cache that may change with the state of the area, precached cache is recalculated instead
 ============
 */
 void idAASLocal::RemoveRoutingCacheUsingArea( int areaNum ) {
-	int clusterNum;
+	int i, j, clusterNum, numClusters, clusters[2];
+	idRoutingCache *cache, *next;
+
+	// routes found before may have changed
+	routingRevision++;
 
 	clusterNum = file->GetArea( areaNum ).cluster;
 	if ( clusterNum > 0 ) {
-		// remove all the cache in the cluster the area is in
-		DeleteClusterCache( clusterNum );
+		// only the cache in the cluster the area is in
+		clusters[0] = clusterNum;
+		numClusters = 1;
+	}
+	else if ( clusterNum < 0 ) {
+		// if this is a portal the cache in both the front and back cluster
+		clusters[0] = file->GetPortal( -clusterNum ).clusters[0];
+		clusters[1] = file->GetPortal( -clusterNum ).clusters[1];
+		numClusters = 2;
 	}
 	else {
-		// if this is a portal remove all cache in both the front and back cluster
-		DeleteClusterCache( file->GetPortal( -clusterNum ).clusters[0] );
-		DeleteClusterCache( file->GetPortal( -clusterNum ).clusters[1] );
+		// not used for routing
+		return;
+	}
+
+	for ( i = 0; i < numClusters; i++ ) {
+		for ( j = 0; j < file->GetCluster( clusters[i] ).numReachableAreas; j++ ) {
+			for ( cache = areaCacheIndex[clusters[i]][j]; cache; cache = next ) {
+				next = cache->next;
+				if ( !AreaCacheUsesArea( cache, areaNum ) ) {
+					continue;
+				}
+				if ( cache->precached ) {
+					memset( cache->travelTimes, 0, cache->size * sizeof( cache->travelTimes[0] ) );
+					memset( cache->reachabilities, 0, cache->size * sizeof( cache->reachabilities[0] ) );
+					UpdateAreaRoutingCache( cache, areaUpdate );
+				} else {
+					DeleteCache( cache );
+				}
+			}
+		}
+	}
+
+	for ( i = 0; i < file->GetNumAreas(); i++ ) {
+		for ( cache = portalCacheIndex[i]; cache; cache = next ) {
+			next = cache->next;
+			for ( j = 0; j < numClusters; j++ ) {
+				if ( PortalCacheUsesCluster( cache, clusters[j] ) ) {
+					DeleteCache( cache );
+					break;
+				}
+			}
+		}
 	}
-	DeletePortalCache();
 }
 
 /*
@@ -438,6 +690,8 @@ bool idAASLocal::SetAreaState( const idBounds &bounds, const int areaContents, b
 		return false;
 	}
 
+	FinishRoutingPrecache( true );
+
 	expBounds[0] = bounds[0] - file->GetSettings().boundingBoxes[0][1];
 	expBounds[1] = bounds[1] - file->GetSettings().boundingBoxes[0][0];
 
@@ -487,8 +741,6 @@ void idAASLocal::SetObstacleState( const idRoutingObstacle *obstacle, bool enabl
 
 	for ( i = 0; i < obstacle->areas.Num(); i++ ) {
 
-		RemoveRoutingCacheUsingArea( obstacle->areas[i] );
-
 		area = &file->GetArea( obstacle->areas[i] );
 
 		for ( rev_reach = area->rev_reach; rev_reach; rev_reach = rev_reach->rev_next ) {
@@ -526,6 +778,11 @@ void idAASLocal::SetObstacleState( const idRoutingObstacle *obstacle, bool enabl
 			}
 		}
 	}
+
+	// after changing all reachabilities, precached cache is recalculated with them
+	for ( i = 0; i < obstacle->areas.Num(); i++ ) {
+		RemoveRoutingCacheUsingArea( obstacle->areas[i] );
+	}
 }
 
 /*
@@ -540,6 +797,8 @@ aasHandle_t idAASLocal::AddObstacle( const idBounds &bounds ) {
 		return -1;
 	}
 
+	FinishRoutingPrecache( true );
+
 	obstacle = new idRoutingObstacle;
 	obstacle->bounds[0] = bounds[0] - file->GetSettings().boundingBoxes[0][1];
 	obstacle->bounds[1] = bounds[1] - file->GetSettings().boundingBoxes[0][0];
@@ -559,6 +818,7 @@ void idAASLocal::RemoveObstacle( const aasHandle_t handle ) {
 	if ( !file ) {
 		return;
 	}
+	FinishRoutingPrecache( true );
 	if ( ( handle >= 0 ) && ( handle < obstacleList.Num() ) ) {
 		SetObstacleState( obstacleList[handle], false );
 
@@ -579,6 +839,8 @@ void idAASLocal::RemoveAllObstacles( void ) {
 		return;
 	}
 
+	FinishRoutingPrecache( true );
+
 	for ( i = 0; i < obstacleList.Num(); i++ ) {
 		SetObstacleState( obstacleList[i], false );
 		delete obstacleList[i];
@@ -639,19 +901,18 @@ void idAASLocal::UnlinkCache( idRoutingCache *cache ) const {
 
 /*
 ============
-idAASLocal::DeleteOldestCache
+idAASLocal::DeleteCache
 ============
 */
-void idAASLocal::DeleteOldestCache( void ) const {
-	idRoutingCache *cache;
-
-	assert( cacheListStart );
+void idAASLocal::DeleteCache( idRoutingCache *cache ) const {
 
-	// unlink the oldest cache
-	cache = cacheListStart;
-	UnlinkCache( cache );
+	if ( cache->precached ) {
+		precacheMemory -= cache->Size();
+	} else {
+		UnlinkCache( cache );
+	}
 
-	// unlink the oldest cache from the area or portal cache index
+	// unlink the cache from the area or portal cache index
 	if ( cache->next ) {
 		cache->next->prev = cache->prev;
 	}
@@ -668,6 +929,17 @@ void idAASLocal::DeleteOldestCache( void ) const {
 	delete cache;
 }
 
+/*
+============
+idAASLocal::DeleteOldestCache
+============
+*/
+void idAASLocal::DeleteOldestCache( void ) const {
+	assert( cacheListStart );
+
+	DeleteCache( cacheListStart );
+}
+
 /*
 ============
 idAASLocal::GetAreaReachability
@@ -707,7 +979,7 @@ ID_INLINE int idAASLocal::ClusterAreaNum( int clusterNum, int areaNum ) const {
 idAASLocal::UpdateAreaRoutingCache
 ============
 */
-void idAASLocal::UpdateAreaRoutingCache( idRoutingCache *areaCache ) const {
+void idAASLocal::UpdateAreaRoutingCache( idRoutingCache *areaCache, idRoutingUpdate *updates ) const {
 	int i, nextAreaNum, cluster, badTravelFlags, clusterAreaNum, numReachableAreas;
 	unsigned short t, startAreaTravelTimes[MAX_REACH_PER_AREA];
 	idRoutingUpdate *updateListStart, *updateListEnd, *curUpdate, *nextUpdate;
@@ -728,7 +1000,7 @@ void idAASLocal::UpdateAreaRoutingCache( idRoutingCache *areaCache ) const {
 	memset( startAreaTravelTimes, 0, sizeof( startAreaTravelTimes ) );
 
 	// initialize first update
-	curUpdate = &areaUpdate[clusterAreaNum];
+	curUpdate = &updates[clusterAreaNum];
 	curUpdate->areaNum = areaCache->areaNum;
 	curUpdate->areaTravelTimes = startAreaTravelTimes;
 	curUpdate->tmpTravelTime = areaCache->startTravelTime;
@@ -790,7 +1062,7 @@ void idAASLocal::UpdateAreaRoutingCache( idRoutingCache *areaCache ) const {
 
 				areaCache->travelTimes[clusterAreaNum] = t;
 				areaCache->reachabilities[clusterAreaNum] = reach->number; // reversed reachability used to get into this area
-				nextUpdate = &areaUpdate[clusterAreaNum];
+				nextUpdate = &updates[clusterAreaNum];
 				nextUpdate->areaNum = nextAreaNum;
 				nextUpdate->tmpTravelTime = t;
 				nextUpdate->areaTravelTimes = reach->areaTravelTimes;
@@ -841,6 +1113,7 @@ idRoutingCache *idAASLocal::GetAreaRoutingCache( int clusterNum, int areaNum, in
 	}
 	// if no cache found
 	if ( !cache ) {
+		routingStats.areaCacheMisses++;
 		cache = new idRoutingCache( file->GetCluster( clusterNum ).numReachableAreas );
 		cache->type = CACHETYPE_AREA;
 		cache->cluster = clusterNum;
@@ -853,9 +1126,14 @@ idRoutingCache *idAASLocal::GetAreaRoutingCache( int clusterNum, int areaNum, in
 			clusterCache->prev = cache;
 		}
 		areaCacheIndex[clusterNum][clusterAreaNum] = cache;
-		UpdateAreaRoutingCache( cache );
+		UpdateAreaRoutingCache( cache, areaUpdate );
+	}
+	else {
+		routingStats.areaCacheHits++;
+	}
+	if ( !cache->precached ) {
+		LinkCache( cache );
 	}
-	LinkCache( cache );
 	return cache;
 }
 
@@ -967,6 +1245,7 @@ idRoutingCache *idAASLocal::GetPortalRoutingCache( int clusterNum, int areaNum,
 	}
 	// if no cache found
 	if ( !cache ) {
+		routingStats.portalCacheMisses++;
 		cache = new idRoutingCache( file->GetNumPortals() );
 		cache->type = CACHETYPE_PORTAL;
 		cache->cluster = clusterNum;
@@ -981,60 +1260,79 @@ idRoutingCache *idAASLocal::GetPortalRoutingCache( int clusterNum, int areaNum,
 		portalCacheIndex[areaNum] = cache;
 		UpdatePortalRoutingCache( cache );
 	}
+	else {
+		routingStats.portalCacheHits++;
+	}
 	LinkCache( cache );
 	return cache;
 }
 
 /*
 ============
-idAASLocal::RouteToGoalArea
+idAASLocal::GetGoalPortalRoutingCache
+
+  the portal routing cache is the reverse flood from the goal area through all clusters
 ============
 */
-bool idAASLocal::RouteToGoalArea( int areaNum, const idVec3 origin, int goalAreaNum, int travelFlags, int &travelTime, idReachability **reach ) const {
-	int clusterNum, goalClusterNum, portalNum, i, clusterAreaNum;
-	unsigned short int t, bestTime;
-	const aasPortal_t *portal;
+idRoutingCache *idAASLocal::GetGoalPortalRoutingCache( int goalAreaNum, int travelFlags ) const {
+	int goalClusterNum;
+
+	goalClusterNum = file->GetArea( goalAreaNum ).cluster;
+	// if the goal area is a portal
+	if ( goalClusterNum < 0 ) {
+		// just assume the goal area is part of the front cluster
+		goalClusterNum = file->GetPortal( -goalClusterNum ).clusters[0];
+	}
+	return GetPortalRoutingCache( goalClusterNum, goalAreaNum, travelFlags );
+}
+
+/*
+============
+idAASLocal::GetClusterPortalCaches
+
+  gets the area cache of every portal of the cluster the goal can be reached from, NULL for the other portals
+============
+*/
+void idAASLocal::GetClusterPortalCaches( int clusterNum, const idRoutingCache *portalCache, int travelFlags, idRoutingCache **caches ) const {
+	int i, portalNum;
 	const aasCluster_t *cluster;
-	idRoutingCache *areaCache, *portalCache, *clusterCache;
-	idReachability *bestReach, *r, *nextr;
 
-	travelTime = 0;
-	*reach = NULL;
+	cluster = &file->GetCluster( clusterNum );
+	for ( i = 0; i < cluster->numPortals; i++ ) {
+		portalNum = file->GetPortalIndex( cluster->firstPortal + i );
 
-	if ( !file ) {
-		return false;
-	}
+		// if the goal area isn't reachable from the portal
+		if ( !portalCache->travelTimes[portalNum] ) {
+			caches[i] = NULL;
+			continue;
+		}
 
-	if ( areaNum == goalAreaNum ) {
-		return true;
+		// get the cache of the portal area
+		caches[i] = GetAreaRoutingCache( clusterNum, file->GetPortal( portalNum ).areaNum, travelFlags );
 	}
+}
 
-	if ( areaNum <= 0 || areaNum >= file->GetNumAreas() ) {
-		gameLocal.Printf( "RouteToGoalArea: areaNum %d out of range\n", areaNum );
-		return false;
-	}
-	if ( goalAreaNum <= 0 || goalAreaNum >= file->GetNumAreas() ) {
-		gameLocal.Printf( "RouteToGoalArea: goalAreaNum %d out of range\n", goalAreaNum );
-		return false;
-	}
+/*
+============
+idAASLocal::RouteFromArea
 
-	while( totalCacheMemory > MAX_ROUTING_CACHE_MEMORY ) {
-		DeleteOldestCache();
-	}
+  portalAreaCaches are the caches from GetClusterPortalCaches for the cluster of the area, looked up when NULL
+============
+*/
+bool idAASLocal::RouteFromArea( int areaNum, const idVec3 &origin, int goalAreaNum, int travelFlags, idRoutingCache *portalCache,
+								idRoutingCache **portalAreaCaches, int &travelTime, idReachability **reach ) const {
+	int clusterNum, goalClusterNum, portalNum, i, clusterAreaNum;
+	unsigned short int t, bestTime;
+	const aasPortal_t *portal;
+	const aasCluster_t *cluster;
+	idRoutingCache *areaCache, *clusterCache;
+	idReachability *bestReach, *r, *nextr;
 
 	clusterNum = file->GetArea( areaNum ).cluster;
 	goalClusterNum = file->GetArea( goalAreaNum ).cluster;
 
 	// if the source area is a cluster portal, read directly from the portal cache
 	if ( clusterNum < 0 ) {
-		// if the goal area is a portal
-		if ( goalClusterNum < 0 ) {
-			// just assume the goal area is part of the front cluster
-			portal = &file->GetPortal( -goalClusterNum );
-			goalClusterNum = portal->clusters[0];
-		}
-		// get the portal routing cache
-		portalCache = GetPortalRoutingCache( goalClusterNum, goalAreaNum, travelFlags );
 		*reach = GetAreaReachability( areaNum, portalCache->reachabilities[-clusterNum] );
 		travelTime = portalCache->travelTimes[-clusterNum] + AreaTravelTime( areaNum, origin, (*reach)->start );
 		return true;
@@ -1067,18 +1365,6 @@ bool idAASLocal::RouteToGoalArea( int areaNum, const idVec3 origin, int goalArea
 		clusterCache = NULL;
 	}
 
-	clusterNum = file->GetArea( areaNum ).cluster;
-	goalClusterNum = file->GetArea( goalAreaNum ).cluster;
-
-	// if the goal area is a portal
-	if ( goalClusterNum < 0 ) {
-		// just assume the goal area is part of the front cluster
-		portal = &file->GetPortal( -goalClusterNum );
-		goalClusterNum = portal->clusters[0];
-	}
-	// get the portal routing cache
-	portalCache = GetPortalRoutingCache( goalClusterNum, goalAreaNum, travelFlags );
-
 	// the cluster the area is in
 	cluster = &file->GetCluster( clusterNum );
 	// current area inside the current cluster
@@ -1088,23 +1374,27 @@ bool idAASLocal::RouteToGoalArea( int areaNum, const idVec3 origin, int goalArea
 		return false;
 	}
 
+	if ( !portalAreaCaches ) {
+		portalAreaCaches = (idRoutingCache **) _alloca16( cluster->numPortals * sizeof( portalAreaCaches[0] ) );
+		GetClusterPortalCaches( clusterNum, portalCache, travelFlags, portalAreaCaches );
+	}
+
 	// find the portal of the source area cluster leading towards the goal area
 	for ( i = 0; i < cluster->numPortals; i++ ) {
-		portalNum = file->GetPortalIndex( cluster->firstPortal + i );
+		areaCache = portalAreaCaches[i];
 
 		// if the goal area isn't reachable from the portal
-		if ( !portalCache->travelTimes[portalNum] ) {
+		if ( !areaCache ) {
 			continue;
 		}
-
-		portal = &file->GetPortal( portalNum );
-		// get the cache of the portal area
-		areaCache = GetAreaRoutingCache( clusterNum, portal->areaNum, travelFlags );
 		// if the portal is not reachable from this area
 		if ( !areaCache->travelTimes[clusterAreaNum] ) {
 			continue;
 		}
 
+		portalNum = file->GetPortalIndex( cluster->firstPortal + i );
+		portal = &file->GetPortal( portalNum );
+
 		r = GetAreaReachability( areaNum, areaCache->reachabilities[clusterAreaNum] );
 
 		if ( clusterCache ) {
@@ -1141,6 +1431,139 @@ bool idAASLocal::RouteToGoalArea( int areaNum, const idVec3 origin, int goalArea
 	return true;
 }
 
+/*
+============
+idAASLocal::RouteToGoalArea
+============
+*/
+bool idAASLocal::RouteToGoalArea( int areaNum, const idVec3 origin, int goalAreaNum, int travelFlags, int &travelTime, idReachability **reach ) const {
+	idRoutingCache *portalCache;
+
+	travelTime = 0;
+	*reach = NULL;
+
+	if ( !file ) {
+		return false;
+	}
+
+	routingStats.numRoutes++;
+
+	if ( areaNum == goalAreaNum ) {
+		return true;
+	}
+
+	if ( areaNum <= 0 || areaNum >= file->GetNumAreas() ) {
+		gameLocal.Printf( "RouteToGoalArea: areaNum %d out of range\n", areaNum );
+		return false;
+	}
+	if ( goalAreaNum <= 0 || goalAreaNum >= file->GetNumAreas() ) {
+		gameLocal.Printf( "RouteToGoalArea: goalAreaNum %d out of range\n", goalAreaNum );
+		return false;
+	}
+
+	// pick up the precached cache once it's ready
+	FinishRoutingPrecache( false );
+
+	while( totalCacheMemory > MAX_ROUTING_CACHE_MEMORY ) {
+		DeleteOldestCache();
+	}
+
+	// get the portal routing cache
+	portalCache = GetGoalPortalRoutingCache( goalAreaNum, travelFlags );
+
+	return RouteFromArea( areaNum, origin, goalAreaNum, travelFlags, portalCache, NULL, travelTime, reach );
+}
+
+/*
+============
+idAASLocal::RoutesToGoalArea
+
+  answers all routes from the one portal routing cache of the goal area, the area cache
+  of the portals of a cluster is looked up once for all routes starting in the cluster
+============
+*/
+int idAASLocal::RoutesToGoalArea( aasRoute_t *routes, int numRoutes, int goalAreaNum, int travelFlags ) const {
+	int i, clusterNum, numFound, *clusterOffsets;
+	idRoutingCache *portalCache, **caches;
+	idList<idRoutingCache *> portalAreaCaches;
+
+	for ( i = 0; i < numRoutes; i++ ) {
+		routes[i].found = false;
+		routes[i].travelTime = 0;
+		routes[i].reach = NULL;
+	}
+
+	if ( !file ) {
+		return 0;
+	}
+
+	routingStats.numBatches++;
+	routingStats.numBatchedRoutes += numRoutes;
+
+	if ( goalAreaNum <= 0 || goalAreaNum >= file->GetNumAreas() ) {
+		gameLocal.Printf( "RoutesToGoalArea: goalAreaNum %d out of range\n", goalAreaNum );
+		return 0;
+	}
+
+	// pick up the precached cache once it's ready
+	FinishRoutingPrecache( false );
+
+	while( totalCacheMemory > MAX_ROUTING_CACHE_MEMORY ) {
+		DeleteOldestCache();
+	}
+
+	// get the portal routing cache shared by all routes
+	portalCache = GetGoalPortalRoutingCache( goalAreaNum, travelFlags );
+
+	// offset of the portal area caches of a cluster in portalAreaCaches, -1 until needed
+	clusterOffsets = (int *) _alloca16( file->GetNumClusters() * sizeof( clusterOffsets[0] ) );
+	memset( clusterOffsets, -1, file->GetNumClusters() * sizeof( clusterOffsets[0] ) );
+	portalAreaCaches.SetGranularity( 256 );
+
+	numFound = 0;
+	for ( i = 0; i < numRoutes; i++ ) {
+		aasRoute_t &route = routes[i];
+
+		if ( route.areaNum == goalAreaNum ) {
+			route.found = true;
+			numFound++;
+			continue;
+		}
+
+		if ( route.areaNum <= 0 || route.areaNum >= file->GetNumAreas() ) {
+			gameLocal.Printf( "RoutesToGoalArea: areaNum %d out of range\n", route.areaNum );
+			continue;
+		}
+
+		caches = NULL;
+		clusterNum = file->GetArea( route.areaNum ).cluster;
+		if ( clusterNum > 0 ) {
+			if ( clusterOffsets[clusterNum] < 0 ) {
+				clusterOffsets[clusterNum] = portalAreaCaches.Num();
+				portalAreaCaches.SetNum( portalAreaCaches.Num() + file->GetCluster( clusterNum ).numPortals, false );
+				GetClusterPortalCaches( clusterNum, portalCache, travelFlags, portalAreaCaches.Ptr() + clusterOffsets[clusterNum] );
+			}
+			caches = portalAreaCaches.Ptr() + clusterOffsets[clusterNum];
+		}
+
+		route.found = RouteFromArea( route.areaNum, route.origin, goalAreaNum, travelFlags, portalCache, caches, route.travelTime, &route.reach );
+		if ( route.found ) {
+			numFound++;
+		}
+	}
+
+	return numFound;
+}
+
+/*
+============
+idAASLocal::GetRoutingRevision
+============
+*/
+int idAASLocal::GetRoutingRevision( void ) const {
+	return routingRevision;
+}
+
 /*
 ============
 idAASLocal::TravelTimeToGoalArea
@@ -522,6 +522,8 @@ public:
 	void						ForceUpdate( void );
 	void						ClearForceUpdate( void );
 	bool						CreateFrame( int animtime, bool force );
+	bool						PrepareParallelFrame( int currentTime );
+	void						CreateParallelFrame( int currentTime );
 	bool						FrameHasChanged( int animtime ) const;
 	void						GetDelta( int fromtime, int totime, idVec3 &delta ) const;
 	bool						GetDeltaRotation( int fromtime, int totime, idMat3 &delta ) const;
@@ -569,6 +571,7 @@ public:
 private:
 	void						FreeData( void );
 	void						PushAnims( int channel, int currentTime, int blendTime );
+	bool						BuildFrame( int currentTime, idJointMat *joints, bool debugInfo ) const;
 
 private:
 	const idDeclModelDef *		modelDef;
@@ -579,6 +582,10 @@ private:
 	int							numJoints;
 	idJointMat *				joints;
 
+	idJointMat *				parallelJoints;			// frame built ahead of time by CreateParallelFrame
+	int							parallelFrameTime;		// time parallelJoints was built for, -1 if not valid
+	bool						parallelFrameResult;
+
 	mutable int					lastTransformTime;		// mutable because the value is updated in CreateFrame
 	mutable bool				stoppedAnimatingUpdate;
 	bool						removeOriginOffset;
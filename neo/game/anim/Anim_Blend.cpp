@@ -3004,6 +3004,8 @@ const idVec3 &idDeclModelDef::GetVisualOffset( void ) const {
 
 ***********************************************************************/
 
+static idCVar r_showSkel( "r_showSkel", "0", CVAR_RENDERER | CVAR_INTEGER, "", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
+
 /*
 =====================
 idAnimator::idAnimator
@@ -3016,6 +3018,9 @@ idAnimator::idAnimator() {
 	entity					= NULL;
 	numJoints				= 0;
 	joints					= NULL;
+	parallelJoints			= NULL;
+	parallelFrameTime		= -1;
+	parallelFrameResult		= false;
 	lastTransformTime		= -1;
 	stoppedAnimatingUpdate	= false;
 	removeOriginOffset		= false;
@@ -3232,6 +3237,8 @@ void idAnimator::FreeData( void ) {
 
 	Mem_Free16( joints );
 	joints = NULL;
+	Mem_Free16( parallelJoints );
+	parallelJoints = NULL;
 	numJoints = 0;
 
 	modelDef = NULL;
@@ -3338,6 +3345,7 @@ idAnimator::RemoveOriginOffset
 */
 void idAnimator::RemoveOriginOffset( bool remove ) {
 	removeOriginOffset = remove;
+	parallelFrameTime = -1;
 }
 
 /*
@@ -3453,6 +3461,9 @@ idAnimBlend *idAnimator::CurrentAnim( int channelNum ) {
 		gameLocal.Error( "idAnimator::CurrentAnim : channel out of range" );
 	}
 
+	// the caller may change the blend, so any frame built ahead of time is stale
+	parallelFrameTime = -1;
+
 	return &channels[ channelNum ][ 0 ];
 }
 
@@ -3491,6 +3502,7 @@ void idAnimator::SetFrame( int channelNum, int animNum, int frame, int currentTi
 	}
 
 	PushAnims( channelNum, currentTime, blendTime );
+	parallelFrameTime = -1;
 	channels[ channelNum ][ 0 ].SetFrame( modelDef, animNum, frame, currentTime, blendTime );
 	if ( entity ) {
 		entity->BecomeActive( TH_ANIMATE );
@@ -3512,6 +3524,7 @@ void idAnimator::CycleAnim( int channelNum, int animNum, int currentTime, int bl
 	}
 
 	PushAnims( channelNum, currentTime, blendTime );
+	parallelFrameTime = -1;
 	channels[ channelNum ][ 0 ].CycleAnim( modelDef, animNum, currentTime, blendTime );
 	if ( entity ) {
 		entity->BecomeActive( TH_ANIMATE );
@@ -3533,6 +3546,7 @@ void idAnimator::PlayAnim( int channelNum, int animNum, int currentTime, int ble
 	}
 
 	PushAnims( channelNum, currentTime, blendTime );
+	parallelFrameTime = -1;
 	channels[ channelNum ][ 0 ].PlayAnim( modelDef, animNum, currentTime, blendTime );
 	if ( entity ) {
 		entity->BecomeActive( TH_ANIMATE );
@@ -3552,6 +3566,8 @@ void idAnimator::SyncAnimChannels( int channelNum, int fromChannelNum, int curre
 	idAnimBlend &fromBlend = channels[ fromChannelNum ][ 0 ];
 	idAnimBlend &toBlend = channels[ channelNum ][ 0 ];
 
+	parallelFrameTime = -1;
+
 	float weight = fromBlend.blendEndValue;
 	if ( ( fromBlend.Anim() != toBlend.Anim() ) || ( fromBlend.GetStartTime() != toBlend.GetStartTime() ) || ( fromBlend.GetEndTime() != toBlend.GetEndTime() ) ) {
 		PushAnims( channelNum, currentTime, blendTime );
@@ -3870,6 +3886,8 @@ idAnimator::InitAFPose
 */
 void idAnimator::InitAFPose( void ) {
 
+	parallelFrameTime = -1;
+
 	if ( !modelDef ) {
 		return;
 	}
@@ -3886,6 +3904,8 @@ idAnimator::SetAFPoseJointMod
 =====================
 */
 void idAnimator::SetAFPoseJointMod( const jointHandle_t jointNum, const AFJointModType_t mod, const idMat3 &axis, const idVec3 &origin ) {
+	parallelFrameTime = -1;
+
 	AFPoseJointMods[jointNum].mod = mod;
 	AFPoseJointMods[jointNum].axis = axis;
 	AFPoseJointMods[jointNum].origin = origin;
@@ -3909,6 +3929,8 @@ void idAnimator::FinishAFPose( int animNum, const idBounds &bounds, const int ti
 	int					jointNum;
 	const int *			jointParent;
 
+	parallelFrameTime = -1;
+
 	if ( !modelDef ) {
 		return;
 	}
@@ -4042,6 +4064,7 @@ idAnimator::SetAFPoseBlendWeight
 */
 void idAnimator::SetAFPoseBlendWeight( float blendWeight ) {
 	AFPoseBlendWeight = blendWeight;
+	parallelFrameTime = -1;
 }
 
 /*
@@ -4178,19 +4201,8 @@ idAnimator::CreateFrame
 =====================
 */
 bool idAnimator::CreateFrame( int currentTime, bool force ) {
-	int					i, j;
-	int					numJoints;
-	int					parentNum;
-	bool				hasAnim;
 	bool				debugInfo;
-	float				baseBlend;
-	float				blendWeight;
-	const idAnimBlend *	blend;
-	const int *			jointParent;
-	const jointMod_t *	jointMod;
-	const idJointQuat *	defaultPose;
-
-	static idCVar		r_showSkel( "r_showSkel", "0", CVAR_RENDERER | CVAR_INTEGER, "", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
+	bool				result;
 
 	if ( gameLocal.inCinematic && gameLocal.skipCinematic ) {
 		return false;
@@ -4220,6 +4232,104 @@ bool idAnimator::CreateFrame( int currentTime, bool force ) {
 		debugInfo = false;
 	}
 
+	// use the frame built by the parallel animation pass if nothing changed since
+	if ( parallelFrameTime == currentTime && !debugInfo ) {
+		parallelFrameTime = -1;
+
+		if ( g_checkParallelThink.GetInteger() ) {
+			result = BuildFrame( currentTime, joints, false );
+			if ( result != parallelFrameResult || ( result && memcmp( joints, parallelJoints, numJoints * sizeof( joints[0] ) ) != 0 ) ) {
+				if ( g_checkParallelThink.GetInteger() > 1 ) {
+					gameLocal.Error( "idAnimator::CreateFrame: parallel frame for '%s' differs from serial frame", entity ? entity->GetName() : modelDef->GetModelName() );
+				} else {
+					gameLocal.Warning( "idAnimator::CreateFrame: parallel frame for '%s' differs from serial frame", entity ? entity->GetName() : modelDef->GetModelName() );
+				}
+			}
+			return result;
+		}
+
+		if ( parallelFrameResult ) {
+			SIMDProcessor->Memcpy( joints, parallelJoints, numJoints * sizeof( joints[0] ) );
+		}
+		return parallelFrameResult;
+	}
+
+	return BuildFrame( currentTime, joints, debugInfo );
+}
+
+/*
+=====================
+idAnimator::PrepareParallelFrame
+
+Called from the main thread before the parallel animation pass.  Returns true
+if CreateFrame would build a new frame at currentTime, in which case the
+frame can be built ahead of time with CreateParallelFrame.
+=====================
+*/
+bool idAnimator::PrepareParallelFrame( int currentTime ) {
+	parallelFrameTime = -1;
+
+	if ( !modelDef || !modelDef->ModelHandle() || !numJoints ) {
+		return false;
+	}
+
+	if ( r_showSkel.GetInteger() ) {
+		return false;
+	}
+
+	if ( lastTransformTime == currentTime ) {
+		return false;
+	}
+
+	if ( lastTransformTime != -1 && !stoppedAnimatingUpdate && !IsAnimating( currentTime ) ) {
+		return false;
+	}
+
+	if ( entity && ( ( g_debugAnim.GetInteger() == entity->entityNumber ) || ( g_debugAnim.GetInteger() == -2 ) ) ) {
+		return false;
+	}
+
+	if ( !parallelJoints ) {
+		parallelJoints = ( idJointMat * )Mem_Alloc16( numJoints * sizeof( parallelJoints[0] ) );
+	}
+
+	return true;
+}
+
+/*
+=====================
+idAnimator::CreateParallelFrame
+
+Builds the frame for currentTime into a separate buffer so CreateFrame can pick
+it up later.  Safe to call from a job as long as nothing else touches the
+animator, since it only writes parallelJoints and the parallel frame state.
+=====================
+*/
+void idAnimator::CreateParallelFrame( int currentTime ) {
+	parallelFrameResult = BuildFrame( currentTime, parallelJoints, false );
+	parallelFrameTime = currentTime;
+}
+
+/*
+=====================
+idAnimator::BuildFrame
+
+Blends the channels and joint modifiers into the given joints.  Does not change
+the animator, so it can build frames on any thread.
+=====================
+*/
+bool idAnimator::BuildFrame( int currentTime, idJointMat *joints, bool debugInfo ) const {
+	int					i, j;
+	int					numJoints;
+	int					parentNum;
+	bool				hasAnim;
+	float				baseBlend;
+	float				blendWeight;
+	const idAnimBlend *	blend;
+	const int *			jointParent;
+	const jointMod_t *	jointMod;
+	const idJointQuat *	defaultPose;
+
 	// init the joint buffer
 	if ( AFPoseJoints.Num() ) {
 		// initialize with AF pose anim for the case where there are no other animations and no AF pose joint modifications
@@ -4229,7 +4339,7 @@ bool idAnimator::CreateFrame( int currentTime, bool force ) {
 	}
 
 	if ( !defaultPose ) {
-		//gameLocal.Warning( "idAnimator::CreateFrame: no defaultPose on '%s'", modelDef->Name() );
+		//gameLocal.Warning( "idAnimator::BuildFrame: no defaultPose on '%s'", modelDef->Name() );
 		return false;
 	}
 
@@ -4424,6 +4534,7 @@ idAnimator::ForceUpdate
 */
 void idAnimator::ForceUpdate( void ) {
 	lastTransformTime = -1;
+	parallelFrameTime = -1;
 	forceUpdate = true;
 }
 
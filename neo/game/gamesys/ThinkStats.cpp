@@ -0,0 +1,485 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "sys/platform.h"
+#include "framework/FileSystem.h"
+#include "Entity.h"
+#include "Game_local.h"
+#include "gamesys/SysCvar.h"
+
+#include "ThinkStats.h"
+
+static const char *thinkStatNames[THINKSTAT_NUM] = { "think", "physics", "present", "script" };
+
+/*
+================
+idThinkStats::idThinkStats
+================
+*/
+idThinkStats::idThinkStats( void ) {
+	active = false;
+	Clear();
+}
+
+/*
+================
+idThinkStats::Clear
+================
+*/
+void idThinkStats::Clear( void ) {
+	for ( int i = 0; i < MAX_GENTITIES; i++ ) {
+		entities[i].spawnId = -1;
+	}
+	classes.Clear();
+	ResetEntry( other, "other", "script outside of thinking" );
+	touched.Clear();
+
+	thinkingEntity = NULL;
+	frameStart = 0.0;
+	frameNum = 0;
+	overBudgetFrames = 0;
+	worstFrame = 0.0;
+	memset( depth, 0, sizeof( depth ) );
+}
+
+/*
+================
+idThinkStats::ResetEntry
+================
+*/
+void idThinkStats::ResetEntry( thinkStats_t &stats, const char *name, const char *className ) {
+	stats.spawnId = -1;
+	stats.name = name;
+	stats.className = className;
+	stats.classNum = -1;
+	stats.frames = 0;
+	stats.lastFrame = -1;
+	stats.overBudget = 0.0;
+	memset( stats.times, 0, sizeof( stats.times ) );
+}
+
+/*
+================
+idThinkStats::BeginFrame
+================
+*/
+void idThinkStats::BeginFrame( void ) {
+	if ( active != ( g_thinkStats.GetInteger() != 0 ) ) {
+		active = !active;
+		Clear();
+	}
+
+	if ( active ) {
+		frameStart = sys->GetMillisecondsPrecise();
+	}
+}
+
+/*
+================
+idThinkStats::AddTime
+================
+*/
+void idThinkStats::AddTime( const idEntity *ent, thinkStat_t stat, double msec ) {
+	thinkStats_t *stats;
+	int num;
+
+	if ( ent == NULL ) {
+		ent = thinkingEntity;
+	}
+
+	if ( ent == NULL ) {
+		stats = &other;
+		num = -1;
+	} else {
+		num = ent->entityNumber;
+		stats = &entities[num];
+		if ( stats->spawnId != gameLocal.spawnIds[num] ) {
+			ResetEntry( *stats, ent->name, ent->GetClassname() );
+			stats->spawnId = gameLocal.spawnIds[num];
+			stats->classNum = ent->GetType()->typeNum;
+		}
+	}
+
+	if ( stats->lastFrame != frameNum ) {
+		stats->lastFrame = frameNum;
+		for ( int i = 0; i < THINKSTAT_NUM; i++ ) {
+			stats->times[i].frame = 0.0;
+		}
+		if ( num >= 0 ) {
+			touched.Append( num );
+		}
+	}
+
+	stats->times[stat].frame += msec;
+}
+
+/*
+================
+idThinkStats::EndFrameEntry
+
+folds the time of the current frame into the totals, the average also decays for entries without time
+================
+*/
+void idThinkStats::EndFrameEntry( thinkStats_t &stats, bool overBudget ) {
+	float frac = gameLocal.msec * 0.001f;
+	bool counted = ( stats.lastFrame == frameNum );
+
+	if ( counted ) {
+		stats.frames++;
+		if ( overBudget ) {
+			stats.overBudget += stats.times[THINKSTAT_THINK].frame;
+		}
+	}
+
+	for ( int i = 0; i < THINKSTAT_NUM; i++ ) {
+		thinkTime_t &time = stats.times[i];
+		double msec = counted ? time.frame : 0.0;
+
+		time.total += msec;
+		time.peak = Max( time.peak, msec );
+		time.average += ( msec - time.average ) * frac;
+		time.frame = 0.0;
+	}
+}
+
+/*
+================
+idThinkStats::EndFrame
+================
+*/
+void idThinkStats::EndFrame( int frameMsec ) {
+	if ( !active ) {
+		return;
+	}
+
+	double msec = sys->GetMillisecondsPrecise() - frameStart;
+	bool overBudget = ( msec > frameMsec );
+	if ( overBudget ) {
+		overBudgetFrames++;
+	}
+	worstFrame = Max( worstFrame, msec );
+
+	// sum up the classes before the entity times are folded in
+	if ( classes.Num() != idClass::GetNumTypes() ) {
+		classes.SetNum( idClass::GetNumTypes() );
+		for ( int i = 0; i < classes.Num(); i++ ) {
+			ResetEntry( classes[i], idClass::GetType( i )->classname, idClass::GetType( i )->classname );
+		}
+	}
+	for ( int i = 0; i < touched.Num(); i++ ) {
+		const thinkStats_t &stats = entities[touched[i]];
+		thinkStats_t &classStats = classes[stats.classNum];
+
+		if ( classStats.lastFrame != frameNum ) {
+			classStats.lastFrame = frameNum;
+			classStats.spawnId = 0;
+		}
+		for ( int j = 0; j < THINKSTAT_NUM; j++ ) {
+			classStats.times[j].frame += stats.times[j].frame;
+		}
+	}
+	touched.SetNum( 0, false );
+
+	for ( int i = 0; i < MAX_GENTITIES; i++ ) {
+		if ( entities[i].spawnId != -1 ) {
+			EndFrameEntry( entities[i], overBudget );
+		}
+	}
+	for ( int i = 0; i < classes.Num(); i++ ) {
+		if ( classes[i].spawnId != -1 ) {
+			EndFrameEntry( classes[i], overBudget );
+		}
+	}
+	EndFrameEntry( other, overBudget );
+
+	frameNum++;
+}
+
+/*
+================
+SortByAverage
+================
+*/
+static thinkStat_t sortStat;
+
+static int SortByAverage( const void *a, const void *b ) {
+	double diff = ( *( const thinkStats_t ** )b )->times[sortStat].average - ( *( const thinkStats_t ** )a )->times[sortStat].average;
+	return ( diff > 0.0 ) ? 1 : ( ( diff < 0.0 ) ? -1 : 0 );
+}
+
+/*
+================
+PrintEntry
+================
+*/
+static void PrintEntry( int num, const thinkStats_t &stats ) {
+	gameLocal.Printf( "%4d %-28.28s %-20.20s %6.3f %6.2f %9.1f %6.3f %6.3f %6.3f %9.1f\n", num, stats.name.c_str(), stats.className,
+		stats.times[THINKSTAT_THINK].average, stats.times[THINKSTAT_THINK].peak, stats.times[THINKSTAT_THINK].total,
+		stats.times[THINKSTAT_PHYSICS].average, stats.times[THINKSTAT_PRESENT].average, stats.times[THINKSTAT_SCRIPT].average,
+		stats.overBudget );
+}
+
+/*
+================
+idThinkStats::Print
+================
+*/
+void idThinkStats::Print( int count, thinkStat_t sortBy ) const {
+	idList<const thinkStats_t *> sorted;
+	int i;
+
+	gameLocal.Printf( "%d game frames, %d took longer than %d msec, the slowest %1.1f msec. sorted by average %s msec per frame:\n",
+		frameNum, overBudgetFrames, gameLocal.msec, worstFrame, thinkStatNames[sortBy] );
+
+	const char *header = "     %-28s %-20s %6s %6s %9s %6s %6s %6s %9s\n";
+
+	sortStat = sortBy;
+
+	for ( i = 0; i < MAX_GENTITIES; i++ ) {
+		if ( entities[i].spawnId != -1 ) {
+			sorted.Append( &entities[i] );
+		}
+	}
+	qsort( sorted.Ptr(), sorted.Num(), sizeof( sorted[0] ), SortByAverage );
+
+	gameLocal.Printf( header, "entity", "class", "think", "peak", "total", "phys", "pres", "script", "overbudg" );
+	for ( i = 0; i < sorted.Num() && i < count; i++ ) {
+		PrintEntry( (int)( sorted[i] - entities ), *sorted[i] );
+	}
+
+	sorted.SetNum( 0, false );
+	for ( i = 0; i < classes.Num(); i++ ) {
+		if ( classes[i].spawnId != -1 ) {
+			sorted.Append( &classes[i] );
+		}
+	}
+	qsort( sorted.Ptr(), sorted.Num(), sizeof( sorted[0] ), SortByAverage );
+
+	gameLocal.Printf( "\n" );
+	gameLocal.Printf( header, "class", "", "think", "peak", "total", "phys", "pres", "script", "overbudg" );
+	for ( i = 0; i < sorted.Num() && i < count; i++ ) {
+		PrintEntry( (int)( sorted[i] - classes.Ptr() ), *sorted[i] );
+	}
+
+	gameLocal.Printf( "\n" );
+	PrintEntry( -1, other );
+}
+
+/*
+================
+idThinkStats::WriteEntry
+================
+*/
+void idThinkStats::WriteEntry( idFile *f, const char *kind, int num, const thinkStats_t &stats ) const {
+	f->Printf( "%s,%d,\"%s\",%s,%d,%.3f", kind, num, stats.name.c_str(), stats.className, stats.frames, stats.overBudget );
+	for ( int i = 0; i < THINKSTAT_NUM; i++ ) {
+		f->Printf( ",%.3f,%.4f,%.3f", stats.times[i].total, ( stats.frames > 0 ) ? stats.times[i].total / stats.frames : 0.0, stats.times[i].peak );
+	}
+	f->Printf( "\n" );
+}
+
+/*
+================
+idThinkStats::WriteCSV
+
+the averages in the file are over the frames the entity thought, not the rolling averages
+================
+*/
+bool idThinkStats::WriteCSV( const char *fileName ) const {
+	idFile *f = fileSystem->OpenFileWrite( fileName );
+	if ( !f ) {
+		gameLocal.Warning( "couldn't open %s", fileName );
+		return false;
+	}
+
+	f->Printf( "kind,number,name,class,frames,overbudget_msec" );
+	for ( int i = 0; i < THINKSTAT_NUM; i++ ) {
+		f->Printf( ",%s_total,%s_avg,%s_peak", thinkStatNames[i], thinkStatNames[i], thinkStatNames[i] );
+	}
+	f->Printf( "\n" );
+
+	for ( int i = 0; i < MAX_GENTITIES; i++ ) {
+		if ( entities[i].spawnId != -1 ) {
+			WriteEntry( f, "entity", i, entities[i] );
+		}
+	}
+	for ( int i = 0; i < classes.Num(); i++ ) {
+		if ( classes[i].spawnId != -1 ) {
+			WriteEntry( f, "class", i, classes[i] );
+		}
+	}
+	WriteEntry( f, "other", -1, other );
+
+	gameLocal.Printf( "wrote think stats of %d frames to %s\n", frameNum, f->GetFullPath() );
+
+	fileSystem->CloseFile( f );
+
+	return true;
+}
+
+/*
+================
+idThinkStats::ListThinkStats_f
+================
+*/
+void idThinkStats::ListThinkStats_f( const idCmdArgs &args ) {
+	int count = 10;
+	thinkStat_t sortBy = THINKSTAT_THINK;
+
+	if ( !gameLocal.thinkStats.IsActive() ) {
+		gameLocal.Printf( "think stats are not recorded, set g_thinkStats 1 first\n" );
+		return;
+	}
+
+	if ( args.Argc() > 1 ) {
+		count = atoi( args.Argv( 1 ) );
+	}
+	if ( args.Argc() > 2 ) {
+		int i;
+		for ( i = 0; i < THINKSTAT_NUM; i++ ) {
+			if ( !idStr::Icmp( args.Argv( 2 ), thinkStatNames[i] ) ) {
+				break;
+			}
+		}
+		if ( i == THINKSTAT_NUM || count < 1 ) {
+			gameLocal.Printf( "usage: listThinkStats [count] [think|physics|present|script]\n" );
+			return;
+		}
+		sortBy = (thinkStat_t)i;
+	}
+
+	gameLocal.thinkStats.Print( count, sortBy );
+}
+
+/*
+================
+idThinkStats::WriteThinkStats_f
+================
+*/
+void idThinkStats::WriteThinkStats_f( const idCmdArgs &args ) {
+	idStr fileName;
+
+	if ( !gameLocal.thinkStats.IsActive() ) {
+		gameLocal.Printf( "think stats are not recorded, set g_thinkStats 1 first\n" );
+		return;
+	}
+
+	if ( args.Argc() > 1 ) {
+		fileName = args.Argv( 1 );
+		fileName.DefaultFileExtension( ".csv" );
+	} else {
+		gameLocal.thinkStats.GetMapFileName( fileName );
+	}
+
+	gameLocal.thinkStats.WriteCSV( fileName );
+}
+
+/*
+================
+idThinkStats::GetMapFileName
+================
+*/
+void idThinkStats::GetMapFileName( idStr &fileName ) const {
+	idStr mapName = gameLocal.GetMapName();
+
+	mapName.StripPath();
+	mapName.StripFileExtension();
+	fileName = "thinkstats/" + mapName + ".csv";
+}
+
+/*
+================
+idThinkStats::MapShutdown
+================
+*/
+void idThinkStats::MapShutdown( void ) {
+	if ( active && g_thinkStats.GetInteger() == 2 && frameNum > 0 ) {
+		idStr fileName;
+		GetMapFileName( fileName );
+		WriteCSV( fileName );
+	}
+	Clear();
+}
+
+/*
+===============================================================================
+
+	idThinkStatsScope
+
+===============================================================================
+*/
+
+/*
+================
+idThinkStatsScope::idThinkStatsScope
+================
+*/
+idThinkStatsScope::idThinkStatsScope( const idEntity *ent, thinkStat_t stat ) {
+	idThinkStats &stats = gameLocal.thinkStats;
+
+	this->ent = ent;
+	this->stat = stat;
+	oldThinkingEntity = NULL;
+	counted = false;
+	start = -1.0;
+
+	if ( !stats.active ) {
+		return;
+	}
+
+	if ( stats.depth[stat]++ == 0 ) {
+		start = sys->GetMillisecondsPrecise();
+	}
+	if ( stat == THINKSTAT_THINK ) {
+		oldThinkingEntity = stats.thinkingEntity;
+		stats.thinkingEntity = ent;
+	}
+	counted = true;
+}
+
+/*
+================
+idThinkStatsScope::~idThinkStatsScope
+================
+*/
+idThinkStatsScope::~idThinkStatsScope( void ) {
+	idThinkStats &stats = gameLocal.thinkStats;
+
+	if ( !counted ) {
+		return;
+	}
+
+	if ( start >= 0.0 ) {
+		// script time goes to the thinking entity, which is still set during its think
+		stats.AddTime( ent, stat, sys->GetMillisecondsPrecise() - start );
+	}
+	stats.depth[stat]--;
+	if ( stat == THINKSTAT_THINK ) {
+		stats.thinkingEntity = oldThinkingEntity;
+	}
+}
@@ -0,0 +1,151 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __THINKSTATS_H__
+#define __THINKSTATS_H__
+
+#include "idlib/containers/List.h"
+#include "idlib/CmdArgs.h"
+#include "idlib/Str.h"
+#include "GameBase.h"
+
+/*
+===============================================================================
+
+	Think cost accounting
+
+	While g_thinkStats is set, the time every entity spends in Think(),
+	RunPhysics(), Present() and in the script it executes while thinking
+	is measured. Think() includes the other three. For each entity and each
+	entity class the total, the slowest frame and an average over about the
+	last second of game frames are kept, along with the think time spent in
+	game frames that took longer than their msec.
+
+	Stats of an entity are dropped when its entity number is reused, they
+	are still counted for its class.
+
+===============================================================================
+*/
+
+class idEntity;
+class idFile;
+
+typedef enum {
+	THINKSTAT_THINK,
+	THINKSTAT_PHYSICS,
+	THINKSTAT_PRESENT,
+	THINKSTAT_SCRIPT,
+	THINKSTAT_NUM
+} thinkStat_t;
+
+typedef struct {
+	double					total;
+	double					peak;				// most in one frame
+	double					average;			// per frame, decays over about a second
+	double					frame;				// so far in the current frame
+} thinkTime_t;
+
+typedef struct {
+	int						spawnId;			// -1 if not used
+	idStr					name;
+	const char *			className;
+	int						classNum;			// idTypeInfo::typeNum
+	int						frames;				// frames with think time
+	int						lastFrame;			// last frame with any time
+	double					overBudget;			// think msec in frames that took too long
+	thinkTime_t				times[THINKSTAT_NUM];
+} thinkStats_t;
+
+class idThinkStats {
+public:
+							idThinkStats( void );
+
+	void					Clear( void );
+	bool					IsActive( void ) const { return active; }
+
+							// around the entity and event processing of a game frame
+	void					BeginFrame( void );
+	void					EndFrame( int frameMsec );
+							// writes the CSV file of the map with g_thinkStats 2 and clears the stats
+	void					MapShutdown( void );
+
+							// script time goes to the thinking entity, or to "other" when nobody thinks
+	void					AddTime( const idEntity *ent, thinkStat_t stat, double msec );
+
+	void					Print( int count, thinkStat_t sortBy ) const;
+	bool					WriteCSV( const char *fileName ) const;
+							// thinkstats/<map>.csv
+	void					GetMapFileName( idStr &fileName ) const;
+
+	static void				ListThinkStats_f( const idCmdArgs &args );
+	static void				WriteThinkStats_f( const idCmdArgs &args );
+
+private:
+	friend class idThinkStatsScope;
+
+	bool					active;
+	const idEntity *		thinkingEntity;
+	double					frameStart;
+	int						frameNum;			// game frames since Clear()
+	int						overBudgetFrames;
+	double					worstFrame;
+	int						depth[THINKSTAT_NUM];	// only the outermost of nested scopes is timed
+
+	thinkStats_t			entities[MAX_GENTITIES];
+	idList<thinkStats_t>	classes;			// indexed by idTypeInfo::typeNum
+	thinkStats_t			other;				// script outside of thinking
+	idList<int>				touched;			// entity numbers with time in the current frame
+
+	void					ResetEntry( thinkStats_t &stats, const char *name, const char *className );
+	void					EndFrameEntry( thinkStats_t &stats, bool overBudget );
+	void					WriteEntry( idFile *f, const char *kind, int num, const thinkStats_t &stats ) const;
+};
+
+/*
+===============================================================================
+
+	Times a scope while the think stats are active, use
+	idThinkStatsScope thinkStatsScope( this, THINKSTAT_PHYSICS );
+
+===============================================================================
+*/
+
+class idThinkStatsScope {
+public:
+							idThinkStatsScope( const idEntity *ent, thinkStat_t stat );
+							~idThinkStatsScope( void );
+
+private:
+	const idEntity *		ent;
+	const idEntity *		oldThinkingEntity;
+	thinkStat_t				stat;
+	bool					counted;			// depth was increased
+	double					start;				// < 0 if not timed
+};
+
+#endif /* !__THINKSTATS_H__ */
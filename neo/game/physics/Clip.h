@@ -31,6 +31,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "idlib/geometry/TraceModel.h"
 #include "cm/CollisionModel.h"
+#include "sys/sys_jobs.h"
 
 class idSaveGame;
 class idRestoreGame;
@@ -250,6 +251,29 @@ ID_INLINE const idTraceModel *idClipModel::GetTraceModel( void ) const {
 //
 //===============================================================
 
+// one query of idClip::TranslationBatch() or idClip::ContentsBatch()
+typedef struct clipTraceQuery_s {
+	idVec3					start;
+	idVec3					end;					// not used by ContentsBatch()
+	const idClipModel *		mdl;					// NULL for point traces
+	idMat3					trmAxis;
+	int						contentMask;
+	const idEntity *		passEntity;
+} clipTraceQuery_t;
+
+typedef struct clipBatchTouch_s {
+	int						query;
+	idClipModel *			clipModel;
+} clipBatchTouch_t;
+
+// a range of batch queries traced in a job
+typedef struct clipBatchJob_s {
+	class idClip *			clip;
+	int						firstQuery;
+	int						numQueries;
+	int						numTraces;				// collision model traces, added to the statistics afterwards
+} clipBatchJob_t;
+
 class idClip {
 
 	friend class idClipModel;
@@ -272,6 +296,13 @@ public:
 	int						Contents( const idVec3 &start,
 								const idClipModel *mdl, const idMat3 &trmAxis, int contentMask, const idEntity *passEntity );
 
+	// many queries at once, the clip sectors are walked only once for all of them.
+	// the results are the same as calling Translation() or Contents() for each query.
+	// large batches are traced in parallel jobs if g_parallelTraces is set.
+	// TranslationBatch() returns the number of traces that hit something
+	int						TranslationBatch( trace_t *results, const clipTraceQuery_t *queries, const int numQueries );
+	void					ContentsBatch( int *contents, const clipTraceQuery_t *queries, const int numQueries );
+
 	// special case translations versus the rest of the world
 	bool					TracePoint( trace_t &results, const idVec3 &start, const idVec3 &end,
 								int contentMask, const idEntity *passEntity );
@@ -325,12 +356,39 @@ private:
 	int						numRenderModelTraces;
 	int						numContents;
 	int						numContacts;
+	int						numBatchQueries;
+	idList<idBounds>		batchBounds;			// per query, to find the clip models
+	idList<int>				batchMasks;				// per query, contents of the clip models to find
+	idList<int>				batchQueryStack;		// queries per sector while walking the sectors
+	idList<clipBatchTouch_t> batchTouches;			// clip models touched by the queries, sorted by query
+	idList<clipBatchTouch_t> batchSortedTouches;
+	idList<int>				batchFirstTouch;		// per query, index into batchTouches
+	idList<const idTraceModel *> batchTrms;			// per query, NULL for point traces
+	idList<bool>			batchDone;				// per query, set once the query is traced
+	const clipTraceQuery_t *batchQueries;			// the batch being traced
+	trace_t *				batchResults;
+	int *					batchContents;
+	idList<clipBatchJob_t>	batchJobs;
+	idParallelJobList *		batchJobList;
 
 private:
 	struct clipSector_s *	CreateClipSectors_r( const int depth, const idBounds &bounds, idVec3 &maxSector );
 	void					ClipModelsTouchingBounds_r( const struct clipSector_s *node, struct listParms_s &parms ) const;
 	const idTraceModel *	TraceModelForClipModel( const idClipModel *mdl ) const;
 	int						GetTraceClipModels( const idBounds &bounds, int contentMask, const idEntity *passEntity, idClipModel **clipModelList ) const;
+	void					TranslationClipModels( trace_t &results, const idVec3 &start, const idVec3 &end, const idTraceModel *trm, const idMat3 &trmAxis,
+								int contentMask, idClipModel **clipModelList, const int num, int &numTraces );
+	int						ContentsClipModels( int contents, const idVec3 &start, const idTraceModel *trm, const idMat3 &trmAxis,
+								int contentMask, idClipModel **clipModelList, const int num, int &numTraces );
+	void					GetBatchClipModels( const int numQueries );
+	void					GetBatchClipModels_r( const struct clipSector_s *node, const int first, const int num );
+	int						GetBatchTraceClipModels( const int query, const idBounds &bounds, const idEntity *passEntity, idClipModel **clipModelList ) const;
+	bool					BatchTouchesRenderModel( const int query ) const;
+	int						RunBatchJobs( jobRun_t function, const int numQueries );
+	void					TranslationBatchQuery( const int query, const bool inJob, int &numTraces );
+	void					ContentsBatchQuery( const int query, int &numTraces );
+	static void				TranslationBatchJob( clipBatchJob_t *job );
+	static void				ContentsBatchJob( clipBatchJob_t *job );
 	void					TraceRenderModel( trace_t &trace, const idVec3 &start, const idVec3 &end, const float radius, const idMat3 &axis, idClipModel *touch ) const;
 };
 
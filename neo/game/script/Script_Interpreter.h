@@ -81,11 +81,14 @@ private:
 	void				CallEvent( const function_t *func, int argsize );
 	void				CallSysEvent( const function_t *func, int argsize );
 
+	int					ExecuteLowered( int runaway );
+
 public:
 	bool				doneProcessing;
 	bool				threadDying;
 	bool				terminateOnExit;
 	bool				debug;
+	int					instructionsExecuted;	// statements of the last Execute, never more than the runaway limit
 
 						idInterpreter();
 
@@ -0,0 +1,403 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "sys/platform.h"
+#include "framework/FileSystem.h"
+#include "gamesys/SysCvar.h"
+#include "Game_local.h"
+#include "script/Script_Thread.h"
+
+#include "Script_Profiler.h"
+
+static const char *scriptProfileSortNames[SCRIPTPROFILE_NUM] = { "time", "instructions", "calls" };
+
+/*
+================
+idScriptProfiler::idScriptProfiler
+================
+*/
+idScriptProfiler::idScriptProfiler( void ) {
+	active = false;
+	Clear();
+}
+
+/*
+================
+idScriptProfiler::Clear
+================
+*/
+void idScriptProfiler::Clear( void ) {
+	frameNum = 0;
+	timedFunction = NULL;
+	timedStart = 0.0;
+	functions.Clear();
+	threads.Clear();
+	threadHash.Free();
+	events.Clear();
+	sysEvents.Clear();
+}
+
+/*
+================
+ResetEntry
+================
+*/
+static void ResetEntry( scriptProfile_t &entry, const char *name, int num ) {
+	entry.name = name;
+	entry.num = num;
+	entry.calls = 0;
+	entry.instructions = 0.0;
+	entry.msec = 0.0;
+	entry.peak = 0.0;
+}
+
+/*
+================
+idScriptProfiler::BeginFrame
+================
+*/
+void idScriptProfiler::BeginFrame( void ) {
+	if ( active != ( g_scriptProfile.GetInteger() != 0 ) ) {
+		active = !active;
+		Clear();
+	}
+
+	if ( active ) {
+		// no script runs between frames, this also drops a function left timed by a script error
+		timedFunction = NULL;
+		frameNum++;
+	}
+}
+
+/*
+================
+idScriptProfiler::FunctionEntry
+================
+*/
+scriptProfile_t &idScriptProfiler::FunctionEntry( const function_t *func ) {
+	int num = gameLocal.program.GetFunctionIndex( func );
+
+	if ( num >= functions.Num() ) {
+		int oldNum = functions.Num();
+		functions.SetNum( num + 1 );
+		for ( int i = oldNum; i < functions.Num(); i++ ) {
+			ResetEntry( functions[i], "", i );
+		}
+	}
+
+	scriptProfile_t &entry = functions[num];
+	if ( !entry.name.Length() ) {
+		entry.name = func->Name();
+	}
+	return entry;
+}
+
+/*
+================
+idScriptProfiler::SwitchFunction
+================
+*/
+const function_t *idScriptProfiler::SwitchFunction( const function_t *func ) {
+	const function_t *oldFunction = timedFunction;
+	double now = sys->GetMillisecondsPrecise();
+
+	if ( oldFunction ) {
+		FunctionEntry( oldFunction ).msec += now - timedStart;
+	}
+	timedFunction = func;
+	timedStart = now;
+
+	return oldFunction;
+}
+
+/*
+================
+idScriptProfiler::AddFunctionCall
+================
+*/
+void idScriptProfiler::AddFunctionCall( const function_t *func ) {
+	FunctionEntry( func ).calls++;
+}
+
+/*
+================
+idScriptProfiler::AddInstructions
+================
+*/
+void idScriptProfiler::AddInstructions( const function_t *func, int instructions ) {
+	if ( func ) {
+		FunctionEntry( func ).instructions += instructions;
+	}
+}
+
+/*
+================
+idScriptProfiler::AddThread
+
+the name is the one the thread had when it first ran
+================
+*/
+void idScriptProfiler::AddThread( idThread *thread, int instructions, double msec ) {
+	int num = thread->GetThreadNum();
+	int i;
+
+	for ( i = threadHash.First( num ); i != -1; i = threadHash.Next( i ) ) {
+		if ( threads[i].num == num ) {
+			break;
+		}
+	}
+	if ( i == -1 ) {
+		i = threads.Num();
+		ResetEntry( threads.Alloc(), thread->GetThreadName(), num );
+		threadHash.Add( num, i );
+	}
+
+	scriptProfile_t &entry = threads[i];
+	entry.calls++;
+	entry.instructions += instructions;
+	entry.msec += msec;
+	entry.peak = Max( entry.peak, msec );
+}
+
+/*
+================
+idScriptProfiler::AddEvent
+================
+*/
+void idScriptProfiler::AddEvent( const idEventDef *evdef, bool sysEvent, double msec ) {
+	idList<scriptProfile_t> &list = sysEvent ? sysEvents : events;
+	int num = evdef->GetEventNum();
+
+	if ( num >= list.Num() ) {
+		int oldNum = list.Num();
+		list.SetNum( idEventDef::NumEventCommands() );
+		for ( int i = oldNum; i < list.Num(); i++ ) {
+			ResetEntry( list[i], idEventDef::GetEventCommand( i )->GetName(), i );
+		}
+	}
+
+	scriptProfile_t &entry = list[num];
+	entry.calls++;
+	entry.msec += msec;
+	entry.peak = Max( entry.peak, msec );
+}
+
+/*
+================
+SortProfile
+================
+*/
+static scriptProfileSort_t profileSortBy;
+
+static int SortProfile( const void *a, const void *b ) {
+	const scriptProfile_t *ea = *( const scriptProfile_t ** )a;
+	const scriptProfile_t *eb = *( const scriptProfile_t ** )b;
+	double diff;
+
+	switch( profileSortBy ) {
+	case SCRIPTPROFILE_INSTRUCTIONS:
+		diff = eb->instructions - ea->instructions;
+		break;
+	case SCRIPTPROFILE_CALLS:
+		diff = eb->calls - ea->calls;
+		break;
+	default:
+		diff = eb->msec - ea->msec;
+		break;
+	}
+	return ( diff > 0.0 ) ? 1 : ( ( diff < 0.0 ) ? -1 : 0 );
+}
+
+/*
+================
+idScriptProfiler::PrintList
+================
+*/
+void idScriptProfiler::PrintList( const idList<scriptProfile_t> &list, const char *kind, int count, scriptProfileSort_t sortBy ) const {
+	idList<const scriptProfile_t *> sorted;
+	int i;
+
+	for ( i = 0; i < list.Num(); i++ ) {
+		if ( list[i].calls > 0 || list[i].msec > 0.0 ) {
+			sorted.Append( &list[i] );
+		}
+	}
+	profileSortBy = sortBy;
+	qsort( sorted.Ptr(), sorted.Num(), sizeof( sorted[0] ), SortProfile );
+
+	gameLocal.Printf( "     %-40s %8s %12s %9s %7s %7s\n", kind, "calls", "instructions", "msec", "msec/fr", "peak" );
+	for ( i = 0; i < sorted.Num() && i < count; i++ ) {
+		const scriptProfile_t &entry = *sorted[i];
+		gameLocal.Printf( "%4d %-40.40s %8d %12.0f %9.1f %7.3f %7.2f\n", entry.num, entry.name.c_str(), entry.calls, entry.instructions,
+			entry.msec, ( frameNum > 0 ) ? entry.msec / frameNum : 0.0, entry.peak );
+	}
+	if ( sorted.Num() > count ) {
+		gameLocal.Printf( "     ... %d more\n", sorted.Num() - count );
+	}
+}
+
+/*
+================
+idScriptProfiler::Print
+================
+*/
+void idScriptProfiler::Print( int count, scriptProfileSort_t sortBy ) const {
+	gameLocal.Printf( "%d game frames, sorted by %s:\n", frameNum, scriptProfileSortNames[sortBy] );
+
+	PrintList( functions, "function", count, sortBy );
+	gameLocal.Printf( "\n" );
+	PrintList( threads, "thread", count, sortBy );
+	gameLocal.Printf( "\n" );
+	PrintList( events, "event", count, sortBy );
+	gameLocal.Printf( "\n" );
+	PrintList( sysEvents, "sys event", count, sortBy );
+}
+
+/*
+================
+idScriptProfiler::WriteList
+================
+*/
+void idScriptProfiler::WriteList( idFile *f, const idList<scriptProfile_t> &list, const char *kind ) const {
+	for ( int i = 0; i < list.Num(); i++ ) {
+		const scriptProfile_t &entry = list[i];
+		if ( entry.calls > 0 || entry.msec > 0.0 ) {
+			f->Printf( "%s,%d,\"%s\",%d,%.0f,%.3f,%.4f,%.3f\n", kind, entry.num, entry.name.c_str(), entry.calls, entry.instructions,
+				entry.msec, ( frameNum > 0 ) ? entry.msec / frameNum : 0.0, entry.peak );
+		}
+	}
+}
+
+/*
+================
+idScriptProfiler::WriteCSV
+================
+*/
+bool idScriptProfiler::WriteCSV( const char *fileName ) const {
+	idFile *f = fileSystem->OpenFileWrite( fileName );
+	if ( !f ) {
+		gameLocal.Warning( "couldn't open %s", fileName );
+		return false;
+	}
+
+	f->Printf( "kind,number,name,calls,instructions,msec,msec_per_frame,peak_msec\n" );
+	WriteList( f, functions, "function" );
+	WriteList( f, threads, "thread" );
+	WriteList( f, events, "event" );
+	WriteList( f, sysEvents, "sysevent" );
+
+	gameLocal.Printf( "wrote script profile of %d frames to %s\n", frameNum, f->GetFullPath() );
+
+	fileSystem->CloseFile( f );
+
+	return true;
+}
+
+/*
+================
+idScriptProfiler::ListScriptProfile_f
+================
+*/
+void idScriptProfiler::ListScriptProfile_f( const idCmdArgs &args ) {
+	int count = 10;
+	scriptProfileSort_t sortBy = SCRIPTPROFILE_TIME;
+
+	if ( !gameLocal.scriptProfiler.IsActive() ) {
+		gameLocal.Printf( "script profile is not recorded, set g_scriptProfile 1 first\n" );
+		return;
+	}
+
+	if ( args.Argc() > 1 ) {
+		count = atoi( args.Argv( 1 ) );
+	}
+	if ( args.Argc() > 2 ) {
+		int i;
+		for ( i = 0; i < SCRIPTPROFILE_NUM; i++ ) {
+			if ( !idStr::Icmp( args.Argv( 2 ), scriptProfileSortNames[i] ) ) {
+				break;
+			}
+		}
+		if ( i == SCRIPTPROFILE_NUM || count < 1 ) {
+			gameLocal.Printf( "usage: listScriptProfile [count] [time|instructions|calls]\n" );
+			return;
+		}
+		sortBy = (scriptProfileSort_t)i;
+	}
+
+	gameLocal.scriptProfiler.Print( count, sortBy );
+}
+
+/*
+================
+idScriptProfiler::WriteScriptProfile_f
+================
+*/
+void idScriptProfiler::WriteScriptProfile_f( const idCmdArgs &args ) {
+	idStr fileName;
+
+	if ( !gameLocal.scriptProfiler.IsActive() ) {
+		gameLocal.Printf( "script profile is not recorded, set g_scriptProfile 1 first\n" );
+		return;
+	}
+
+	if ( args.Argc() > 1 ) {
+		fileName = args.Argv( 1 );
+		fileName.DefaultFileExtension( ".csv" );
+	} else {
+		gameLocal.scriptProfiler.GetMapFileName( fileName );
+	}
+
+	gameLocal.scriptProfiler.WriteCSV( fileName );
+}
+
+/*
+================
+idScriptProfiler::GetMapFileName
+================
+*/
+void idScriptProfiler::GetMapFileName( idStr &fileName ) const {
+	idStr mapName = gameLocal.GetMapName();
+
+	mapName.StripPath();
+	mapName.StripFileExtension();
+	fileName = "scriptprofile/" + mapName + ".csv";
+}
+
+/*
+================
+idScriptProfiler::MapShutdown
+================
+*/
+void idScriptProfiler::MapShutdown( void ) {
+	if ( active && g_scriptProfile.GetInteger() == 2 && frameNum > 0 ) {
+		idStr fileName;
+		GetMapFileName( fileName );
+		WriteCSV( fileName );
+	}
+	Clear();
+}
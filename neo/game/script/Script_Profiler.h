@@ -0,0 +1,126 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+
+#ifndef __SCRIPT_PROFILER_H__
+#define __SCRIPT_PROFILER_H__
+
+#include "idlib/containers/List.h"
+#include "idlib/containers/HashIndex.h"
+#include "idlib/CmdArgs.h"
+#include "idlib/Str.h"
+
+/*
+===============================================================================
+
+	Script profiler
+
+	While g_scriptProfile is set, the interpreter counts the statements
+	executed and the time spent in every script function, every idThread
+	and every event called from script, events called on sys are listed
+	separately.
+
+	Function time is exclusive: it stops while the function calls another
+	script function or while an event it called runs another thread, but
+	it includes the time of the events the function calls itself. Thread
+	and event times include everything that runs during them.
+
+	The stats are kept until the map ends, function stats are indexed by
+	the function number of the program.
+
+===============================================================================
+*/
+
+class idThread;
+class idEventDef;
+class idFile;
+class function_t;
+
+typedef enum {
+	SCRIPTPROFILE_TIME,
+	SCRIPTPROFILE_INSTRUCTIONS,
+	SCRIPTPROFILE_CALLS,
+	SCRIPTPROFILE_NUM
+} scriptProfileSort_t;
+
+typedef struct {
+	idStr					name;				// empty if not used
+	int						num;				// function, thread or event number
+	int						calls;				// function calls, thread executions or event dispatches
+	double					instructions;		// statements, not counted for events
+	double					msec;
+	double					peak;				// most msec in one thread execution or event dispatch, not kept for functions
+} scriptProfile_t;
+
+class idScriptProfiler {
+public:
+							idScriptProfiler( void );
+
+	void					Clear( void );
+	bool					IsActive( void ) const { return active; }
+
+							// before the entity and event processing of a game frame
+	void					BeginFrame( void );
+							// writes the CSV file of the map with g_scriptProfile 2 and clears the stats
+	void					MapShutdown( void );
+
+							// called by the interpreter, the function being timed changes to func
+							// and the previously timed function is returned
+	const function_t *		SwitchFunction( const function_t *func );
+	void					AddFunctionCall( const function_t *func );
+	void					AddInstructions( const function_t *func, int instructions );
+	void					AddThread( idThread *thread, int instructions, double msec );
+	void					AddEvent( const idEventDef *evdef, bool sysEvent, double msec );
+
+	void					Print( int count, scriptProfileSort_t sortBy ) const;
+	bool					WriteCSV( const char *fileName ) const;
+							// scriptprofile/<map>.csv
+	void					GetMapFileName( idStr &fileName ) const;
+
+	static void				ListScriptProfile_f( const idCmdArgs &args );
+	static void				WriteScriptProfile_f( const idCmdArgs &args );
+
+private:
+	bool					active;
+	int						frameNum;			// game frames since Clear()
+
+	const function_t *		timedFunction;
+	double					timedStart;
+
+	idList<scriptProfile_t>	functions;			// indexed by function number
+	idList<scriptProfile_t>	threads;
+	idHashIndex				threadHash;			// thread number to index in threads
+	idList<scriptProfile_t>	events;				// called on entities, indexed by event number
+	idList<scriptProfile_t>	sysEvents;			// called on sys, indexed by event number
+
+	scriptProfile_t &		FunctionEntry( const function_t *func );
+	void					PrintList( const idList<scriptProfile_t> &list, const char *kind, int count, scriptProfileSort_t sortBy ) const;
+	void					WriteList( idFile *f, const idList<scriptProfile_t> &list, const char *kind ) const;
+};
+
+#endif /* !__SCRIPT_PROFILER_H__ */
@@ -1651,6 +1651,8 @@ void idProgram::BeginCompilation( void ) {
 
 	FreeData();
 
+	programKey = StartProgramKey();
+
 	try {
 		// make the first statement a return for a "NULL" function
 		statement = AllocStatement();
@@ -1752,11 +1754,15 @@ Called after all files are compiled to check for errors
 void idProgram::FinishCompilation( void ) {
 	int	i;
 
+	// the statements from BeginCompilation
+	LowerStatements( true );
+
 	top_functions	= functions.Num();
 	top_statements	= statements.Num();
 	top_types		= types.Num();
 	top_defs		= varDefs.Num();
 	top_files		= fileList.Num();
+	top_programKey	= programKey;
 
 	variableDefaults.Clear();
 	variableDefaults.SetNum( numVariables );
@@ -1820,6 +1826,231 @@ void idProgram::CompileStats( void ) {
 	gameLocal.Printf( " Thread size: %zd bytes\n", sizeof( idThread ) );
 }
 
+/*
+==============
+idProgram::LowerOperand
+
+Returns false if the operand isn't a stack variable or a global
+==============
+*/
+bool idProgram::LowerOperand( const idVarDef *def, int &operand ) const {
+	if ( !def ) {
+		return false;
+	}
+
+	if ( def->initialized == idVarDef::stackVariable ) {
+		operand = ( def->value.stackOffset << 1 ) | SCRIPT_OPERAND_LOCAL;
+		return true;
+	}
+
+	if ( def->value.bytePtr < variables || def->value.bytePtr >= &variables[ MAX_GLOBALS ] ) {
+		return false;
+	}
+
+	operand = ( def->value.bytePtr - variables ) << 1;
+	return true;
+}
+
+#define LOWER_A			1
+#define LOWER_B			2
+#define LOWER_C			4
+#define LOWER_FIELD		8		// the object field offset of b
+#define LOWER_JUMP_A	16
+#define LOWER_JUMP_B	32
+
+typedef struct {
+	int		op;
+	int		sop;
+	int		operands;
+} loweredOp_t;
+
+static const loweredOp_t loweredOps[] = {
+	{ OP_GOTO,				SOP_GOTO,			LOWER_JUMP_A },
+	{ OP_IF,				SOP_IF,				LOWER_A | LOWER_JUMP_B },
+	{ OP_IFNOT,				SOP_IFNOT,			LOWER_A | LOWER_JUMP_B },
+
+	{ OP_ADD_F,				SOP_ADD_F,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_ADD_V,				SOP_ADD_V,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_SUB_F,				SOP_SUB_F,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_SUB_V,				SOP_SUB_V,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_MUL_F,				SOP_MUL_F,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_MUL_V,				SOP_MUL_V,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_MUL_FV,			SOP_MUL_FV,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_MUL_VF,			SOP_MUL_VF,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_DIV_F,				SOP_DIV_F,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_MOD_F,				SOP_MOD_F,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_BITAND,			SOP_BITAND,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_BITOR,				SOP_BITOR,			LOWER_A | LOWER_B | LOWER_C },
+
+	{ OP_GE,				SOP_GE,				LOWER_A | LOWER_B | LOWER_C },
+	{ OP_LE,				SOP_LE,				LOWER_A | LOWER_B | LOWER_C },
+	{ OP_GT,				SOP_GT,				LOWER_A | LOWER_B | LOWER_C },
+	{ OP_LT,				SOP_LT,				LOWER_A | LOWER_B | LOWER_C },
+	{ OP_EQ_F,				SOP_EQ_F,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_NE_F,				SOP_NE_F,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_EQ_E,				SOP_EQ_E,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_EQ_EO,				SOP_EQ_E,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_EQ_OE,				SOP_EQ_E,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_EQ_OO,				SOP_EQ_E,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_NE_E,				SOP_NE_E,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_NE_EO,				SOP_NE_E,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_NE_OE,				SOP_NE_E,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_NE_OO,				SOP_NE_E,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_EQ_V,				SOP_EQ_V,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_NE_V,				SOP_NE_V,			LOWER_A | LOWER_B | LOWER_C },
+
+	{ OP_AND,				SOP_AND,			LOWER_A | LOWER_B | LOWER_C },
+	{ OP_AND_BOOLF,			SOP_AND_BOOLF,		LOWER_A | LOWER_B | LOWER_C },
+	{ OP_AND_FBOOL,			SOP_AND_FBOOL,		LOWER_A | LOWER_B | LOWER_C },
+	{ OP_AND_BOOLBOOL,		SOP_AND_BOOLBOOL,	LOWER_A | LOWER_B | LOWER_C },
+	{ OP_OR,				SOP_OR,				LOWER_A | LOWER_B | LOWER_C },
+	{ OP_OR_BOOLF,			SOP_OR_BOOLF,		LOWER_A | LOWER_B | LOWER_C },
+	{ OP_OR_FBOOL,			SOP_OR_FBOOL,		LOWER_A | LOWER_B | LOWER_C },
+	{ OP_OR_BOOLBOOL,		SOP_OR_BOOLBOOL,	LOWER_A | LOWER_B | LOWER_C },
+
+	{ OP_NOT_BOOL,			SOP_NOT_BOOL,		LOWER_A | LOWER_C },
+	{ OP_NOT_F,				SOP_NOT_F,			LOWER_A | LOWER_C },
+	{ OP_NOT_V,				SOP_NOT_V,			LOWER_A | LOWER_C },
+	{ OP_NOT_ENT,			SOP_NOT_ENT,		LOWER_A | LOWER_C },
+	{ OP_NEG_F,				SOP_NEG_F,			LOWER_A | LOWER_C },
+	{ OP_NEG_V,				SOP_NEG_V,			LOWER_A | LOWER_C },
+	{ OP_INT_F,				SOP_INT_F,			LOWER_A | LOWER_C },
+	{ OP_COMP_F,			SOP_COMP_F,			LOWER_A | LOWER_C },
+
+	{ OP_UADD_F,			SOP_UADD_F,			LOWER_A | LOWER_B },
+	{ OP_UADD_V,			SOP_UADD_V,			LOWER_A | LOWER_B },
+	{ OP_USUB_F,			SOP_USUB_F,			LOWER_A | LOWER_B },
+	{ OP_USUB_V,			SOP_USUB_V,			LOWER_A | LOWER_B },
+	{ OP_UMUL_F,			SOP_UMUL_F,			LOWER_A | LOWER_B },
+	{ OP_UMUL_V,			SOP_UMUL_V,			LOWER_A | LOWER_B },
+	{ OP_UOR_F,				SOP_UOR_F,			LOWER_A | LOWER_B },
+	{ OP_UAND_F,			SOP_UAND_F,			LOWER_A | LOWER_B },
+	{ OP_UINC_F,			SOP_UINC_F,			LOWER_A },
+	{ OP_UDEC_F,			SOP_UDEC_F,			LOWER_A },
+	{ OP_UINCP_F,			SOP_UINCP_F,		LOWER_A | LOWER_FIELD },
+	{ OP_UDECP_F,			SOP_UDECP_F,		LOWER_A | LOWER_FIELD },
+
+	{ OP_STORE_F,			SOP_STORE_INT,		LOWER_A | LOWER_B },
+	{ OP_STORE_ENT,			SOP_STORE_INT,		LOWER_A | LOWER_B },
+	{ OP_STORE_BOOL,		SOP_STORE_INT,		LOWER_A | LOWER_B },
+	{ OP_STORE_OBJ,			SOP_STORE_INT,		LOWER_A | LOWER_B },
+	{ OP_STORE_ENTOBJ,		SOP_STORE_INT,		LOWER_A | LOWER_B },
+	{ OP_STORE_V,			SOP_STORE_V,		LOWER_A | LOWER_B },
+	{ OP_STORE_FTOBOOL,		SOP_STORE_FTOBOOL,	LOWER_A | LOWER_B },
+	{ OP_STORE_BOOLTOF,		SOP_STORE_BOOLTOF,	LOWER_A | LOWER_B },
+	{ OP_STOREP_F,			SOP_STOREP_INT,		LOWER_A | LOWER_B },
+	{ OP_STOREP_ENT,		SOP_STOREP_INT,		LOWER_A | LOWER_B },
+	{ OP_STOREP_FLD,		SOP_STOREP_INT,		LOWER_A | LOWER_B },
+	{ OP_STOREP_BOOL,		SOP_STOREP_INT,		LOWER_A | LOWER_B },
+	{ OP_STOREP_OBJ,		SOP_STOREP_INT,		LOWER_A | LOWER_B },
+	{ OP_STOREP_V,			SOP_STOREP_V,		LOWER_A | LOWER_B },
+	{ OP_STOREP_FTOBOOL,	SOP_STOREP_FTOBOOL,	LOWER_A | LOWER_B },
+	{ OP_STOREP_BOOLTOF,	SOP_STOREP_BOOLTOF,	LOWER_A | LOWER_B },
+
+	{ OP_ADDRESS,			SOP_ADDRESS,		LOWER_A | LOWER_FIELD | LOWER_C },
+	{ OP_INDIRECT_F,		SOP_INDIRECT_INT,	LOWER_A | LOWER_FIELD | LOWER_C },
+	{ OP_INDIRECT_ENT,		SOP_INDIRECT_INT,	LOWER_A | LOWER_FIELD | LOWER_C },
+	{ OP_INDIRECT_BOOL,		SOP_INDIRECT_INT,	LOWER_A | LOWER_FIELD | LOWER_C },
+	{ OP_INDIRECT_OBJ,		SOP_INDIRECT_INT,	LOWER_A | LOWER_FIELD | LOWER_C },
+	{ OP_INDIRECT_V,		SOP_INDIRECT_V,		LOWER_A | LOWER_FIELD | LOWER_C },
+
+	{ OP_PUSH_F,			SOP_PUSH_INT,		LOWER_A },
+	{ OP_PUSH_ENT,			SOP_PUSH_INT,		LOWER_A },
+	{ OP_PUSH_OBJ,			SOP_PUSH_INT,		LOWER_A },
+	{ OP_PUSH_OBJENT,		SOP_PUSH_INT,		LOWER_A },
+	{ OP_PUSH_V,			SOP_PUSH_V,			LOWER_A },
+	{ OP_PUSH_BTOF,			SOP_PUSH_BTOF,		LOWER_A },
+	{ OP_PUSH_FTOB,			SOP_PUSH_FTOB,		LOWER_A },
+
+	{ -1,					SOP_STATEMENT,		0 }
+};
+
+/*
+==============
+idProgram::LowerStatement
+
+Statements that can't be lowered stay SOP_STATEMENT
+==============
+*/
+void idProgram::LowerStatement( int index, scriptInstruction_t &in ) const {
+	const statement_t	&st = statements[ index ];
+	const loweredOp_t	*lowered;
+
+	memset( &in, 0, sizeof( in ) );
+	in.op = SOP_STATEMENT;
+
+	for( lowered = loweredOps; lowered->op != -1; lowered++ ) {
+		if ( lowered->op == st.op ) {
+			break;
+		}
+	}
+	if ( lowered->op == -1 ) {
+		return;
+	}
+
+	if ( ( lowered->operands & LOWER_A ) && !LowerOperand( st.a, in.a ) ) {
+		return;
+	}
+	if ( ( lowered->operands & LOWER_B ) && !LowerOperand( st.b, in.b ) ) {
+		return;
+	}
+	if ( ( lowered->operands & LOWER_C ) && !LowerOperand( st.c, in.c ) ) {
+		return;
+	}
+	if ( lowered->operands & LOWER_FIELD ) {
+		if ( !st.b ) {
+			return;
+		}
+		in.b = st.b->value.ptrOffset;
+	}
+	if ( lowered->operands & LOWER_JUMP_A ) {
+		if ( !st.a ) {
+			return;
+		}
+		in.jump = index + st.a->value.jumpOffset;
+	}
+	if ( lowered->operands & LOWER_JUMP_B ) {
+		if ( !st.b ) {
+			return;
+		}
+		in.jump = index + st.b->value.jumpOffset;
+	}
+
+	in.op = lowered->sop;
+
+	// fuse a compare with the branch on its result, the branch keeps its own instruction for jumps to it
+	if ( in.op >= SOP_GE && in.op <= SOP_NE_E && index + 1 < statements.Num() ) {
+		const statement_t &next = statements[ index + 1 ];
+		if ( ( next.op == OP_IF || next.op == OP_IFNOT ) && next.a == st.c && next.b ) {
+			in.op += ( next.op == OP_IF ? SOP_GE_IF : SOP_GE_IFNOT ) - SOP_GE;
+			in.jump = index + 1 + next.b->value.jumpOffset;
+		}
+	}
+}
+
+/*
+==============
+idProgram::LowerStatements
+
+Lowers the statements added by the last compile, or just adds SOP_STATEMENT instructions for them
+==============
+*/
+void idProgram::LowerStatements( bool lower ) {
+	int i, first;
+
+	first = instructions.Num();
+	instructions.SetNum( statements.Num() );
+
+	for( i = first; i < statements.Num(); i++ ) {
+		if ( lower ) {
+			LowerStatement( i, instructions[ i ] );
+		} else {
+			memset( &instructions[ i ], 0, sizeof( instructions[ i ] ) );
+			instructions[ i ].op = SOP_STATEMENT;
+		}
+	}
+}
+
 /*
 ================
 idProgram::CompileText
@@ -1831,12 +2062,16 @@ bool idProgram::CompileText( const char *source, const char *text, bool console
 	idVarDef	*def;
 	idStr		ospath;
 
+	// only CompileFile knows what was compiled
+	programKey = 0;
+
 	// use a full os path for GetFilenum since it calls OSPathToRelativePath to convert filenames from the parser
 	ospath = fileSystem->RelativePathToOSPath( source );
 	filenum = GetFilenum( ospath );
 
 	try {
 		compiler.CompileFile( text, filename, console );
+		includedFiles = compiler.GetIncludedFiles();
 
 		// check to make sure all functions prototyped have code
 		for( i = 0; i < varDefs.Num(); i++ ) {
@@ -1852,12 +2087,16 @@ bool idProgram::CompileText( const char *source, const char *text, bool console
 	catch( idCompileError &err ) {
 		if ( console ) {
 			gameLocal.Printf( "%s\n", err.error );
+			// don't trust the defs of a failed compile
+			LowerStatements( false );
 			return false;
 		} else {
 			gameLocal.Error( "%s\n", err.error );
 		}
 	};
 
+	LowerStatements( true );
+
 	if ( !console ) {
 		CompileStats();
 	}
@@ -1893,13 +2132,24 @@ idProgram::CompileFile
 */
 void idProgram::CompileFile( const char *filename ) {
 	char *src;
+	int length;
 	bool result;
+	scriptImageBase_t base;
 
-	if ( fileSystem->ReadFile( filename, ( void ** )&src, NULL ) < 0 ) {
+	length = fileSystem->ReadFile( filename, ( void ** )&src, NULL );
+	if ( length < 0 ) {
 		gameLocal.Error( "Couldn't load %s\n", filename );
 	}
 
-	result = CompileText( filename, src, false );
+	if ( LoadImage( filename, src, length ) ) {
+		result = true;
+	} else {
+		GetImageBase( base );
+		result = CompileText( filename, src, false );
+		if ( result ) {
+			WriteImage( filename, src, length, base );
+		}
+	}
 
 	fileSystem->FreeFile( src );
 
@@ -1945,6 +2195,7 @@ void idProgram::FreeData( void ) {
 	filename.Clear();
 	fileList.Clear();
 	statements.Clear();
+	instructions.Clear();
 	functions.Clear();
 
 	top_functions	= 0;
@@ -1953,6 +2204,10 @@ void idProgram::FreeData( void ) {
 	top_defs		= 0;
 	top_files		= 0;
 
+	programKey		= 0;
+	top_programKey	= 0;
+	includedFiles.Clear();
+
 	filename = "";
 }
 
@@ -2156,8 +2411,10 @@ void idProgram::Restart( void ) {
 	functions.SetNum( top_functions	);
 
 	statements.SetNum( top_statements );
+	instructions.SetNum( top_statements );
 	fileList.SetNum( top_files, false );
 	filename.Clear();
+	programKey = top_programKey;
 
 	// reset the variables to their default values
 	numVariables = variableDefaults.Num();
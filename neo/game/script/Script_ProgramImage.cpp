@@ -0,0 +1,955 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+
+#include "sys/platform.h"
+#include "idlib/hashing/CRC32.h"
+#include "idlib/hashing/MD5.h"
+#include "idlib/Timer.h"
+#include "framework/FileSystem.h"
+#include "framework/Licensee.h"
+
+#include "gamesys/Event.h"
+#include "gamesys/SysCvar.h"
+#include "script/Script_Compiler.h"
+#include "script/Script_Interpreter.h"
+#include "Game_local.h"
+
+#include "script/Script_Program.h"
+
+#define SCRIPTIMAGE_FILE_SUFFIX		"b"		// script/doom_main.script -> script/doom_main.scriptb
+#define SCRIPTIMAGE_FILEID			( ( 'I' << 24 ) | ( 'P' << 16 ) | ( 'C' << 8 ) | 'S' )	// little endian "SCPI"
+#define SCRIPTIMAGE_FILEVERSION		1
+
+/*
+===============================================================================
+
+	Program image file
+
+	The header with the state of the program the file was compiled on and
+	the files read by the compile is followed by the file names, types,
+	defs, functions and statements that were added, the global variables
+	that were reserved, including the string constants, and the type of the
+	return def the compiler leaves behind.
+
+	Types, defs and functions refer to each other by their index in the
+	program, the builtin types and defs by -2 - their index in the tables
+	below, NULL is -1.
+
+===============================================================================
+*/
+
+#define SCRIPTIMAGE_NULL			-1
+
+static idTypeDef *imageTypes[] = {
+	&type_void, &type_scriptevent, &type_namespace, &type_string, &type_float, &type_vector, &type_entity, &type_field,
+	&type_function, &type_virtualfunction, &type_pointer, &type_object, &type_jumpoffset, &type_argsize, &type_boolean
+};
+
+static idVarDef *imageDefs[] = {
+	&def_void, &def_scriptevent, &def_namespace, &def_string, &def_float, &def_vector, &def_entity, &def_field,
+	&def_function, &def_virtualfunction, &def_pointer, &def_object, &def_jumpoffset, &def_argsize, &def_boolean
+};
+
+static const int numImageBuiltins = sizeof( imageTypes ) / sizeof( imageTypes[0] );
+
+// what the value of a def holds
+typedef enum {
+	SCRIPTIMAGE_VALUE_INT,			// stack, field or jump offset, arg size or virtual function number
+	SCRIPTIMAGE_VALUE_GLOBAL,		// offset in the global variables
+	SCRIPTIMAGE_VALUE_FUNCTION		// function number
+} scriptImageValue_t;
+
+/*
+================
+ImageFileName
+================
+*/
+static idStr ImageFileName( const char *filename ) {
+	idStr imageName = filename;
+	imageName += SCRIPTIMAGE_FILE_SUFFIX;
+	return imageName;
+}
+
+/*
+================
+SetImageFile
+================
+*/
+static void SetImageFile( scriptImageFile_t &file, const char *name, const void *data, int length ) {
+	file.name = name;
+	file.length = length;
+	file.crc = CRC32_BlockChecksum( data, length );
+	file.md5 = MD5_BlockChecksum( data, length );
+}
+
+/*
+================
+ImageFileChanged
+================
+*/
+static bool ImageFileChanged( const scriptImageFile_t &file ) {
+	scriptImageFile_t current;
+	void *buffer;
+	int length;
+
+	length = fileSystem->ReadFile( file.name, &buffer, NULL );
+	if ( length < 0 ) {
+		return true;
+	}
+	SetImageFile( current, file.name, buffer, length );
+	fileSystem->FreeFile( buffer );
+
+	return ( current.length != file.length || current.crc != file.crc || current.md5 != file.md5 );
+}
+
+/*
+================
+ImageProgramKey
+
+the key of the program after the files were compiled on top of the program with baseKey
+================
+*/
+static unsigned int ImageProgramKey( unsigned int baseKey, const idList<scriptImageFile_t> &files ) {
+	unsigned int key;
+	int values[4];
+
+	CRC32_InitChecksum( key );
+	values[0] = LittleInt( baseKey );
+	CRC32_UpdateChecksum( key, values, sizeof( int ) );
+	for ( int i = 0; i < files.Num(); i++ ) {
+		CRC32_UpdateChecksum( key, files[i].name.c_str(), files[i].name.Length() + 1 );
+		values[0] = LittleInt( files[i].length );
+		values[1] = LittleInt( files[i].crc );
+		values[2] = LittleInt( files[i].md5 );
+		CRC32_UpdateChecksum( key, values, 3 * sizeof( int ) );
+	}
+	CRC32_FinishChecksum( key );
+
+	// 0 is a program that can't be cached
+	return key ? key : 1;
+}
+
+/*
+================
+idProgram::StartProgramKey
+
+the key of an empty program, it covers what the compiled code depends on
+besides the script files, including the build of the compiler
+================
+*/
+unsigned int idProgram::StartProgramKey( void ) {
+	static const char *buildVersion = ENGINE_VERSION " " ID__DATE__ " " ID__TIME__;
+	unsigned int key;
+	int values[3];
+
+	CRC32_InitChecksum( key );
+	values[0] = LittleInt( SCRIPTIMAGE_FILEVERSION );
+	values[1] = LittleInt( (int)sizeof( intptr_t ) );
+	values[2] = LittleInt( MAX_STRING_LEN );
+	CRC32_UpdateChecksum( key, values, sizeof( values ) );
+	CRC32_UpdateChecksum( key, buildVersion, strlen( buildVersion ) + 1 );
+
+	// calls are compiled against the events of the game code
+	for ( int i = 0; i < idEventDef::NumEventCommands(); i++ ) {
+		const idEventDef *ev = idEventDef::GetEventCommand( i );
+		char returnType = ev->GetReturnType();
+		CRC32_UpdateChecksum( key, ev->GetName(), strlen( ev->GetName() ) + 1 );
+		CRC32_UpdateChecksum( key, ev->GetArgFormat(), strlen( ev->GetArgFormat() ) + 1 );
+		CRC32_UpdateChecksum( key, &returnType, 1 );
+	}
+	CRC32_FinishChecksum( key );
+
+	return key ? key : 1;
+}
+
+/*
+================
+idProgram::GetImageBase
+================
+*/
+void idProgram::GetImageBase( scriptImageBase_t &base ) const {
+	base.programKey		= programKey;
+	base.numFiles		= fileList.Num();
+	base.numTypes		= types.Num();
+	base.numDefs		= varDefs.Num();
+	base.numFunctions	= functions.Num();
+	base.numStatements	= statements.Num();
+	base.numVariables	= numVariables;
+	base.lastDef		= varDefs.Num() ? varDefs[ varDefs.Num() - 1 ] : NULL;
+}
+
+/*
+================
+idProgram::FreeImageData
+
+removes everything a failed image load added, like Restart does for the map scripts
+================
+*/
+void idProgram::FreeImageData( const scriptImageBase_t &base ) {
+	int i;
+
+	for( i = base.numTypes; i < types.Num(); i++ ) {
+		delete types[ i ];
+	}
+	types.SetNum( base.numTypes, false );
+
+	for( i = base.numDefs; i < varDefs.Num(); i++ ) {
+		delete varDefs[ i ];
+	}
+	varDefs.SetNum( base.numDefs, false );
+
+	for( i = base.numFunctions; i < functions.Num(); i++ ) {
+		functions[ i ].Clear();
+	}
+	functions.SetNum( base.numFunctions );
+
+	statements.SetNum( base.numStatements );
+	fileList.SetNum( base.numFiles, false );
+	filename.Clear();
+	numVariables = base.numVariables;
+}
+
+/*
+===============================================================================
+
+	Writing
+
+===============================================================================
+*/
+
+/*
+================
+TypeHashKey
+================
+*/
+static int TypeHashKey( const idTypeDef *type ) {
+	return (int)( (intptr_t)type >> 4 );
+}
+
+/*
+================
+ImageTypeRef
+================
+*/
+static int ImageTypeRef( const idTypeDef *type, const idList<idTypeDef *> &types, const idHashIndex &typeHash, bool &ok ) {
+	if ( !type ) {
+		return SCRIPTIMAGE_NULL;
+	}
+	for ( int i = typeHash.First( TypeHashKey( type ) ); i != -1; i = typeHash.Next( i ) ) {
+		if ( types[i] == type ) {
+			return i;
+		}
+	}
+	for ( int i = 0; i < numImageBuiltins; i++ ) {
+		if ( imageTypes[i] == type ) {
+			return -2 - i;
+		}
+	}
+	ok = false;
+	return SCRIPTIMAGE_NULL;
+}
+
+/*
+================
+ImageDefRef
+================
+*/
+static int ImageDefRef( const idVarDef *def, const idList<idVarDef *> &varDefs, bool &ok ) {
+	if ( !def ) {
+		return SCRIPTIMAGE_NULL;
+	}
+	if ( def->num >= 0 && def->num < varDefs.Num() && varDefs[def->num] == def ) {
+		return def->num;
+	}
+	for ( int i = 0; i < numImageBuiltins; i++ ) {
+		if ( imageDefs[i] == def ) {
+			return -2 - i;
+		}
+	}
+	ok = false;
+	return SCRIPTIMAGE_NULL;
+}
+
+/*
+================
+ImageFunctionRef
+================
+*/
+static int ImageFunctionRef( const function_t *func, const function_t *functions, int numFunctions, bool &ok ) {
+	if ( !func ) {
+		return SCRIPTIMAGE_NULL;
+	}
+	if ( func >= functions && func < functions + numFunctions ) {
+		return func - functions;
+	}
+	ok = false;
+	return SCRIPTIMAGE_NULL;
+}
+
+/*
+================
+idProgram::WriteImage
+
+Called after the file was compiled on top of base.  Sets the key of the program
+and writes the image of what was added when the program could be cached so far.
+================
+*/
+void idProgram::WriteImage( const char *filename, const char *text, int length, const scriptImageBase_t &base ) {
+	idList<scriptImageFile_t> files;
+	idHashIndex typeHash;
+	idStr imageName;
+	idFile *f;
+	int i, j;
+	bool ok;
+
+	if ( !g_scriptImageCache.GetBool() || !base.programKey ) {
+		return;
+	}
+
+	// the compiler only ever adds to the program, unless it frees constants it folded
+	if ( varDefs.Num() < base.numDefs || ( base.numDefs && varDefs[ base.numDefs - 1 ] != base.lastDef ) ||
+		types.Num() < base.numTypes || functions.Num() < base.numFunctions || statements.Num() < base.numStatements || fileList.Num() < base.numFiles ) {
+		return;
+	}
+
+	SetImageFile( files.Alloc(), filename, text, length );
+	for ( i = 0; i < includedFiles.Num(); i++ ) {
+		void *buffer;
+		int includeLength = fileSystem->ReadFile( includedFiles[i], &buffer, NULL );
+		if ( includeLength < 0 ) {
+			return;
+		}
+		SetImageFile( files.Alloc(), includedFiles[i], buffer, includeLength );
+		fileSystem->FreeFile( buffer );
+	}
+
+	programKey = ImageProgramKey( base.programKey, files );
+
+	typeHash.Clear( 1024, types.Num() );
+	for ( i = 0; i < types.Num(); i++ ) {
+		typeHash.Add( TypeHashKey( types[i] ), i );
+	}
+
+	imageName = ImageFileName( filename );
+	f = fileSystem->OpenFileWrite( imageName, "fs_devpath" );
+	if ( !f ) {
+		gameLocal.DPrintf( "idProgram::WriteImage: Error opening file %s\n", imageName.c_str() );
+		return;
+	}
+
+	// the image is removed again if anything can't be referenced
+	ok = true;
+
+	f->WriteInt( SCRIPTIMAGE_FILEID );
+	f->WriteInt( SCRIPTIMAGE_FILEVERSION );
+	f->WriteInt( sizeof( intptr_t ) );
+	f->WriteInt( MAX_STRING_LEN );
+	f->WriteUnsignedInt( base.programKey );
+	f->WriteInt( base.numFiles );
+	f->WriteInt( base.numTypes );
+	f->WriteInt( base.numDefs );
+	f->WriteInt( base.numFunctions );
+	f->WriteInt( base.numStatements );
+	f->WriteInt( base.numVariables );
+	f->WriteInt( fileList.Num() - base.numFiles );
+	f->WriteInt( types.Num() - base.numTypes );
+	f->WriteInt( varDefs.Num() - base.numDefs );
+	f->WriteInt( functions.Num() - base.numFunctions );
+	f->WriteInt( statements.Num() - base.numStatements );
+	f->WriteInt( numVariables );
+
+	f->WriteInt( files.Num() );
+	for ( i = 0; i < files.Num(); i++ ) {
+		f->WriteString( files[i].name );
+		f->WriteInt( files[i].length );
+		f->WriteUnsignedInt( files[i].crc );
+		f->WriteUnsignedInt( files[i].md5 );
+	}
+
+	for ( i = base.numFiles; i < fileList.Num(); i++ ) {
+		f->WriteString( fileList[i] );
+	}
+
+	for ( i = base.numTypes; i < types.Num(); i++ ) {
+		const idTypeDef *type = types[i];
+		f->WriteInt( type->type );
+		f->WriteString( type->name );
+		f->WriteInt( type->size );
+		f->WriteInt( ImageTypeRef( type->auxType, types, typeHash, ok ) );
+		f->WriteInt( ImageDefRef( type->def, varDefs, ok ) );
+		f->WriteInt( type->parmTypes.Num() );
+		for ( j = 0; j < type->parmTypes.Num(); j++ ) {
+			f->WriteInt( ImageTypeRef( type->parmTypes[j], types, typeHash, ok ) );
+			f->WriteString( type->parmNames[j] );
+		}
+		f->WriteInt( type->functions.Num() );
+		for ( j = 0; j < type->functions.Num(); j++ ) {
+			f->WriteInt( ImageFunctionRef( type->functions[j], functions.Ptr(), functions.Num(), ok ) );
+		}
+	}
+
+	for ( i = base.numDefs; i < varDefs.Num(); i++ ) {
+		const idVarDef *def = varDefs[i];
+		int kind, value;
+
+		if ( def->num != i ) {
+			ok = false;
+		}
+
+		etype_t etype = def->Type();
+		if ( def->initialized == idVarDef::stackVariable ) {
+			kind = SCRIPTIMAGE_VALUE_INT;
+			value = def->value.stackOffset;
+		} else if ( etype == ev_jumpoffset || etype == ev_argsize || etype == ev_virtualfunction ) {
+			kind = SCRIPTIMAGE_VALUE_INT;
+			value = def->value.argSize;
+		} else if ( etype == ev_function && def->value.functionPtr >= functions.Ptr() && def->value.functionPtr < functions.Ptr() + functions.Num() ) {
+			kind = SCRIPTIMAGE_VALUE_FUNCTION;
+			value = def->value.functionPtr - functions.Ptr();
+		} else if ( def->scope && def->scope->TypeDef() && def->scope->TypeDef()->Inherits( &type_object ) ) {
+			kind = SCRIPTIMAGE_VALUE_INT;
+			value = def->value.ptrOffset;
+		} else if ( def->value.bytePtr >= variables && def->value.bytePtr <= variables + numVariables ) {
+			kind = SCRIPTIMAGE_VALUE_GLOBAL;
+			value = def->value.bytePtr - variables;
+		} else if ( def->value.bytePtr == NULL ) {
+			kind = SCRIPTIMAGE_VALUE_INT;
+			value = 0;
+		} else {
+			kind = SCRIPTIMAGE_VALUE_INT;
+			value = 0;
+			ok = false;
+		}
+
+		f->WriteInt( ImageTypeRef( def->TypeDef(), types, typeHash, ok ) );
+		f->WriteString( def->Name() );
+		f->WriteInt( ImageDefRef( def->scope, varDefs, ok ) );
+		f->WriteInt( def->numUsers );
+		f->WriteInt( def->initialized );
+		f->WriteInt( kind );
+		f->WriteInt( value );
+	}
+
+	for ( i = base.numFunctions; i < functions.Num(); i++ ) {
+		const function_t &func = functions[i];
+		f->WriteString( func.Name() );
+		f->WriteString( func.eventdef ? func.eventdef->GetName() : "" );
+		f->WriteInt( ImageDefRef( func.def, varDefs, ok ) );
+		f->WriteInt( ImageTypeRef( func.type, types, typeHash, ok ) );
+		f->WriteInt( func.firstStatement );
+		f->WriteInt( func.numStatements );
+		f->WriteInt( func.parmTotal );
+		f->WriteInt( func.locals );
+		f->WriteInt( func.filenum );
+		f->WriteInt( func.parmSize.Num() );
+		for ( j = 0; j < func.parmSize.Num(); j++ ) {
+			f->WriteInt( func.parmSize[j] );
+		}
+	}
+
+	for ( i = base.numStatements; i < statements.Num(); i++ ) {
+		const statement_t &st = statements[i];
+		f->WriteUnsignedShort( st.op );
+		f->WriteUnsignedShort( st.flags );
+		f->WriteUnsignedShort( st.linenumber );
+		f->WriteUnsignedShort( st.file );
+		f->WriteInt( ImageDefRef( st.a, varDefs, ok ) );
+		f->WriteInt( ImageDefRef( st.b, varDefs, ok ) );
+		f->WriteInt( ImageDefRef( st.c, varDefs, ok ) );
+	}
+
+	f->Write( &variables[ base.numVariables ], numVariables - base.numVariables );
+
+	// left behind by the compiler and used as the type of later returns
+	f->WriteInt( ImageTypeRef( returnDef->TypeDef(), types, typeHash, ok ) );
+	f->WriteInt( ImageTypeRef( type_pointer.PointerType(), types, typeHash, ok ) );
+
+	fileSystem->CloseFile( f );
+
+	if ( !ok ) {
+		gameLocal.DPrintf( "idProgram::WriteImage: couldn't reference everything compiled from %s\n", filename );
+		fileSystem->RemoveFile( imageName );
+	}
+}
+
+/*
+===============================================================================
+
+	Loading
+
+===============================================================================
+*/
+
+/*
+================
+ReadImageInt
+================
+*/
+static int ReadImageInt( idFile *f, bool &ok ) {
+	int value = 0;
+	if ( f->ReadInt( value ) != sizeof( value ) ) {
+		ok = false;
+		value = 0;
+	}
+	return value;
+}
+
+/*
+================
+ReadImageShort
+================
+*/
+static unsigned short ReadImageShort( idFile *f, bool &ok ) {
+	unsigned short value = 0;
+	if ( f->ReadUnsignedShort( value ) != sizeof( value ) ) {
+		ok = false;
+		value = 0;
+	}
+	return value;
+}
+
+/*
+================
+ReadImageString
+================
+*/
+static void ReadImageString( idFile *f, idStr &string, bool &ok ) {
+	int length = ReadImageInt( f, ok );
+
+	string.Clear();
+	if ( !ok || length < 0 || length > f->Length() - f->Tell() ) {
+		ok = false;
+		return;
+	}
+	string.Fill( ' ', length );
+	f->Read( &string[0], length );
+}
+
+/*
+================
+ReadImageCount
+
+counts are checked against what is left in the file, so a broken file doesn't allocate much
+================
+*/
+static int ReadImageCount( idFile *f, int minSize, bool &ok ) {
+	int count = ReadImageInt( f, ok );
+
+	if ( count < 0 || count > ( f->Length() - f->Tell() ) / minSize ) {
+		ok = false;
+		return 0;
+	}
+	return count;
+}
+
+/*
+================
+ValidImageRef
+================
+*/
+static bool ValidImageRef( int ref, int num ) {
+	return ( ref >= -1 - numImageBuiltins && ref < num );
+}
+
+/*
+================
+ImageStackSize
+
+the stack space the compiler reserves for a variable of the type
+================
+*/
+static int ImageStackSize( const idTypeDef *type ) {
+	// objects only have their entity number on the stack
+	return type->Inherits( &type_object ) ? type_object.Size() : type->Size();
+}
+
+/*
+================
+ValidImageFunction
+
+The interpreter trusts the stack layout and the jumps the compiler made,
+so they are checked for every function read from an image.
+================
+*/
+static bool ValidImageFunction( const function_t &func, const statement_t *statements ) {
+	int i, j, total;
+
+	if ( func.parmTotal < 0 || func.locals < func.parmTotal || func.locals > LOCALSTACK_SIZE ) {
+		return false;
+	}
+
+	// events read their parms with the parm sizes, prototypes may not have them yet
+	total = 0;
+	for ( i = 0; i < func.parmSize.Num(); i++ ) {
+		if ( func.parmSize[i] < 0 || func.parmSize[i] > func.parmTotal - total ) {
+			return false;
+		}
+		total += func.parmSize[i];
+	}
+	if ( func.parmSize.Num() && total != func.parmTotal ) {
+		return false;
+	}
+	if ( func.eventdef ) {
+		return ( func.parmSize.Num() == func.eventdef->GetNumArgs() && !func.numStatements );
+	}
+
+	if ( !func.numStatements ) {
+		return true;
+	}
+	if ( statements[ func.firstStatement + func.numStatements - 1 ].op != OP_RETURN ) {
+		return false;
+	}
+
+	for ( i = func.firstStatement; i < func.firstStatement + func.numStatements; i++ ) {
+		const statement_t &st = statements[i];
+		const idVarDef *operands[3] = { st.a, st.b, st.c };
+
+		for ( j = 0; j < 3; j++ ) {
+			const idVarDef *def = operands[j];
+			if ( !def || def->initialized != idVarDef::stackVariable ) {
+				continue;
+			}
+			if ( !def->TypeDef() || def->value.stackOffset < 0 || def->value.stackOffset > func.locals - ImageStackSize( def->TypeDef() ) ) {
+				return false;
+			}
+		}
+
+		// jumps have to stay inside the function
+		const idVarDef *jump = NULL;
+		if ( st.op == OP_GOTO ) {
+			jump = st.a;
+		} else if ( st.op == OP_IF || st.op == OP_IFNOT ) {
+			jump = st.b;
+		} else {
+			continue;
+		}
+		if ( !jump || jump->value.jumpOffset < func.firstStatement - i || jump->value.jumpOffset >= func.firstStatement + func.numStatements - i ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+================
+idProgram::ReadImage
+
+Reads the image and adds it to the program, returns false if the image is
+broken or out of date.  The caller removes whatever was added in that case.
+================
+*/
+bool idProgram::ReadImage( idFile *f, const char *filename, const char *text, int length, const scriptImageBase_t &base, idList<scriptImageFile_t> &files ) {
+	int numNewFiles, numNewTypes, numNewDefs, numNewFunctions, numNewStatements, newNumVariables;
+	int numFiles, numTypes, numDefs, numFunctions, numStatements;
+	int i, j, num;
+	bool ok;
+	idStr name;
+
+	ok = true;
+
+	if ( ReadImageInt( f, ok ) != SCRIPTIMAGE_FILEID || ReadImageInt( f, ok ) != SCRIPTIMAGE_FILEVERSION ||
+		ReadImageInt( f, ok ) != sizeof( intptr_t ) || ReadImageInt( f, ok ) != MAX_STRING_LEN ) {
+		return false;
+	}
+
+	// must have been compiled on top of the same program
+	if ( (unsigned int)ReadImageInt( f, ok ) != base.programKey ||
+		ReadImageInt( f, ok ) != base.numFiles || ReadImageInt( f, ok ) != base.numTypes ||
+		ReadImageInt( f, ok ) != base.numDefs || ReadImageInt( f, ok ) != base.numFunctions ||
+		ReadImageInt( f, ok ) != base.numStatements || ReadImageInt( f, ok ) != base.numVariables ) {
+		return false;
+	}
+
+	numNewFiles			= ReadImageCount( f, 4, ok );
+	numNewTypes			= ReadImageCount( f, 4, ok );
+	numNewDefs			= ReadImageCount( f, 4, ok );
+	numNewFunctions		= ReadImageCount( f, 4, ok );
+	numNewStatements	= ReadImageCount( f, 4, ok );
+	newNumVariables		= ReadImageInt( f, ok );
+
+	numFiles			= base.numFiles + numNewFiles;
+	numTypes			= base.numTypes + numNewTypes;
+	numDefs				= base.numDefs + numNewDefs;
+	numFunctions		= base.numFunctions + numNewFunctions;
+	numStatements		= base.numStatements + numNewStatements;
+
+	if ( !ok || numFunctions > functions.Max() || numStatements > statements.Max() ||
+		newNumVariables < base.numVariables || newNumVariables > (int)sizeof( variables ) ) {
+		return false;
+	}
+
+	// the compiled script must be the same and none of the files it included may have changed
+	files.SetNum( ReadImageCount( f, 16, ok ) );
+	for ( i = 0; i < files.Num(); i++ ) {
+		ReadImageString( f, files[i].name, ok );
+		files[i].length = ReadImageInt( f, ok );
+		files[i].crc = (unsigned int)ReadImageInt( f, ok );
+		files[i].md5 = (unsigned int)ReadImageInt( f, ok );
+	}
+	if ( !ok || files.Num() < 1 ) {
+		return false;
+	}
+
+	scriptImageFile_t current;
+	SetImageFile( current, filename, text, length );
+	if ( files[0].name.Icmp( filename ) || files[0].length != current.length || files[0].crc != current.crc || files[0].md5 != current.md5 ) {
+		return false;
+	}
+	for ( i = 1; i < files.Num(); i++ ) {
+		if ( ImageFileChanged( files[i] ) ) {
+			gameLocal.DPrintf( "%s changed since the image of %s was written\n", files[i].name.c_str(), filename );
+			return false;
+		}
+	}
+
+	for ( i = 0; i < numNewFiles; i++ ) {
+		ReadImageString( f, name, ok );
+		fileList.Append( name );
+	}
+
+	// allocate everything first so it can be referenced before it is read
+	for ( i = 0; i < numNewTypes; i++ ) {
+		types.Append( new idTypeDef( ev_void, NULL, "", 0, NULL ) );
+	}
+	for ( i = 0; i < numNewDefs; i++ ) {
+		idVarDef *def = new idVarDef();
+		def->num = varDefs.Append( def );
+	}
+	for ( i = 0; i < numNewFunctions; i++ ) {
+		functions.Alloc()->parmSize.SetGranularity( 1 );
+	}
+
+	for ( i = base.numTypes; i < numTypes && ok; i++ ) {
+		idTypeDef *type = types[i];
+		int etype, aux, def;
+
+		etype = ReadImageInt( f, ok );
+		ReadImageString( f, type->name, ok );
+		type->size = ReadImageInt( f, ok );
+		aux = ReadImageInt( f, ok );
+		def = ReadImageInt( f, ok );
+		if ( etype < ev_void || etype > ev_boolean || !ValidImageRef( aux, numTypes ) || !ValidImageRef( def, numDefs ) ) {
+			return false;
+		}
+		type->type = (etype_t)etype;
+		type->auxType = ( aux >= 0 ) ? types[aux] : ( ( aux < -1 ) ? imageTypes[-2 - aux] : NULL );
+		type->def = ( def >= 0 ) ? varDefs[def] : ( ( def < -1 ) ? imageDefs[-2 - def] : NULL );
+
+		num = ReadImageCount( f, 8, ok );
+		for ( j = 0; j < num; j++ ) {
+			int parm = ReadImageInt( f, ok );
+			ReadImageString( f, name, ok );
+			if ( !ValidImageRef( parm, numTypes ) ) {
+				return false;
+			}
+			type->parmTypes.Append( ( parm >= 0 ) ? types[parm] : ( ( parm < -1 ) ? imageTypes[-2 - parm] : NULL ) );
+			type->parmNames.Append( name );
+		}
+
+		num = ReadImageCount( f, 4, ok );
+		for ( j = 0; j < num; j++ ) {
+			int func = ReadImageInt( f, ok );
+			if ( func < -1 || func >= numFunctions ) {
+				return false;
+			}
+			type->functions.Append( ( func >= 0 ) ? &functions[func] : NULL );
+		}
+	}
+
+	for ( i = base.numDefs; i < numDefs && ok; i++ ) {
+		idVarDef *def = varDefs[i];
+		int type, scope, initialized, kind, value;
+
+		type = ReadImageInt( f, ok );
+		ReadImageString( f, name, ok );
+		scope = ReadImageInt( f, ok );
+		def->numUsers = ReadImageInt( f, ok );
+		initialized = ReadImageInt( f, ok );
+		kind = ReadImageInt( f, ok );
+		value = ReadImageInt( f, ok );
+		if ( !ValidImageRef( type, numTypes ) || !ValidImageRef( scope, numDefs ) || initialized < idVarDef::uninitialized || initialized > idVarDef::stackVariable ) {
+			return false;
+		}
+
+		// in the same order as the compiler, so the defs with the same name are found in the same order
+		AddDefToNameList( def, name );
+		def->SetTypeDef( ( type >= 0 ) ? types[type] : ( ( type < -1 ) ? imageTypes[-2 - type] : NULL ) );
+		def->scope = ( scope >= 0 ) ? varDefs[scope] : ( ( scope < -1 ) ? imageDefs[-2 - scope] : NULL );
+		def->initialized = (idVarDef::initialized_t)initialized;
+
+		switch( kind ) {
+		case SCRIPTIMAGE_VALUE_INT:
+			def->value.argSize = value;
+			break;
+		case SCRIPTIMAGE_VALUE_GLOBAL:
+			if ( value < 0 || value > newNumVariables ) {
+				return false;
+			}
+			def->value.bytePtr = &variables[value];
+			break;
+		case SCRIPTIMAGE_VALUE_FUNCTION:
+			if ( value < 0 || value >= numFunctions ) {
+				return false;
+			}
+			def->value.functionPtr = &functions[value];
+			break;
+		default:
+			return false;
+		}
+	}
+
+	for ( i = base.numFunctions; i < numFunctions && ok; i++ ) {
+		function_t &func = functions[i];
+		int def, type;
+
+		ReadImageString( f, name, ok );
+		func.SetName( name );
+		ReadImageString( f, name, ok );
+		if ( name.Length() ) {
+			func.eventdef = idEventDef::FindEvent( name );
+			if ( !func.eventdef ) {
+				return false;
+			}
+		}
+		def = ReadImageInt( f, ok );
+		type = ReadImageInt( f, ok );
+		func.firstStatement = ReadImageInt( f, ok );
+		func.numStatements = ReadImageInt( f, ok );
+		func.parmTotal = ReadImageInt( f, ok );
+		func.locals = ReadImageInt( f, ok );
+		func.filenum = ReadImageInt( f, ok );
+		if ( !ValidImageRef( def, numDefs ) || !ValidImageRef( type, numTypes ) || func.firstStatement < 0 || func.numStatements < 0 ||
+			func.firstStatement > numStatements - func.numStatements || func.filenum < 0 || func.filenum >= numFiles ) {
+			return false;
+		}
+		func.def = ( def >= 0 ) ? varDefs[def] : ( ( def < -1 ) ? imageDefs[-2 - def] : NULL );
+		func.type = ( type >= 0 ) ? types[type] : ( ( type < -1 ) ? imageTypes[-2 - type] : NULL );
+
+		num = ReadImageCount( f, 4, ok );
+		func.parmSize.SetNum( num );
+		for ( j = 0; j < num; j++ ) {
+			func.parmSize[j] = ReadImageInt( f, ok );
+		}
+	}
+
+	for ( i = base.numStatements; i < numStatements && ok; i++ ) {
+		statement_t &st = *statements.Alloc();
+		int a, b, c;
+
+		st.op = ReadImageShort( f, ok );
+		st.flags = ReadImageShort( f, ok );
+		st.linenumber = ReadImageShort( f, ok );
+		st.file = ReadImageShort( f, ok );
+		a = ReadImageInt( f, ok );
+		b = ReadImageInt( f, ok );
+		c = ReadImageInt( f, ok );
+		if ( st.op >= NUM_OPCODES || st.file >= numFiles || !ValidImageRef( a, numDefs ) || !ValidImageRef( b, numDefs ) || !ValidImageRef( c, numDefs ) ) {
+			return false;
+		}
+		st.a = ( a >= 0 ) ? varDefs[a] : ( ( a < -1 ) ? imageDefs[-2 - a] : NULL );
+		st.b = ( b >= 0 ) ? varDefs[b] : ( ( b < -1 ) ? imageDefs[-2 - b] : NULL );
+		st.c = ( c >= 0 ) ? varDefs[c] : ( ( c < -1 ) ? imageDefs[-2 - c] : NULL );
+	}
+
+	for ( i = base.numFunctions; i < numFunctions && ok; i++ ) {
+		if ( !ValidImageFunction( functions[i], statements.Ptr() ) ) {
+			return false;
+		}
+	}
+
+	num = newNumVariables - base.numVariables;
+	if ( !ok || f->Read( &variables[ base.numVariables ], num ) != num ) {
+		return false;
+	}
+	numVariables = newNumVariables;
+
+	int returnType = ReadImageInt( f, ok );
+	int pointerType = ReadImageInt( f, ok );
+	if ( !ok || f->Tell() != f->Length() || !ValidImageRef( returnType, numTypes ) || returnType == SCRIPTIMAGE_NULL || !ValidImageRef( pointerType, numTypes ) ) {
+		return false;
+	}
+	returnDef->SetTypeDef( ( returnType >= 0 ) ? types[returnType] : imageTypes[-2 - returnType] );
+	type_pointer.SetPointerType( ( pointerType >= 0 ) ? types[pointerType] : ( ( pointerType < -1 ) ? imageTypes[-2 - pointerType] : NULL ) );
+
+	return true;
+}
+
+/*
+================
+idProgram::LoadImage
+
+Adds the program image of the file instead of compiling it, if there is one that
+was compiled from the same files on top of the same program.
+================
+*/
+bool idProgram::LoadImage( const char *filename, const char *text, int length ) {
+	idList<scriptImageFile_t> files;
+	scriptImageBase_t base;
+	idTimer loadTime;
+	idStr imageName;
+	idFile *f;
+	bool loaded;
+
+	if ( !g_scriptImageCache.GetBool() || !programKey ) {
+		return false;
+	}
+
+	imageName = ImageFileName( filename );
+	f = fileSystem->OpenFileRead( imageName );
+	if ( !f ) {
+		return false;
+	}
+
+	loadTime.Start();
+
+	GetImageBase( base );
+
+	loaded = ReadImage( f, filename, text, length, base, files );
+
+	fileSystem->CloseFile( f );
+
+	if ( !loaded ) {
+		FreeImageData( base );
+		gameLocal.DPrintf( "%s is out of date\n", imageName.c_str() );
+		return false;
+	}
+
+	programKey = ImageProgramKey( base.programKey, files );
+	this->filename.Clear();		// the file number cache
+
+	LowerStatements( true );
+
+	loadTime.Stop();
+	gameLocal.Printf( "Loaded '%s' from %s: %u ms\n", filename, imageName.c_str(), loadTime.Milliseconds() );
+
+	CompileStats();
+
+	return true;
+}
@@ -649,17 +649,29 @@ idThread::Execute
 bool idThread::Execute( void ) {
 	idThread	*oldThread;
 	bool		done;
+	double		profileStart;
 
 	if ( manualControl && ( waitingUntil > gameLocal.time ) ) {
 		return false;
 	}
 
+	// counts for the entity that is thinking
+	idThinkStatsScope thinkStatsScope( NULL, THINKSTAT_SCRIPT );
+
 	oldThread = currentThread;
 	currentThread = this;
 
 	lastExecuteTime = gameLocal.time;
 	ClearWaitFor();
+
+	profileStart = gameLocal.scriptProfiler.IsActive() ? sys->GetMillisecondsPrecise() : -1.0;
+
 	done = interpreter.Execute();
+
+	if ( profileStart >= 0.0 ) {
+		gameLocal.scriptProfiler.AddThread( this, interpreter.instructionsExecuted, sys->GetMillisecondsPrecise() - profileStart );
+	}
+
 	if ( done ) {
 		End();
 		if ( interpreter.terminateOnExit ) {
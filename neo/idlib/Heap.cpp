@@ -31,8 +31,13 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "idlib/Heap.h"
 
+// idHeap's own small/medium/large allocators aren't thread-safe, but the job
+// worker threads (see sys/sys_jobs.h) allocate memory concurrently with the
+// main thread, so all builds use the libc allocator by default now.
+// Building with -DUSE_LIBC_MALLOC=0 brings idHeap's allocators back, which is
+// only safe with sys_jobThreads 0.
 #ifndef USE_LIBC_MALLOC
-	#define USE_LIBC_MALLOC		0
+	#define USE_LIBC_MALLOC		1
 #endif
 
 #ifndef CRASH_ON_STATIC_ALLOCATION
@@ -27,6 +27,7 @@ If you have questions concerning this license or the applicable additional terms
 */
 
 #include "sys/platform.h"
+#include "idlib/Profiler.h"
 #include "framework/File.h"
 #include "framework/FileSystem.h"
 
@@ -717,6 +718,8 @@ idMapFile::Parse
 ===============
 */
 bool idMapFile::Parse( const char *filename, bool ignoreRegion, bool osPath ) {
+	PROFILE_ZONE( "idMapFile::Parse" );
+
 	// no string concatenation for epairs and allow path names for materials
 	idLexer src( LEXFL_NOSTRINGCONCAT | LEXFL_NOSTRINGESCAPECHARS | LEXFL_ALLOWPATHNAMES );
 	idToken token;
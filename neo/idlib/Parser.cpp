@@ -28,6 +28,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "sys/platform.h"
 #include "idlib/Lib.h"
+#include "idlib/Profiler.h"
 #include "framework/Common.h"
 
 #include "idlib/Parser.h"
@@ -1019,8 +1020,9 @@ int idParser::Directive_include( void ) {
 		if ( idParser::flags & LEXFL_NOBASEINCLUDES ) {
 			return true;
 		}
+		path = includepath + path;
 		script = new idLexer;
-		if ( !script->LoadFile( includepath + path, OSPath ) ) {
+		if ( !script->LoadFile( path, OSPath ) ) {
 			delete script;
 			script = NULL;
 		}
@@ -1033,6 +1035,7 @@ int idParser::Directive_include( void ) {
 		idParser::Error( "file '%s' not found", path.c_str() );
 		return false;
 	}
+	idParser::includedFiles.AddUnique( path );
 	script->SetFlags( idParser::flags );
 	script->SetPunctuations( idParser::punctuations );
 	idParser::PushScript( script );
@@ -3040,6 +3043,8 @@ idParser::LoadFile
 ================
 */
 int idParser::LoadFile( const char *filename, bool OSPath ) {
+	PROFILE_ZONE( "idParser::LoadFile" );
+
 	idLexer *script;
 
 	if ( idParser::loaded ) {
@@ -3061,6 +3066,7 @@ int idParser::LoadFile( const char *filename, bool OSPath ) {
 	idParser::indentstack = NULL;
 	idParser::skip = 0;
 	idParser::loaded = true;
+	idParser::includedFiles.Clear();
 
 	if ( !idParser::definehash ) {
 		idParser::defines = NULL;
@@ -3096,6 +3102,7 @@ int idParser::LoadMemory(const char *ptr, int length, const char *name ) {
 	idParser::indentstack = NULL;
 	idParser::skip = 0;
 	idParser::loaded = true;
+	idParser::includedFiles.Clear();
 
 	if ( !idParser::definehash ) {
 		idParser::defines = NULL;
@@ -29,6 +29,7 @@ If you have questions concerning this license or the applicable additional terms
 #ifndef __PARSER_H__
 #define __PARSER_H__
 
+#include "idlib/containers/StrList.h"
 #include "idlib/Token.h"
 #include "idlib/Lexer.h"
 
@@ -161,6 +162,8 @@ public:
 	int				GetFlags( void ) const;
 					// returns the current filename
 	const char *	GetFileName( void ) const;
+					// returns the paths of the files included by the loaded source, also valid after FreeSource
+	const idStrList &GetIncludedFiles( void ) const;
 					// get current offset in current script
 	const int		GetFileOffset( void ) const;
 					// get file time for current script
@@ -185,6 +188,7 @@ private:
 	int				loaded;						// set when a source file is loaded from file or memory
 	idStr			filename;					// file name of the script
 	idStr			includepath;				// path to include files
+	idStrList		includedFiles;				// files loaded by #include since the source was loaded
 	bool			OSPath;						// true if the file was loaded from an OS path
 	const punctuation_t *punctuations;			// punctuations to use
 	int				flags;						// flags used for script parsing
@@ -256,6 +260,10 @@ ID_INLINE const char *idParser::GetFileName( void ) const {
 	}
 }
 
+ID_INLINE const idStrList &idParser::GetIncludedFiles( void ) const {
+	return idParser::includedFiles;
+}
+
 ID_INLINE const int idParser::GetFileOffset( void ) const {
 	if ( idParser::scriptstack ) {
 		return idParser::scriptstack->GetFileOffset();
@@ -0,0 +1,101 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include "idlib/Lib.h"
+
+/*
+===============================================================================
+
+	Frame profiler
+
+	Code marks a zone with PROFILE_ZONE( "name" ), the zone lasts until the
+	end of the enclosing scope. While recording, every
+	thread writes the zones it leaves into its own ring buffer, so the last
+	frames can be written out as a trace with all threads on one timeline.
+
+	The name has to be a string literal or otherwise outlive the recording,
+	only the pointer is stored.
+
+	The profiler is implemented by the engine and reached through
+	idLib::profiler, so the macros work in idLib, the engine and the game.
+	When not recording a zone costs a pointer load and a test.
+
+===============================================================================
+*/
+
+class idProfiler {
+public:
+	virtual					~idProfiler( void ) {}
+
+	virtual void			Init( void ) = 0;
+	virtual void			Shutdown( void ) = 0;
+
+							// called by the main thread at the start of each frame
+	virtual void			BeginFrame( void ) = 0;
+							// drops all recorded zones, names from unloaded modules may not be used anymore
+	virtual void			Clear( void ) = 0;
+
+							// use idProfileZone instead
+	virtual void			BeginZone( const char *name ) = 0;
+	virtual void			EndZone( void ) = 0;
+
+	bool					IsRecording( void ) const { return recording; }
+
+protected:
+	volatile bool			recording;
+};
+
+extern idProfiler *			profiler;
+
+class idProfileZone {
+public:
+							idProfileZone( const char *name ) {
+								active = ( idLib::profiler != NULL && idLib::profiler->IsRecording() );
+								if ( active ) {
+									idLib::profiler->BeginZone( name );
+								}
+							}
+							~idProfileZone( void ) {
+								// always close the zone that was opened, even if recording was stopped in between
+								if ( active ) {
+									idLib::profiler->EndZone();
+								}
+							}
+
+private:
+	bool					active;
+};
+
+#define PROFILE_ZONE_NAME2( line )	profileZone_##line
+#define PROFILE_ZONE_NAME( line )	PROFILE_ZONE_NAME2( line )
+#define PROFILE_ZONE( name )		idProfileZone PROFILE_ZONE_NAME( __LINE__ )( name )
+
+#endif /* !__PROFILER_H__ */
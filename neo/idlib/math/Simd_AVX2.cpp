@@ -0,0 +1,947 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+
+#include "sys/platform.h"
+#include "idlib/geometry/DrawVert.h"
+#include "idlib/geometry/JointTransform.h"
+#include "idlib/math/Vector.h"
+#include "idlib/math/Plane.h"
+
+#include "idlib/math/Simd_AVX2.h"
+
+//===============================================================
+//
+//	AVX2 & FMA implementation of idSIMDProcessor
+//
+//===============================================================
+
+#ifdef ID_SIMD_AVX2
+
+#include <immintrin.h>
+
+#define DRAWVERT_SIZE_FLOATS		15
+#define JOINTQUAT_SIZE_FLOATS		7
+#define JOINTMAT_SIZE_FLOATS		12
+
+/*
+============
+idSIMD_AVX2::GetName
+============
+*/
+const char * idSIMD_AVX2::GetName( void ) const {
+	return "MMX & SSE & SSE2 & SSE3 & SSE4 & AVX2 & FMA";
+}
+
+/*
+============
+HorizontalMin / HorizontalMax
+
+  reduces the two 128 bit lanes and returns the result in a __m128
+============
+*/
+ID_AVX2_TARGET static ID_INLINE __m128 HorizontalMin( const __m256 v ) {
+	return _mm_min_ps( _mm256_castps256_ps128( v ), _mm256_extractf128_ps( v, 1 ) );
+}
+
+ID_AVX2_TARGET static ID_INLINE __m128 HorizontalMax( const __m256 v ) {
+	return _mm_max_ps( _mm256_castps256_ps128( v ), _mm256_extractf128_ps( v, 1 ) );
+}
+
+/*
+============
+RSqrt
+
+  reciprocal square root with one Newton-Raphson step, like idMath::RSqrt
+  the input is clamped so zero length vectors end up zero instead of NaN
+============
+*/
+ID_AVX2_TARGET static ID_INLINE __m256 RSqrt( __m256 x ) {
+	x = _mm256_max_ps( x, _mm256_set1_ps( 1e-30f ) );
+	const __m256 y = _mm256_rsqrt_ps( x );
+	const __m256 yy = _mm256_mul_ps( _mm256_mul_ps( x, _mm256_set1_ps( 0.5f ) ), _mm256_mul_ps( y, y ) );
+	return _mm256_mul_ps( y, _mm256_sub_ps( _mm256_set1_ps( 1.5f ), yy ) );
+}
+
+/*
+============
+Sin16
+
+  idMath::Sin16 for angles in the range [0, PI/2]
+============
+*/
+ID_AVX2_TARGET static ID_INLINE __m256 Sin16( const __m256 a ) {
+	const __m256 s = _mm256_mul_ps( a, a );
+	__m256 t = _mm256_set1_ps( -2.39e-08f );
+	t = _mm256_fmadd_ps( t, s, _mm256_set1_ps( 2.7526e-06f ) );
+	t = _mm256_fmadd_ps( t, s, _mm256_set1_ps( -1.98409e-04f ) );
+	t = _mm256_fmadd_ps( t, s, _mm256_set1_ps( 8.3333315e-03f ) );
+	t = _mm256_fmadd_ps( t, s, _mm256_set1_ps( -1.666666664e-01f ) );
+	t = _mm256_fmadd_ps( t, s, _mm256_set1_ps( 1.0f ) );
+	return _mm256_mul_ps( a, t );
+}
+
+/*
+============
+ATan16
+
+  idMath::ATan16( y, x ) for y >= 0 and x >= 0
+============
+*/
+ID_AVX2_TARGET static ID_INLINE __m256 ATan16( const __m256 y, const __m256 x ) {
+	const __m256 swap = _mm256_cmp_ps( y, x, _CMP_GT_OQ );
+	const __m256 a = _mm256_div_ps( _mm256_min_ps( y, x ), _mm256_max_ps( y, x ) );
+	const __m256 s = _mm256_mul_ps( a, a );
+	__m256 t = _mm256_set1_ps( 0.0028662257f );
+	t = _mm256_fmadd_ps( t, s, _mm256_set1_ps( -0.0161657367f ) );
+	t = _mm256_fmadd_ps( t, s, _mm256_set1_ps( 0.0429096138f ) );
+	t = _mm256_fmadd_ps( t, s, _mm256_set1_ps( -0.0752896400f ) );
+	t = _mm256_fmadd_ps( t, s, _mm256_set1_ps( 0.1065626393f ) );
+	t = _mm256_fmadd_ps( t, s, _mm256_set1_ps( -0.1420889944f ) );
+	t = _mm256_fmadd_ps( t, s, _mm256_set1_ps( 0.1999355085f ) );
+	t = _mm256_fmadd_ps( t, s, _mm256_set1_ps( -0.3333314528f ) );
+	t = _mm256_fmadd_ps( t, s, _mm256_set1_ps( 1.0f ) );
+	t = _mm256_mul_ps( t, a );
+	return _mm256_blendv_ps( t, _mm256_sub_ps( _mm256_set1_ps( idMath::HALF_PI ), t ), swap );
+}
+
+/*
+============
+idSIMD_AVX2::MinMax
+============
+*/
+ID_AVX2_TARGET void VPCALL idSIMD_AVX2::MinMax( float &min, float &max, const float *src, const int count ) {
+	__m256 vmin = _mm256_set1_ps( idMath::INFINITY );
+	__m256 vmax = _mm256_set1_ps( -idMath::INFINITY );
+	int i;
+
+	for ( i = 0; i + 8 <= count; i += 8 ) {
+		const __m256 v = _mm256_loadu_ps( src + i );
+		vmin = _mm256_min_ps( vmin, v );
+		vmax = _mm256_max_ps( vmax, v );
+	}
+
+	__m128 m0 = HorizontalMin( vmin );
+	__m128 m1 = HorizontalMax( vmax );
+	m0 = _mm_min_ps( m0, _mm_movehl_ps( m0, m0 ) );
+	m1 = _mm_max_ps( m1, _mm_movehl_ps( m1, m1 ) );
+	m0 = _mm_min_ss( m0, _mm_shuffle_ps( m0, m0, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+	m1 = _mm_max_ss( m1, _mm_shuffle_ps( m1, m1, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+	min = _mm_cvtss_f32( m0 );
+	max = _mm_cvtss_f32( m1 );
+
+	for ( ; i < count; i++ ) {
+		if ( src[i] < min ) {
+			min = src[i];
+		}
+		if ( src[i] > max ) {
+			max = src[i];
+		}
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MinMax
+============
+*/
+ID_AVX2_TARGET void VPCALL idSIMD_AVX2::MinMax( idVec2 &min, idVec2 &max, const idVec2 *src, const int count ) {
+	const float *f = src->ToFloatPtr();
+	__m256 vmin = _mm256_set1_ps( idMath::INFINITY );
+	__m256 vmax = _mm256_set1_ps( -idMath::INFINITY );
+	int i;
+
+	// four vectors per register, the lanes alternate x, y
+	for ( i = 0; i + 4 <= count; i += 4 ) {
+		const __m256 v = _mm256_loadu_ps( f + i * 2 );
+		vmin = _mm256_min_ps( vmin, v );
+		vmax = _mm256_max_ps( vmax, v );
+	}
+
+	__m128 m0 = HorizontalMin( vmin );
+	__m128 m1 = HorizontalMax( vmax );
+	m0 = _mm_min_ps( m0, _mm_movehl_ps( m0, m0 ) );
+	m1 = _mm_max_ps( m1, _mm_movehl_ps( m1, m1 ) );
+	_mm_storel_pi( (__m64 *)min.ToFloatPtr(), m0 );
+	_mm_storel_pi( (__m64 *)max.ToFloatPtr(), m1 );
+
+	for ( ; i < count; i++ ) {
+		const idVec2 &v = src[i];
+		if ( v[0] < min[0] ) { min[0] = v[0]; } if ( v[0] > max[0] ) { max[0] = v[0]; }
+		if ( v[1] < min[1] ) { min[1] = v[1]; } if ( v[1] > max[1] ) { max[1] = v[1]; }
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MinMax
+============
+*/
+ID_AVX2_TARGET void VPCALL idSIMD_AVX2::MinMax( idVec3 &min, idVec3 &max, const idVec3 *src, const int count ) {
+	const float *f = src->ToFloatPtr();
+	__m256 vmin0, vmin1, vmin2, vmax0, vmax1, vmax2;
+	int i;
+
+	vmin0 = vmin1 = vmin2 = _mm256_set1_ps( idMath::INFINITY );
+	vmax0 = vmax1 = vmax2 = _mm256_set1_ps( -idMath::INFINITY );
+
+	// eight vectors in three registers, each register lane always sees the same component
+	for ( i = 0; i + 8 <= count; i += 8 ) {
+		const __m256 v0 = _mm256_loadu_ps( f + i * 3 + 0 );
+		const __m256 v1 = _mm256_loadu_ps( f + i * 3 + 8 );
+		const __m256 v2 = _mm256_loadu_ps( f + i * 3 + 16 );
+		vmin0 = _mm256_min_ps( vmin0, v0 );
+		vmin1 = _mm256_min_ps( vmin1, v1 );
+		vmin2 = _mm256_min_ps( vmin2, v2 );
+		vmax0 = _mm256_max_ps( vmax0, v0 );
+		vmax1 = _mm256_max_ps( vmax1, v1 );
+		vmax2 = _mm256_max_ps( vmax2, v2 );
+	}
+
+	float mins[24], maxs[24];
+	_mm256_storeu_ps( mins + 0, vmin0 );
+	_mm256_storeu_ps( mins + 8, vmin1 );
+	_mm256_storeu_ps( mins + 16, vmin2 );
+	_mm256_storeu_ps( maxs + 0, vmax0 );
+	_mm256_storeu_ps( maxs + 8, vmax1 );
+	_mm256_storeu_ps( maxs + 16, vmax2 );
+
+	min[0] = min[1] = min[2] = idMath::INFINITY; max[0] = max[1] = max[2] = -idMath::INFINITY;
+	for ( int j = 0; j < 24; j++ ) {
+		if ( mins[j] < min[j % 3] ) { min[j % 3] = mins[j]; }
+		if ( maxs[j] > max[j % 3] ) { max[j % 3] = maxs[j]; }
+	}
+
+	for ( ; i < count; i++ ) {
+		const idVec3 &v = src[i];
+		if ( v[0] < min[0] ) { min[0] = v[0]; } if ( v[0] > max[0] ) { max[0] = v[0]; }
+		if ( v[1] < min[1] ) { min[1] = v[1]; } if ( v[1] > max[1] ) { max[1] = v[1]; }
+		if ( v[2] < min[2] ) { min[2] = v[2]; } if ( v[2] > max[2] ) { max[2] = v[2]; }
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MinMax
+============
+*/
+ID_AVX2_TARGET void VPCALL idSIMD_AVX2::MinMax( idVec3 &min, idVec3 &max, const idDrawVert *src, const int count ) {
+	__m256 vmin = _mm256_set1_ps( idMath::INFINITY );
+	__m256 vmax = _mm256_set1_ps( -idMath::INFINITY );
+	int i;
+
+	assert( sizeof( idDrawVert ) == DRAWVERT_SIZE_FLOATS * sizeof( float ) );
+
+	// the fourth lane loads st[0] and is ignored
+	for ( i = 0; i + 2 <= count; i += 2 ) {
+		const __m256 v = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( src[i+0].xyz.ToFloatPtr() ) ), _mm_loadu_ps( src[i+1].xyz.ToFloatPtr() ), 1 );
+		vmin = _mm256_min_ps( vmin, v );
+		vmax = _mm256_max_ps( vmax, v );
+	}
+
+	__m128 m0 = HorizontalMin( vmin );
+	__m128 m1 = HorizontalMax( vmax );
+	if ( i < count ) {
+		const __m128 v = _mm_loadu_ps( src[i].xyz.ToFloatPtr() );
+		m0 = _mm_min_ps( m0, v );
+		m1 = _mm_max_ps( m1, v );
+	}
+
+	ALIGN16( float mins[4] );
+	ALIGN16( float maxs[4] );
+	_mm_store_ps( mins, m0 );
+	_mm_store_ps( maxs, m1 );
+	min.Set( mins[0], mins[1], mins[2] );
+	max.Set( maxs[0], maxs[1], maxs[2] );
+}
+
+/*
+============
+idSIMD_AVX2::MinMax
+============
+*/
+ID_AVX2_TARGET void VPCALL idSIMD_AVX2::MinMax( idVec3 &min, idVec3 &max, const idDrawVert *src, const int *indexes, const int count ) {
+	__m256 vmin = _mm256_set1_ps( idMath::INFINITY );
+	__m256 vmax = _mm256_set1_ps( -idMath::INFINITY );
+	int i;
+
+	for ( i = 0; i + 2 <= count; i += 2 ) {
+		const __m256 v = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( src[indexes[i+0]].xyz.ToFloatPtr() ) ), _mm_loadu_ps( src[indexes[i+1]].xyz.ToFloatPtr() ), 1 );
+		vmin = _mm256_min_ps( vmin, v );
+		vmax = _mm256_max_ps( vmax, v );
+	}
+
+	__m128 m0 = HorizontalMin( vmin );
+	__m128 m1 = HorizontalMax( vmax );
+	if ( i < count ) {
+		const __m128 v = _mm_loadu_ps( src[indexes[i]].xyz.ToFloatPtr() );
+		m0 = _mm_min_ps( m0, v );
+		m1 = _mm_max_ps( m1, v );
+	}
+
+	ALIGN16( float mins[4] );
+	ALIGN16( float maxs[4] );
+	_mm_store_ps( mins, m0 );
+	_mm_store_ps( maxs, m1 );
+	min.Set( mins[0], mins[1], mins[2] );
+	max.Set( maxs[0], maxs[1], maxs[2] );
+}
+
+/*
+============
+idSIMD_AVX2::BlendJoints
+
+  Eight joints at a time are gathered into SoA registers and slerped with the
+  same 16 bit approximations idQuat::Slerp uses.
+============
+*/
+ID_AVX2_TARGET void VPCALL idSIMD_AVX2::BlendJoints( idJointQuat *joints, const idJointQuat *blendJoints, const float lerp, const int *index, const int numJoints ) {
+	int i;
+
+	if ( lerp <= 0.0f ) {
+		return;
+	} else if ( lerp >= 1.0f ) {
+		for ( i = 0; i < numJoints; i++ ) {
+			int j = index[i];
+			joints[j] = blendJoints[j];
+		}
+		return;
+	}
+
+	assert( sizeof( idJointQuat ) == JOINTQUAT_SIZE_FLOATS * sizeof( float ) );
+
+	const float *from = joints[0].q.ToFloatPtr();
+	const float *to = blendJoints[0].q.ToFloatPtr();
+	const __m256i stride = _mm256_set1_epi32( JOINTQUAT_SIZE_FLOATS );
+	const __m256 signBit = _mm256_castsi256_ps( _mm256_set1_epi32( 1 << 31 ) );
+	const __m256 one = _mm256_set1_ps( 1.0f );
+	const __m256 t = _mm256_set1_ps( lerp );
+	const __m256 omt = _mm256_set1_ps( 1.0f - lerp );
+	float result[JOINTQUAT_SIZE_FLOATS][8];
+
+	for ( i = 0; i + 8 <= numJoints; i += 8 ) {
+		const __m256i offsets = _mm256_mullo_epi32( _mm256_loadu_si256( (const __m256i *)( index + i ) ), stride );
+
+		__m256 ax = _mm256_i32gather_ps( from + 0, offsets, 4 );
+		__m256 ay = _mm256_i32gather_ps( from + 1, offsets, 4 );
+		__m256 az = _mm256_i32gather_ps( from + 2, offsets, 4 );
+		__m256 aw = _mm256_i32gather_ps( from + 3, offsets, 4 );
+		__m256 bx = _mm256_i32gather_ps( to + 0, offsets, 4 );
+		__m256 by = _mm256_i32gather_ps( to + 1, offsets, 4 );
+		__m256 bz = _mm256_i32gather_ps( to + 2, offsets, 4 );
+		__m256 bw = _mm256_i32gather_ps( to + 3, offsets, 4 );
+
+		__m256 cosom = _mm256_mul_ps( ax, bx );
+		cosom = _mm256_fmadd_ps( ay, by, cosom );
+		cosom = _mm256_fmadd_ps( az, bz, cosom );
+		cosom = _mm256_fmadd_ps( aw, bw, cosom );
+
+		// take the shortest path
+		const __m256 sign = _mm256_and_ps( cosom, signBit );
+		cosom = _mm256_xor_ps( cosom, sign );
+		bx = _mm256_xor_ps( bx, sign );
+		by = _mm256_xor_ps( by, sign );
+		bz = _mm256_xor_ps( bz, sign );
+		bw = _mm256_xor_ps( bw, sign );
+
+		__m256 scale0 = _mm256_fnmadd_ps( cosom, cosom, one );
+		const __m256 sinom = RSqrt( scale0 );
+		const __m256 omega = ATan16( _mm256_mul_ps( scale0, sinom ), cosom );
+		scale0 = _mm256_mul_ps( Sin16( _mm256_mul_ps( omt, omega ) ), sinom );
+		__m256 scale1 = _mm256_mul_ps( Sin16( _mm256_mul_ps( t, omega ) ), sinom );
+
+		// fall back to a linear blend for nearly identical quaternions
+		const __m256 useSlerp = _mm256_cmp_ps( _mm256_sub_ps( one, cosom ), _mm256_set1_ps( 1e-6f ), _CMP_GT_OQ );
+		scale0 = _mm256_blendv_ps( omt, scale0, useSlerp );
+		scale1 = _mm256_blendv_ps( t, scale1, useSlerp );
+
+		_mm256_storeu_ps( result[0], _mm256_fmadd_ps( scale0, ax, _mm256_mul_ps( scale1, bx ) ) );
+		_mm256_storeu_ps( result[1], _mm256_fmadd_ps( scale0, ay, _mm256_mul_ps( scale1, by ) ) );
+		_mm256_storeu_ps( result[2], _mm256_fmadd_ps( scale0, az, _mm256_mul_ps( scale1, bz ) ) );
+		_mm256_storeu_ps( result[3], _mm256_fmadd_ps( scale0, aw, _mm256_mul_ps( scale1, bw ) ) );
+
+		for ( int k = 4; k < JOINTQUAT_SIZE_FLOATS; k++ ) {
+			const __m256 a = _mm256_i32gather_ps( from + k, offsets, 4 );
+			const __m256 b = _mm256_i32gather_ps( to + k, offsets, 4 );
+			_mm256_storeu_ps( result[k], _mm256_fmadd_ps( t, _mm256_sub_ps( b, a ), a ) );
+		}
+
+		for ( int k = 0; k < 8; k++ ) {
+			float *dst = joints[index[i+k]].q.ToFloatPtr();
+			for ( int c = 0; c < JOINTQUAT_SIZE_FLOATS; c++ ) {
+				dst[c] = result[c][k];
+			}
+		}
+	}
+
+	for ( ; i < numJoints; i++ ) {
+		int j = index[i];
+		joints[j].q.Slerp( joints[j].q, blendJoints[j].q, lerp );
+		joints[j].t.Lerp( joints[j].t, blendJoints[j].t, lerp );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::ConvertJointQuatsToJointMats
+============
+*/
+ID_AVX2_TARGET void VPCALL idSIMD_AVX2::ConvertJointQuatsToJointMats( idJointMat *jointMats, const idJointQuat *jointQuats, const int numJoints ) {
+	int i;
+
+	assert( sizeof( idJointQuat ) == JOINTQUAT_SIZE_FLOATS * sizeof( float ) );
+	assert( sizeof( idJointMat ) == JOINTMAT_SIZE_FLOATS * sizeof( float ) );
+
+	const __m256i offsets = _mm256_setr_epi32( 0, 7, 14, 21, 28, 35, 42, 49 );
+	const __m256 one = _mm256_set1_ps( 1.0f );
+	float result[JOINTMAT_SIZE_FLOATS][8];
+
+	for ( i = 0; i + 8 <= numJoints; i += 8 ) {
+		const float *q = jointQuats[i].q.ToFloatPtr();
+
+		const __m256 x = _mm256_i32gather_ps( q + 0, offsets, 4 );
+		const __m256 y = _mm256_i32gather_ps( q + 1, offsets, 4 );
+		const __m256 z = _mm256_i32gather_ps( q + 2, offsets, 4 );
+		const __m256 w = _mm256_i32gather_ps( q + 3, offsets, 4 );
+
+		const __m256 x2 = _mm256_add_ps( x, x );
+		const __m256 y2 = _mm256_add_ps( y, y );
+		const __m256 z2 = _mm256_add_ps( z, z );
+
+		const __m256 xx = _mm256_mul_ps( x, x2 );
+		const __m256 xy = _mm256_mul_ps( x, y2 );
+		const __m256 xz = _mm256_mul_ps( x, z2 );
+		const __m256 yy = _mm256_mul_ps( y, y2 );
+		const __m256 yz = _mm256_mul_ps( y, z2 );
+		const __m256 zz = _mm256_mul_ps( z, z2 );
+		const __m256 wx = _mm256_mul_ps( w, x2 );
+		const __m256 wy = _mm256_mul_ps( w, y2 );
+		const __m256 wz = _mm256_mul_ps( w, z2 );
+
+		// same layout as idJointMat::SetRotation( q.ToMat3() ) and SetTranslation( t )
+		_mm256_storeu_ps( result[ 0], _mm256_sub_ps( one, _mm256_add_ps( yy, zz ) ) );
+		_mm256_storeu_ps( result[ 1], _mm256_add_ps( xy, wz ) );
+		_mm256_storeu_ps( result[ 2], _mm256_sub_ps( xz, wy ) );
+		_mm256_storeu_ps( result[ 3], _mm256_i32gather_ps( q + 4, offsets, 4 ) );
+		_mm256_storeu_ps( result[ 4], _mm256_sub_ps( xy, wz ) );
+		_mm256_storeu_ps( result[ 5], _mm256_sub_ps( one, _mm256_add_ps( xx, zz ) ) );
+		_mm256_storeu_ps( result[ 6], _mm256_add_ps( yz, wx ) );
+		_mm256_storeu_ps( result[ 7], _mm256_i32gather_ps( q + 5, offsets, 4 ) );
+		_mm256_storeu_ps( result[ 8], _mm256_add_ps( xz, wy ) );
+		_mm256_storeu_ps( result[ 9], _mm256_sub_ps( yz, wx ) );
+		_mm256_storeu_ps( result[10], _mm256_sub_ps( one, _mm256_add_ps( xx, yy ) ) );
+		_mm256_storeu_ps( result[11], _mm256_i32gather_ps( q + 6, offsets, 4 ) );
+
+		for ( int k = 0; k < 8; k++ ) {
+			float *dst = jointMats[i+k].ToFloatPtr();
+			for ( int c = 0; c < JOINTMAT_SIZE_FLOATS; c++ ) {
+				dst[c] = result[c][k];
+			}
+		}
+	}
+
+	for ( ; i < numJoints; i++ ) {
+		jointMats[i].SetRotation( jointQuats[i].q.ToMat3() );
+		jointMats[i].SetTranslation( jointQuats[i].t );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::TransformVerts
+
+  The weighted joint rows are accumulated with FMA and only reduced to a
+  position once per vertex.
+============
+*/
+ID_AVX2_TARGET void VPCALL idSIMD_AVX2::TransformVerts( idDrawVert *verts, const int numVerts, const idJointMat *joints, const idVec4 *weights, const int *index, const int numWeights ) {
+	const byte *jointsPtr = (const byte *)joints;
+	int i, j;
+
+	for ( j = i = 0; i < numVerts; i++ ) {
+		const float *m = (const float *)( jointsPtr + index[j*2+0] );
+		__m256 w = _mm256_broadcast_ps( (const __m128 *)weights[j].ToFloatPtr() );
+		__m256 row01 = _mm256_mul_ps( _mm256_loadu_ps( m + 0 ), w );
+		__m128 row2 = _mm_mul_ps( _mm_loadu_ps( m + 8 ), _mm256_castps256_ps128( w ) );
+
+		while ( index[j*2+1] == 0 ) {
+			j++;
+			m = (const float *)( jointsPtr + index[j*2+0] );
+			w = _mm256_broadcast_ps( (const __m128 *)weights[j].ToFloatPtr() );
+			row01 = _mm256_fmadd_ps( _mm256_loadu_ps( m + 0 ), w, row01 );
+			row2 = _mm_fmadd_ps( _mm_loadu_ps( m + 8 ), _mm256_castps256_ps128( w ), row2 );
+		}
+		j++;
+
+		const __m128 r01 = _mm_hadd_ps( _mm256_castps256_ps128( row01 ), _mm256_extractf128_ps( row01, 1 ) );
+		const __m128 r22 = _mm_hadd_ps( row2, row2 );
+		const __m128 xyz = _mm_hadd_ps( r01, r22 );
+
+		float *dst = verts[i].xyz.ToFloatPtr();
+		_mm_storel_pi( (__m64 *)dst, xyz );
+		_mm_store_ss( dst + 2, _mm_movehl_ps( xyz, xyz ) );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::TracePointCull
+
+  Two vertices are tested against the four planes per iteration.
+============
+*/
+ID_AVX2_TARGET void VPCALL idSIMD_AVX2::TracePointCull( byte *cullBits, byte &totalOr, const float radius, const idPlane *planes, const idDrawVert *verts, const int numVerts ) {
+	__m128 p0 = _mm_loadu_ps( planes[0].ToFloatPtr() );
+	__m128 p1 = _mm_loadu_ps( planes[1].ToFloatPtr() );
+	__m128 p2 = _mm_loadu_ps( planes[2].ToFloatPtr() );
+	__m128 p3 = _mm_loadu_ps( planes[3].ToFloatPtr() );
+	_MM_TRANSPOSE4_PS( p0, p1, p2, p3 );
+
+	const __m256 px = _mm256_insertf128_ps( _mm256_castps128_ps256( p0 ), p0, 1 );
+	const __m256 py = _mm256_insertf128_ps( _mm256_castps128_ps256( p1 ), p1, 1 );
+	const __m256 pz = _mm256_insertf128_ps( _mm256_castps128_ps256( p2 ), p2, 1 );
+	const __m256 pd = _mm256_insertf128_ps( _mm256_castps128_ps256( p3 ), p3, 1 );
+	const __m256 r = _mm256_set1_ps( radius );
+	int tOr = 0;
+	int i;
+
+	for ( i = 0; i + 2 <= numVerts; i += 2 ) {
+		const __m256 v = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( verts[i+0].xyz.ToFloatPtr() ) ), _mm_loadu_ps( verts[i+1].xyz.ToFloatPtr() ), 1 );
+		__m256 d = _mm256_fmadd_ps( pz, _mm256_permute_ps( v, _MM_SHUFFLE( 2, 2, 2, 2 ) ), pd );
+		d = _mm256_fmadd_ps( py, _mm256_permute_ps( v, _MM_SHUFFLE( 1, 1, 1, 1 ) ), d );
+		d = _mm256_fmadd_ps( px, _mm256_permute_ps( v, _MM_SHUFFLE( 0, 0, 0, 0 ) ), d );
+
+		const int front = _mm256_movemask_ps( _mm256_add_ps( d, r ) );
+		const int back = _mm256_movemask_ps( _mm256_sub_ps( d, r ) );
+		const int bits0 = ( ( front & 0x0F ) | ( ( back & 0x0F ) << 4 ) ) ^ 0x0F;
+		const int bits1 = ( ( front >> 4 ) | ( back & 0xF0 ) ) ^ 0x0F;
+
+		cullBits[i+0] = (byte)bits0;
+		cullBits[i+1] = (byte)bits1;
+		tOr |= bits0 | bits1;
+	}
+
+	if ( i < numVerts ) {
+		const __m128 v = _mm_loadu_ps( verts[i].xyz.ToFloatPtr() );
+		__m128 d = _mm_fmadd_ps( p2, _mm_shuffle_ps( v, v, _MM_SHUFFLE( 2, 2, 2, 2 ) ), p3 );
+		d = _mm_fmadd_ps( p1, _mm_shuffle_ps( v, v, _MM_SHUFFLE( 1, 1, 1, 1 ) ), d );
+		d = _mm_fmadd_ps( p0, _mm_shuffle_ps( v, v, _MM_SHUFFLE( 0, 0, 0, 0 ) ), d );
+
+		const int front = _mm_movemask_ps( _mm_add_ps( d, _mm256_castps256_ps128( r ) ) );
+		const int back = _mm_movemask_ps( _mm_sub_ps( d, _mm256_castps256_ps128( r ) ) );
+		const int bits = ( front | ( back << 4 ) ) ^ 0x0F;
+
+		cullBits[i] = (byte)bits;
+		tOr |= bits;
+	}
+
+	totalOr = (byte)tOr;
+}
+
+/*
+============
+idSIMD_AVX2::DeriveTangents
+
+	Derives the normal and orthogonal tangent vectors for the triangle vertices.
+	The triangle planes and tangents are calculated eight triangles at a time,
+	the per vertex accumulation stays in triangle order so the results match
+	idSIMD_Generic::DeriveTangents.
+============
+*/
+ID_AVX2_TARGET void VPCALL idSIMD_AVX2::DeriveTangents( idPlane *planes, idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes ) {
+	enum { NX, NY, NZ, ND, T0X, T0Y, T0Z, T1X, T1Y, T1Z, NUM_RESULTS };
+
+	assert( sizeof( idDrawVert ) == DRAWVERT_SIZE_FLOATS * sizeof( float ) );
+
+	bool *used = (bool *)_alloca16( numVerts * sizeof( used[0] ) );
+	memset( used, 0, numVerts * sizeof( used[0] ) );
+
+	const float *vf = verts[0].xyz.ToFloatPtr();
+	const __m256i triOffsets = _mm256_setr_epi32( 0, 3, 6, 9, 12, 15, 18, 21 );
+	const __m256i vertStride = _mm256_set1_epi32( DRAWVERT_SIZE_FLOATS );
+	const __m256 signBit = _mm256_castsi256_ps( _mm256_set1_epi32( 1 << 31 ) );
+
+	float result[NUM_RESULTS][8];
+	int triVerts[3][8];
+
+	idPlane *planesPtr = planes;
+	for ( int i = 0; i < numIndexes; i += 8 * 3 ) {
+		const int numTris = Min( 8, ( numIndexes - i ) / 3 );
+
+		if ( numTris == 8 ) {
+			const __m256i i0 = _mm256_i32gather_epi32( indexes + i + 0, triOffsets, 4 );
+			const __m256i i1 = _mm256_i32gather_epi32( indexes + i + 1, triOffsets, 4 );
+			const __m256i i2 = _mm256_i32gather_epi32( indexes + i + 2, triOffsets, 4 );
+			_mm256_storeu_si256( (__m256i *)triVerts[0], i0 );
+			_mm256_storeu_si256( (__m256i *)triVerts[1], i1 );
+			_mm256_storeu_si256( (__m256i *)triVerts[2], i2 );
+
+			const __m256i o0 = _mm256_mullo_epi32( i0, vertStride );
+			const __m256i o1 = _mm256_mullo_epi32( i1, vertStride );
+			const __m256i o2 = _mm256_mullo_epi32( i2, vertStride );
+
+			const __m256 ax = _mm256_i32gather_ps( vf + 0, o0, 4 );
+			const __m256 ay = _mm256_i32gather_ps( vf + 1, o0, 4 );
+			const __m256 az = _mm256_i32gather_ps( vf + 2, o0, 4 );
+			const __m256 as = _mm256_i32gather_ps( vf + 3, o0, 4 );
+			const __m256 at = _mm256_i32gather_ps( vf + 4, o0, 4 );
+
+			const __m256 d0x = _mm256_sub_ps( _mm256_i32gather_ps( vf + 0, o1, 4 ), ax );
+			const __m256 d0y = _mm256_sub_ps( _mm256_i32gather_ps( vf + 1, o1, 4 ), ay );
+			const __m256 d0z = _mm256_sub_ps( _mm256_i32gather_ps( vf + 2, o1, 4 ), az );
+			const __m256 d0s = _mm256_sub_ps( _mm256_i32gather_ps( vf + 3, o1, 4 ), as );
+			const __m256 d0t = _mm256_sub_ps( _mm256_i32gather_ps( vf + 4, o1, 4 ), at );
+
+			const __m256 d1x = _mm256_sub_ps( _mm256_i32gather_ps( vf + 0, o2, 4 ), ax );
+			const __m256 d1y = _mm256_sub_ps( _mm256_i32gather_ps( vf + 1, o2, 4 ), ay );
+			const __m256 d1z = _mm256_sub_ps( _mm256_i32gather_ps( vf + 2, o2, 4 ), az );
+			const __m256 d1s = _mm256_sub_ps( _mm256_i32gather_ps( vf + 3, o2, 4 ), as );
+			const __m256 d1t = _mm256_sub_ps( _mm256_i32gather_ps( vf + 4, o2, 4 ), at );
+
+			// no FMA for the cross products, a fused multiply-subtract of two equal
+			// products isn't zero and degenerate triangles would get a random normal
+			__m256 nx = _mm256_sub_ps( _mm256_mul_ps( d1y, d0z ), _mm256_mul_ps( d1z, d0y ) );
+			__m256 ny = _mm256_sub_ps( _mm256_mul_ps( d1z, d0x ), _mm256_mul_ps( d1x, d0z ) );
+			__m256 nz = _mm256_sub_ps( _mm256_mul_ps( d1x, d0y ), _mm256_mul_ps( d1y, d0x ) );
+			__m256 f = RSqrt( _mm256_fmadd_ps( nx, nx, _mm256_fmadd_ps( ny, ny, _mm256_mul_ps( nz, nz ) ) ) );
+			nx = _mm256_mul_ps( nx, f );
+			ny = _mm256_mul_ps( ny, f );
+			nz = _mm256_mul_ps( nz, f );
+			_mm256_storeu_ps( result[NX], nx );
+			_mm256_storeu_ps( result[NY], ny );
+			_mm256_storeu_ps( result[NZ], nz );
+			_mm256_storeu_ps( result[ND], _mm256_xor_ps( _mm256_fmadd_ps( nx, ax, _mm256_fmadd_ps( ny, ay, _mm256_mul_ps( nz, az ) ) ), signBit ) );
+
+			// area sign bit
+			const __m256 signs = _mm256_and_ps( _mm256_sub_ps( _mm256_mul_ps( d0s, d1t ), _mm256_mul_ps( d0t, d1s ) ), signBit );
+
+			// first tangent
+			__m256 tx = _mm256_sub_ps( _mm256_mul_ps( d0x, d1t ), _mm256_mul_ps( d0t, d1x ) );
+			__m256 ty = _mm256_sub_ps( _mm256_mul_ps( d0y, d1t ), _mm256_mul_ps( d0t, d1y ) );
+			__m256 tz = _mm256_sub_ps( _mm256_mul_ps( d0z, d1t ), _mm256_mul_ps( d0t, d1z ) );
+			f = _mm256_xor_ps( RSqrt( _mm256_fmadd_ps( tx, tx, _mm256_fmadd_ps( ty, ty, _mm256_mul_ps( tz, tz ) ) ) ), signs );
+			_mm256_storeu_ps( result[T0X], _mm256_mul_ps( tx, f ) );
+			_mm256_storeu_ps( result[T0Y], _mm256_mul_ps( ty, f ) );
+			_mm256_storeu_ps( result[T0Z], _mm256_mul_ps( tz, f ) );
+
+			// second tangent
+			tx = _mm256_sub_ps( _mm256_mul_ps( d0s, d1x ), _mm256_mul_ps( d0x, d1s ) );
+			ty = _mm256_sub_ps( _mm256_mul_ps( d0s, d1y ), _mm256_mul_ps( d0y, d1s ) );
+			tz = _mm256_sub_ps( _mm256_mul_ps( d0s, d1z ), _mm256_mul_ps( d0z, d1s ) );
+			f = _mm256_xor_ps( RSqrt( _mm256_fmadd_ps( tx, tx, _mm256_fmadd_ps( ty, ty, _mm256_mul_ps( tz, tz ) ) ) ), signs );
+			_mm256_storeu_ps( result[T1X], _mm256_mul_ps( tx, f ) );
+			_mm256_storeu_ps( result[T1Y], _mm256_mul_ps( ty, f ) );
+			_mm256_storeu_ps( result[T1Z], _mm256_mul_ps( tz, f ) );
+		} else {
+			for ( int k = 0; k < numTris; k++ ) {
+				const int *tri = indexes + i + k * 3;
+				const idDrawVert *a = verts + tri[0];
+				const idDrawVert *b = verts + tri[1];
+				const idDrawVert *c = verts + tri[2];
+				float d0[5], d1[5], f, area;
+				unsigned int signBit;
+				idVec3 n, t0, t1;
+
+				triVerts[0][k] = tri[0];
+				triVerts[1][k] = tri[1];
+				triVerts[2][k] = tri[2];
+
+				for ( int j = 0; j < 3; j++ ) {
+					d0[j] = b->xyz[j] - a->xyz[j];
+					d1[j] = c->xyz[j] - a->xyz[j];
+				}
+				for ( int j = 0; j < 2; j++ ) {
+					d0[3+j] = b->st[j] - a->st[j];
+					d1[3+j] = c->st[j] - a->st[j];
+				}
+
+				n[0] = d1[1] * d0[2] - d1[2] * d0[1];
+				n[1] = d1[2] * d0[0] - d1[0] * d0[2];
+				n[2] = d1[0] * d0[1] - d1[1] * d0[0];
+				n *= idMath::RSqrt( n.LengthSqr() );
+
+				area = d0[3] * d1[4] - d0[4] * d1[3];
+				signBit = ( *(unsigned int *)&area ) & ( 1 << 31 );
+
+				t0[0] = d0[0] * d1[4] - d0[4] * d1[0];
+				t0[1] = d0[1] * d1[4] - d0[4] * d1[1];
+				t0[2] = d0[2] * d1[4] - d0[4] * d1[2];
+				f = idMath::RSqrt( t0.LengthSqr() );
+				*(unsigned int *)&f ^= signBit;
+				t0 *= f;
+
+				t1[0] = d0[3] * d1[0] - d0[0] * d1[3];
+				t1[1] = d0[3] * d1[1] - d0[1] * d1[3];
+				t1[2] = d0[3] * d1[2] - d0[2] * d1[3];
+				f = idMath::RSqrt( t1.LengthSqr() );
+				*(unsigned int *)&f ^= signBit;
+				t1 *= f;
+
+				result[NX][k] = n[0];
+				result[NY][k] = n[1];
+				result[NZ][k] = n[2];
+				result[ND][k] = -( n * a->xyz );
+				result[T0X][k] = t0[0];
+				result[T0Y][k] = t0[1];
+				result[T0Z][k] = t0[2];
+				result[T1X][k] = t1[0];
+				result[T1Y][k] = t1[1];
+				result[T1Z][k] = t1[2];
+			}
+		}
+
+		for ( int k = 0; k < numTris; k++ ) {
+			const idVec3 n( result[NX][k], result[NY][k], result[NZ][k] );
+			const idVec3 t0( result[T0X][k], result[T0Y][k], result[T0Z][k] );
+			const idVec3 t1( result[T1X][k], result[T1Y][k], result[T1Z][k] );
+
+			planesPtr->SetNormal( n );
+			planesPtr->SetDist( -result[ND][k] );
+			planesPtr++;
+
+			for ( int j = 0; j < 3; j++ ) {
+				const int v = triVerts[j][k];
+				idDrawVert *a = verts + v;
+				if ( used[v] ) {
+					a->normal += n;
+					a->tangents[0] += t0;
+					a->tangents[1] += t1;
+				} else {
+					a->normal = n;
+					a->tangents[0] = t0;
+					a->tangents[1] = t1;
+					used[v] = true;
+				}
+			}
+		}
+	}
+}
+
+/*
+============
+idSIMD_AVX2::CreateShadowCache
+============
+*/
+ID_AVX2_TARGET int VPCALL idSIMD_AVX2::CreateShadowCache( idVec4 *vertexCache, int *vertRemap, const idVec3 &lightOrigin, const idDrawVert *verts, const int numVerts ) {
+	const __m128 light = _mm_setr_ps( lightOrigin[0], lightOrigin[1], lightOrigin[2], 0.0f );
+	const __m128 one = _mm_set1_ps( 1.0f );
+	const __m128 zero = _mm_setzero_ps();
+	int outVerts = 0;
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		if ( vertRemap[i] ) {
+			continue;
+		}
+		// the fourth lane loads st[0] and is replaced
+		const __m128 v = _mm_loadu_ps( verts[i].xyz.ToFloatPtr() );
+		const __m128 v0 = _mm_blend_ps( v, one, 0x08 );
+		const __m128 v1 = _mm_blend_ps( _mm_sub_ps( v, light ), zero, 0x08 );
+		_mm256_storeu_ps( vertexCache[outVerts].ToFloatPtr(), _mm256_insertf128_ps( _mm256_castps128_ps256( v0 ), v1, 1 ) );
+		vertRemap[i] = outVerts;
+		outVerts += 2;
+	}
+	return outVerts;
+}
+
+/*
+============
+idSIMD_AVX2::CreateVertexProgramShadowCache
+============
+*/
+ID_AVX2_TARGET int VPCALL idSIMD_AVX2::CreateVertexProgramShadowCache( idVec4 *vertexCache, const idDrawVert *verts, const int numVerts ) {
+	const __m256 w = _mm256_setr_ps( 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f );
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		const __m128 v = _mm_loadu_ps( verts[i].xyz.ToFloatPtr() );
+		const __m256 vv = _mm256_insertf128_ps( _mm256_castps128_ps256( v ), v, 1 );
+		_mm256_storeu_ps( vertexCache[i*2].ToFloatPtr(), _mm256_blend_ps( vv, w, 0x88 ) );
+	}
+	return numVerts * 2;
+}
+
+/*
+============
+SetupMixRamp
+
+  builds the speaker volumes for the first group of samples and the increment
+  per group, laid out like the interleaved mix buffer
+============
+*/
+static void SetupMixRamp( float *volumes, float *increments, const int numSpeakers, const int samplesPerGroup, const float *lastV, const float *currentV ) {
+	for ( int k = 0; k < samplesPerGroup; k++ ) {
+		for ( int s = 0; s < numSpeakers; s++ ) {
+			const float inc = ( currentV[s] - lastV[s] ) / MIXBUFFER_SAMPLES;
+			volumes[k * numSpeakers + s] = lastV[s] + k * inc;
+			increments[k * numSpeakers + s] = samplesPerGroup * inc;
+		}
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MixSoundTwoSpeakerMono
+============
+*/
+ID_AVX2_TARGET void VPCALL idSIMD_AVX2::MixSoundTwoSpeakerMono( float *mixBuffer, const float *samples, const int numSamples, const float lastV[2], const float currentV[2] ) {
+	float volumes[8], increments[8];
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	SetupMixRamp( volumes, increments, 2, 4, lastV, currentV );
+
+	const __m256i spread = _mm256_setr_epi32( 0, 0, 1, 1, 2, 2, 3, 3 );
+	const __m256 inc = _mm256_loadu_ps( increments );
+	__m256 vol = _mm256_loadu_ps( volumes );
+
+	for ( int j = 0; j < MIXBUFFER_SAMPLES; j += 4 ) {
+		const __m256 s = _mm256_permutevar8x32_ps( _mm256_castps128_ps256( _mm_loadu_ps( samples + j ) ), spread );
+		_mm256_storeu_ps( mixBuffer + j * 2, _mm256_fmadd_ps( s, vol, _mm256_loadu_ps( mixBuffer + j * 2 ) ) );
+		vol = _mm256_add_ps( vol, inc );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MixSoundTwoSpeakerStereo
+============
+*/
+ID_AVX2_TARGET void VPCALL idSIMD_AVX2::MixSoundTwoSpeakerStereo( float *mixBuffer, const float *samples, const int numSamples, const float lastV[2], const float currentV[2] ) {
+	float volumes[8], increments[8];
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	SetupMixRamp( volumes, increments, 2, 4, lastV, currentV );
+
+	const __m256 inc = _mm256_loadu_ps( increments );
+	__m256 vol = _mm256_loadu_ps( volumes );
+
+	for ( int j = 0; j < MIXBUFFER_SAMPLES; j += 4 ) {
+		const __m256 s = _mm256_loadu_ps( samples + j * 2 );
+		_mm256_storeu_ps( mixBuffer + j * 2, _mm256_fmadd_ps( s, vol, _mm256_loadu_ps( mixBuffer + j * 2 ) ) );
+		vol = _mm256_add_ps( vol, inc );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MixSoundSixSpeakerMono
+============
+*/
+ID_AVX2_TARGET void VPCALL idSIMD_AVX2::MixSoundSixSpeakerMono( float *mixBuffer, const float *samples, const int numSamples, const float lastV[6], const float currentV[6] ) {
+	float volumes[24], increments[24];
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	SetupMixRamp( volumes, increments, 6, 4, lastV, currentV );
+
+	// four samples fill three registers of six speakers each
+	const __m256i spread0 = _mm256_setr_epi32( 0, 0, 0, 0, 0, 0, 1, 1 );
+	const __m256i spread1 = _mm256_setr_epi32( 1, 1, 1, 1, 2, 2, 2, 2 );
+	const __m256i spread2 = _mm256_setr_epi32( 2, 2, 3, 3, 3, 3, 3, 3 );
+	const __m256 inc0 = _mm256_loadu_ps( increments + 0 );
+	const __m256 inc1 = _mm256_loadu_ps( increments + 8 );
+	const __m256 inc2 = _mm256_loadu_ps( increments + 16 );
+	__m256 vol0 = _mm256_loadu_ps( volumes + 0 );
+	__m256 vol1 = _mm256_loadu_ps( volumes + 8 );
+	__m256 vol2 = _mm256_loadu_ps( volumes + 16 );
+
+	for ( int i = 0; i < MIXBUFFER_SAMPLES; i += 4 ) {
+		const __m256 s = _mm256_castps128_ps256( _mm_loadu_ps( samples + i ) );
+		float *mix = mixBuffer + i * 6;
+		_mm256_storeu_ps( mix + 0, _mm256_fmadd_ps( _mm256_permutevar8x32_ps( s, spread0 ), vol0, _mm256_loadu_ps( mix + 0 ) ) );
+		_mm256_storeu_ps( mix + 8, _mm256_fmadd_ps( _mm256_permutevar8x32_ps( s, spread1 ), vol1, _mm256_loadu_ps( mix + 8 ) ) );
+		_mm256_storeu_ps( mix + 16, _mm256_fmadd_ps( _mm256_permutevar8x32_ps( s, spread2 ), vol2, _mm256_loadu_ps( mix + 16 ) ) );
+		vol0 = _mm256_add_ps( vol0, inc0 );
+		vol1 = _mm256_add_ps( vol1, inc1 );
+		vol2 = _mm256_add_ps( vol2, inc2 );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MixSoundSixSpeakerStereo
+============
+*/
+ID_AVX2_TARGET void VPCALL idSIMD_AVX2::MixSoundSixSpeakerStereo( float *mixBuffer, const float *samples, const int numSamples, const float lastV[6], const float currentV[6] ) {
+	float volumes[24], increments[24];
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	SetupMixRamp( volumes, increments, 6, 4, lastV, currentV );
+
+	// the right channel goes to SPEAKER_RIGHT and SPEAKER_BACKRIGHT, the left channel to the rest
+	const __m256i spread0 = _mm256_setr_epi32( 0, 1, 0, 0, 0, 1, 2, 3 );
+	const __m256i spread1 = _mm256_setr_epi32( 2, 2, 2, 3, 4, 5, 4, 4 );
+	const __m256i spread2 = _mm256_setr_epi32( 4, 5, 6, 7, 6, 6, 6, 7 );
+	const __m256 inc0 = _mm256_loadu_ps( increments + 0 );
+	const __m256 inc1 = _mm256_loadu_ps( increments + 8 );
+	const __m256 inc2 = _mm256_loadu_ps( increments + 16 );
+	__m256 vol0 = _mm256_loadu_ps( volumes + 0 );
+	__m256 vol1 = _mm256_loadu_ps( volumes + 8 );
+	__m256 vol2 = _mm256_loadu_ps( volumes + 16 );
+
+	for ( int i = 0; i < MIXBUFFER_SAMPLES; i += 4 ) {
+		const __m256 s = _mm256_loadu_ps( samples + i * 2 );
+		float *mix = mixBuffer + i * 6;
+		_mm256_storeu_ps( mix + 0, _mm256_fmadd_ps( _mm256_permutevar8x32_ps( s, spread0 ), vol0, _mm256_loadu_ps( mix + 0 ) ) );
+		_mm256_storeu_ps( mix + 8, _mm256_fmadd_ps( _mm256_permutevar8x32_ps( s, spread1 ), vol1, _mm256_loadu_ps( mix + 8 ) ) );
+		_mm256_storeu_ps( mix + 16, _mm256_fmadd_ps( _mm256_permutevar8x32_ps( s, spread2 ), vol2, _mm256_loadu_ps( mix + 16 ) ) );
+		vol0 = _mm256_add_ps( vol0, inc0 );
+		vol1 = _mm256_add_ps( vol1, inc1 );
+		vol2 = _mm256_add_ps( vol2, inc2 );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MixedSoundToSamples
+============
+*/
+ID_AVX2_TARGET void VPCALL idSIMD_AVX2::MixedSoundToSamples( short *samples, const float *mixBuffer, const int numSamples ) {
+	const __m256 minSample = _mm256_set1_ps( -32768.0f );
+	const __m256 maxSample = _mm256_set1_ps( 32767.0f );
+	int i;
+
+	for ( i = 0; i + 8 <= numSamples; i += 8 ) {
+		const __m256 f = _mm256_max_ps( _mm256_min_ps( _mm256_loadu_ps( mixBuffer + i ), maxSample ), minSample );
+		const __m256i n = _mm256_cvttps_epi32( f );
+		_mm_storeu_si128( (__m128i *)( samples + i ), _mm_packs_epi32( _mm256_castsi256_si128( n ), _mm256_extracti128_si256( n, 1 ) ) );
+	}
+
+	for ( ; i < numSamples; i++ ) {
+		if ( mixBuffer[i] <= -32768.0f ) {
+			samples[i] = -32768;
+		} else if ( mixBuffer[i] >= 32767.0f ) {
+			samples[i] = 32767;
+		} else {
+			samples[i] = (short) mixBuffer[i];
+		}
+	}
+}
+
+#endif /* ID_SIMD_AVX2 */
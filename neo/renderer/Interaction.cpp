@@ -292,7 +292,7 @@ static srfTriangles_t *R_CreateLightTris( const idRenderEntityLocal *ent,
 	bool		includeBackFaces;
 	int			faceNum;
 
-	tr.pc.c_createLightTris++;
+	R_PerformanceCounters().c_createLightTris++;
 	c_backfaced = 0;
 	c_distance = 0;
 
@@ -823,21 +823,17 @@ The results of this are cached and valid until the light or entity change.
 ====================
 */
 void idInteraction::CreateInteraction( const idRenderModel *model ) {
-	const idMaterial *	lightShader = lightDef->lightShader;
-	const idMaterial*	shader;
-	bool				interactionGenerated;
-	idBounds			bounds;
-
-	tr.pc.c_createInteractions++;
-
-	bounds = model->Bounds( &entityDef->parms );
-
-	// if it doesn't contact the light frustum, none of the surfaces will
-	if ( R_CullLocalBox( bounds, entityDef->modelMatrix, 6, lightDef->frustum ) ) {
+	if ( !CreateInteractionSurfaces( model ) ) {
 		MakeEmpty();
-		return;
 	}
+}
 
+/*
+====================
+R_InteractionShadowGen
+====================
+*/
+static shadowGen_t R_InteractionShadowGen( const idBounds &bounds ) {
 	// use the turbo shadow path
 	shadowGen_t shadowGen = SG_DYNAMIC;
 
@@ -848,6 +844,52 @@ void idInteraction::CreateInteraction( const idRenderModel *model ) {
 		shadowGen = SG_STATIC;
 	}
 
+	return shadowGen;
+}
+
+/*
+====================
+idInteraction::SurfaceNeedsShadowVolume
+====================
+*/
+bool idInteraction::SurfaceNeedsShadowVolume( const idRenderModel *model, const idMaterial *shader, const srfTriangles_t *tri ) const {
+	// if the interaction has shadows and this surface casts a shadow
+	if ( HasShadows() && shader->SurfaceCastsShadow() && tri->silEdges != NULL ) {
+		// if the light has an optimized shadow volume, don't create shadows for any models that are part of the base areas
+		if ( lightDef->parms.prelightModel == NULL || !model->IsStaticWorldModel() || !r_useOptimizedShadows.GetBool() ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+====================
+idInteraction::CreateInteractionSurfaces
+
+Returns false if none of the surfaces generated anything, the
+interaction has to be made empty then.  Doesn't touch the
+interaction lists of the light and entity, so it can run in
+a front end job.
+====================
+*/
+bool idInteraction::CreateInteractionSurfaces( const idRenderModel *model ) {
+	const idMaterial *	lightShader = lightDef->lightShader;
+	const idMaterial*	shader;
+	bool				interactionGenerated;
+	idBounds			bounds;
+
+	R_PerformanceCounters().c_createInteractions++;
+
+	bounds = model->Bounds( &entityDef->parms );
+
+	// if it doesn't contact the light frustum, none of the surfaces will
+	if ( R_CullLocalBox( bounds, entityDef->modelMatrix, 6, lightDef->frustum ) ) {
+		return false;
+	}
+
+	shadowGen_t shadowGen = R_InteractionShadowGen( bounds );
+
 	//
 	// create slots for each of the model's surfaces
 	//
@@ -907,24 +949,19 @@ void idInteraction::CreateInteraction( const idRenderModel *model ) {
 		}
 
 		// if the interaction has shadows and this surface casts a shadow
-		if ( HasShadows() && shader->SurfaceCastsShadow() && tri->silEdges != NULL ) {
-
-			// if the light has an optimized shadow volume, don't create shadows for any models that are part of the base areas
-			if ( lightDef->parms.prelightModel == NULL || !model->IsStaticWorldModel() || !r_useOptimizedShadows.GetBool() ) {
-
-				// this is the only place during gameplay (outside the utilities) that R_CreateShadowVolume() is called
-				sint->shadowTris = R_CreateShadowVolume( entityDef, tri, lightDef, shadowGen, sint->cullInfo );
-				if ( sint->shadowTris ) {
-					if ( shader->Coverage() != MC_OPAQUE || ( !r_skipSuppress.GetBool() && entityDef->parms.suppressSurfaceInViewID ) ) {
-						// if any surface is a shadow-casting perforated or translucent surface, or the
-						// base surface is suppressed in the view (world weapon shadows) we can't use
-						// the external shadow optimizations because we can see through some of the faces
-						sint->shadowTris->numShadowIndexesNoCaps = sint->shadowTris->numIndexes;
-						sint->shadowTris->numShadowIndexesNoFrontCaps = sint->shadowTris->numIndexes;
-					}
+		if ( SurfaceNeedsShadowVolume( model, shader, tri ) ) {
+			// this is the only place during gameplay (outside the utilities) that R_CreateShadowVolume() is called
+			sint->shadowTris = R_CreateShadowVolume( entityDef, tri, lightDef, shadowGen, sint->cullInfo );
+			if ( sint->shadowTris ) {
+				if ( shader->Coverage() != MC_OPAQUE || ( !r_skipSuppress.GetBool() && entityDef->parms.suppressSurfaceInViewID ) ) {
+					// if any surface is a shadow-casting perforated or translucent surface, or the
+					// base surface is suppressed in the view (world weapon shadows) we can't use
+					// the external shadow optimizations because we can see through some of the faces
+					sint->shadowTris->numShadowIndexesNoCaps = sint->shadowTris->numIndexes;
+					sint->shadowTris->numShadowIndexesNoFrontCaps = sint->shadowTris->numIndexes;
 				}
-				interactionGenerated = true;
 			}
+			interactionGenerated = true;
 		}
 
 		// free the cull information when it's no longer needed
@@ -934,9 +971,86 @@ void idInteraction::CreateInteraction( const idRenderModel *model ) {
 	}
 
 	// if none of the surfaces generated anything, don't even bother checking?
-	if ( !interactionGenerated ) {
-		MakeEmpty();
+	return interactionGenerated;
+}
+
+/*
+====================
+R_ShadowVolumesMatch
+====================
+*/
+static bool R_ShadowVolumesMatch( const srfTriangles_t *a, const srfTriangles_t *b ) {
+	if ( a == NULL || b == NULL ) {
+		return ( a == b );
+	}
+	if ( a->numVerts != b->numVerts || a->numIndexes != b->numIndexes
+		|| a->numShadowIndexesNoCaps != b->numShadowIndexesNoCaps
+		|| a->numShadowIndexesNoFrontCaps != b->numShadowIndexesNoFrontCaps
+		|| a->shadowCapPlaneBits != b->shadowCapPlaneBits ) {
+		return false;
+	}
+	if ( memcmp( a->indexes, b->indexes, a->numIndexes * sizeof( a->indexes[0] ) ) != 0 ) {
+		return false;
 	}
+	if ( ( a->shadowVertexes == NULL ) != ( b->shadowVertexes == NULL ) ) {
+		return false;
+	}
+	if ( a->shadowVertexes != NULL && memcmp( a->shadowVertexes, b->shadowVertexes, a->numVerts * sizeof( a->shadowVertexes[0] ) ) != 0 ) {
+		return false;
+	}
+	return true;
+}
+
+/*
+====================
+idInteraction::VerifyShadowSurfaces
+
+Used by r_checkParallelShadows, creates the shadow volumes again on
+the calling thread and compares them with the ones the jobs created.
+====================
+*/
+int idInteraction::VerifyShadowSurfaces( const idRenderModel *model ) {
+	int numMismatches = 0;
+
+	if ( numSurfaces <= 0 ) {
+		return 0;
+	}
+
+	shadowGen_t shadowGen = R_InteractionShadowGen( model->Bounds( &entityDef->parms ) );
+
+	for ( int c = 0 ; c < numSurfaces ; c++ ) {
+		const surfaceInteraction_t *sint = &surfaces[c];
+
+		if ( sint->ambientTris == NULL || sint->shader->Spectrum() != lightDef->lightShader->Spectrum() ) {
+			continue;
+		}
+		if ( !SurfaceNeedsShadowVolume( model, sint->shader, sint->ambientTris ) ) {
+			continue;
+		}
+
+		srfCullInfo_t cullInfo;
+		memset( &cullInfo, 0, sizeof( cullInfo ) );
+		srfTriangles_t *shadowTris = R_CreateShadowVolume( entityDef, sint->ambientTris, lightDef, shadowGen, cullInfo );
+		R_FreeInteractionCullInfo( cullInfo );
+
+		if ( shadowTris != NULL && ( sint->shader->Coverage() != MC_OPAQUE || ( !r_skipSuppress.GetBool() && entityDef->parms.suppressSurfaceInViewID ) ) ) {
+			shadowTris->numShadowIndexesNoCaps = shadowTris->numIndexes;
+			shadowTris->numShadowIndexesNoFrontCaps = shadowTris->numIndexes;
+		}
+
+		if ( !R_ShadowVolumesMatch( shadowTris, sint->shadowTris ) ) {
+			numMismatches++;
+			common->Warning( "shadow volume mismatch: entity %i, light %i, surface %i (%i / %i indexes)",
+				entityDef->index, lightDef->index, c,
+				sint->shadowTris ? sint->shadowTris->numIndexes : 0, shadowTris ? shadowTris->numIndexes : 0 );
+		}
+
+		if ( shadowTris != NULL ) {
+			R_ReallyFreeStaticTriSurf( shadowTris );
+		}
+	}
+
+	return numMismatches;
 }
 
 /*
@@ -1024,12 +1138,34 @@ instantiate the dynamic model to find out
 ==================
 */
 void idInteraction::AddActiveInteraction( void ) {
+	idScreenRect	shadowScissor;
+	idRenderModel *	model;
+
+	if ( !PrepareActiveInteraction( shadowScissor, &model ) ) {
+		return;
+	}
+
+	// actually create the interaction if needed, building light and shadow surfaces as needed
+	if ( IsDeferred() ) {
+		double startTime = Sys_MillisecondsPrecise();
+		CreateInteraction( model );
+		tr.pc.interactionMsec += Sys_MillisecondsPrecise() - startTime;
+	}
+
+	LinkActiveInteraction( shadowScissor );
+}
+
+/*
+==================
+idInteraction::PrepareActiveInteraction
+
+Culls the interaction and makes sure the dynamic model is created,
+returns false if the interaction doesn't need to be added
+==================
+*/
+bool idInteraction::PrepareActiveInteraction( idScreenRect &shadowScissor, idRenderModel **model ) {
 	viewLight_t *	vLight;
 	viewEntity_t *	vEntity;
-	idScreenRect	shadowScissor;
-	idScreenRect	lightScissor;
-	idVec3			localLightOrigin;
-	idVec3			localViewOrigin;
 
 	vLight = lightDef->viewLight;
 	vEntity = entityDef->viewEntity;
@@ -1052,7 +1188,7 @@ void idInteraction::AddActiveInteraction( void ) {
 		// this will also cull the case where the light origin is inside the
 		// view frustum and the entity bounds are outside the view frustum
 		if ( CullInteractionByViewFrustum( tr.viewDef->viewFrustum ) ) {
-			return;
+			return false;
 		}
 
 		// calculate the shadow scissor rectangle
@@ -1061,15 +1197,15 @@ void idInteraction::AddActiveInteraction( void ) {
 
 	// get out before making the dynamic model if the shadow scissor rectangle is empty
 	if ( shadowScissor.IsEmpty() ) {
-		return;
+		return false;
 	}
 
 	// We will need the dynamic surface created to make interactions, even if the
 	// model itself wasn't visible.  This just returns a cached value after it
 	// has been generated once in the view.
-	idRenderModel *model = R_EntityDefDynamicModel( entityDef );
-	if ( model == NULL || model->NumSurfaces() <= 0 ) {
-		return;
+	*model = R_EntityDefDynamicModel( entityDef );
+	if ( *model == NULL || (*model)->NumSurfaces() <= 0 ) {
+		return false;
 	}
 
 	// the dynamic model may have changed since we built the surface list
@@ -1078,10 +1214,25 @@ void idInteraction::AddActiveInteraction( void ) {
 	}
 	dynamicModelFrameCount = entityDef->dynamicModelFrameCount;
 
-	// actually create the interaction if needed, building light and shadow surfaces as needed
-	if ( IsDeferred() ) {
-		CreateInteraction( model );
-	}
+	return true;
+}
+
+/*
+==================
+idInteraction::LinkActiveInteraction
+
+Adds the light and shadow surfaces of a created interaction to the view light
+==================
+*/
+void idInteraction::LinkActiveInteraction( const idScreenRect &shadowScissor ) {
+	viewLight_t *	vLight;
+	viewEntity_t *	vEntity;
+	idScreenRect	lightScissor;
+	idVec3			localLightOrigin;
+	idVec3			localViewOrigin;
+
+	vLight = lightDef->viewLight;
+	vEntity = entityDef->viewEntity;
 
 	R_GlobalPointToLocal( vEntity->modelMatrix, lightDef->globalLightOrigin, localLightOrigin );
 	R_GlobalPointToLocal( vEntity->modelMatrix, tr.viewDef->renderView.vieworg, localViewOrigin );
@@ -150,6 +150,18 @@ public:
 	// calls R_LinkLightSurf() for each one
 	void					AddActiveInteraction( void );
 
+	// AddActiveInteraction() in three steps for the parallel front end.  Preparing and
+	// linking have to run on the main thread, creating the surfaces of a deferred
+	// interaction can run in a job.  If the surfaces didn't generate anything,
+	// MakeEmpty() has to be called before linking
+	bool					PrepareActiveInteraction( idScreenRect &shadowScissor, idRenderModel **model );
+	bool					CreateInteractionSurfaces( const idRenderModel *model );
+	void					LinkActiveInteraction( const idScreenRect &shadowScissor );
+
+	// creates the shadow volumes of all surfaces again and compares them with the
+	// ones created by CreateInteractionSurfaces(), returns the number of mismatches
+	int						VerifyShadowSurfaces( const idRenderModel *model );
+
 private:
 	enum {
 		FRUSTUM_UNINITIALIZED,
@@ -166,6 +178,9 @@ private:
 	// actually create the interaction
 	void					CreateInteraction( const idRenderModel *model );
 
+	// true if a shadow volume has to be created for the surface
+	bool					SurfaceNeedsShadowVolume( const idRenderModel *model, const idMaterial *shader, const srfTriangles_t *tri ) const;
+
 	// unlink from entity and light lists
 	void					Unlink( void );
 
@@ -306,8 +306,8 @@ public:
 	// Returns the default animation pose or NULL if the model is not an MD5.
 	virtual const idJointQuat *	GetDefaultPose( void ) const = 0;
 
-	// Returns number of the joint nearest to the given triangle.
-	virtual int					NearestJoint( int surfaceNum, int a, int c, int b ) const = 0;
+	// Returns number of the joint nearest to the given triangle of the instantiated surface with the given id.
+	virtual int					NearestJoint( int surfaceId, int a, int c, int b ) const = 0;
 
 	// Writing to and reading from a demo file.
 	virtual void				ReadFromDemoFile( class idDemoFile *f ) = 0;
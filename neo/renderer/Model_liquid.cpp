@@ -75,9 +75,10 @@ modelSurface_t idRenderModelLiquid::GenerateSurface( float lerp ) {
 		vert->xyz.z = page1[ i ] * lerp + page2[ i ] * inv_lerp;
 	}
 
-	tr.pc.c_deformedSurfaces++;
-	tr.pc.c_deformedVerts += deformInfo->numOutputVerts;
-	tr.pc.c_deformedIndexes += deformInfo->numIndexes;
+	performanceCounters_t &pc = R_PerformanceCounters();
+	pc.c_deformedSurfaces++;
+	pc.c_deformedVerts += deformInfo->numOutputVerts;
+	pc.c_deformedIndexes += deformInfo->numIndexes;
 
 	tri = R_AllocStaticTriSurf();
 
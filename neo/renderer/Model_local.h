@@ -82,7 +82,7 @@ public:
 	virtual jointHandle_t		GetJointHandle( const char *name ) const;
 	virtual const char *		GetJointName( jointHandle_t handle ) const;
 	virtual const idJointQuat *	GetDefaultPose( void ) const;
-	virtual int					NearestJoint( int surfaceNum, int a, int b, int c ) const;
+	virtual int					NearestJoint( int surfaceId, int a, int b, int c ) const;
 	virtual idBounds			Bounds( const struct renderEntity_s *ent ) const;
 	virtual void				ReadFromDemoFile( class idDemoFile *f );
 	virtual void				WriteToDemoFile( class idDemoFile *f );
@@ -138,6 +138,14 @@ protected:
 ===============================================================================
 */
 
+// skinning of one md5 mesh that idRenderModelMD5::InstantiateDynamicModelDeferred left for later
+typedef struct md5SkinSurface_s {
+	const class idMD5Mesh *		mesh;
+	const struct renderEntity_s *ent;
+	struct srfTriangles_s *		tri;
+	bool						deriveTangents;	// also create normals, tangents and face planes
+} md5SkinSurface_t;
+
 class idMD5Mesh {
 	friend class				idRenderModelMD5;
 
@@ -147,6 +155,8 @@ public:
 
 	void						ParseMesh( idLexer &parser, int numJoints, const idJointMat *joints );
 	void						UpdateSurface( const struct renderEntity_s *ent, const idJointMat *joints, modelSurface_t *surf );
+	void						SetupSurface( modelSurface_t *surf );
+	void						SkinSurface( const struct renderEntity_s *ent, const idJointMat *joints, srfTriangles_t *tri, bool deriveTangents ) const;
 	idBounds					CalcBounds( const idJointMat *joints );
 	int							NearestJoint( int a, int b, int c ) const;
 	int							NumVerts( void ) const;
@@ -161,10 +171,9 @@ private:
 	const idMaterial *			shader;				// material applied to mesh
 	int							numTris;			// number of triangles
 	struct deformInfo_s *		deformInfo;			// used to create srfTriangles_t from base frames and new vertexes
-	int							surfaceNum;			// number of the static surface created for this mesh
 
-	void						TransformVerts( idDrawVert *verts, const idJointMat *joints );
-	void						TransformScaledVerts( idDrawVert *verts, const idJointMat *joints, float scale );
+	void						TransformVerts( idDrawVert *verts, const idJointMat *joints ) const;
+	void						TransformScaledVerts( idDrawVert *verts, const idJointMat *joints, float scale ) const;
 };
 
 class idRenderModelMD5 : public idRenderModelStatic {
@@ -184,7 +193,13 @@ public:
 	virtual jointHandle_t		GetJointHandle( const char *name ) const;
 	virtual const char *		GetJointName( jointHandle_t handle ) const;
 	virtual const idJointQuat *	GetDefaultPose( void ) const;
-	virtual int					NearestJoint( int surfaceNum, int a, int b, int c ) const;
+	virtual int					NearestJoint( int surfaceId, int a, int b, int c ) const;
+
+								// like InstantiateDynamicModel, but the meshes are only skinned by
+								// SkinSurface and FinishDeferredModel, so that can be done in jobs
+	idRenderModel *				InstantiateDynamicModelDeferred( const struct renderEntity_s *ent, const struct viewDef_s *view, idRenderModel *cachedModel, md5SkinSurface_t **skinSurfaces, int *numSkinSurfaces );
+	static void					SkinSurface( const md5SkinSurface_t *skinSurface );
+	static void					FinishDeferredModel( idRenderModel *model, const md5SkinSurface_t *skinSurfaces, int numSkinSurfaces );
 
 private:
 	idList<idMD5Joint>			joints;
@@ -194,6 +209,7 @@ private:
 	void						CalculateBounds( const idJointMat *joints );
 	void						GetFrameBounds( const renderEntity_t *ent, idBounds &bounds ) const;
 	void						DrawJoints( const renderEntity_t *ent, const struct viewDef_s *view ) const;
+	idRenderModel *				InstantiateSurfaces( const struct renderEntity_s *ent, const struct viewDef_s *view, idRenderModel *cachedModel, md5SkinSurface_t **skinSurfaces, int *numSkinSurfaces );
 	void						ParseJoint( idLexer &parser, idMD5Joint *joint, idJointQuat *defaultPose );
 };
 
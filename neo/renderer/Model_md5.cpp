@@ -62,7 +62,6 @@ idMD5Mesh::idMD5Mesh() {
 	shader			= NULL;
 	numTris			= 0;
 	deformInfo		= NULL;
-	surfaceNum		= 0;
 }
 
 /*
@@ -249,7 +248,7 @@ void idMD5Mesh::ParseMesh( idLexer &parser, int numJoints, const idJointMat *joi
 idMD5Mesh::TransformVerts
 ====================
 */
-void idMD5Mesh::TransformVerts( idDrawVert *verts, const idJointMat *entJoints ) {
+void idMD5Mesh::TransformVerts( idDrawVert *verts, const idJointMat *entJoints ) const {
 	SIMDProcessor->TransformVerts( verts, texCoords.Num(), entJoints, scaledWeights, weightIndex, numWeights );
 }
 
@@ -260,7 +259,7 @@ idMD5Mesh::TransformScaledVerts
 Special transform to make the mesh seem fat or skinny.  May be used for zombie deaths
 ====================
 */
-void idMD5Mesh::TransformScaledVerts( idDrawVert *verts, const idJointMat *entJoints, float scale ) {
+void idMD5Mesh::TransformScaledVerts( idDrawVert *verts, const idJointMat *entJoints, float scale ) const {
 	idVec4 *scaledWeights = (idVec4 *) _alloca16( numWeights * sizeof( scaledWeights[0] ) );
 	SIMDProcessor->Mul( scaledWeights[0].ToFloatPtr(), scale, scaledWeights[0].ToFloatPtr(), numWeights * 4 );
 	SIMDProcessor->TransformVerts( verts, texCoords.Num(), entJoints, scaledWeights, weightIndex, numWeights );
@@ -272,12 +271,31 @@ idMD5Mesh::UpdateSurface
 ====================
 */
 void idMD5Mesh::UpdateSurface( const struct renderEntity_s *ent, const idJointMat *entJoints, modelSurface_t *surf ) {
-	int i, base;
+	SetupSurface( surf );
+
+	// If a surface is going to be have a lighting interaction generated, it will also have to call
+	// R_DeriveTangents() to get normals, tangents, and face planes.  If it only
+	// needs shadows generated, it will only have to generate face planes.  If it only
+	// has ambient drawing, or is culled, no additional work will be necessary
+	SkinSurface( ent, entJoints, surf->geometry, !r_useDeferredTangents.GetBool() );
+}
+
+/*
+====================
+idMD5Mesh::SetupSurface
+
+Makes sure the surface has triangles of the right size that reference the
+deform info, the vertexes are filled in by SkinSurface.
+====================
+*/
+void idMD5Mesh::SetupSurface( modelSurface_t *surf ) {
+	int i;
 	srfTriangles_t *tri;
 
-	tr.pc.c_deformedSurfaces++;
-	tr.pc.c_deformedVerts += deformInfo->numOutputVerts;
-	tr.pc.c_deformedIndexes += deformInfo->numIndexes;
+	performanceCounters_t &pc = R_PerformanceCounters();
+	pc.c_deformedSurfaces++;
+	pc.c_deformedVerts += deformInfo->numOutputVerts;
+	pc.c_deformedIndexes += deformInfo->numIndexes;
 
 	surf->shader = shader;
 
@@ -320,6 +338,18 @@ void idMD5Mesh::UpdateSurface( const struct renderEntity_s *ent, const idJointMa
 			tri->verts[i].st = texCoords[i];
 		}
 	}
+}
+
+/*
+====================
+idMD5Mesh::SkinSurface
+
+Transforms the vertexes of a surface set up by SetupSurface and bounds it.
+Only writes to tri, so surfaces can be skinned in parallel.
+====================
+*/
+void idMD5Mesh::SkinSurface( const struct renderEntity_s *ent, const idJointMat *entJoints, srfTriangles_t *tri, bool deriveTangents ) const {
+	int i, base;
 
 	if ( ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ] != 0.0f ) {
 		TransformScaledVerts( tri->verts, entJoints, ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ] );
@@ -335,11 +365,7 @@ void idMD5Mesh::UpdateSurface( const struct renderEntity_s *ent, const idJointMa
 
 	R_BoundTriSurf( tri );
 
-	// If a surface is going to be have a lighting interaction generated, it will also have to call
-	// R_DeriveTangents() to get normals, tangents, and face planes.  If it only
-	// needs shadows generated, it will only have to generate face planes.  If it only
-	// has ambient drawing, or is culled, no additional work will be necessary
-	if ( !r_useDeferredTangents.GetBool() ) {
+	if ( deriveTangents ) {
 		// set face planes, vertex normals, tangents
 		R_DeriveTangents( tri );
 	}
@@ -719,6 +745,60 @@ idRenderModelMD5::InstantiateDynamicModel
 ====================
 */
 idRenderModel *idRenderModelMD5::InstantiateDynamicModel( const struct renderEntity_s *ent, const struct viewDef_s *view, idRenderModel *cachedModel ) {
+	return InstantiateSurfaces( ent, view, cachedModel, NULL, NULL );
+}
+
+/*
+====================
+idRenderModelMD5::InstantiateDynamicModelDeferred
+
+Returns the snapshot with all its surfaces set up, but not skinned yet.
+*skinSurfaces is allocated from frame memory and gets one entry for every
+surface, each of them has to be passed to SkinSurface before the snapshot is
+passed to FinishDeferredModel.
+====================
+*/
+idRenderModel *idRenderModelMD5::InstantiateDynamicModelDeferred( const struct renderEntity_s *ent, const struct viewDef_s *view, idRenderModel *cachedModel, md5SkinSurface_t **skinSurfaces, int *numSkinSurfaces ) {
+	*skinSurfaces = (md5SkinSurface_t *)R_FrameAlloc( meshes.Num() * sizeof( md5SkinSurface_t ) );
+	*numSkinSurfaces = 0;
+
+	return InstantiateSurfaces( ent, view, cachedModel, skinSurfaces, numSkinSurfaces );
+}
+
+/*
+====================
+idRenderModelMD5::SkinSurface
+====================
+*/
+void idRenderModelMD5::SkinSurface( const md5SkinSurface_t *skinSurface ) {
+	skinSurface->mesh->SkinSurface( skinSurface->ent, skinSurface->ent->joints, skinSurface->tri, skinSurface->deriveTangents );
+}
+
+/*
+====================
+idRenderModelMD5::FinishDeferredModel
+
+Sets the bounds of a snapshot once all its surfaces are skinned.
+====================
+*/
+void idRenderModelMD5::FinishDeferredModel( idRenderModel *model, const md5SkinSurface_t *skinSurfaces, int numSkinSurfaces ) {
+	idRenderModelStatic *staticModel = static_cast<idRenderModelStatic *>( model );
+
+	staticModel->bounds.Clear();
+	for ( int i = 0; i < numSkinSurfaces; i++ ) {
+		staticModel->bounds.AddPoint( skinSurfaces[i].tri->bounds[0] );
+		staticModel->bounds.AddPoint( skinSurfaces[i].tri->bounds[1] );
+	}
+}
+
+/*
+====================
+idRenderModelMD5::InstantiateSurfaces
+
+Skins the meshes right away if skinSurfaces is NULL.
+====================
+*/
+idRenderModel *idRenderModelMD5::InstantiateSurfaces( const struct renderEntity_s *ent, const struct viewDef_s *view, idRenderModel *cachedModel, md5SkinSurface_t **skinSurfaces, int *numSkinSurfaces ) {
 	int					i, surfaceNum;
 	idMD5Mesh			*mesh;
 	idRenderModelStatic	*staticModel;
@@ -743,7 +823,7 @@ idRenderModel *idRenderModelMD5::InstantiateDynamicModel( const struct renderEnt
 		return NULL;
 	}
 
-	tr.pc.c_generateMd5++;
+	R_PerformanceCounters().c_generateMd5++;
 
 	if ( cachedModel ) {
 		assert( dynamic_cast<idRenderModelStatic *>(cachedModel) != NULL );
@@ -779,27 +859,36 @@ idRenderModel *idRenderModelMD5::InstantiateDynamicModel( const struct renderEnt
 
 		if ( !shader || ( !shader->IsDrawn() && !shader->SurfaceCastsShadow() ) ) {
 			staticModel->DeleteSurfaceWithId( i );
-			mesh->surfaceNum = -1;
 			continue;
 		}
 
 		modelSurface_t *surf;
 
 		if ( staticModel->FindSurfaceWithId( i, surfaceNum ) ) {
-			mesh->surfaceNum = surfaceNum;
 			surf = &staticModel->surfaces[surfaceNum];
 		} else {
 
 			// Remove Overlays before adding new surfaces
 			idRenderModelOverlay::RemoveOverlaySurfacesFromModel( staticModel );
 
-			mesh->surfaceNum = staticModel->NumSurfaces();
 			surf = &staticModel->surfaces.Alloc();
 			surf->geometry = NULL;
 			surf->shader = NULL;
 			surf->id = i;
 		}
 
+		if ( skinSurfaces != NULL ) {
+			mesh->SetupSurface( surf );
+
+			// lit surfaces will need their tangents for the ambient cache, so derive them while skinning
+			md5SkinSurface_t *skinSurface = &( *skinSurfaces )[( *numSkinSurfaces )++];
+			skinSurface->mesh = mesh;
+			skinSurface->ent = ent;
+			skinSurface->tri = surf->geometry;
+			skinSurface->deriveTangents = !r_useDeferredTangents.GetBool() || ( shader->IsDrawn() && shader->ReceivesLighting() );
+			continue;
+		}
+
 		mesh->UpdateSurface( ent, ent->joints, surf );
 
 		staticModel->bounds.AddPoint( surf->geometry->bounds[0] );
@@ -882,20 +971,12 @@ const char *idRenderModelMD5::GetJointName( jointHandle_t handle ) const {
 idRenderModelMD5::NearestJoint
 ====================
 */
-int idRenderModelMD5::NearestJoint( int surfaceNum, int a, int b, int c ) const {
-	int i;
-	const idMD5Mesh *mesh;
-
-	if ( surfaceNum > meshes.Num() ) {
-		common->Error( "idRenderModelMD5::NearestJoint: surfaceNum > meshes.Num()" );
-	}
-
-	for ( mesh = meshes.Ptr(), i = 0; i < meshes.Num(); i++, mesh++ ) {
-		if ( mesh->surfaceNum == surfaceNum ) {
-			return mesh->NearestJoint( a, b, c );
-		}
+int idRenderModelMD5::NearestJoint( int surfaceId, int a, int b, int c ) const {
+	// the surfaces of the instantiated model have the number of their mesh as id
+	if ( surfaceId < 0 || surfaceId >= meshes.Num() ) {
+		return 0;
 	}
-	return 0;
+	return meshes[surfaceId].NearestJoint( a, b, c );
 }
 
 /*
@@ -116,6 +116,9 @@ static void R_PerformanceCounters( void ) {
 	if ( r_showMemory.GetBool() ) {
 		int	m1 = frameData ? frameData->memoryHighwater : 0;
 		common->Printf( "frameData: %i (%i)\n", R_CountFrameData(), m1 );
+		if ( r_showMemory.GetInteger() > 1 ) {
+			R_PrintFrameArenas();
+		}
 	}
 	if ( r_showLightScale.GetBool() ) {
 		common->Printf( "lightScale: %f\n", backEnd.pc.maxLightValue );
@@ -125,6 +128,149 @@ static void R_PerformanceCounters( void ) {
 	memset( &backEnd.pc, 0, sizeof( backEnd.pc ) );
 }
 
+/*
+===============================================================================
+
+FRONT END BENCHMARK
+
+benchFrontEnd plays back a demo as a timedemo and records how long the steps
+of R_RenderView() took in each frame.  Together with the headless build, which
+has stubbed out OpenGL, this measures the front end without any driver time.
+
+===============================================================================
+*/
+
+static const int NUM_BENCH_TIMINGS = 6;
+
+static const char *benchTimingNames[NUM_BENCH_TIMINGS] = {
+	"FindViewLightsAndEntities",
+	"R_AddLightSurfaces",
+	"R_AddModelSurfaces",
+	"  interactions/shadows",
+	"R_SortDrawSurfs",
+	"R_RenderView"
+};
+
+typedef struct {
+	float	msec[NUM_BENCH_TIMINGS];
+} benchFrame_t;
+
+static bool					benchActive;
+static bool					benchStarted;
+static idList<benchFrame_t>	benchFrames;
+
+/*
+=====================
+R_BenchFrontEnd_f
+=====================
+*/
+void R_BenchFrontEnd_f( const idCmdArgs &args ) {
+	if ( args.Argc() < 2 ) {
+		common->Printf( "usage: benchFrontEnd <demoName> [quit]\n" );
+		return;
+	}
+
+	benchActive = true;
+	benchStarted = false;
+	benchFrames.Clear();
+	benchFrames.SetGranularity( 1024 );
+
+	if ( args.Argc() > 2 && !idStr::Icmp( args.Argv( 2 ), "quit" ) ) {
+		cmdSystem->BufferCommandText( CMD_EXEC_APPEND, va( "timeDemoQuit %s\n", args.Argv( 1 ) ) );
+	} else {
+		cmdSystem->BufferCommandText( CMD_EXEC_APPEND, va( "timeDemo %s\n", args.Argv( 1 ) ) );
+	}
+}
+
+/*
+=====================
+R_SortBenchTimes
+=====================
+*/
+static int R_SortBenchTimes( const float *a, const float *b ) {
+	if ( *a < *b ) {
+		return -1;
+	}
+	if ( *a > *b ) {
+		return 1;
+	}
+	return 0;
+}
+
+/*
+=====================
+R_PrintFrontEndBenchmark
+=====================
+*/
+static void R_PrintFrontEndBenchmark( void ) {
+	idList<float>	times;
+	int				i, j, num;
+
+	num = benchFrames.Num();
+	if ( num == 0 ) {
+		common->Printf( "benchFrontEnd: no frames rendered\n" );
+		return;
+	}
+
+	common->Printf( "benchFrontEnd: %i frames, msec per frame:\n", num );
+	common->Printf( "%-26s %8s %8s %8s %8s %8s %8s\n", "", "avg", "min", "50%", "90%", "99%", "max" );
+
+	times.SetNum( num );
+	for ( i = 0; i < NUM_BENCH_TIMINGS; i++ ) {
+		float total = 0.0f;
+		for ( j = 0; j < num; j++ ) {
+			times[j] = benchFrames[j].msec[i];
+			total += times[j];
+		}
+		times.Sort( R_SortBenchTimes );
+
+		common->Printf( "%-26s %8.3f %8.3f %8.3f %8.3f %8.3f %8.3f\n", benchTimingNames[i], total / num,
+			times[0], times[num * 50 / 100], times[num * 90 / 100], times[num * 99 / 100], times[num - 1] );
+	}
+}
+
+/*
+=====================
+R_FrontEndBenchmarkFrame
+
+Called at the end of every frame, before the performance counters are cleared
+=====================
+*/
+static void R_FrontEndBenchmarkFrame( void ) {
+	benchFrame_t	frame;
+
+	if ( !benchActive ) {
+		return;
+	}
+
+	if ( session->readDemo == NULL ) {
+		// the demo ended (or couldn't be loaded)
+		if ( benchStarted ) {
+			R_PrintFrontEndBenchmark();
+			benchActive = false;
+			benchFrames.Clear();
+		}
+		return;
+	}
+	benchStarted = true;
+
+	// frames without a 3D view, like the loading screen, don't count
+	if ( tr.pc.c_numViews == 0 ) {
+		return;
+	}
+
+	frame.msec[0] = tr.pc.findViewMsec;
+	frame.msec[1] = tr.pc.lightSurfacesMsec;
+	frame.msec[2] = tr.pc.modelSurfacesMsec;
+	frame.msec[3] = tr.pc.interactionMsec;
+	frame.msec[4] = tr.pc.sortMsec;
+	frame.msec[5] = tr.pc.renderViewMsec;
+	benchFrames.Append( frame );
+
+	common->Printf( "frame %4i: find %6.3f lights %6.3f models %6.3f (interactions %6.3f) sort %6.3f total %6.3f msec\n",
+		benchFrames.Num(), frame.msec[0], frame.msec[1], frame.msec[2], frame.msec[3], frame.msec[4], frame.msec[5] );
+}
+
 
 
 /*
@@ -135,6 +281,8 @@ Called by R_EndFrame each frame
 ====================
 */
 static void R_IssueRenderCommands( void ) {
+	PROFILE_ZONE( "R_IssueRenderCommands" );
+
 	if ( frameData->cmdHead->commandId == RC_NOP
 		&& !frameData->cmdHead->next ) {
 		// nothing to issue
@@ -673,6 +821,8 @@ Returns the number of msec spent in the back end
 =============
 */
 void idRenderSystemLocal::EndFrame( int *frontEndMsec, int *backEndMsec ) {
+	PROFILE_ZONE( "idRenderSystem::EndFrame" );
+
 	emptyCommand_t *cmd;
 
 	if ( !glConfig.isInitialized ) {
@@ -691,6 +841,8 @@ void idRenderSystemLocal::EndFrame( int *frontEndMsec, int *backEndMsec ) {
 		*backEndMsec = backEnd.pc.msec;
 	}
 
+	R_FrontEndBenchmarkFrame();
+
 	// print any other statistics and clear all of them
 	R_PerformanceCounters();
 
@@ -131,6 +131,9 @@ idCVar r_useLightScissors( "r_useLightScissors", "1", CVAR_RENDERER | CVAR_BOOL,
 idCVar r_useClippedLightScissors( "r_useClippedLightScissors", "1", CVAR_RENDERER | CVAR_INTEGER, "0 = full screen when near clipped, 1 = exact when near clipped, 2 = exact always", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
 idCVar r_useEntityCulling( "r_useEntityCulling", "1", CVAR_RENDERER | CVAR_BOOL, "0 = none, 1 = box" );
 idCVar r_useEntityScissors( "r_useEntityScissors", "0", CVAR_RENDERER | CVAR_BOOL, "1 = use custom scissor rectangle for each entity" );
+idCVar r_useParallelFrontEnd( "r_useParallelFrontEnd", "0", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "1 = instantiate dynamic models and evaluate light and surface shaders in parallel jobs (see sys_jobThreads)" );
+idCVar r_checkParallelShadows( "r_checkParallelShadows", "0", CVAR_RENDERER | CVAR_INTEGER, "with r_useParallelFrontEnd, create the shadow volumes made by jobs again on the main thread and compare them. 1 = print a warning for each difference, 2 = fatal error on the first one", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
+idCVar r_parallelSkinning( "r_parallelSkinning", "1", CVAR_RENDERER | CVAR_BOOL, "with r_useParallelFrontEnd, skin every md5 mesh in its own job and derive the tangents of lit meshes there, instead of skinning all meshes of an entity in its entity job" );
 idCVar r_useInteractionCulling( "r_useInteractionCulling", "1", CVAR_RENDERER | CVAR_BOOL, "1 = cull interactions" );
 idCVar r_useInteractionScissors( "r_useInteractionScissors", "2", CVAR_RENDERER | CVAR_INTEGER, "1 = use a custom scissor rectangle for each shadow interaction, 2 = also crop using portal scissors", -2, 2, idCmdSystem::ArgCompletion_Integer<-2,2> );
 idCVar r_useShadowCulling( "r_useShadowCulling", "1", CVAR_RENDERER | CVAR_BOOL, "try to cull shadows from partially visible lights" );
@@ -197,7 +200,7 @@ idCVar r_showViewEntitys( "r_showViewEntitys", "0", CVAR_RENDERER | CVAR_INTEGER
 idCVar r_showTris( "r_showTris", "0", CVAR_RENDERER | CVAR_INTEGER, "enables wireframe rendering of the world, 1 = only draw visible ones, 2 = draw all front facing, 3 = draw all", 0, 3, idCmdSystem::ArgCompletion_Integer<0,3> );
 idCVar r_showSurfaceInfo( "r_showSurfaceInfo", "0", CVAR_RENDERER | CVAR_BOOL, "show surface material name under crosshair" );
 idCVar r_showNormals( "r_showNormals", "0", CVAR_RENDERER | CVAR_FLOAT, "draws wireframe normals" );
-idCVar r_showMemory( "r_showMemory", "0", CVAR_RENDERER | CVAR_BOOL, "print frame memory utilization" );
+idCVar r_showMemory( "r_showMemory", "0", CVAR_RENDERER | CVAR_INTEGER, "print frame memory utilization, 2 = also per thread arena", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
 idCVar r_showCull( "r_showCull", "0", CVAR_RENDERER | CVAR_BOOL, "report sphere and box culling stats" );
 idCVar r_showInteractions( "r_showInteractions", "0", CVAR_RENDERER | CVAR_BOOL, "report interaction generation activity" );
 idCVar r_showDepth( "r_showDepth", "0", CVAR_RENDERER | CVAR_BOOL, "display the contents of the depth buffer and the depth range" );
@@ -2158,6 +2161,7 @@ void R_InitCommands( void ) {
 	cmdSystem->AddCommand( "envshot", R_EnvShot_f, CMD_FL_RENDERER, "takes an environment shot" );
 	cmdSystem->AddCommand( "makeAmbientMap", R_MakeAmbientMap_f, CMD_FL_RENDERER|CMD_FL_CHEAT, "makes an ambient map" );
 	cmdSystem->AddCommand( "benchmark", R_Benchmark_f, CMD_FL_RENDERER, "benchmark" );
+	cmdSystem->AddCommand( "benchFrontEnd", R_BenchFrontEnd_f, CMD_FL_RENDERER, "plays a demo as timedemo and reports the time spent in the renderer front end", idCmdSystem::ArgCompletion_DemoName );
 	cmdSystem->AddCommand( "gfxInfo", GfxInfo_f, CMD_FL_RENDERER, "show graphics info" );
 	cmdSystem->AddCommand( "modulateLights", R_ModulateLights_f, CMD_FL_RENDERER | CMD_FL_CHEAT, "modifies shader parms on all lights" );
 	cmdSystem->AddCommand( "testImage", R_TestImage_f, CMD_FL_RENDERER | CMD_FL_CHEAT, "displays the given image centered on screen", idCmdSystem::ArgCompletion_ImageName );
@@ -2167,6 +2171,7 @@ void R_InitCommands( void ) {
 	cmdSystem->AddCommand( "regenerateWorld", R_RegenerateWorld_f, CMD_FL_RENDERER, "regenerates all interactions" );
 	cmdSystem->AddCommand( "showInteractionMemory", R_ShowInteractionMemory_f, CMD_FL_RENDERER, "shows memory used by interactions" );
 	cmdSystem->AddCommand( "showTriSurfMemory", R_ShowTriSurfMemory_f, CMD_FL_RENDERER, "shows memory used by triangle surfaces" );
+	cmdSystem->AddCommand( "listFrameArenas", R_ListFrameArenas_f, CMD_FL_RENDERER, "lists the per thread frame memory arenas" );
 	cmdSystem->AddCommand( "vid_restart", R_VidRestart_f, CMD_FL_RENDERER, "restarts renderSystem" );
 	cmdSystem->AddCommand( "listRenderEntityDefs", R_ListRenderEntityDefs_f, CMD_FL_RENDERER, "lists the entity defs" );
 	cmdSystem->AddCommand( "listRenderLightDefs", R_ListRenderLightDefs_f, CMD_FL_RENDERER, "lists the light defs" );
@@ -2194,6 +2199,8 @@ void idRenderSystemLocal::Clear( void ) {
 	backEndRendererMaxLight = 1.0f;
 	ambientLightVector.Zero();
 	sortOffset = 0;
+	frontEndJobsActive = false;
+	memset( jobPc, 0, sizeof( jobPc ) );
 	worlds.Clear();
 	primaryWorld = NULL;
 	memset( &primaryRenderView, 0, sizeof( primaryRenderView ) );
@@ -2245,6 +2252,8 @@ void idRenderSystemLocal::Init( void ) {
 
 	R_InitTriSurfData();
 
+	R_InitFrontEndJobs();
+
 	globalImages->Init();
 
 	idCinematic::InitCinematic( );
@@ -2289,6 +2298,9 @@ void idRenderSystemLocal::Shutdown( void ) {
 	// free the vertex cache, which should have nothing allocated now
 	vertexCache.Shutdown();
 
+	R_ShutdownFrontEndJobs();
+	R_FreeShadowScratch();
+
 	R_ShutdownTriSurfData();
 
 	RB_ShutdownDebugTools();
@@ -349,6 +349,10 @@ void idVertexCache::Free( vertCache_t *block ) {
 	// but it won't need to clear a user pointer when it is
 	block->user = NULL;
 
+	// dynamic models instantiated in front end jobs free their old caches,
+	// Alloc() and Touch() are only called from the main thread
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TRISURF );
+
 	block->next->prev = block->prev;
 	block->prev->next = block->next;
 
@@ -356,6 +360,8 @@ void idVertexCache::Free( vertCache_t *block ) {
 	block->prev = &deferredFreeList;
 	deferredFreeList.next->prev = block;
 	deferredFreeList.next = block;
+
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TRISURF );
 }
 
 /*
@@ -32,7 +32,7 @@ If you have questions concerning this license or the applicable additional terms
 #ifndef __QGL_H__
 #define __QGL_H__
 
-#if defined( ID_DEDICATED ) && defined( _WIN32 )
+#if ( defined( ID_DEDICATED ) || defined( ID_HEADLESS ) ) && defined( _WIN32 )
 // to allow stubbing gl on windows, define WINGDIAPI to nothing - it would otherwise be
 // extended to __declspec(dllimport) on MSVC (our stub is no dll.)
 	#ifdef WINGDIAPI
@@ -44,7 +44,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include <SDL_opengl.h>
 
-#if defined( ID_DEDICATED ) && defined( _WIN32 )
+#if ( defined( ID_DEDICATED ) || defined( ID_HEADLESS ) ) && defined( _WIN32 )
 // restore WINGDIAPI
 	#ifdef WINGDIAPI
 		#pragma pop_macro("WINGDIAPI")
@@ -642,6 +642,8 @@ smp extensions, or asyncronously by another thread.
 */
 int		backEndStartTime, backEndFinishTime;
 void RB_ExecuteBackEndCommands( const emptyCommand_t *cmds ) {
+	PROFILE_ZONE( "RB_ExecuteBackEndCommands" );
+
 	// r_debugRenderToTexture
 	int	c_draw3d = 0, c_draw2d = 0, c_setBuffers = 0, c_swapBuffers = 0, c_copyRenders = 0;
 
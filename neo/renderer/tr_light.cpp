@@ -32,6 +32,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "renderer/VertexCache.h"
 #include "renderer/RenderWorld_local.h"
 #include "ui/Window.h"
+#include "renderer/Model_local.h"
 
 #include "renderer/tr_local.h"
 
@@ -857,6 +858,260 @@ idScreenRect	R_CalcLightScissorRectangle( viewLight_t *vLight ) {
 	return r;
 }
 
+/*
+===============================================================================
+
+PARALLEL FRONT END
+
+With r_useParallelFrontEnd the per light and per entity work of a view that
+doesn't touch shared state runs in jobs: light shader evaluation, light and
+entity scissor rects, instantiation of cached dynamic models (md5, md3) and
+culling and shader evaluation of the ambient surfaces.
+
+With r_parallelSkinning the surfaces of md5 models are set up on the main
+thread and every mesh is skinned in a job of its own before the entity jobs
+run, so a few models with many vertexes don't end up in a single job.  Lit
+meshes get their tangents there as well, instead of when the ambient cache
+is created on the main thread.
+
+Interactions that have to be created get one job each, which builds their
+light triangles and shadow volumes (using per thread scratch buffers in
+tr_stencilshadow.cpp).  Culling them, and linking the created surfaces into
+the view lights, is done on the main thread, in the same order as the serial
+path would.  r_checkParallelShadows creates all those shadow volumes again on
+the main thread and compares them.
+
+Everything else (entity callbacks, time groups, continuously animated models,
+vertex cache allocation, deforms, guis) stays on the main thread.
+The job results are picked up in viewLight / viewEntity list order and the
+sort offsets are assigned there, so the drawSurf list comes out exactly the
+same as from the serial path.
+
+Sound amplitudes can only be sampled on the main thread, so shaders of lights
+and entities with a referenceSound are evaluated there as well.
+
+===============================================================================
+*/
+
+static idParallelJobList *	lightJobList;
+static idParallelJobList *	entityScissorJobList;
+static idParallelJobList *	skinJobList;
+static idParallelJobList *	entityJobList;
+static idParallelJobList *	interactionJobList;
+
+/*
+=================
+R_InitFrontEndJobs
+=================
+*/
+void R_InitFrontEndJobs( void ) {
+	lightJobList = parallelJobManager->AllocJobList( "R_AddLightSurfaces" );
+	entityScissorJobList = parallelJobManager->AllocJobList( "R_CalcEntityScissorRectangle" );
+	skinJobList = parallelJobManager->AllocJobList( "idMD5Mesh::SkinSurface" );
+	entityJobList = parallelJobManager->AllocJobList( "R_AddModelSurfaces" );
+	interactionJobList = parallelJobManager->AllocJobList( "CreateInteraction" );
+}
+
+/*
+=================
+R_ShutdownFrontEndJobs
+=================
+*/
+void R_ShutdownFrontEndJobs( void ) {
+	parallelJobManager->FreeJobList( lightJobList );
+	lightJobList = NULL;
+	parallelJobManager->FreeJobList( entityScissorJobList );
+	entityScissorJobList = NULL;
+	parallelJobManager->FreeJobList( skinJobList );
+	skinJobList = NULL;
+	parallelJobManager->FreeJobList( entityJobList );
+	entityJobList = NULL;
+	parallelJobManager->FreeJobList( interactionJobList );
+	interactionJobList = NULL;
+}
+
+/*
+=================
+R_UseParallelFrontEnd
+=================
+*/
+static bool R_UseParallelFrontEnd( void ) {
+	if ( !r_useParallelFrontEnd.GetBool() || lightJobList == NULL ) {
+		return false;
+	}
+
+	// these debug tools print, draw or look up decls from code that would run in jobs
+	if ( r_checkBounds.GetBool() || r_showSkel.GetInteger() != 0 || r_materialOverride.GetString()[0] != '\0' ) {
+		return false;
+	}
+
+	return true;
+}
+
+/*
+=================
+R_RunFrontEndJobs
+=================
+*/
+static void R_RunFrontEndJobs( idParallelJobList *jobList ) {
+	tr.frontEndJobsActive = true;
+	jobList->Submit();
+	jobList->Wait();
+	tr.frontEndJobsActive = false;
+
+	// add up what the jobs counted
+	for ( int i = 0; i <= parallelJobManager->GetNumWorkerThreads(); i++ ) {
+		performanceCounters_t &jobPc = tr.jobPc[i];
+
+		tr.pc.c_box_cull_in += jobPc.c_box_cull_in;
+		tr.pc.c_box_cull_out += jobPc.c_box_cull_out;
+		tr.pc.c_createInteractions += jobPc.c_createInteractions;
+		tr.pc.c_createLightTris += jobPc.c_createLightTris;
+		tr.pc.c_createShadowVolumes += jobPc.c_createShadowVolumes;
+		tr.pc.c_caps += jobPc.c_caps;
+		tr.pc.c_sils += jobPc.c_sils;
+		tr.pc.c_generateMd5 += jobPc.c_generateMd5;
+		tr.pc.c_alloc += jobPc.c_alloc;
+		tr.pc.c_free += jobPc.c_free;
+		tr.staticAllocCount += jobPc.c_allocBytes;
+		tr.pc.c_deformedSurfaces += jobPc.c_deformedSurfaces;
+		tr.pc.c_deformedVerts += jobPc.c_deformedVerts;
+		tr.pc.c_deformedIndexes += jobPc.c_deformedIndexes;
+		tr.pc.c_tangentIndexes += jobPc.c_tangentIndexes;
+
+		memset( &jobPc, 0, sizeof( jobPc ) );
+	}
+}
+
+/*
+=================
+R_EvaluateLightShader
+
+Evaluates the light shader registers. Returns false if this is a purely
+additive light and no stage of it adds anything, so it can be skipped.
+
+Called from front end jobs for lights without a referenceSound.
+=================
+*/
+static bool R_EvaluateLightShader( viewLight_t *vLight ) {
+	const idRenderLightLocal *light = vLight->lightDef;
+	const idMaterial	*lightShader = light->lightShader;
+
+	// evaluate the light shader registers
+	float *lightRegs =(float *)R_FrameAlloc( lightShader->GetNumRegisters() * sizeof( float ) );
+	vLight->shaderRegisters = lightRegs;
+	lightShader->EvaluateRegisters( lightRegs, light->parms.shaderParms, tr.viewDef, light->parms.referenceSound );
+
+	// if this is a purely additive light and no stage in the light shader evaluates
+	// to a positive light value, we can completely skip the light
+	if ( !lightShader->IsFogLight() && !lightShader->IsBlendLight() ) {
+		int lightStageNum;
+		for ( lightStageNum = 0 ; lightStageNum < lightShader->GetNumStages() ; lightStageNum++ ) {
+			const shaderStage_t	*lightStage = lightShader->GetStage( lightStageNum );
+
+			// ignore stages that fail the condition
+			if ( !lightRegs[ lightStage->conditionRegister ] ) {
+				continue;
+			}
+
+			const int *registers = lightStage->color.registers;
+
+			// snap tiny values to zero to avoid lights showing up with the wrong color
+			if ( lightRegs[ registers[0] ] < 0.001f ) {
+				lightRegs[ registers[0] ] = 0.0f;
+			}
+			if ( lightRegs[ registers[1] ] < 0.001f ) {
+				lightRegs[ registers[1] ] = 0.0f;
+			}
+			if ( lightRegs[ registers[2] ] < 0.001f ) {
+				lightRegs[ registers[2] ] = 0.0f;
+			}
+
+			// FIXME:	when using the following values the light shows up bright red when using nvidia drivers/hardware
+			//			this seems to have been fixed ?
+			//lightRegs[ registers[0] ] = 1.5143074e-005f;
+			//lightRegs[ registers[1] ] = 1.5483369e-005f;
+			//lightRegs[ registers[2] ] = 1.7014690e-005f;
+
+			if ( lightRegs[ registers[0] ] > 0.0f ||
+					lightRegs[ registers[1] ] > 0.0f ||
+						lightRegs[ registers[2] ] > 0.0f ) {
+				break;
+			}
+		}
+		if ( lightStageNum == lightShader->GetNumStages() ) {
+			// we went through all the stages and didn't find one that adds anything
+			return false;
+		}
+	}
+
+	return true;
+}
+
+typedef struct {
+	viewLight_t *		vLight;
+	bool				evaluated;		// false if the shader has to be evaluated on the main thread
+	bool				lightAdds;		// result of R_EvaluateLightShader
+} lightJob_t;
+
+/*
+=================
+R_LightJob
+=================
+*/
+static void R_LightJob( void *data ) {
+	lightJob_t *job = (lightJob_t *)data;
+	viewLight_t *vLight = job->vLight;
+	const idRenderLightLocal *light = vLight->lightDef;
+
+	job->evaluated = false;
+	job->lightAdds = true;
+
+	if ( light->lightShader != NULL && light->parms.referenceSound == NULL ) {
+		job->lightAdds = R_EvaluateLightShader( vLight );
+		job->evaluated = true;
+	}
+
+	if ( r_useLightScissors.GetBool() ) {
+		// calculate the screen area covered by the light frustum
+		// which will be used to crop the stencil cull
+		idScreenRect scissorRect = R_CalcLightScissorRectangle( vLight );
+		// intersect with the portal crossing scissor rectangle
+		vLight->scissorRect.Intersect( scissorRect );
+	}
+}
+
+/*
+=================
+R_RunLightJobs
+
+Returns one lightJob_t for every light on the viewLights list, in list order.
+=================
+*/
+static lightJob_t *R_RunLightJobs( void ) {
+	viewLight_t	*vLight;
+	int			numLights;
+
+	numLights = 0;
+	for ( vLight = tr.viewDef->viewLights; vLight; vLight = vLight->next ) {
+		numLights++;
+	}
+
+	lightJob_t *lightJobs = (lightJob_t *)R_FrameAlloc( numLights * sizeof( lightJobs[0] ) );
+
+	lightJobList->Clear();
+	numLights = 0;
+	for ( vLight = tr.viewDef->viewLights; vLight; vLight = vLight->next ) {
+		lightJob_t *job = &lightJobs[numLights++];
+		job->vLight = vLight;
+		lightJobList->AddJob( R_LightJob, job );
+	}
+
+	R_RunFrontEndJobs( lightJobList );
+
+	return lightJobs;
+}
+
 /*
 =================
 R_AddLightSurfaces
@@ -876,16 +1131,31 @@ and the viewEntitys due to game movement
 =================
 */
 void R_AddLightSurfaces( void ) {
+	PROFILE_ZONE( "R_AddLightSurfaces" );
+
 	viewLight_t		*vLight;
 	idRenderLightLocal *light;
 	viewLight_t		**ptr;
+	lightJob_t		*lightJobs;
+	int				lightNum;
+
+	// the shader registers and scissor rects of the lights can be calculated
+	// in parallel, the loop below picks the results up in list order
+	lightJobs = NULL;
+	if ( R_UseParallelFrontEnd() ) {
+		lightJobs = R_RunLightJobs();
+	}
 
 	// go through each visible light, possibly removing some from the list
+	lightNum = 0;
 	ptr = &tr.viewDef->viewLights;
 	while ( *ptr ) {
 		vLight = *ptr;
 		light = vLight->lightDef;
 
+		const lightJob_t *job = ( lightJobs != NULL ) ? &lightJobs[lightNum] : NULL;
+		lightNum++;
+
 		const idMaterial	*lightShader = light->lightShader;
 		if ( !lightShader ) {
 			common->Error( "R_AddLightSurfaces: NULL lightShader" );
@@ -907,65 +1177,30 @@ void R_AddLightSurfaces( void ) {
 			}
 		}
 
-		// evaluate the light shader registers
-		float *lightRegs =(float *)R_FrameAlloc( lightShader->GetNumRegisters() * sizeof( float ) );
-		vLight->shaderRegisters = lightRegs;
-		lightShader->EvaluateRegisters( lightRegs, light->parms.shaderParms, tr.viewDef, light->parms.referenceSound );
-
-		// if this is a purely additive light and no stage in the light shader evaluates
-		// to a positive light value, we can completely skip the light
-		if ( !lightShader->IsFogLight() && !lightShader->IsBlendLight() ) {
-			int lightStageNum;
-			for ( lightStageNum = 0 ; lightStageNum < lightShader->GetNumStages() ; lightStageNum++ ) {
-				const shaderStage_t	*lightStage = lightShader->GetStage( lightStageNum );
-
-				// ignore stages that fail the condition
-				if ( !lightRegs[ lightStage->conditionRegister ] ) {
-					continue;
-				}
-
-				const int *registers = lightStage->color.registers;
-
-				// snap tiny values to zero to avoid lights showing up with the wrong color
-				if ( lightRegs[ registers[0] ] < 0.001f ) {
-					lightRegs[ registers[0] ] = 0.0f;
-				}
-				if ( lightRegs[ registers[1] ] < 0.001f ) {
-					lightRegs[ registers[1] ] = 0.0f;
-				}
-				if ( lightRegs[ registers[2] ] < 0.001f ) {
-					lightRegs[ registers[2] ] = 0.0f;
-				}
-
-				// FIXME:	when using the following values the light shows up bright red when using nvidia drivers/hardware
-				//			this seems to have been fixed ?
-				//lightRegs[ registers[0] ] = 1.5143074e-005f;
-				//lightRegs[ registers[1] ] = 1.5483369e-005f;
-				//lightRegs[ registers[2] ] = 1.7014690e-005f;
-
-				if ( lightRegs[ registers[0] ] > 0.0f ||
-						lightRegs[ registers[1] ] > 0.0f ||
-							lightRegs[ registers[2] ] > 0.0f ) {
-					break;
-				}
-			}
-			if ( lightStageNum == lightShader->GetNumStages() ) {
-				// we went through all the stages and didn't find one that adds anything
-				// remove the light from the viewLights list, and change its frame marker
-				// so interaction generation doesn't think the light is visible and
-				// create a shadow for it
-				*ptr = vLight->next;
-				light->viewCount = -1;
-				continue;
-			}
+		// evaluate the light shader registers, unless a job did it already
+		bool lightAdds;
+		if ( job != NULL && job->evaluated ) {
+			lightAdds = job->lightAdds;
+		} else {
+			lightAdds = R_EvaluateLightShader( vLight );
+		}
+		if ( !lightAdds ) {
+			// remove the light from the viewLights list, and change its frame marker
+			// so interaction generation doesn't think the light is visible and
+			// create a shadow for it
+			*ptr = vLight->next;
+			light->viewCount = -1;
+			continue;
 		}
 
 		if ( r_useLightScissors.GetBool() ) {
-			// calculate the screen area covered by the light frustum
-			// which will be used to crop the stencil cull
-			idScreenRect scissorRect = R_CalcLightScissorRectangle( vLight );
-			// intersect with the portal crossing scissor rectangle
-			vLight->scissorRect.Intersect( scissorRect );
+			if ( job == NULL ) {
+				// calculate the screen area covered by the light frustum
+				// which will be used to crop the stencil cull
+				idScreenRect scissorRect = R_CalcLightScissorRectangle( vLight );
+				// intersect with the portal crossing scissor rectangle
+				vLight->scissorRect.Intersect( scissorRect );
+			}
 
 			if ( r_showLightScissors.GetBool() ) {
 				R_ShowColoredScreenRect( vLight->scissorRect, light->index );
@@ -1098,15 +1333,14 @@ bool R_IssueEntityDefCallback( idRenderEntityLocal *def ) {
 
 /*
 ===================
-R_EntityDefDynamicModel
+R_PrepareEntityDefDynamicModel
 
-Issues a deferred entity callback if necessary.
-If the model isn't dynamic, it returns the original.
-Returns the cached dynamic model if present, otherwise creates
-it and any necessary overlays
+Issues a deferred entity callback if necessary and throws away
+a snapshot of the dynamic model that is out of date.
+Returns false if the model isn't dynamic.
 ===================
 */
-idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def ) {
+static bool R_PrepareEntityDefDynamicModel( idRenderEntityLocal *def ) {
 	bool callbackUpdate;
 
 	// allow deferred entities to construct themselves
@@ -1125,7 +1359,7 @@ idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def ) {
 	if ( model->IsDynamicModel() == DM_STATIC ) {
 		def->dynamicModel = NULL;
 		def->dynamicModelFrameCount = 0;
-		return model;
+		return false;
 	}
 
 	// continously animating models (particle systems, etc) will have their snapshot updated every single view
@@ -1133,36 +1367,75 @@ idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def ) {
 		R_ClearEntityDefDynamicModel( def );
 	}
 
-	// if we don't have a snapshot of the dynamic model, generate it now
-	if ( !def->dynamicModel ) {
+	return true;
+}
 
-		// instantiate the snapshot of the dynamic model, possibly reusing memory from the cached snapshot
-		def->cachedDynamicModel = model->InstantiateDynamicModel( &def->parms, tr.viewDef, def->cachedDynamicModel );
+static void R_FinishEntityDefSnapshot( idRenderEntityLocal *def );
 
-		if ( def->cachedDynamicModel ) {
+/*
+===================
+R_InstantiateEntityDefDynamicModel
 
-			// add any overlays to the snapshot of the dynamic model
-			if ( def->overlay && !r_skipOverlays.GetBool() ) {
-				def->overlay->AddOverlaySurfacesToModel( def->cachedDynamicModel );
-			} else {
-				idRenderModelOverlay::RemoveOverlaySurfacesFromModel( def->cachedDynamicModel );
-			}
+Creates the snapshot of the dynamic model and any necessary overlays.
+This runs in front end jobs for the models R_CanInstantiateInJob accepts.
+===================
+*/
+static void R_InstantiateEntityDefDynamicModel( idRenderEntityLocal *def ) {
+	idRenderModel *model = def->parms.hModel;
 
-			if ( r_checkBounds.GetBool() ) {
-				idBounds b = def->cachedDynamicModel->Bounds();
-				if (	b[0][0] < def->referenceBounds[0][0] - CHECK_BOUNDS_EPSILON ||
-						b[0][1] < def->referenceBounds[0][1] - CHECK_BOUNDS_EPSILON ||
-						b[0][2] < def->referenceBounds[0][2] - CHECK_BOUNDS_EPSILON ||
-						b[1][0] > def->referenceBounds[1][0] + CHECK_BOUNDS_EPSILON ||
-						b[1][1] > def->referenceBounds[1][1] + CHECK_BOUNDS_EPSILON ||
-						b[1][2] > def->referenceBounds[1][2] + CHECK_BOUNDS_EPSILON ) {
-					common->Printf( "entity %i dynamic model exceeded reference bounds\n", def->index );
-				}
+	// instantiate the snapshot of the dynamic model, possibly reusing memory from the cached snapshot
+	def->cachedDynamicModel = model->InstantiateDynamicModel( &def->parms, tr.viewDef, def->cachedDynamicModel );
+
+	R_FinishEntityDefSnapshot( def );
+}
+
+/*
+===================
+R_FinishEntityDefSnapshot
+
+Adds the overlays to the freshly instantiated snapshot of the dynamic model
+and makes it the dynamic model of the entity.
+===================
+*/
+static void R_FinishEntityDefSnapshot( idRenderEntityLocal *def ) {
+	if ( def->cachedDynamicModel ) {
+
+		// add any overlays to the snapshot of the dynamic model
+		if ( def->overlay && !r_skipOverlays.GetBool() ) {
+			def->overlay->AddOverlaySurfacesToModel( def->cachedDynamicModel );
+		} else {
+			idRenderModelOverlay::RemoveOverlaySurfacesFromModel( def->cachedDynamicModel );
+		}
+
+		if ( r_checkBounds.GetBool() ) {
+			idBounds b = def->cachedDynamicModel->Bounds();
+			if (	b[0][0] < def->referenceBounds[0][0] - CHECK_BOUNDS_EPSILON ||
+					b[0][1] < def->referenceBounds[0][1] - CHECK_BOUNDS_EPSILON ||
+					b[0][2] < def->referenceBounds[0][2] - CHECK_BOUNDS_EPSILON ||
+					b[1][0] > def->referenceBounds[1][0] + CHECK_BOUNDS_EPSILON ||
+					b[1][1] > def->referenceBounds[1][1] + CHECK_BOUNDS_EPSILON ||
+					b[1][2] > def->referenceBounds[1][2] + CHECK_BOUNDS_EPSILON ) {
+				common->Printf( "entity %i dynamic model exceeded reference bounds\n", def->index );
 			}
 		}
+	}
+
+	def->dynamicModel = def->cachedDynamicModel;
+	def->dynamicModelFrameCount = tr.frameCount;
+}
+
+/*
+===================
+R_FinishEntityDefDynamicModel
 
-		def->dynamicModel = def->cachedDynamicModel;
-		def->dynamicModelFrameCount = tr.frameCount;
+Sets the model depth hack and returns the model to draw.
+===================
+*/
+static idRenderModel *R_FinishEntityDefDynamicModel( idRenderEntityLocal *def ) {
+	idRenderModel *model = def->parms.hModel;
+
+	if ( model->IsDynamicModel() == DM_STATIC ) {
+		return model;
 	}
 
 	// set model depth hack value
@@ -1180,48 +1453,57 @@ idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def ) {
 	return def->dynamicModel;
 }
 
+/*
+===================
+R_EntityDefDynamicModel
+
+Issues a deferred entity callback if necessary.
+If the model isn't dynamic, it returns the original.
+Returns the cached dynamic model if present, otherwise creates
+it and any necessary overlays
+===================
+*/
+idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def ) {
+	// if we don't have a snapshot of the dynamic model, generate it now
+	if ( R_PrepareEntityDefDynamicModel( def ) && !def->dynamicModel ) {
+		R_InstantiateEntityDefDynamicModel( def );
+	}
+
+	return R_FinishEntityDefDynamicModel( def );
+}
+
 /*
 =================
-R_AddDrawSurf
+R_AllocDrawSurf
 =================
 */
-void R_AddDrawSurf( const srfTriangles_t *tri, const viewEntity_t *space, const renderEntity_t *renderEntity,
-					const idMaterial *shader, const idScreenRect &scissor ) {
+static drawSurf_t *R_AllocDrawSurf( const srfTriangles_t *tri, const viewEntity_t *space, const idMaterial *shader, const idScreenRect &scissor ) {
 	drawSurf_t		*drawSurf;
-	const float		*shaderParms;
-	static float	refRegs[MAX_EXPRESSION_REGISTERS];	// don't put on stack, or VC++ will do a page touch
-	float			generatedShaderParms[MAX_ENTITY_SHADER_PARMS];
 
 	drawSurf = (drawSurf_t *)R_FrameAlloc( sizeof( *drawSurf ) );
 	drawSurf->geo = tri;
 	drawSurf->space = space;
 	drawSurf->material = shader;
 	drawSurf->scissorRect = scissor;
-	drawSurf->sort = shader->GetSort() + tr.sortOffset;
+	drawSurf->sort = shader->GetSort();
 	drawSurf->dsFlags = 0;
 
-	// bumping this offset each time causes surfaces with equal sort orders to still
-	// deterministically draw in the order they are added
-	tr.sortOffset += 0.000001f;
+	return drawSurf;
+}
 
-	// if it doesn't fit, resize the list
-	if ( tr.viewDef->numDrawSurfs == tr.viewDef->maxDrawSurfs ) {
-		drawSurf_t	**old = tr.viewDef->drawSurfs;
-		int			count;
+/*
+=================
+R_EvaluateDrawSurfRegisters
 
-		if ( tr.viewDef->maxDrawSurfs == 0 ) {
-			tr.viewDef->maxDrawSurfs = INITIAL_DRAWSURFS;
-			count = 0;
-		} else {
-			count = tr.viewDef->maxDrawSurfs * sizeof( tr.viewDef->drawSurfs[0] );
-			tr.viewDef->maxDrawSurfs *= 2;
-		}
-		tr.viewDef->drawSurfs = (drawSurf_t **)R_FrameAlloc( tr.viewDef->maxDrawSurfs * sizeof( tr.viewDef->drawSurfs[0] ) );
-		if(count > 0)
-			memcpy( tr.viewDef->drawSurfs, old, count ); // XXX null pointer passed as argument 2, which is declared to never be null
-	}
-	tr.viewDef->drawSurfs[tr.viewDef->numDrawSurfs] = drawSurf;
-	tr.viewDef->numDrawSurfs++;
+refRegs needs room for the registers of renderEntity->referenceShader.
+Called from front end jobs for entities without a timeGroup and referenceSound.
+=================
+*/
+static void R_EvaluateDrawSurfRegisters( drawSurf_t *drawSurf, const renderEntity_t *renderEntity, float *refRegs ) {
+	const idMaterial	*shader = drawSurf->material;
+	const viewEntity_t	*space = drawSurf->space;
+	const float			*shaderParms;
+	float				generatedShaderParms[MAX_ENTITY_SHADER_PARMS];
 
 	// process the shader expressions for conditionals / color / texcoords
 	const float	*constRegs = shader->ConstantRegisters();
@@ -1272,6 +1554,44 @@ void R_AddDrawSurf( const srfTriangles_t *tri, const viewEntity_t *space, const
 			tr.viewDef->renderView.time = oldTime;
 		}
 	}
+}
+
+/*
+=================
+R_LinkDrawSurf
+
+Adds an evaluated drawSurf to the view and does the work that has to
+happen on the main thread.
+=================
+*/
+static void R_LinkDrawSurf( drawSurf_t *drawSurf, const renderEntity_t *renderEntity ) {
+	const idMaterial	*shader = drawSurf->material;
+	const viewEntity_t	*space = drawSurf->space;
+
+	drawSurf->sort += tr.sortOffset;
+
+	// bumping this offset each time causes surfaces with equal sort orders to still
+	// deterministically draw in the order they are added
+	tr.sortOffset += 0.000001f;
+
+	// if it doesn't fit, resize the list
+	if ( tr.viewDef->numDrawSurfs == tr.viewDef->maxDrawSurfs ) {
+		drawSurf_t	**old = tr.viewDef->drawSurfs;
+		int			count;
+
+		if ( tr.viewDef->maxDrawSurfs == 0 ) {
+			tr.viewDef->maxDrawSurfs = INITIAL_DRAWSURFS;
+			count = 0;
+		} else {
+			count = tr.viewDef->maxDrawSurfs * sizeof( tr.viewDef->drawSurfs[0] );
+			tr.viewDef->maxDrawSurfs *= 2;
+		}
+		tr.viewDef->drawSurfs = (drawSurf_t **)R_FrameAlloc( tr.viewDef->maxDrawSurfs * sizeof( tr.viewDef->drawSurfs[0] ) );
+		if(count > 0)
+			memcpy( tr.viewDef->drawSurfs, old, count ); // XXX null pointer passed as argument 2, which is declared to never be null
+	}
+	tr.viewDef->drawSurfs[tr.viewDef->numDrawSurfs] = drawSurf;
+	tr.viewDef->numDrawSurfs++;
 
 	// check for deformations
 	R_DeformDrawSurf( drawSurf );
@@ -1329,6 +1649,21 @@ void R_AddDrawSurf( const srfTriangles_t *tri, const viewEntity_t *space, const
 	// adds for this view
 }
 
+/*
+=================
+R_AddDrawSurf
+=================
+*/
+void R_AddDrawSurf( const srfTriangles_t *tri, const viewEntity_t *space, const renderEntity_t *renderEntity,
+					const idMaterial *shader, const idScreenRect &scissor ) {
+	drawSurf_t		*drawSurf;
+	static float	refRegs[MAX_EXPRESSION_REGISTERS];	// don't put on stack, or VC++ will do a page touch
+
+	drawSurf = R_AllocDrawSurf( tri, space, shader, scissor );
+	R_EvaluateDrawSurfRegisters( drawSurf, renderEntity, refRegs );
+	R_LinkDrawSurf( drawSurf, renderEntity );
+}
+
 /*
 ===============
 R_AddAmbientDrawsurfs
@@ -1452,6 +1787,419 @@ idScreenRect R_CalcEntityScissorRectangle( viewEntity_t *vEntity ) {
 	return R_ScreenRectFromViewFrustumBounds( bounds );
 }
 
+typedef struct {
+	viewEntity_t *		vEntity;
+	bool				prepared;		// dynamic model and ambient surfaces handled by R_EntityJob
+	int					numSkinSurfaces;
+	md5SkinSurface_t *	skinSurfaces;	// md5 meshes skinned by R_SkinJob, the snapshot is finished by R_EntityJob
+	int					numSurfs;
+	drawSurf_t **		surfs;			// ambient surfaces that passed culling, in surface order
+} entityJob_t;
+
+/*
+==================
+R_CanInstantiateInJob
+
+Cached dynamic models (md5, md3) only write to the snapshot of the entity,
+everything else is instantiated on the main thread.
+==================
+*/
+static bool R_CanInstantiateInJob( const idRenderEntityLocal *def ) {
+	const idRenderModel *model = def->parms.hModel;
+
+	if ( model->IsDynamicModel() != DM_CACHED ) {
+		return false;
+	}
+	// purged models get reloaded
+	if ( !model->IsLoaded() ) {
+		return false;
+	}
+	// md5 models complain about bad joints
+	if ( model->NumJoints() != 0 && ( def->parms.joints == NULL || def->parms.numJoints != model->NumJoints() ) ) {
+		return false;
+	}
+	return true;
+}
+
+/*
+==================
+R_EntityScissorJob
+==================
+*/
+static void R_EntityScissorJob( void *data ) {
+	viewEntity_t *vEntity = (viewEntity_t *)data;
+
+	// calculate the screen area covered by the entity
+	idScreenRect scissorRect = R_CalcEntityScissorRectangle( vEntity );
+	// intersect with the portal crossing scissor rectangle
+	vEntity->scissorRect.Intersect( scissorRect );
+}
+
+/*
+==================
+R_SkinJob
+==================
+*/
+static void R_SkinJob( void *data ) {
+	idRenderModelMD5::SkinSurface( (const md5SkinSurface_t *)data );
+}
+
+/*
+==================
+R_InstantiateMD5Deferred
+
+Sets up the snapshot of an md5 model and adds a skinning job for each of its
+meshes.  Returns false if the model isn't an md5 model.
+==================
+*/
+static bool R_InstantiateMD5Deferred( idRenderEntityLocal *def, entityJob_t *job ) {
+	idRenderModelMD5 *model = dynamic_cast<idRenderModelMD5 *>( def->parms.hModel );
+
+	if ( model == NULL ) {
+		return false;
+	}
+
+	def->cachedDynamicModel = model->InstantiateDynamicModelDeferred( &def->parms, tr.viewDef, def->cachedDynamicModel, &job->skinSurfaces, &job->numSkinSurfaces );
+
+	for ( int i = 0; i < job->numSkinSurfaces; i++ ) {
+		skinJobList->AddJob( R_SkinJob, &job->skinSurfaces[i] );
+	}
+
+	return true;
+}
+
+/*
+==================
+R_EntityJob
+
+Instantiates the dynamic model if that wasn't done on the main thread
+and collects the ambient surfaces that pass culling, see R_AddAmbientDrawsurfs.
+==================
+*/
+static void R_EntityJob( void *data ) {
+	entityJob_t *job = (entityJob_t *)data;
+	viewEntity_t *vEntity = job->vEntity;
+	idRenderEntityLocal *def = vEntity->entityDef;
+	idRenderModel *model = def->parms.hModel;
+	const idMaterial *shader;
+
+	job->numSurfs = 0;
+	job->surfs = NULL;
+
+	if ( model->IsDynamicModel() != DM_STATIC ) {
+		if ( job->skinSurfaces != NULL ) {
+			// the snapshot is NULL if the joints didn't match the model
+			if ( def->cachedDynamicModel != NULL ) {
+				idRenderModelMD5::FinishDeferredModel( def->cachedDynamicModel, job->skinSurfaces, job->numSkinSurfaces );
+			}
+			R_FinishEntityDefSnapshot( def );
+		} else if ( !def->dynamicModel ) {
+			R_InstantiateEntityDefDynamicModel( def );
+		}
+		model = def->dynamicModel;
+		if ( model == NULL ) {
+			return;
+		}
+	}
+
+	int total = model->NumSurfaces();
+	if ( total <= 0 ) {
+		return;
+	}
+	job->surfs = (drawSurf_t **)R_FrameAlloc( total * sizeof( job->surfs[0] ) );
+
+	// reference shaders are evaluated into frame memory instead of a static buffer
+	float *refRegs = NULL;
+	if ( def->parms.referenceShader ) {
+		refRegs = (float *)R_FrameAlloc( def->parms.referenceShader->GetNumRegisters() * sizeof( float ) );
+	}
+
+	for ( int i = 0 ; i < total ; i++ ) {
+		const modelSurface_t	*surf = model->Surface( i );
+
+		// for debugging, only show a single surface at a time
+		if ( r_singleSurface.GetInteger() >= 0 && i != r_singleSurface.GetInteger() ) {
+			continue;
+		}
+
+		const srfTriangles_t *tri = surf->geometry;
+		if ( !tri ) {
+			continue;
+		}
+		if ( !tri->numIndexes ) {
+			continue;
+		}
+		shader = surf->shader;
+		shader = R_RemapShaderBySkin( shader, def->parms.customSkin, def->parms.customShader );
+
+		R_GlobalShaderOverride( &shader );
+
+		if ( !shader ) {
+			continue;
+		}
+		if ( !shader->IsDrawn() ) {
+			continue;
+		}
+
+		if ( R_CullLocalBox( tri->bounds, vEntity->modelMatrix, 5, tr.viewDef->frustum ) ) {
+			continue;
+		}
+
+		drawSurf_t *drawSurf = R_AllocDrawSurf( tri, vEntity, shader, vEntity->scissorRect );
+		if ( def->parms.referenceSound == NULL ) {
+			R_EvaluateDrawSurfRegisters( drawSurf, &def->parms, refRegs );
+		} else {
+			drawSurf->shaderRegisters = NULL;
+		}
+		job->surfs[job->numSurfs++] = drawSurf;
+	}
+}
+
+/*
+==================
+R_RunEntityJobs
+
+Returns one entityJob_t for every entity on the viewEntitys list, in list order.
+The entity callbacks and anything else that can't run in jobs is
+done here in list order before the jobs are started.
+==================
+*/
+static entityJob_t *R_RunEntityJobs( void ) {
+	viewEntity_t	*vEntity;
+	int				numEntities;
+
+	numEntities = 0;
+	for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
+		numEntities++;
+	}
+
+	entityJob_t *entityJobs = (entityJob_t *)R_ClearedFrameAlloc( numEntities * sizeof( entityJobs[0] ) );
+
+	if ( r_useEntityScissors.GetBool() ) {
+		entityScissorJobList->Clear();
+		for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
+			entityScissorJobList->AddJob( R_EntityScissorJob, vEntity );
+		}
+		R_RunFrontEndJobs( entityScissorJobList );
+	}
+
+	skinJobList->Clear();
+	entityJobList->Clear();
+	numEntities = 0;
+	for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
+		entityJob_t *job = &entityJobs[numEntities++];
+		idRenderEntityLocal *def = vEntity->entityDef;
+
+		job->vEntity = vEntity;
+
+		if ( r_showEntityScissors.GetBool() ) {
+			R_ShowColoredScreenRect( vEntity->scissorRect, def->index );
+		}
+
+		// same conditions as in R_AddModelSurfaces
+		if ( tr.viewDef->isXraySubview && def->parms.xrayIndex == 1 ) {
+			continue;
+		} else if ( !tr.viewDef->isXraySubview && def->parms.xrayIndex == 2 ) {
+			continue;
+		}
+		if ( vEntity->scissorRect.IsEmpty() ) {
+			continue;
+		}
+
+		// entities with their own time group change the time of the view,
+		// which all the other jobs are using
+		if ( def->parms.timeGroup ) {
+			continue;
+		}
+
+		if ( R_PrepareEntityDefDynamicModel( def ) && !def->dynamicModel ) {
+			if ( !R_CanInstantiateInJob( def ) ) {
+				R_InstantiateEntityDefDynamicModel( def );
+			} else if ( r_parallelSkinning.GetBool() ) {
+				R_InstantiateMD5Deferred( def, job );
+			}
+		}
+
+		job->prepared = true;
+		entityJobList->AddJob( R_EntityJob, job );
+	}
+
+	// the entity jobs cull the skinned surfaces, so all skinning has to be done before they start
+	if ( skinJobList->NumJobs() ) {
+		R_RunFrontEndJobs( skinJobList );
+	}
+	R_RunFrontEndJobs( entityJobList );
+
+	return entityJobs;
+}
+
+/*
+==================
+R_LinkAmbientDrawsurfs
+
+Adds the ambient surfaces collected by R_EntityJob in the same
+way R_AddAmbientDrawsurfs does.
+==================
+*/
+static void R_LinkAmbientDrawsurfs( const entityJob_t *job ) {
+	static float	refRegs[MAX_EXPRESSION_REGISTERS];	// don't put on stack, or VC++ will do a page touch
+	viewEntity_t	*vEntity = job->vEntity;
+	idRenderEntityLocal	*def = vEntity->entityDef;
+
+	for ( int i = 0 ; i < job->numSurfs ; i++ ) {
+		drawSurf_t *drawSurf = job->surfs[i];
+		srfTriangles_t *tri = const_cast<srfTriangles_t *>( drawSurf->geo );
+
+		def->visibleCount = tr.viewCount;
+
+		// make sure we have an ambient cache
+		if ( !R_CreateAmbientCache( tri, drawSurf->material->ReceivesLighting() ) ) {
+			// don't add anything if the vertex cache was too full to give us an ambient cache
+			return;
+		}
+		// touch it so it won't get purged
+		vertexCache.Touch( tri->ambientCache );
+
+		if ( r_useIndexBuffers.GetBool() && !tri->indexCache ) {
+			vertexCache.Alloc( tri->indexes, tri->numIndexes * sizeof( tri->indexes[0] ), &tri->indexCache, true );
+		}
+		if ( tri->indexCache ) {
+			vertexCache.Touch( tri->indexCache );
+		}
+
+		// surfaces of entities with a referenceSound still need their registers
+		if ( drawSurf->shaderRegisters == NULL ) {
+			R_EvaluateDrawSurfRegisters( drawSurf, &def->parms, refRegs );
+		}
+
+		// add the surface for drawing
+		R_LinkDrawSurf( drawSurf, &def->parms );
+
+		// ambientViewCount is used to allow light interactions to be rejected
+		// if the ambient surface isn't visible at all
+		tri->ambientViewCount = tr.viewCount;
+	}
+
+	// add the lightweight decal surfaces
+	for ( idRenderModelDecal *decal = def->decals; decal; decal = decal->Next() ) {
+		decal->AddDecalDrawSurf( vEntity );
+	}
+}
+
+typedef struct {
+	idInteraction *		inter;
+	idRenderModel *		model;
+	idScreenRect		shadowScissor;
+	int					timeGroup;		// of the entity, its surfaces are linked at the time of the group
+	bool				create;			// deferred interaction, created by a job
+	bool				generated;		// false if it has to be made empty
+} interactionJob_t;
+
+// the active interactions of the view, in the order the serial path would add them
+static idList<interactionJob_t>	activeInteractions;
+
+/*
+=================
+R_InteractionJob
+=================
+*/
+static void R_InteractionJob( void *data ) {
+	interactionJob_t *job = (interactionJob_t *)data;
+
+	job->generated = job->inter->CreateInteractionSurfaces( job->model );
+}
+
+/*
+=================
+R_QueueActiveInteraction
+
+The parallel version of idInteraction::AddActiveInteraction(), the
+interaction is created and linked in R_AddActiveInteractions()
+=================
+*/
+static void R_QueueActiveInteraction( idInteraction *inter ) {
+	interactionJob_t job;
+
+	if ( !inter->PrepareActiveInteraction( job.shadowScissor, &job.model ) ) {
+		return;
+	}
+	job.inter = inter;
+	job.timeGroup = inter->entityDef->parms.timeGroup;
+	job.create = inter->IsDeferred();
+	job.generated = true;
+
+	if ( job.create ) {
+		// several interactions of the model may be created at the same time,
+		// so the face planes they all need are derived here
+		for ( int i = 0 ; i < job.model->NumSurfaces() ; i++ ) {
+			srfTriangles_t *tri = job.model->Surface( i )->geometry;
+			if ( tri != NULL && tri->numIndexes > 0 && ( !tri->facePlanes || !tri->facePlanesCalculated ) ) {
+				R_DeriveFacePlanes( tri );
+			}
+		}
+	}
+
+	activeInteractions.Append( job );
+}
+
+/*
+=================
+R_AddActiveInteractions
+
+Creates the queued interactions in jobs and links them all in queue order
+=================
+*/
+static void R_AddActiveInteractions( void ) {
+	int i;
+
+	interactionJobList->Clear();
+	for ( i = 0 ; i < activeInteractions.Num() ; i++ ) {
+		if ( activeInteractions[i].create ) {
+			interactionJobList->AddJob( R_InteractionJob, &activeInteractions[i] );
+		}
+	}
+	if ( interactionJobList->NumJobs() > 0 ) {
+		double startTime = Sys_MillisecondsPrecise();
+		R_RunFrontEndJobs( interactionJobList );
+		tr.pc.interactionMsec += Sys_MillisecondsPrecise() - startTime;
+	}
+
+	for ( i = 0 ; i < activeInteractions.Num() ; i++ ) {
+		interactionJob_t *job = &activeInteractions[i];
+
+		if ( job->create ) {
+			if ( r_checkParallelShadows.GetInteger() != 0 ) {
+				int numMismatches = job->inter->VerifyShadowSurfaces( job->model );
+				if ( numMismatches != 0 && r_checkParallelShadows.GetInteger() > 1 ) {
+					common->FatalError( "r_checkParallelShadows: %i shadow volumes differ from the serial path", numMismatches );
+				}
+			}
+			if ( !job->generated ) {
+				job->inter->MakeEmpty();
+			}
+		}
+
+		// the shader registers of the surfaces are evaluated at the time
+		// R_AddModelSurfaces uses for the entity
+		if ( job->timeGroup ) {
+			const float oldFloatTime = tr.viewDef->floatTime;
+			const int oldTime = tr.viewDef->renderView.time;
+
+			tr.viewDef->floatTime = game->GetTimeGroupTime( job->timeGroup ) * 0.001;
+			tr.viewDef->renderView.time = game->GetTimeGroupTime( job->timeGroup );
+
+			job->inter->LinkActiveInteraction( job->shadowScissor );
+
+			tr.viewDef->floatTime = oldFloatTime;
+			tr.viewDef->renderView.time = oldTime;
+		} else {
+			job->inter->LinkActiveInteraction( job->shadowScissor );
+		}
+	}
+
+	activeInteractions.SetNum( 0, false );
+}
+
 /*
 ===================
 R_AddModelSurfaces
@@ -1464,19 +2212,34 @@ two or more lights.
 ===================
 */
 void R_AddModelSurfaces( void ) {
+	PROFILE_ZONE( "R_AddModelSurfaces" );
+
 	viewEntity_t		*vEntity;
 	idInteraction		*inter, *next;
 	idRenderModel		*model;
+	entityJob_t			*entityJobs;
+	int					entityNum;
 
 	// clear the ambient surface list
 	tr.viewDef->numDrawSurfs = 0;
 	tr.viewDef->maxDrawSurfs = 0;	// will be set to INITIAL_DRAWSURFS on R_AddDrawSurf
 
+	// instantiate the dynamic models and collect the ambient surfaces in parallel,
+	// the loop below adds them in list order
+	entityJobs = NULL;
+	if ( R_UseParallelFrontEnd() ) {
+		entityJobs = R_RunEntityJobs();
+	}
+	const bool parallelInteractions = ( entityJobs != NULL );
+
 	// go through each entity that is either visible to the view, or to
 	// any light that intersects the view (for shadows)
+	entityNum = 0;
 	for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
+		const entityJob_t *job = ( entityJobs != NULL ) ? &entityJobs[entityNum] : NULL;
+		entityNum++;
 
-		if ( r_useEntityScissors.GetBool() ) {
+		if ( job == NULL && r_useEntityScissors.GetBool() ) {
 			// calculate the screen area covered by the entity
 			idScreenRect scissorRect = R_CalcEntityScissorRectangle( vEntity );
 			// intersect with the portal crossing scissor rectangle
@@ -1516,7 +2279,11 @@ void R_AddModelSurfaces( void ) {
 
 		// add the ambient surface if it has a visible rectangle
 		if ( !vEntity->scissorRect.IsEmpty() ) {
-			model = R_EntityDefDynamicModel( vEntity->entityDef );
+			if ( job != NULL && job->prepared ) {
+				model = R_FinishEntityDefDynamicModel( vEntity->entityDef );
+			} else {
+				model = R_EntityDefDynamicModel( vEntity->entityDef );
+			}
 			if ( model == NULL || model->NumSurfaces() <= 0 ) {
 				if ( vEntity->entityDef->parms.timeGroup ) {
 					tr.viewDef->floatTime = oldFloatTime;
@@ -1525,7 +2292,11 @@ void R_AddModelSurfaces( void ) {
 				continue;
 			}
 
-			R_AddAmbientDrawsurfs( vEntity );
+			if ( job != NULL && job->prepared ) {
+				R_LinkAmbientDrawsurfs( job );
+			} else {
+				R_AddAmbientDrawsurfs( vEntity );
+			}
 			tr.pc.c_visibleViewEntities++;
 		} else {
 			tr.pc.c_shadowViewEntities++;
@@ -1541,7 +2312,11 @@ void R_AddModelSurfaces( void ) {
 					if ( inter->lightDef->viewCount != tr.viewCount ) {
 						continue;
 					}
-					inter->AddActiveInteraction();
+					if ( parallelInteractions ) {
+						R_QueueActiveInteraction( inter );
+					} else {
+						inter->AddActiveInteraction();
+					}
 				}
 			}
 		} else {
@@ -1556,7 +2331,11 @@ void R_AddModelSurfaces( void ) {
 				if ( inter->lightDef->viewCount != tr.viewCount ) {
 					continue;
 				}
-				inter->AddActiveInteraction();
+				if ( parallelInteractions ) {
+					R_QueueActiveInteraction( inter );
+				} else {
+					inter->AddActiveInteraction();
+				}
 			}
 		}
 
@@ -1566,6 +2345,10 @@ void R_AddModelSurfaces( void ) {
 		}
 
 	}
+
+	if ( parallelInteractions ) {
+		R_AddActiveInteractions();
+	}
 }
 
 /*
@@ -38,6 +38,8 @@ class idScreenRect; // yay for include recursion
 #include "renderer/ModelOverlay.h"
 #include "renderer/RenderSystem.h"
 #include "renderer/RenderWorld.h"
+#include "sys/sys_jobs.h"
+#include "idlib/Profiler.h"
 
 class idRenderWorldLocal;
 
@@ -521,22 +523,36 @@ typedef struct frameMemoryBlock_s {
 	byte	base[4];	// dynamically allocated as [size]
 } frameMemoryBlock_t;
 
-// all of the information needed by the back end must be
-// contained in a frameData_t.  This entire structure is
-// duplicated so the front and back end can run in parallel
-// on an SMP machine (OBSOLETE: this capability has been removed)
+// a linear allocator that is only used by a single thread, so
+// allocating from it doesn't need any locking.  All arenas are
+// reset together at the frame boundary in R_ToggleSmpFrame()
 typedef struct {
 	// one or more blocks of memory for all frame
-	// temporary allocations
+	// temporary allocations of the thread
 	frameMemoryBlock_t	*memory;
 
 	// alloc will point somewhere into the memory chain
 	frameMemoryBlock_t	*alloc;
 
+	int					numBlocks;		// blocks in the memory chain
+	int					frameUsed;		// used by the last counted frame
+	int					highwater;		// max used on any frame
+} frameArena_t;
+
+// all of the information needed by the back end must be
+// contained in a frameData_t.  This entire structure is
+// duplicated so the front and back end can run in parallel
+// on an SMP machine (OBSOLETE: this capability has been removed)
+typedef struct {
+	// frame temporary allocations, indexed by
+	// parallelJobManager->GetThreadIndex(): arena 0 belongs
+	// to the main thread, the others to the job worker threads
+	frameArena_t		arenas[MAX_JOB_THREADS];
+
 	srfTriangles_t *	firstDeferredFreeTriSurf;
 	srfTriangles_t *	lastDeferredFreeTriSurf;
 
-	int					memoryHighwater;	// max used on any frame
+	int					memoryHighwater;	// max used on any frame, all arenas together
 
 	// the currently building command list
 	// commands can be inserted at the front if needed, as for required
@@ -575,9 +591,11 @@ typedef struct {
 	int		c_createInteractions;	// number of calls to idInteraction::CreateInteraction
 	int		c_createLightTris;
 	int		c_createShadowVolumes;
+	int		c_caps, c_sils;		// shadow volume cap and silhouette indexes of R_CreateShadowVolume()
 	int		c_generateMd5;
 	int		c_entityDefCallbacks;
 	int		c_alloc, c_free;	// counts for R_StaticAllc/R_StaticFree
+	int		c_allocBytes;		// R_StaticAlloc bytes of the front end jobs, added to staticAllocCount after them
 	int		c_visibleViewEntities;
 	int		c_shadowViewEntities;
 	int		c_viewLights;
@@ -589,6 +607,14 @@ typedef struct {
 	int		c_entityUpdates, c_lightUpdates, c_entityReferences, c_lightReferences;
 	int		c_guiSurfs;
 	int		frontEndMsec;		// sum of time in all RE_RenderScene's in a frame
+
+	// time spent in the steps of R_RenderView(), summed up over all views of a frame
+	double	findViewMsec;		// FindViewLightsAndEntities
+	double	lightSurfacesMsec;	// R_AddLightSurfaces
+	double	modelSurfacesMsec;	// R_AddModelSurfaces
+	double	interactionMsec;	// creating interactions and shadow volumes, part of modelSurfacesMsec
+	double	sortMsec;			// R_SortDrawSurfs
+	double	renderViewMsec;		// all of R_RenderView, subviews are counted in their parent view
 } performanceCounters_t;
 
 
@@ -765,6 +791,8 @@ public:
 
 	float					sortOffset;				// for determinist sorting of equal sort materials
 
+	bool					frontEndJobsActive;		// front end jobs are running, R_FrameAlloc has to pick the thread's arena
+
 	idList<idRenderWorldLocal*>worlds;
 
 	idRenderWorldLocal *	primaryWorld;
@@ -782,6 +810,7 @@ public:
 	viewDef_t *				viewDef;
 
 	performanceCounters_t	pc;					// performance counters
+	performanceCounters_t	jobPc[MAX_JOB_THREADS];	// counted by front end jobs, added to pc by R_RunFrontEndJobs
 
 	drawSurfsCommand_t		lockSurfacesCmd;	// use this when r_lockSurfaces = 1
 	//renderView_t			lockSurfacesRenderView;
@@ -809,6 +838,14 @@ extern backEndState_t		backEnd;
 extern idRenderSystemLocal	tr;
 extern glconfig_t			glConfig;		// outside of TR since it shouldn't be cleared during ref re-init
 
+// performance counters for code that can run in front end jobs
+ID_INLINE performanceCounters_t &R_PerformanceCounters( void ) {
+	if ( tr.frontEndJobsActive ) {
+		return tr.jobPc[ parallelJobManager->GetThreadIndex() ];
+	}
+	return tr.pc;
+}
+
 
 //
 // cvars
@@ -856,6 +893,9 @@ extern idCVar r_useLightScissors;		// 1 = use custom scissor rectangle for each
 extern idCVar r_useClippedLightScissors;// 0 = full screen when near clipped, 1 = exact when near clipped, 2 = exact always
 extern idCVar r_useEntityCulling;		// 0 = none, 1 = box
 extern idCVar r_useEntityScissors;		// 1 = use custom scissor rectangle for each entity
+extern idCVar r_useParallelFrontEnd;	// instantiate models and evaluate shaders for the view in parallel jobs
+extern idCVar r_checkParallelShadows;	// compare the shadow volumes created by jobs with the serial path
+extern idCVar r_parallelSkinning;		// skin md5 meshes in one job each before the entity jobs
 extern idCVar r_useInteractionCulling;	// 1 = cull interactions
 extern idCVar r_useInteractionScissors;	// 1 = use a custom scissor rectangle for each interaction
 extern idCVar r_useFrustumFarDistance;	// if != 0 force the view frustum far distance to this distance
@@ -942,7 +982,7 @@ extern idCVar r_showLightScissors;		// show light scissor rectangles
 extern idCVar r_showEntityScissors;		// show entity scissor rectangles
 extern idCVar r_showInteractionFrustums;// show a frustum for each interaction
 extern idCVar r_showInteractionScissors;// show screen rectangle which contains the interaction frustum
-extern idCVar r_showMemory;				// print frame memory utilization
+extern idCVar r_showMemory;				// print frame memory utilization, 2 = per thread arena
 extern idCVar r_showCull;				// report sphere and box culling stats
 extern idCVar r_showInteractions;		// report interaction generation activity
 extern idCVar r_showSurfaces;			// report surface/light/shadow counts
@@ -1204,6 +1244,9 @@ void R_ModulateLights_f( const idCmdArgs &args );
 void R_SetLightProject( idPlane lightProject[4], const idVec3 origin, const idVec3 targetPoint,
 	   const idVec3 rightVector, const idVec3 upVector, const idVec3 start, const idVec3 stop );
 
+void R_InitFrontEndJobs( void );
+void R_ShutdownFrontEndJobs( void );
+
 void R_AddLightSurfaces( void );
 void R_AddModelSurfaces( void );
 void R_RemoveUnecessaryViewLights( void );
@@ -1390,6 +1433,9 @@ srfTriangles_t *R_CreateShadowVolume( const idRenderEntityLocal *ent,
 									 const srfTriangles_t *tri, const idRenderLightLocal *light,
 									 shadowGen_t optimize, srfCullInfo_t &cullInfo );
 
+// frees the per thread scratch buffers of R_CreateShadowVolume()
+void R_FreeShadowScratch( void );
+
 /*
 ============================================================
 
@@ -1450,6 +1496,10 @@ TRISURF
 
 #define USE_TRI_DATA_ALLOCATOR
 
+// the triangle surface allocators and the vertex cache free list are
+// shared with the dynamic model instantiation in front end jobs
+const int CRITICAL_SECTION_TRISURF = CRITICAL_SECTION_TWO;
+
 void				R_InitTriSurfData( void );
 void				R_ShutdownTriSurfData( void );
 void				R_PurgeTriSurfData( frameData_t *frame );
@@ -1547,6 +1597,9 @@ SCENE GENERATION
 void R_InitFrameData( void );
 void R_ShutdownFrameData( void );
 int R_CountFrameData( void );
+void R_ListFrameArenas_f( const idCmdArgs &args );
+void R_BenchFrontEnd_f( const idCmdArgs &args );
+void R_PrintFrameArenas( void );
 void R_ToggleSmpFrame( void );
 void *R_FrameAlloc( int bytes );
 void *R_ClearedFrameAlloc( int bytes );
@@ -190,17 +190,21 @@ void R_ToggleSmpFrame( void ) {
 	frameData_t		*frame;
 	frameMemoryBlock_t	*block;
 
-	// update the highwater mark
+	// update the highwater marks
 	R_CountFrameData();
 
 	frame = frameData;
 
-	// reset the memory allocation to the first block
-	frame->alloc = frame->memory;
+	for ( int i = 0 ; i < MAX_JOB_THREADS ; i++ ) {
+		frameArena_t *arena = &frame->arenas[i];
 
-	// clear all the blocks
-	for ( block = frame->memory ; block ; block = block->next ) {
-		block->used = 0;
+		// reset the memory allocation to the first block
+		arena->alloc = arena->memory;
+
+		// clear all the blocks
+		for ( block = arena->memory ; block ; block = block->next ) {
+			block->used = 0;
+		}
 	}
 
 	R_ClearCommandChain();
@@ -211,6 +215,28 @@ void R_ToggleSmpFrame( void ) {
 
 #define	MEMORY_BLOCK_SIZE	0x100000
 
+/*
+=====================
+R_AllocFrameMemoryBlock
+=====================
+*/
+static frameMemoryBlock_t *R_AllocFrameMemoryBlock( frameArena_t *arena ) {
+	frameMemoryBlock_t *block;
+	int size;
+
+	size = MEMORY_BLOCK_SIZE;
+	block = (frameMemoryBlock_t *)Mem_Alloc( size + sizeof( *block ) );
+	if ( !block ) {
+		common->FatalError( "R_FrameAlloc: Mem_Alloc() failed" );
+	}
+	block->size = size;
+	block->used = 0;
+	block->next = NULL;
+	arena->numBlocks++;
+
+	return block;
+}
+
 /*
 =====================
 R_ShutdownFrameData
@@ -229,9 +255,11 @@ void R_ShutdownFrameData( void ) {
 	R_FreeDeferredTriSurfs( frame );
 
 	frameMemoryBlock_t *nextBlock;
-	for ( block = frame->memory ; block ; block = nextBlock ) {
-		nextBlock = block->next;
-		Mem_Free( block );
+	for ( int i = 0 ; i < MAX_JOB_THREADS ; i++ ) {
+		for ( block = frame->arenas[i].memory ; block ; block = nextBlock ) {
+			nextBlock = block->next;
+			Mem_Free( block );
+		}
 	}
 	Mem_Free( frame );
 	frameData = NULL;
@@ -240,26 +268,20 @@ void R_ShutdownFrameData( void ) {
 /*
 =====================
 R_InitFrameData
+
+Only the main thread's arena gets a block up front,
+the arenas of the job worker threads are created
+on their first allocation.
 =====================
 */
 void R_InitFrameData( void ) {
-	int size;
 	frameData_t *frame;
-	frameMemoryBlock_t *block;
 
 	R_ShutdownFrameData();
 
 	frameData = (frameData_t *)Mem_ClearedAlloc( sizeof( *frameData ));
 	frame = frameData;
-	size = MEMORY_BLOCK_SIZE;
-	block = (frameMemoryBlock_t *)Mem_Alloc( size + sizeof( *block ) );
-	if ( !block ) {
-		common->FatalError( "R_InitFrameData: Mem_Alloc() failed" );
-	}
-	block->size = size;
-	block->used = 0;
-	block->next = NULL;
-	frame->memory = block;
+	frame->arenas[0].memory = R_AllocFrameMemoryBlock( &frame->arenas[0] );
 	frame->memoryHighwater = 0;
 
 	R_ToggleSmpFrame();
@@ -268,6 +290,8 @@ void R_InitFrameData( void ) {
 /*
 ================
 R_CountFrameData
+
+Also updates the per arena statistics
 ================
 */
 int R_CountFrameData( void ) {
@@ -277,11 +301,20 @@ int R_CountFrameData( void ) {
 
 	count = 0;
 	frame = frameData;
-	for ( block = frame->memory ; block ; block=block->next ) {
-		count += block->used;
-		if ( block == frame->alloc ) {
-			break;
+	for ( int i = 0 ; i < MAX_JOB_THREADS ; i++ ) {
+		frameArena_t *arena = &frame->arenas[i];
+
+		arena->frameUsed = 0;
+		for ( block = arena->memory ; block ; block=block->next ) {
+			arena->frameUsed += block->used;
+			if ( block == arena->alloc ) {
+				break;
+			}
 		}
+		if ( arena->frameUsed > arena->highwater ) {
+			arena->highwater = arena->frameUsed;
+		}
+		count += arena->frameUsed;
 	}
 
 	// note if this is a new highwater mark
@@ -292,6 +325,64 @@ int R_CountFrameData( void ) {
 	return count;
 }
 
+/*
+================
+R_PrintFrameArenas
+
+r_showMemory 2 output, one line per frame
+================
+*/
+void R_PrintFrameArenas( void ) {
+	idStr	line;
+
+	if ( !frameData ) {
+		return;
+	}
+	R_CountFrameData();
+	for ( int i = 0 ; i < MAX_JOB_THREADS ; i++ ) {
+		const frameArena_t *arena = &frameData->arenas[i];
+		if ( !arena->memory ) {
+			continue;
+		}
+		if ( i == 0 ) {
+			line += va( "main:%ik(%ik) ", arena->frameUsed >> 10, arena->highwater >> 10 );
+		} else {
+			line += va( "%i:%ik(%ik) ", i, arena->frameUsed >> 10, arena->highwater >> 10 );
+		}
+	}
+	common->Printf( "frameArenas: %s\n", line.c_str() );
+}
+
+/*
+================
+R_ListFrameArenas_f
+================
+*/
+void R_ListFrameArenas_f( const idCmdArgs &args ) {
+	int		numArenas, totalBlocks;
+
+	if ( !frameData ) {
+		return;
+	}
+	R_CountFrameData();
+
+	common->Printf( "arena  blocks   used kB   highwater kB\n" );
+	numArenas = 0;
+	totalBlocks = 0;
+	for ( int i = 0 ; i < MAX_JOB_THREADS ; i++ ) {
+		const frameArena_t *arena = &frameData->arenas[i];
+		if ( !arena->memory ) {
+			continue;
+		}
+		common->Printf( "%5s  %6i  %8i  %13i\n", i == 0 ? "main" : va( "%i", i ),
+			arena->numBlocks, arena->frameUsed >> 10, arena->highwater >> 10 );
+		numArenas++;
+		totalBlocks += arena->numBlocks;
+	}
+	common->Printf( "%i arenas, %i kB in %i blocks, %i kB highwater of all arenas together\n",
+		numArenas, ( totalBlocks * MEMORY_BLOCK_SIZE ) >> 10, totalBlocks, frameData->memoryHighwater >> 10 );
+}
+
 /*
 =================
 R_StaticAlloc
@@ -300,9 +391,16 @@ R_StaticAlloc
 void *R_StaticAlloc( int bytes ) {
 	void	*buf;
 
-	tr.pc.c_alloc++;
+	performanceCounters_t &pc = R_PerformanceCounters();
 
-	tr.staticAllocCount += bytes;
+	pc.c_alloc++;
+
+	// the jobs count per thread, R_RunFrontEndJobs adds it up
+	if ( tr.frontEndJobsActive ) {
+		pc.c_allocBytes += bytes;
+	} else {
+		tr.staticAllocCount += bytes;
+	}
 
 	buf = Mem_Alloc( bytes );
 
@@ -332,7 +430,7 @@ R_StaticFree
 =================
 */
 void R_StaticFree( void *data ) {
-	tr.pc.c_free++;
+	R_PerformanceCounters().c_free++;
 	Mem_Free( data );
 }
 
@@ -359,40 +457,42 @@ from this frame.
 
 The memory is NOT zero filled.
 Should part of this be inlined in a macro?
+
+While front end jobs are running every thread
+allocates from its own arena, so no locking is needed.
 ================
 */
 void *R_FrameAlloc( int bytes ) {
-	frameData_t		*frame;
+	frameArena_t		*arena;
 	frameMemoryBlock_t	*block;
 	void			*buf;
 
 	bytes = (bytes+16)&~15;
 	// see if it can be satisfied in the current block
-	frame = frameData;
-	block = frame->alloc;
+	arena = &frameData->arenas[0];
+	if ( tr.frontEndJobsActive ) {
+		arena = &frameData->arenas[parallelJobManager->GetThreadIndex()];
+	}
+	block = arena->alloc;
 
-	if ( block->size - block->used >= bytes ) {
+	if ( block && block->size - block->used >= bytes ) {
 		buf = block->base + block->used;
 		block->used += bytes;
 		return buf;
 	}
 
 	// advance to the next memory block if available
-	block = block->next;
+	block = block ? block->next : NULL;
 	// create a new block if we are at the end of
 	// the chain
 	if ( !block ) {
-		int		size;
-
-		size = MEMORY_BLOCK_SIZE;
-		block = (frameMemoryBlock_t *)Mem_Alloc( size + sizeof( *block ) );
-		if ( !block ) {
-			common->FatalError( "R_FrameAlloc: Mem_Alloc() failed" );
+		block = R_AllocFrameMemoryBlock( arena );
+		if ( arena->alloc ) {
+			arena->alloc->next = block;
+		} else {
+			// first allocation of a job worker thread
+			arena->memory = block;
 		}
-		block->size = size;
-		block->used = 0;
-		block->next = NULL;
-		frame->alloc->next = block;
 	}
 
 	// we could fix this if we needed to...
@@ -401,7 +501,7 @@ void *R_FrameAlloc( int bytes ) {
 			bytes );
 	}
 
-	frame->alloc = block;
+	arena->alloc = block;
 
 	block->used = bytes;
 
@@ -653,12 +753,12 @@ bool R_CornerCullLocalBox( const idBounds &bounds, const float modelMatrix[16],
 		}
 		if ( j == 8 ) {
 			// all points were behind one of the planes
-			tr.pc.c_box_cull_out++;
+			R_PerformanceCounters().c_box_cull_out++;
 			return true;
 		}
 	}
 
-	tr.pc.c_box_cull_in++;
+	R_PerformanceCounters().c_box_cull_in++;
 
 	return false;		// not culled
 }
@@ -1068,6 +1168,8 @@ R_SortDrawSurfs
 =================
 */
 static void R_SortDrawSurfs( void ) {
+	PROFILE_ZONE( "R_SortDrawSurfs" );
+
 	// sort the drawsurfs by sort type, then orientation, then shader
 	qsort( tr.viewDef->drawSurfs, tr.viewDef->numDrawSurfs, sizeof( tr.viewDef->drawSurfs[0] ),
 		R_QsortSurfaces );
@@ -1093,12 +1195,17 @@ Parms will typically be allocated with R_FrameAlloc
 ================
 */
 void R_RenderView( viewDef_t *parms ) {
+	PROFILE_ZONE( "R_RenderView" );
+
 	viewDef_t		*oldView;
+	double			startTime, time;
 
 	if ( parms->renderView.width <= 0 || parms->renderView.height <= 0 ) {
 		return;
 	}
 
+	startTime = Sys_MillisecondsPrecise();
+
 	tr.viewCount++;
 
 	// save view in case we are a subview
@@ -1121,7 +1228,9 @@ void R_RenderView( viewDef_t *parms ) {
 
 	// identify all the visible portalAreas, and the entityDefs and
 	// lightDefs that are in them and pass culling.
+	time = Sys_MillisecondsPrecise();
 	static_cast<idRenderWorldLocal *>(parms->renderWorld)->FindViewLightsAndEntities();
+	tr.pc.findViewMsec += Sys_MillisecondsPrecise() - time;
 
 	// constrain the view frustum to the view lights and entities
 	R_ConstrainViewFrustum();
@@ -1129,23 +1238,32 @@ void R_RenderView( viewDef_t *parms ) {
 	// make sure that interactions exist for all light / entity combinations
 	// that are visible
 	// add any pre-generated light shadows, and calculate the light shader values
+	time = Sys_MillisecondsPrecise();
 	R_AddLightSurfaces();
+	tr.pc.lightSurfacesMsec += Sys_MillisecondsPrecise() - time;
 
 	// adds ambient surfaces and create any necessary interaction surfaces to add to the light
 	// lists
+	time = Sys_MillisecondsPrecise();
 	R_AddModelSurfaces();
+	tr.pc.modelSurfacesMsec += Sys_MillisecondsPrecise() - time;
 
 	// any viewLight that didn't have visible surfaces can have it's shadows removed
 	R_RemoveUnecessaryViewLights();
 
 	// sort all the ambient surfaces for translucency ordering
+	time = Sys_MillisecondsPrecise();
 	R_SortDrawSurfs();
+	tr.pc.sortMsec += Sys_MillisecondsPrecise() - time;
 
 	// generate any subviews (mirrors, cameras, etc) before adding this view
 	if ( R_GenerateSubViews() ) {
 		// if we are debugging subviews, allow the skipping of the
 		// main view draw
 		if ( r_subviewOnly.GetBool() ) {
+			if ( oldView == NULL ) {
+				tr.pc.renderViewMsec += Sys_MillisecondsPrecise() - startTime;
+			}
 			return;
 		}
 	}
@@ -1160,4 +1278,8 @@ void R_RenderView( viewDef_t *parms ) {
 
 	// restore view in case we are a subview
 	tr.viewDef = oldView;
+
+	if ( oldView == NULL ) {
+		tr.pc.renderViewMsec += Sys_MillisecondsPrecise() - startTime;
+	}
 }
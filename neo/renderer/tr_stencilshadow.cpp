@@ -125,27 +125,6 @@ If a high order bit is clear, the point is outside the plane (definately negativ
 //#define	LIGHT_CLIP_EPSILON	0.001f
 #define	LIGHT_CLIP_EPSILON		0.1f
 
-#define	MAX_CLIP_SIL_EDGES		2048
-static int	numClipSilEdges;
-static int	clipSilEdges[MAX_CLIP_SIL_EDGES][2];
-
-// facing will be 0 if forward facing, 1 if backwards facing
-// grabbed with alloca
-static byte	*globalFacing;
-
-// faceCastsShadow will be 1 if the face is in the projection
-// and facing the apropriate direction
-static byte	*faceCastsShadow;
-
-static int	*remap;
-
-#define	MAX_SHADOW_INDEXES		0x18000
-#define	MAX_SHADOW_VERTS		0x18000
-static int	numShadowIndexes;
-static glIndex_t	shadowIndexes[MAX_SHADOW_INDEXES];
-static int	numShadowVerts;
-static idVec4	shadowVerts[MAX_SHADOW_VERTS];
-static bool overflowed;
 
 idPlane	pointLightFrustums[6][6] = {
 	{
@@ -200,9 +179,9 @@ idPlane	pointLightFrustums[6][6] = {
 	},
 };
 
-int	c_caps, c_sils;
-
-static bool	callOptimizer;			// call the preprocessor optimizer after clipping occluders
+#define	MAX_CLIP_SIL_EDGES		2048
+#define	MAX_SHADOW_INDEXES		0x18000
+#define	MAX_SHADOW_VERTS		0x18000
 
 typedef struct {
 	int		frontCapStart;
@@ -210,8 +189,69 @@ typedef struct {
 	int		silStart;
 	int		end;
 } indexRef_t;
-static indexRef_t	indexRef[6];
-static int indexFrustumNumber;		// which shadow generating side of a light the indexRef is for
+
+// everything R_CreateShadowVolume() builds a volume in before copying it
+// off to the new surface.  Every thread that creates shadow volumes has
+// its own, so the front end jobs can create them in parallel
+typedef struct {
+	int			numClipSilEdges;
+	int			clipSilEdges[MAX_CLIP_SIL_EDGES][2];
+
+	// facing will be 0 if forward facing, 1 if backwards facing
+	const byte *globalFacing;
+
+	// faceCastsShadow will be 1 if the face is in the projection
+	// and facing the apropriate direction
+	// grabbed with alloca
+	byte *		faceCastsShadow;
+
+	int *		remap;
+
+	int			numShadowIndexes;
+	glIndex_t	shadowIndexes[MAX_SHADOW_INDEXES];
+	int			numShadowVerts;
+	idVec4		shadowVerts[MAX_SHADOW_VERTS];
+	bool		overflowed;
+
+	bool		callOptimizer;			// call the preprocessor optimizer after clipping occluders
+
+	indexRef_t	indexRef[6];
+	int			indexFrustumNumber;		// which shadow generating side of a light the indexRef is for
+} shadowScratch_t;
+
+// indexed by parallelJobManager->GetThreadIndex(), allocated on first use
+static shadowScratch_t *	shadowScratch[MAX_JOB_THREADS];
+
+/*
+===============
+R_GetShadowScratch
+
+Returns the scratch buffers of the calling thread
+===============
+*/
+static shadowScratch_t *R_GetShadowScratch( void ) {
+	int thread = parallelJobManager->GetThreadIndex();
+
+	// only the owning thread ever touches its slot
+	if ( shadowScratch[thread] == NULL ) {
+		shadowScratch[thread] = (shadowScratch_t *)Mem_Alloc16( sizeof( shadowScratch_t ) );
+	}
+	return shadowScratch[thread];
+}
+
+/*
+===============
+R_FreeShadowScratch
+===============
+*/
+void R_FreeShadowScratch( void ) {
+	for ( int i = 0 ; i < MAX_JOB_THREADS ; i++ ) {
+		if ( shadowScratch[i] != NULL ) {
+			Mem_Free16( shadowScratch[i] );
+			shadowScratch[i] = NULL;
+		}
+	}
+}
 
 /*
 ===============
@@ -295,7 +335,7 @@ make a projected copy of the even verts into the odd spots
 that is on the far light clip plane
 ===================
 */
-static void R_ProjectPointsToFarPlane( const idRenderEntityLocal *ent, const idRenderLightLocal *light,
+static void R_ProjectPointsToFarPlane( shadowScratch_t *ctx, const idRenderEntityLocal *ent, const idRenderLightLocal *light,
 									const idPlane &lightPlaneLocal,
 									int firstShadowVert, int numShadowVerts ) {
 	idVec3		lv;
@@ -308,7 +348,7 @@ static void R_ProjectPointsToFarPlane( const idRenderEntityLocal *ent, const idR
 
 #if 1
 	// make a projected copy of the even verts into the odd spots
-	in = &shadowVerts[firstShadowVert];
+	in = &ctx->shadowVerts[firstShadowVert];
 	for ( i = firstShadowVert ; i < numShadowVerts ; i+= 2, in += 2 ) {
 		float	w, oow;
 
@@ -331,7 +371,7 @@ static void R_ProjectPointsToFarPlane( const idRenderEntityLocal *ent, const idR
 	// messing with W seems to cause some depth precision problems
 
 	// make a projected copy of the even verts into the odd spots
-	in = &shadowVerts[firstShadowVert];
+	in = &ctx->shadowVerts[firstShadowVert];
 	for ( i = firstShadowVert ; i < numShadowVerts ; i+= 2, in += 2 ) {
 		in[0].w = 1;
 		in[1].x = *in * mat[0].ToVec3() + mat[0][3];
@@ -453,7 +493,7 @@ R_ClipTriangleToLight
 Returns false if nothing is left after clipping
 ===================
 */
-static bool	R_ClipTriangleToLight( const idVec3 &a, const idVec3 &b, const idVec3 &c, int planeBits,
+static bool	R_ClipTriangleToLight( shadowScratch_t *ctx, const idVec3 &a, const idVec3 &b, const idVec3 &c, int planeBits,
 							  const idPlane frustum[6] ) {
 	int			i;
 	int			base;
@@ -480,26 +520,26 @@ static bool	R_ClipTriangleToLight( const idVec3 &a, const idVec3 &b, const idVec
 	ct = &pingPong[p];
 
 	// copy the clipped points out to shadowVerts
-	if ( numShadowVerts + ct->numVerts * 2 > MAX_SHADOW_VERTS ) {
-		overflowed = true;
+	if ( ctx->numShadowVerts + ct->numVerts * 2 > MAX_SHADOW_VERTS ) {
+		ctx->overflowed = true;
 		return false;
 	}
 
-	base = numShadowVerts;
+	base = ctx->numShadowVerts;
 	for ( i = 0 ; i < ct->numVerts ; i++ ) {
-		shadowVerts[ base + i*2 ].ToVec3() = ct->verts[i];
+		ctx->shadowVerts[ base + i*2 ].ToVec3() = ct->verts[i];
 	}
-	numShadowVerts += ct->numVerts * 2;
+	ctx->numShadowVerts += ct->numVerts * 2;
 
-	if ( numShadowIndexes + 3 * ( ct->numVerts - 2 ) > MAX_SHADOW_INDEXES ) {
-		overflowed = true;
+	if ( ctx->numShadowIndexes + 3 * ( ct->numVerts - 2 ) > MAX_SHADOW_INDEXES ) {
+		ctx->overflowed = true;
 		return false;
 	}
 
 	for ( i = 2 ; i < ct->numVerts ; i++ ) {
-		shadowIndexes[numShadowIndexes++] = base + i * 2;
-		shadowIndexes[numShadowIndexes++] = base + ( i - 1 ) * 2;
-		shadowIndexes[numShadowIndexes++] = base;
+		ctx->shadowIndexes[ctx->numShadowIndexes++] = base + i * 2;
+		ctx->shadowIndexes[ctx->numShadowIndexes++] = base + ( i - 1 ) * 2;
+		ctx->shadowIndexes[ctx->numShadowIndexes++] = base;
 	}
 
 	// any edges that were created by the clipping process will
@@ -507,16 +547,16 @@ static bool	R_ClipTriangleToLight( const idVec3 &a, const idVec3 &b, const idVec
 	// of the exterior bounds of the shadow volume
 	for ( i = 0 ; i < ct->numVerts ; i++ ) {
 		if ( ct->edgeFlags[i] ) {
-			if ( numClipSilEdges == MAX_CLIP_SIL_EDGES ) {
+			if ( ctx->numClipSilEdges == MAX_CLIP_SIL_EDGES ) {
 				break;
 			}
-			clipSilEdges[ numClipSilEdges ][0] = base + i * 2;
+			ctx->clipSilEdges[ ctx->numClipSilEdges ][0] = base + i * 2;
 			if ( i == ct->numVerts - 1 ) {
-				clipSilEdges[ numClipSilEdges ][1] = base;
+				ctx->clipSilEdges[ ctx->numClipSilEdges ][1] = base;
 			} else {
-				clipSilEdges[ numClipSilEdges ][1] = base + ( i + 1 ) * 2;
+				ctx->clipSilEdges[ ctx->numClipSilEdges ][1] = base + ( i + 1 ) * 2;
 			}
-			numClipSilEdges++;
+			ctx->numClipSilEdges++;
 		}
 	}
 
@@ -596,36 +636,36 @@ the frustum.
 Only done for simple projected lights, not point lights.
 ==================
 */
-static void R_AddClipSilEdges( void ) {
+static void R_AddClipSilEdges( shadowScratch_t *ctx ) {
 	int		v1, v2;
 	int		v1_back, v2_back;
 	int		i;
 
 	// don't allow it to overflow
-	if ( numShadowIndexes + numClipSilEdges * 6 > MAX_SHADOW_INDEXES ) {
-		overflowed = true;
+	if ( ctx->numShadowIndexes + ctx->numClipSilEdges * 6 > MAX_SHADOW_INDEXES ) {
+		ctx->overflowed = true;
 		return;
 	}
 
-	for ( i = 0 ; i < numClipSilEdges ; i++ ) {
-		v1 = clipSilEdges[i][0];
-		v2 = clipSilEdges[i][1];
+	for ( i = 0 ; i < ctx->numClipSilEdges ; i++ ) {
+		v1 = ctx->clipSilEdges[i][0];
+		v2 = ctx->clipSilEdges[i][1];
 		v1_back = v1 + 1;
 		v2_back = v2 + 1;
-		if ( PointsOrdered( shadowVerts[ v1 ].ToVec3(), shadowVerts[ v2 ].ToVec3() ) ) {
-			shadowIndexes[numShadowIndexes++] = v1;
-			shadowIndexes[numShadowIndexes++] = v2;
-			shadowIndexes[numShadowIndexes++] = v1_back;
-			shadowIndexes[numShadowIndexes++] = v2;
-			shadowIndexes[numShadowIndexes++] = v2_back;
-			shadowIndexes[numShadowIndexes++] = v1_back;
+		if ( PointsOrdered( ctx->shadowVerts[ v1 ].ToVec3(), ctx->shadowVerts[ v2 ].ToVec3() ) ) {
+			ctx->shadowIndexes[ctx->numShadowIndexes++] = v1;
+			ctx->shadowIndexes[ctx->numShadowIndexes++] = v2;
+			ctx->shadowIndexes[ctx->numShadowIndexes++] = v1_back;
+			ctx->shadowIndexes[ctx->numShadowIndexes++] = v2;
+			ctx->shadowIndexes[ctx->numShadowIndexes++] = v2_back;
+			ctx->shadowIndexes[ctx->numShadowIndexes++] = v1_back;
 		} else {
-			shadowIndexes[numShadowIndexes++] = v1;
-			shadowIndexes[numShadowIndexes++] = v2;
-			shadowIndexes[numShadowIndexes++] = v2_back;
-			shadowIndexes[numShadowIndexes++] = v1;
-			shadowIndexes[numShadowIndexes++] = v2_back;
-			shadowIndexes[numShadowIndexes++] = v1_back;
+			ctx->shadowIndexes[ctx->numShadowIndexes++] = v1;
+			ctx->shadowIndexes[ctx->numShadowIndexes++] = v2;
+			ctx->shadowIndexes[ctx->numShadowIndexes++] = v2_back;
+			ctx->shadowIndexes[ctx->numShadowIndexes++] = v1;
+			ctx->shadowIndexes[ctx->numShadowIndexes++] = v2_back;
+			ctx->shadowIndexes[ctx->numShadowIndexes++] = v1_back;
 		}
 	}
 }
@@ -638,7 +678,7 @@ Add quads from the front points to the projected points
 for each silhouette edge in the light
 =================
 */
-static void R_AddSilEdges( const srfTriangles_t *tri, unsigned short *pointCull, const idPlane frustum[6] ) {
+static void R_AddSilEdges( shadowScratch_t *ctx, const srfTriangles_t *tri, unsigned short *pointCull, const idPlane frustum[6] ) {
 	int		v1, v2;
 	int		i;
 	silEdge_t	*sil;
@@ -659,7 +699,7 @@ static void R_AddSilEdges( const srfTriangles_t *tri, unsigned short *pointCull,
 		// not just that it has the correct facing direction
 		// This will cause edges that are exactly on the frustum plane
 		// to be considered sil edges if the face inside casts a shadow.
-		if ( !( faceCastsShadow[ sil->p1 ] ^ faceCastsShadow[ sil->p2 ] ) ) {
+		if ( !( ctx->faceCastsShadow[ sil->p1 ] ^ ctx->faceCastsShadow[ sil->p2 ] ) ) {
 			continue;
 		}
 
@@ -673,30 +713,30 @@ static void R_AddSilEdges( const srfTriangles_t *tri, unsigned short *pointCull,
 
 		// see if the edge needs to be clipped
 		if ( EDGE_CLIPPED( sil->v1, sil->v2 ) ) {
-			if ( numShadowVerts + 4 > MAX_SHADOW_VERTS ) {
-				overflowed = true;
+			if ( ctx->numShadowVerts + 4 > MAX_SHADOW_VERTS ) {
+				ctx->overflowed = true;
 				return;
 			}
-			v1 = numShadowVerts;
+			v1 = ctx->numShadowVerts;
 			v2 = v1 + 2;
 			if ( !R_ClipLineToLight( tri->verts[ sil->v1 ].xyz, tri->verts[ sil->v2 ].xyz,
-				frustum, shadowVerts[v1].ToVec3(), shadowVerts[v2].ToVec3() ) ) {
+				frustum, ctx->shadowVerts[v1].ToVec3(), ctx->shadowVerts[v2].ToVec3() ) ) {
 				continue;	// clipped away
 			}
 
-			numShadowVerts += 4;
+			ctx->numShadowVerts += 4;
 		} else {
 			// use the entire edge
-			v1 = remap[ sil->v1 ];
-			v2 = remap[ sil->v2 ];
+			v1 = ctx->remap[ sil->v1 ];
+			v2 = ctx->remap[ sil->v2 ];
 			if ( v1 < 0 || v2 < 0 ) {
 				common->Error( "R_AddSilEdges: bad remap[]" );
 			}
 		}
 
 		// don't overflow
-		if ( numShadowIndexes + 6 > MAX_SHADOW_INDEXES ) {
-			overflowed = true;
+		if ( ctx->numShadowIndexes + 6 > MAX_SHADOW_INDEXES ) {
+			ctx->overflowed = true;
 			return;
 		}
 
@@ -704,37 +744,37 @@ static void R_AddSilEdges( const srfTriangles_t *tri, unsigned short *pointCull,
 		// consistantly between any two points, no matter which order they are specified.
 		// If this wasn't done, slight rasterization cracks would show in the shadow
 		// volume when two sil edges were exactly coincident
-		if ( faceCastsShadow[ sil->p2 ] ) {
-			if ( PointsOrdered( shadowVerts[ v1 ].ToVec3(), shadowVerts[ v2 ].ToVec3() ) ) {
-				shadowIndexes[numShadowIndexes++] = v1;
-				shadowIndexes[numShadowIndexes++] = v1+1;
-				shadowIndexes[numShadowIndexes++] = v2;
-				shadowIndexes[numShadowIndexes++] = v2;
-				shadowIndexes[numShadowIndexes++] = v1+1;
-				shadowIndexes[numShadowIndexes++] = v2+1;
+		if ( ctx->faceCastsShadow[ sil->p2 ] ) {
+			if ( PointsOrdered( ctx->shadowVerts[ v1 ].ToVec3(), ctx->shadowVerts[ v2 ].ToVec3() ) ) {
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v1;
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v1+1;
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v2;
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v2;
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v1+1;
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v2+1;
 			} else {
-				shadowIndexes[numShadowIndexes++] = v1;
-				shadowIndexes[numShadowIndexes++] = v2+1;
-				shadowIndexes[numShadowIndexes++] = v2;
-				shadowIndexes[numShadowIndexes++] = v1;
-				shadowIndexes[numShadowIndexes++] = v1+1;
-				shadowIndexes[numShadowIndexes++] = v2+1;
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v1;
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v2+1;
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v2;
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v1;
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v1+1;
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v2+1;
 			}
 		} else {
-			if ( PointsOrdered( shadowVerts[ v1 ].ToVec3(), shadowVerts[ v2 ].ToVec3() ) ) {
-				shadowIndexes[numShadowIndexes++] = v1;
-				shadowIndexes[numShadowIndexes++] = v2;
-				shadowIndexes[numShadowIndexes++] = v1+1;
-				shadowIndexes[numShadowIndexes++] = v2;
-				shadowIndexes[numShadowIndexes++] = v2+1;
-				shadowIndexes[numShadowIndexes++] = v1+1;
+			if ( PointsOrdered( ctx->shadowVerts[ v1 ].ToVec3(), ctx->shadowVerts[ v2 ].ToVec3() ) ) {
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v1;
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v2;
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v1+1;
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v2;
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v2+1;
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v1+1;
 			} else {
-				shadowIndexes[numShadowIndexes++] = v1;
-				shadowIndexes[numShadowIndexes++] = v2;
-				shadowIndexes[numShadowIndexes++] = v2+1;
-				shadowIndexes[numShadowIndexes++] = v1;
-				shadowIndexes[numShadowIndexes++] = v2+1;
-				shadowIndexes[numShadowIndexes++] = v1+1;
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v1;
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v2;
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v2+1;
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v1;
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v2+1;
+				ctx->shadowIndexes[ctx->numShadowIndexes++] = v1+1;
 			}
 		}
 	}
@@ -747,13 +787,13 @@ R_CalcPointCull
 Also inits the remap[] array to all -1
 ================
 */
-static void R_CalcPointCull( const srfTriangles_t *tri, const idPlane frustum[6], unsigned short *pointCull ) {
+static void R_CalcPointCull( shadowScratch_t *ctx, const srfTriangles_t *tri, const idPlane frustum[6], unsigned short *pointCull ) {
 	int i;
 	int frontBits;
 	float *planeSide;
 	byte *side1, *side2;
 
-	SIMDProcessor->Memset( remap, -1, tri->numVerts * sizeof( remap[0] ) );
+	SIMDProcessor->Memset( ctx->remap, -1, tri->numVerts * sizeof( ctx->remap[0] ) );
 
 	for ( frontBits = 0, i = 0; i < 6; i++ ) {
 		// get front bits for the whole surface
@@ -807,7 +847,7 @@ If the frustum is just part of a point light, clipped planes don't
 need to be added.
 =================
 */
-static void R_CreateShadowVolumeInFrustum( const idRenderEntityLocal *ent,
+static void R_CreateShadowVolumeInFrustum( shadowScratch_t *ctx, const idRenderEntityLocal *ent,
 										  const srfTriangles_t *tri,
 										  const idRenderLightLocal *light,
 										  const idVec3 lightOrigin,
@@ -826,23 +866,23 @@ static void R_CreateShadowVolumeInFrustum( const idRenderEntityLocal *ent,
 
 	// test the vertexes for inside the light frustum, which will allow
 	// us to completely cull away some triangles from consideration.
-	R_CalcPointCull( tri, frustum, pointCull );
+	R_CalcPointCull( ctx, tri, frustum, pointCull );
 
 	// this may not be the first frustum added to the volume
-	firstShadowIndex = numShadowIndexes;
-	firstShadowVert = numShadowVerts;
+	firstShadowIndex = ctx->numShadowIndexes;
+	firstShadowVert = ctx->numShadowVerts;
 
 	// decide which triangles front shadow volumes, clipping as needed
-	numClipSilEdges = 0;
+	ctx->numClipSilEdges = 0;
 	numTris = tri->numIndexes / 3;
 	for ( i = 0 ; i < numTris ; i++ ) {
 		int		i1, i2, i3;
 
-		faceCastsShadow[i] = 0;	// until shown otherwise
+		ctx->faceCastsShadow[i] = 0;	// until shown otherwise
 
 		// if it isn't facing the right way, don't add it
 		// to the shadow volume
-		if ( globalFacing[i] ) {
+		if ( ctx->globalFacing[i] ) {
 			continue;
 		}
 
@@ -861,25 +901,25 @@ static void R_CreateShadowVolumeInFrustum( const idRenderEntityLocal *ent,
 		// we need to get the original verts even from clipped triangles
 		// so the edges reference correctly, because an edge may be unclipped
 		// even when a triangle is clipped.
-		if ( numShadowVerts + 6 > MAX_SHADOW_VERTS ) {
-			overflowed = true;
+		if ( ctx->numShadowVerts + 6 > MAX_SHADOW_VERTS ) {
+			ctx->overflowed = true;
 			return;
 		}
 
-		if ( !POINT_CULLED(i1) && remap[i1] == -1 ) {
-			remap[i1] = numShadowVerts;
-			shadowVerts[ numShadowVerts ].ToVec3() = tri->verts[i1].xyz;
-			numShadowVerts+=2;
+		if ( !POINT_CULLED(i1) && ctx->remap[i1] == -1 ) {
+			ctx->remap[i1] = ctx->numShadowVerts;
+			ctx->shadowVerts[ ctx->numShadowVerts ].ToVec3() = tri->verts[i1].xyz;
+			ctx->numShadowVerts+=2;
 		}
-		if ( !POINT_CULLED(i2) && remap[i2] == -1 ) {
-			remap[i2] = numShadowVerts;
-			shadowVerts[ numShadowVerts ].ToVec3() = tri->verts[i2].xyz;
-			numShadowVerts+=2;
+		if ( !POINT_CULLED(i2) && ctx->remap[i2] == -1 ) {
+			ctx->remap[i2] = ctx->numShadowVerts;
+			ctx->shadowVerts[ ctx->numShadowVerts ].ToVec3() = tri->verts[i2].xyz;
+			ctx->numShadowVerts+=2;
 		}
-		if ( !POINT_CULLED(i3) && remap[i3] == -1 ) {
-			remap[i3] = numShadowVerts;
-			shadowVerts[ numShadowVerts ].ToVec3() = tri->verts[i3].xyz;
-			numShadowVerts+=2;
+		if ( !POINT_CULLED(i3) && ctx->remap[i3] == -1 ) {
+			ctx->remap[i3] = ctx->numShadowVerts;
+			ctx->shadowVerts[ ctx->numShadowVerts ].ToVec3() = tri->verts[i3].xyz;
+			ctx->numShadowVerts+=2;
 		}
 
 		// clip the triangle if any points are on the negative sides
@@ -887,29 +927,29 @@ static void R_CreateShadowVolumeInFrustum( const idRenderEntityLocal *ent,
 			cullBits = ( ( pointCull[ i1 ] ^ 0xfc0 ) | ( pointCull[ i2 ] ^ 0xfc0 ) | ( pointCull[ i3 ] ^ 0xfc0 ) ) >> 6;
 			// this will also define clip edges that will become
 			// silhouette planes
-			if ( R_ClipTriangleToLight( tri->verts[i1].xyz, tri->verts[i2].xyz,
+			if ( R_ClipTriangleToLight( ctx, tri->verts[i1].xyz, tri->verts[i2].xyz,
 				tri->verts[i3].xyz, cullBits, frustum ) ) {
-				faceCastsShadow[i] = 1;
+				ctx->faceCastsShadow[i] = 1;
 			}
 		} else {
 			// instead of overflowing or drawing a streamer shadow, don't draw a shadow at all
-			if ( numShadowIndexes + 3 > MAX_SHADOW_INDEXES ) {
-				overflowed = true;
+			if ( ctx->numShadowIndexes + 3 > MAX_SHADOW_INDEXES ) {
+				ctx->overflowed = true;
 				return;
 			}
-			if ( remap[i1] == -1 || remap[i2] == -1 || remap[i3] == -1 ) {
+			if ( ctx->remap[i1] == -1 || ctx->remap[i2] == -1 || ctx->remap[i3] == -1 ) {
 				common->Error( "R_CreateShadowVolumeInFrustum: bad remap[]" );
 			}
-			shadowIndexes[numShadowIndexes++] = remap[i3];
-			shadowIndexes[numShadowIndexes++] = remap[i2];
-			shadowIndexes[numShadowIndexes++] = remap[i1];
-			faceCastsShadow[i] = 1;
+			ctx->shadowIndexes[ctx->numShadowIndexes++] = ctx->remap[i3];
+			ctx->shadowIndexes[ctx->numShadowIndexes++] = ctx->remap[i2];
+			ctx->shadowIndexes[ctx->numShadowIndexes++] = ctx->remap[i1];
+			ctx->faceCastsShadow[i] = 1;
 		}
 	}
 
 	// add indexes for the back caps, which will just be reversals of the
 	// front caps using the back vertexes
-	numCapIndexes = numShadowIndexes - firstShadowIndex;
+	numCapIndexes = ctx->numShadowIndexes - firstShadowIndex;
 
 	// if no faces have been defined for the shadow volume,
 	// there won't be anything at all
@@ -921,23 +961,23 @@ static void R_CreateShadowVolumeInFrustum( const idRenderEntityLocal *ent,
 
 	// if we are running from dmap, perform the (very) expensive shadow optimizations
 	// to remove internal sil edges and optimize the caps
-	if ( callOptimizer ) {
+	if ( ctx->callOptimizer ) {
 		optimizedShadow_t opt;
 
 		// project all of the vertexes to the shadow plane, generating
 		// an equal number of back vertexes
-//		R_ProjectPointsToFarPlane( ent, light, farPlane, firstShadowVert, numShadowVerts );
+//		R_ProjectPointsToFarPlane( ctx, ent, light, farPlane, firstShadowVert, ctx->numShadowVerts );
 
-		opt = SuperOptimizeOccluders( shadowVerts, shadowIndexes + firstShadowIndex, numCapIndexes, farPlane, lightOrigin );
+		opt = SuperOptimizeOccluders( ctx->shadowVerts, ctx->shadowIndexes + firstShadowIndex, numCapIndexes, farPlane, lightOrigin );
 
 		// pull off the non-optimized data
-		numShadowIndexes = firstShadowIndex;
-		numShadowVerts = firstShadowVert;
+		ctx->numShadowIndexes = firstShadowIndex;
+		ctx->numShadowVerts = firstShadowVert;
 
 		// add the optimized data
-		if ( numShadowIndexes + opt.totalIndexes > MAX_SHADOW_INDEXES
-			|| numShadowVerts + opt.numVerts > MAX_SHADOW_VERTS ) {
-			overflowed = true;
+		if ( ctx->numShadowIndexes + opt.totalIndexes > MAX_SHADOW_INDEXES
+			|| ctx->numShadowVerts + opt.numVerts > MAX_SHADOW_VERTS ) {
+			ctx->overflowed = true;
 			common->Printf( "WARNING: overflowed MAX_SHADOW tables, shadow discarded\n" );
 			Mem_Free( opt.verts );
 			Mem_Free( opt.indexes );
@@ -945,28 +985,28 @@ static void R_CreateShadowVolumeInFrustum( const idRenderEntityLocal *ent,
 		}
 
 		for ( i = 0 ; i < opt.numVerts ; i++ ) {
-			shadowVerts[numShadowVerts+i][0] = opt.verts[i][0];
-			shadowVerts[numShadowVerts+i][1] = opt.verts[i][1];
-			shadowVerts[numShadowVerts+i][2] = opt.verts[i][2];
-			shadowVerts[numShadowVerts+i][3] = 1;
+			ctx->shadowVerts[ctx->numShadowVerts+i][0] = opt.verts[i][0];
+			ctx->shadowVerts[ctx->numShadowVerts+i][1] = opt.verts[i][1];
+			ctx->shadowVerts[ctx->numShadowVerts+i][2] = opt.verts[i][2];
+			ctx->shadowVerts[ctx->numShadowVerts+i][3] = 1;
 		}
 		for ( i = 0 ; i < opt.totalIndexes ; i++ ) {
 			int	index = opt.indexes[i];
 			if ( index < 0 || index > opt.numVerts ) {
 				common->Error( "optimized shadow index out of range" );
 			}
-			shadowIndexes[numShadowIndexes+i] = index + numShadowVerts;
+			ctx->shadowIndexes[ctx->numShadowIndexes+i] = index + ctx->numShadowVerts;
 		}
 
-		numShadowVerts += opt.numVerts;
-		numShadowIndexes += opt.totalIndexes;
+		ctx->numShadowVerts += opt.numVerts;
+		ctx->numShadowIndexes += opt.totalIndexes;
 
 		// note the index distribution so we can sort all the caps after all the sils
-		indexRef[indexFrustumNumber].frontCapStart = firstShadowIndex;
-		indexRef[indexFrustumNumber].rearCapStart = firstShadowIndex+opt.numFrontCapIndexes;
-		indexRef[indexFrustumNumber].silStart = firstShadowIndex+opt.numFrontCapIndexes+opt.numRearCapIndexes;
-		indexRef[indexFrustumNumber].end = numShadowIndexes;
-		indexFrustumNumber++;
+		ctx->indexRef[ctx->indexFrustumNumber].frontCapStart = firstShadowIndex;
+		ctx->indexRef[ctx->indexFrustumNumber].rearCapStart = firstShadowIndex+opt.numFrontCapIndexes;
+		ctx->indexRef[ctx->indexFrustumNumber].silStart = firstShadowIndex+opt.numFrontCapIndexes+opt.numRearCapIndexes;
+		ctx->indexRef[ctx->indexFrustumNumber].end = ctx->numShadowIndexes;
+		ctx->indexFrustumNumber++;
 
 		Mem_Free( opt.verts );
 		Mem_Free( opt.indexes );
@@ -978,47 +1018,47 @@ static void R_CreateShadowVolumeInFrustum( const idRenderEntityLocal *ent,
 	// the dangling edge "face" is never considered to cast a shadow,
 	// so any face with dangling edges that casts a shadow will have
 	// it's dangling sil edge trigger a sil plane
-	faceCastsShadow[numTris] = 0;
+	ctx->faceCastsShadow[numTris] = 0;
 
 	// instead of overflowing or drawing a streamer shadow, don't draw a shadow at all
 	// if we ran out of space
-	if ( numShadowIndexes + numCapIndexes > MAX_SHADOW_INDEXES ) {
-		overflowed = true;
+	if ( ctx->numShadowIndexes + numCapIndexes > MAX_SHADOW_INDEXES ) {
+		ctx->overflowed = true;
 		return;
 	}
 	for ( i = 0 ; i < numCapIndexes ; i += 3 ) {
-		shadowIndexes[ numShadowIndexes + i + 0 ] = shadowIndexes[ firstShadowIndex + i + 2 ] + 1;
-		shadowIndexes[ numShadowIndexes + i + 1 ] = shadowIndexes[ firstShadowIndex + i + 1 ] + 1;
-		shadowIndexes[ numShadowIndexes + i + 2 ] = shadowIndexes[ firstShadowIndex + i + 0 ] + 1;
+		ctx->shadowIndexes[ ctx->numShadowIndexes + i + 0 ] = ctx->shadowIndexes[ firstShadowIndex + i + 2 ] + 1;
+		ctx->shadowIndexes[ ctx->numShadowIndexes + i + 1 ] = ctx->shadowIndexes[ firstShadowIndex + i + 1 ] + 1;
+		ctx->shadowIndexes[ ctx->numShadowIndexes + i + 2 ] = ctx->shadowIndexes[ firstShadowIndex + i + 0 ] + 1;
 	}
-	numShadowIndexes += numCapIndexes;
+	ctx->numShadowIndexes += numCapIndexes;
 
-c_caps += numCapIndexes * 2;
+R_PerformanceCounters().c_caps += numCapIndexes * 2;
 
-int preSilIndexes = numShadowIndexes;
+int preSilIndexes = ctx->numShadowIndexes;
 
 	// if any triangles were clipped, we will have a list of edges
 	// on the frustum which must now become sil edges
 	if ( makeClippedPlanes ) {
-		R_AddClipSilEdges();
+		R_AddClipSilEdges( ctx );
 	}
 
 	// any edges that are a transition between a shadowing and
 	// non-shadowing triangle will cast a silhouette edge
-	R_AddSilEdges( tri, pointCull, frustum );
+	R_AddSilEdges( ctx, tri, pointCull, frustum );
 
-c_sils += numShadowIndexes - preSilIndexes;
+R_PerformanceCounters().c_sils += ctx->numShadowIndexes - preSilIndexes;
 
 	// project all of the vertexes to the shadow plane, generating
 	// an equal number of back vertexes
-	R_ProjectPointsToFarPlane( ent, light, farPlane, firstShadowVert, numShadowVerts );
+	R_ProjectPointsToFarPlane( ctx, ent, light, farPlane, firstShadowVert, ctx->numShadowVerts );
 
 	// note the index distribution so we can sort all the caps after all the sils
-	indexRef[indexFrustumNumber].frontCapStart = firstShadowIndex;
-	indexRef[indexFrustumNumber].rearCapStart = firstShadowIndex+numCapIndexes;
-	indexRef[indexFrustumNumber].silStart = preSilIndexes;
-	indexRef[indexFrustumNumber].end = numShadowIndexes;
-	indexFrustumNumber++;
+	ctx->indexRef[ctx->indexFrustumNumber].frontCapStart = firstShadowIndex;
+	ctx->indexRef[ctx->indexFrustumNumber].rearCapStart = firstShadowIndex+numCapIndexes;
+	ctx->indexRef[ctx->indexFrustumNumber].silStart = preSilIndexes;
+	ctx->indexRef[ctx->indexFrustumNumber].end = ctx->numShadowIndexes;
+	ctx->indexFrustumNumber++;
 }
 
 /*
@@ -1237,7 +1277,7 @@ srfTriangles_t *R_CreateShadowVolume( const idRenderEntityLocal *ent,
 		common->Error( "R_CreateShadowVolume: tri->numVerts = %i", tri->numVerts );
 	}
 
-	tr.pc.c_createShadowVolumes++;
+	R_PerformanceCounters().c_createShadowVolumes++;
 
 	// use the fast infinite projection in dynamic situations, which
 	// trades somewhat more overdraw and no cap optimizations for
@@ -1263,18 +1303,19 @@ srfTriangles_t *R_CreateShadowVolume( const idRenderEntityLocal *ent,
 	}
 
 	// clear the shadow volume
-	numShadowIndexes = 0;
-	numShadowVerts = 0;
-	overflowed = false;
-	indexFrustumNumber = 0;
+	shadowScratch_t *ctx = R_GetShadowScratch();
+	ctx->numShadowIndexes = 0;
+	ctx->numShadowVerts = 0;
+	ctx->overflowed = false;
+	ctx->indexFrustumNumber = 0;
 	capPlaneBits = 0;
-	callOptimizer = (optimize == SG_OFFLINE);
+	ctx->callOptimizer = (optimize == SG_OFFLINE);
 
 	// the facing information will be the same for all six projections
 	// from a point light, as well as for any directed lights
-	globalFacing = cullInfo.facing;
-	faceCastsShadow = (byte *)_alloca16( tri->numIndexes / 3 + 1 );	// + 1 for fake dangling edge face
-	remap = (int *)_alloca16( tri->numVerts * sizeof( remap[0] ) );
+	ctx->globalFacing = cullInfo.facing;
+	ctx->faceCastsShadow = (byte *)_alloca16( tri->numIndexes / 3 + 1 );	// + 1 for fake dangling edge face
+	ctx->remap = (int *)_alloca16( tri->numVerts * sizeof( ctx->remap[0] ) );
 
 	R_GlobalPointToLocal( ent->modelMatrix, light->globalLightOrigin, lightOrigin );
 
@@ -1305,17 +1346,17 @@ srfTriangles_t *R_CreateShadowVolume( const idRenderEntityLocal *ent,
 			continue;
 		}
 		// we need to check all the triangles
-		int		oldFrustumNumber = indexFrustumNumber;
+		int		oldFrustumNumber = ctx->indexFrustumNumber;
 
-		R_CreateShadowVolumeInFrustum( ent, tri, light, lightOrigin, frustum, frustum[5], frust->makeClippedPlanes );
+		R_CreateShadowVolumeInFrustum( ctx, ent, tri, light, lightOrigin, frustum, frustum[5], frust->makeClippedPlanes );
 
 		// if we couldn't make a complete shadow volume, it is better to
 		// not draw one at all, avoiding streamer problems
-		if ( overflowed ) {
+		if ( ctx->overflowed ) {
 			return NULL;
 		}
 
-		if ( indexFrustumNumber != oldFrustumNumber ) {
+		if ( ctx->indexFrustumNumber != oldFrustumNumber ) {
 			// note that we have caps projected against this frustum,
 			// which may allow us to skip drawing the caps if all projected
 			// planes face away from the viewer and the viewer is outside the light volume
@@ -1325,13 +1366,13 @@ srfTriangles_t *R_CreateShadowVolume( const idRenderEntityLocal *ent,
 
 	// if no faces have been defined for the shadow volume,
 	// there won't be anything at all
-	if ( numShadowIndexes == 0 ) {
+	if ( ctx->numShadowIndexes == 0 ) {
 		return NULL;
 	}
 
 	// this should have been prevented by the overflowed flag, so if it ever happens,
 	// it is a code error
-	if ( numShadowVerts > MAX_SHADOW_VERTS || numShadowIndexes > MAX_SHADOW_INDEXES ) {
+	if ( ctx->numShadowVerts > MAX_SHADOW_VERTS || ctx->numShadowIndexes > MAX_SHADOW_INDEXES ) {
 		common->FatalError( "Shadow volume exceeded allocation" );
 	}
 
@@ -1343,13 +1384,13 @@ srfTriangles_t *R_CreateShadowVolume( const idRenderEntityLocal *ent,
 	newTri->bounds.Clear();
 
 	// copy off the verts and indexes
-	newTri->numVerts = numShadowVerts;
-	newTri->numIndexes = numShadowIndexes;
+	newTri->numVerts = ctx->numShadowVerts;
+	newTri->numIndexes = ctx->numShadowIndexes;
 
 	// the shadow verts will go into a main memory buffer as well as a vertex
 	// cache buffer, so they can be copied back if they are purged
 	R_AllocStaticTriSurfShadowVerts( newTri, newTri->numVerts );
-	SIMDProcessor->Memcpy( newTri->shadowVertexes, shadowVerts, newTri->numVerts * sizeof( newTri->shadowVertexes[0] ) );
+	SIMDProcessor->Memcpy( newTri->shadowVertexes, ctx->shadowVerts, newTri->numVerts * sizeof( newTri->shadowVertexes[0] ) );
 
 	R_AllocStaticTriSurfIndexes( newTri, newTri->numIndexes );
 
@@ -1358,32 +1399,32 @@ srfTriangles_t *R_CreateShadowVolume( const idRenderEntityLocal *ent,
 
 		// copy the sil indexes first
 		newTri->numShadowIndexesNoCaps = 0;
-		for ( i = 0 ; i < indexFrustumNumber ; i++ ) {
-			int	c = indexRef[i].end - indexRef[i].silStart;
+		for ( i = 0 ; i < ctx->indexFrustumNumber ; i++ ) {
+			int	c = ctx->indexRef[i].end - ctx->indexRef[i].silStart;
 			SIMDProcessor->Memcpy( newTri->indexes+newTri->numShadowIndexesNoCaps,
-									shadowIndexes+indexRef[i].silStart, c * sizeof( newTri->indexes[0] ) );
+									ctx->shadowIndexes+ctx->indexRef[i].silStart, c * sizeof( newTri->indexes[0] ) );
 			newTri->numShadowIndexesNoCaps += c;
 		}
 		// copy rear cap indexes next
 		newTri->numShadowIndexesNoFrontCaps = newTri->numShadowIndexesNoCaps;
-		for ( i = 0 ; i < indexFrustumNumber ; i++ ) {
-			int	c = indexRef[i].silStart - indexRef[i].rearCapStart;
+		for ( i = 0 ; i < ctx->indexFrustumNumber ; i++ ) {
+			int	c = ctx->indexRef[i].silStart - ctx->indexRef[i].rearCapStart;
 			SIMDProcessor->Memcpy( newTri->indexes+newTri->numShadowIndexesNoFrontCaps,
-									shadowIndexes+indexRef[i].rearCapStart, c * sizeof( newTri->indexes[0] ) );
+									ctx->shadowIndexes+ctx->indexRef[i].rearCapStart, c * sizeof( newTri->indexes[0] ) );
 			newTri->numShadowIndexesNoFrontCaps += c;
 		}
 		// copy front cap indexes last
 		newTri->numIndexes = newTri->numShadowIndexesNoFrontCaps;
-		for ( i = 0 ; i < indexFrustumNumber ; i++ ) {
-			int	c = indexRef[i].rearCapStart - indexRef[i].frontCapStart;
+		for ( i = 0 ; i < ctx->indexFrustumNumber ; i++ ) {
+			int	c = ctx->indexRef[i].rearCapStart - ctx->indexRef[i].frontCapStart;
 			SIMDProcessor->Memcpy( newTri->indexes+newTri->numIndexes,
-									shadowIndexes+indexRef[i].frontCapStart, c * sizeof( newTri->indexes[0] ) );
+									ctx->shadowIndexes+ctx->indexRef[i].frontCapStart, c * sizeof( newTri->indexes[0] ) );
 			newTri->numIndexes += c;
 		}
 
 	} else {
 		newTri->shadowCapPlaneBits = 63;	// we don't have optimized index lists
-		SIMDProcessor->Memcpy( newTri->indexes, shadowIndexes, newTri->numIndexes * sizeof( newTri->indexes[0] ) );
+		SIMDProcessor->Memcpy( newTri->indexes, ctx->shadowIndexes, newTri->numIndexes * sizeof( newTri->indexes[0] ) );
 	}
 
 	if ( optimize == SG_OFFLINE ) {
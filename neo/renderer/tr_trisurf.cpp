@@ -378,6 +378,8 @@ void R_ReallyFreeStaticTriSurf( srfTriangles_t *tri ) {
 
 	R_FreeStaticTriSurfVertexCaches( tri );
 
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TRISURF );
+
 	if ( tri->verts != NULL ) {
 		// R_CreateLightTris points tri->verts at the verts of the ambient surface
 		if ( tri->ambientSurface == NULL || tri->verts != tri->ambientSurface->verts ) {
@@ -422,6 +424,8 @@ void R_ReallyFreeStaticTriSurf( srfTriangles_t *tri ) {
 #endif
 
 	srfTrianglesAllocator.Free( tri );
+
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TRISURF );
 }
 
 /*
@@ -505,6 +509,7 @@ void R_FreeStaticTriSurf( srfTriangles_t *tri ) {
 #ifdef ID_DEBUG_MEMORY
 		R_CheckStaticTriSurfMemory( tri );
 #endif
+		Sys_EnterCriticalSection( CRITICAL_SECTION_TRISURF );
 		tri->nextDeferredFree = NULL;
 		if ( frame->lastDeferredFreeTriSurf ) {
 			frame->lastDeferredFreeTriSurf->nextDeferredFree = tri;
@@ -512,6 +517,7 @@ void R_FreeStaticTriSurf( srfTriangles_t *tri ) {
 			frame->firstDeferredFreeTriSurf = tri;
 		}
 		frame->lastDeferredFreeTriSurf = tri;
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_TRISURF );
 	}
 }
 
@@ -521,7 +527,9 @@ R_AllocStaticTriSurf
 ==============
 */
 srfTriangles_t *R_AllocStaticTriSurf( void ) {
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TRISURF );
 	srfTriangles_t *tris = srfTrianglesAllocator.Alloc();
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TRISURF );
 	memset( tris, 0, sizeof( srfTriangles_t ) );
 	return tris;
 }
@@ -554,7 +562,9 @@ R_AllocStaticTriSurfVerts
 */
 void R_AllocStaticTriSurfVerts( srfTriangles_t *tri, int numVerts ) {
 	assert( tri->verts == NULL );
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TRISURF );
 	tri->verts = triVertexAllocator.Alloc( numVerts );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TRISURF );
 }
 
 /*
@@ -564,7 +574,9 @@ R_AllocStaticTriSurfIndexes
 */
 void R_AllocStaticTriSurfIndexes( srfTriangles_t *tri, int numIndexes ) {
 	assert( tri->indexes == NULL );
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TRISURF );
 	tri->indexes = triIndexAllocator.Alloc( numIndexes );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TRISURF );
 }
 
 /*
@@ -574,7 +586,9 @@ R_AllocStaticTriSurfShadowVerts
 */
 void R_AllocStaticTriSurfShadowVerts( srfTriangles_t *tri, int numVerts ) {
 	assert( tri->shadowVertexes == NULL );
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TRISURF );
 	tri->shadowVertexes = triShadowVertexAllocator.Alloc( numVerts );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TRISURF );
 }
 
 /*
@@ -583,10 +597,12 @@ R_AllocStaticTriSurfPlanes
 =================
 */
 void R_AllocStaticTriSurfPlanes( srfTriangles_t *tri, int numIndexes ) {
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TRISURF );
 	if ( tri->facePlanes ) {
 		triPlaneAllocator.Free( tri->facePlanes );
 	}
 	tri->facePlanes = triPlaneAllocator.Alloc( numIndexes / 3 );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TRISURF );
 }
 
 /*
@@ -596,7 +612,9 @@ R_ResizeStaticTriSurfVerts
 */
 void R_ResizeStaticTriSurfVerts( srfTriangles_t *tri, int numVerts ) {
 #ifdef USE_TRI_DATA_ALLOCATOR
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TRISURF );
 	tri->verts = triVertexAllocator.Resize( tri->verts, numVerts );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TRISURF );
 #else
 	assert( false );
 #endif
@@ -609,7 +627,9 @@ R_ResizeStaticTriSurfIndexes
 */
 void R_ResizeStaticTriSurfIndexes( srfTriangles_t *tri, int numIndexes ) {
 #ifdef USE_TRI_DATA_ALLOCATOR
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TRISURF );
 	tri->indexes = triIndexAllocator.Resize( tri->indexes, numIndexes );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TRISURF );
 #else
 	assert( false );
 #endif
@@ -622,7 +642,9 @@ R_ResizeStaticTriSurfShadowVerts
 */
 void R_ResizeStaticTriSurfShadowVerts( srfTriangles_t *tri, int numVerts ) {
 #ifdef USE_TRI_DATA_ALLOCATOR
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TRISURF );
 	tri->shadowVertexes = triShadowVertexAllocator.Resize( tri->shadowVertexes, numVerts );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TRISURF );
 #else
 	assert( false );
 #endif
@@ -652,7 +674,9 @@ R_FreeStaticTriSurfSilIndexes
 =================
 */
 void R_FreeStaticTriSurfSilIndexes( srfTriangles_t *tri ) {
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TRISURF );
 	triSilIndexAllocator.Free( tri->silIndexes );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TRISURF );
 	tri->silIndexes = NULL;
 }
 
@@ -1676,7 +1700,7 @@ void R_DeriveTangents( srfTriangles_t *tri, bool allocFacePlanes ) {
 		return;
 	}
 
-	tr.pc.c_tangentIndexes += tri->numIndexes;
+	R_PerformanceCounters().c_tangentIndexes += tri->numIndexes;
 
 	if ( !tri->facePlanes && allocFacePlanes ) {
 		R_AllocStaticTriSurfPlanes( tri, tri->numIndexes );
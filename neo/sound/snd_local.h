@@ -29,7 +29,7 @@ If you have questions concerning this license or the applicable additional terms
 #ifndef __SND_LOCAL_H__
 #define __SND_LOCAL_H__
 
-#ifdef ID_DEDICATED
+#if defined(ID_DEDICATED) || defined(ID_HEADLESS)
 // stub-only mode: AL_API and ALC_API shouldn't refer to any dll-stuff
 // because the implemenations are in openal_stub.cpp
 // this is ensured by defining AL_LIBTYPE_STATIC before including the AL headers
@@ -78,6 +78,7 @@ If you have questions concerning this license or the applicable additional terms
   #define ALC_OUTPUT_LIMITER_SOFT                  0x199A
 #endif
 
+#include "idlib/Profiler.h"
 #include "framework/UsercmdGen.h"
 #include "sound/efxlib.h"
 #include "sound/sound.h"
@@ -31,7 +31,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "sound/snd_local.h"
 #include <limits.h>
 
-#ifdef ID_DEDICATED
+#if defined(ID_DEDICATED) || defined(ID_HEADLESS)
 idCVar idSoundSystemLocal::s_noSound( "s_noSound", "1", CVAR_SOUND | CVAR_BOOL | CVAR_ROM, "" );
 #else
 idCVar idSoundSystemLocal::s_noSound( "s_noSound", "0", CVAR_SOUND | CVAR_BOOL | CVAR_NOCHEAT, "" );
@@ -70,7 +70,7 @@ idCVar idSoundSystemLocal::s_reverbFeedback( "s_reverbFeedback", "0.333", CVAR_S
 idCVar idSoundSystemLocal::s_enviroSuitVolumeScale( "s_enviroSuitVolumeScale", "0.9", CVAR_SOUND | CVAR_FLOAT, "" );
 idCVar idSoundSystemLocal::s_skipHelltimeFX( "s_skipHelltimeFX", "0", CVAR_SOUND | CVAR_BOOL, "" );
 
-#if !defined(ID_DEDICATED)
+#if !defined(ID_DEDICATED) && !defined(ID_HEADLESS)
 idCVar idSoundSystemLocal::s_useEAXReverb( "s_useEAXReverb", "1", CVAR_SOUND | CVAR_BOOL | CVAR_ARCHIVE, "use EFX reverb" );
 idCVar idSoundSystemLocal::s_decompressionLimit( "s_decompressionLimit", "6", CVAR_SOUND | CVAR_INTEGER | CVAR_ARCHIVE, "specifies maximum uncompressed sample length in seconds" );
 #else
@@ -774,6 +774,8 @@ Mac OSX version. The system uses it's own thread and an IOProc callback
 ===================
 */
 int idSoundSystemLocal::AsyncMix( int soundTime, float *mixBuffer ) {
+	PROFILE_ZONE( "idSoundSystem::AsyncMix" );
+
 	int	inTime, numSpeakers;
 
 	if ( !isInitialized || shutdown ) {
@@ -803,6 +805,7 @@ DG: using this for the "traditional" sound updates that
 ===================
 */
 int idSoundSystemLocal::AsyncUpdate( int inTime ) {
+	PROFILE_ZONE( "idSoundSystem::AsyncUpdate" );
 
 	if ( !isInitialized || shutdown ) {
 		return 0;
@@ -885,6 +888,7 @@ instead of once every ~100ms.
 ===================
 */
 int idSoundSystemLocal::AsyncUpdateWrite( int inTime ) {
+	PROFILE_ZONE( "idSoundSystem::AsyncUpdateWrite" );
 
 	if ( !isInitialized || shutdown ) {
 		return 0;
@@ -1534,7 +1538,7 @@ idSoundSystemLocal::IsEFXAvailable
 ===============
 */
 int idSoundSystemLocal::IsEFXAvailable( void ) {
-#if defined(ID_DEDICATED)
+#if defined(ID_DEDICATED) || defined(ID_HEADLESS)
 	return -1;
 #else
 	return EFXAvailable;
@@ -495,6 +495,8 @@ for AVIdemo writing
 ===================
 */
 void idSoundWorldLocal::MixLoop( int current44kHz, int numSpeakers, float *finalMixBuffer ) {
+	PROFILE_ZONE( "idSoundWorld::MixLoop" );
+
 	int i, j;
 	idSoundEmitterLocal *sound;
 
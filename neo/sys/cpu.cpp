@@ -79,28 +79,50 @@ static inline void CPUid(int index, int *a, int *b, int *c, int *d) {
 		"xchg %%" REG_b ", %%" REG_S
 		:	"=a" (*a), "=S" (*b),
 			"=c" (*c), "=d" (*d)
-		: "0" (index));
+		: "0" (index), "2" (0));
+}
+
+static inline unsigned int XGetBV0() {
+	unsigned int a, d;
+
+	// xgetbv, spelled out for assemblers that don't know the mnemonic
+	__asm__ volatile
+	(	".byte 0x0f, 0x01, 0xd0"
+		:	"=a" (a), "=d" (d)
+		: "c" (0));
+	return a;
 }
 #elif defined(_MSC_VER)
 #include <intrin.h>
 static inline void CPUid(int index, int *a, int *b, int *c, int *d) {
 	int info[4] = { };
 
-	// VS2005 and up
-	__cpuid(info, index);
+	// VS2008 SP1 and up
+	__cpuidex(info, index, 0);
 
 	*a = info[0];
 	*b = info[1];
 	*c = info[2];
 	*d = info[3];
 }
+
+static inline unsigned int XGetBV0() {
+	// VS2010 SP1 and up
+	return (unsigned int)_xgetbv(0);
+}
 #else
 #error unsupported compiler
 #endif
 
 #define c_SSE3		(1 << 0)
+#define c_FMA3		(1 << 12)
+#define c_OSXSAVE	(1 << 27)
+#define c_AVX		(1 << 28)
+#define b_AVX2		(1 << 5)
 #define d_FXSAVE	(1 << 24)
 
+#define XCR0_SSE_AVX	0x6		// the OS saves the XMM and YMM registers
+
 static inline bool HasDAZ() {
 	int a, b, c, d;
 
@@ -125,6 +147,44 @@ static inline bool HasSSE3() {
 	return (c & c_SSE3) == c_SSE3;
 }
 
+static inline bool HasAVXState() {
+	int a, b, c, d;
+
+	CPUid(0, &a, &b, &c, &d);
+	if (a < 1)
+		return false;
+
+	CPUid(1, &a, &b, &c, &d);
+	if ((c & (c_OSXSAVE | c_AVX)) != (c_OSXSAVE | c_AVX))
+		return false;
+
+	return (XGetBV0() & XCR0_SSE_AVX) == XCR0_SSE_AVX;
+}
+
+static inline bool HasAVX2() {
+	int a, b, c, d;
+
+	CPUid(0, &a, &b, &c, &d);
+	if (a < 7 || !HasAVXState())
+		return false;
+
+	CPUid(7, &a, &b, &c, &d);
+
+	return (b & b_AVX2) == b_AVX2;
+}
+
+static inline bool HasFMA3() {
+	int a, b, c, d;
+
+	CPUid(0, &a, &b, &c, &d);
+	if (a < 1 || !HasAVXState())
+		return false;
+
+	CPUid(1, &a, &b, &c, &d);
+
+	return (c & c_FMA3) == c_FMA3;
+}
+
 #define MXCSR_DAZ	(1 << 6)
 #define MXCSR_FTZ	(1 << 15)
 
@@ -214,6 +274,13 @@ int Sys_GetProcessorId( void ) {
 	// there is no SDL_HasSSE3() in SDL 1.2
 	if (HasSSE3())
 		flags |= CPUID_SSE3;
+
+	// SDL 1.2 doesn't know about AVX, and SDL2 doesn't know about FMA
+	if (HasAVX2())
+		flags |= CPUID_AVX2;
+
+	if (HasFMA3())
+		flags |= CPUID_FMA3;
 #endif
 
 	if (SDL_HasAltiVec())
@@ -0,0 +1,889 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include <SDL_version.h>
+#include <SDL_mutex.h>
+#include <SDL_thread.h>
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+#include <SDL_atomic.h>
+#include <SDL_cpuinfo.h>
+#endif
+
+#include "sys/platform.h"
+#include "idlib/containers/List.h"
+#include "idlib/math/Math.h"
+#include "idlib/Profiler.h"
+#include "framework/Common.h"
+#include "framework/CmdSystem.h"
+#include "framework/CVarSystem.h"
+
+#include "sys/sys_public.h"
+#include "sys/sys_jobs.h"
+
+idCVar sys_jobThreads( "sys_jobThreads", "-1", CVAR_SYSTEM | CVAR_INTEGER | CVAR_ARCHIVE, "number of job worker threads, -1 = number of CPU cores minus one, 0 = run jobs on the submitting thread, changes apply between frames", -1, MAX_JOB_THREADS - 1 );
+
+#ifdef _MSC_VER
+#define JOB_THREAD_LOCAL	__declspec( thread )
+#else
+#define JOB_THREAD_LOCAL	__thread
+#endif
+
+// set by the workers when they start, 0 for all other threads
+static JOB_THREAD_LOCAL int	jobThreadIndex;
+
+/*
+===============================================================================
+
+	idJobCounter
+
+	SDL2 has atomics, with SDL1.2 we have to use a mutex
+
+===============================================================================
+*/
+
+#if !SDL_VERSION_ATLEAST(2, 0, 0)
+static SDL_mutex *	counterMutex = NULL;
+#endif
+
+class idJobCounter {
+public:
+					idJobCounter( void ) { Set( 0 ); }
+
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	void			Set( int v ) { SDL_AtomicSet( &value, v ); }
+	int				Get( void ) { return SDL_AtomicGet( &value ); }
+					// returns the new value
+	int				Add( int v ) { return SDL_AtomicAdd( &value, v ) + v; }
+
+private:
+	SDL_atomic_t	value;
+#else
+	void			Set( int v ) { Add( v - value ); }
+	int				Get( void ) { return Add( 0 ); }
+	int				Add( int v ) {
+						if ( !counterMutex ) {
+							return ( value += v );
+						}
+						SDL_LockMutex( counterMutex );
+						int r = ( value += v );
+						SDL_UnlockMutex( counterMutex );
+						return r;
+					}
+
+private:
+	int				value;
+#endif
+};
+
+class idParallelJobListLocal;
+class idParallelJobManagerLocal;
+
+typedef struct {
+	jobRun_t					function;
+	void *						data;
+	idParallelJobListLocal *	list;
+} job_t;
+
+/*
+===============================================================================
+
+	idJobDeque
+
+	The owning thread pushes and pops at the back, other threads steal from
+	the front. Guarded by a mutex, contention is low because every thread
+	mostly works on its own deque.
+
+===============================================================================
+*/
+
+class idJobDeque {
+public:
+					idJobDeque( void );
+
+	void			Init( void );
+	void			Shutdown( void );
+
+	void			PushBack( job_t *job );
+	job_t *			PopBack( void );
+	job_t *			PopFront( void );
+
+private:
+	SDL_mutex *		mutex;
+	idList<job_t *>	ring;		// ring.Num() is always a power of two
+	int				first;
+	int				count;
+};
+
+/*
+================
+idJobDeque::idJobDeque
+================
+*/
+idJobDeque::idJobDeque( void ) {
+	mutex = NULL;
+	first = 0;
+	count = 0;
+}
+
+/*
+================
+idJobDeque::Init
+================
+*/
+void idJobDeque::Init( void ) {
+	mutex = SDL_CreateMutex();
+	ring.SetNum( 256 );
+	first = 0;
+	count = 0;
+}
+
+/*
+================
+idJobDeque::Shutdown
+================
+*/
+void idJobDeque::Shutdown( void ) {
+	SDL_DestroyMutex( mutex );
+	mutex = NULL;
+	ring.Clear();
+	first = 0;
+	count = 0;
+}
+
+/*
+================
+idJobDeque::PushBack
+================
+*/
+void idJobDeque::PushBack( job_t *job ) {
+	SDL_LockMutex( mutex );
+	if ( count == ring.Num() ) {
+		idList<job_t *> grown;
+		grown.SetNum( ring.Num() * 2 );
+		for ( int i = 0; i < count; i++ ) {
+			grown[i] = ring[( first + i ) & ( ring.Num() - 1 )];
+		}
+		ring = grown;
+		first = 0;
+	}
+	ring[( first + count ) & ( ring.Num() - 1 )] = job;
+	count++;
+	SDL_UnlockMutex( mutex );
+}
+
+/*
+================
+idJobDeque::PopBack
+================
+*/
+job_t *idJobDeque::PopBack( void ) {
+	job_t *job = NULL;
+
+	SDL_LockMutex( mutex );
+	if ( count > 0 ) {
+		count--;
+		job = ring[( first + count ) & ( ring.Num() - 1 )];
+	}
+	SDL_UnlockMutex( mutex );
+	return job;
+}
+
+/*
+================
+idJobDeque::PopFront
+================
+*/
+job_t *idJobDeque::PopFront( void ) {
+	job_t *job = NULL;
+
+	SDL_LockMutex( mutex );
+	if ( count > 0 ) {
+		job = ring[first];
+		first = ( first + 1 ) & ( ring.Num() - 1 );
+		count--;
+	}
+	SDL_UnlockMutex( mutex );
+	return job;
+}
+
+/*
+===============================================================================
+
+	idParallelJobListLocal
+
+===============================================================================
+*/
+
+class idParallelJobListLocal : public idParallelJobList {
+	friend class idParallelJobManagerLocal;
+public:
+							idParallelJobListLocal( const char *name, idParallelJobManagerLocal *manager );
+	virtual					~idParallelJobListLocal( void );
+
+	virtual const char *	GetName( void ) const { return name; }
+
+	virtual void			AddJob( jobRun_t function, void *data );
+	virtual void			AddDependency( idParallelJobList *list );
+	virtual void			Clear( void );
+	virtual int				NumJobs( void ) const { return jobs.Num(); }
+
+	virtual void			Submit( void );
+	virtual void			Wait( void );
+	virtual bool			IsSubmitted( void ) const { return submitted; }
+	virtual bool			IsDone( void ) const { return done; }
+
+private:
+	const char *			name;
+	idParallelJobManagerLocal *manager;
+	idList<job_t>			jobs;
+	idList<idParallelJobListLocal *> dependencies;
+	bool					submitted;
+	// set under the manager mutex once everything about the list is finished,
+	// so the owner can't reuse or free it while a worker still touches it
+	volatile bool			done;
+
+	// jobs that are not done yet, plus one while the jobs are not handed to the workers
+	idJobCounter			unfinished;
+	// lists waiting for this one, guarded by the manager mutex
+	idList<idParallelJobListLocal *> dependents;
+	// dependencies that are not done yet, guarded by the manager mutex
+	int						blockingDependencies;
+
+	// statistics
+	int						numSubmits;
+	int						numJobsRun;
+};
+
+/*
+===============================================================================
+
+	idParallelJobManagerLocal
+
+===============================================================================
+*/
+
+typedef struct {
+	idParallelJobManagerLocal *	manager;
+	int							threadIndex;
+	char						name[16];
+	xthreadInfo					info;
+} jobWorker_t;
+
+class idParallelJobManagerLocal : public idParallelJobManager {
+public:
+							idParallelJobManagerLocal( void );
+
+	virtual void			Init( void );
+	virtual void			Shutdown( void );
+
+	virtual idParallelJobList *	AllocJobList( const char *name );
+	virtual void			FreeJobList( idParallelJobList *list );
+
+	virtual int				GetNumWorkerThreads( void ) const { return numWorkers; }
+	virtual int				GetThreadIndex( void ) const;
+	virtual void			UpdateWorkerThreads( void );
+
+	void					SubmitList( idParallelJobListLocal *list );
+	void					WaitForList( idParallelJobListLocal *list );
+
+	static void				ListJobs_f( const idCmdArgs &args );
+
+private:
+	bool					initialized;
+	int						numWorkers;
+	jobWorker_t				workers[MAX_JOB_THREADS];
+	// slot 0 is shared by all threads that are not workers
+	idJobDeque				deques[MAX_JOB_THREADS];
+	// round robin start for jobs submitted by non-worker threads
+	int						nextDeque;
+
+	// guards sleeping, waking and the dependency bookkeeping of the lists
+	SDL_mutex *				mutex;
+	SDL_cond *				signal;
+	bool					shutdown;
+	// jobs pushed to a deque and not taken yet, may briefly become negative
+	idJobCounter			pendingJobs;
+
+	idList<idParallelJobListLocal *> jobLists;
+
+	// statistics, only written by the thread owning the slot (slot 0 is racy but that's fine for stats)
+	int						jobsRun[MAX_JOB_THREADS];
+	int						jobsStolen[MAX_JOB_THREADS];
+
+	static int				RequestedWorkers( void );
+	void					StartWorkers( int count );
+	void					StopWorkers( void );
+	void					ReleaseList( idParallelJobListLocal *list );
+	void					ListFinished( idParallelJobListLocal *list );
+	job_t *					FindJob( int threadIndex );
+	void					RunJob( job_t *job, int threadIndex );
+
+	static int				WorkerThread( void *parms );
+};
+
+static idParallelJobManagerLocal	parallelJobManagerLocal;
+idParallelJobManager *				parallelJobManager = &parallelJobManagerLocal;
+
+/*
+================
+idParallelJobListLocal::idParallelJobListLocal
+================
+*/
+idParallelJobListLocal::idParallelJobListLocal( const char *name, idParallelJobManagerLocal *manager ) {
+	this->name = name;
+	this->manager = manager;
+	submitted = false;
+	done = true;
+	blockingDependencies = 0;
+	numSubmits = 0;
+	numJobsRun = 0;
+}
+
+/*
+================
+idParallelJobListLocal::~idParallelJobListLocal
+================
+*/
+idParallelJobListLocal::~idParallelJobListLocal( void ) {
+	assert( !submitted );
+}
+
+/*
+================
+idParallelJobListLocal::AddJob
+================
+*/
+void idParallelJobListLocal::AddJob( jobRun_t function, void *data ) {
+	assert( !submitted );
+
+	job_t &job = jobs.Alloc();
+	job.function = function;
+	job.data = data;
+	job.list = this;
+}
+
+/*
+================
+idParallelJobListLocal::AddDependency
+================
+*/
+void idParallelJobListLocal::AddDependency( idParallelJobList *list ) {
+	assert( !submitted );
+	assert( list != this );
+
+	dependencies.AddUnique( static_cast<idParallelJobListLocal *>( list ) );
+}
+
+/*
+================
+idParallelJobListLocal::Clear
+================
+*/
+void idParallelJobListLocal::Clear( void ) {
+	assert( !submitted );
+
+	jobs.Clear();
+	dependencies.Clear();
+}
+
+/*
+================
+idParallelJobListLocal::Submit
+================
+*/
+void idParallelJobListLocal::Submit( void ) {
+	assert( !submitted );
+
+	submitted = true;
+	numSubmits++;
+	manager->SubmitList( this );
+}
+
+/*
+================
+idParallelJobListLocal::Wait
+================
+*/
+void idParallelJobListLocal::Wait( void ) {
+	if ( !submitted ) {
+		return;
+	}
+	manager->WaitForList( this );
+	submitted = false;
+}
+
+/*
+================
+idParallelJobManagerLocal::idParallelJobManagerLocal
+================
+*/
+idParallelJobManagerLocal::idParallelJobManagerLocal( void ) {
+	initialized = false;
+	numWorkers = 0;
+	nextDeque = 0;
+	mutex = NULL;
+	signal = NULL;
+	shutdown = false;
+	memset( workers, 0, sizeof( workers ) );
+	memset( jobsRun, 0, sizeof( jobsRun ) );
+	memset( jobsStolen, 0, sizeof( jobsStolen ) );
+}
+
+/*
+================
+idParallelJobManagerLocal::Init
+================
+*/
+void idParallelJobManagerLocal::Init( void ) {
+	assert( !initialized );
+
+#if !SDL_VERSION_ATLEAST(2, 0, 0)
+	counterMutex = SDL_CreateMutex();
+#endif
+
+	mutex = SDL_CreateMutex();
+	signal = SDL_CreateCond();
+	shutdown = false;
+	pendingJobs.Set( 0 );
+	nextDeque = 0;
+
+	initialized = true;
+
+	StartWorkers( RequestedWorkers() );
+
+	cmdSystem->AddCommand( "listJobs", ListJobs_f, CMD_FL_SYSTEM, "lists job worker threads and job lists" );
+
+	common->Printf( "%d job worker threads\n", numWorkers );
+}
+
+/*
+================
+idParallelJobManagerLocal::UpdateWorkerThreads
+
+Init runs before the config files are executed, this restarts the workers
+with the sys_jobThreads of the configs, and later on whenever it changes.
+Nothing is restarted while a submitted list isn't done yet.
+================
+*/
+void idParallelJobManagerLocal::UpdateWorkerThreads( void ) {
+	if ( !initialized || RequestedWorkers() == numWorkers ) {
+		return;
+	}
+
+	// try again next time if a list, like a background job, still runs
+	SDL_LockMutex( mutex );
+	for ( int i = 0; i < jobLists.Num(); i++ ) {
+		if ( !jobLists[i]->done ) {
+			SDL_UnlockMutex( mutex );
+			return;
+		}
+	}
+	SDL_UnlockMutex( mutex );
+
+	StopWorkers();
+	StartWorkers( RequestedWorkers() );
+
+	common->Printf( "%d job worker threads\n", numWorkers );
+}
+
+/*
+================
+idParallelJobManagerLocal::RequestedWorkers
+================
+*/
+int idParallelJobManagerLocal::RequestedWorkers( void ) {
+	int count = sys_jobThreads.GetInteger();
+	if ( count < 0 ) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		count = SDL_GetCPUCount() - 1;
+#else
+		count = 0;
+#endif
+	}
+	return idMath::ClampInt( 0, MAX_JOB_THREADS - 1, count );
+}
+
+/*
+================
+idParallelJobManagerLocal::StartWorkers
+================
+*/
+void idParallelJobManagerLocal::StartWorkers( int count ) {
+	numWorkers = count;
+	nextDeque = 0;
+
+	for ( int i = 0; i <= numWorkers; i++ ) {
+		deques[i].Init();
+	}
+
+	for ( int i = 1; i <= numWorkers; i++ ) {
+		jobWorker_t &worker = workers[i];
+		worker.manager = this;
+		worker.threadIndex = i;
+		idStr::snPrintf( worker.name, sizeof( worker.name ), "jobs%d", i );
+		Sys_CreateThread( WorkerThread, &worker, worker.info, worker.name );
+	}
+}
+
+/*
+================
+idParallelJobManagerLocal::StopWorkers
+================
+*/
+void idParallelJobManagerLocal::StopWorkers( void ) {
+	SDL_LockMutex( mutex );
+	shutdown = true;
+	SDL_CondBroadcast( signal );
+	SDL_UnlockMutex( mutex );
+
+	for ( int i = 1; i <= numWorkers; i++ ) {
+		Sys_DestroyThread( workers[i].info );
+	}
+
+	for ( int i = 0; i <= numWorkers; i++ ) {
+		deques[i].Shutdown();
+	}
+
+	shutdown = false;
+	numWorkers = 0;
+}
+
+/*
+================
+idParallelJobManagerLocal::Shutdown
+================
+*/
+void idParallelJobManagerLocal::Shutdown( void ) {
+	if ( !initialized ) {
+		return;
+	}
+
+	cmdSystem->RemoveCommand( "listJobs" );
+
+	StopWorkers();
+
+	if ( jobLists.Num() ) {
+		common->DPrintf( "WARNING: %d job lists not freed\n", jobLists.Num() );
+	}
+
+	SDL_DestroyCond( signal );
+	signal = NULL;
+	SDL_DestroyMutex( mutex );
+	mutex = NULL;
+
+#if !SDL_VERSION_ATLEAST(2, 0, 0)
+	SDL_DestroyMutex( counterMutex );
+	counterMutex = NULL;
+#endif
+
+	initialized = false;
+}
+
+/*
+================
+idParallelJobManagerLocal::AllocJobList
+================
+*/
+idParallelJobList *idParallelJobManagerLocal::AllocJobList( const char *name ) {
+	idParallelJobListLocal *list = new idParallelJobListLocal( name, this );
+
+	SDL_LockMutex( mutex );
+	jobLists.Append( list );
+	SDL_UnlockMutex( mutex );
+
+	return list;
+}
+
+/*
+================
+idParallelJobManagerLocal::FreeJobList
+================
+*/
+void idParallelJobManagerLocal::FreeJobList( idParallelJobList *list ) {
+	if ( list == NULL ) {
+		return;
+	}
+
+	list->Wait();
+
+	SDL_LockMutex( mutex );
+	jobLists.Remove( static_cast<idParallelJobListLocal *>( list ) );
+	SDL_UnlockMutex( mutex );
+
+	delete list;
+}
+
+/*
+================
+idParallelJobManagerLocal::GetThreadIndex
+================
+*/
+int idParallelJobManagerLocal::GetThreadIndex( void ) const {
+	return jobThreadIndex;
+}
+
+/*
+================
+idParallelJobManagerLocal::SubmitList
+================
+*/
+void idParallelJobManagerLocal::SubmitList( idParallelJobListLocal *list ) {
+	list->unfinished.Set( list->jobs.Num() + 1 );
+
+	if ( numWorkers == 0 ) {
+		// all lists submitted before are done already, so are the dependencies
+		for ( int i = 0; i < list->jobs.Num(); i++ ) {
+			RunJob( &list->jobs[i], 0 );
+		}
+		list->unfinished.Set( 0 );
+		return;
+	}
+
+	SDL_LockMutex( mutex );
+	list->done = false;
+	list->blockingDependencies = 0;
+	for ( int i = 0; i < list->dependencies.Num(); i++ ) {
+		idParallelJobListLocal *dependency = list->dependencies[i];
+		// done is only set with the mutex held, after the dependents were handled
+		if ( !dependency->done ) {
+			dependency->dependents.Append( list );
+			list->blockingDependencies++;
+		}
+	}
+	SDL_UnlockMutex( mutex );
+
+	if ( list->blockingDependencies == 0 ) {
+		ReleaseList( list );
+	}
+}
+
+/*
+================
+idParallelJobManagerLocal::ReleaseList
+
+hands the jobs of a list to the deques once all its dependencies are done
+================
+*/
+void idParallelJobManagerLocal::ReleaseList( idParallelJobListLocal *list ) {
+	int numJobs = list->jobs.Num();
+
+	if ( numJobs > 0 ) {
+		int threadIndex = GetThreadIndex();
+
+		if ( threadIndex != 0 ) {
+			// a worker keeps the jobs to itself, the others steal them if they are idle
+			for ( int i = 0; i < numJobs; i++ ) {
+				deques[threadIndex].PushBack( &list->jobs[i] );
+			}
+		} else {
+			SDL_LockMutex( mutex );
+			int start = nextDeque;
+			nextDeque = ( nextDeque + numJobs ) % ( numWorkers + 1 );
+			SDL_UnlockMutex( mutex );
+
+			for ( int i = 0; i < numJobs; i++ ) {
+				deques[( start + i ) % ( numWorkers + 1 )].PushBack( &list->jobs[i] );
+			}
+		}
+
+		SDL_LockMutex( mutex );
+		pendingJobs.Add( numJobs );
+		SDL_CondBroadcast( signal );
+		SDL_UnlockMutex( mutex );
+	}
+
+	// drop the reference that kept the list from finishing while the jobs were handed out
+	if ( list->unfinished.Add( -1 ) == 0 ) {
+		ListFinished( list );
+	}
+}
+
+/*
+================
+idParallelJobManagerLocal::ListFinished
+================
+*/
+void idParallelJobManagerLocal::ListFinished( idParallelJobListLocal *list ) {
+	idList<idParallelJobListLocal *> released;
+
+	SDL_LockMutex( mutex );
+	for ( int i = 0; i < list->dependents.Num(); i++ ) {
+		idParallelJobListLocal *dependent = list->dependents[i];
+		if ( --dependent->blockingDependencies == 0 ) {
+			released.Append( dependent );
+		}
+	}
+	list->dependents.Clear();
+	list->done = true;
+	// wake up threads waiting for this list
+	SDL_CondBroadcast( signal );
+	SDL_UnlockMutex( mutex );
+
+	for ( int i = 0; i < released.Num(); i++ ) {
+		ReleaseList( released[i] );
+	}
+}
+
+/*
+================
+idParallelJobManagerLocal::FindJob
+================
+*/
+job_t *idParallelJobManagerLocal::FindJob( int threadIndex ) {
+	job_t *job = deques[threadIndex].PopBack();
+
+	if ( job == NULL ) {
+		for ( int i = 1; i <= numWorkers; i++ ) {
+			job = deques[( threadIndex + i ) % ( numWorkers + 1 )].PopFront();
+			if ( job != NULL ) {
+				jobsStolen[threadIndex]++;
+				break;
+			}
+		}
+		if ( job == NULL ) {
+			return NULL;
+		}
+	}
+
+	pendingJobs.Add( -1 );
+	return job;
+}
+
+/*
+================
+idParallelJobManagerLocal::RunJob
+================
+*/
+void idParallelJobManagerLocal::RunJob( job_t *job, int threadIndex ) {
+	idParallelJobListLocal *list = job->list;
+
+	{
+		PROFILE_ZONE( list->name );
+		job->function( job->data );
+	}
+
+	jobsRun[threadIndex]++;
+
+	if ( list->unfinished.Add( -1 ) == 0 ) {
+		ListFinished( list );
+	}
+}
+
+/*
+================
+idParallelJobManagerLocal::WaitForList
+================
+*/
+void idParallelJobManagerLocal::WaitForList( idParallelJobListLocal *list ) {
+	PROFILE_ZONE( "WaitForList" );
+
+	int threadIndex = GetThreadIndex();
+
+	while ( 1 ) {
+		if ( !list->done ) {
+			job_t *job = FindJob( threadIndex );
+			if ( job != NULL ) {
+				RunJob( job, threadIndex );
+				continue;
+			}
+		}
+
+		SDL_LockMutex( mutex );
+		bool finished = list->done;
+		if ( !finished ) {
+			if ( pendingJobs.Get() <= 0 ) {
+				SDL_CondWait( signal, mutex );
+			} else {
+				// another thread took the last jobs and didn't count them yet, nobody signals that
+				SDL_CondWaitTimeout( signal, mutex, 1 );
+			}
+		}
+		SDL_UnlockMutex( mutex );
+
+		if ( finished ) {
+			break;
+		}
+	}
+
+	list->numJobsRun += list->jobs.Num();
+}
+
+/*
+================
+idParallelJobManagerLocal::WorkerThread
+================
+*/
+int idParallelJobManagerLocal::WorkerThread( void *parms ) {
+	jobWorker_t *worker = static_cast<jobWorker_t *>( parms );
+	idParallelJobManagerLocal *manager = worker->manager;
+
+	jobThreadIndex = worker->threadIndex;
+
+	while ( 1 ) {
+		job_t *job = manager->FindJob( worker->threadIndex );
+		if ( job != NULL ) {
+			manager->RunJob( job, worker->threadIndex );
+			continue;
+		}
+
+		SDL_LockMutex( manager->mutex );
+		while ( !manager->shutdown && manager->pendingJobs.Get() <= 0 ) {
+			SDL_CondWait( manager->signal, manager->mutex );
+		}
+		bool quit = manager->shutdown;
+		SDL_UnlockMutex( manager->mutex );
+
+		if ( quit ) {
+			break;
+		}
+	}
+
+	return 0;
+}
+
+/*
+================
+idParallelJobManagerLocal::ListJobs_f
+================
+*/
+void idParallelJobManagerLocal::ListJobs_f( const idCmdArgs &args ) {
+	idParallelJobManagerLocal &m = parallelJobManagerLocal;
+
+	common->Printf( "%d job worker threads\n", m.numWorkers );
+	for ( int i = 0; i <= m.numWorkers; i++ ) {
+		common->Printf( "%2d: %-8s %8d jobs run, %8d stolen\n", i, ( i == 0 ) ? "other" : m.workers[i].name, m.jobsRun[i], m.jobsStolen[i] );
+	}
+
+	SDL_LockMutex( m.mutex );
+	common->Printf( "%d job lists\n", m.jobLists.Num() );
+	for ( int i = 0; i < m.jobLists.Num(); i++ ) {
+		const idParallelJobListLocal *list = m.jobLists[i];
+		common->Printf( "%-32s %5d jobs %8d submits %10d jobs run\n", list->name, list->jobs.Num(), list->numSubmits, list->numJobsRun );
+	}
+	SDL_UnlockMutex( m.mutex );
+}
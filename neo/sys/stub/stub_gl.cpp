@@ -32,7 +32,7 @@ If you have questions concerning this license or the applicable additional terms
 #ifdef _MSC_VER
 #pragma warning(push)
 // for each gl function we get an inconsistent dll linkage warning, because SDL_OpenGL.h says they're dllimport
-// showing one warning is enough and it doesn't matter anyway (these stubs are for the dedicated server)
+// showing one warning is enough and it doesn't matter anyway (these stubs are for the dedicated server and the headless build)
 #pragma warning( once : 4273 )
 #endif
 
@@ -0,0 +1,104 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __SYS_JOBS__
+#define __SYS_JOBS__
+
+/*
+===============================================================================
+
+	Parallel jobs
+
+	A pool of worker threads runs jobs that are handed to it in job lists.
+	Every worker owns a deque of jobs, it takes work from the back of its own
+	deque and steals from the front of the other deques when that is empty.
+
+	A job list can depend on other job lists, its jobs are only started once
+	all jobs of those lists are done. Waiting for a list doesn't just block,
+	the waiting thread helps running jobs until the list is done.
+
+	Jobs run concurrently with each other and with the submitting thread, so
+	a job may only write to memory nobody else touches while its list runs.
+
+===============================================================================
+*/
+
+typedef void (*jobRun_t)( void * );
+
+// including the non-worker slot 0, see idParallelJobManager::GetThreadIndex()
+const int MAX_JOB_THREADS			= 32;
+
+class idParallelJobList {
+public:
+	virtual					~idParallelJobList( void ) {}
+
+	virtual const char *	GetName( void ) const = 0;
+
+							// not allowed while the list is submitted
+	virtual void			AddJob( jobRun_t function, void *data ) = 0;
+							// the jobs of this list won't start before all jobs of list are done.
+							// list has to be submitted before this one, otherwise it's considered done
+	virtual void			AddDependency( idParallelJobList *list ) = 0;
+							// removes all jobs and dependencies
+	virtual void			Clear( void ) = 0;
+	virtual int				NumJobs( void ) const = 0;
+
+							// hands the jobs to the worker threads and returns immediately
+	virtual void			Submit( void ) = 0;
+							// returns when all jobs are done, the calling thread runs jobs in the meantime.
+							// the list keeps its jobs and can be submitted again afterwards
+	virtual void			Wait( void ) = 0;
+	virtual bool			IsSubmitted( void ) const = 0;
+	virtual bool			IsDone( void ) const = 0;
+};
+
+class idParallelJobManager {
+public:
+	virtual					~idParallelJobManager( void ) {}
+
+	virtual void			Init( void ) = 0;
+	virtual void			Shutdown( void ) = 0;
+
+							// name is not copied and shows up as profile zone of the jobs, so it should be a string literal
+	virtual idParallelJobList *	AllocJobList( const char *name ) = 0;
+	virtual void			FreeJobList( idParallelJobList *list ) = 0;
+
+							// 0 if all jobs run on the thread that submits them
+	virtual int				GetNumWorkerThreads( void ) const = 0;
+							// 1 .. GetNumWorkerThreads() for workers, 0 for any other thread (usually the main thread).
+							// meant for indexing per-thread data of size MAX_JOB_THREADS
+	virtual int				GetThreadIndex( void ) const = 0;
+
+							// restarts the workers if sys_jobThreads changed and no submitted list is running,
+							// no list may be submitted meanwhile
+	virtual void			UpdateWorkerThreads( void ) = 0;
+};
+
+extern idParallelJobManager *	parallelJobManager;
+
+#endif /* !__SYS_JOBS__ */
@@ -57,6 +57,10 @@ unsigned int idSysLocal::GetMilliseconds( void ) {
 	return Sys_Milliseconds();
 }
 
+double idSysLocal::GetMillisecondsPrecise( void ) {
+	return Sys_MillisecondsPrecise();
+}
+
 int idSysLocal::GetProcessorId( void ) {
 	return Sys_GetProcessorId();
 }
@@ -41,6 +41,8 @@ typedef enum {
 	CPUID_SSE2							= 0x00080,	// Streaming SIMD Extensions 2
 	CPUID_SSE3							= 0x00100,	// Streaming SIMD Extentions 3 aka Prescott's New Instructions
 	CPUID_ALTIVEC						= 0x00200,	// AltiVec
+	CPUID_AVX2							= 0x00400,	// Advanced Vector Extensions 2, only set if the OS saves the AVX state
+	CPUID_FMA3							= 0x00800,	// Fused Multiply-Add
 } cpuidSimd_t;
 
 typedef enum {
@@ -163,6 +165,9 @@ void			Sys_Sleep( int msec );
 // any game related timing information should come from event timestamps
 unsigned int	Sys_Milliseconds( void );
 
+// like Sys_Milliseconds, but with sub-millisecond precision (where available) for profiling
+double			Sys_MillisecondsPrecise( void );
+
 // returns a selection of the CPUID_* flags
 int				Sys_GetProcessorId( void );
 
@@ -425,6 +430,7 @@ public:
 	virtual void			DebugVPrintf( const char *fmt, va_list arg ) = 0;
 
 	virtual unsigned int	GetMilliseconds( void ) = 0;
+	virtual double			GetMillisecondsPrecise( void ) = 0;
 	virtual int				GetProcessorId( void ) = 0;
 	virtual void			FPU_SetFTZ( bool enable ) = 0;
 	virtual void			FPU_SetDAZ( bool enable ) = 0;
@@ -77,6 +77,23 @@ unsigned int Sys_Milliseconds() {
 	return SDL_GetTicks();
 }
 
+/*
+================
+Sys_MillisecondsPrecise
+================
+*/
+double Sys_MillisecondsPrecise() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	static double ticksPerMsec = 0.0;
+	if ( ticksPerMsec == 0.0 ) {
+		ticksPerMsec = (double)SDL_GetPerformanceFrequency() * 0.001;
+	}
+	return (double)SDL_GetPerformanceCounter() / ticksPerMsec;
+#else
+	return SDL_GetTicks();
+#endif
+}
+
 /*
 ==================
 Sys_InitThreads
@@ -30,11 +30,14 @@ If you have questions concerning this license or the applicable additional terms
 #include "framework/FileSystem.h"
 #include "framework/Game.h"
 #include "renderer/RenderWorld.h"
+#include "sys/sys_jobs.h"
 
 #include "tools/compilers/aas/AASBuild_local.h"
 
 #define BFL_PATCH		0x1000
 
+idCVar aas_buildJobs( "aas_buildJobs", "1", CVAR_SYSTEM | CVAR_BOOL, "build the AAS files for all bounding box sizes and their reachabilities on the job threads" );
+
 //===============================================================
 //
 //	idAASBuild
@@ -54,6 +57,13 @@ idAASBuild::idAASBuild( void ) {
 	numMergedLeafNodes = 0;
 	numLedgeSubdivisions = 0;
 	ledgeMap = NULL;
+	mapFile = NULL;
+	buildBSP = NULL;
+	buildHasOutside = false;
+	buildStartTime = 0;
+	vertexHash = NULL;
+	edgeHash = NULL;
+	vertexShift = 0;
 }
 
 /*
@@ -85,6 +95,17 @@ void idAASBuild::Shutdown( void ) {
 		delete ledgeMap;
 		ledgeMap = NULL;
 	}
+	if ( buildBSP ) {
+		delete buildBSP;
+		buildBSP = NULL;
+	}
+	// brushes not yet handed over to a BSP tree
+	buildBrushList.Free();
+	entityClassNames.Clear();
+	buildFileName.Clear();
+	buildHasOutside = false;
+	buildError.Clear();
+	mapFile = NULL;
 }
 
 /*
@@ -635,67 +656,76 @@ void idAASBuild::ChangeMultipleBoundingBoxContents_r( idBrushBSPNode *node, int
 
 /*
 ============
-idAASBuild::Build
+idAASBuild::BeginBuild
+
+  Gathers the map brushes and loads the .proc file for the build.
+  Uses the file system and the decl manager so it runs on the main thread.
+  Returns false if no entities in the map use this AAS file.
 ============
 */
-bool idAASBuild::Build( const idStr &fileName, const idAASSettings *settings ) {
-	int i, bit, mask, startTime;
-	idMapFile * mapFile;
-	idBrushList brushList;
-	idList<idBrushList*> expandedBrushes;
-	idBrush *b;
-	idBrushBSP bsp;
+bool idAASBuild::BeginBuild( const idStr &fileName, const idAASSettings *settings, const idMapFile *mapFile ) {
 	idStr name;
-	idAASReach reach;
-	idAASCluster cluster;
-	idStrList entityClassNames;
 
-	startTime = Sys_Milliseconds();
+	buildStartTime = Sys_Milliseconds();
 
 	Shutdown();
 
 	aasSettings = settings;
+	this->mapFile = mapFile;
+	buildFileName = fileName;
 
 	name = fileName;
 	name.SetFileExtension( "map" );
 
-	mapFile = new idMapFile;
-	if ( !mapFile->Parse( name ) ) {
-		delete mapFile;
-		common->Error( "Couldn't load map file: '%s'", name.c_str() );
-		return false;
-	}
-
 	// check if this map has any entities that use this AAS file
 	if ( !CheckForEntities( mapFile, entityClassNames ) ) {
-		delete mapFile;
 		common->Printf( "no entities in map that use %s\n", settings->fileExtension.c_str() );
-		return true;
+		return false;
 	}
 
 	// load map file brushes
-	brushList = AddBrushesForMapFile( mapFile, brushList );
+	buildBrushList = AddBrushesForMapFile( mapFile, buildBrushList );
 
 	// if empty map
-	if ( brushList.Num() == 0 ) {
-		delete mapFile;
+	if ( buildBrushList.Num() == 0 ) {
 		common->Error( "%s is empty", name.c_str() );
 		return false;
 	}
 
+	// load the .proc file if it is newer than the .map file
+	LoadProcBSP( fileName, mapFile->GetFileTime() );
+
+	return true;
+}
+
+/*
+============
+idAASBuild::BuildFile
+
+  Builds the AAS file from the brushes gathered by BeginBuild.
+  Only touches this build so several builds can run on the job threads at the same time.
+============
+*/
+void idAASBuild::BuildFile( void ) {
+	int i, bit, mask;
+	idList<idBrushList*> expandedBrushes;
+	idBrush *b;
+	idAASReach reach;
+	idAASCluster cluster;
+
 	// merge as many brushes as possible before expansion
-	brushList.Merge( MergeAllowed );
+	buildBrushList.Merge( MergeAllowed );
 
 	// if there is a .proc file newer than the .map file
-	if ( LoadProcBSP( fileName, mapFile->GetFileTime() ) ) {
-		ClipBrushSidesWithProcBSP( brushList );
+	if ( procNodes ) {
+		ClipBrushSidesWithProcBSP( buildBrushList );
 		DeleteProcBSP();
 	}
 
 	// make copies of the brush list
-	expandedBrushes.Append( &brushList );
+	expandedBrushes.Append( &buildBrushList );
 	for ( i = 1; i < aasSettings->numBoundingBoxes; i++ ) {
-		expandedBrushes.Append( brushList.Copy() );
+		expandedBrushes.Append( buildBrushList.Copy() );
 	}
 
 	// expand brushes for the axial bounding boxes
@@ -711,81 +741,218 @@ bool idAASBuild::Build( const idStr &fileName, const idAASSettings *settings ) {
 
 	// move all brushes back into the original list
 	for ( i = 1; i < aasSettings->numBoundingBoxes; i++ ) {
-		brushList.AddToTail( *expandedBrushes[i] );
+		buildBrushList.AddToTail( *expandedBrushes[i] );
 		delete expandedBrushes[i];
 	}
 
+	buildBSP = new idBrushBSP;
+
 	if ( aasSettings->writeBrushMap ) {
-		bsp.WriteBrushMap( fileName, "_" + aasSettings->fileExtension, AREACONTENTS_SOLID );
+		buildBSP->WriteBrushMap( buildFileName, "_" + aasSettings->fileExtension, AREACONTENTS_SOLID );
 	}
 
-	// build BSP tree from brushes
-	bsp.Build( brushList, AREACONTENTS_SOLID, ExpandedChopAllowed, ExpandedMergeAllowed );
+	// build BSP tree from brushes, the tree owns the brushes from here on
+	buildBSP->Build( buildBrushList, AREACONTENTS_SOLID, ExpandedChopAllowed, ExpandedMergeAllowed );
+	buildBrushList.Clear();
 
 	// only solid nodes with all bits set for all bounding boxes need to stay solid
-	ChangeMultipleBoundingBoxContents_r( bsp.GetRootNode(), mask );
+	ChangeMultipleBoundingBoxContents_r( buildBSP->GetRootNode(), mask );
 
 	// portalize the bsp tree
-	bsp.Portalize();
+	buildBSP->Portalize();
 
 	// remove subspaces not reachable by entities
-	if ( !bsp.RemoveOutside( mapFile, AREACONTENTS_SOLID, entityClassNames ) ) {
-		bsp.LeakFile( name );
-		delete mapFile;
-		common->Printf( "%s has no outside", name.c_str() );
-		return false;
+	buildHasOutside = buildBSP->RemoveOutside( mapFile, AREACONTENTS_SOLID, entityClassNames );
+	if ( !buildHasOutside ) {
+		// the leak file is written by EndBuild
+		return;
 	}
 
 	// gravitational subdivision
-	GravitationalSubdivision( bsp );
+	GravitationalSubdivision( *buildBSP );
 
 	// merge portals where possible
-	bsp.MergePortals( AREACONTENTS_SOLID );
+	buildBSP->MergePortals( AREACONTENTS_SOLID );
 
 	// melt portal windings
-	bsp.MeltPortals( AREACONTENTS_SOLID );
+	buildBSP->MeltPortals( AREACONTENTS_SOLID );
 
 	if ( aasSettings->writeBrushMap ) {
-		WriteLedgeMap( fileName, "_" + aasSettings->fileExtension + "_ledge" );
+		WriteLedgeMap( buildFileName, "_" + aasSettings->fileExtension + "_ledge" );
 	}
 
 	// ledge subdivisions
-	LedgeSubdivision( bsp );
+	LedgeSubdivision( *buildBSP );
 
 	// merge leaf nodes
-	MergeLeafNodes( bsp );
+	MergeLeafNodes( *buildBSP );
 
 	// merge portals where possible
-	bsp.MergePortals( AREACONTENTS_SOLID );
+	buildBSP->MergePortals( AREACONTENTS_SOLID );
 
 	// melt portal windings
-	bsp.MeltPortals( AREACONTENTS_SOLID );
+	buildBSP->MeltPortals( AREACONTENTS_SOLID );
 
 	// store the file from the bsp tree
-	StoreFile( bsp );
+	StoreFile( *buildBSP );
 	file->settings = *aasSettings;
 
+	// the tree is no longer needed
+	delete buildBSP;
+	buildBSP = NULL;
+
 	// calculate reachability
 	reach.Build( mapFile, file );
 
 	// build clusters
-	cluster.Build( file );
+	if ( !cluster.Build( file ) ) {
+		buildError = cluster.GetError();
+		return;
+	}
 
 	// optimize the file
 	if ( !aasSettings->noOptimize ) {
 		file->Optimize();
 	}
+}
+
+/*
+============
+idAASBuild::EndBuild
+
+  Writes the AAS file or the leak file on the main thread.
+============
+*/
+bool idAASBuild::EndBuild( void ) {
+	idStr name;
+
+	name = buildFileName;
+	name.SetFileExtension( "map" );
+
+	if ( buildError.Length() ) {
+		common->Error( "%s: %s", name.c_str(), buildError.c_str() );
+		return false;
+	}
+
+	if ( !buildHasOutside ) {
+		buildBSP->LeakFile( name );
+		common->Printf( "%s has no outside", name.c_str() );
+		return false;
+	}
 
 	// write the file
 	name.SetFileExtension( aasSettings->fileExtension );
 	file->Write( name, mapFile->GetGeometryCRC() );
 
+	common->Printf( "%6d seconds to create AAS\n", (Sys_Milliseconds() - buildStartTime) / 1000 );
+
+	return true;
+}
+
+/*
+============
+idAASBuild::Build
+============
+*/
+bool idAASBuild::Build( const idStr &fileName, const idAASSettings *settings ) {
+	idMapFile * mapFile;
+	idStr name;
+	bool result;
+
+	name = fileName;
+	name.SetFileExtension( "map" );
+
+	mapFile = new idMapFile;
+	if ( !mapFile->Parse( name ) ) {
+		delete mapFile;
+		common->Error( "Couldn't load map file: '%s'", name.c_str() );
+		return false;
+	}
+
+	if ( !BeginBuild( fileName, settings, mapFile ) ) {
+		Shutdown();
+		delete mapFile;
+		return true;
+	}
+
+	BuildFile();
+	result = EndBuild();
+
+	// the build references the map file
+	Shutdown();
+
 	// delete the map file
 	delete mapFile;
 
-	common->Printf( "%6d seconds to create AAS\n", (Sys_Milliseconds() - startTime) / 1000 );
+	return result;
+}
 
-	return true;
+/*
+============
+idAASBuild::BuildFiles
+
+  Builds the AAS files for several bounding box sizes from a single parse of the map.
+  The files are built on the job threads and written in order on the main thread.
+============
+*/
+void idAASBuild::BuildFiles( const idStr &fileName, const idList<idAASSettings> &settings ) {
+	int i;
+	bool useJobs;
+	idMapFile * mapFile;
+	idStr name;
+	idList<idAASBuild *> builds;
+
+	name = fileName;
+	name.SetFileExtension( "map" );
+
+	mapFile = new idMapFile;
+	if ( !mapFile->Parse( name ) ) {
+		delete mapFile;
+		common->Error( "Couldn't load map file: '%s'", name.c_str() );
+		return;
+	}
+
+	// brush and ledge maps are written while building
+	useJobs = aas_buildJobs.GetBool();
+	for ( i = 0; i < settings.Num(); i++ ) {
+		if ( settings[i].writeBrushMap ) {
+			useJobs = false;
+		}
+	}
+
+	for ( i = 0; i < settings.Num(); i++ ) {
+		idAASBuild *build = new idAASBuild;
+		if ( !build->BeginBuild( fileName, &settings[i], mapFile ) ) {
+			delete build;
+			continue;
+		}
+		builds.Append( build );
+	}
+
+	if ( useJobs && builds.Num() > 1 ) {
+		idParallelJobList *jobList = parallelJobManager->AllocJobList( "AAS build" );
+		for ( i = 0; i < builds.Num(); i++ ) {
+			jobList->AddJob( (jobRun_t)idAASBuild::BuildFileJob, builds[i] );
+		}
+		jobList->Submit();
+		jobList->Wait();
+		parallelJobManager->FreeJobList( jobList );
+	} else {
+		for ( i = 0; i < builds.Num(); i++ ) {
+			builds[i]->BuildFile();
+		}
+	}
+
+	for ( i = 0; i < builds.Num(); i++ ) {
+		if ( i ) {
+			common->Printf( "=======================================================\n" );
+		}
+		builds[i]->EndBuild();
+		delete builds[i];
+	}
+
+	// delete the map file
+	delete mapFile;
 }
 
 /*
@@ -829,7 +996,11 @@ bool idAASBuild::BuildReachability( const idStr &fileName, const idAASSettings *
 	reach.Build( mapFile, file );
 
 	// build clusters
-	cluster.Build( file );
+	if ( !cluster.Build( file ) ) {
+		delete mapFile;
+		common->Error( "%s: %s", name.c_str(), cluster.GetError() );
+		return false;
+	}
 
 	// write the file
 	file->Write( name, mapFile->GetGeometryCRC() );
@@ -880,8 +1051,7 @@ RunAAS_f
 */
 void RunAAS_f( const idCmdArgs &args ) {
 	int i;
-	idAASBuild aas;
-	idAASSettings settings;
+	idList<idAASSettings> settings;
 	idStr mapName;
 
 	if ( args.Argc() <= 1 ) {
@@ -909,21 +1079,23 @@ void RunAAS_f( const idCmdArgs &args ) {
 		if ( !settingsDict ) {
 			common->Warning( "Unable to find '%s' in def/aas.def", kv->GetValue().c_str() );
 		} else {
-			settings.FromDict( kv->GetValue(), settingsDict );
-			i = ParseOptions( args, settings );
+			idAASSettings &typeSettings = settings.Alloc();
+			typeSettings.FromDict( kv->GetValue(), settingsDict );
+			i = ParseOptions( args, typeSettings );
 			mapName = args.Argv(i);
 			mapName.BackSlashesToSlashes();
 			if ( mapName.Icmpn( "maps/", 4 ) != 0 ) {
 				mapName = "maps/" + mapName;
 			}
-			aas.Build( mapName, &settings );
 		}
 
 		kv = dict->MatchPrefix( "type", kv );
-		if ( kv ) {
-			common->Printf( "=======================================================\n" );
-		}
 	}
+
+	if ( settings.Num() ) {
+		idAASBuild::BuildFiles( mapName, settings );
+	}
+
 	common->SetRefreshOnPrint( false );
 	common->PrintWarnings();
 }
@@ -935,8 +1107,7 @@ RunAASDir_f
 */
 void RunAASDir_f( const idCmdArgs &args ) {
 	int i;
-	idAASBuild aas;
-	idAASSettings settings;
+	idList<idAASSettings> settings;
 	idFileList *mapFiles;
 
 	if ( args.Argc() <= 1 ) {
@@ -954,6 +1125,17 @@ void RunAASDir_f( const idCmdArgs &args ) {
 		common->Error( "Unable to find entityDef for 'aas_types'" );
 	}
 
+	const idKeyValue *kv = dict->MatchPrefix( "type" );
+	while( kv != NULL ) {
+		const idDict *settingsDict = gameEdit->FindEntityDefDict( kv->GetValue(), false );
+		if ( !settingsDict ) {
+			common->Warning( "Unable to find '%s' in def/aas.def", kv->GetValue().c_str() );
+		} else {
+			settings.Alloc().FromDict( kv->GetValue(), settingsDict );
+		}
+		kv = dict->MatchPrefix( "type", kv );
+	}
+
 	// scan for .map files
 	mapFiles = fileSystem->ListFiles( idStr("maps/") + args.Argv(1), ".map" );
 
@@ -963,20 +1145,8 @@ void RunAASDir_f( const idCmdArgs &args ) {
 			common->Printf( "=======================================================\n" );
 		}
 
-		const idKeyValue *kv = dict->MatchPrefix( "type" );
-		while( kv != NULL ) {
-			const idDict *settingsDict = gameEdit->FindEntityDefDict( kv->GetValue(), false );
-			if ( !settingsDict ) {
-				common->Warning( "Unable to find '%s' in def/aas.def", kv->GetValue().c_str() );
-			} else {
-				settings.FromDict( kv->GetValue(), settingsDict );
-				aas.Build( idStr( "maps/" ) + args.Argv( 1 ) + "/" + mapFiles->GetFile( i ), &settings );
-			}
-
-			kv = dict->MatchPrefix( "type", kv );
-			if ( kv ) {
-				common->Printf( "=======================================================\n" );
-			}
+		if ( settings.Num() ) {
+			idAASBuild::BuildFiles( idStr( "maps/" ) + args.Argv( 1 ) + "/" + mapFiles->GetFile( i ), settings );
 		}
 	}
 
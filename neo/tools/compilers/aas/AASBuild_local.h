@@ -79,9 +79,25 @@ public:
 	bool					BuildReachability( const idStr &fileName, const idAASSettings *settings );
 	void					Shutdown( void );
 
+							// a build split up so it can run on a job thread, only BuildFile may run on a job thread
+	bool					BeginBuild( const idStr &fileName, const idAASSettings *settings, const idMapFile *mapFile );
+	void					BuildFile( void );
+	bool					EndBuild( void );
+	static void				BuildFileJob( idAASBuild *build ) { build->BuildFile(); }
+							// builds the AAS files for all settings from a single parse of the map
+	static void				BuildFiles( const idStr &fileName, const idList<idAASSettings> &settings );
+
 private:
 	const idAASSettings *	aasSettings;
 	idAASFileLocal *		file;
+	const idMapFile *		mapFile;
+	idStr					buildFileName;
+	idBrushList				buildBrushList;
+	idStrList				entityClassNames;
+	idBrushBSP *			buildBSP;
+	bool					buildHasOutside;
+	idStr					buildError;			// errors of BuildFile are raised on the main thread by EndBuild
+	int						buildStartTime;
 	aasProcNode_t *			procNodes;
 	int						numProcNodes;
 	int						numGravitationalSubdivisions;
@@ -142,6 +158,11 @@ private:	// storing file
 	void					SetSizeEstimate( const idBrushBSP &bsp, idAASFileLocal *file );
 	bool					StoreFile( const idBrushBSP &bsp );
 
+	idHashIndex *			vertexHash;
+	idHashIndex *			edgeHash;
+	idBounds				vertexBounds;
+	int						vertexShift;
+
 };
 
 #endif /* !__AASBUILD_LOCAL_H__ */
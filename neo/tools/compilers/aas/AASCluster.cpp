@@ -48,8 +48,8 @@ bool idAASCluster::UpdatePortal( int areaNum, int clusterNum ) {
 	}
 
 	if ( portalNum >= file->portals.Num() ) {
-		common->Error( "no portal for area %d", areaNum );
-		return true;
+		sprintf( error, "no portal for area %d", areaNum );
+		return false;
 	}
 
 	portal = &file->portals[portalNum];
@@ -105,7 +105,7 @@ bool idAASCluster::FloodClusterAreas_r( int areaNum, int clusterNum ) {
 			return true;
 		}
 		// there's a reachability going from one cluster to another only in one direction
-		common->Error( "cluster %d touched cluster %d at area %d\r\n", clusterNum, file->areas[areaNum].cluster, areaNum );
+		sprintf( error, "cluster %d touched cluster %d at area %d", clusterNum, file->areas[areaNum].cluster, areaNum );
 		return false;
 	}
 
@@ -466,6 +466,7 @@ bool idAASCluster::Build( idAASFileLocal *file ) {
 
 	this->file = file;
 	this->noFaceFlood = true;
+	this->error.Clear();
 
 	RemoveInvalidPortals();
 
@@ -481,6 +482,9 @@ bool idAASCluster::Build( idAASFileLocal *file ) {
 
 		// find the clusters
 		if ( !FindClusters() ) {
+			if ( error.Length() ) {
+				return false;
+			}
 			continue;
 		}
 
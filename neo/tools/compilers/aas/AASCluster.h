@@ -44,10 +44,13 @@ class idAASCluster {
 public:
 	bool					Build( idAASFileLocal *file );
 	bool					BuildSingleCluster( idAASFileLocal *file );
+							// the reason Build failed, raised by the caller on the main thread
+	const char *			GetError( void ) const { return error.c_str(); }
 
 private:
 	idAASFileLocal *		file;
 	bool					noFaceFlood;
+	idStr					error;
 
 private:
 	bool					UpdatePortal( int areaNum, int clusterNum );
@@ -1112,6 +1112,16 @@ bool idAASFileLocal::Load( const idStr &fileName, unsigned int mapFileCRC ) {
 	common->Printf( "[Load AAS]\n" );
 	common->Printf( "loading %s\n", name.c_str() );
 
+	// try the binary file first
+	if ( aas_binaryCache.GetBool() && LoadBinary( name, mapFileCRC ) ) {
+		depth = MaxTreeDepth();
+		if ( depth > MAX_AAS_TREE_DEPTH ) {
+			common->Warning( "idAASFileLocal::Load: tree depth = %d", depth );
+		}
+		common->Printf( "done.\n" );
+		return true;
+	}
+
 	if ( !src.LoadFile( name ) ) {
 		return false;
 	}
@@ -1195,6 +1205,11 @@ bool idAASFileLocal::Load( const idStr &fileName, unsigned int mapFileCRC ) {
 		src.Error( "idAASFileLocal::Load: tree depth = %d", depth );
 	}
 
+	// write the binary file so the file loads faster next time
+	if ( aas_binaryCache.GetBool() ) {
+		WriteBinary( name, c );
+	}
+
 	common->Printf( "done.\n" );
 
 	return true;
@@ -0,0 +1,856 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "sys/platform.h"
+#include "framework/FileSystem.h"
+
+#include "tools/compilers/aas/AASFile_local.h"
+
+#define AASB_FILE_SUFFIX		"b"		// maps/name.aas48 -> maps/name.aas48b
+#define AASB_FILEID				( ( 'B' << 24 ) | ( 'S' << 16 ) | ( 'A' << 8 ) | 'A' )	// little endian "AASB"
+#define AASB_FILEVERSION		1
+
+idCVar aas_binaryCache( "aas_binaryCache", "1", CVAR_SYSTEM | CVAR_BOOL, "load AAS files from binary .aas*b files and write those when loading text AAS files" );
+
+/*
+===============================================================================
+
+	Binary AAS file
+
+	A cached copy of a text AAS file that can be used without any parsing.
+	The header is followed by lumps with flat arrays of fixed size records.
+	Everything refers to everything else by index and is little endian.
+	The area bounds and centers are stored as well, so they don't have to be
+	recalculated on load.
+
+===============================================================================
+*/
+
+enum {
+	AASB_LUMP_PLANES,
+	AASB_LUMP_VERTICES,
+	AASB_LUMP_EDGES,
+	AASB_LUMP_EDGEINDEX,
+	AASB_LUMP_FACES,
+	AASB_LUMP_FACEINDEX,
+	AASB_LUMP_AREAS,
+	AASB_LUMP_REACHABILITIES,
+	AASB_LUMP_KEYVALUES,
+	AASB_LUMP_NODES,
+	AASB_LUMP_PORTALS,
+	AASB_LUMP_PORTALINDEX,
+	AASB_LUMP_CLUSTERS,
+	AASB_LUMP_STRINGS,				// must be last, not a multiple of 4 bytes
+	AASB_NUM_LUMPS
+};
+
+typedef struct aasbLump_s {
+	int					num;
+	int					ofs;
+} aasbLump_t;
+
+typedef struct aasbSettings_s {
+	int					numBoundingBoxes;
+	float				boundingBoxes[MAX_AAS_BOUNDING_BOXES][2][3];
+	int					usePatches;
+	int					writeBrushMap;
+	int					playerFlood;
+	int					noOptimize;
+	int					allowSwimReachabilities;
+	int					allowFlyReachabilities;
+	int					fileExtension;		// offset in the strings lump
+	float				gravity[3];
+	float				maxStepHeight;
+	float				maxBarrierHeight;
+	float				maxWaterJumpHeight;
+	float				maxFallHeight;
+	float				minFloorCos;
+	int					tt_barrierJump;
+	int					tt_startCrouching;
+	int					tt_waterJump;
+	int					tt_startWalkOffLedge;
+} aasbSettings_t;
+
+typedef struct aasbHeader_s {
+	int					ident;
+	int					version;
+	unsigned int		mapFileCRC;
+	aasbSettings_t		settings;
+	aasbLump_t			lumps[AASB_NUM_LUMPS];
+} aasbHeader_t;
+
+typedef struct aasbPlane_s {
+	float				normal[3];
+	float				dist;
+} aasbPlane_t;
+
+typedef struct aasbVertex_s {
+	float				p[3];
+} aasbVertex_t;
+
+typedef struct aasbEdge_s {
+	int					vertexNum[2];
+} aasbEdge_t;
+
+typedef struct aasbFace_s {
+	int					planeNum;
+	int					flags;
+	int					numEdges;
+	int					firstEdge;
+	int					areas[2];
+} aasbFace_t;
+
+typedef struct aasbArea_s {
+	int					numFaces;
+	int					firstFace;
+	float				bounds[2][3];
+	float				center[3];
+	int					flags;
+	int					contents;
+	int					cluster;
+	int					clusterAreaNum;
+	int					travelFlags;
+	int					numReachabilities;
+	int					firstReachability;	// in the order of the area reachability list
+} aasbArea_t;
+
+typedef struct aasbReachability_s {
+	int					travelType;
+	int					toAreaNum;
+	float				start[3];
+	float				end[3];
+	int					edgeNum;
+	int					travelTime;
+	int					numKeyValues;		// only used by TFL_SPECIAL
+	int					firstKeyValue;
+} aasbReachability_t;
+
+typedef struct aasbKeyValue_s {
+	int					key;				// offsets in the strings lump
+	int					value;
+} aasbKeyValue_t;
+
+typedef struct aasbNode_s {
+	int					planeNum;
+	int					children[2];
+} aasbNode_t;
+
+typedef struct aasbPortal_s {
+	int					areaNum;
+	int					clusters[2];
+	int					clusterAreaNum[2];
+} aasbPortal_t;
+
+typedef struct aasbCluster_s {
+	int					numAreas;
+	int					numReachableAreas;
+	int					numPortals;
+	int					firstPortal;
+} aasbCluster_t;
+
+static const int aasbLumpSizes[AASB_NUM_LUMPS] = {
+	sizeof( aasbPlane_t ),
+	sizeof( aasbVertex_t ),
+	sizeof( aasbEdge_t ),
+	sizeof( aasIndex_t ),
+	sizeof( aasbFace_t ),
+	sizeof( aasIndex_t ),
+	sizeof( aasbArea_t ),
+	sizeof( aasbReachability_t ),
+	sizeof( aasbKeyValue_t ),
+	sizeof( aasbNode_t ),
+	sizeof( aasbPortal_t ),
+	sizeof( aasIndex_t ),
+	sizeof( aasbCluster_t ),
+	sizeof( char )
+};
+
+/*
+================
+AASB_FileName
+================
+*/
+static idStr AASB_FileName( const idStr &fileName ) {
+	return fileName + AASB_FILE_SUFFIX;
+}
+
+/*
+================
+AASB_AddString
+================
+*/
+static int AASB_AddString( idList<char> &strings, const char *string ) {
+	int offset = strings.Num();
+	do {
+		strings.Append( *string );
+	} while( *string++ != '\0' );
+	return offset;
+}
+
+/*
+================
+AASB_WriteFloats
+================
+*/
+static void AASB_WriteFloats( idFile *fp, const float *f, int num ) {
+	for ( int i = 0; i < num; i++ ) {
+		fp->WriteFloat( f[i] );
+	}
+}
+
+/*
+================
+idAASFileLocal::WriteBinary
+
+  Writes the binary version of the file that was just loaded from text.
+================
+*/
+void idAASFileLocal::WriteBinary( const idStr &fileName, unsigned int mapFileCRC ) const {
+	int i, j, ofs;
+	idFile *fp;
+	idStr binaryFileName;
+	aasbHeader_t header;
+	const idReachability *reach;
+	const idKeyValue *keyValue;
+	idList<const idReachability *> reachabilities;
+	idList<int> firstKeyValue;
+	idList<aasbKeyValue_t> keyValues;
+	idList<char> strings;
+
+	reachabilities.SetGranularity( 1024 );
+	firstKeyValue.SetGranularity( 1024 );
+	strings.SetGranularity( 1024 );
+
+	memset( &header, 0, sizeof( header ) );
+	header.ident = AASB_FILEID;
+	header.version = AASB_FILEVERSION;
+	header.mapFileCRC = mapFileCRC;
+
+	AASB_AddString( strings, "" );
+
+	// settings
+	header.settings.numBoundingBoxes = settings.numBoundingBoxes;
+	for ( i = 0; i < MAX_AAS_BOUNDING_BOXES; i++ ) {
+		for ( j = 0; j < 2; j++ ) {
+			header.settings.boundingBoxes[i][j][0] = settings.boundingBoxes[i][j].x;
+			header.settings.boundingBoxes[i][j][1] = settings.boundingBoxes[i][j].y;
+			header.settings.boundingBoxes[i][j][2] = settings.boundingBoxes[i][j].z;
+		}
+	}
+	header.settings.usePatches = settings.usePatches;
+	header.settings.writeBrushMap = settings.writeBrushMap;
+	header.settings.playerFlood = settings.playerFlood;
+	header.settings.noOptimize = settings.noOptimize;
+	header.settings.allowSwimReachabilities = settings.allowSwimReachabilities;
+	header.settings.allowFlyReachabilities = settings.allowFlyReachabilities;
+	header.settings.fileExtension = AASB_AddString( strings, settings.fileExtension );
+	header.settings.gravity[0] = settings.gravity.x;
+	header.settings.gravity[1] = settings.gravity.y;
+	header.settings.gravity[2] = settings.gravity.z;
+	header.settings.maxStepHeight = settings.maxStepHeight;
+	header.settings.maxBarrierHeight = settings.maxBarrierHeight;
+	header.settings.maxWaterJumpHeight = settings.maxWaterJumpHeight;
+	header.settings.maxFallHeight = settings.maxFallHeight;
+	header.settings.minFloorCos = settings.minFloorCos;
+	header.settings.tt_barrierJump = settings.tt_barrierJump;
+	header.settings.tt_startCrouching = settings.tt_startCrouching;
+	header.settings.tt_waterJump = settings.tt_waterJump;
+	header.settings.tt_startWalkOffLedge = settings.tt_startWalkOffLedge;
+
+	// gather the reachabilities of all areas and the key/values of the special ones
+	for ( i = 0; i < areas.Num(); i++ ) {
+		for ( reach = areas[i].reach; reach; reach = reach->next ) {
+			reachabilities.Append( reach );
+			firstKeyValue.Append( keyValues.Num() );
+			if ( reach->travelType == TFL_SPECIAL ) {
+				const idDict &dict = static_cast<const idReachability_Special *>( reach )->dict;
+				for ( j = 0; j < dict.GetNumKeyVals(); j++ ) {
+					keyValue = dict.GetKeyVal( j );
+					aasbKeyValue_t &kv = keyValues.Alloc();
+					kv.key = AASB_AddString( strings, keyValue->GetKey() );
+					kv.value = AASB_AddString( strings, keyValue->GetValue() );
+				}
+			}
+		}
+	}
+
+	header.lumps[AASB_LUMP_PLANES].num = planeList.Num();
+	header.lumps[AASB_LUMP_VERTICES].num = vertices.Num();
+	header.lumps[AASB_LUMP_EDGES].num = edges.Num();
+	header.lumps[AASB_LUMP_EDGEINDEX].num = edgeIndex.Num();
+	header.lumps[AASB_LUMP_FACES].num = faces.Num();
+	header.lumps[AASB_LUMP_FACEINDEX].num = faceIndex.Num();
+	header.lumps[AASB_LUMP_AREAS].num = areas.Num();
+	header.lumps[AASB_LUMP_REACHABILITIES].num = reachabilities.Num();
+	header.lumps[AASB_LUMP_KEYVALUES].num = keyValues.Num();
+	header.lumps[AASB_LUMP_NODES].num = nodes.Num();
+	header.lumps[AASB_LUMP_PORTALS].num = portals.Num();
+	header.lumps[AASB_LUMP_PORTALINDEX].num = portalIndex.Num();
+	header.lumps[AASB_LUMP_CLUSTERS].num = clusters.Num();
+	header.lumps[AASB_LUMP_STRINGS].num = strings.Num();
+
+	ofs = sizeof( aasbHeader_t );
+	for ( i = 0; i < AASB_NUM_LUMPS; i++ ) {
+		header.lumps[i].ofs = ofs;
+		ofs += header.lumps[i].num * aasbLumpSizes[i];
+	}
+
+	binaryFileName = AASB_FileName( fileName );
+	fp = fileSystem->OpenFileWrite( binaryFileName, "fs_devpath" );
+	if ( !fp ) {
+		common->DPrintf( "idAASFileLocal::WriteBinary: Error opening file %s\n", binaryFileName.c_str() );
+		return;
+	}
+
+	// the header only consists of 32 bit values
+	for ( i = 0; i < (int) ( sizeof( header ) / sizeof( int ) ); i++ ) {
+		fp->WriteInt( ( (int *) &header )[i] );
+	}
+
+	for ( i = 0; i < planeList.Num(); i++ ) {
+		AASB_WriteFloats( fp, planeList[i].ToFloatPtr(), 4 );
+	}
+	for ( i = 0; i < vertices.Num(); i++ ) {
+		AASB_WriteFloats( fp, vertices[i].ToFloatPtr(), 3 );
+	}
+	for ( i = 0; i < edges.Num(); i++ ) {
+		fp->WriteInt( edges[i].vertexNum[0] );
+		fp->WriteInt( edges[i].vertexNum[1] );
+	}
+	for ( i = 0; i < edgeIndex.Num(); i++ ) {
+		fp->WriteInt( edgeIndex[i] );
+	}
+	for ( i = 0; i < faces.Num(); i++ ) {
+		fp->WriteInt( faces[i].planeNum );
+		fp->WriteInt( faces[i].flags );
+		fp->WriteInt( faces[i].numEdges );
+		fp->WriteInt( faces[i].firstEdge );
+		fp->WriteInt( faces[i].areas[0] );
+		fp->WriteInt( faces[i].areas[1] );
+	}
+	for ( i = 0; i < faceIndex.Num(); i++ ) {
+		fp->WriteInt( faceIndex[i] );
+	}
+	for ( i = 0, j = 0; i < areas.Num(); i++ ) {
+		const aasArea_t &area = areas[i];
+		int numReach = 0;
+		for ( reach = area.reach; reach; reach = reach->next ) {
+			numReach++;
+		}
+		fp->WriteInt( area.numFaces );
+		fp->WriteInt( area.firstFace );
+		AASB_WriteFloats( fp, area.bounds[0].ToFloatPtr(), 3 );
+		AASB_WriteFloats( fp, area.bounds[1].ToFloatPtr(), 3 );
+		AASB_WriteFloats( fp, area.center.ToFloatPtr(), 3 );
+		fp->WriteInt( area.flags );
+		fp->WriteInt( area.contents );
+		fp->WriteInt( area.cluster );
+		fp->WriteInt( area.clusterAreaNum );
+		fp->WriteInt( area.travelFlags );
+		fp->WriteInt( numReach );
+		fp->WriteInt( j );
+		j += numReach;
+	}
+	for ( i = 0; i < reachabilities.Num(); i++ ) {
+		reach = reachabilities[i];
+		fp->WriteInt( reach->travelType );
+		fp->WriteInt( reach->toAreaNum );
+		AASB_WriteFloats( fp, reach->start.ToFloatPtr(), 3 );
+		AASB_WriteFloats( fp, reach->end.ToFloatPtr(), 3 );
+		fp->WriteInt( reach->edgeNum );
+		fp->WriteInt( reach->travelTime );
+		fp->WriteInt( ( i < reachabilities.Num() - 1 ? firstKeyValue[i+1] : keyValues.Num() ) - firstKeyValue[i] );
+		fp->WriteInt( firstKeyValue[i] );
+	}
+	for ( i = 0; i < keyValues.Num(); i++ ) {
+		fp->WriteInt( keyValues[i].key );
+		fp->WriteInt( keyValues[i].value );
+	}
+	for ( i = 0; i < nodes.Num(); i++ ) {
+		fp->WriteInt( nodes[i].planeNum );
+		fp->WriteInt( nodes[i].children[0] );
+		fp->WriteInt( nodes[i].children[1] );
+	}
+	for ( i = 0; i < portals.Num(); i++ ) {
+		fp->WriteInt( portals[i].areaNum );
+		fp->WriteInt( portals[i].clusters[0] );
+		fp->WriteInt( portals[i].clusters[1] );
+		fp->WriteInt( portals[i].clusterAreaNum[0] );
+		fp->WriteInt( portals[i].clusterAreaNum[1] );
+	}
+	for ( i = 0; i < portalIndex.Num(); i++ ) {
+		fp->WriteInt( portalIndex[i] );
+	}
+	for ( i = 0; i < clusters.Num(); i++ ) {
+		fp->WriteInt( clusters[i].numAreas );
+		fp->WriteInt( clusters[i].numReachableAreas );
+		fp->WriteInt( clusters[i].numPortals );
+		fp->WriteInt( clusters[i].firstPortal );
+	}
+	fp->Write( strings.Ptr(), strings.Num() );
+
+	fileSystem->CloseFile( fp );
+}
+
+/*
+================
+AASB_ValidRange
+================
+*/
+static bool AASB_ValidRange( int first, int num, int max ) {
+	return ( num >= 0 && first >= 0 && first <= max - num );
+}
+
+/*
+================
+AASB_ValidString
+================
+*/
+static bool AASB_ValidString( int ofs, const aasbLump_t &strings ) {
+	return ( ofs >= 0 && ofs < strings.num );
+}
+
+/*
+================
+AASB_ValidSignedIndex
+
+  Index whose sign encodes a direction or type, the absolute value must be below max.
+================
+*/
+static bool AASB_ValidSignedIndex( int index, int max ) {
+	return ( index > -max && index < max );
+}
+
+/*
+================
+idAASFileLocal::ValidateBinary
+
+  Checks all counts and cross references so nothing has to be checked while copying.
+================
+*/
+bool idAASFileLocal::ValidateBinary( const byte *buffer, int size ) const {
+	int i, j, num[AASB_NUM_LUMPS];
+	const aasbHeader_t *header = (const aasbHeader_t *) buffer;
+
+	for ( i = 0; i < AASB_NUM_LUMPS; i++ ) {
+		int ofs = LittleInt( header->lumps[i].ofs );
+		num[i] = LittleInt( header->lumps[i].num );
+		if ( num[i] < 0 || ofs < (int) sizeof( aasbHeader_t ) || ofs > size || ( ofs & 3 ) ) {
+			return false;
+		}
+		if ( num[i] > ( size - ofs ) / aasbLumpSizes[i] ) {
+			return false;
+		}
+	}
+
+	const aasbLump_t &stringLump = header->lumps[AASB_LUMP_STRINGS];
+	aasbLump_t strings;
+	strings.num = LittleInt( stringLump.num );
+	strings.ofs = LittleInt( stringLump.ofs );
+	if ( strings.num < 1 || buffer[strings.ofs + strings.num - 1] != '\0' ) {
+		return false;
+	}
+
+	const aasbSettings_t &s = header->settings;
+	if ( LittleInt( s.numBoundingBoxes ) <= 0 || LittleInt( s.numBoundingBoxes ) > MAX_AAS_BOUNDING_BOXES ) {
+		return false;
+	}
+	if ( !AASB_ValidString( LittleInt( s.fileExtension ), strings ) ) {
+		return false;
+	}
+
+	const aasbEdge_t *edge = (const aasbEdge_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_EDGES].ofs ) );
+	for ( i = 0; i < num[AASB_LUMP_EDGES]; i++, edge++ ) {
+		for ( j = 0; j < 2; j++ ) {
+			if ( (unsigned int) LittleInt( edge->vertexNum[j] ) >= (unsigned int) num[AASB_LUMP_VERTICES] ) {
+				return false;
+			}
+		}
+	}
+
+	const aasIndex_t *index = (const aasIndex_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_EDGEINDEX].ofs ) );
+	for ( i = 0; i < num[AASB_LUMP_EDGEINDEX]; i++ ) {
+		if ( !AASB_ValidSignedIndex( LittleInt( index[i] ), num[AASB_LUMP_EDGES] ) ) {
+			return false;
+		}
+	}
+
+	const aasbFace_t *face = (const aasbFace_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_FACES].ofs ) );
+	for ( i = 0; i < num[AASB_LUMP_FACES]; i++, face++ ) {
+		if ( (unsigned int) LittleInt( face->planeNum ) >= (unsigned int) num[AASB_LUMP_PLANES] ) {
+			return false;
+		}
+		if ( !AASB_ValidRange( LittleInt( face->firstEdge ), LittleInt( face->numEdges ), num[AASB_LUMP_EDGEINDEX] ) ) {
+			return false;
+		}
+		for ( j = 0; j < 2; j++ ) {
+			if ( (unsigned int) LittleInt( face->areas[j] ) >= (unsigned int) num[AASB_LUMP_AREAS] ) {
+				return false;
+			}
+		}
+	}
+
+	index = (const aasIndex_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_FACEINDEX].ofs ) );
+	for ( i = 0; i < num[AASB_LUMP_FACEINDEX]; i++ ) {
+		if ( !AASB_ValidSignedIndex( LittleInt( index[i] ), num[AASB_LUMP_FACES] ) ) {
+			return false;
+		}
+	}
+
+	const aasbArea_t *area = (const aasbArea_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_AREAS].ofs ) );
+	for ( i = 0; i < num[AASB_LUMP_AREAS]; i++, area++ ) {
+		if ( !AASB_ValidRange( LittleInt( area->firstFace ), LittleInt( area->numFaces ), num[AASB_LUMP_FACEINDEX] ) ) {
+			return false;
+		}
+		if ( !AASB_ValidRange( LittleInt( area->firstReachability ), LittleInt( area->numReachabilities ), num[AASB_LUMP_REACHABILITIES] ) ) {
+			return false;
+		}
+	}
+
+	const aasbReachability_t *reach = (const aasbReachability_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_REACHABILITIES].ofs ) );
+	for ( i = 0; i < num[AASB_LUMP_REACHABILITIES]; i++, reach++ ) {
+		if ( (unsigned int) LittleInt( reach->toAreaNum ) >= (unsigned int) num[AASB_LUMP_AREAS] ) {
+			return false;
+		}
+		if ( !AASB_ValidRange( LittleInt( reach->firstKeyValue ), LittleInt( reach->numKeyValues ), num[AASB_LUMP_KEYVALUES] ) ) {
+			return false;
+		}
+		if ( !AASB_ValidSignedIndex( LittleInt( reach->edgeNum ), num[AASB_LUMP_EDGES] ) ) {
+			return false;
+		}
+	}
+
+	const aasbKeyValue_t *keyValue = (const aasbKeyValue_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_KEYVALUES].ofs ) );
+	for ( i = 0; i < num[AASB_LUMP_KEYVALUES]; i++, keyValue++ ) {
+		if ( !AASB_ValidString( LittleInt( keyValue->key ), strings ) || !AASB_ValidString( LittleInt( keyValue->value ), strings ) ) {
+			return false;
+		}
+	}
+
+	const aasbNode_t *node = (const aasbNode_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_NODES].ofs ) );
+	for ( i = 0; i < num[AASB_LUMP_NODES]; i++, node++ ) {
+		if ( (unsigned int) LittleInt( node->planeNum ) >= (unsigned int) num[AASB_LUMP_PLANES] ) {
+			return false;
+		}
+		for ( j = 0; j < 2; j++ ) {
+			int child = LittleInt( node->children[j] );
+			if ( child >= num[AASB_LUMP_NODES] || child <= -num[AASB_LUMP_AREAS] ) {
+				return false;
+			}
+		}
+	}
+
+	const aasbPortal_t *portal = (const aasbPortal_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_PORTALS].ofs ) );
+	for ( i = 0; i < num[AASB_LUMP_PORTALS]; i++, portal++ ) {
+		if ( (unsigned int) LittleInt( portal->areaNum ) >= (unsigned int) num[AASB_LUMP_AREAS] ) {
+			return false;
+		}
+		for ( j = 0; j < 2; j++ ) {
+			if ( (unsigned int) LittleInt( portal->clusters[j] ) >= (unsigned int) num[AASB_LUMP_CLUSTERS] ) {
+				return false;
+			}
+		}
+	}
+
+	index = (const aasIndex_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_PORTALINDEX].ofs ) );
+	for ( i = 0; i < num[AASB_LUMP_PORTALINDEX]; i++ ) {
+		if ( (unsigned int) LittleInt( index[i] ) >= (unsigned int) num[AASB_LUMP_PORTALS] ) {
+			return false;
+		}
+	}
+
+	const aasbCluster_t *cluster = (const aasbCluster_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_CLUSTERS].ofs ) );
+	for ( i = 0; i < num[AASB_LUMP_CLUSTERS]; i++, cluster++ ) {
+		if ( !AASB_ValidRange( LittleInt( cluster->firstPortal ), LittleInt( cluster->numPortals ), num[AASB_LUMP_PORTALINDEX] ) ) {
+			return false;
+		}
+		int numAreas = LittleInt( cluster->numAreas );
+		int numReachableAreas = LittleInt( cluster->numReachableAreas );
+		if ( numAreas < 0 || numAreas > num[AASB_LUMP_AREAS] || numReachableAreas < 0 || numReachableAreas > numAreas ) {
+			return false;
+		}
+	}
+
+	// the routing indexes the per cluster area arrays with these, cluster 0 is the unused solid cluster
+	cluster = (const aasbCluster_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_CLUSTERS].ofs ) );
+
+	portal = (const aasbPortal_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_PORTALS].ofs ) );
+	for ( i = 0; i < num[AASB_LUMP_PORTALS]; i++, portal++ ) {
+		for ( j = 0; j < 2; j++ ) {
+			int clusterNum = LittleInt( portal->clusters[j] );
+			if ( clusterNum > 0 && (unsigned int) LittleInt( portal->clusterAreaNum[j] ) >= (unsigned int) LittleInt( cluster[clusterNum].numAreas ) ) {
+				return false;
+			}
+		}
+	}
+
+	area = (const aasbArea_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_AREAS].ofs ) );
+	for ( i = 0; i < num[AASB_LUMP_AREAS]; i++, area++ ) {
+		int clusterNum = LittleInt( area->cluster );
+		if ( clusterNum < 0 ) {
+			// portal area, the cluster area numbers are stored with the portal
+			if ( clusterNum <= -num[AASB_LUMP_PORTALS] ) {
+				return false;
+			}
+		} else {
+			if ( clusterNum >= num[AASB_LUMP_CLUSTERS] ) {
+				return false;
+			}
+			if ( clusterNum > 0 && (unsigned int) LittleInt( area->clusterAreaNum ) >= (unsigned int) LittleInt( cluster[clusterNum].numAreas ) ) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/*
+================
+AASB_ReadFloats
+================
+*/
+static void AASB_ReadFloats( float *out, const float *in, int num ) {
+	for ( int i = 0; i < num; i++ ) {
+		out[i] = LittleFloat( in[i] );
+	}
+}
+
+/*
+================
+idAASFileLocal::LoadBinary
+================
+*/
+bool idAASFileLocal::LoadBinary( const idStr &fileName, unsigned int mapFileCRC ) {
+	int i, j, k, size;
+	idStr binaryFileName;
+	byte *buffer;
+	ID_TIME_T binaryTime, textTime;
+	idReachability *reach, **lastReach;
+
+	binaryFileName = AASB_FileName( fileName );
+	size = fileSystem->ReadFile( binaryFileName, (void **) &buffer, &binaryTime );
+	if ( !buffer ) {
+		return false;
+	}
+
+	// the binary file is out of date if the text file was changed after it was written
+	fileSystem->ReadFile( fileName, NULL, &textTime );
+	if ( textTime != FILE_NOT_FOUND_TIMESTAMP && textTime > binaryTime ) {
+		common->Printf( "%s is older than %s\n", binaryFileName.c_str(), fileName.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	const aasbHeader_t *header = (const aasbHeader_t *) buffer;
+	if ( size < (int) sizeof( aasbHeader_t ) || LittleInt( header->ident ) != AASB_FILEID ) {
+		common->Warning( "%s is not a binary AAS file.", binaryFileName.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	if ( LittleInt( header->version ) != AASB_FILEVERSION ) {
+		common->Warning( "%s has version %d instead of %d", binaryFileName.c_str(), LittleInt( header->version ), AASB_FILEVERSION );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	if ( mapFileCRC && (unsigned int) LittleInt( header->mapFileCRC ) != mapFileCRC ) {
+		common->Printf( "%s is out of date\n", binaryFileName.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	if ( !ValidateBinary( buffer, size ) ) {
+		common->Warning( "%s is corrupt", binaryFileName.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	// clear the file in memory
+	Clear();
+
+	const char *strings = (const char *) buffer + LittleInt( header->lumps[AASB_LUMP_STRINGS].ofs );
+
+	// settings
+	const aasbSettings_t &s = header->settings;
+	settings.numBoundingBoxes = LittleInt( s.numBoundingBoxes );
+	for ( i = 0; i < MAX_AAS_BOUNDING_BOXES; i++ ) {
+		AASB_ReadFloats( settings.boundingBoxes[i][0].ToFloatPtr(), s.boundingBoxes[i][0], 3 );
+		AASB_ReadFloats( settings.boundingBoxes[i][1].ToFloatPtr(), s.boundingBoxes[i][1], 3 );
+	}
+	settings.usePatches = LittleInt( s.usePatches ) != 0;
+	settings.writeBrushMap = LittleInt( s.writeBrushMap ) != 0;
+	settings.playerFlood = LittleInt( s.playerFlood ) != 0;
+	settings.noOptimize = LittleInt( s.noOptimize ) != 0;
+	settings.allowSwimReachabilities = LittleInt( s.allowSwimReachabilities ) != 0;
+	settings.allowFlyReachabilities = LittleInt( s.allowFlyReachabilities ) != 0;
+	settings.fileExtension = strings + LittleInt( s.fileExtension );
+	AASB_ReadFloats( settings.gravity.ToFloatPtr(), s.gravity, 3 );
+	settings.gravityDir = settings.gravity;
+	settings.gravityValue = settings.gravityDir.Normalize();
+	settings.invGravityDir = -settings.gravityDir;
+	settings.maxStepHeight = LittleFloat( s.maxStepHeight );
+	settings.maxBarrierHeight = LittleFloat( s.maxBarrierHeight );
+	settings.maxWaterJumpHeight = LittleFloat( s.maxWaterJumpHeight );
+	settings.maxFallHeight = LittleFloat( s.maxFallHeight );
+	settings.minFloorCos = LittleFloat( s.minFloorCos );
+	settings.tt_barrierJump = LittleInt( s.tt_barrierJump );
+	settings.tt_startCrouching = LittleInt( s.tt_startCrouching );
+	settings.tt_waterJump = LittleInt( s.tt_waterJump );
+	settings.tt_startWalkOffLedge = LittleInt( s.tt_startWalkOffLedge );
+
+	const aasbPlane_t *inPlane = (const aasbPlane_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_PLANES].ofs ) );
+	planeList.SetNum( LittleInt( header->lumps[AASB_LUMP_PLANES].num ), false );
+	for ( i = 0; i < planeList.Num(); i++ ) {
+		AASB_ReadFloats( planeList[i].ToFloatPtr(), inPlane[i].normal, 4 );
+	}
+
+	const aasbVertex_t *inVertex = (const aasbVertex_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_VERTICES].ofs ) );
+	vertices.SetNum( LittleInt( header->lumps[AASB_LUMP_VERTICES].num ), false );
+	for ( i = 0; i < vertices.Num(); i++ ) {
+		AASB_ReadFloats( vertices[i].ToFloatPtr(), inVertex[i].p, 3 );
+	}
+
+	const aasbEdge_t *inEdge = (const aasbEdge_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_EDGES].ofs ) );
+	edges.SetNum( LittleInt( header->lumps[AASB_LUMP_EDGES].num ), false );
+	for ( i = 0; i < edges.Num(); i++ ) {
+		edges[i].vertexNum[0] = LittleInt( inEdge[i].vertexNum[0] );
+		edges[i].vertexNum[1] = LittleInt( inEdge[i].vertexNum[1] );
+	}
+
+	const aasIndex_t *inIndex = (const aasIndex_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_EDGEINDEX].ofs ) );
+	edgeIndex.SetNum( LittleInt( header->lumps[AASB_LUMP_EDGEINDEX].num ), false );
+	for ( i = 0; i < edgeIndex.Num(); i++ ) {
+		edgeIndex[i] = LittleInt( inIndex[i] );
+	}
+
+	const aasbFace_t *inFace = (const aasbFace_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_FACES].ofs ) );
+	faces.SetNum( LittleInt( header->lumps[AASB_LUMP_FACES].num ), false );
+	for ( i = 0; i < faces.Num(); i++ ) {
+		faces[i].planeNum = LittleInt( inFace[i].planeNum );
+		faces[i].flags = LittleInt( inFace[i].flags );
+		faces[i].numEdges = LittleInt( inFace[i].numEdges );
+		faces[i].firstEdge = LittleInt( inFace[i].firstEdge );
+		faces[i].areas[0] = LittleInt( inFace[i].areas[0] );
+		faces[i].areas[1] = LittleInt( inFace[i].areas[1] );
+	}
+
+	inIndex = (const aasIndex_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_FACEINDEX].ofs ) );
+	faceIndex.SetNum( LittleInt( header->lumps[AASB_LUMP_FACEINDEX].num ), false );
+	for ( i = 0; i < faceIndex.Num(); i++ ) {
+		faceIndex[i] = LittleInt( inIndex[i] );
+	}
+
+	const aasbArea_t *inArea = (const aasbArea_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_AREAS].ofs ) );
+	const aasbReachability_t *inReach = (const aasbReachability_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_REACHABILITIES].ofs ) );
+	const aasbKeyValue_t *inKeyValue = (const aasbKeyValue_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_KEYVALUES].ofs ) );
+	areas.SetNum( LittleInt( header->lumps[AASB_LUMP_AREAS].num ), false );
+	for ( i = 0; i < areas.Num(); i++ ) {
+		aasArea_t &area = areas[i];
+		area.numFaces = LittleInt( inArea[i].numFaces );
+		area.firstFace = LittleInt( inArea[i].firstFace );
+		AASB_ReadFloats( area.bounds[0].ToFloatPtr(), inArea[i].bounds[0], 3 );
+		AASB_ReadFloats( area.bounds[1].ToFloatPtr(), inArea[i].bounds[1], 3 );
+		AASB_ReadFloats( area.center.ToFloatPtr(), inArea[i].center, 3 );
+		area.flags = LittleInt( inArea[i].flags );
+		area.contents = LittleInt( inArea[i].contents );
+		area.cluster = LittleInt( inArea[i].cluster );
+		area.clusterAreaNum = LittleInt( inArea[i].clusterAreaNum );
+		area.travelFlags = LittleInt( inArea[i].travelFlags );
+		area.reach = NULL;
+		area.rev_reach = NULL;
+
+		// keep the order of the reachability list
+		lastReach = &area.reach;
+		const aasbReachability_t *r = inReach + LittleInt( inArea[i].firstReachability );
+		for ( j = LittleInt( inArea[i].numReachabilities ); j > 0; j--, r++ ) {
+			int travelType = LittleInt( r->travelType );
+			if ( travelType == TFL_SPECIAL ) {
+				idReachability_Special *special = new idReachability_Special();
+				const aasbKeyValue_t *kv = inKeyValue + LittleInt( r->firstKeyValue );
+				for ( k = LittleInt( r->numKeyValues ); k > 0; k--, kv++ ) {
+					special->dict.Set( strings + LittleInt( kv->key ), strings + LittleInt( kv->value ) );
+				}
+				reach = special;
+			} else {
+				reach = new idReachability();
+			}
+			reach->travelType = travelType;
+			reach->toAreaNum = LittleInt( r->toAreaNum );
+			reach->fromAreaNum = i;
+			AASB_ReadFloats( reach->start.ToFloatPtr(), r->start, 3 );
+			AASB_ReadFloats( reach->end.ToFloatPtr(), r->end, 3 );
+			reach->edgeNum = LittleInt( r->edgeNum );
+			reach->travelTime = LittleInt( r->travelTime );
+			reach->next = NULL;
+			*lastReach = reach;
+			lastReach = &reach->next;
+		}
+	}
+
+	const aasbNode_t *inNode = (const aasbNode_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_NODES].ofs ) );
+	nodes.SetNum( LittleInt( header->lumps[AASB_LUMP_NODES].num ), false );
+	for ( i = 0; i < nodes.Num(); i++ ) {
+		nodes[i].planeNum = LittleInt( inNode[i].planeNum );
+		nodes[i].children[0] = LittleInt( inNode[i].children[0] );
+		nodes[i].children[1] = LittleInt( inNode[i].children[1] );
+	}
+
+	const aasbPortal_t *inPortal = (const aasbPortal_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_PORTALS].ofs ) );
+	portals.SetNum( LittleInt( header->lumps[AASB_LUMP_PORTALS].num ), false );
+	for ( i = 0; i < portals.Num(); i++ ) {
+		portals[i].areaNum = LittleInt( inPortal[i].areaNum );
+		portals[i].clusters[0] = LittleInt( inPortal[i].clusters[0] );
+		portals[i].clusters[1] = LittleInt( inPortal[i].clusters[1] );
+		portals[i].clusterAreaNum[0] = LittleInt( inPortal[i].clusterAreaNum[0] );
+		portals[i].clusterAreaNum[1] = LittleInt( inPortal[i].clusterAreaNum[1] );
+		portals[i].maxAreaTravelTime = 0;
+	}
+
+	inIndex = (const aasIndex_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_PORTALINDEX].ofs ) );
+	portalIndex.SetNum( LittleInt( header->lumps[AASB_LUMP_PORTALINDEX].num ), false );
+	for ( i = 0; i < portalIndex.Num(); i++ ) {
+		portalIndex[i] = LittleInt( inIndex[i] );
+	}
+
+	const aasbCluster_t *inCluster = (const aasbCluster_t *) ( buffer + LittleInt( header->lumps[AASB_LUMP_CLUSTERS].ofs ) );
+	clusters.SetNum( LittleInt( header->lumps[AASB_LUMP_CLUSTERS].num ), false );
+	for ( i = 0; i < clusters.Num(); i++ ) {
+		clusters[i].numAreas = LittleInt( inCluster[i].numAreas );
+		clusters[i].numReachableAreas = LittleInt( inCluster[i].numReachableAreas );
+		clusters[i].numPortals = LittleInt( inCluster[i].numPortals );
+		clusters[i].firstPortal = LittleInt( inCluster[i].firstPortal );
+	}
+
+	fileSystem->FreeFile( buffer );
+
+	LinkReversedReachability();
+
+	return true;
+}
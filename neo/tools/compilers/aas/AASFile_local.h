@@ -29,6 +29,7 @@ If you have questions concerning this license or the applicable additional terms
 #ifndef __AASFILELOCAL_H__
 #define __AASFILELOCAL_H__
 
+#include "framework/CVarSystem.h"
 #include "tools/compilers/aas/AASFile.h"
 
 /*
@@ -89,6 +90,10 @@ private:
 	bool						ParsePortals( idLexer &src );
 	bool						ParseClusters( idLexer &src );
 
+	bool						LoadBinary( const idStr &fileName, unsigned int mapFileCRC );
+	bool						ValidateBinary( const byte *buffer, int size ) const;
+	void						WriteBinary( const idStr &fileName, unsigned int mapFileCRC ) const;
+
 private:
 	int							BoundsReachableAreaNum_r( int nodeNum, const idBounds &bounds, const int areaFlags, const int excludeTravelFlags ) const;
 	void						MaxTreeDepth_r( int nodeNum, int &depth, int &maxDepth ) const;
@@ -98,4 +103,7 @@ private:
 	int							NumReachabilities( void ) const;
 };
 
+extern idCVar aas_binaryCache;
+extern idCVar aas_buildJobs;
+
 #endif /* !__AASFILELOCAL_H__ */
@@ -27,6 +27,7 @@ If you have questions concerning this license or the applicable additional terms
 */
 
 #include "sys/platform.h"
+#include "sys/sys_jobs.h"
 
 #include "tools/compilers/aas/AASReach.h"
 
@@ -37,6 +38,8 @@ If you have questions concerning this license or the applicable additional terms
 #define INSIDEUNITS_FLYEND					0.5f
 #define INSIDEUNITS_WATERJUMP				15.0f
 
+#define REACH_AREAS_PER_JOB					64
+
 /*
 ================
 idAASReach::ReachabilityExists
@@ -93,7 +96,6 @@ void idAASReach::AddReachabilityToArea( idReachability *reach, int areaNum ) {
 	area = &file->areas[areaNum];
 	reach->next = area->reach;
 	area->reach = reach;
-	numReachabilities++;
 }
 
 /*
@@ -869,42 +871,21 @@ void idAASReach::FlagReachableAreas( idAASFileLocal *file ) {
 
 /*
 ================
-idAASReach::Build
+idAASReach::Reachability_Area
 ================
 */
-bool idAASReach::Build( const idMapFile *mapFile, idAASFileLocal *file ) {
-	int i, j, lastPercent, percent;
-
-	this->mapFile = mapFile;
-	this->file = file;
-	numReachabilities = 0;
-
-	common->Printf( "[Reachability]\n" );
-
-	// delete all existing reachabilities
-	file->DeleteReachabilities();
-
-	FlagReachableAreas( file );
+void idAASReach::Reachability_Area( int areaNum ) {
+	int j;
 
-	for ( i = 1; i < file->areas.Num(); i++ ) {
-		if ( !( file->areas[i].flags & AREA_REACHABLE_WALK ) ) {
-			continue;
-		}
+	// only the reachabilities of this area are created and tested so areas can be done in parallel
+	if ( file->areas[areaNum].flags & AREA_REACHABLE_WALK ) {
 		if ( file->GetSettings().allowSwimReachabilities ) {
-			Reachability_Swim( i );
-		}
-		Reachability_EqualFloorHeight( i );
-	}
-
-	lastPercent = -1;
-	for ( i = 1; i < file->areas.Num(); i++ ) {
-
-		if ( !( file->areas[i].flags & AREA_REACHABLE_WALK ) ) {
-			continue;
+			Reachability_Swim( areaNum );
 		}
+		Reachability_EqualFloorHeight( areaNum );
 
 		for ( j = 0; j < file->areas.Num(); j++ ) {
-			if ( i == j ) {
+			if ( areaNum == j ) {
 				continue;
 			}
 
@@ -912,32 +893,75 @@ bool idAASReach::Build( const idMapFile *mapFile, idAASFileLocal *file ) {
 				continue;
 			}
 
-			if ( ReachabilityExists( i, j ) ) {
+			if ( ReachabilityExists( areaNum, j ) ) {
 				continue;
 			}
-			if ( Reachability_Step_Barrier_WaterJump_WalkOffLedge( i, j ) ) {
+			if ( Reachability_Step_Barrier_WaterJump_WalkOffLedge( areaNum, j ) ) {
 				continue;
 			}
 		}
 
-		//Reachability_WalkOffLedge( i );
-
-		percent = 100 * i / file->areas.Num();
-		if ( percent > lastPercent ) {
-			common->Printf( "\r%6d%%", percent );
-			lastPercent = percent;
-		}
+		//Reachability_WalkOffLedge( areaNum );
 	}
 
 	if ( file->GetSettings().allowFlyReachabilities ) {
+		Reachability_Fly( areaNum );
+	}
+}
+
+/*
+================
+idAASReach::ReachabilityJob
+================
+*/
+void idAASReach::ReachabilityJob( aasReachJob_t *job ) {
+	for ( int i = 0; i < job->numAreas; i++ ) {
+		job->reach->Reachability_Area( job->firstArea + i );
+	}
+}
+
+/*
+================
+idAASReach::Build
+================
+*/
+bool idAASReach::Build( const idMapFile *mapFile, idAASFileLocal *file ) {
+	int i;
+
+	this->mapFile = mapFile;
+	this->file = file;
+
+	common->Printf( "[Reachability]\n" );
+
+	// delete all existing reachabilities
+	file->DeleteReachabilities();
+
+	FlagReachableAreas( file );
+
+	if ( aas_buildJobs.GetBool() ) {
+		idList<aasReachJob_t> jobs;
+		idParallelJobList *jobList = parallelJobManager->AllocJobList( "AAS reachability" );
+
+		// the job data must not move once the jobs are added
+		jobs.SetNum( ( file->areas.Num() - 1 + REACH_AREAS_PER_JOB - 1 ) / REACH_AREAS_PER_JOB );
+		for ( i = 0; i < jobs.Num(); i++ ) {
+			jobs[i].reach = this;
+			jobs[i].firstArea = 1 + i * REACH_AREAS_PER_JOB;
+			jobs[i].numAreas = Min( REACH_AREAS_PER_JOB, file->areas.Num() - jobs[i].firstArea );
+			jobList->AddJob( (jobRun_t)ReachabilityJob, &jobs[i] );
+		}
+		jobList->Submit();
+		jobList->Wait();
+		parallelJobManager->FreeJobList( jobList );
+	} else {
 		for ( i = 1; i < file->areas.Num(); i++ ) {
-			Reachability_Fly( i );
+			Reachability_Area( i );
 		}
 	}
 
 	file->LinkReversedReachability();
 
-	common->Printf( "\r%6d reachabilities\n", numReachabilities );
+	common->Printf( "%6d reachabilities\n", file->NumReachabilities() );
 
 	return true;
 }
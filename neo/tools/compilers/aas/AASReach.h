@@ -40,6 +40,15 @@ If you have questions concerning this license or the applicable additional terms
 ===============================================================================
 */
 
+class idAASReach;
+
+// a range of areas to calculate the reachabilities for on a job thread
+typedef struct aasReachJob_s {
+	idAASReach *			reach;
+	int						firstArea;
+	int						numAreas;
+} aasReachJob_t;
+
 class idAASReach {
 
 public:
@@ -48,7 +57,6 @@ public:
 private:
 	const idMapFile *		mapFile;
 	idAASFileLocal *		file;
-	int						numReachabilities;
 	bool					allowSwimReachabilities;
 	bool					allowFlyReachabilities;
 
@@ -64,6 +72,8 @@ private:	// reachability
 	void					Reachability_EqualFloorHeight( int areaNum );
 	bool					Reachability_Step_Barrier_WaterJump_WalkOffLedge( int fromAreaNum, int toAreaNum );
 	void					Reachability_WalkOffLedge( int areaNum );
+	void					Reachability_Area( int areaNum );
+	static void				ReachabilityJob( aasReachJob_t *job );
 
 };
 
@@ -30,6 +30,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "idlib/MapFile.h"
 #include "framework/Common.h"
 #include "framework/FileSystem.h"
+#include "sys/sys_public.h"
 
 #include "tools/compilers/aas/Brush.h"
 
@@ -44,6 +45,8 @@ If you have questions concerning this license or the applicable additional terms
 /*
 ============
 DisplayRealTimeString
+
+  Progress output is only shown for builds on the main thread.
 ============
 */
 void DisplayRealTimeString( const char *string, ... ) {
@@ -52,6 +55,10 @@ void DisplayRealTimeString( const char *string, ... ) {
 	static int lastUpdateTime;
 	int time;
 
+	if ( !Sys_IsMainThread() ) {
+		return;
+	}
+
 	time = Sys_Milliseconds();
 	if ( time > lastUpdateTime + OUTPUT_UPDATE_TIME ) {
 		va_start( argPtr, string );
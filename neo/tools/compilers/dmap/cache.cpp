@@ -0,0 +1,584 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "sys/platform.h"
+#include "idlib/hashing/CRC32.h"
+#include "idlib/hashing/MD5.h"
+#include "framework/FileSystem.h"
+
+#include "tools/compilers/dmap/dmap.h"
+
+/*
+
+  The results of the expensive per area and per light steps of an earlier
+  dmap -incremental run, keyed by checksums of everything that goes into them.
+
+  An area is keyed by the planes, materials and triangles of its optimize groups,
+  just before they are optimized, so an area only misses the cache if a brush,
+  patch, model or light that touches it changed. A shadow volume is keyed by
+  the light and the shadow casting triangles clipped to the light.
+
+  Only the entries used by the last run are written back, so the file doesn't
+  grow with every edit.
+
+*/
+
+#define DMAPCACHE_FILE_EXT		"dmc"
+#define DMAPCACHE_FILEID		( ( 'C' << 24 ) | ( 'P' << 16 ) | ( 'M' << 8 ) | 'D' )	// little endian "DMPC"
+#define DMAPCACHE_FILEVERSION	2
+
+// 32 bit values of one cached idDrawVert
+#define DMAPCACHE_DRAWVERT_SIZE	( 14 * 4 + 4 )
+
+typedef struct {
+	int				type;
+	dmapCacheKey_t	key;
+	int				length;				// length of the data in bytes
+	const char *	data;				// in the loaded file or allocated
+	bool			allocated;
+	bool			keep;				// write to the new cache file
+} dmapCacheEntry_t;
+
+static char *					cacheFileBuffer;
+static idList<dmapCacheEntry_t>	cacheEntries;
+static idHashIndex				cacheHash;
+
+/*
+================
+CacheFileName
+================
+*/
+static idStr CacheFileName( void ) {
+	idStr fileName = dmapGlobals.mapFileBase;
+	fileName.SetFileExtension( DMAPCACHE_FILE_EXT );
+	return fileName;
+}
+
+/*
+================
+WriteDrawVert
+================
+*/
+static void WriteDrawVert( idFile *f, const idDrawVert &v ) {
+	f->WriteVec3( v.xyz );
+	f->WriteVec2( v.st );
+	f->WriteVec3( v.normal );
+	f->WriteVec3( v.tangents[0] );
+	f->WriteVec3( v.tangents[1] );
+	f->Write( v.color, 4 );
+}
+
+/*
+================
+ReadDrawVert
+================
+*/
+static void ReadDrawVert( idFile *f, idDrawVert &v ) {
+	f->ReadVec3( v.xyz );
+	f->ReadVec2( v.st );
+	f->ReadVec3( v.normal );
+	f->ReadVec3( v.tangents[0] );
+	f->ReadVec3( v.tangents[1] );
+	f->Read( v.color, 4 );
+}
+
+/*
+================
+WriteGroupList
+
+Everything of the groups and the options that changes the optimized triangles
+================
+*/
+static void WriteGroupList( idFile *f, const optimizeGroup_t *groups ) {
+	const optimizeGroup_t	*group;
+	const mapTri_t			*tri;
+	int						i;
+
+	// the optimizer fixes the t junctions of the groups unless disabled
+	f->WriteBool( dmapGlobals.noTJunc );
+
+	for ( group = groups ; group ; group = group->nextGroup ) {
+		f->WriteVec4( dmapGlobals.mapPlanes[group->planeNum].ToVec4() );
+		f->WriteString( group->material->GetName() );
+		f->WriteBool( group->material->IsDiscrete() );
+		f->WriteInt( CountTriList( group->triList ) );
+		for ( tri = group->triList ; tri ; tri = tri->next ) {
+			for ( i = 0 ; i < 3 ; i++ ) {
+				WriteDrawVert( f, tri->v[i] );
+			}
+		}
+	}
+}
+
+/*
+================
+CacheKeyForFile
+================
+*/
+static void CacheKeyForFile( idFile_Memory &f, dmapCacheKey_t &key ) {
+	key.length = f.Length();
+	key.crc = CRC32_BlockChecksum( f.GetDataPtr(), key.length );
+	key.md5 = MD5_BlockChecksum( f.GetDataPtr(), key.length );
+}
+
+/*
+================
+NewCacheFile
+
+A memory file that grows in large steps, so writing many triangles doesn't
+keep reallocating it
+================
+*/
+static void NewCacheFile( idFile_Memory &f, const optimizeGroup_t *groups ) {
+	int numTris = 0;
+
+	for ( const optimizeGroup_t *group = groups ; group ; group = group->nextGroup ) {
+		numTris += CountTriList( group->triList );
+	}
+	f.SetGranularity( Max( 16384, numTris * 3 * DMAPCACHE_DRAWVERT_SIZE + 16384 ) );
+}
+
+/*
+================
+FindCacheEntry
+
+Returns the entry number or -1, doesn't change anything so it can be called from the job threads
+================
+*/
+static int FindCacheEntry( int type, const dmapCacheKey_t &key ) {
+	int		i;
+
+	for ( i = cacheHash.First( key.crc ) ; i != -1 ; i = cacheHash.Next( i ) ) {
+		const dmapCacheEntry_t &entry = cacheEntries[i];
+		if ( entry.type == type && entry.key.crc == key.crc && entry.key.md5 == key.md5 && entry.key.length == key.length ) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/*
+================
+AddCacheEntry
+================
+*/
+static void AddCacheEntry( int type, const dmapCacheKey_t &key, idFile_Memory &f ) {
+	dmapCacheEntry_t	entry;
+	char				*data;
+
+	if ( FindCacheEntry( type, key ) != -1 ) {
+		return;
+	}
+
+	data = (char *)Mem_Alloc( f.Length() );
+	memcpy( data, f.GetDataPtr(), f.Length() );
+
+	entry.type = type;
+	entry.key = key;
+	entry.length = f.Length();
+	entry.data = data;
+	entry.allocated = true;
+	entry.keep = true;
+	cacheHash.Add( key.crc, cacheEntries.Append( entry ) );
+}
+
+/*
+================
+LoadDmapCache
+================
+*/
+void LoadDmapCache( void ) {
+	idStr	fileName;
+	int		length, numEntries, i, ofs;
+	const int *header;
+
+	FreeDmapCache();
+
+	fileName = CacheFileName();
+	length = fileSystem->ReadFile( fileName, (void **)&cacheFileBuffer );
+	if ( length < 0 ) {
+		common->Printf( "no %s, building everything\n", fileName.c_str() );
+		return;
+	}
+
+	header = (const int *)cacheFileBuffer;
+	if ( length < 3 * (int)sizeof( int ) || LittleInt( header[0] ) != DMAPCACHE_FILEID || LittleInt( header[1] ) != DMAPCACHE_FILEVERSION ) {
+		common->Printf( "%s is not a dmap cache of this version, building everything\n", fileName.c_str() );
+		FreeDmapCache();
+		return;
+	}
+
+	numEntries = LittleInt( header[2] );
+	ofs = 3 * sizeof( int );
+
+	for ( i = 0 ; i < numEntries ; i++ ) {
+		dmapCacheEntry_t	entry;
+		const int			*e = (const int *)( cacheFileBuffer + ofs );
+
+		if ( ofs + 5 * (int)sizeof( int ) > length ) {
+			break;
+		}
+		entry.type = LittleInt( e[0] );
+		entry.key.crc = LittleInt( e[1] );
+		entry.key.md5 = LittleInt( e[2] );
+		entry.key.length = LittleInt( e[3] );
+		entry.length = LittleInt( e[4] );
+		ofs += 5 * sizeof( int );
+
+		if ( entry.length < 0 || entry.length > length - ofs ) {
+			break;
+		}
+		entry.data = cacheFileBuffer + ofs;
+		entry.allocated = false;
+		entry.keep = false;
+		ofs += entry.length;
+
+		cacheHash.Add( entry.key.crc, cacheEntries.Append( entry ) );
+	}
+
+	if ( i < numEntries ) {
+		common->Warning( "%s is corrupt, building everything", fileName.c_str() );
+		FreeDmapCache();
+		return;
+	}
+
+	common->Printf( "%i entries in %s\n", cacheEntries.Num(), fileName.c_str() );
+}
+
+/*
+================
+WriteDmapCache
+================
+*/
+void WriteDmapCache( void ) {
+	idStr	fileName;
+	idFile	*f;
+	int		i, numEntries;
+
+	fileName = CacheFileName();
+	f = fileSystem->OpenFileWrite( fileName, "fs_devpath" );
+	if ( !f ) {
+		common->Warning( "couldn't write %s", fileName.c_str() );
+		return;
+	}
+
+	numEntries = 0;
+	for ( i = 0 ; i < cacheEntries.Num() ; i++ ) {
+		if ( cacheEntries[i].keep ) {
+			numEntries++;
+		}
+	}
+
+	f->WriteInt( DMAPCACHE_FILEID );
+	f->WriteInt( DMAPCACHE_FILEVERSION );
+	f->WriteInt( numEntries );
+
+	for ( i = 0 ; i < cacheEntries.Num() ; i++ ) {
+		const dmapCacheEntry_t &entry = cacheEntries[i];
+		if ( !entry.keep ) {
+			continue;
+		}
+		f->WriteInt( entry.type );
+		f->WriteUnsignedInt( entry.key.crc );
+		f->WriteUnsignedInt( entry.key.md5 );
+		f->WriteInt( entry.key.length );
+		f->WriteInt( entry.length );
+		f->Write( entry.data, entry.length );
+	}
+
+	fileSystem->CloseFile( f );
+
+	common->Printf( "wrote %i entries to %s\n", numEntries, fileName.c_str() );
+}
+
+/*
+================
+FreeDmapCache
+================
+*/
+void FreeDmapCache( void ) {
+	int		i;
+
+	for ( i = 0 ; i < cacheEntries.Num() ; i++ ) {
+		if ( cacheEntries[i].allocated ) {
+			Mem_Free( (void *)cacheEntries[i].data );
+		}
+	}
+	cacheEntries.Clear();
+	cacheHash.Free();
+
+	if ( cacheFileBuffer ) {
+		fileSystem->FreeFile( cacheFileBuffer );
+		cacheFileBuffer = NULL;
+	}
+}
+
+/*
+================
+KeepCacheEntry
+================
+*/
+void KeepCacheEntry( int entryNum ) {
+	cacheEntries[entryNum].keep = true;
+}
+
+/*
+================
+AreaCacheKey
+================
+*/
+void AreaCacheKey( const optimizeGroup_t *groups, dmapCacheKey_t &key ) {
+	idFile_Memory	f;
+
+	NewCacheFile( f, groups );
+	WriteGroupList( &f, groups );
+	CacheKeyForFile( f, key );
+}
+
+/*
+================
+FindCachedArea
+
+Replaces the triangles of the groups with the cached optimized triangles
+and returns the cache entry, or returns -1 if the area isn't cached.
+Can be called from the job threads.
+================
+*/
+int FindCachedArea( const dmapCacheKey_t &key, optimizeGroup_t *groups ) {
+	int					entryNum, i, numTris, numGroups;
+	optimizeGroup_t		*group;
+	mapTri_t			*tri, **tail;
+	idList<mapTri_t *>	triLists;
+
+	entryNum = FindCacheEntry( DMAP_CACHE_AREA, key );
+	if ( entryNum == -1 ) {
+		return -1;
+	}
+
+	const dmapCacheEntry_t &entry = cacheEntries[entryNum];
+	idFile_Memory f( "dmapCache", entry.data, entry.length );
+
+	numGroups = 0;
+	for ( group = groups ; group ; group = group->nextGroup ) {
+		numGroups++;
+	}
+
+	// build all the lists before changing any group, the data may not fit
+	bool ok = true;
+	triLists.SetNum( numGroups );
+	for ( group = groups, numGroups = 0 ; group ; group = group->nextGroup, numGroups++ ) {
+		triLists[numGroups] = NULL;
+		if ( !ok ) {
+			continue;
+		}
+		f.ReadInt( numTris );
+		if ( numTris < 0 || numTris > ( f.Length() - f.Tell() ) / ( 3 * DMAPCACHE_DRAWVERT_SIZE ) ) {
+			ok = false;
+			continue;
+		}
+		tail = &triLists[numGroups];
+		for ( ; numTris > 0 ; numTris-- ) {
+			tri = AllocTri();
+			tri->material = group->material;
+			tri->mergeGroup = group->mergeGroup;
+			tri->planeNum = group->planeNum;
+			for ( i = 0 ; i < 3 ; i++ ) {
+				ReadDrawVert( &f, tri->v[i] );
+			}
+			*tail = tri;
+			tail = &tri->next;
+		}
+	}
+
+	if ( !ok || f.Tell() != f.Length() ) {
+		for ( i = 0 ; i < triLists.Num() ; i++ ) {
+			FreeTriList( triLists[i] );
+		}
+		return -1;
+	}
+
+	for ( group = groups, i = 0 ; group ; group = group->nextGroup, i++ ) {
+		FreeTriList( group->triList );
+		group->triList = triLists[i];
+	}
+
+	return entryNum;
+}
+
+/*
+================
+CacheArea
+
+Stores the optimized triangles of an area
+================
+*/
+void CacheArea( const dmapCacheKey_t &key, const optimizeGroup_t *groups ) {
+	idFile_Memory			f;
+	const optimizeGroup_t	*group;
+	const mapTri_t			*tri;
+	int						i;
+
+	NewCacheFile( f, groups );
+	for ( group = groups ; group ; group = group->nextGroup ) {
+		f.WriteInt( CountTriList( group->triList ) );
+		for ( tri = group->triList ; tri ; tri = tri->next ) {
+			for ( i = 0 ; i < 3 ; i++ ) {
+				WriteDrawVert( &f, tri->v[i] );
+			}
+		}
+	}
+	AddCacheEntry( DMAP_CACHE_AREA, key, f );
+}
+
+/*
+================
+ShadowCacheKey
+================
+*/
+void ShadowCacheKey( const optimizeGroup_t *shadowerGroups, const mapLight_t *light, bool hasPerforatedSurface, dmapCacheKey_t &key ) {
+	idFile_Memory				f;
+	const idRenderLightLocal	&def = light->def;
+	int							i, j;
+
+	NewCacheFile( f, shadowerGroups );
+
+	f.WriteInt( dmapGlobals.shadowOptLevel );
+	f.WriteBool( hasPerforatedSurface );
+
+	// everything of the light the shadow volume creation uses
+	f.WriteVec3( def.globalLightOrigin );
+	for ( i = 0 ; i < 6 ; i++ ) {
+		f.WriteVec4( def.frustum[i].ToVec4() );
+	}
+	f.WriteInt( def.numShadowFrustums );
+	for ( i = 0 ; i < def.numShadowFrustums ; i++ ) {
+		f.WriteInt( def.shadowFrustums[i].numPlanes );
+		for ( j = 0 ; j < def.shadowFrustums[i].numPlanes ; j++ ) {
+			f.WriteVec4( def.shadowFrustums[i].planes[j].ToVec4() );
+		}
+		f.WriteBool( def.shadowFrustums[i].makeClippedPlanes );
+	}
+	f.WriteMat3( def.parms.axis );
+	f.WriteVec3( def.parms.origin );
+	f.WriteVec3( def.parms.lightCenter );
+	f.WriteVec3( def.parms.lightRadius );
+	f.WriteBool( def.parms.pointLight );
+	f.WriteBool( def.parms.parallel );
+
+	WriteGroupList( &f, shadowerGroups );
+	CacheKeyForFile( f, key );
+}
+
+/*
+================
+FindCachedShadow
+
+Returns true and the cached shadow volume, which can be NULL, if the light is cached
+================
+*/
+bool FindCachedShadow( const dmapCacheKey_t &key, srfTriangles_t **shadowTris ) {
+	int				entryNum, i, hasTris, numVerts, numIndexes;
+	srfTriangles_t	*tri;
+
+	entryNum = FindCacheEntry( DMAP_CACHE_SHADOW, key );
+	if ( entryNum == -1 ) {
+		return false;
+	}
+
+	const dmapCacheEntry_t &entry = cacheEntries[entryNum];
+	idFile_Memory f( "dmapCache", entry.data, entry.length );
+
+	f.ReadInt( hasTris );
+	if ( !hasTris ) {
+		KeepCacheEntry( entryNum );
+		*shadowTris = NULL;
+		return true;
+	}
+
+	f.ReadInt( numVerts );
+	f.ReadInt( numIndexes );
+	if ( numVerts < 0 || numIndexes < 0 || numVerts > f.Length() / 16 || numIndexes > f.Length() / 4
+		|| ( 3 + numVerts * 4 + numIndexes ) * 4 != f.Length() - f.Tell() ) {
+		return false;
+	}
+
+	tri = R_AllocStaticTriSurf();
+	R_AllocStaticTriSurfShadowVerts( tri, numVerts );
+	R_AllocStaticTriSurfIndexes( tri, numIndexes );
+	tri->numVerts = numVerts;
+	tri->numIndexes = numIndexes;
+	f.ReadInt( tri->numShadowIndexesNoCaps );
+	f.ReadInt( tri->numShadowIndexesNoFrontCaps );
+	f.ReadInt( tri->shadowCapPlaneBits );
+	for ( i = 0 ; i < numVerts ; i++ ) {
+		f.ReadVec4( tri->shadowVertexes[i].xyz );
+	}
+	for ( i = 0 ; i < numIndexes ; i++ ) {
+		int index;
+		f.ReadInt( index );
+		tri->indexes[i] = index;
+	}
+
+	dmapGlobals.totalShadowTriangles += tri->numIndexes / 3;
+	dmapGlobals.totalShadowVerts += tri->numVerts / 3;
+
+	KeepCacheEntry( entryNum );
+	*shadowTris = tri;
+	return true;
+}
+
+/*
+================
+CacheShadow
+================
+*/
+void CacheShadow( const dmapCacheKey_t &key, const srfTriangles_t *shadowTris ) {
+	idFile_Memory	f;
+	int				i;
+
+	if ( !shadowTris ) {
+		f.WriteInt( 0 );
+		AddCacheEntry( DMAP_CACHE_SHADOW, key, f );
+		return;
+	}
+
+	f.SetGranularity( 16384 + ( shadowTris->numVerts * 4 + shadowTris->numIndexes ) * 4 );
+	f.WriteInt( 1 );
+	f.WriteInt( shadowTris->numVerts );
+	f.WriteInt( shadowTris->numIndexes );
+	f.WriteInt( shadowTris->numShadowIndexesNoCaps );
+	f.WriteInt( shadowTris->numShadowIndexesNoFrontCaps );
+	f.WriteInt( shadowTris->shadowCapPlaneBits );
+	for ( i = 0 ; i < shadowTris->numVerts ; i++ ) {
+		f.WriteVec4( shadowTris->shadowVertexes[i].xyz );
+	}
+	for ( i = 0 ; i < shadowTris->numIndexes ; i++ ) {
+		f.WriteInt( shadowTris->indexes[i] );
+	}
+	AddCacheEntry( DMAP_CACHE_SHADOW, key, f );
+}
@@ -27,12 +27,113 @@ If you have questions concerning this license or the applicable additional terms
 */
 
 #include "sys/platform.h"
+#include "sys/sys_jobs.h"
+
 #include "tools/compilers/dmap/dmap.h"
 
 #include "tools/compilers/compiler_public.h"
 
 dmapGlobals_t	dmapGlobals;
 
+#ifdef _MSC_VER
+#define DMAP_THREAD_LOCAL	__declspec( thread )
+#else
+#define DMAP_THREAD_LOCAL	__thread
+#endif
+
+typedef struct {
+	uEntity_t *		entity;
+	int				areaNum;
+	areaJob_t		func;
+	void *			data;
+	idStr			error;			// set if the job failed
+} areaJobParms_t;
+
+// true while the thread runs an area job
+static DMAP_THREAD_LOCAL bool inAreaJob;
+
+/*
+============
+AreaError
+
+common->Error isn't thread safe and nothing catches its
+exception on a job thread, so inside an area job the
+error is only thrown to AreaJob, which hands it over
+to RunAreaJobs.
+============
+*/
+void AreaError( const char *fmt, ... ) {
+	va_list		argptr;
+	char		text[MAX_STRING_CHARS];
+
+	va_start( argptr, fmt );
+	idStr::vsnPrintf( text, sizeof( text ), fmt, argptr );
+	va_end( argptr );
+
+	if ( !inAreaJob ) {
+		common->Error( "%s", text );
+	}
+	throw idException( text );
+}
+
+/*
+============
+AreaJob
+============
+*/
+static void AreaJob( areaJobParms_t *parms ) {
+	inAreaJob = true;
+	try {
+		parms->func( parms->entity, parms->areaNum, parms->data );
+	} catch ( idException &ex ) {
+		parms->error = ex.error;
+	}
+	inAreaJob = false;
+}
+
+/*
+============
+RunAreaJobs
+
+Runs func for every area of the entity on the job threads.
+The areas don't share any triangles, so the result doesn't
+depend on the order the jobs run in.
+============
+*/
+void RunAreaJobs( uEntity_t *e, areaJob_t func, void *data, const char *name ) {
+	int		i;
+
+	// the debug drawing isn't thread safe
+	if ( dmapGlobals.noJobs || dmapGlobals.drawflag || e->numAreas < 2 ) {
+		for ( i = 0 ; i < e->numAreas ; i++ ) {
+			func( e, i, data );
+		}
+		return;
+	}
+
+	idList<areaJobParms_t>	parms;
+	idParallelJobList *jobList = parallelJobManager->AllocJobList( name );
+
+	parms.SetNum( e->numAreas );
+	for ( i = 0 ; i < e->numAreas ; i++ ) {
+		parms[i].entity = e;
+		parms[i].areaNum = i;
+		parms[i].func = func;
+		parms[i].data = data;
+		jobList->AddJob( (jobRun_t)AreaJob, &parms[i] );
+	}
+	jobList->Submit();
+	jobList->Wait();
+	parallelJobManager->FreeJobList( jobList );
+
+	// raise the error of the first area that failed
+	for ( i = 0 ; i < e->numAreas ; i++ ) {
+		if ( parms[i].error.Length() ) {
+			common->Error( "%s", parms[i].error.c_str() );
+		}
+	}
+}
+
 /*
 ============
 ProcessModel
@@ -153,6 +254,8 @@ void DmapHelp( void ) {
 	"noCurves          = don't process curves\n"
 	"noCM              = don't create collision map\n"
 	"noAAS             = don't create AAS files\n"
+	"noJobs            = don't optimize the areas on the job threads\n"
+	"incremental       = reuse the areas and shadows that didn't change since the last incremental dmap\n"
 
 	);
 }
@@ -183,6 +286,8 @@ void ResetDmapGlobals( void ) {
 	dmapGlobals.noClipSides = false;
 	dmapGlobals.noLightCarve = false;
 	dmapGlobals.noShadow = false;
+	dmapGlobals.noJobs = false;
+	dmapGlobals.incremental = false;
 	dmapGlobals.shadowOptLevel = SO_NONE;
 	dmapGlobals.drawBounds.Clear();
 	dmapGlobals.drawflag = false;
@@ -277,6 +382,12 @@ void Dmap( const idCmdArgs &args ) {
 			dmapGlobals.noTJunc = true;
 			dmapGlobals.noOptimize = true;
 			common->Printf ("forcing noOptimize = true\n" );
+		} else if ( !idStr::Icmp( s, "noJobs" ) ) {
+			common->Printf( "noJobs = true\n" );
+			dmapGlobals.noJobs = true;
+		} else if ( !idStr::Icmp( s, "incremental" ) ) {
+			common->Printf( "incremental = true\n" );
+			dmapGlobals.incremental = true;
 		} else if ( !idStr::Icmp( s, "noCM" ) ) {
 			noCM = true;
 			common->Printf( "noCM = true\n" );
@@ -313,6 +424,11 @@ void Dmap( const idCmdArgs &args ) {
 		fileSystem->RemoveFile( path );
 	} else {
 		region = true;
+		// the cache is for the whole map
+		if ( dmapGlobals.incremental ) {
+			common->Printf( "region map, forcing incremental = false\n" );
+			dmapGlobals.incremental = false;
+		}
 	}
 
 
@@ -332,13 +448,27 @@ void Dmap( const idCmdArgs &args ) {
 		return;
 	}
 
+	// scratch space for the main thread and the job threads that are running
+	AllocOptimizeScratch();
+	AllocTJunctionHashes();
+
+	if ( dmapGlobals.incremental ) {
+		LoadDmapCache();
+	}
+
 	if ( ProcessModels() ) {
 		WriteOutputFile();
+		if ( dmapGlobals.incremental ) {
+			WriteDmapCache();
+		}
 	} else {
 		leaked = true;
 	}
 
 	FreeDMapFile();
+	FreeOptimizeScratch();
+	FreeTJunctionHashes();
+	FreeDmapCache();
 
 	common->Printf( "%i total shadow triangles\n", dmapGlobals.totalShadowTriangles );
 	common->Printf( "%i total shadow verts\n", dmapGlobals.totalShadowVerts );
@@ -262,6 +262,8 @@ typedef struct {
 	bool	noLightCarve;		// extra triangle subdivision by light frustums
 	shadowOptLevel_t	shadowOptLevel;
 	bool	noShadow;			// don't create optimized shadow volumes
+	bool	noJobs;				// don't process the areas of an entity on the job threads
+	bool	incremental;		// reuse the unchanged areas and shadows of the last run
 
 	idBounds	drawBounds;
 	bool	drawflag;
@@ -274,6 +276,16 @@ extern dmapGlobals_t dmapGlobals;
 
 int FindFloatPlane( const idPlane &plane, bool *fixedDegeneracies = NULL );
 
+// called for every area of an entity, may run on a job thread so it
+// must only change the given area
+typedef void (*areaJob_t)( uEntity_t *e, int areaNum, void *data );
+
+void RunAreaJobs( uEntity_t *e, areaJob_t func, void *data, const char *name );
+
+// common->Error for the code run by RunAreaJobs, the error of an area
+// job is raised on the main thread once all jobs are done
+void AreaError( const char *fmt, ... ) id_attribute((format(printf,1,2)));
+
 
 //=============================================================================
 
@@ -398,6 +410,8 @@ void	Prelight( uEntity_t *e );
 struct hashVert_s	*GetHashVert( idVec3 &v );
 void	HashTriangles( optimizeGroup_t *groupList );
 void	FreeTJunctionHash( void );
+void	AllocTJunctionHashes( void );
+void	FreeTJunctionHashes( void );
 int		CountGroupListTris( const optimizeGroup_t *groupList );
 void	FixEntityTjunctions( uEntity_t *e );
 void	FixAreaGroupsTjunctions( optimizeGroup_t *groupList );
@@ -447,6 +461,8 @@ typedef struct {
 
 void	OptimizeEntity( uEntity_t *e );
 void	OptimizeGroupList( optimizeGroup_t *groupList );
+void	AllocOptimizeScratch( void );
+void	FreeOptimizeScratch( void );
 
 //=============================================================================
 
@@ -485,3 +501,31 @@ srfTriangles_t *CreateLightShadow( optimizeGroup_t *shadowerGroups, const mapLig
 void		FreeBeamTree( struct beamTree_s *beamTree );
 
 void		CarveTriByBeamTree( const struct beamTree_s *beamTree, const mapTri_t *tri, mapTri_t **lit, mapTri_t **unLit );
+
+//=============================================================================
+
+// cache.cpp -- results of the last dmap -incremental run
+
+typedef enum {
+	DMAP_CACHE_AREA,			// optimized triangles of an area
+	DMAP_CACHE_SHADOW			// optimized shadow volume of a light
+} dmapCacheType_t;
+
+typedef struct {
+	unsigned int	crc;
+	unsigned int	md5;
+	int				length;
+} dmapCacheKey_t;
+
+void		LoadDmapCache( void );
+void		WriteDmapCache( void );
+void		FreeDmapCache( void );
+void		KeepCacheEntry( int entryNum );
+
+void		AreaCacheKey( const optimizeGroup_t *groups, dmapCacheKey_t &key );
+int			FindCachedArea( const dmapCacheKey_t &key, optimizeGroup_t *groups );
+void		CacheArea( const dmapCacheKey_t &key, const optimizeGroup_t *groups );
+
+void		ShadowCacheKey( const optimizeGroup_t *shadowerGroups, const mapLight_t *light, bool hasPerforatedSurface, dmapCacheKey_t &key );
+bool		FindCachedShadow( const dmapCacheKey_t &key, srfTriangles_t **shadowTris );
+void		CacheShadow( const dmapCacheKey_t &key, const srfTriangles_t *shadowTris );
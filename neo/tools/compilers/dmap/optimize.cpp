@@ -37,6 +37,8 @@ If you have questions concerning this license or the applicable additional terms
 #include <GL/gl.h>
 #endif
 
+#include "sys/sys_jobs.h"
+
 #include "tools/compilers/dmap/dmap.h"
 
 /*
@@ -49,21 +51,89 @@ If you have questions concerning this license or the applicable additional terms
 
 */
 
-idBounds	optBounds;
-
 #define	MAX_OPT_VERTEXES	0x10000
-int			numOptVerts;
-optVertex_t optVerts[MAX_OPT_VERTEXES];
-
 #define	MAX_OPT_EDGES		0x40000
-static	int		numOptEdges;
-static	optEdge_t	optEdges[MAX_OPT_EDGES];
+
+typedef struct {
+	optVertex_t	*v1, *v2;
+} originalEdges_t;
+
+// the vertexes and edges of the group that is being optimized
+typedef struct {
+	idBounds		optBounds;
+
+	int				numOptVerts;
+	optVertex_t		optVerts[MAX_OPT_VERTEXES];
+
+	int				numOptEdges;
+	optEdge_t		optEdges[MAX_OPT_EDGES];
+
+	originalEdges_t	*originalEdges;
+	int				numOriginalEdges;
+} optimizeScratch_t;
+
+// indexed by parallelJobManager->GetThreadIndex() so the areas of an
+// entity can be optimized on the job threads, one slot for every running
+// thread, the scratch space of a slot is allocated on first use
+static idList<optimizeScratch_t *> optimizeScratch;
 
 static bool IsTriangleValid( const optVertex_t *v1, const optVertex_t *v2, const optVertex_t *v3 );
 static bool IsTriangleDegenerate( const optVertex_t *v1, const optVertex_t *v2, const optVertex_t *v3 );
 
 static idRandom orandom;
 
+/*
+==============
+GetOptimizeScratch
+
+Returns the scratch space of the calling thread
+==============
+*/
+static optimizeScratch_t *GetOptimizeScratch( void ) {
+	int thread = parallelJobManager->GetThreadIndex();
+
+	// the slots of the job threads are created by AllocOptimizeScratch before any jobs run
+	if ( thread >= optimizeScratch.Num() ) {
+		assert( thread == 0 );
+		AllocOptimizeScratch();
+	}
+
+	// only the owning thread ever touches its slot
+	if ( optimizeScratch[thread] == NULL ) {
+		optimizeScratch[thread] = (optimizeScratch_t *)Mem_Alloc( sizeof( optimizeScratch_t ) );
+	}
+	return optimizeScratch[thread];
+}
+
+/*
+==============
+AllocOptimizeScratch
+
+Creates a scratch slot for the main thread and every job thread
+==============
+*/
+void AllocOptimizeScratch( void ) {
+	int num = parallelJobManager->GetNumWorkerThreads() + 1;
+
+	for ( int i = optimizeScratch.Num() ; i < num ; i++ ) {
+		optimizeScratch.Append( NULL );
+	}
+}
+
+/*
+==============
+FreeOptimizeScratch
+==============
+*/
+void FreeOptimizeScratch( void ) {
+	for ( int i = 0 ; i < optimizeScratch.Num() ; i++ ) {
+		if ( optimizeScratch[i] != NULL ) {
+			Mem_Free( optimizeScratch[i] );
+		}
+	}
+	optimizeScratch.Clear();
+}
+
 /*
 ==============
 ValidateEdgeCounts
@@ -83,7 +153,7 @@ static void ValidateEdgeCounts( optIsland_t *island ) {
 			} else if ( e->v2 == vert ) {
 				e = e->v2link;
 			} else {
-				common->Error( "ValidateEdgeCounts: mislinked" );
+				AreaError( "ValidateEdgeCounts: mislinked" );
 			}
 		}
 		if ( c != 2 && c != 0 ) {
@@ -100,13 +170,14 @@ AllocEdge
 ====================
 */
 static optEdge_t	*AllocEdge( void ) {
+	optimizeScratch_t	*scratch = GetOptimizeScratch();
 	optEdge_t	*e;
 
-	if ( numOptEdges == MAX_OPT_EDGES ) {
-		common->Error( "MAX_OPT_EDGES" );
+	if ( scratch->numOptEdges == MAX_OPT_EDGES ) {
+		AreaError( "MAX_OPT_EDGES" );
 	}
-	e = &optEdges[ numOptEdges ];
-	numOptEdges++;
+	e = &scratch->optEdges[ scratch->numOptEdges ];
+	scratch->numOptEdges++;
 	memset( e, 0, sizeof( *e ) );
 
 	return e;
@@ -133,7 +204,7 @@ static	void RemoveEdgeFromVert( optEdge_t *e1, optVertex_t *vert ) {
 			} else if ( e1->v2 == vert ) {
 				*prev = e1->v2link;
 			} else {
-				common->Error( "RemoveEdgeFromVert: vert not found" );
+				AreaError( "RemoveEdgeFromVert: vert not found" );
 			}
 			return;
 		}
@@ -143,7 +214,7 @@ static	void RemoveEdgeFromVert( optEdge_t *e1, optVertex_t *vert ) {
 		} else if ( e->v2 == vert ) {
 			prev = &e->v2link;
 		} else {
-			common->Error( "RemoveEdgeFromVert: vert not found" );
+			AreaError( "RemoveEdgeFromVert: vert not found" );
 		}
 	}
 }
@@ -166,7 +237,7 @@ static	void UnlinkEdge( optEdge_t *e, optIsland_t *island ) {
 		}
 	}
 
-	common->Error( "RemoveEdgeFromIsland: couldn't free edge" );
+	AreaError( "RemoveEdgeFromIsland: couldn't free edge" );
 }
 
 
@@ -189,6 +260,7 @@ FindOptVertex
 ================
 */
 static optVertex_t *FindOptVertex( idDrawVert *v, optimizeGroup_t *opt ) {
+	optimizeScratch_t	*scratch = GetOptimizeScratch();
 	int		i;
 	float	x, y;
 	optVertex_t	*vert;
@@ -198,27 +270,27 @@ static optVertex_t *FindOptVertex( idDrawVert *v, optimizeGroup_t *opt ) {
 	y = v->xyz * opt->axis[1];
 
 	// should we match based on the t-junction fixing hash verts?
-	for ( i = 0 ; i < numOptVerts ; i++ ) {
-		if ( optVerts[i].pv[0] == x && optVerts[i].pv[1] == y ) {
-			return &optVerts[i];
+	for ( i = 0 ; i < scratch->numOptVerts ; i++ ) {
+		if ( scratch->optVerts[i].pv[0] == x && scratch->optVerts[i].pv[1] == y ) {
+			return &scratch->optVerts[i];
 		}
 	}
 
-	if ( numOptVerts >= MAX_OPT_VERTEXES ) {
-		common->Error( "MAX_OPT_VERTEXES" );
+	if ( scratch->numOptVerts >= MAX_OPT_VERTEXES ) {
+		AreaError( "MAX_OPT_VERTEXES" );
 		return NULL;
 	}
 
-	numOptVerts++;
+	scratch->numOptVerts++;
 
-	vert = &optVerts[i];
+	vert = &scratch->optVerts[i];
 	memset( vert, 0, sizeof( *vert ) );
 	vert->v = *v;
 	vert->pv[0] = x;
 	vert->pv[1] = y;
 	vert->pv[2] = 0;
 
-	optBounds.AddPoint( vert->pv );
+	scratch->optBounds.AddPoint( vert->pv );
 
 	return vert;
 }
@@ -229,6 +301,7 @@ DrawAllEdges
 ================
 */
 static	void DrawAllEdges( void ) {
+	optimizeScratch_t	*scratch = GetOptimizeScratch();
 	int		i;
 
 	if ( !dmapGlobals.drawflag ) {
@@ -238,14 +311,14 @@ static	void DrawAllEdges( void ) {
 	Draw_ClearWindow();
 
 	qglBegin( GL_LINES );
-	for ( i = 0 ; i < numOptEdges ; i++ ) {
-		if ( optEdges[i].v1 == NULL ) {
+	for ( i = 0 ; i < scratch->numOptEdges ; i++ ) {
+		if ( scratch->optEdges[i].v1 == NULL ) {
 			continue;
 		}
 		qglColor3f( 1, 0, 0 );
-		qglVertex3fv( optEdges[i].v1->pv.ToFloatPtr() );
+		qglVertex3fv( scratch->optEdges[i].v1->pv.ToFloatPtr() );
 		qglColor3f( 0, 0, 0 );
-		qglVertex3fv( optEdges[i].v2->pv.ToFloatPtr() );
+		qglVertex3fv( scratch->optEdges[i].v2->pv.ToFloatPtr() );
 	}
 	qglEnd();
 	qglFlush();
@@ -625,7 +698,7 @@ static	void RemoveIfColinear( optVertex_t *ov, optIsland_t *island ) {
 		} else if ( e->v2 == v2 ) {
 			e = e->v2link;
 		} else {
-			common->Error( "RemoveIfColinear: mislinked edge" );
+			AreaError( "RemoveIfColinear: mislinked edge" );
 			return;
 		}
 	}
@@ -647,7 +720,7 @@ static	void RemoveIfColinear( optVertex_t *ov, optIsland_t *island ) {
 	} else if ( e1->v2 == v2 ) {
 		v1 = e1->v1;
 	} else {
-		common->Error( "RemoveIfColinear: mislinked edge" );
+		AreaError( "RemoveIfColinear: mislinked edge" );
 		return;
 	}
 	if ( e2->v1 == v2 ) {
@@ -655,12 +728,12 @@ static	void RemoveIfColinear( optVertex_t *ov, optIsland_t *island ) {
 	} else if ( e2->v2 == v2 ) {
 		v3 = e2->v1;
 	} else {
-		common->Error( "RemoveIfColinear: mislinked edge" );
+		AreaError( "RemoveIfColinear: mislinked edge" );
 		return;
 	}
 
 	if ( v1 == v3 ) {
-		common->Error( "RemoveIfColinear: mislinked edge" );
+		AreaError( "RemoveIfColinear: mislinked edge" );
 		return;
 	}
 
@@ -704,7 +777,7 @@ static	void RemoveIfColinear( optVertex_t *ov, optIsland_t *island ) {
 
 	// v2 should have no edges now
 	if ( v2->edges ) {
-		common->Error( "RemoveIfColinear: didn't remove properly" );
+		AreaError( "RemoveIfColinear: didn't remove properly" );
 		return;
 	}
 
@@ -921,7 +994,7 @@ static void LinkTriToEdge( optTri_t *optTri, optEdge_t *edge ) {
 		edge->frontTri = optTri;
 		return;
 	}
-	common->Error( "LinkTriToEdge: edge not found on tri" );
+	AreaError( "LinkTriToEdge: edge not found on tri" );
 }
 
 /*
@@ -940,7 +1013,7 @@ static void CreateOptTri( optVertex_t *first, optEdge_t *e1, optEdge_t *e2, optI
 	} else if ( e1->v2 == first ) {
 		second = e1->v1;
 	} else {
-		common->Error( "CreateOptTri: mislinked edge" );
+		AreaError( "CreateOptTri: mislinked edge" );
 		return;
 	}
 
@@ -949,12 +1022,12 @@ static void CreateOptTri( optVertex_t *first, optEdge_t *e1, optEdge_t *e2, optI
 	} else if ( e2->v2 == first ) {
 		third = e2->v1;
 	} else {
-		common->Error( "CreateOptTri: mislinked edge" );
+		AreaError( "CreateOptTri: mislinked edge" );
 		return;
 	}
 
 	if ( !IsTriangleValid( first, second, third ) ) {
-		common->Error( "CreateOptTri: invalid" );
+		AreaError( "CreateOptTri: invalid" );
 		return;
 	}
 
@@ -985,7 +1058,7 @@ static void CreateOptTri( optVertex_t *first, optEdge_t *e1, optEdge_t *e2, optI
 		} else if ( opposite->v2 == second ) {
 			opposite = opposite->v2link;
 		} else {
-			common->Error( "BuildOptTriangles: mislinked edge" );
+			AreaError( "BuildOptTriangles: mislinked edge" );
 			return;
 		}
 	}
@@ -1139,7 +1212,7 @@ for ( e1 = ov->edges ; e1 ; e1 = e1Next ) {
 				second = e1->v1;
 				e1Next = e1->v2link;
 			} else {
-				common->Error( "BuildOptTriangles: mislinked edge" );
+				AreaError( "BuildOptTriangles: mislinked edge" );
 			}
 
 			// if the vertex has already been used, it can't be used again
@@ -1155,7 +1228,7 @@ for ( e1 = ov->edges ; e1 ; e1 = e1Next ) {
 					third = e2->v1;
 					e2Next = e2->v2link;
 				} else {
-					common->Error( "BuildOptTriangles: mislinked edge" );
+					AreaError( "BuildOptTriangles: mislinked edge" );
 				}
 				if ( e2 == e1 ) {
 					continue;
@@ -1181,7 +1254,7 @@ for ( e1 = ov->edges ; e1 ; e1 = e1Next ) {
 						middle = check->v1;
 						checkNext = check->v2link;
 					} else {
-						common->Error( "BuildOptTriangles: mislinked edge" );
+						AreaError( "BuildOptTriangles: mislinked edge" );
 					}
 
 					if ( check == e1 || check == e2 ) {
@@ -1314,10 +1387,6 @@ static	void RemoveInteriorEdges( optIsland_t *island ) {
 
 //==================================================================================
 
-typedef struct {
-	optVertex_t	*v1, *v2;
-} originalEdges_t;
-
 /*
 =================
 AddEdgeIfNotAlready
@@ -1336,7 +1405,7 @@ void AddEdgeIfNotAlready( optVertex_t *v1, optVertex_t *v2 ) {
 		} else if ( e->v2 == v1 ) {
 			e = e->v2link;
 		} else {
-			common->Error( "SplitEdgeByList: bad edge link" );
+			AreaError( "SplitEdgeByList: bad edge link" );
 		}
 	}
 
@@ -1383,15 +1452,13 @@ typedef struct edgeCrossing_s {
 	optVertex_t		*ov;
 } edgeCrossing_t;
 
-static	originalEdges_t	*originalEdges;
-static	int				numOriginalEdges;
-
 /*
 =================
 AddOriginalTriangle
 =================
 */
 static void AddOriginalTriangle( optVertex_t *v[3] ) {
+	optimizeScratch_t	*scratch = GetOptimizeScratch();
 	optVertex_t		*v1, *v2;
 
 	// if this triangle is backwards (possible with epsilon issues)
@@ -1412,20 +1479,20 @@ static void AddOriginalTriangle( optVertex_t *v[3] ) {
 		}
 		int j;
 		// see if there is an existing one
-		for ( j = 0 ; j < numOriginalEdges ; j++ ) {
-			if ( originalEdges[j].v1 == v1 && originalEdges[j].v2 == v2 ) {
+		for ( j = 0 ; j < scratch->numOriginalEdges ; j++ ) {
+			if ( scratch->originalEdges[j].v1 == v1 && scratch->originalEdges[j].v2 == v2 ) {
 				break;
 			}
-			if ( originalEdges[j].v2 == v1 && originalEdges[j].v1 == v2 ) {
+			if ( scratch->originalEdges[j].v2 == v1 && scratch->originalEdges[j].v1 == v2 ) {
 				break;
 			}
 		}
 
-		if ( j == numOriginalEdges ) {
+		if ( j == scratch->numOriginalEdges ) {
 			// add it
-			originalEdges[j].v1 = v1;
-			originalEdges[j].v2 = v2;
-			numOriginalEdges++;
+			scratch->originalEdges[j].v1 = v1;
+			scratch->originalEdges[j].v2 = v2;
+			scratch->numOriginalEdges++;
 		}
 	}
 }
@@ -1436,6 +1503,7 @@ AddOriginalEdges
 =================
 */
 static	void AddOriginalEdges( optimizeGroup_t *opt ) {
+	optimizeScratch_t	*scratch = GetOptimizeScratch();
 	mapTri_t		*tri;
 	optVertex_t		*v[3];
 	int				numTris;
@@ -1445,16 +1513,16 @@ static	void AddOriginalEdges( optimizeGroup_t *opt ) {
 		common->Printf( "%6i original tris\n", CountTriList( opt->triList ) );
 	}
 
-	optBounds.Clear();
+	scratch->optBounds.Clear();
 
 	// allocate space for max possible edges
 	numTris = CountTriList( opt->triList );
-	originalEdges = (originalEdges_t *)Mem_Alloc( numTris * 3 * sizeof( *originalEdges ) );
-	numOriginalEdges = 0;
+	scratch->originalEdges = (originalEdges_t *)Mem_Alloc( numTris * 3 * sizeof( *scratch->originalEdges ) );
+	scratch->numOriginalEdges = 0;
 
 	// add all unique triangle edges
-	numOptVerts = 0;
-	numOptEdges = 0;
+	scratch->numOptVerts = 0;
+	scratch->numOptEdges = 0;
 	for ( tri = opt->triList ; tri ; tri = tri->next ) {
 		v[0] = tri->optVert[0] = FindOptVertex( &tri->v[0], opt );
 		v[1] = tri->optVert[1] = FindOptVertex( &tri->v[1], opt );
@@ -1470,45 +1538,48 @@ SplitOriginalEdgesAtCrossings
 =====================
 */
 void SplitOriginalEdgesAtCrossings( optimizeGroup_t *opt ) {
+	optimizeScratch_t	*scratch = GetOptimizeScratch();
 	int				i, j, k, l;
 	int				numOriginalVerts;
 	edgeCrossing_t	**crossings;
 
-	numOriginalVerts = numOptVerts;
+	numOriginalVerts = scratch->numOptVerts;
 	// now split any crossing edges and create optEdges
 	// linked to the vertexes
 
-	// debug drawing bounds
-	dmapGlobals.drawBounds = optBounds;
+	// debug drawing bounds, only drawn when running without jobs
+	if ( dmapGlobals.drawflag ) {
+		dmapGlobals.drawBounds = scratch->optBounds;
 
-	dmapGlobals.drawBounds[0][0] -= 2;
-	dmapGlobals.drawBounds[0][1] -= 2;
-	dmapGlobals.drawBounds[1][0] += 2;
-	dmapGlobals.drawBounds[1][1] += 2;
+		dmapGlobals.drawBounds[0][0] -= 2;
+		dmapGlobals.drawBounds[0][1] -= 2;
+		dmapGlobals.drawBounds[1][0] += 2;
+		dmapGlobals.drawBounds[1][1] += 2;
+	}
 
 	// generate crossing points between all the original edges
-	crossings = (edgeCrossing_t **)Mem_ClearedAlloc( numOriginalEdges * sizeof( *crossings ) );
+	crossings = (edgeCrossing_t **)Mem_ClearedAlloc( scratch->numOriginalEdges * sizeof( *crossings ) );
 
-	for ( i = 0 ; i < numOriginalEdges ; i++ ) {
+	for ( i = 0 ; i < scratch->numOriginalEdges ; i++ ) {
 		if ( dmapGlobals.drawflag ) {
-			DrawOriginalEdges( numOriginalEdges, originalEdges );
+			DrawOriginalEdges( scratch->numOriginalEdges, scratch->originalEdges );
 			qglBegin( GL_LINES );
 			qglColor3f( 0, 1, 0 );
-			qglVertex3fv( originalEdges[i].v1->pv.ToFloatPtr() );
+			qglVertex3fv( scratch->originalEdges[i].v1->pv.ToFloatPtr() );
 			qglColor3f( 0, 0, 1 );
-			qglVertex3fv( originalEdges[i].v2->pv.ToFloatPtr() );
+			qglVertex3fv( scratch->originalEdges[i].v2->pv.ToFloatPtr() );
 			qglEnd();
 			qglFlush();
 		}
-		for ( j = i+1 ; j < numOriginalEdges ; j++ ) {
+		for ( j = i+1 ; j < scratch->numOriginalEdges ; j++ ) {
 			optVertex_t	*v1, *v2, *v3, *v4;
 			optVertex_t	*newVert;
 			edgeCrossing_t	*cross;
 
-			v1 = originalEdges[i].v1;
-			v2 = originalEdges[i].v2;
-			v3 = originalEdges[j].v1;
-			v4 = originalEdges[j].v2;
+			v1 = scratch->originalEdges[i].v1;
+			v2 = scratch->originalEdges[i].v2;
+			v3 = scratch->originalEdges[j].v1;
+			v4 = scratch->originalEdges[j].v2;
 
 			if ( !EdgesCross( v1, v2, v3, v4 ) ) {
 				continue;
@@ -1521,8 +1592,8 @@ void SplitOriginalEdgesAtCrossings( optimizeGroup_t *opt ) {
 			newVert = EdgeIntersection( v1, v2, v3, v4, opt );
 
 			if ( !newVert ) {
-//common->Printf( "lines %i (%i to %i) and %i (%i to %i) are colinear\n", i, v1 - optVerts, v2 - optVerts,
-//		   j, v3 - optVerts, v4 - optVerts );	// !@#
+//common->Printf( "lines %i (%i to %i) and %i (%i to %i) are colinear\n", i, v1 - scratch->optVerts, v2 - scratch->optVerts,
+//		   j, v3 - scratch->optVerts, v4 - scratch->optVerts );	// !@#
 				// colinear, so add both verts of each edge to opposite
 				if ( VertexBetween( v3, v1, v2 ) ) {
 					cross = (edgeCrossing_t *)Mem_ClearedAlloc( sizeof( *cross ) );
@@ -1556,11 +1627,11 @@ void SplitOriginalEdgesAtCrossings( optimizeGroup_t *opt ) {
 			}
 #if 0
 if ( newVert && newVert != v1 && newVert != v2 && newVert != v3 && newVert != v4 ) {
-common->Printf( "lines %i (%i to %i) and %i (%i to %i) cross at new point %i\n", i, v1 - optVerts, v2 - optVerts,
-		   j, v3 - optVerts, v4 - optVerts, newVert - optVerts );
+common->Printf( "lines %i (%i to %i) and %i (%i to %i) cross at new point %i\n", i, v1 - scratch->optVerts, v2 - scratch->optVerts,
+		   j, v3 - scratch->optVerts, v4 - scratch->optVerts, newVert - scratch->optVerts );
 } else if ( newVert ) {
-common->Printf( "lines %i (%i to %i) and %i (%i to %i) intersect at old point %i\n", i, v1 - optVerts, v2 - optVerts,
-		  j, v3 - optVerts, v4 - optVerts, newVert - optVerts );
+common->Printf( "lines %i (%i to %i) and %i (%i to %i) intersect at old point %i\n", i, v1 - scratch->optVerts, v2 - scratch->optVerts,
+		  j, v3 - scratch->optVerts, v4 - scratch->optVerts, newVert - scratch->optVerts );
 }
 #endif
 			if ( newVert != v1 && newVert != v2 ) {
@@ -1583,7 +1654,7 @@ common->Printf( "lines %i (%i to %i) and %i (%i to %i) intersect at old point %i
 
 	// now split each edge by its crossing points
 	// colinear edges will have duplicated edges added, but it won't hurt anything
-	for ( i = 0 ; i < numOriginalEdges ; i++ ) {
+	for ( i = 0 ; i < scratch->numOriginalEdges ; i++ ) {
 		edgeCrossing_t	*cross, *nextCross;
 		int				numCross;
 		optVertex_t		**sorted;
@@ -1594,8 +1665,8 @@ common->Printf( "lines %i (%i to %i) and %i (%i to %i) intersect at old point %i
 		}
 		numCross += 2;	// account for originals
 		sorted = (optVertex_t **)Mem_Alloc( numCross * sizeof( *sorted ) );
-		sorted[0] = originalEdges[i].v1;
-		sorted[1] = originalEdges[i].v2;
+		sorted[0] = scratch->originalEdges[i].v1;
+		sorted[1] = scratch->originalEdges[i].v2;
 		j = 2;
 		for ( cross = crossings[i] ; cross ; cross = nextCross ) {
 			nextCross = cross->next;
@@ -1620,7 +1691,7 @@ common->Printf( "lines %i (%i to %i) and %i (%i to %i) intersect at old point %i
 					}
 				}
 				if ( l == numCross ) {
-//common->Printf( "line %i fragment from point %i to %i\n", i, sorted[j] - optVerts, sorted[k] - optVerts );
+//common->Printf( "line %i fragment from point %i to %i\n", i, sorted[j] - scratch->optVerts, sorted[k] - scratch->optVerts );
 					AddEdgeIfNotAlready( sorted[j], sorted[k] );
 				}
 			}
@@ -1631,23 +1702,23 @@ common->Printf( "lines %i (%i to %i) and %i (%i to %i) intersect at old point %i
 
 
 	Mem_Free( crossings );
-	Mem_Free( originalEdges );
+	Mem_Free( scratch->originalEdges );
 
 	// check for duplicated edges
-	for ( i = 0 ; i < numOptEdges ; i++ ) {
-		for ( j = i+1 ; j < numOptEdges ; j++ ) {
-			if ( ( optEdges[i].v1 == optEdges[j].v1 && optEdges[i].v2 == optEdges[j].v2 )
-				|| ( optEdges[i].v1 == optEdges[j].v2 && optEdges[i].v2 == optEdges[j].v1 ) ) {
+	for ( i = 0 ; i < scratch->numOptEdges ; i++ ) {
+		for ( j = i+1 ; j < scratch->numOptEdges ; j++ ) {
+			if ( ( scratch->optEdges[i].v1 == scratch->optEdges[j].v1 && scratch->optEdges[i].v2 == scratch->optEdges[j].v2 )
+				|| ( scratch->optEdges[i].v1 == scratch->optEdges[j].v2 && scratch->optEdges[i].v2 == scratch->optEdges[j].v1 ) ) {
 				common->Printf( "duplicated optEdge\n" );
 			}
 		}
 	}
 
 	if ( dmapGlobals.verbose ) {
-		common->Printf( "%6i original edges\n", numOriginalEdges );
-		common->Printf( "%6i edges after splits\n", numOptEdges );
+		common->Printf( "%6i original edges\n", scratch->numOriginalEdges );
+		common->Printf( "%6i edges after splits\n", scratch->numOptEdges );
 		common->Printf( "%6i original vertexes\n", numOriginalVerts );
-		common->Printf( "%6i vertexes after splits\n", numOptVerts );
+		common->Printf( "%6i vertexes after splits\n", scratch->numOptVerts );
 	}
 }
 
@@ -1785,7 +1856,7 @@ static void AddVertexToIsland_r( optVertex_t *vert, optIsland_t *island ) {
 			e = e->v2link;
 			continue;
 		}
-		common->Error( "AddVertexToIsland_r: mislinked vert" );
+		AreaError( "AddVertexToIsland_r: mislinked vert" );
 	}
 
 }
@@ -1807,6 +1878,7 @@ the source list has triangles not used in the optimization
 */
 #if 0
 static void SeparateIslands( optimizeGroup_t *opt ) {
+	optimizeScratch_t	*scratch = GetOptimizeScratch();
 	int		i;
 	optIsland_t	island;
 	int		numIslands;
@@ -1814,14 +1886,14 @@ static void SeparateIslands( optimizeGroup_t *opt ) {
 	DrawAllEdges();
 
 	numIslands = 0;
-	for ( i = 0 ; i < numOptVerts ; i++ ) {
-		if ( optVerts[i].addedToIsland ) {
+	for ( i = 0 ; i < scratch->numOptVerts ; i++ ) {
+		if ( scratch->optVerts[i].addedToIsland ) {
 			continue;
 		}
 		numIslands++;
 		memset( &island, 0, sizeof( island ) );
 		island.group = opt;
-		AddVertexToIsland_r( &optVerts[i], &island );
+		AddVertexToIsland_r( &scratch->optVerts[i], &island );
 		OptimizeIsland( &island );
 	}
 	if ( dmapGlobals.verbose ) {
@@ -1831,6 +1903,7 @@ static void SeparateIslands( optimizeGroup_t *opt ) {
 #endif
 
 static void DontSeparateIslands( optimizeGroup_t *opt ) {
+	optimizeScratch_t	*scratch = GetOptimizeScratch();
 	int		i;
 	optIsland_t	island;
 
@@ -1840,14 +1913,14 @@ static void DontSeparateIslands( optimizeGroup_t *opt ) {
 	island.group = opt;
 
 	// link everything together
-	for ( i = 0 ; i < numOptVerts ; i++ ) {
-		optVerts[i].islandLink = island.verts;
-		island.verts = &optVerts[i];
+	for ( i = 0 ; i < scratch->numOptVerts ; i++ ) {
+		scratch->optVerts[i].islandLink = island.verts;
+		island.verts = &scratch->optVerts[i];
 	}
 
-	for ( i = 0 ; i < numOptEdges ; i++ ) {
-		optEdges[i].islandLink = island.edges;
-		island.edges = &optEdges[i];
+	for ( i = 0 ; i < scratch->numOptEdges ; i++ ) {
+		scratch->optEdges[i].islandLink = island.edges;
+		island.edges = &scratch->optEdges[i];
 	}
 
 	OptimizeIsland( &island );
@@ -1947,44 +2020,100 @@ void SetGroupTriPlaneNums( optimizeGroup_t *groups ) {
 }
 
 
+typedef struct {
+	int		c_in, c_edge, c_tjunc2;
+
+	// dmap -incremental
+	dmapCacheKey_t	key;
+	int		cacheEntry;			// -1 if the area wasn't in the cache
+} optimizeResults_t;
+
 /*
 ===================
-OptimizeGroupList
+OptimizeGroups
 
 This will also fix tjunctions
-
 ===================
 */
-void	OptimizeGroupList( optimizeGroup_t *groupList ) {
-	int			c_in, c_edge, c_tjunc2;
+static void OptimizeGroups( optimizeGroup_t *groupList, optimizeResults_t *results ) {
 	optimizeGroup_t	*group;
 
-	if ( !groupList ) {
-		return;
-	}
-
-	c_in = CountGroupListTris( groupList );
+	results->c_in = CountGroupListTris( groupList );
 
 	// optimize and remove colinear edges, which will
 	// re-introduce some t junctions
 	for ( group = groupList ; group ; group = group->nextGroup ) {
 		OptimizeOptList( group );
 	}
-	c_edge = CountGroupListTris( groupList );
+	results->c_edge = CountGroupListTris( groupList );
 
 	// fix t junctions again
 	FixAreaGroupsTjunctions( groupList );
 	FreeTJunctionHash();
-	c_tjunc2 = CountGroupListTris( groupList );
+	results->c_tjunc2 = CountGroupListTris( groupList );
 
 	SetGroupTriPlaneNums( groupList );
+}
 
+/*
+===================
+PrintOptimizeResults
+===================
+*/
+static void PrintOptimizeResults( const optimizeResults_t *results ) {
 	common->Printf( "----- OptimizeAreaGroups Results -----\n" );
-	common->Printf( "%6i tris in\n", c_in );
-	common->Printf( "%6i tris after edge removal optimization\n", c_edge );
-	common->Printf( "%6i tris after final t junction fixing\n", c_tjunc2 );
+	common->Printf( "%6i tris in\n", results->c_in );
+	common->Printf( "%6i tris after edge removal optimization\n", results->c_edge );
+	common->Printf( "%6i tris after final t junction fixing\n", results->c_tjunc2 );
+}
+
+/*
+===================
+OptimizeGroupList
+
+This will also fix tjunctions
+
+===================
+*/
+void	OptimizeGroupList( optimizeGroup_t *groupList ) {
+	optimizeResults_t	results;
+
+	if ( !groupList ) {
+		return;
+	}
+
+	OptimizeGroups( groupList, &results );
+	PrintOptimizeResults( &results );
 }
 
+/*
+==================
+OptimizeAreaJob
+==================
+*/
+static void OptimizeAreaJob( uEntity_t *e, int areaNum, void *data ) {
+	optimizeResults_t	*results = (optimizeResults_t *)data;
+	optimizeGroup_t		*groups = e->areas[areaNum].groups;
+	optimizeResults_t	*areaResults = &results[areaNum];
+
+	areaResults->cacheEntry = -1;
+
+	if ( !groups ) {
+		return;
+	}
+
+	if ( dmapGlobals.incremental ) {
+		AreaCacheKey( groups, areaResults->key );
+		areaResults->c_in = CountGroupListTris( groups );
+		areaResults->cacheEntry = FindCachedArea( areaResults->key, groups );
+		if ( areaResults->cacheEntry != -1 ) {
+			areaResults->c_edge = areaResults->c_tjunc2 = CountGroupListTris( groups );
+			return;
+		}
+	}
+
+	OptimizeGroups( groups, areaResults );
+}
 
 /*
 ==================
@@ -1993,9 +2122,39 @@ OptimizeEntity
 */
 void	OptimizeEntity( uEntity_t *e ) {
 	int		i;
+	optimizeResults_t	*results;
 
 	common->Printf( "----- OptimizeEntity -----\n" );
+
+	results = (optimizeResults_t *)Mem_ClearedAlloc( e->numAreas * sizeof( *results ) );
+
+	RunAreaJobs( e, OptimizeAreaJob, results, "dmap optimize" );
+
+	// print in area order, independent of the order the jobs ran in
 	for ( i = 0 ; i < e->numAreas ; i++ ) {
-		OptimizeGroupList( e->areas[i].groups );
+		if ( e->areas[i].groups ) {
+			PrintOptimizeResults( &results[i] );
+		}
 	}
+
+	// the cache isn't changed by the jobs
+	if ( dmapGlobals.incremental ) {
+		int		numAreas = 0, numCached = 0;
+
+		for ( i = 0 ; i < e->numAreas ; i++ ) {
+			if ( !e->areas[i].groups ) {
+				continue;
+			}
+			numAreas++;
+			if ( results[i].cacheEntry != -1 ) {
+				KeepCacheEntry( results[i].cacheEntry );
+				numCached++;
+			} else {
+				CacheArea( results[i].key, e->areas[i].groups );
+			}
+		}
+		common->Printf( "%i of %i areas from the cache\n", numCached, numAreas );
+	}
+
+	Mem_Free( results );
 }
@@ -28,6 +28,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "sys/platform.h"
 #include "renderer/ModelManager.h"
+#include "sys/sys_jobs.h"
 
 #include "tools/compilers/dmap/dmap.h"
 
@@ -93,31 +94,84 @@ typedef struct hashVert_s {
 	int					iv[3];
 } hashVert_t;
 
-static idBounds	hashBounds;
-static idVec3	hashScale;
-static hashVert_t	*hashVerts[HASH_BINS][HASH_BINS][HASH_BINS];
-static int		numHashVerts, numTotalVerts;
-static int		hashIntMins[3], hashIntScale[3];
+typedef struct {
+	idBounds	hashBounds;
+	idVec3		hashScale;
+	hashVert_t	*hashVerts[HASH_BINS][HASH_BINS][HASH_BINS];
+	int			numHashVerts, numTotalVerts;
+	int			hashIntMins[3], hashIntScale[3];
+} tjunctionHash_t;
+
+// indexed by parallelJobManager->GetThreadIndex() so the areas
+// of an entity can be fixed on the job threads
+static idList<tjunctionHash_t *>	tjunctionHashes;
 
 /*
 ===============
-GetHashVert
+AllocTJunctionHashes
+
+Creates a hash for the main thread and every job thread
+===============
+*/
+void AllocTJunctionHashes( void ) {
+	int num = parallelJobManager->GetNumWorkerThreads() + 1;
+
+	for ( int i = tjunctionHashes.Num() ; i < num ; i++ ) {
+		tjunctionHashes.Append( (tjunctionHash_t *)Mem_ClearedAlloc( sizeof( tjunctionHash_t ) ) );
+	}
+}
+
+/*
+===============
+FreeTJunctionHashes
+
+The hash verts must have been freed with FreeTJunctionHash
+===============
+*/
+void FreeTJunctionHashes( void ) {
+	for ( int i = 0 ; i < tjunctionHashes.Num() ; i++ ) {
+		Mem_Free( tjunctionHashes[i] );
+	}
+	tjunctionHashes.Clear();
+}
+
+/*
+===============
+GetTJunctionHash
+
+Returns the hash of the calling thread
+===============
+*/
+static tjunctionHash_t *GetTJunctionHash( void ) {
+	int thread = parallelJobManager->GetThreadIndex();
+
+	// the hashes of the job threads are created by AllocTJunctionHashes before any jobs run
+	if ( thread >= tjunctionHashes.Num() ) {
+		assert( thread == 0 );
+		AllocTJunctionHashes();
+	}
+	return tjunctionHashes[thread];
+}
+
+/*
+===============
+HashVert
 
 Also modifies the original vert to the snapped value
 ===============
 */
-struct hashVert_s	*GetHashVert( idVec3 &v ) {
+static hashVert_t *HashVert( tjunctionHash_t *hash, idVec3 &v ) {
 	int		iv[3];
 	int		block[3];
 	int		i;
 	hashVert_t	*hv;
 
-	numTotalVerts++;
+	hash->numTotalVerts++;
 
 	// snap the vert to integral values
 	for ( i = 0 ; i < 3 ; i++ ) {
 		iv[i] = floor( ( v[i] + 0.5/SNAP_FRACTIONS ) * SNAP_FRACTIONS );
-		block[i] = ( iv[i] - hashIntMins[i] ) / hashIntScale[i];
+		block[i] = ( iv[i] - hash->hashIntMins[i] ) / hash->hashIntScale[i];
 		if ( block[i] < 0 ) {
 			block[i] = 0;
 		} else if ( block[i] >= HASH_BINS ) {
@@ -127,7 +181,7 @@ struct hashVert_s	*GetHashVert( idVec3 &v ) {
 
 	// see if a vertex near enough already exists
 	// this could still fail to find a near neighbor right at the hash block boundary
-	for ( hv = hashVerts[block[0]][block[1]][block[2]] ; hv ; hv = hv->next ) {
+	for ( hv = hash->hashVerts[block[0]][block[1]][block[2]] ; hv ; hv = hv->next ) {
 #if 0
 		if ( hv->iv[0] == iv[0] && hv->iv[1] == iv[1] && hv->iv[2] == iv[2] ) {
 			VectorCopy( hv->v, v );
@@ -151,8 +205,8 @@ struct hashVert_s	*GetHashVert( idVec3 &v ) {
 	// create a new one
 	hv = (hashVert_t *)Mem_Alloc( sizeof( *hv ) );
 
-	hv->next = hashVerts[block[0]][block[1]][block[2]];
-	hashVerts[block[0]][block[1]][block[2]] = hv;
+	hv->next = hash->hashVerts[block[0]][block[1]][block[2]];
+	hash->hashVerts[block[0]][block[1]][block[2]] = hv;
 
 	hv->iv[0] = iv[0];
 	hv->iv[1] = iv[1];
@@ -164,12 +218,23 @@ struct hashVert_s	*GetHashVert( idVec3 &v ) {
 
 	VectorCopy( hv->v, v );
 
-	numHashVerts++;
+	hash->numHashVerts++;
 
 	return hv;
 }
 
 
+/*
+===============
+GetHashVert
+
+Also modifies the original vert to the snapped value
+===============
+*/
+struct hashVert_s	*GetHashVert( idVec3 &v ) {
+	return HashVert( GetTJunctionHash(), v );
+}
+
 /*
 ==================
 HashBlocksForTri
@@ -178,7 +243,7 @@ Returns an inclusive bounding box of hash
 bins that should hold the triangle
 ==================
 */
-static void HashBlocksForTri( const mapTri_t *tri, int blocks[2][3] ) {
+static void HashBlocksForTri( const tjunctionHash_t *hash, const mapTri_t *tri, int blocks[2][3] ) {
 	idBounds	bounds;
 	int			i;
 
@@ -189,14 +254,14 @@ static void HashBlocksForTri( const mapTri_t *tri, int blocks[2][3] ) {
 
 	// add a 1.0 slop margin on each side
 	for ( i = 0 ; i < 3 ; i++ ) {
-		blocks[0][i] = ( bounds[0][i] - 1.0 - hashBounds[0][i] ) / hashScale[i];
+		blocks[0][i] = ( bounds[0][i] - 1.0 - hash->hashBounds[0][i] ) / hash->hashScale[i];
 		if ( blocks[0][i] < 0 ) {
 			blocks[0][i] = 0;
 		} else if ( blocks[0][i] >= HASH_BINS ) {
 			blocks[0][i] = HASH_BINS - 1;
 		}
 
-		blocks[1][i] = ( bounds[1][i] + 1.0 - hashBounds[0][i] ) / hashScale[i];
+		blocks[1][i] = ( bounds[1][i] + 1.0 - hash->hashBounds[0][i] ) / hash->hashScale[i];
 		if ( blocks[1][i] < 0 ) {
 			blocks[1][i] = 0;
 		} else if ( blocks[1][i] >= HASH_BINS ) {
@@ -218,33 +283,34 @@ void HashTriangles( optimizeGroup_t *groupList ) {
 	int			vert;
 	int			i;
 	optimizeGroup_t	*group;
+	tjunctionHash_t	*hash = GetTJunctionHash();
 
 	// clear the hash tables
-	memset( hashVerts, 0, sizeof( hashVerts ) );
+	memset( hash->hashVerts, 0, sizeof( hash->hashVerts ) );
 
-	numHashVerts = 0;
-	numTotalVerts = 0;
+	hash->numHashVerts = 0;
+	hash->numTotalVerts = 0;
 
 	// bound all the triangles to determine the bucket size
-	hashBounds.Clear();
+	hash->hashBounds.Clear();
 	for ( group = groupList ; group ; group = group->nextGroup ) {
 		for ( a = group->triList ; a ; a = a->next ) {
-			hashBounds.AddPoint( a->v[0].xyz );
-			hashBounds.AddPoint( a->v[1].xyz );
-			hashBounds.AddPoint( a->v[2].xyz );
+			hash->hashBounds.AddPoint( a->v[0].xyz );
+			hash->hashBounds.AddPoint( a->v[1].xyz );
+			hash->hashBounds.AddPoint( a->v[2].xyz );
 		}
 	}
 
 	// spread the bounds so it will never have a zero size
 	for ( i = 0 ; i < 3 ; i++ ) {
-		hashBounds[0][i] = floor( hashBounds[0][i] - 1 );
-		hashBounds[1][i] = ceil( hashBounds[1][i] + 1 );
-		hashIntMins[i] = hashBounds[0][i] * SNAP_FRACTIONS;
-
-		hashScale[i] = ( hashBounds[1][i] - hashBounds[0][i] ) / HASH_BINS;
-		hashIntScale[i] = hashScale[i] * SNAP_FRACTIONS;
-		if ( hashIntScale[i] < 1 ) {
-			hashIntScale[i] = 1;
+		hash->hashBounds[0][i] = floor( hash->hashBounds[0][i] - 1 );
+		hash->hashBounds[1][i] = ceil( hash->hashBounds[1][i] + 1 );
+		hash->hashIntMins[i] = hash->hashBounds[0][i] * SNAP_FRACTIONS;
+
+		hash->hashScale[i] = ( hash->hashBounds[1][i] - hash->hashBounds[0][i] ) / HASH_BINS;
+		hash->hashIntScale[i] = hash->hashScale[i] * SNAP_FRACTIONS;
+		if ( hash->hashIntScale[i] < 1 ) {
+			hash->hashIntScale[i] = 1;
 		}
 	}
 
@@ -256,7 +322,7 @@ void HashTriangles( optimizeGroup_t *groupList ) {
 		}
 		for ( a = group->triList ; a ; a = a->next ) {
 			for ( vert = 0 ; vert < 3 ; vert++ ) {
-				a->hashVert[vert] = GetHashVert( a->v[vert].xyz );
+				a->hashVert[vert] = HashVert( hash, a->v[vert].xyz );
 			}
 		}
 	}
@@ -273,18 +339,19 @@ after t junction processing
 void FreeTJunctionHash( void ) {
 	int			i, j, k;
 	hashVert_t	*hv, *next;
+	tjunctionHash_t	*hash = GetTJunctionHash();
 
 	for ( i = 0 ; i < HASH_BINS ; i++ ) {
 		for ( j = 0 ; j < HASH_BINS ; j++ ) {
 			for ( k = 0 ; k < HASH_BINS ; k++ ) {
-				for ( hv = hashVerts[i][j][k] ; hv ; hv = next ) {
+				for ( hv = hash->hashVerts[i][j][k] ; hv ; hv = next ) {
 					next = hv->next;
 					Mem_Free( hv );
 				}
 			}
 		}
 	}
-	memset( hashVerts, 0, sizeof( hashVerts ) );
+	memset( hash->hashVerts, 0, sizeof( hash->hashVerts ) );
 }
 
 
@@ -393,7 +460,7 @@ FixTriangleAgainstHash
 Potentially splits a triangle into a list of triangles based on tjunctions
 ==================
 */
-static mapTri_t	*FixTriangleAgainstHash( const mapTri_t *tri ) {
+static mapTri_t	*FixTriangleAgainstHash( const tjunctionHash_t *hash, const mapTri_t *tri ) {
 	mapTri_t		*fixed;
 	mapTri_t		*a;
 	mapTri_t		*test, *next;
@@ -413,11 +480,11 @@ static mapTri_t	*FixTriangleAgainstHash( const mapTri_t *tri ) {
 	fixed = CopyMapTri( tri );
 	fixed->next = NULL;
 
-	HashBlocksForTri( tri, blocks );
+	HashBlocksForTri( hash, tri, blocks );
 	for ( i = blocks[0][0] ; i <= blocks[1][0] ; i++ ) {
 		for ( j = blocks[0][1] ; j <= blocks[1][1] ; j++ ) {
 			for ( k = blocks[0][2] ; k <= blocks[1][2] ; k++ ) {
-				for ( hv = hashVerts[i][j][k] ; hv ; hv = hv->next ) {
+				for ( hv = hash->hashVerts[i][j][k] ; hv ; hv = hv->next ) {
 					// fix all triangles in the list against this point
 					test = fixed;
 					fixed = NULL;
@@ -470,6 +537,7 @@ void	FixAreaGroupsTjunctions( optimizeGroup_t *groupList ) {
 	mapTri_t		*fixed;
 	int				startCount, endCount;
 	optimizeGroup_t	*group;
+	const tjunctionHash_t	*hash;
 
 	if ( dmapGlobals.noTJunc ) {
 		return;
@@ -487,6 +555,7 @@ void	FixAreaGroupsTjunctions( optimizeGroup_t *groupList ) {
 	}
 
 	HashTriangles( groupList );
+	hash = GetTJunctionHash();
 
 	for ( group = groupList ; group ; group = group->nextGroup ) {
 		// don't touch discrete surfaces
@@ -496,7 +565,7 @@ void	FixAreaGroupsTjunctions( optimizeGroup_t *groupList ) {
 
 		newList = NULL;
 		for ( tri = group->triList ; tri ; tri = tri->next ) {
-			fixed = FixTriangleAgainstHash( tri );
+			fixed = FixTriangleAgainstHash( hash, tri );
 			newList = MergeTriLists( newList, fixed );
 		}
 		FreeTriList( group->triList );
@@ -510,17 +579,47 @@ void	FixAreaGroupsTjunctions( optimizeGroup_t *groupList ) {
 }
 
 
+/*
+==================
+FixAreaTjunctionsJob
+==================
+*/
+static void FixAreaTjunctionsJob( uEntity_t *e, int areaNum, void *data ) {
+	FixAreaGroupsTjunctions( e->areas[areaNum].groups );
+	FreeTJunctionHash();
+}
+
 /*
 ==================
 FixEntityTjunctions
 ==================
 */
 void	FixEntityTjunctions( uEntity_t *e ) {
-	int		i;
+	RunAreaJobs( e, FixAreaTjunctionsJob, NULL, "dmap tjunctions" );
+}
+
+/*
+==================
+FixGlobalTjunctionsJob
+==================
+*/
+static void FixGlobalTjunctionsJob( uEntity_t *e, int areaNum, void *data ) {
+	const tjunctionHash_t	*hash = (const tjunctionHash_t *)data;
+	optimizeGroup_t	*group;
+
+	for ( group = e->areas[areaNum].groups ; group ; group = group->nextGroup ) {
+		// don't touch discrete surfaces
+		if ( group->material != NULL && group->material->IsDiscrete() ) {
+			continue;
+		}
 
-	for ( i = 0 ; i < e->numAreas ; i++ ) {
-		FixAreaGroupsTjunctions( e->areas[i].groups );
-		FreeTJunctionHash();
+		mapTri_t *newList = NULL;
+		for ( mapTri_t *tri = group->triList ; tri ; tri = tri->next ) {
+			mapTri_t *fixed = FixTriangleAgainstHash( hash, tri );
+			newList = MergeTriLists( newList, fixed );
+		}
+		FreeTriList( group->triList );
+		group->triList = newList;
 	}
 }
 
@@ -535,37 +634,38 @@ void	FixGlobalTjunctions( uEntity_t *e ) {
 	int			i;
 	optimizeGroup_t	*group;
 	int			areaNum;
+	tjunctionHash_t	*hash = GetTJunctionHash();
 
 	common->Printf( "----- FixGlobalTjunctions -----\n" );
 
 	// clear the hash tables
-	memset( hashVerts, 0, sizeof( hashVerts ) );
+	memset( hash->hashVerts, 0, sizeof( hash->hashVerts ) );
 
-	numHashVerts = 0;
-	numTotalVerts = 0;
+	hash->numHashVerts = 0;
+	hash->numTotalVerts = 0;
 
 	// bound all the triangles to determine the bucket size
-	hashBounds.Clear();
+	hash->hashBounds.Clear();
 	for ( areaNum = 0 ; areaNum < e->numAreas ; areaNum++ ) {
 		for ( group = e->areas[areaNum].groups ; group ; group = group->nextGroup ) {
 			for ( a = group->triList ; a ; a = a->next ) {
-				hashBounds.AddPoint( a->v[0].xyz );
-				hashBounds.AddPoint( a->v[1].xyz );
-				hashBounds.AddPoint( a->v[2].xyz );
+				hash->hashBounds.AddPoint( a->v[0].xyz );
+				hash->hashBounds.AddPoint( a->v[1].xyz );
+				hash->hashBounds.AddPoint( a->v[2].xyz );
 			}
 		}
 	}
 
 	// spread the bounds so it will never have a zero size
 	for ( i = 0 ; i < 3 ; i++ ) {
-		hashBounds[0][i] = floor( hashBounds[0][i] - 1 );
-		hashBounds[1][i] = ceil( hashBounds[1][i] + 1 );
-		hashIntMins[i] = hashBounds[0][i] * SNAP_FRACTIONS;
-
-		hashScale[i] = ( hashBounds[1][i] - hashBounds[0][i] ) / HASH_BINS;
-		hashIntScale[i] = hashScale[i] * SNAP_FRACTIONS;
-		if ( hashIntScale[i] < 1 ) {
-			hashIntScale[i] = 1;
+		hash->hashBounds[0][i] = floor( hash->hashBounds[0][i] - 1 );
+		hash->hashBounds[1][i] = ceil( hash->hashBounds[1][i] + 1 );
+		hash->hashIntMins[i] = hash->hashBounds[0][i] * SNAP_FRACTIONS;
+
+		hash->hashScale[i] = ( hash->hashBounds[1][i] - hash->hashBounds[0][i] ) / HASH_BINS;
+		hash->hashIntScale[i] = hash->hashScale[i] * SNAP_FRACTIONS;
+		if ( hash->hashIntScale[i] < 1 ) {
+			hash->hashIntScale[i] = 1;
 		}
 	}
 
@@ -579,7 +679,7 @@ void	FixGlobalTjunctions( uEntity_t *e ) {
 
 			for ( a = group->triList ; a ; a = a->next ) {
 				for ( vert = 0 ; vert < 3 ; vert++ ) {
-					a->hashVert[vert] = GetHashVert( a->v[vert].xyz );
+					a->hashVert[vert] = HashVert( hash, a->v[vert].xyz );
 				}
 			}
 		}
@@ -638,7 +738,7 @@ void	FixGlobalTjunctions( uEntity_t *e ) {
 				}
 				for ( int j = 0 ; j < tri->numVerts ; j += 3 ) {
 					idVec3 v = tri->verts[j].xyz * axis + origin;
-					GetHashVert( v );
+					HashVert( hash, v );
 				}
 			}
 		}
@@ -646,23 +746,8 @@ void	FixGlobalTjunctions( uEntity_t *e ) {
 
 
 
-	// now fix each area
-	for ( areaNum = 0 ; areaNum < e->numAreas ; areaNum++ ) {
-		for ( group = e->areas[areaNum].groups ; group ; group = group->nextGroup ) {
-			// don't touch discrete surfaces
-			if ( group->material != NULL && group->material->IsDiscrete() ) {
-				continue;
-			}
-
-			mapTri_t *newList = NULL;
-			for ( mapTri_t *tri = group->triList ; tri ; tri = tri->next ) {
-				mapTri_t *fixed = FixTriangleAgainstHash( tri );
-				newList = MergeTriLists( newList, fixed );
-			}
-			FreeTriList( group->triList );
-			group->triList = newList;
-		}
-	}
+	// now fix each area, the jobs only read the hash of this thread
+	RunAreaJobs( e, FixGlobalTjunctionsJob, hash, "dmap global tjunctions" );
 
 
 	// done
@@ -883,6 +883,19 @@ static void BuildLightShadows( uEntity_t *e, mapLight_t *light ) {
 		}
 	}
 
+	// the shadow volume only depends on the light and the clipped shadowers,
+	// so an incremental dmap can reuse it if neither changed
+	dmapCacheKey_t	cacheKey;
+	bool			cache = dmapGlobals.incremental && shadowerGroups;
+
+	if ( cache ) {
+		ShadowCacheKey( shadowerGroups, light, hasPerforatedSurface, cacheKey );
+		if ( FindCachedShadow( cacheKey, &light->shadowTris ) ) {
+			FreeOptimizeGroupList( shadowerGroups );
+			return;
+		}
+	}
+
 	// take the shadower group list and create a beam tree and shadow volume
 	light->shadowTris = CreateLightShadow( shadowerGroups, light );
 
@@ -892,6 +905,10 @@ static void BuildLightShadows( uEntity_t *e, mapLight_t *light ) {
 			light->shadowTris->numIndexes;
 	}
 
+	if ( cache ) {
+		CacheShadow( cacheKey, light->shadowTris );
+	}
+
 	// we don't need the original shadower triangles for anything else
 	FreeOptimizeGroupList( shadowerGroups );
 }